@@ -28,6 +28,7 @@ of the microphone array using in MVDR.
 #include <math.h>
 #include <time.h>
 #include "kernels/dios_ssp_api.h"
+#include "dios_signal.h"
 
 const int array_frm_len = 128;
 
@@ -45,6 +46,15 @@ int dios_ssp_v1(int argc, char **argv, int *fe_switch, size_t m, float *mic_coor
     SSP_PARAM->mic_num = mic_num;
     SSP_PARAM->ref_num = ref_num;
     SSP_PARAM->loc_phi = loc_phi;
+    SSP_PARAM->frame_len = array_frm_len;
+    SSP_PARAM->sample_rate = 16000;
+    SSP_PARAM->table_pool = NULL;
+    SSP_PARAM->interleaved = 0;
+    SSP_PARAM->dither = 0;
+    SSP_PARAM->doa_resolution = 0.0f;
+    SSP_PARAM->doa_elevation_min = 0.0f;
+    SSP_PARAM->doa_elevation_max = 0.0f;
+    SSP_PARAM->loc_elevation = 0.0f;
 
     if (SSP_PARAM->AEC_KEY == 1)
     {
@@ -224,3 +234,265 @@ int dios_ssp_v1(int argc, char **argv, int *fe_switch, size_t m, float *mic_coor
     return 0;
 }
 
+
+typedef struct
+{
+    objSSP_Param param;
+    void *st;
+    short *mic_frame;
+    short *ref_frame;
+    short *out_frame;
+} objDios_stream;
+
+void* dios_ssp_stream_init(int *fe_switch, size_t m, float *mic_coord, size_t n, int mic_num, int ref_num, float loc_phi)
+{
+    int i;
+    if (m < 6 || mic_num <= 0 || mic_num > 16 || ref_num < 0)
+    {
+        return NULL;
+    }
+    if (fe_switch[0] == 1 && ref_num == 0)
+    {
+        return NULL;
+    }
+    if ((fe_switch[4] != 0 || fe_switch[5] == 1) && (mic_num <= 1 || n != 3 * (unsigned int)mic_num))
+    {
+        return NULL;
+    }
+
+    objDios_stream *srv = (objDios_stream*)calloc(1, sizeof(objDios_stream));
+    srv->param.AEC_KEY = fe_switch[0];
+    srv->param.NS_KEY = fe_switch[1];
+    srv->param.AGC_KEY = fe_switch[2];
+    srv->param.HPF_KEY = fe_switch[3];
+    srv->param.BF_KEY = fe_switch[4];
+    srv->param.DOA_KEY = fe_switch[5];
+    srv->param.mic_num = mic_num;
+    srv->param.ref_num = ref_num;
+    srv->param.loc_phi = loc_phi;
+    for (i = 0; i < mic_num && 3 * (size_t)i + 2 < n; i++)
+    {
+        srv->param.mic_coord[i].x = mic_coord[3 * i];
+        srv->param.mic_coord[i].y = mic_coord[3 * i + 1];
+        srv->param.mic_coord[i].z = mic_coord[3 * i + 2];
+    }
+
+    /* dios_ssp_process_api reads one frame of every channel back to back,
+       so the strided (channels, samples) input is gathered per frame here */
+    srv->mic_frame = (short*)calloc(mic_num * array_frm_len, sizeof(short));
+    srv->ref_frame = (short*)calloc((ref_num > 0 ? ref_num : 1) * array_frm_len, sizeof(short));
+    srv->out_frame = (short*)calloc(array_frm_len, sizeof(short));
+
+    srv->st = dios_ssp_init_api(&srv->param);
+    if (srv->st == NULL)
+    {
+        dios_ssp_stream_uninit(srv);
+        return NULL;
+    }
+    dios_ssp_reset_api(srv->st, &srv->param);
+    return srv;
+}
+
+int dios_ssp_stream_reset(void *handle)
+{
+    if (handle == NULL)
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
+    objDios_stream *srv = (objDios_stream*)handle;
+    return dios_ssp_reset_api(srv->st, &srv->param);
+}
+
+int dios_ssp_stream_frame_len(void *handle)
+{
+    return array_frm_len;
+}
+
+/* returns the number of processed samples per channel, or -1 on bad shapes */
+static long dios_ssp_stream_check(objDios_stream *srv, size_t mic_len, size_t ref_len, size_t out_len)
+{
+    size_t samples;
+    if (srv == NULL || mic_len % srv->param.mic_num != 0)
+    {
+        return -1;
+    }
+    samples = mic_len / srv->param.mic_num;
+    if (samples % array_frm_len != 0 || out_len < samples)
+    {
+        return -1;
+    }
+    if (ref_len != 0 && (srv->param.ref_num == 0 || ref_len != samples * srv->param.ref_num))
+    {
+        return -1;
+    }
+    return (long)samples;
+}
+
+int dios_ssp_stream_process_short(void *handle, short *mic_data, size_t mic_len, short *ref_data, size_t ref_len, short *out_data, size_t out_len)
+{
+    objDios_stream *srv = (objDios_stream*)handle;
+    long samples = dios_ssp_stream_check(srv, mic_len, ref_len, out_len);
+    long frm_idx;
+    int ch_idx;
+    int ret;
+    if (samples < 0)
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
+    if (ref_len == 0)
+    {
+        memset(srv->ref_frame, 0, sizeof(short) * (srv->param.ref_num > 0 ? srv->param.ref_num : 1) * array_frm_len);
+    }
+
+    for (frm_idx = 0; frm_idx < samples; frm_idx += array_frm_len)
+    {
+        for (ch_idx = 0; ch_idx < srv->param.mic_num; ch_idx++)
+        {
+            memcpy(&srv->mic_frame[ch_idx * array_frm_len], &mic_data[ch_idx * samples + frm_idx], sizeof(short) * array_frm_len);
+        }
+        if (ref_len != 0)
+        {
+            for (ch_idx = 0; ch_idx < srv->param.ref_num; ch_idx++)
+            {
+                memcpy(&srv->ref_frame[ch_idx * array_frm_len], &ref_data[ch_idx * samples + frm_idx], sizeof(short) * array_frm_len);
+            }
+        }
+
+        /* output frames are written in place, no staging buffer needed */
+        ret = dios_ssp_process_api(srv->st, srv->mic_frame, srv->ref_frame, &out_data[frm_idx], &srv->param);
+        if (ret != OK_AUDIO_PROCESS)
+        {
+            return ret;
+        }
+    }
+    return OK_AUDIO_PROCESS;
+}
+
+static short dios_ssp_stream_float_to_short(float x)
+{
+    float y = x * 32768.0f;
+    if (y >= 32767.0f)
+    {
+        return 32767;
+    }
+    if (y <= -32768.0f)
+    {
+        return -32768;
+    }
+    return (short)lrintf(y);
+}
+
+int dios_ssp_stream_process_float(void *handle, float *mic_data, size_t mic_len, float *ref_data, size_t ref_len, float *out_data, size_t out_len)
+{
+    objDios_stream *srv = (objDios_stream*)handle;
+    long samples = dios_ssp_stream_check(srv, mic_len, ref_len, out_len);
+    long frm_idx;
+    int ch_idx, i;
+    int ret;
+    if (samples < 0)
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
+    if (ref_len == 0)
+    {
+        memset(srv->ref_frame, 0, sizeof(short) * (srv->param.ref_num > 0 ? srv->param.ref_num : 1) * array_frm_len);
+    }
+
+    /* float samples are full scale at +/-1.0, same as soundfile/librosa */
+    for (frm_idx = 0; frm_idx < samples; frm_idx += array_frm_len)
+    {
+        for (ch_idx = 0; ch_idx < srv->param.mic_num; ch_idx++)
+        {
+            for (i = 0; i < array_frm_len; i++)
+            {
+                srv->mic_frame[ch_idx * array_frm_len + i] = dios_ssp_stream_float_to_short(mic_data[ch_idx * samples + frm_idx + i]);
+            }
+        }
+        if (ref_len != 0)
+        {
+            for (ch_idx = 0; ch_idx < srv->param.ref_num; ch_idx++)
+            {
+                for (i = 0; i < array_frm_len; i++)
+                {
+                    srv->ref_frame[ch_idx * array_frm_len + i] = dios_ssp_stream_float_to_short(ref_data[ch_idx * samples + frm_idx + i]);
+                }
+            }
+        }
+
+        ret = dios_ssp_process_api(srv->st, srv->mic_frame, srv->ref_frame, srv->out_frame, &srv->param);
+        if (ret != OK_AUDIO_PROCESS)
+        {
+            return ret;
+        }
+        for (i = 0; i < array_frm_len; i++)
+        {
+            out_data[frm_idx + i] = srv->out_frame[i] * (1.0f / 32768.0f);
+        }
+    }
+    return OK_AUDIO_PROCESS;
+}
+
+float dios_ssp_stream_doa_result(void *handle)
+{
+    if (handle == NULL)
+    {
+        return ERROR_DOA;
+    }
+    objDios_stream *srv = (objDios_stream*)handle;
+    return dios_ssp_doa_result_get_api(srv->st, &srv->param);
+}
+
+int dios_ssp_stream_doa_sources(void *handle, float *source_data, size_t source_len)
+{
+    DoaSource source[DEFAULT_DOA_MAX_SOURCE_NUM];
+    int num;
+    int i;
+
+    if (handle == NULL || source_data == NULL)
+    {
+        return -1;
+    }
+    objDios_stream *srv = (objDios_stream*)handle;
+    num = (int)(source_len / 3);
+    num = dios_ssp_doa_source_get_api(srv->st, &srv->param, source, 
+        num < DEFAULT_DOA_MAX_SOURCE_NUM ? num : DEFAULT_DOA_MAX_SOURCE_NUM);
+    if (num == ERROR_DOA)
+    {
+        return -1;
+    }
+    for (i = 0; i < num; i++)
+    {
+        source_data[3 * i] = source[i].angle;
+        source_data[3 * i + 1] = source[i].confidence;
+        source_data[3 * i + 2] = (float)source[i].id;
+    }
+    return num;
+}
+
+int dios_ssp_stream_vad_result(void *handle)
+{
+    if (handle == NULL)
+    {
+        return ERROR_VAD;
+    }
+    objDios_stream *srv = (objDios_stream*)handle;
+    return dios_ssp_vad_result_get_api(srv->st, &srv->param);
+}
+
+int dios_ssp_stream_uninit(void *handle)
+{
+    if (handle == NULL)
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
+    objDios_stream *srv = (objDios_stream*)handle;
+    if (srv->st != NULL)
+    {
+        dios_ssp_uninit_api(srv->st, &srv->param);
+    }
+    free(srv->mic_frame);
+    free(srv->ref_frame);
+    free(srv->out_frame);
+    free(srv);
+    return OK_AUDIO_PROCESS;
+}
@@ -21,4 +21,20 @@ limitations under the License.
 #include <time.h>
 #include "kernels/dios_ssp_api.h"
 
-int dios_ssp_v1(int argc, char **argv, int *fe_switch, size_t m, float *mic_coord, size_t n, int mic_num, int ref_num, float loc_phi);
\ No newline at end of file
+int dios_ssp_v1(int argc, char **argv, int *fe_switch, size_t m, float *mic_coord, size_t n, int mic_num, int ref_num, float loc_phi);
+
+/* streaming session used by the python package: one handle owns the
+   objDios_ssp instance and its parameters, and whole frames are processed
+   straight out of caller owned (mic_num, samples) / (ref_num, samples)
+   C-contiguous buffers into a caller owned (samples) output buffer. */
+void* dios_ssp_stream_init(int *fe_switch, size_t m, float *mic_coord, size_t n, int mic_num, int ref_num, float loc_phi);
+int dios_ssp_stream_reset(void *handle);
+int dios_ssp_stream_frame_len(void *handle);
+int dios_ssp_stream_process_short(void *handle, short *mic_data, size_t mic_len, short *ref_data, size_t ref_len, short *out_data, size_t out_len);
+int dios_ssp_stream_process_float(void *handle, float *mic_data, size_t mic_len, float *ref_data, size_t ref_len, float *out_data, size_t out_len);
+float dios_ssp_stream_doa_result(void *handle);
+/* the tracked sources as (angle, confidence, id) triples, returns their number
+   or -1 if DOA is off */
+int dios_ssp_stream_doa_sources(void *handle, float *source_data, size_t source_len);
+int dios_ssp_stream_vad_result(void *handle);
+int dios_ssp_stream_uninit(void *handle);
@@ -148,4 +148,68 @@ callable module for Python to call.
 %}
 
 
-int dios_ssp_v1(int argc, char **argv, int *fe_switch, size_t m, float *mic_coord, size_t n, int mic_num, int ref_num, float loc_phi);
\ No newline at end of file
+int dios_ssp_v1(int argc, char **argv, int *fe_switch, size_t m, float *mic_coord, size_t n, int mic_num, int ref_num, float loc_phi);
+
+/* streaming session: numpy arrays (or any C-contiguous buffer) are handed
+   to C through the buffer protocol without copying, and the GIL is released
+   while the frames are processed */
+%define DIOS_BUFFER_TYPEMAP(TYPE, DATA, LEN, FLAGS)
+/* freearg of every buffer also runs when an earlier argument fails, so all
+   the views are cleared before any argument is converted */
+%typemap(arginit) (TYPE *DATA, size_t LEN) %{
+  view$argnum.obj = NULL;
+%}
+
+%typemap(in, numinputs=1) (TYPE *DATA, size_t LEN) (Py_buffer view) %{
+  if ($input == Py_None) {
+    $1 = NULL;
+    $2 = 0;
+  } else {
+    if (PyObject_GetBuffer($input, &view, PyBUF_C_CONTIGUOUS | FLAGS) != 0) {
+      SWIG_fail;
+    }
+    if (view.itemsize != sizeof(TYPE)) {
+      PyErr_SetString(PyExc_TypeError, "buffer item size does not match " #TYPE);
+      SWIG_fail;
+    }
+    $1 = (TYPE *) view.buf;
+    $2 = view.len / sizeof(TYPE);
+  }
+%}
+
+%typemap(freearg) (TYPE *DATA, size_t LEN) %{
+  if (view$argnum.obj != NULL) {
+    PyBuffer_Release(&view$argnum);
+  }
+%}
+%enddef
+
+DIOS_BUFFER_TYPEMAP(short, mic_data, mic_len, PyBUF_SIMPLE)
+DIOS_BUFFER_TYPEMAP(short, ref_data, ref_len, PyBUF_SIMPLE)
+DIOS_BUFFER_TYPEMAP(short, out_data, out_len, PyBUF_WRITABLE)
+DIOS_BUFFER_TYPEMAP(float, mic_data, mic_len, PyBUF_SIMPLE)
+DIOS_BUFFER_TYPEMAP(float, ref_data, ref_len, PyBUF_SIMPLE)
+DIOS_BUFFER_TYPEMAP(float, out_data, out_len, PyBUF_WRITABLE)
+DIOS_BUFFER_TYPEMAP(float, source_data, source_len, PyBUF_WRITABLE)
+
+%exception dios_ssp_stream_process_short %{
+  Py_BEGIN_ALLOW_THREADS
+  $action
+  Py_END_ALLOW_THREADS
+%}
+
+%exception dios_ssp_stream_process_float %{
+  Py_BEGIN_ALLOW_THREADS
+  $action
+  Py_END_ALLOW_THREADS
+%}
+
+void* dios_ssp_stream_init(int *fe_switch, size_t m, float *mic_coord, size_t n, int mic_num, int ref_num, float loc_phi);
+int dios_ssp_stream_reset(void *handle);
+int dios_ssp_stream_frame_len(void *handle);
+int dios_ssp_stream_process_short(void *handle, short *mic_data, size_t mic_len, short *ref_data, size_t ref_len, short *out_data, size_t out_len);
+int dios_ssp_stream_process_float(void *handle, float *mic_data, size_t mic_len, float *ref_data, size_t ref_len, float *out_data, size_t out_len);
+float dios_ssp_stream_doa_result(void *handle);
+int dios_ssp_stream_doa_sources(void *handle, float *source_data, size_t source_len);
+int dios_ssp_stream_vad_result(void *handle);
+int dios_ssp_stream_uninit(void *handle);
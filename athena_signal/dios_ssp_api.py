@@ -17,6 +17,10 @@
 easy invocation."""
 
 from athena_signal.dios_signal import dios_ssp_v1
+from athena_signal.dios_signal import dios_ssp_stream_init, dios_ssp_stream_reset, \
+    dios_ssp_stream_frame_len, dios_ssp_stream_process_short, dios_ssp_stream_process_float, \
+    dios_ssp_stream_doa_result, dios_ssp_stream_doa_sources, dios_ssp_stream_vad_result, \
+    dios_ssp_stream_uninit
 import numpy as np
 
 class AthenaSignal:
@@ -109,6 +113,111 @@ class AthenaSignal:
                 argc.append(file.encode())
         dios_ssp_v1(argc, self.feature_switch, list(self.mic_coord), self.mic_num, self.ref_num, self.loc_phi)
 
+class AthenaSignalStream:
+    """
+    Stateful AEC/NS/AGC/HPF/BF/DOA session working on numpy arrays.
+    The session keeps the signal processing state between calls, so a long
+    signal can be fed in chunks of any number of whole frames.
+    """
+    def __init__(self, config=None, mic_coord=None):
+        """
+        :param config: Same keys as AthenaSignal.set_params.
+        :param mic_coord: Microphone coordinates of shape [mic_num, 3], needed
+                when add_BF or add_DOA is on.
+        """
+        self._handle = None
+        config = config or {}
+        self.feature_switch = [config.get('add_AEC', 1), config.get('add_NS', 1),
+                               config.get('add_AGC', 0), config.get('add_HPF', 0),
+                               config.get('add_BF', 0), config.get('add_DOA', 0)]
+        self.mic_num = config.get('mic_num', 1)
+        self.ref_num = config.get('ref_num', 1)
+        self.loc_phi = config.get('loc_phi', 90.0)
+
+        coord = np.zeros(3 * self.mic_num, dtype=float)
+        if mic_coord is not None:
+            coord[:] = np.asarray(mic_coord, dtype=float).reshape(-1)[:3 * self.mic_num]
+        self._handle = dios_ssp_stream_init(list(self.feature_switch), list(coord),
+                                            self.mic_num, self.ref_num, self.loc_phi)
+        if self._handle is None:
+            raise ValueError('invalid athena_signal configuration: {}'.format(config))
+        self.frame_len = dios_ssp_stream_frame_len(self._handle)
+
+    def process(self, mic, ref=None):
+        """
+        Process whole frames of multichannel input.
+        :param mic: int16 or float32 array of shape [mic_num, samples]. float32
+                samples are full scale at +/-1.0. samples must be a multiple
+                of frame_len.
+        :param ref: Optional reference array of shape [ref_num, samples] with the
+                same dtype as mic.
+        :return: Processed array of shape [samples] with the dtype of mic.
+        """
+        if self._handle is None:
+            raise RuntimeError('AthenaSignalStream is closed')
+        mic = np.asarray(mic)
+        if mic.dtype == np.int16:
+            process_fn = dios_ssp_stream_process_short
+        elif mic.dtype == np.float32:
+            process_fn = dios_ssp_stream_process_float
+        else:
+            raise TypeError('mic must be int16 or float32, got {}'.format(mic.dtype))
+        if mic.ndim == 1:
+            mic = mic[np.newaxis, :]
+        if mic.ndim != 2 or mic.shape[0] != self.mic_num:
+            raise ValueError('mic must have shape ({}, samples), got {}'.format(self.mic_num, mic.shape))
+        samples = mic.shape[1]
+        if samples % self.frame_len != 0:
+            raise ValueError('samples must be a multiple of {}, got {}'.format(self.frame_len, samples))
+        mic = np.ascontiguousarray(mic)
+
+        if ref is not None:
+            ref = np.ascontiguousarray(ref, dtype=mic.dtype)
+            if ref.ndim == 1:
+                ref = ref[np.newaxis, :]
+            if ref.shape != (self.ref_num, samples):
+                raise ValueError('ref must have shape ({}, {}), got {}'.format(self.ref_num, samples, ref.shape))
+
+        out = np.empty(samples, dtype=mic.dtype)
+        ret = process_fn(self._handle, mic, ref, out)
+        if ret != 0:
+            raise RuntimeError('athena_signal processing failed with code {}'.format(ret))
+        return out
+
+    def reset(self):
+        dios_ssp_stream_reset(self._handle)
+
+    def doa(self):
+        """Return the DOA angle estimated on the processed frames."""
+        return dios_ssp_stream_doa_result(self._handle)
+
+    def doa_sources(self, max_num=4):
+        """Return the tracked sources as a list of (angle, confidence, id), most
+        confident first. Needs add_DOA."""
+        out = np.zeros(3 * max_num, dtype=np.float32)
+        num = dios_ssp_stream_doa_sources(self._handle, out)
+        if num < 0:
+            raise RuntimeError('athena_signal DOA is off')
+        return [(float(out[3 * i]), float(out[3 * i + 1]), int(out[3 * i + 2])) for i in range(num)]
+
+    def vad(self):
+        """Return the VAD status of the last processed frame."""
+        return dios_ssp_stream_vad_result(self._handle)
+
+    def close(self):
+        if self._handle is not None:
+            dios_ssp_stream_uninit(self._handle)
+            self._handle = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
 def athena_signal_process(input_file, out_file, ref_file=None, config=None, mic_coord=None):
     """
     Do signal processing.
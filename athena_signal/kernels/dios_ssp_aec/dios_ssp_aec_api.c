@@ -20,6 +20,7 @@ and residual echo suppression.
 
 /* include file */
 #include "dios_ssp_aec_api.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
 /* aec struct define */
 typedef struct {
@@ -49,6 +50,8 @@ typedef struct {
 	int mic_num;
 	int ref_num;
 	int frm_len;
+	int sample_rate;
+	int sub_num;
 	float *abs_ref_avg;
 	float *mic_tde;
 	float *ref_tde;
@@ -58,9 +61,37 @@ typedef struct {
 	/* some variable definition */
 	int far_end_talk_holdtime;
 	int* doubletalk_result;
+
+	/* per microphone parallel processing */
+	void* workpool;
+	int* mic_ret;
+	float* io_buf;
 }objAEC;
 
-void* dios_ssp_aec_init_api(int mic_num, int ref_num, int frm_len)
+void* dios_ssp_aec_init_api(int mic_num, int ref_num, int frm_len, int sample_rate)
+{
+	return dios_ssp_aec_multithread_init_api(mic_num, ref_num, frm_len, sample_rate, 1, NULL);
+}
+
+static const size_t g_aec_ptr[] = {
+	offsetof(objAEC, st_tde), offsetof(objAEC, st_subband_mic),
+	offsetof(objAEC, st_subband_ref), offsetof(objAEC, st_firfilter),
+	offsetof(objAEC, st_res), offsetof(objAEC, st_doubletalk),
+	offsetof(objAEC, st_noise_est_spk_t), offsetof(objAEC, st_noise_est_spk_subband),
+	offsetof(objAEC, input_mic_time), offsetof(objAEC, input_ref_time),
+	offsetof(objAEC, input_mic_subband), offsetof(objAEC, input_ref_subband),
+	offsetof(objAEC, firfilter_out), offsetof(objAEC, final_out),
+	offsetof(objAEC, est_echo), offsetof(objAEC, band_table),
+	offsetof(objAEC, ref_psd), offsetof(objAEC, spk_part_band_energy),
+	offsetof(objAEC, spk_peak), offsetof(objAEC, abs_ref_avg),
+	offsetof(objAEC, mic_tde), offsetof(objAEC, ref_tde),
+	offsetof(objAEC, ref_buffer), offsetof(objAEC, doubletalk_result),
+	offsetof(objAEC, workpool), offsetof(objAEC, mic_ret),
+	offsetof(objAEC, io_buf)
+};
+
+void* dios_ssp_aec_multithread_init_api(int mic_num, int ref_num, int frm_len, int sample_rate, int thread_num,
+										void* table_pool)
 {
 	int i;
 	int i_mic;
@@ -68,52 +99,61 @@ void* dios_ssp_aec_init_api(int mic_num, int ref_num, int frm_len)
 	int ret = 0;
 	void* ptr = NULL;
 
-	if (mic_num <= 0 || ref_num <= 0 || frm_len != 128)
+	if (mic_num <= 0 || ref_num <= 0 || thread_num <= 0 || thread_num > WORKPOOL_MAX_THREADS)
+	{
+		return NULL;
+	}
+	/* the subband layout keeps the 16kHz bin width, one frame is 8ms at any rate */
+	if ((sample_rate != 8000 && sample_rate != 16000 && sample_rate != 32000 && sample_rate != AEC_SAMPLE_RATE_MAX)
+		|| frm_len * AEC_SAMPLE_RATE != AEC_FFT_LEN / 2 * sample_rate)
 	{
 		return NULL;
 	}
 
-	ptr = (void*)calloc(1,sizeof(objAEC));
+	ptr = (void*)dios_ssp_share_calloc_map(1, sizeof(objAEC), g_aec_ptr, SHARE_ARENA_MAP_NUM(g_aec_ptr));
 	objAEC* srv = (objAEC*)ptr;
 	
 	srv->mic_num = mic_num;
 	srv->ref_num = ref_num;
 	srv->frm_len = frm_len;
+	srv->sample_rate = sample_rate;
+	srv->sub_num = frm_len + 1;
 
 	srv->ref_buffer_len = AEC_REF_FIX_DELAY;
 
 	/* buffer memory allocate */
 	/* mic number related */
-	srv->mic_tde = (float*)calloc(srv->mic_num * srv->frm_len, sizeof(float));
-	srv->doubletalk_result = (int *)calloc(srv->mic_num, sizeof(int));
-	srv->input_mic_time = (float**)calloc(srv->mic_num, sizeof(float*));
-	srv->input_mic_subband = (xcomplex**)calloc(srv->mic_num, sizeof(xcomplex*));
-	srv->firfilter_out = (xcomplex**)calloc(srv->mic_num, sizeof(xcomplex*));
-	srv->final_out = (xcomplex**)calloc(srv->mic_num, sizeof(xcomplex*));
-	srv->est_echo = (xcomplex**)calloc(srv->mic_num, sizeof(xcomplex*));
-	srv->st_subband_mic = (objSubBand**)calloc(srv->mic_num, sizeof(objSubBand*));
-	srv->st_firfilter = (objFirFilter**)calloc(srv->mic_num, sizeof(objFirFilter*));
-	srv->st_doubletalk = (objDoubleTalk**)calloc(srv->mic_num, sizeof(objDoubleTalk*));
-	srv->st_res = (objRES***)calloc(srv->mic_num, sizeof(objRES**));
-
-	srv->st_tde = dios_ssp_aec_tde_init(srv->mic_num, srv->ref_num, srv->frm_len);
+	srv->mic_tde = (float*)dios_ssp_share_calloc(srv->mic_num * srv->frm_len, sizeof(float));
+	srv->doubletalk_result = (int *)dios_ssp_share_calloc(srv->mic_num, sizeof(int));
+	srv->mic_ret = (int *)dios_ssp_share_calloc(srv->mic_num, sizeof(int));
+	srv->input_mic_time = (float**)dios_ssp_share_calloc_ptr(srv->mic_num, sizeof(float*));
+	srv->input_mic_subband = (xcomplex**)dios_ssp_share_calloc_ptr(srv->mic_num, sizeof(xcomplex*));
+	srv->firfilter_out = (xcomplex**)dios_ssp_share_calloc_ptr(srv->mic_num, sizeof(xcomplex*));
+	srv->final_out = (xcomplex**)dios_ssp_share_calloc_ptr(srv->mic_num, sizeof(xcomplex*));
+	srv->est_echo = (xcomplex**)dios_ssp_share_calloc_ptr(srv->mic_num, sizeof(xcomplex*));
+	srv->st_subband_mic = (objSubBand**)dios_ssp_share_calloc_ptr(srv->mic_num, sizeof(objSubBand*));
+	srv->st_firfilter = (objFirFilter**)dios_ssp_share_calloc_ptr(srv->mic_num, sizeof(objFirFilter*));
+	srv->st_doubletalk = (objDoubleTalk**)dios_ssp_share_calloc_ptr(srv->mic_num, sizeof(objDoubleTalk*));
+	srv->st_res = (objRES***)dios_ssp_share_calloc_ptr(srv->mic_num, sizeof(objRES**));
+
+	srv->st_tde = dios_ssp_aec_tde_init(srv->mic_num, srv->ref_num, srv->frm_len, srv->sample_rate, table_pool);
 
 	for (i_mic = 0; i_mic < srv->mic_num; i_mic++)
 	{
-		srv->input_mic_time[i_mic] = (float*)calloc(srv->frm_len, sizeof(float));
-		srv->input_mic_subband[i_mic] = (xcomplex*)calloc(AEC_SUBBAND_NUM, sizeof(xcomplex));
-		srv->firfilter_out[i_mic] = (xcomplex*)calloc(AEC_SUBBAND_NUM, sizeof(xcomplex));
-		srv->final_out[i_mic] = (xcomplex*)calloc(AEC_SUBBAND_NUM, sizeof(xcomplex));
-		srv->est_echo[i_mic] = (xcomplex*)calloc(AEC_SUBBAND_NUM, sizeof(xcomplex));
-		srv->st_res[i_mic] = (objRES**)calloc(srv->ref_num, sizeof(objRES*));
+		srv->input_mic_time[i_mic] = (float*)dios_ssp_share_calloc(srv->frm_len, sizeof(float));
+		srv->input_mic_subband[i_mic] = (xcomplex*)dios_ssp_share_calloc(srv->sub_num, sizeof(xcomplex));
+		srv->firfilter_out[i_mic] = (xcomplex*)dios_ssp_share_calloc(srv->sub_num, sizeof(xcomplex));
+		srv->final_out[i_mic] = (xcomplex*)dios_ssp_share_calloc(srv->sub_num, sizeof(xcomplex));
+		srv->est_echo[i_mic] = (xcomplex*)dios_ssp_share_calloc(srv->sub_num, sizeof(xcomplex));
+		srv->st_res[i_mic] = (objRES**)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(objRES*));
 		
 		/* sub module init */
-		srv->st_subband_mic[i_mic] = dios_ssp_share_subband_init(srv->frm_len);
-		srv->st_firfilter[i_mic] = dios_ssp_aec_firfilter_init(srv->ref_num);
-		srv->st_doubletalk[i_mic] = dios_ssp_aec_doubletalk_init(srv->ref_num);		
+		srv->st_subband_mic[i_mic] = dios_ssp_share_subband_init_pool(srv->frm_len, table_pool);
+		srv->st_firfilter[i_mic] = dios_ssp_aec_firfilter_init(srv->ref_num, srv->sub_num);
+		srv->st_doubletalk[i_mic] = dios_ssp_aec_doubletalk_init(srv->ref_num, srv->sub_num);		
 		for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
 		{
-			srv->st_res[i_mic][i_ref] = dios_ssp_aec_res_init();
+			srv->st_res[i_mic][i_ref] = dios_ssp_aec_res_init(srv->sub_num);
 		}
 
 		/* module share memory and varvariable */
@@ -127,45 +167,45 @@ void* dios_ssp_aec_init_api(int mic_num, int ref_num, int frm_len)
 	}
 
 	/* reference number related */
-	srv->ref_buffer = (float*)calloc(srv->ref_num * (srv->ref_buffer_len + srv->frm_len), sizeof(float));
-	srv->ref_tde = (float*)calloc(srv->ref_num * srv->frm_len, sizeof(float));
-	srv->abs_ref_avg = (float*)calloc(srv->ref_num, sizeof(float));
-	srv->ref_psd = (float**)calloc(srv->ref_num, sizeof(float*));
-	srv->input_ref_subband = (xcomplex**)calloc(srv->ref_num, sizeof(xcomplex*));
-	srv->spk_peak = (float**)calloc(srv->ref_num, sizeof(float*));
-	srv->input_ref_time = (float**)calloc(srv->ref_num, sizeof(float*));
-	srv->st_subband_ref = (objSubBand**)calloc(srv->ref_num, sizeof(objSubBand*));
-	srv->st_noise_est_spk_t = (objNoiseLevel**)calloc(srv->ref_num, sizeof(objNoiseLevel*));
+	srv->ref_buffer = (float*)dios_ssp_share_calloc(srv->ref_num * (srv->ref_buffer_len + srv->frm_len), sizeof(float));
+	srv->ref_tde = (float*)dios_ssp_share_calloc(srv->ref_num * srv->frm_len, sizeof(float));
+	srv->abs_ref_avg = (float*)dios_ssp_share_calloc(srv->ref_num, sizeof(float));
+	srv->ref_psd = (float**)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(float*));
+	srv->input_ref_subband = (xcomplex**)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(xcomplex*));
+	srv->spk_peak = (float**)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(float*));
+	srv->input_ref_time = (float**)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(float*));
+	srv->st_subband_ref = (objSubBand**)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(objSubBand*));
+	srv->st_noise_est_spk_t = (objNoiseLevel**)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(objNoiseLevel*));
 	for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
 	{
-		srv->input_ref_time[i_ref] = (float*)calloc(srv->frm_len, sizeof(float));
-		srv->input_ref_subband[i_ref] = (xcomplex*)calloc(AEC_SUBBAND_NUM, sizeof(xcomplex));
-		srv->ref_psd[i_ref] = (float*)calloc(AEC_SUBBAND_NUM, sizeof(float));
-		srv->spk_peak[i_ref] = (float*)calloc(ERL_BAND_NUM, sizeof(float));
+		srv->input_ref_time[i_ref] = (float*)dios_ssp_share_calloc(srv->frm_len, sizeof(float));
+		srv->input_ref_subband[i_ref] = (xcomplex*)dios_ssp_share_calloc(srv->sub_num, sizeof(xcomplex));
+		srv->ref_psd[i_ref] = (float*)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+		srv->spk_peak[i_ref] = (float*)dios_ssp_share_calloc(ERL_BAND_NUM, sizeof(float));
 	}
 	for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
 	{
 		/* ref signal sunbband init */
-		srv->st_subband_ref[i_ref] = dios_ssp_share_subband_init(srv->frm_len);
-		srv->st_noise_est_spk_t[i_ref] = (objNoiseLevel*)calloc(1, sizeof(objNoiseLevel));
+		srv->st_subband_ref[i_ref] = dios_ssp_share_subband_init_pool(srv->frm_len, table_pool);
+		srv->st_noise_est_spk_t[i_ref] = (objNoiseLevel*)dios_ssp_share_calloc(1, sizeof(objNoiseLevel));
 	}
 
-	srv->st_noise_est_spk_subband = (objNoiseLevel***)calloc(srv->ref_num, sizeof(objNoiseLevel**));
+	srv->st_noise_est_spk_subband = (objNoiseLevel***)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(objNoiseLevel**));
 	for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
 	{
-		srv->st_noise_est_spk_subband[i_ref] = (objNoiseLevel**)calloc(ERL_BAND_NUM, sizeof(objNoiseLevel*));
+		srv->st_noise_est_spk_subband[i_ref] = (objNoiseLevel**)dios_ssp_share_calloc_ptr(ERL_BAND_NUM, sizeof(objNoiseLevel*));
 		for (i = 0; i < ERL_BAND_NUM; i++)
 		{
-			srv->st_noise_est_spk_subband[i_ref][i] = (objNoiseLevel *)calloc(1, sizeof(objNoiseLevel));
+			srv->st_noise_est_spk_subband[i_ref][i] = (objNoiseLevel *)dios_ssp_share_calloc(1, sizeof(objNoiseLevel));
 		}
 	}
 
 	/* erl number related */
-	srv->spk_part_band_energy = (float*)calloc(ERL_BAND_NUM, sizeof(float));
-	srv->band_table = (int**)calloc(ERL_BAND_NUM, sizeof(int*));
+	srv->spk_part_band_energy = (float*)dios_ssp_share_calloc(ERL_BAND_NUM, sizeof(float));
+	srv->band_table = (int**)dios_ssp_share_calloc_ptr(ERL_BAND_NUM, sizeof(int*));
 	for (i = 0; i < ERL_BAND_NUM; i++)
 	{
-		srv->band_table[i] = (int *)calloc(2, sizeof(int));
+		srv->band_table[i] = (int *)dios_ssp_share_calloc(2, sizeof(int));
 	}
 	
 	/* variable init */
@@ -182,7 +222,18 @@ void* dios_ssp_aec_init_api(int mic_num, int ref_num, int frm_len)
 		srv->band_table[i][0] = (int)(srv->freq_div_table[i] / AEC_SAMPLE_RATE * AEC_FFT_LEN);
 		srv->band_table[i - 1][1] = srv->band_table[i][0] - 1;
 	}
-	srv->band_table[ERL_BAND_NUM - 1][1] = AEC_HIGH_CHAN - 1;
+	srv->band_table[ERL_BAND_NUM - 1][1] = srv->sub_num - 1;
+
+	/* no more threads than microphone channels */
+	if (thread_num > 1 && srv->mic_num > 1)
+	{
+		srv->workpool = dios_ssp_share_workpool_init(thread_num < srv->mic_num ? thread_num : srv->mic_num);
+		if (NULL == srv->workpool)
+		{
+			dios_ssp_aec_uninit_api(srv);
+			return NULL;
+		}
+	}
 
 	ret = dios_ssp_aec_reset_api(srv);
 	if (0 != ret)
@@ -313,7 +364,7 @@ int dios_ssp_aec_reset_api(void* ptr)
 	for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
 	{
 		srv->abs_ref_avg[i_ref] = 0;
-		memset(srv->ref_psd[i_ref], 0, AEC_SUBBAND_NUM * sizeof(float));
+		memset(srv->ref_psd[i_ref], 0, srv->sub_num * sizeof(float));
 
 		ret = dios_ssp_share_subband_reset(srv->st_subband_ref[i_ref]);
 		if (0 != ret)
@@ -340,6 +391,115 @@ int dios_ssp_aec_reset_api(void* ptr)
 	return 0;
 }
 
+/* echo cancellation of one microphone channel, reads only the reference
+   state shared by all channels, so channels can run in any order or in parallel */
+static int dios_ssp_aec_mic_process(objAEC* srv, int i_mic)
+{
+	int ret_process = 0;
+	int i_ref;
+	int ii;
+	int ch;
+
+	/* mic subband analyse */
+	ret_process = dios_ssp_share_subband_analyse(srv->st_subband_mic[i_mic], srv->input_mic_time[i_mic], srv->input_mic_subband[i_mic]);
+	if (0 != ret_process) 
+	{
+		return ERR_AEC;
+	}
+	/* fir filter process */
+	srv->st_firfilter[i_mic]->far_end_talk_holdtime = srv->far_end_talk_holdtime;
+	srv->st_firfilter[i_mic]->dt_status = &srv->doubletalk_result[i_mic];
+
+	srv->st_firfilter[i_mic]->sig_mic_rec = srv->input_mic_subband[i_mic];
+	srv->st_firfilter[i_mic]->sig_spk_ref = srv->input_ref_subband;
+
+	srv->st_firfilter[i_mic]->noise_est_spk_part = srv->st_noise_est_spk_subband;
+	srv->st_firfilter[i_mic]->noise_est_spk_t = srv->st_noise_est_spk_t;
+
+	srv->st_firfilter[i_mic]->band_table = srv->band_table;
+	srv->st_firfilter[i_mic]->spk_part_band_energy = srv->spk_part_band_energy;
+	srv->st_firfilter[i_mic]->spk_peak = srv->spk_peak;
+	ret_process = dios_ssp_aec_firfilter_process(srv->st_firfilter[i_mic], srv->firfilter_out[i_mic], srv->est_echo[i_mic]);
+	if (0 != ret_process) 
+	{
+		return ERR_AEC;
+	}
+
+	/* save for 2nd stage res */
+	/* The 1st stage residual echo processing is to judge the double-talk state */
+	memcpy(srv->final_out[i_mic], srv->firfilter_out[i_mic], sizeof(xcomplex) * srv->sub_num);
+
+	/* ERL estimate */
+	ret_process = dios_ssp_aec_erl_est_process(srv->st_firfilter[i_mic]);
+	if (ret_process != 0)
+	{
+		return ERR_AEC;
+	}
+
+	/* aec output noise tracking */
+	for (ch = AEC_LOW_CHAN; ch < srv->sub_num; ch++)
+	{
+		if (srv->far_end_talk_holdtime == 0)
+		{
+			dios_ssp_share_noiselevel_process(srv->st_firfilter[i_mic]->noise_est_mic_chan[ch], srv->st_firfilter[i_mic]->power_mic_send_smooth[ch]);
+		}
+	}
+
+	/* 1st stage residual echo suppression to improve dtd result */
+	for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
+	{
+		srv->st_res[i_mic][i_ref]->Xf_res_echo = srv->firfilter_out[i_mic];
+		srv->st_res[i_mic][i_ref]->Xf_echo = srv->est_echo[i_mic];
+		/* dtd result input(the 2nd parameter) is only for stage two, so this dtd result is useless */
+		ret_process = dios_ssp_aec_res_process(srv->st_res[i_mic][i_ref], srv->doubletalk_result[i_mic], 1);
+		if (0 != ret_process)
+		{
+			return ERR_AEC;
+		}
+	}		
+
+	/* double talk process */
+	for (ii = 0; ii< srv->sub_num; ii++)
+	{
+		srv->st_doubletalk[i_mic]->res1_psd[ii] = complex_abs2(srv->firfilter_out[i_mic][ii]);
+	}
+	srv->st_doubletalk[i_mic]->mic_noise_bin = srv->st_firfilter[i_mic]->noise_est_mic_chan;
+	srv->st_doubletalk[i_mic]->erl_ratio = srv->st_firfilter[i_mic]->erl_ratio;
+	srv->st_doubletalk[i_mic]->far_end_talk_holdtime = srv->far_end_talk_holdtime;
+	ret_process = dios_ssp_aec_doubletalk_process(srv->st_doubletalk[i_mic], &srv->doubletalk_result[i_mic]);
+	if (0 != ret_process)
+	{
+		return ERR_AEC;
+	}
+
+	/* 2nd stage residual echo suppression */
+	for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
+	{
+		srv->st_res[i_mic][i_ref]->Xf_res_echo = srv->final_out[i_mic];
+		srv->st_res[i_mic][i_ref]->Xf_echo = srv->est_echo[i_mic];
+		ret_process = dios_ssp_aec_res_process(srv->st_res[i_mic][i_ref], srv->doubletalk_result[i_mic], 2);
+		if (0 != ret_process)
+		{
+			return ERR_AEC;
+		}
+	}
+
+	/* subband compose */
+	ret_process = dios_ssp_share_subband_compose(srv->st_subband_mic[i_mic], srv->final_out[i_mic], &srv->io_buf[i_mic * srv->frm_len]);
+	if (0 != ret_process)
+	{
+		return ERR_AEC;
+	}
+
+	return 0;
+}
+
+static void dios_ssp_aec_mic_task(void* arg, int i_mic)
+{
+	objAEC* srv = (objAEC*)arg;
+	srv->mic_ret[i_mic] = dios_ssp_aec_mic_process(srv, i_mic);
+}
+
 // main function processed by AEC
 int dios_ssp_aec_process_api(void* ptr, float* io_buf, float* ref_buf, int* dt_st)
 {
@@ -347,7 +507,7 @@ int dios_ssp_aec_process_api(void* ptr, float* io_buf, float* ref_buf, int* dt_s
 	int ret_process = 0;
 	int i_mic;
 	int i_ref;
-	int i, ii;
+	int i;
 	int ch;
 	int far_end_talk_flag = 0;
 
@@ -428,7 +588,7 @@ int dios_ssp_aec_process_api(void* ptr, float* io_buf, float* ref_buf, int* dt_s
 		}		
 
 		/* get reference signal psd */
-		for(ch = 0; ch < AEC_SUBBAND_NUM; ch++)
+		for(ch = 0; ch < srv->sub_num; ch++)
 		{
 			srv->ref_psd[i_ref][ch] = complex_abs2(srv->input_ref_subband[i_ref][ch]);
 		}
@@ -456,95 +616,19 @@ int dios_ssp_aec_process_api(void* ptr, float* io_buf, float* ref_buf, int* dt_s
 		}
     }
 		
-    for (i_mic = 0; i_mic < srv->mic_num; i_mic++)
-    {
-		/* mic subband analyse */
-		ret_process = dios_ssp_share_subband_analyse(srv->st_subband_mic[i_mic], srv->input_mic_time[i_mic], srv->input_mic_subband[i_mic]);
-		if (0 != ret_process) 
-		{
-			return ERR_AEC;
-		}
-		/* fir filter process */
-		srv->st_firfilter[i_mic]->far_end_talk_holdtime = srv->far_end_talk_holdtime;
-		srv->st_firfilter[i_mic]->dt_status = &srv->doubletalk_result[i_mic];
-
-		srv->st_firfilter[i_mic]->sig_mic_rec = srv->input_mic_subband[i_mic];
-		srv->st_firfilter[i_mic]->sig_spk_ref = srv->input_ref_subband;
-
-		srv->st_firfilter[i_mic]->noise_est_spk_part = srv->st_noise_est_spk_subband;
-		srv->st_firfilter[i_mic]->noise_est_spk_t = srv->st_noise_est_spk_t;
-
-		srv->st_firfilter[i_mic]->band_table = srv->band_table;
-		srv->st_firfilter[i_mic]->spk_part_band_energy = srv->spk_part_band_energy;
-		srv->st_firfilter[i_mic]->spk_peak = srv->spk_peak;
-		ret_process = dios_ssp_aec_firfilter_process(srv->st_firfilter[i_mic], srv->firfilter_out[i_mic], srv->est_echo[i_mic]);
-		if (0 != ret_process) 
-		{
-			return ERR_AEC;
-		}
-
-		/* save for 2nd stage res */
-		/* The 1st stage residual echo processing is to judge the double-talk state */
-		memcpy(srv->final_out[i_mic], srv->firfilter_out[i_mic], sizeof(xcomplex) * AEC_SUBBAND_NUM);
-		
-		/* ERL estimate */
-		ret_process = dios_ssp_aec_erl_est_process(srv->st_firfilter[i_mic]);
-		if (ret_process != 0)
-		{
-			return ERR_AEC;
-		}
-		
-		/* aec output noise tracking */
-		for (ch = AEC_LOW_CHAN; ch < AEC_HIGH_CHAN; ch++)
-		{
-			if (srv->far_end_talk_holdtime == 0)
-			{
-				dios_ssp_share_noiselevel_process(srv->st_firfilter[i_mic]->noise_est_mic_chan[ch], srv->st_firfilter[i_mic]->power_mic_send_smooth[ch]);
-			}
-		}
-
-		/* 1st stage residual echo suppression to improve dtd result */
-		for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
-		{
-			srv->st_res[i_mic][i_ref]->Xf_res_echo = srv->firfilter_out[i_mic];
-			srv->st_res[i_mic][i_ref]->Xf_echo = srv->est_echo[i_mic];
-			/* dtd result input(the 2nd parameter) is only for stage two, so this dtd result is useless */
-			ret_process = dios_ssp_aec_res_process(srv->st_res[i_mic][i_ref], srv->doubletalk_result[i_mic], 1);
-			if (0 != ret_process)
-			{
-				return ERR_AEC;
-			}
-		}		
-
-		/* double talk process */
-		for (ii = 0; ii< AEC_SUBBAND_NUM; ii++)
-		{
-			srv->st_doubletalk[i_mic]->res1_psd[ii] = complex_abs2(srv->firfilter_out[i_mic][ii]);
-		}
-		srv->st_doubletalk[i_mic]->mic_noise_bin = srv->st_firfilter[i_mic]->noise_est_mic_chan;
-		srv->st_doubletalk[i_mic]->erl_ratio = srv->st_firfilter[i_mic]->erl_ratio;
-		srv->st_doubletalk[i_mic]->far_end_talk_holdtime = srv->far_end_talk_holdtime;
-		ret_process = dios_ssp_aec_doubletalk_process(srv->st_doubletalk[i_mic], &srv->doubletalk_result[i_mic]);
-		if (0 != ret_process)
+	/* microphone channels are independent of each other */
+	srv->io_buf = io_buf;
+	ret_process = dios_ssp_share_workpool_run(srv->workpool, dios_ssp_aec_mic_task, srv, srv->mic_num);
+	if (0 != ret_process)
+	{
+		return ERR_AEC;
+	}
+	for (i_mic = 0; i_mic < srv->mic_num; i_mic++)
+	{
+		if (0 != srv->mic_ret[i_mic])
 		{
 			return ERR_AEC;
 		}
-		
-		/* 2nd stage residual echo suppression */
-		for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
-		{
-			srv->st_res[i_mic][i_ref]->Xf_res_echo = srv->final_out[i_mic];
-			srv->st_res[i_mic][i_ref]->Xf_echo = srv->est_echo[i_mic];
-			ret_process = dios_ssp_aec_res_process(srv->st_res[i_mic][i_ref], srv->doubletalk_result[i_mic], 2);
-			if (0 != ret_process)
-			{
-				return ERR_AEC;
-			}
-		}
-
-		/* subband compose */
-		ret_process = dios_ssp_share_subband_compose(srv->st_subband_mic[i_mic], srv->final_out[i_mic], &io_buf[i_mic * srv->frm_len]);
-		
 	}
     dt_st[0] = srv->doubletalk_result[0];
     return 0;
@@ -563,51 +647,61 @@ int dios_ssp_aec_uninit_api(void* ptr)
 		return ERR_AEC;
 	}
 
+	if (NULL != srv->workpool)
+	{
+		ret = dios_ssp_share_workpool_uninit(srv->workpool);
+		if (0 != ret)
+		{
+			return ERR_AEC;
+		}
+	}
+
 	/* buffer memory free */
 	for (i_mic = 0; i_mic < srv->mic_num; i_mic++)
 	{
-		free(srv->input_mic_time[i_mic]);
-		free(srv->input_mic_subband[i_mic]);
-		free(srv->firfilter_out[i_mic]);
-		free(srv->final_out[i_mic]);
-		free(srv->est_echo[i_mic]);		
-	}
-	free(srv->mic_tde);
-	free(srv->doubletalk_result);
-	free(srv->input_mic_time);
-	free(srv->input_mic_subband);
-	free(srv->firfilter_out);
-	free(srv->final_out);
-	free(srv->est_echo);
+		dios_ssp_share_free(srv->input_mic_time[i_mic]);
+		dios_ssp_share_free(srv->input_mic_subband[i_mic]);
+		dios_ssp_share_free(srv->firfilter_out[i_mic]);
+		dios_ssp_share_free(srv->final_out[i_mic]);
+		dios_ssp_share_free(srv->est_echo[i_mic]);		
+	}
+	dios_ssp_share_free(srv->mic_tde);
+	dios_ssp_share_free(srv->doubletalk_result);
+	dios_ssp_share_free(srv->mic_ret);
+	dios_ssp_share_free(srv->input_mic_time);
+	dios_ssp_share_free(srv->input_mic_subband);
+	dios_ssp_share_free(srv->firfilter_out);
+	dios_ssp_share_free(srv->final_out);
+	dios_ssp_share_free(srv->est_echo);
 	
 	for (i = 0; i < ERL_BAND_NUM; i++)
 	{
-		free(srv->band_table[i]);
+		dios_ssp_share_free(srv->band_table[i]);
 	}
-	free(srv->band_table);
+	dios_ssp_share_free(srv->band_table);
 	for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
 	{
-		free(srv->input_ref_time[i_ref]);
-		free(srv->input_ref_subband[i_ref]);
-		free(srv->st_noise_est_spk_t[i_ref]);
-		free(srv->ref_psd[i_ref]);
-		free(srv->spk_peak[i_ref]);
+		dios_ssp_share_free(srv->input_ref_time[i_ref]);
+		dios_ssp_share_free(srv->input_ref_subband[i_ref]);
+		dios_ssp_share_free(srv->st_noise_est_spk_t[i_ref]);
+		dios_ssp_share_free(srv->ref_psd[i_ref]);
+		dios_ssp_share_free(srv->spk_peak[i_ref]);
 		for (i = 0; i < ERL_BAND_NUM; i++)
 		{
-			free(srv->st_noise_est_spk_subband[i_ref][i]);
+			dios_ssp_share_free(srv->st_noise_est_spk_subband[i_ref][i]);
 		}
-		free(srv->st_noise_est_spk_subband[i_ref]);
-	}
-	free(srv->st_noise_est_spk_t);
-	free(srv->st_noise_est_spk_subband);
-	free(srv->spk_peak);
-	free(srv->ref_psd);
-	free(srv->abs_ref_avg);
-	free(srv->ref_buffer);
-	free(srv->ref_tde);
-	free(srv->input_ref_time);
-	free(srv->input_ref_subband);
-	free(srv->spk_part_band_energy);
+		dios_ssp_share_free(srv->st_noise_est_spk_subband[i_ref]);
+	}
+	dios_ssp_share_free(srv->st_noise_est_spk_t);
+	dios_ssp_share_free(srv->st_noise_est_spk_subband);
+	dios_ssp_share_free(srv->spk_peak);
+	dios_ssp_share_free(srv->ref_psd);
+	dios_ssp_share_free(srv->abs_ref_avg);
+	dios_ssp_share_free(srv->ref_buffer);
+	dios_ssp_share_free(srv->ref_tde);
+	dios_ssp_share_free(srv->input_ref_time);
+	dios_ssp_share_free(srv->input_ref_subband);
+	dios_ssp_share_free(srv->spk_part_band_energy);
 
 	ret = dios_ssp_aec_tde_uninit(srv->st_tde);
 	if (0 != ret)
@@ -624,7 +718,7 @@ int dios_ssp_aec_uninit_api(void* ptr)
 			return ERR_AEC;
 		}
 	}
-	free(srv->st_subband_ref);
+	dios_ssp_share_free(srv->st_subband_ref);
 
 	/* microphone number related uninit */
 	for (i_mic = 0; i_mic < srv->mic_num; i_mic++)
@@ -650,7 +744,7 @@ int dios_ssp_aec_uninit_api(void* ptr)
 				return ERR_AEC;
 			}
 		}
-		free(srv->st_res[i_mic]);
+		dios_ssp_share_free(srv->st_res[i_mic]);
 
 		/* double talk uninit */
 		ret = dios_ssp_aec_doubletalk_uninit(srv->st_doubletalk[i_mic]);
@@ -659,11 +753,11 @@ int dios_ssp_aec_uninit_api(void* ptr)
 			return ERR_AEC;
 		}		
 	}
-	free(srv->st_subband_mic);
-	free(srv->st_firfilter);
-	free(srv->st_res);
-	free(srv->st_doubletalk);
-	free(srv);
+	dios_ssp_share_free(srv->st_subband_mic);
+	dios_ssp_share_free(srv->st_firfilter);
+	dios_ssp_share_free(srv->st_res);
+	dios_ssp_share_free(srv->st_doubletalk);
+	dios_ssp_share_free(srv);
 
 	return 0;
 }
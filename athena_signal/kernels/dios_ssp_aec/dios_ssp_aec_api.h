@@ -28,18 +28,40 @@ limitations under the License.
 #include "./dios_ssp_aec_tde/dios_ssp_aec_tde.h"
 #include "../dios_ssp_share/dios_ssp_share_subband.h"
 #include "../dios_ssp_share/dios_ssp_share_complex_defs.h"
+#include "../dios_ssp_share/dios_ssp_share_workpool.h"
 
 /**********************************************************************************
 Function:      // dios_ssp_aec_init_api
 Description:   // load configure file and allocate memory
 Input:         // mic_num: microphone number
 	              ref_num: reference number
-				  frm_len: frame length
+				  frm_len: frame length, must be sample_rate / 125 (8ms)
+				  sample_rate: 8000, 16000, 32000 or 48000
 Output:        // none
 Return:        // success: return dios speech signal process aec pointer
 	              failure: return NULL
 **********************************************************************************/
-void* dios_ssp_aec_init_api(int mic_num, int ref_num, int frm_len);
+void* dios_ssp_aec_init_api(int mic_num, int ref_num, int frm_len, int sample_rate);
+
+/**********************************************************************************
+Function:      // dios_ssp_aec_multithread_init_api
+Description:   // same as dios_ssp_aec_init_api, the microphone channels are
+                  processed in parallel on a pool of persistent threads, the
+                  output is identical to the single thread one
+Input:         // mic_num: microphone number
+	              ref_num: reference number
+				  frm_len: frame length, must be sample_rate / 125 (8ms)
+				  sample_rate: 8000, 16000, 32000 or 48000
+				  thread_num: number of threads including the caller, 1 ~ 32,
+				              1 processes the channels one after another
+				  table_pool: pool of read-only tables shared with other instances,
+				              see dios_ssp_share_table.h, NULL for private tables
+Output:        // none
+Return:        // success: return dios speech signal process aec pointer
+	              failure: return NULL
+**********************************************************************************/
+void* dios_ssp_aec_multithread_init_api(int mic_num, int ref_num, int frm_len, int sample_rate, int thread_num,
+										void* table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_aec_config_api
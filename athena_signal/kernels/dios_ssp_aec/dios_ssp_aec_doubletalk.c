@@ -19,32 +19,42 @@ the 1st-stage residual echo suppression.
 
 /* include file */
 #include "dios_ssp_aec_doubletalk.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
-objDoubleTalk* dios_ssp_aec_doubletalk_init(int ref_num)
+static const size_t g_doubletalk_ptr[] = {
+	offsetof(objDoubleTalk, sig_spk_ref), offsetof(objDoubleTalk, sig_mic_rec),
+	offsetof(objDoubleTalk, res1_psd), offsetof(objDoubleTalk, res1_sum),
+	offsetof(objDoubleTalk, res1_eng_avg_buf), offsetof(objDoubleTalk, res1_min_avg_buf),
+	offsetof(objDoubleTalk, mic_noiselevel_sum), offsetof(objDoubleTalk, erl_ratio),
+	offsetof(objDoubleTalk, doubletalk_band_table), offsetof(objDoubleTalk, mic_noise_bin)
+};
+
+objDoubleTalk* dios_ssp_aec_doubletalk_init(int ref_num, int sub_num)
 {
 	int i;
 	int j;
 	int ret = 0;
 	objDoubleTalk* srv = NULL;
 
-	srv = (objDoubleTalk*)calloc(1, sizeof(objDoubleTalk));
+	srv = (objDoubleTalk*)dios_ssp_share_calloc_map(1, sizeof(objDoubleTalk), g_doubletalk_ptr, SHARE_ARENA_MAP_NUM(g_doubletalk_ptr));
 
 	srv->ref_num = ref_num;
+	srv->sub_num = sub_num;
 
 	srv->dt_num_bands = (int)(((float)DT_FREQ_HI - DT_FREQ_LO) / DT_FREQ_DELTA + 0.5);
 	
-	srv->doubletalk_band_table = (int **)calloc(srv->dt_num_bands, sizeof(int*));
+	srv->doubletalk_band_table = (int **)dios_ssp_share_calloc_ptr(srv->dt_num_bands, sizeof(int*));
 	for (i = 0; i<srv->dt_num_bands; i++)
 	{
-		srv->doubletalk_band_table[i] = (int *)calloc(2, sizeof(int));
+		srv->doubletalk_band_table[i] = (int *)dios_ssp_share_calloc(2, sizeof(int));
 	}
 	
-	srv->res1_psd = (float*)calloc(AEC_SUBBAND_NUM, sizeof(float));
-	srv->res1_sum = (float *)calloc(srv->dt_num_bands, sizeof(float));
-	srv->res1_eng_avg_buf = (float *)calloc(DT_RES1_ENG_BUF_LEN, sizeof(float));
-	srv->res1_min_avg_buf = (float *)calloc(DT_RES1_MIN_BUF_LEN, sizeof(float));
+	srv->res1_psd = (float*)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+	srv->res1_sum = (float *)dios_ssp_share_calloc(srv->dt_num_bands, sizeof(float));
+	srv->res1_eng_avg_buf = (float *)dios_ssp_share_calloc(DT_RES1_ENG_BUF_LEN, sizeof(float));
+	srv->res1_min_avg_buf = (float *)dios_ssp_share_calloc(DT_RES1_MIN_BUF_LEN, sizeof(float));
 	
-	srv->mic_noiselevel_sum = (float *)calloc(srv->dt_num_bands, sizeof(float));
+	srv->mic_noiselevel_sum = (float *)dios_ssp_share_calloc(srv->dt_num_bands, sizeof(float));
 
 	/* double talk band table init */
 	srv->doubletalk_band_table[0][0] = (int)((float)DT_FREQ_LO * AEC_FFT_LEN / AEC_SAMPLE_RATE);
@@ -54,6 +64,17 @@ objDoubleTalk* dios_ssp_aec_doubletalk_init(int ref_num)
 		srv->doubletalk_band_table[j - 1][1] = srv->doubletalk_band_table[j][0] - 1;
 	}
 	srv->doubletalk_band_table[j - 1][1] = (int)((float)DT_FREQ_HI * AEC_FFT_LEN / AEC_SAMPLE_RATE);
+	/* bands above the nyquist frequency of low sampling rates are cut to the last bin */
+	for (i = 0; i < srv->dt_num_bands; i++)
+	{
+		for (j = 0; j < 2; j++)
+		{
+			if (srv->doubletalk_band_table[i][j] > srv->sub_num - 1)
+			{
+				srv->doubletalk_band_table[i][j] = srv->sub_num - 1;
+			}
+		}
+	}
 	
 	ret = dios_ssp_aec_doubletalk_reset(srv);
 	if (0 != ret)
@@ -201,15 +222,15 @@ int dios_ssp_aec_doubletalk_uninit(objDoubleTalk* srv)
 	}
 	for (i = 0; i<srv->dt_num_bands; i++)
 	{
-		free(srv->doubletalk_band_table[i]);
+		dios_ssp_share_free(srv->doubletalk_band_table[i]);
 	}
-	free(srv->doubletalk_band_table);
-
-	free(srv->res1_psd);	
-	free(srv->res1_sum);
-	free(srv->res1_eng_avg_buf);
-	free(srv->res1_min_avg_buf);
-	free(srv->mic_noiselevel_sum);
-	free(srv);
+	dios_ssp_share_free(srv->doubletalk_band_table);
+
+	dios_ssp_share_free(srv->res1_psd);	
+	dios_ssp_share_free(srv->res1_sum);
+	dios_ssp_share_free(srv->res1_eng_avg_buf);
+	dios_ssp_share_free(srv->res1_min_avg_buf);
+	dios_ssp_share_free(srv->mic_noiselevel_sum);
+	dios_ssp_share_free(srv);
 	return 0;
 }
@@ -28,6 +28,7 @@ typedef struct {
 	xcomplex** sig_spk_ref;
 	xcomplex* sig_mic_rec;
 	int ref_num;
+	int sub_num;
 	float* res1_psd;
 	float* res1_sum;
 	float res1_eng_avg;
@@ -51,11 +52,12 @@ typedef struct {
 Function:      // dios_ssp_aec_doubletalk_init
 Description:   // load configure file and allocate memory
 Input:         // ref_num: reference number
+                  sub_num: subband number
 Output:        // none
 Return:        // success: return dios speech signal process aec doubletalk pointer
 	              failure: return NULL
 **********************************************************************************/
-objDoubleTalk* dios_ssp_aec_doubletalk_init(int ref_num);
+objDoubleTalk* dios_ssp_aec_doubletalk_init(int ref_num, int sub_num);
 
 /**********************************************************************************
 Function:      // dios_ssp_aec_doubletalk_reset
@@ -34,7 +34,7 @@ int dios_ssp_aec_erl_est_process(objFirFilter* srv)
 		return ERR_AEC;
 	}
 
-	for (ch = AEC_LOW_CHAN; ch < AEC_HIGH_CHAN; ch++)
+	for (ch = AEC_LOW_CHAN; ch < srv->sub_num; ch++)
 	{
 		/* get psd */		
 		srv->mic_rec_psd[ch] = complex_abs2(srv->sig_mic_rec[ch]);/* mic record signal */
@@ -46,7 +46,7 @@ int dios_ssp_aec_erl_est_process(objFirFilter* srv)
 			srv->power_echo_rtn_adpt[i_spk][ch] = complex_abs2(srv->est_ref_adf[i_spk][ch]);
 		}
 	}
-	for (ch = AEC_LOW_CHAN; ch < AEC_HIGH_CHAN; ch++)
+	for (ch = AEC_LOW_CHAN; ch < srv->sub_num; ch++)
 	{
 		if (srv->energy_err_fir[ch] < srv->energy_err_adf[ch])
 		{
@@ -17,10 +17,109 @@ Description: the core part of linear echo cancellation. The filter coefficients
 consist of two groups for stability of filter: adf_coef and fir_coef, the best 
 one will be chosen according to the residual error signal level, the adf_coef 
 is updated with IPNLMS. 
+In the fixed-point build the taps are Q27, the reference history of each subband
+is a block with its own exponent and the convolution, the power and the tap
+update run in integer, the step size normalization stays in float.
 ==============================================================================*/
 
 /* include file */
 #include "dios_ssp_aec_firfilter.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
+
+/* offset of the first tap of subband ch of reference i_ref */
+#define AEC_TAP_OFFSET(i_ref, ch)   (((i_ref) * srv->sub_num + (ch)) * AEC_TAP_STRIDE)
+
+#if DIOS_SSP_FIXED_POINT
+#define AEC_FIX_TAP_FRAC			(27)	/* taps are Q27 */
+#define AEC_FIX_STACK_HEADROOM		(4)		/* reference history |x| < 2^27 */
+
+/* push a reference sample into the history block of one subband, then
+   renormalize the block to AEC_FIX_STACK_HEADROOM bits of headroom */
+static void aec_fix_stack_push(int *x_r, int *x_i, int M, int *exp, xcomplex in)
+{
+	float peak = fabsf(in.r) > fabsf(in.i) ? fabsf(in.r) : fabsf(in.i);
+	int e = 0;
+	int shift;
+	int headroom;
+	long long v;
+
+	/* make room for the new sample: peak < 2^e */
+	if (peak > 0.0f && isfinite(peak))
+	{
+		frexpf(peak, &e);
+		shift = e - (31 - AEC_FIX_STACK_HEADROOM) - *exp;
+		if (shift > 0)
+		{
+			dios_ssp_share_fixed_shift(x_r + 1, M - 1, -shift);
+			dios_ssp_share_fixed_shift(x_i + 1, M - 1, -shift);
+			*exp += shift;
+		}
+	}
+	v = llrint(ldexp(in.r, -*exp));
+	x_r[0] = FIX_SAT32(v);
+	v = llrint(ldexp(in.i, -*exp));
+	x_i[0] = FIX_SAT32(v);
+
+	headroom = dios_ssp_share_fixed_headroom(x_r, M);
+	shift = dios_ssp_share_fixed_headroom(x_i, M);
+	headroom = shift < headroom ? shift : headroom;
+	if (headroom < 31 && headroom > AEC_FIX_STACK_HEADROOM)
+	{
+		dios_ssp_share_fixed_shift(x_r, M, headroom - AEC_FIX_STACK_HEADROOM);
+		dios_ssp_share_fixed_shift(x_i, M, headroom - AEC_FIX_STACK_HEADROOM);
+		*exp -= headroom - AEC_FIX_STACK_HEADROOM;
+	}
+}
+
+/* kl[m] = kl_base + kl_scale * src[m] * 2^-src_frac / kl_norm in Q30, the
+   float scalar is split into a Q30 mantissa and a shift once per call */
+static void aec_fix_kl(const long long *src, int src_frac, int M, float kl_base, 
+	float kl_scale, float kl_norm, int *kl)
+{
+	int m;
+	int e = 0;
+	int shift;
+	int b = dios_ssp_share_fixed_bits64(src, M) - 31;
+	long long base = llrint(ldexp(kl_base, 30));
+	long long mant;
+	long long v;
+
+	b = b > 0 ? b : 0;
+	/* src >> b times c = mant * 2^(e - 30) */
+	mant = llrint(ldexp(frexp(kl_scale * ldexp(1.0, 30 - src_frac + b) / kl_norm, &e), 30));
+	shift = 30 - e;
+	for (m = 0; m < M; m++)
+	{
+		v = b > 0 ? (src[m] + (1LL << (b - 1))) >> b : src[m];
+		v *= mant;
+		if (shift > 0)
+		{
+			v = shift < 63 ? (v + (1LL << (shift - 1))) >> shift : 0;
+		}
+		else
+		{
+			v = FIX_SAT32(v) * (1LL << (-shift < 31 ? -shift : 31));
+		}
+		v += base;
+		kl[m] = FIX_SAT32(v);
+	}
+}
+
+/* h + u * 2^-shift, saturated */
+static int aec_fix_tap_add(int h, long long u, int shift)
+{
+	if (shift > 0)
+	{
+		u = shift < 63 ? (u + (1LL << (shift - 1))) >> shift : 0;
+	}
+	else
+	{
+		u = FIX_SAT32(u) * (1LL << (-shift < 31 ? -shift : 31));
+	}
+	u += h;
+	return FIX_SAT32(u);
+}
+#endif
 
 /* estimate echo and calculate residual */
 void dios_ssp_aec_residual(objFirFilter *srv)
@@ -30,26 +129,66 @@ void dios_ssp_aec_residual(objFirFilter *srv)
 	int i;
 	for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
     {
-		for (ch = AEC_LOW_CHAN; ch < AEC_HIGH_CHAN; ch++)
+		for (ch = AEC_LOW_CHAN; ch < srv->sub_num; ch++)
 		{
+			int M = srv->num_main_subband_adf[ch];
+			int offset = AEC_TAP_OFFSET(i_ref, ch);
+			aec_tap_t *x_r = srv->stack_sigIn_adf_r + offset;
+			aec_tap_t *x_i = srv->stack_sigIn_adf_i + offset;
+			const aec_tap_t *fir_r = srv->fir_coef_r + offset;
+			const aec_tap_t *fir_i = srv->fir_coef_i + offset;
+			const aec_tap_t *adf_r = srv->adf_coef_r + offset;
+			const aec_tap_t *adf_i = srv->adf_coef_i + offset;
+			xcomplex y_fir = {0.0f, 0.0f};
+			xcomplex y_adf = {0.0f, 0.0f};
+			float power = 0.0f;
+
 			/* get reference vector for fir filter */
-			complex_data_push(srv->num_main_subband_adf[ch] + 1, srv->sig_spk_ref[i_ref][ch], srv->stack_sigIn_adf[i_ref][ch]);
-			
-			/* get echo signal: conv: y = conj(h) * x */
-			srv->est_ref_fir[i_ref][ch] = complex_conv(srv->num_main_subband_adf[ch], srv->fir_coef[i_ref][ch],
-					srv->stack_sigIn_adf[i_ref][ch]);
-			srv->est_ref_adf[i_ref][ch] = complex_conv(srv->num_main_subband_adf[ch], srv->adf_coef[i_ref][ch], 
-					srv->stack_sigIn_adf[i_ref][ch]);
-			
-			/* get power of reference vector */
-			srv->power_in_ntaps_smooth[i_ref][ch] = 0.0f;
-			for (i = 0; i < srv->num_main_subband_adf[ch]; i++)
+			memmove(x_r + 1, x_r, M * sizeof(aec_tap_t));
+			memmove(x_i + 1, x_i, M * sizeof(aec_tap_t));
+#if DIOS_SSP_FIXED_POINT
+			int *x_exp = srv->stack_exp + i_ref * srv->sub_num + ch;
+			long long acc_fir_r = 0;
+			long long acc_fir_i = 0;
+			long long acc_adf_r = 0;
+			long long acc_adf_i = 0;
+			long long acc_power = 0;
+
+			aec_fix_stack_push(x_r, x_i, M, x_exp, srv->sig_spk_ref[i_ref][ch]);
+			for (i = 0; i < M; i++)
+			{
+				acc_fir_r += (long long)fir_r[i] * x_r[i] + (long long)fir_i[i] * x_i[i];
+				acc_fir_i += (long long)fir_r[i] * x_i[i] - (long long)fir_i[i] * x_r[i];
+				acc_adf_r += (long long)adf_r[i] * x_r[i] + (long long)adf_i[i] * x_i[i];
+				acc_adf_i += (long long)adf_r[i] * x_i[i] - (long long)adf_i[i] * x_r[i];
+				acc_power += (long long)x_r[i] * x_r[i] + (long long)x_i[i] * x_i[i];
+			}
+			y_fir.r = (float)ldexp((double)acc_fir_r, *x_exp - AEC_FIX_TAP_FRAC);
+			y_fir.i = (float)ldexp((double)acc_fir_i, *x_exp - AEC_FIX_TAP_FRAC);
+			y_adf.r = (float)ldexp((double)acc_adf_r, *x_exp - AEC_FIX_TAP_FRAC);
+			y_adf.i = (float)ldexp((double)acc_adf_i, *x_exp - AEC_FIX_TAP_FRAC);
+			power = (float)ldexp((double)acc_power, 2 * *x_exp);
+#else
+			x_r[0] = srv->sig_spk_ref[i_ref][ch].r;
+			x_i[0] = srv->sig_spk_ref[i_ref][ch].i;
+
+			/* get echo signal: conv: y = conj(h) * x, both filters and the
+			   power of reference vector in one pass over the taps */
+			for (i = 0; i < M; i++)
 			{
-			    srv->power_in_ntaps_smooth[i_ref][ch] += complex_abs2(srv->stack_sigIn_adf[i_ref][ch][i]);
+				y_fir.r += fir_r[i] * x_r[i] - (-fir_i[i]) * x_i[i];
+				y_fir.i += (-fir_i[i]) * x_r[i] + fir_r[i] * x_i[i];
+				y_adf.r += adf_r[i] * x_r[i] - (-adf_i[i]) * x_i[i];
+				y_adf.i += (-adf_i[i]) * x_r[i] + adf_r[i] * x_i[i];
+				power += x_r[i] * x_r[i] + x_i[i] * x_i[i];
 			}
+#endif
+			srv->est_ref_fir[i_ref][ch] = y_fir;
+			srv->est_ref_adf[i_ref][ch] = y_adf;
+			srv->power_in_ntaps_smooth[i_ref][ch] = power;
 		}
     }
-	for (ch = AEC_LOW_CHAN; ch < AEC_HIGH_CHAN; ch++)
+	for (ch = AEC_LOW_CHAN; ch < srv->sub_num; ch++)
 	{
 		/* get total error signal for each reference signal */
         srv->err_fir[ch] = complex_sub(srv->sig_mic_rec[ch], srv->est_ref_fir[0][ch]);
@@ -69,19 +208,17 @@ void dios_ssp_aec_residual(objFirFilter *srv)
 /* filter convergence detection */
 void dios_ssp_aec_firfilter_detect(objFirFilter *srv)
 {
-	int ch, i_ref, i;
-	for (ch = AEC_LOW_CHAN; ch < AEC_HIGH_CHAN; ch++)
+	int ch, i_ref;
+	for (ch = AEC_LOW_CHAN; ch < srv->sub_num; ch++)
     {
+		int M = srv->num_main_subband_adf[ch];
 		/* filter convergence detection */
 		if (srv->mse_adpt[ch] > srv->mse_mic_in[ch] * MSE_RATIO_OUT_IN)
 		{
 			for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
-			{			 
-				for (i = 0; i < srv->num_main_subband_adf[ch]; i++)
-				{
-					srv->adf_coef[i_ref][ch][i].r = 0.0;
-					srv->adf_coef[i_ref][ch][i].i = 0.0;
-				}
+			{
+				memset(srv->adf_coef_r + AEC_TAP_OFFSET(i_ref, ch), 0, M * sizeof(aec_tap_t));
+				memset(srv->adf_coef_i + AEC_TAP_OFFSET(i_ref, ch), 0, M * sizeof(aec_tap_t));
 			}
 			srv->mse_mic_in[ch] = 0.0;
 			srv->mse_adpt[ch] = 0.0;
@@ -91,11 +228,9 @@ void dios_ssp_aec_firfilter_detect(objFirFilter *srv)
 				&& (srv->mse_adpt[ch] < FILTER_COPY_FAC * srv->mse_main[ch]))
 		{
 			for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
-			{				
-				for (i = 0; i < srv->num_main_subband_adf[ch]; i++)
-				{
-					srv->fir_coef[i_ref][ch][i] = srv->adf_coef[i_ref][ch][i];
-				}
+			{
+				memcpy(srv->fir_coef_r + AEC_TAP_OFFSET(i_ref, ch), srv->adf_coef_r + AEC_TAP_OFFSET(i_ref, ch), M * sizeof(aec_tap_t));
+				memcpy(srv->fir_coef_i + AEC_TAP_OFFSET(i_ref, ch), srv->adf_coef_i + AEC_TAP_OFFSET(i_ref, ch), M * sizeof(aec_tap_t));
 			}
 			srv->mse_mic_in[ch] = 0.0;
 			srv->mse_adpt[ch] = 0.0;
@@ -105,12 +240,9 @@ void dios_ssp_aec_firfilter_detect(objFirFilter *srv)
 		if (srv->mse_main[ch] > srv->mse_mic_in[ch] * MSE_RATIO_OUT_IN)
 		{
 			for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
-			{				
-				for (i = 0; i < srv->num_main_subband_adf[ch]; i++)
-				{
-					srv->fir_coef[i_ref][ch][i].r = 0.0;
-					srv->fir_coef[i_ref][ch][i].i = 0.0;
-				}
+			{
+				memset(srv->fir_coef_r + AEC_TAP_OFFSET(i_ref, ch), 0, M * sizeof(aec_tap_t));
+				memset(srv->fir_coef_i + AEC_TAP_OFFSET(i_ref, ch), 0, M * sizeof(aec_tap_t));
 			}
 			srv->mse_main[ch] = 0.0;
 			srv->mse_adpt[ch] = 0.0;
@@ -121,10 +253,8 @@ void dios_ssp_aec_firfilter_detect(objFirFilter *srv)
 		{
 			for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
 			{
-				for (i = 0; i<srv->num_main_subband_adf[ch]; i++)
-				{
-					srv->adf_coef[i_ref][ch][i] = srv->fir_coef[i_ref][ch][i];
-				}
+				memcpy(srv->adf_coef_r + AEC_TAP_OFFSET(i_ref, ch), srv->fir_coef_r + AEC_TAP_OFFSET(i_ref, ch), M * sizeof(aec_tap_t));
+				memcpy(srv->adf_coef_i + AEC_TAP_OFFSET(i_ref, ch), srv->fir_coef_i + AEC_TAP_OFFSET(i_ref, ch), M * sizeof(aec_tap_t));
 			}
 			srv->mse_mic_in[ch] = 0.0;
 			srv->mse_adpt[ch] = 0.0;
@@ -140,7 +270,7 @@ void dios_ssp_estecho_output(objFirFilter *srv, xcomplex* output_buf, xcomplex*
 	int ch;
 	int i_ref;
 
-	for(ch = AEC_LOW_CHAN; ch < AEC_HIGH_CHAN; ch++)
+	for(ch = AEC_LOW_CHAN; ch < srv->sub_num; ch++)
 	{
 		srv->energy_err_fir[ch] = complex_abs2(srv->err_fir[ch]);
 		srv->energy_err_adf[ch] = complex_abs2(srv->err_adf[ch]);
@@ -193,117 +323,235 @@ int aec_channel_to_band(int **band_table, int ch)
 }
 
 /* filter coefficient update */
+#if DIOS_SSP_FIXED_POINT
+void ipnlms_complex(int ch, objFirFilter *srv, int i_ref)
+{
+    int ii_spk;
+	int m, M = srv->num_main_subband_adf[ch];
+	float aec_ns_alpha = 0;
+	float myu = srv->weight[ch * 2];
+	float delta[2];
+	int delta_fix[2];
+	int delta_exp;
+	int x_exp;
+	int shift;
+	long long Padf = 0;
+	long long kl_src[NUM_MAX_BAND];
+	int kl_src_frac = 2 * AEC_FIX_TAP_FRAC - 8;
+	int kl[NUM_MAX_BAND];
+	float ip_alpha = 0.5;
+	long long x2_kl = 0;
+	float norm_aec = 0.0;
+	float kl_base = (1 - ip_alpha) / (2 * M);
+	float kl_scale = 1 + ip_alpha;
+	float kl_norm;
+	int *h_r = srv->adf_coef_r + AEC_TAP_OFFSET(i_ref, ch);
+	int *h_i = srv->adf_coef_i + AEC_TAP_OFFSET(i_ref, ch);
+	const int *x_r;
+	const int *x_i;
+	long long z_r;
+	long long z_i;
+
+	/* |h|^2 from taps reduced by 4 bits, so the sum fits int64 */
+	for (m = 0; m < M; m++)
+	{
+		kl_src[m] = (long long)(h_r[m] >> 4) * (h_r[m] >> 4) + (long long)(h_i[m] >> 4) * (h_i[m] >> 4);
+		Padf += kl_src[m];
+	}
+	kl_norm = (float)ldexp((double)Padf, -kl_src_frac) * 2 + 1e-5f;
+
+	for (ii_spk = 0; ii_spk < srv->ref_num; ii_spk++)
+	{
+		x_r = srv->stack_sigIn_adf_r + AEC_TAP_OFFSET(ii_spk, ch);
+		x_i = srv->stack_sigIn_adf_i + AEC_TAP_OFFSET(ii_spk, ch);
+		x_exp = srv->stack_exp[ii_spk * srv->sub_num + ch];
+		aec_fix_kl(kl_src, kl_src_frac, M, kl_base, kl_scale, kl_norm, kl);
+		for (m = 0; m < M; m++)
+		{
+			kl_src[m] = kl[m];
+		}
+		kl_src_frac = 30;
+		x2_kl = 0;
+		for (m = 0; m < M; m++)
+		{
+			x2_kl += (((long long)x_r[m] * x_r[m] + (long long)x_i[m] * x_i[m]) >> 28) * kl[m];
+		}
+		norm_aec += (float)ldexp((double)x2_kl, 2 * x_exp - 2);
+	}
+
+	aec_ns_alpha = myu / (norm_aec + 0.01f);
+	delta[0] = aec_ns_alpha * srv->err_adf[ch].r;
+	delta[1] = aec_ns_alpha * (-srv->err_adf[ch].i);
+	delta_exp = dios_ssp_share_fixed_from_float(delta, delta_fix, 2, 1);
+	x_r = srv->stack_sigIn_adf_r + AEC_TAP_OFFSET(i_ref, ch);
+	x_i = srv->stack_sigIn_adf_i + AEC_TAP_OFFSET(i_ref, ch);
+	x_exp = srv->stack_exp[i_ref * srv->sub_num + ch];
+	/* z = x * delta is rounded by 2^31, kl * z is brought to Q27 */
+	shift = -(AEC_FIX_TAP_FRAC + 1 + x_exp + delta_exp);
+	for (m = 0; m < M; m++)
+	{
+		z_r = (long long)x_r[m] * delta_fix[0] - (long long)x_i[m] * delta_fix[1];
+		z_i = (long long)x_i[m] * delta_fix[0] + (long long)x_r[m] * delta_fix[1];
+		z_r = (z_r + (1LL << 30)) >> 31;
+		z_i = (z_i + (1LL << 30)) >> 31;
+		h_r[m] = aec_fix_tap_add(h_r[m], z_r * kl[m], shift);
+		h_i[m] = aec_fix_tap_add(h_i[m], z_i * kl[m], shift);
+	}
+}
+#else
 void ipnlms_complex(int ch, objFirFilter *srv, int i_ref)
 {
     int ii_spk;
 	int m, M = srv->num_main_subband_adf[ch];
 	float aec_ns_alpha = 0;
 	float myu = srv->weight[ch * 2];
-	xcomplex delta, z;
+	xcomplex delta;
 	float Padf = 0.0;
 	float kl[NUM_MAX_BAND];
 	float ip_alpha = 0.5;
 	float x2_kl = 0.0;
 	float norm_aec = 0.0;
+	float kl_base = (1 - ip_alpha) / (2 * M);
+	float kl_scale = 1 + ip_alpha;
+	float kl_norm;
+	float *h_r = srv->adf_coef_r + AEC_TAP_OFFSET(i_ref, ch);
+	float *h_i = srv->adf_coef_i + AEC_TAP_OFFSET(i_ref, ch);
+	const float *x_r;
+	const float *x_i;
+
 	for (m = 0; m < M; m++)
 	{
-		kl[m] = complex_abs2(srv->adf_coef[i_ref][ch][m]);
+		kl[m] = h_r[m] * h_r[m] + h_i[m] * h_i[m];
 		Padf += kl[m];
 	}
-		
+	kl_norm = Padf * 2 + 1e-5f;
+
 	for (ii_spk = 0; ii_spk < srv->ref_num; ii_spk++)
 	{
+		x_r = srv->stack_sigIn_adf_r + AEC_TAP_OFFSET(ii_spk, ch);
+		x_i = srv->stack_sigIn_adf_i + AEC_TAP_OFFSET(ii_spk, ch);
+		for (m = 0; m < M; m++)
+		{
+			kl[m] = kl_base + kl_scale * kl[m] / kl_norm;
+		}
 		x2_kl = 0.0;
 		for (m = 0; m < M; m++)
 		{
-			kl[m] = (1 - ip_alpha) / (2 * M) + (1 + ip_alpha)*kl[m] / (Padf * 2 + 1e-5f);
-			x2_kl += complex_abs2(srv->stack_sigIn_adf[ii_spk][ch][m])*kl[m];
+			x2_kl += (x_r[m] * x_r[m] + x_i[m] * x_i[m]) * kl[m];
 		}
 		norm_aec += x2_kl;
 	}
 
 	aec_ns_alpha = myu / (norm_aec + 0.01f);
-	delta = complex_real_complex_mul(aec_ns_alpha, complex_conjg(srv->err_adf[ch]));
+	delta.r = aec_ns_alpha * srv->err_adf[ch].r;
+	delta.i = aec_ns_alpha * (-srv->err_adf[ch].i);
+	x_r = srv->stack_sigIn_adf_r + AEC_TAP_OFFSET(i_ref, ch);
+	x_i = srv->stack_sigIn_adf_i + AEC_TAP_OFFSET(i_ref, ch);
 	for (m = 0; m < M; m++)
 	{
-		z = complex_mul(srv->stack_sigIn_adf[i_ref][ch][m], delta);
-		z = complex_real_complex_mul(kl[m], z);
-		srv->adf_coef[i_ref][ch][m] = complex_add(srv->adf_coef[i_ref][ch][m], z);
+		float z_r = x_r[m] * delta.r - x_i[m] * delta.i;
+		float z_i = x_i[m] * delta.r + x_r[m] * delta.i;
+		h_r[m] = h_r[m] + kl[m] * z_r;
+		h_i[m] = h_i[m] + kl[m] * z_i;
 	}
 }
+#endif
+
+static const size_t g_firfilter_ptr[] = {
+	offsetof(objFirFilter, sig_spk_ref), offsetof(objFirFilter, sig_mic_rec),
+	offsetof(objFirFilter, err_out), offsetof(objFirFilter, num_main_subband_adf),
+	offsetof(objFirFilter, lambda), offsetof(objFirFilter, weight),
+	offsetof(objFirFilter, fir_coef_r), offsetof(objFirFilter, fir_coef_i),
+	offsetof(objFirFilter, adf_coef_r), offsetof(objFirFilter, adf_coef_i),
+	offsetof(objFirFilter, stack_sigIn_adf_r), offsetof(objFirFilter, stack_sigIn_adf_i),
+#if DIOS_SSP_FIXED_POINT
+	offsetof(objFirFilter, stack_exp),
+#endif
+	offsetof(objFirFilter, err_adf), offsetof(objFirFilter, err_fir),
+	offsetof(objFirFilter, est_ref_adf), offsetof(objFirFilter, est_ref_fir),
+	offsetof(objFirFilter, mse_main), offsetof(objFirFilter, mse_adpt),
+	offsetof(objFirFilter, mse_mic_in), offsetof(objFirFilter, power_in_ntaps_smooth),
+	offsetof(objFirFilter, mic_rec_psd), offsetof(objFirFilter, energy_err_fir),
+	offsetof(objFirFilter, energy_err_adf), offsetof(objFirFilter, power_mic_send_smooth),
+	offsetof(objFirFilter, power_echo_rtn_smooth), offsetof(objFirFilter, ref_psd),
+	offsetof(objFirFilter, power_echo_rtn_fir), offsetof(objFirFilter, power_echo_rtn_adpt),
+	offsetof(objFirFilter, band_table), offsetof(objFirFilter, spk_part_band_energy),
+	offsetof(objFirFilter, echo_return_band_energy), offsetof(objFirFilter, mic_rec_part_band_energy),
+	offsetof(objFirFilter, mic_send_part_band_energy), offsetof(objFirFilter, spk_peak),
+	offsetof(objFirFilter, mic_peak), offsetof(objFirFilter, erl_ratio),
+	offsetof(objFirFilter, noise_est_spk_t), offsetof(objFirFilter, noise_est_spk_part),
+	offsetof(objFirFilter, noise_est_mic_chan), offsetof(objFirFilter, dt_status)
+};
 
 //aec fir filter init
-objFirFilter* dios_ssp_aec_firfilter_init(int ref_num)
+objFirFilter* dios_ssp_aec_firfilter_init(int ref_num, int sub_num)
 {
 	int i;
 	int i_ref;
 	int ret = 0;
     objFirFilter* srv = NULL;
-    srv = (objFirFilter*)calloc(1, sizeof(objFirFilter));
+    srv = (objFirFilter*)dios_ssp_share_calloc_map(1, sizeof(objFirFilter), g_firfilter_ptr, SHARE_ARENA_MAP_NUM(g_firfilter_ptr));
 	
 	srv->ref_num = ref_num;
+	srv->sub_num = sub_num;
     srv->myu = 0.5f;
     srv->beta = 1e-008f;
-    srv->fir_coef = (xcomplex ***)calloc(srv->ref_num, sizeof(xcomplex**));
-    srv->adf_coef = (xcomplex ***)calloc(srv->ref_num, sizeof(xcomplex**));
-    srv->stack_sigIn_adf = (xcomplex ***)calloc(srv->ref_num, sizeof(xcomplex**));
-    srv->err_adf = (xcomplex *)calloc(AEC_SUBBAND_NUM, sizeof(xcomplex));
-    srv->err_fir = (xcomplex *)calloc(AEC_SUBBAND_NUM, sizeof(xcomplex));
-    srv->est_ref_adf = (xcomplex **)calloc(srv->ref_num, sizeof(xcomplex*));
-    srv->est_ref_fir = (xcomplex **)calloc(srv->ref_num, sizeof(xcomplex*));
-
-    srv->mse_main = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
-    srv->mse_adpt = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
-    srv->mse_mic_in = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
-    srv->power_in_ntaps_smooth = (float **)calloc(srv->ref_num, sizeof(float*));
-    srv->mic_rec_psd = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
-	srv->energy_err_fir = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
-	srv->energy_err_adf = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
-	srv->ref_psd = (float **)calloc(srv->ref_num, sizeof(float*));
-    srv->power_mic_send_smooth = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
-    srv->power_echo_rtn_smooth = (float **)calloc(srv->ref_num, sizeof(float*));
-    srv->mic_rec_part_band_energy = (float *)calloc(ERL_BAND_NUM, sizeof(float));
-
-    srv->echo_return_band_energy = (float *)calloc(ERL_BAND_NUM, sizeof(float));
-    srv->mic_send_part_band_energy = (float *)calloc(ERL_BAND_NUM, sizeof(float));
-    srv->mic_peak = (float **)calloc(srv->ref_num, sizeof(float*));
-    srv->erl_ratio = (float **)calloc(srv->ref_num, sizeof(float*));
-    srv->power_echo_rtn_fir = (float **)calloc(srv->ref_num, sizeof(float*));
-    srv->power_echo_rtn_adpt = (float **)calloc(srv->ref_num, sizeof(float*));
+    srv->fir_coef_r = (aec_tap_t *)dios_ssp_share_calloc(srv->ref_num * srv->sub_num * AEC_TAP_STRIDE, sizeof(aec_tap_t));
+    srv->fir_coef_i = (aec_tap_t *)dios_ssp_share_calloc(srv->ref_num * srv->sub_num * AEC_TAP_STRIDE, sizeof(aec_tap_t));
+    srv->adf_coef_r = (aec_tap_t *)dios_ssp_share_calloc(srv->ref_num * srv->sub_num * AEC_TAP_STRIDE, sizeof(aec_tap_t));
+    srv->adf_coef_i = (aec_tap_t *)dios_ssp_share_calloc(srv->ref_num * srv->sub_num * AEC_TAP_STRIDE, sizeof(aec_tap_t));
+    srv->stack_sigIn_adf_r = (aec_tap_t *)dios_ssp_share_calloc(srv->ref_num * srv->sub_num * AEC_TAP_STRIDE, sizeof(aec_tap_t));
+    srv->stack_sigIn_adf_i = (aec_tap_t *)dios_ssp_share_calloc(srv->ref_num * srv->sub_num * AEC_TAP_STRIDE, sizeof(aec_tap_t));
+#if DIOS_SSP_FIXED_POINT
+    srv->stack_exp = (int *)dios_ssp_share_calloc(srv->ref_num * srv->sub_num, sizeof(int));
+#endif
+    srv->err_adf = (xcomplex *)dios_ssp_share_calloc(srv->sub_num, sizeof(xcomplex));
+    srv->err_fir = (xcomplex *)dios_ssp_share_calloc(srv->sub_num, sizeof(xcomplex));
+    srv->est_ref_adf = (xcomplex **)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(xcomplex*));
+    srv->est_ref_fir = (xcomplex **)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(xcomplex*));
+
+    srv->mse_main = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+    srv->mse_adpt = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+    srv->mse_mic_in = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+    srv->power_in_ntaps_smooth = (float **)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(float*));
+    srv->mic_rec_psd = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+	srv->energy_err_fir = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+	srv->energy_err_adf = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+	srv->ref_psd = (float **)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(float*));
+    srv->power_mic_send_smooth = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+    srv->power_echo_rtn_smooth = (float **)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(float*));
+    srv->mic_rec_part_band_energy = (float *)dios_ssp_share_calloc(ERL_BAND_NUM, sizeof(float));
+
+    srv->echo_return_band_energy = (float *)dios_ssp_share_calloc(ERL_BAND_NUM, sizeof(float));
+    srv->mic_send_part_band_energy = (float *)dios_ssp_share_calloc(ERL_BAND_NUM, sizeof(float));
+    srv->mic_peak = (float **)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(float*));
+    srv->erl_ratio = (float **)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(float*));
+    srv->power_echo_rtn_fir = (float **)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(float*));
+    srv->power_echo_rtn_adpt = (float **)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(float*));
     for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
     {
-		srv->ref_psd[i_ref] = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
-		srv->power_in_ntaps_smooth[i_ref] = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
-		srv->adf_coef[i_ref] = (xcomplex **)calloc(AEC_SUBBAND_NUM, sizeof(xcomplex*));
-		srv->fir_coef[i_ref] = (xcomplex **)calloc(AEC_SUBBAND_NUM, sizeof(xcomplex*));
-		srv->stack_sigIn_adf[i_ref] = (xcomplex **)calloc(AEC_SUBBAND_NUM, sizeof(xcomplex*));
-		srv->power_echo_rtn_fir[i_ref] = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
-		srv->power_echo_rtn_adpt[i_ref] = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
-		for (i = 0; i < AEC_SUBBAND_NUM; i++)
-		{
-			srv->adf_coef[i_ref][i] = (xcomplex *)calloc((NUM_MAX_BAND + 1), sizeof(xcomplex));
-			srv->fir_coef[i_ref][i] = (xcomplex *)calloc((NUM_MAX_BAND + 1), sizeof(xcomplex));
-			srv->stack_sigIn_adf[i_ref][i] = (xcomplex *)calloc((NUM_MAX_BAND + 1), sizeof(xcomplex));
-		}
-
-		srv->est_ref_adf[i_ref] = (xcomplex *)calloc(AEC_SUBBAND_NUM, sizeof(xcomplex));
-		srv->est_ref_fir[i_ref] = (xcomplex *)calloc(AEC_SUBBAND_NUM, sizeof(xcomplex));
-		srv->power_echo_rtn_smooth[i_ref] = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
+		srv->ref_psd[i_ref] = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+		srv->power_in_ntaps_smooth[i_ref] = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+		srv->power_echo_rtn_fir[i_ref] = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+		srv->power_echo_rtn_adpt[i_ref] = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+		srv->est_ref_adf[i_ref] = (xcomplex *)dios_ssp_share_calloc(srv->sub_num, sizeof(xcomplex));
+		srv->est_ref_fir[i_ref] = (xcomplex *)dios_ssp_share_calloc(srv->sub_num, sizeof(xcomplex));
+		srv->power_echo_rtn_smooth[i_ref] = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
     }
 
-    srv->num_main_subband_adf = (int *)calloc(AEC_SUBBAND_NUM, sizeof(int));
-    srv->lambda = (float *)calloc(AEC_SUBBAND_NUM, sizeof(float));
-    srv->weight = (float *)calloc(AEC_SUBBAND_NUM * 2, sizeof(float));
+    srv->num_main_subband_adf = (int *)dios_ssp_share_calloc(srv->sub_num, sizeof(int));
+    srv->lambda = (float *)dios_ssp_share_calloc(srv->sub_num, sizeof(float));
+    srv->weight = (float *)dios_ssp_share_calloc(srv->sub_num * 2, sizeof(float));
     
 	for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
     {
-		srv->mic_peak[i_ref] = (float *)calloc(ERL_BAND_NUM, sizeof(float));
-		srv->erl_ratio[i_ref] = (float *)calloc(ERL_BAND_NUM, sizeof(float));
+		srv->mic_peak[i_ref] = (float *)dios_ssp_share_calloc(ERL_BAND_NUM, sizeof(float));
+		srv->erl_ratio[i_ref] = (float *)dios_ssp_share_calloc(ERL_BAND_NUM, sizeof(float));
     }
-    srv->noise_est_mic_chan = (objNoiseLevel **)calloc(AEC_SUBBAND_NUM, sizeof(objNoiseLevel*));
-    for (i = 0; i < AEC_SUBBAND_NUM; i++)
+    srv->noise_est_mic_chan = (objNoiseLevel **)dios_ssp_share_calloc_ptr(srv->sub_num, sizeof(objNoiseLevel*));
+    for (i = 0; i < srv->sub_num; i++)
     {
-		srv->noise_est_mic_chan[i] = (objNoiseLevel *)calloc(1, sizeof(objNoiseLevel));
+		srv->noise_est_mic_chan[i] = (objNoiseLevel *)dios_ssp_share_calloc(1, sizeof(objNoiseLevel));
     }
 
 	ret = dios_ssp_aec_firfilter_reset(srv);
@@ -318,7 +566,6 @@ objFirFilter* dios_ssp_aec_firfilter_init(int ref_num)
 int dios_ssp_aec_firfilter_reset(objFirFilter* srv)
 {
 	int i;
-	int n;
 	int i_ref;
 	int ret = 0;
 
@@ -327,7 +574,7 @@ int dios_ssp_aec_firfilter_reset(objFirFilter* srv)
 		return ERR_AEC;
     }
 
-	for (i = 0; i < AEC_SUBBAND_NUM; i++)
+	for (i = 0; i < srv->sub_num; i++)
 	{
 		srv->weight[2 * i] = srv->myu;
 		srv->weight[2 * i + 1] = srv->beta;
@@ -343,7 +590,7 @@ int dios_ssp_aec_firfilter_reset(objFirFilter* srv)
 		}
 	}
 
-	for (i = 0; i < AEC_SUBBAND_NUM; i++)
+	for (i = 0; i < srv->sub_num; i++)
 	{
 		srv->err_fir[i].r = 0.0;
 		srv->err_fir[i].i = 0.0;
@@ -363,19 +610,6 @@ int dios_ssp_aec_firfilter_reset(objFirFilter* srv)
 			srv->power_echo_rtn_smooth[i_ref][i] = 0.0f;
 			srv->power_in_ntaps_smooth[i_ref][i] = 0.0f;
 		}
-
-		for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
-		{
-			for (n = 0; n < NUM_MAX_BAND + 1; n++)
-			{
-				srv->adf_coef[i_ref][i][n].r = 0.0f;
-				srv->adf_coef[i_ref][i][n].i = 0.0f;
-				srv->fir_coef[i_ref][i][n].r = 0.0f;
-				srv->fir_coef[i_ref][i][n].i = 0.0f;
-				srv->stack_sigIn_adf[i_ref][i][n].r = 0.0f;
-				srv->stack_sigIn_adf[i_ref][i][n].i = 0.0f;
-			}
-		}
 		srv->mse_adpt[i] = 0.0f;
 		srv->mse_main[i] = 0.0f;
 		srv->mse_mic_in[i] = 0.0f;
@@ -393,8 +627,18 @@ int dios_ssp_aec_firfilter_reset(objFirFilter* srv)
 		}
 	}
 
+	memset(srv->adf_coef_r, 0, srv->ref_num * srv->sub_num * AEC_TAP_STRIDE * sizeof(aec_tap_t));
+	memset(srv->adf_coef_i, 0, srv->ref_num * srv->sub_num * AEC_TAP_STRIDE * sizeof(aec_tap_t));
+	memset(srv->fir_coef_r, 0, srv->ref_num * srv->sub_num * AEC_TAP_STRIDE * sizeof(aec_tap_t));
+	memset(srv->fir_coef_i, 0, srv->ref_num * srv->sub_num * AEC_TAP_STRIDE * sizeof(aec_tap_t));
+	memset(srv->stack_sigIn_adf_r, 0, srv->ref_num * srv->sub_num * AEC_TAP_STRIDE * sizeof(aec_tap_t));
+	memset(srv->stack_sigIn_adf_i, 0, srv->ref_num * srv->sub_num * AEC_TAP_STRIDE * sizeof(aec_tap_t));
+#if DIOS_SSP_FIXED_POINT
+	memset(srv->stack_exp, 0, srv->ref_num * srv->sub_num * sizeof(int));
+#endif
+
 	// noise level estimate
-	for (i = 0; i < AEC_SUBBAND_NUM; i++)
+	for (i = 0; i < srv->sub_num; i++)
 	{
 		ret = dios_ssp_share_noiselevel_init(srv->noise_est_mic_chan[i], MIC_CHAN_MAX_NOISE, MIC_CHAN_MIN_NOISE, NL_RUN_MIN_LEN); 
 		if (ret != 0)
@@ -440,18 +684,15 @@ int dios_ssp_aec_firfilter_process(objFirFilter* srv, xcomplex* output_buf, xcom
 
 
 	/* filter update */
-	for (ch = AEC_LOW_CHAN; ch < AEC_HIGH_CHAN; ch++)
+	for (ch = AEC_LOW_CHAN; ch < srv->sub_num; ch++)
     {
-		if (AEC_SAMPLE_RATE == 16000)
+		if (ch >= FILTER_UPDATE_FAC_BIN_THR1)
 		{
-			if (ch >= FILTER_UPDATE_FAC_BIN_THR1)
-			{
-				update_thr_final = update_thr * FILTER_UPDATE_FAC_PARA1;
-			}
-			else if ((ch >= FILTER_UPDATE_FAC_BIN_THR2)&& (ch < FILTER_UPDATE_FAC_BIN_THR1))
-			{
-				update_thr_final = update_thr * FILTER_UPDATE_FAC_PARA2;
-			}
+			update_thr_final = update_thr * FILTER_UPDATE_FAC_PARA1;
+		}
+		else if ((ch >= FILTER_UPDATE_FAC_BIN_THR2)&& (ch < FILTER_UPDATE_FAC_BIN_THR1))
+		{
+			update_thr_final = update_thr * FILTER_UPDATE_FAC_PARA2;
 		}
 		
 		for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
@@ -480,11 +721,6 @@ int dios_ssp_aec_firfilter_process(objFirFilter* srv, xcomplex* output_buf, xcom
 
 	/* get linear echo cancellation output */
     for (ch = 0; ch < AEC_LOW_CHAN; ch++)
-    {
-		output_buf[ch].r = 0.0f;
-		output_buf[ch].i = 0.0f;
-    }
-    for (ch = AEC_HIGH_CHAN; ch < AEC_SUBBAND_NUM; ch++)
     {
 		output_buf[ch].r = 0.0f;
 		output_buf[ch].i = 0.0f;
@@ -504,67 +740,62 @@ int dios_ssp_aec_firfilter_uninit(objFirFilter* srv)
     }
     for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
     {
-		for (i = 0; i < AEC_SUBBAND_NUM; i++)
-		{
-			free(srv->adf_coef[i_ref][i]);
-			free(srv->fir_coef[i_ref][i]);
-			free(srv->stack_sigIn_adf[i_ref][i]);
-		}
-		
-		free(srv->adf_coef[i_ref]);
-		free(srv->fir_coef[i_ref]);
-		free(srv->stack_sigIn_adf[i_ref]);
-	
-		free(srv->power_in_ntaps_smooth[i_ref]);
-		free(srv->est_ref_adf[i_ref]);
-		free(srv->est_ref_fir[i_ref]);
-		free(srv->ref_psd[i_ref]);
-		free(srv->power_echo_rtn_smooth[i_ref]);
-		free(srv->power_echo_rtn_fir[i_ref]);
-		free(srv->power_echo_rtn_adpt[i_ref]);
+		dios_ssp_share_free(srv->power_in_ntaps_smooth[i_ref]);
+		dios_ssp_share_free(srv->est_ref_adf[i_ref]);
+		dios_ssp_share_free(srv->est_ref_fir[i_ref]);
+		dios_ssp_share_free(srv->ref_psd[i_ref]);
+		dios_ssp_share_free(srv->power_echo_rtn_smooth[i_ref]);
+		dios_ssp_share_free(srv->power_echo_rtn_fir[i_ref]);
+		dios_ssp_share_free(srv->power_echo_rtn_adpt[i_ref]);
     }
-    free(srv->power_echo_rtn_fir);
-    free(srv->power_echo_rtn_adpt);
-    free(srv->fir_coef);
-    free(srv->adf_coef);
-    free(srv->stack_sigIn_adf);
-    free(srv->err_adf);
-    free(srv->err_fir);
-    free(srv->est_ref_adf);
-    free(srv->est_ref_fir);
-
-    free(srv->mse_main);
-    free(srv->mse_adpt);
-    free(srv->mse_mic_in);
-    free(srv->power_in_ntaps_smooth);
-    free(srv->mic_rec_psd);
-	free(srv->energy_err_fir);
-	free(srv->energy_err_adf);
-    free(srv->power_mic_send_smooth);
-	free(srv->ref_psd);
-    free(srv->power_echo_rtn_smooth);
-
-    free(srv->echo_return_band_energy);
-    free(srv->mic_rec_part_band_energy);
-    free(srv->mic_send_part_band_energy);
+    dios_ssp_share_free(srv->power_echo_rtn_fir);
+    dios_ssp_share_free(srv->power_echo_rtn_adpt);
+    dios_ssp_share_free(srv->fir_coef_r);
+    dios_ssp_share_free(srv->fir_coef_i);
+    dios_ssp_share_free(srv->adf_coef_r);
+    dios_ssp_share_free(srv->adf_coef_i);
+    dios_ssp_share_free(srv->stack_sigIn_adf_r);
+    dios_ssp_share_free(srv->stack_sigIn_adf_i);
+#if DIOS_SSP_FIXED_POINT
+    dios_ssp_share_free(srv->stack_exp);
+#endif
+    dios_ssp_share_free(srv->err_adf);
+    dios_ssp_share_free(srv->err_fir);
+    dios_ssp_share_free(srv->est_ref_adf);
+    dios_ssp_share_free(srv->est_ref_fir);
+
+    dios_ssp_share_free(srv->mse_main);
+    dios_ssp_share_free(srv->mse_adpt);
+    dios_ssp_share_free(srv->mse_mic_in);
+    dios_ssp_share_free(srv->power_in_ntaps_smooth);
+    dios_ssp_share_free(srv->mic_rec_psd);
+	dios_ssp_share_free(srv->energy_err_fir);
+	dios_ssp_share_free(srv->energy_err_adf);
+    dios_ssp_share_free(srv->power_mic_send_smooth);
+	dios_ssp_share_free(srv->ref_psd);
+    dios_ssp_share_free(srv->power_echo_rtn_smooth);
+
+    dios_ssp_share_free(srv->echo_return_band_energy);
+    dios_ssp_share_free(srv->mic_rec_part_band_energy);
+    dios_ssp_share_free(srv->mic_send_part_band_energy);
 
     for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
     {
-		free(srv->mic_peak[i_ref]);
-		free(srv->erl_ratio[i_ref]);
+		dios_ssp_share_free(srv->mic_peak[i_ref]);
+		dios_ssp_share_free(srv->erl_ratio[i_ref]);
     }
-    free(srv->mic_peak);
-    free(srv->erl_ratio);
-    free(srv->num_main_subband_adf);
-    free(srv->lambda);
-    free(srv->weight);
+    dios_ssp_share_free(srv->mic_peak);
+    dios_ssp_share_free(srv->erl_ratio);
+    dios_ssp_share_free(srv->num_main_subband_adf);
+    dios_ssp_share_free(srv->lambda);
+    dios_ssp_share_free(srv->weight);
 	
-    for (i = 0; i < AEC_SUBBAND_NUM; i++)
+    for (i = 0; i < srv->sub_num; i++)
     {
-		free(srv->noise_est_mic_chan[i]);
+		dios_ssp_share_free(srv->noise_est_mic_chan[i]);
     }
-    free(srv->noise_est_mic_chan);
-    free(srv);
+    dios_ssp_share_free(srv->noise_est_mic_chan);
+    dios_ssp_share_free(srv);
     return 0;
 }
 
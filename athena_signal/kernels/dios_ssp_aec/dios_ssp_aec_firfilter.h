@@ -23,10 +23,20 @@ limitations under the License.
 #include "dios_ssp_aec_macros.h"
 #include "../dios_ssp_share/dios_ssp_share_complex_defs.h"
 #include "../dios_ssp_share/dios_ssp_share_noiselevel.h"
+#include "../dios_ssp_share/dios_ssp_share_fixed.h"
+
+/* filter taps and reference history: in the fixed-point build the taps are Q27
+   and the history of each subband is a block sharing the exponent stack_exp */
+#if DIOS_SSP_FIXED_POINT
+typedef int aec_tap_t;
+#else
+typedef float aec_tap_t;
+#endif
 
 /* fir filter struct define */
 typedef struct {
 	int ref_num;
+	int sub_num;
 	int far_end_talk_holdtime;
 	float myu;
 	float beta;
@@ -36,9 +46,17 @@ typedef struct {
 	int* num_main_subband_adf;
 	float* lambda;
 	float* weight;
-	xcomplex*** fir_coef;
-	xcomplex*** adf_coef;
-	xcomplex*** stack_sigIn_adf;
+	/* taps are split real/imag blocks laid out [ref][subband][tap],
+	   subband ch of reference i_ref starts at (i_ref * sub_num + ch) * AEC_TAP_STRIDE */
+	aec_tap_t* fir_coef_r;
+	aec_tap_t* fir_coef_i;
+	aec_tap_t* adf_coef_r;
+	aec_tap_t* adf_coef_i;
+	aec_tap_t* stack_sigIn_adf_r;
+	aec_tap_t* stack_sigIn_adf_i;
+#if DIOS_SSP_FIXED_POINT
+	int* stack_exp;        // [ref][subband] exponent of the reference history
+#endif
 	xcomplex* err_adf;
 	xcomplex* err_fir;
 	xcomplex** est_ref_adf;
@@ -77,11 +95,12 @@ typedef struct {
 Function:      // dios_ssp_aec_firfilter_init
 Description:   // load configure file and allocate memory
 Input:         // ref_num: reference number
+                  sub_num: subband number
 Output:        // none
 Return:        // success: return dios speech signal process aec firfilter pointer
 	              failure: return NULL
 **********************************************************************************/
-objFirFilter* dios_ssp_aec_firfilter_init(int ref_num);
+objFirFilter* dios_ssp_aec_firfilter_init(int ref_num, int sub_num);
 
 /**********************************************************************************
 Function:      // dios_ssp_aec_firfilter_reset
@@ -22,13 +22,16 @@ limitations under the License.
 
 #define PI                                        (3.141592653589793f)
 
+/* the fft length grows with the sampling rate, so the bin width (62.5Hz) 
+   and the frame shift (8ms) are the same as at AEC_SAMPLE_RATE */
 #define AEC_SAMPLE_RATE				              (16000)
-#define AEC_FFT_LEN                               (256)
+#define AEC_SAMPLE_RATE_MAX                       (48000)
+#define AEC_FFT_LEN                               (256) /* at AEC_SAMPLE_RATE */
 #define AEC_SUBBAND_NUM                           (AEC_FFT_LEN/2+1)
+#define AEC_SUBBAND_MAX                           (AEC_SUBBAND_NUM * AEC_SAMPLE_RATE_MAX / AEC_SAMPLE_RATE)
 #define AEC_WIN_LEN                               (768)
 #define AEC_LOW_CHAN                              (0) /* low band for process */
 #define AEC_MID_CHAN                              (AEC_FFT_LEN/8-1) 
-#define AEC_HIGH_CHAN                             (129)/* high band for process */
 #define FAREND_TALK_CNT                           (20)
 
 /* fixed delay submodule */
@@ -41,6 +44,7 @@ limitations under the License.
 #define NTAPS_LOW_BAND                            (10)          /* low band filter tap number */
 #define NTAPS_HIGH_BAND                           (8)           /* hign band filter tap number */
 #define NUM_MAX_BAND                              (NTAPS_LOW_BAND + 10)    /* max filter tap number */
+#define AEC_TAP_STRIDE                            ((NUM_MAX_BAND + 1 + 7) & ~7) /* taps of one subband, padded */
 
 /* smooth factor */
 #define AEC_PEAK_ALPHA                            (0.9048f)
@@ -28,11 +28,12 @@ Function framework:
 
 /* include file */
 #include "dios_ssp_aec_res.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
 int dios_ssp_aec_res_get_residual_echo(objRES* srv, float *residual_echo, int dt_st, int stage)
 {
 	int i;
-	float resPsd[AEC_SUBBAND_NUM];
+	float resPsd[AEC_SUBBAND_MAX];
 	float Pey = 1.0, Pyy = 1.0;
 	float Eh, Yh;
 	float Syy = 0.0, See = 0.0;
@@ -46,7 +47,7 @@ int dios_ssp_aec_res_get_residual_echo(objRES* srv, float *residual_echo, int dt
 	if (stage == 1)
 	{
 		/* Compute power spectrum of the echo */
-		for (i = AEC_LOW_CHAN; i < AEC_HIGH_CHAN; i++)
+		for (i = AEC_LOW_CHAN; i < srv->ccsize; i++)
 		{
 			srv->echoPsd[i] = complex_abs2(srv->Xf_echo[i]);
 			resPsd[i] = complex_abs2(srv->Xf_res_echo[i]);
@@ -112,7 +113,7 @@ int dios_ssp_aec_res_get_residual_echo(objRES* srv, float *residual_echo, int dt
 	}
 
 	/* Estimate residual echo */
-	for (i = AEC_LOW_CHAN; i < AEC_HIGH_CHAN; i++)
+	for (i = AEC_LOW_CHAN; i < srv->ccsize; i++)
 	{
 		residual_echo[i] = leak_estimate * srv->echoPsd[i];
 	}
@@ -127,9 +128,9 @@ float dios_ssp_aec_res_prioriser(objRES* srv, float *ps, float *postSer, float *
 	
 	/* Special case for first frame */
 	if (srv->nb_adapt == 1)
-		for (i = AEC_LOW_CHAN; i < AEC_HIGH_CHAN; i++)
+		for (i = AEC_LOW_CHAN; i < srv->ccsize; i++)
 			srv->res_old_ps[i] = ps[i];
-	for (i = AEC_LOW_CHAN; i < AEC_HIGH_CHAN; i++)
+	for (i = AEC_LOW_CHAN; i < srv->ccsize; i++)
 	{
 		srv->res_echo_noise[i] = xmax(srv->res_echo_noise_factor * srv->res_echo_noise[i], srv->res_echo_psd[i]);
 		srv->res_echo_noise[i] = xmax(srv->res_echo_noise[i], 1e-10f);
@@ -147,9 +148,9 @@ float dios_ssp_aec_res_prioriser(objRES* srv, float *ps, float *postSer, float *
 	}
 
 	/* Recursive average of the a priori SNR. A bit smoothed for the psd components */
-	for (i = AEC_LOW_CHAN; i < AEC_HIGH_CHAN; i++)
+	for (i = AEC_LOW_CHAN; i < srv->ccsize; i++)
 	{
-		if (i == AEC_LOW_CHAN || i == (AEC_HIGH_CHAN - 1))
+		if (i == AEC_LOW_CHAN || i == (srv->ccsize - 1))
 			srv->res_zeta[i] = 0.7f * srv->res_zeta[i] + 0.3f * prioriSer[i];
 		else
 			srv->res_zeta[i] = 0.7f*srv->res_zeta[i] + 0.15f*prioriSer[i] + 0.075f*prioriSer[i - 1] + 0.075f*prioriSer[i + 1];
@@ -165,7 +166,7 @@ static float dios_ssp_aec_res_qcurve(float x)
 	return 1.f / (1.f + .15f / x);
 }
 
-static void dios_ssp_aec_res_compute_gain_floor(float effective_echo_suppress, float *echo, float *gain_floor)
+static void dios_ssp_aec_res_compute_gain_floor(float effective_echo_suppress, float *echo, float *gain_floor, int ccsize)
 {
 	int i;
 	float echo_floor;
@@ -173,7 +174,7 @@ static void dios_ssp_aec_res_compute_gain_floor(float effective_echo_suppress, f
 	echo_floor = (float)exp(.2302585f*effective_echo_suppress);
 
 	/* Compute the gain floor based on different floors for the background noise and residual echo */
-	for (i = AEC_LOW_CHAN; i < AEC_HIGH_CHAN; i++)
+	for (i = AEC_LOW_CHAN; i < ccsize; i++)
 		gain_floor[i] = (float)(sqrt(echo_floor * echo[i]) / sqrt(1 + echo[i]));
 }
 
@@ -199,22 +200,33 @@ static float dios_ssp_aec_res_hypergeom_gain(float xx)
 	return (float)(((1 - frac)*table[ind] + frac * table[ind + 1]) / sqrt(xx + .0001f));
 }
 
-objRES* dios_ssp_aec_res_init(void)
+static const size_t g_res_ptr[] = {
+	offsetof(objRES, Xf_res_echo), offsetof(objRES, Xf_echo),
+	offsetof(objRES, echoPsd), offsetof(objRES, res1_old_ps),
+	offsetof(objRES, res2_old_ps), offsetof(objRES, Eh),
+	offsetof(objRES, Yh), offsetof(objRES, res1_echo_noise),
+	offsetof(objRES, res2_echo_noise), offsetof(objRES, res1_zeta),
+	offsetof(objRES, res2_zeta), offsetof(objRES, res_echo_noise),
+	offsetof(objRES, res_zeta), offsetof(objRES, res_echo_psd),
+	offsetof(objRES, res_old_ps)
+};
+
+objRES* dios_ssp_aec_res_init(int sub_num)
 {
 	int ret = 0;
 	objRES* srv = NULL;
-	srv = (objRES *)calloc(1, sizeof(objRES));
-
-    srv->ccsize = AEC_FFT_LEN/2 + 1;
-	srv->echoPsd = (float *)calloc(srv->ccsize, sizeof(float));
-	srv->res1_old_ps = (float *)calloc(srv->ccsize, sizeof(float));
-	srv->res2_old_ps = (float *)calloc(srv->ccsize, sizeof(float));
-	srv->Eh = (float *)calloc(srv->ccsize, sizeof(float));
-	srv->Yh = (float *)calloc(srv->ccsize, sizeof(float));
-	srv->res1_echo_noise = (float *)calloc(srv->ccsize, sizeof(float));
-	srv->res2_echo_noise = (float *)calloc(srv->ccsize, sizeof(float));
-	srv->res1_zeta = (float *)calloc(srv->ccsize, sizeof(float));
-	srv->res2_zeta = (float *)calloc(srv->ccsize, sizeof(float));
+	srv = (objRES *)dios_ssp_share_calloc_map(1, sizeof(objRES), g_res_ptr, SHARE_ARENA_MAP_NUM(g_res_ptr));
+
+    srv->ccsize = sub_num;
+	srv->echoPsd = (float *)dios_ssp_share_calloc(srv->ccsize, sizeof(float));
+	srv->res1_old_ps = (float *)dios_ssp_share_calloc(srv->ccsize, sizeof(float));
+	srv->res2_old_ps = (float *)dios_ssp_share_calloc(srv->ccsize, sizeof(float));
+	srv->Eh = (float *)dios_ssp_share_calloc(srv->ccsize, sizeof(float));
+	srv->Yh = (float *)dios_ssp_share_calloc(srv->ccsize, sizeof(float));
+	srv->res1_echo_noise = (float *)dios_ssp_share_calloc(srv->ccsize, sizeof(float));
+	srv->res2_echo_noise = (float *)dios_ssp_share_calloc(srv->ccsize, sizeof(float));
+	srv->res1_zeta = (float *)dios_ssp_share_calloc(srv->ccsize, sizeof(float));
+	srv->res2_zeta = (float *)dios_ssp_share_calloc(srv->ccsize, sizeof(float));
 
 	ret = dios_ssp_aec_res_reset(srv);
 	if (0 != ret)
@@ -238,7 +250,6 @@ int dios_ssp_aec_res_reset(objRES *srv)
 	srv->Pyy_avg = 1.0;
 	srv->nb_adapt = 0;
 
-    srv->ccsize = AEC_FFT_LEN/2 + 1;
     for (j = 0; j < srv->ccsize; j++)
     {
 		srv->echoPsd[j] = 0.0f;
@@ -260,12 +271,12 @@ int dios_ssp_aec_res_process(objRES *srv, int dt_st, int stage)
 {
 	int i;
 	int ret = 0;
-    float ps[AEC_SUBBAND_NUM];
-	float resEchoPsd[AEC_SUBBAND_NUM];
-	float postSer[AEC_SUBBAND_NUM];
-	float prioriSer[AEC_SUBBAND_NUM];
-	float gain[AEC_SUBBAND_NUM];
-	float gain_floor[AEC_SUBBAND_NUM];
+    float ps[AEC_SUBBAND_MAX];
+	float resEchoPsd[AEC_SUBBAND_MAX];
+	float postSer[AEC_SUBBAND_MAX];
+	float prioriSer[AEC_SUBBAND_MAX];
+	float gain[AEC_SUBBAND_MAX];
+	float gain_floor[AEC_SUBBAND_MAX];
 	float Zframe = 0;
 	float Pframe;
 	float effective_echo_suppress;
@@ -283,7 +294,7 @@ int dios_ssp_aec_res_process(objRES *srv, int dt_st, int stage)
 
 	srv->res_echo_psd = resEchoPsd;
 
-	for (i = AEC_LOW_CHAN; i < AEC_HIGH_CHAN; i++)
+	for (i = AEC_LOW_CHAN; i < srv->ccsize; i++)
     {      
         ps[i] = complex_abs2(srv->Xf_res_echo[i]);
     }
@@ -311,13 +322,13 @@ int dios_ssp_aec_res_process(objRES *srv, int dt_st, int stage)
 	Zframe = dios_ssp_aec_res_prioriser(srv, ps, postSer, prioriSer);
 	
 	Zframe = xmax(Zframe, 1e-10f);
-	Pframe = 0.1f + 0.9f * dios_ssp_aec_res_qcurve(Zframe / (AEC_HIGH_CHAN - AEC_LOW_CHAN));
+	Pframe = 0.1f + 0.9f * dios_ssp_aec_res_qcurve(Zframe / (srv->ccsize - AEC_LOW_CHAN));
 	
 	
 	if (stage == 1)
 	{
 		effective_echo_suppress = (1.0f - Pframe) * srv->res1_echo_suppress_default + Pframe * srv->res1_echo_suppress_active_default;
-		dios_ssp_aec_res_compute_gain_floor(effective_echo_suppress, srv->res1_echo_noise, gain_floor);
+		dios_ssp_aec_res_compute_gain_floor(effective_echo_suppress, srv->res1_echo_noise, gain_floor, srv->ccsize);
 	}
 	else
 	{
@@ -329,7 +340,7 @@ int dios_ssp_aec_res_process(objRES *srv, int dt_st, int stage)
 		{
 			effective_echo_suppress = (1.0f - Pframe) * srv->res2_dt_echo_suppress_default + Pframe * srv->res2_dt_echo_suppress_active_default;
 		}		
-		dios_ssp_aec_res_compute_gain_floor(effective_echo_suppress, srv->res2_echo_noise, gain_floor);
+		dios_ssp_aec_res_compute_gain_floor(effective_echo_suppress, srv->res2_echo_noise, gain_floor, srv->ccsize);
 	}
 
 
@@ -348,7 +359,7 @@ int dios_ssp_aec_res_process(objRES *srv, int dt_st, int stage)
 	float p;
 	
 	/* Calculate the final residual echo output*/
-	for (i = AEC_LOW_CHAN; i < AEC_HIGH_CHAN; i++)
+	for (i = AEC_LOW_CHAN; i < srv->ccsize; i++)
 	{
 		/* Wiener filter gain */
 		prior_ratio = prioriSer[i] / (prioriSer[i] + 1);
@@ -405,11 +416,6 @@ int dios_ssp_aec_res_process(objRES *srv, int dt_st, int stage)
 		srv->Xf_res_echo[i].r = 0;
 		srv->Xf_res_echo[i].i = 0;
 	}
-	for (i = AEC_HIGH_CHAN; i < AEC_SUBBAND_NUM; i++)
-	{
-		srv->Xf_res_echo[i].r = 0;
-		srv->Xf_res_echo[i].i = 0;
-	}
 	return 0;
 }
 
@@ -420,15 +426,15 @@ int dios_ssp_aec_res_unit(objRES *srv)
 	{
 		return ERR_AEC;
 	}
-	free(srv->echoPsd);
-	free(srv->res1_old_ps);
-	free(srv->res2_old_ps);
-	free(srv->res1_echo_noise);
-	free(srv->res2_echo_noise);
-	free(srv->res1_zeta);
-	free(srv->res2_zeta);
-	free(srv->Eh);
-	free(srv->Yh);
-	free(srv);
+	dios_ssp_share_free(srv->echoPsd);
+	dios_ssp_share_free(srv->res1_old_ps);
+	dios_ssp_share_free(srv->res2_old_ps);
+	dios_ssp_share_free(srv->res1_echo_noise);
+	dios_ssp_share_free(srv->res2_echo_noise);
+	dios_ssp_share_free(srv->res1_zeta);
+	dios_ssp_share_free(srv->res2_zeta);
+	dios_ssp_share_free(srv->Eh);
+	dios_ssp_share_free(srv->Yh);
+	dios_ssp_share_free(srv);
 	return 0;
 }
@@ -74,12 +74,12 @@ int dios_ssp_aec_res_get_residual_echo(objRES* srv, float* residual_echo, int dt
 /**********************************************************************************
 Function:      // dios_ssp_aec_res_init
 Description:   // load configure file and allocate memory
-Input:         // none
+Input:         // sub_num: subband number
 Output:        // none
 Return:        // success: return dios speech signal process aec res pointer
 	              failure: return NULL
 **********************************************************************************/
-objRES* dios_ssp_aec_res_init(void);
+objRES* dios_ssp_aec_res_init(int sub_num);
 	
 /**********************************************************************************
 Function:      // dios_ssp_aec_res_reset
@@ -21,17 +21,53 @@ reference and mic signal.
 
 /* include file */
 #include "dios_ssp_aec_tde.h"
+#include "../../dios_ssp_share/dios_ssp_share_arena.h"
 
-objTDE* dios_ssp_aec_tde_init(int mic_num, int ref_num, int frm_len)
+/* read one estimator input sample at buffer position pos, averaging decm 
+   consecutive samples when the delay estimator runs decimated */
+static float dios_ssp_aec_tde_fetch(objTDE *srv, float *buf, int pos)
+{
+	int k;
+	float sum = 0.0f;
+
+	if (pos < 0)
+	{
+		pos += srv->buf_size;
+	}
+	if (srv->decm == 1)
+	{
+		return buf[pos];
+	}
+	for (k = 0; k < srv->decm; k++)
+	{
+		sum += buf[(pos + k) % srv->buf_size];
+	}
+	return sum / srv->decm;
+}
+
+static const size_t g_tde_ptr[] = {
+	offsetof(objTDE, tde_short), offsetof(objTDE, tde_long),
+	offsetof(objTDE, tdeBuf_ref), offsetof(objTDE, tdeBuf_mic),
+	offsetof(objTDE, audioBuf_mic), offsetof(objTDE, audioBuf_ref)
+};
+
+objTDE* dios_ssp_aec_tde_init(int mic_num, int ref_num, int frm_len, int sample_rate, void *table_pool)
 {
 	int i;
 	int ret;
 	objTDE *srv = NULL;
-    srv = (objTDE *)calloc(1, sizeof(objTDE));
+    srv = (objTDE *)dios_ssp_share_calloc_map(1, sizeof(objTDE), g_tde_ptr, SHARE_ARENA_MAP_NUM(g_tde_ptr));
 
 	srv->mic_num = mic_num;
 	srv->ref_num = ref_num;
 	srv->frm_len = frm_len;	
+	/* the delay estimator works on 16kHz or lower, higher rates are decimated,
+	   the buffer keeps its length in estimator samples */
+	srv->decm = sample_rate > AEC_SAMPLE_RATE ? sample_rate / AEC_SAMPLE_RATE : 1;
+	srv->part_num = srv->frm_len / srv->decm / PART_LEN;
+	srv->buf_size = DELAY_BUFFER_SIZE * srv->decm;
+	srv->look_ahead = 100 * sample_rate / AEC_SAMPLE_RATE;
+	srv->long_offset = 3200 * sample_rate / AEC_SAMPLE_RATE;
 
     srv->tde_short = NULL;
     srv->tde_long = NULL;
@@ -42,30 +78,30 @@ objTDE* dios_ssp_aec_tde_init(int mic_num, int ref_num, int frm_len)
     srv->audioBuf_mic  = NULL;
     srv->audioBuf_ref  = NULL;
   
-    srv->audioBuf_mic = (float **)calloc(srv->mic_num, sizeof(float*));
+    srv->audioBuf_mic = (float **)dios_ssp_share_calloc_ptr(srv->mic_num, sizeof(float*));
     for (i = 0; i < srv->mic_num; i++)
     {
-	    srv->audioBuf_mic[i] = (float*)calloc(DELAY_BUFFER_SIZE, sizeof(float));
+	    srv->audioBuf_mic[i] = (float*)dios_ssp_share_calloc(srv->buf_size, sizeof(float));
     }
     
-    srv->audioBuf_ref = (float **)calloc(srv->ref_num, sizeof(float*));
+    srv->audioBuf_ref = (float **)dios_ssp_share_calloc_ptr(srv->ref_num, sizeof(float*));
     for(i = 0; i < srv->ref_num; i++)
     {
-	    srv->audioBuf_ref[i] = (float *)calloc(DELAY_BUFFER_SIZE, sizeof(float));
+	    srv->audioBuf_ref[i] = (float *)dios_ssp_share_calloc(srv->buf_size, sizeof(float));
     }
     
-    srv->tdeBuf_ref = (float *)calloc(PART_LEN, sizeof(float));	
-    srv->tdeBuf_mic = (float *)calloc(PART_LEN, sizeof(float));
+    srv->tdeBuf_ref = (float *)dios_ssp_share_calloc(PART_LEN, sizeof(float));	
+    srv->tdeBuf_mic = (float *)dios_ssp_share_calloc(PART_LEN, sizeof(float));
     
     /* long-term tde */ 
-    ret = dios_ssp_aec_tde_creatcore(&srv->tde_long, MAX_DELAY_LONG, DELAY_WIN_SLIDE_TDE); 
+    ret = dios_ssp_aec_tde_creatcore(&srv->tde_long, MAX_DELAY_LONG, DELAY_WIN_SLIDE_TDE, table_pool); 
     if (ret != 0)
     {
 	    printf("dios_ssp_aec_tde_creatcore Error!\n");
     }    
 
     /* short-term tde */
-    ret = dios_ssp_aec_tde_creatcore(&srv->tde_short, MAX_DELAY_SHORT, DELAY_WIN_SLIDE); 
+    ret = dios_ssp_aec_tde_creatcore(&srv->tde_short, MAX_DELAY_SHORT, DELAY_WIN_SLIDE, table_pool); 
     if (ret != 0)
     {
 	    printf("dios_ssp_aec_tde_creatcore Error!\n");
@@ -97,12 +133,12 @@ int dios_ssp_aec_tde_reset(objTDE *srv)
 
     for(i = 0; i < srv->mic_num; i++)
     {
-		memset(srv->audioBuf_mic[i], 0, DELAY_BUFFER_SIZE * sizeof(float));
+		memset(srv->audioBuf_mic[i], 0, srv->buf_size * sizeof(float));
     }
     
     for(i = 0; i < srv->ref_num; i++)
     {
-		memset(srv->audioBuf_ref[i], 0, DELAY_BUFFER_SIZE * sizeof(float));
+		memset(srv->audioBuf_ref[i], 0, srv->buf_size * sizeof(float));
     }
     memset(srv->tdeBuf_ref, 0, PART_LEN * sizeof(float));
     memset(srv->tdeBuf_mic, 0, PART_LEN * sizeof(float));
@@ -133,7 +169,7 @@ int dios_ssp_aec_tde_process(objTDE *srv, float* refbuf, float* micbuf)
 	int i_mic;
 	int i_ref;
 	int i_tde;
-    int look_ahead = 100;
+    int look_ahead = srv->look_ahead;
 	int pp;
 
 	if (NULL == srv)
@@ -160,17 +196,13 @@ int dios_ssp_aec_tde_process(objTDE *srv, float* refbuf, float* micbuf)
     int idx;
     /* long-term delay estimation */
     srv->flag_delayfind = 0;
-    for (i_tde = 0; i_tde < 2; i_tde++)
+    for (i_tde = 0; i_tde < srv->part_num; i_tde++)
     {
 		for (i = 0; i < PART_LEN; i++)
 		{
-			idx = srv->pt_buf_push + i + i_tde * PART_LEN - look_ahead;
-			if (idx < 0) 
-			{
-				idx += DELAY_BUFFER_SIZE;
-			}
-			srv->tdeBuf_mic[i] =  srv->audioBuf_mic[0][idx];
-			srv->tdeBuf_ref[i] =  srv->audioBuf_ref[0][srv->pt_buf_push + i + i_tde * PART_LEN];
+			idx = srv->pt_buf_push + (i + i_tde * PART_LEN) * srv->decm;
+			srv->tdeBuf_mic[i] = dios_ssp_aec_tde_fetch(srv, srv->audioBuf_mic[0], idx - look_ahead);
+			srv->tdeBuf_ref[i] = dios_ssp_aec_tde_fetch(srv, srv->audioBuf_ref[0], idx);
 		}
 		int flag1 = dios_ssp_aec_tde_ProcessBlock(srv->tde_long, srv->tdeBuf_ref, srv->tdeBuf_mic);
 		srv->CalibrateCounter--;
@@ -181,8 +213,8 @@ int dios_ssp_aec_tde_process(objTDE *srv, float* refbuf, float* micbuf)
 		}
 		if (srv->CalibrateEnable == 1 && flag1)
 		{
-			srv->tde_long_shift_smpl = get_tde_final(srv->tde_long);
-			srv->tde_long_shift_smpl -= 3200;
+			srv->tde_long_shift_smpl = get_tde_final(srv->tde_long) * srv->decm;
+			srv->tde_long_shift_smpl -= srv->long_offset;
 			if (srv->tde_long_shift_smpl < 0)
 			{
 				srv->tde_long_shift_smpl = 0;
@@ -197,28 +229,18 @@ int dios_ssp_aec_tde_process(objTDE *srv, float* refbuf, float* micbuf)
     }
 
     /* short-term delay estimation */
-    for (i_tde = 0; i_tde < 2; i_tde++)
+    for (i_tde = 0; i_tde < srv->part_num; i_tde++)
     {
-		int j1, j2;
 		for (i = 0; i < PART_LEN; i++)
 		{
-			j1 =  srv->pt_buf_push + i + i_tde * PART_LEN - look_ahead;
-			if (j1 < 0) 
-			{
-				j1 += DELAY_BUFFER_SIZE;
-			}
-			srv->tdeBuf_mic[i] =  srv->audioBuf_mic[0][j1];
-			j2 = srv->pt_buf_push + i + i_tde * PART_LEN - srv->tde_long_shift_smpl;
-			if (j2 < 0) 
-			{
-				j2 += DELAY_BUFFER_SIZE;
-			}
-			srv->tdeBuf_ref[i] =  srv->audioBuf_ref[0][j2];
+			idx = srv->pt_buf_push + (i + i_tde * PART_LEN) * srv->decm;
+			srv->tdeBuf_mic[i] = dios_ssp_aec_tde_fetch(srv, srv->audioBuf_mic[0], idx - look_ahead);
+			srv->tdeBuf_ref[i] = dios_ssp_aec_tde_fetch(srv, srv->audioBuf_ref[0], idx - srv->tde_long_shift_smpl);
 		}
 		int flag2 = dios_ssp_aec_tde_ProcessBlock(srv->tde_short, srv->tdeBuf_ref, srv->tdeBuf_mic);
 		if (flag2)
 		{
-			srv->tde_short_shift_smpl = get_tde_final(srv->tde_short);
+			srv->tde_short_shift_smpl = get_tde_final(srv->tde_short) * srv->decm;
 		}
 		else
 		{
@@ -226,11 +248,11 @@ int dios_ssp_aec_tde_process(objTDE *srv, float* refbuf, float* micbuf)
 			{
 				if (srv->tde_long_shift_smpl > 0)
 				{
-					srv->tde_short_shift_smpl = 3200;
+					srv->tde_short_shift_smpl = srv->long_offset;
 				}
 				else if (srv->tde_long_shift_smpl == 0)
 				{
-					srv->tde_short_shift_smpl = get_tde_final(srv->tde_long);
+					srv->tde_short_shift_smpl = get_tde_final(srv->tde_long) * srv->decm;
 				}
 				srv->flag_delayfind = 0;
 			}
@@ -252,13 +274,13 @@ int dios_ssp_aec_tde_process(objTDE *srv, float* refbuf, float* micbuf)
     pt_pop = srv->pt_buf_push - look_ahead;
     if (pt_pop < 0)
     {
-		pt_pop += DELAY_BUFFER_SIZE;
+		pt_pop += srv->buf_size;
     }
 	for (i_mic = 0; i_mic < srv->mic_num; i_mic++)
 	{
-		if (pt_pop < DELAY_BUFFER_SIZE && (pt_pop + srv->frm_len > DELAY_BUFFER_SIZE))
+		if (pt_pop < srv->buf_size && (pt_pop + srv->frm_len > srv->buf_size))
 		{
-			int len = DELAY_BUFFER_SIZE - pt_pop;
+			int len = srv->buf_size - pt_pop;
 			memcpy(micbuf + i_mic * srv->frm_len, srv->audioBuf_mic[i_mic] + pt_pop, len * sizeof(float));
 			memcpy(micbuf + i_mic * srv->frm_len + len, srv->audioBuf_mic[i_mic], (srv->frm_len - len) * sizeof(float));
 		}
@@ -271,7 +293,7 @@ int dios_ssp_aec_tde_process(objTDE *srv, float* refbuf, float* micbuf)
 	/* ref signal */
 	if (srv->pt_buf_push - srv->act_delay_smpl < 0)
 	{
-		pp = DELAY_BUFFER_SIZE + (srv->pt_buf_push - srv->act_delay_smpl);
+		pp = srv->buf_size + (srv->pt_buf_push - srv->act_delay_smpl);
 	}
 	else
 	{
@@ -279,9 +301,9 @@ int dios_ssp_aec_tde_process(objTDE *srv, float* refbuf, float* micbuf)
 	}
 	for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
 	{
-		if (pp < DELAY_BUFFER_SIZE && (pp + srv->frm_len > DELAY_BUFFER_SIZE))
+		if (pp < srv->buf_size && (pp + srv->frm_len > srv->buf_size))
 		{
-			int len = DELAY_BUFFER_SIZE - pp;
+			int len = srv->buf_size - pp;
 			memcpy(refbuf + i_ref * srv->frm_len, srv->audioBuf_ref[i_ref] + pp, len * sizeof(float));
 			memcpy(refbuf + i_ref * srv->frm_len + len, srv->audioBuf_ref[i_ref], (srv->frm_len - len) * sizeof(float));
 		}
@@ -291,7 +313,7 @@ int dios_ssp_aec_tde_process(objTDE *srv, float* refbuf, float* micbuf)
 		}			
 	}
 
-    srv->pt_buf_push = (srv->pt_buf_push + srv->frm_len) % DELAY_BUFFER_SIZE;
+    srv->pt_buf_push = (srv->pt_buf_push + srv->frm_len) % srv->buf_size;
 	
     return 0;
 }
@@ -309,9 +331,9 @@ int dios_ssp_aec_tde_uninit(objTDE* srv)
     {
         for (i_mic = 0; i_mic < srv->mic_num; i_mic++)
 		{
-            free(srv->audioBuf_mic[i_mic]);
+            dios_ssp_share_free(srv->audioBuf_mic[i_mic]);
         }
-        free(srv->audioBuf_mic);
+        dios_ssp_share_free(srv->audioBuf_mic);
         srv->audioBuf_mic = NULL;
     }
 
@@ -319,19 +341,19 @@ int dios_ssp_aec_tde_uninit(objTDE* srv)
     {
         for (i_ref = 0; i_ref < srv->ref_num; i_ref++)
 		{
-            free(srv->audioBuf_ref[i_ref]);
+            dios_ssp_share_free(srv->audioBuf_ref[i_ref]);
         }
-        free(srv->audioBuf_ref);
+        dios_ssp_share_free(srv->audioBuf_ref);
         srv->audioBuf_ref = NULL;
     }
     if (srv->tdeBuf_ref != NULL)
     {
-        free(srv->tdeBuf_ref);
+        dios_ssp_share_free(srv->tdeBuf_ref);
         srv->tdeBuf_ref = NULL;
     }
     if (srv->tdeBuf_mic != NULL)
     {
-        free(srv->tdeBuf_mic);
+        dios_ssp_share_free(srv->tdeBuf_mic);
         srv->tdeBuf_mic = NULL;
     }
 
@@ -340,7 +362,7 @@ int dios_ssp_aec_tde_uninit(objTDE* srv)
 
     if (srv != NULL)
     {
-        free(srv);
+        dios_ssp_share_free(srv);
         srv = NULL;
     }
 
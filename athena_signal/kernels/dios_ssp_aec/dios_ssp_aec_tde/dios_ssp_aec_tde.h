@@ -39,6 +39,11 @@ typedef struct
 	int mic_num;
 	int ref_num;
 	int frm_len;
+	int decm;        // decimation of the delay estimator input
+	int part_num;    // estimator partitions per frame
+	int buf_size;    // delay buffer length in samples
+	int look_ahead;
+	int long_offset; // long-term delay back-off in samples
 
 	/* buffer, loop number and data length definition */
 	float *tdeBuf_ref;
@@ -64,11 +69,13 @@ Description:   // load configure file and allocate memory
 Input:         // mic_num: microphone number
 				  ref_num: reference number
 				  frm_len: frame length
+				  sample_rate: sampling rate in Hz
+				  table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return dios speech signal process aec time delay estimation(tde) pointer
 	              failure: return NULL
 **********************************************************************************/
-objTDE* dios_ssp_aec_tde_init(int mic_num, int ref_num, int frm_len);
+objTDE* dios_ssp_aec_tde_init(int mic_num, int ref_num, int frm_len, int sample_rate, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_aec_tde_reset
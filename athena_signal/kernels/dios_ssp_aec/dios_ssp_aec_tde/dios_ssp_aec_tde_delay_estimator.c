@@ -20,6 +20,13 @@ spectra. The return value is 0 - OK and -1 - Error, unless otherwise stated.
 
 /* include file */
 #include "dios_ssp_aec_tde_delay_estimator.h"
+#include "../../dios_ssp_share/dios_ssp_share_arena.h"
+#include "../../dios_ssp_share/dios_ssp_share_workpool.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TDE_X86_SIMD
+#include <immintrin.h>
+#endif
 
 // Number of right shifts for scaling is linearly depending on number of bits in
 // the far-end binary spectrum.
@@ -70,6 +77,126 @@ void dios_ssp_aec_tde_meanestimate(int new_value, int factor, int* mean_value)
     *mean_value += diff;
 }
 
+// Compare with delayed spectra and store the |bit_counts| for each delay.
+// Update |mean_bit_counts| only when far-end signal has something to
+// contribute. If |far_bit_counts| is zero the far-end signal is weak and
+// we likely have a poor echo condition, hence don't update.
+static void tde_bitcount_pass_scalar(unsigned int binary_near_spectrum,
+                                     const unsigned int* binary_far_history,
+                                     const int* far_bit_counts, int n,
+                                     int* bit_counts, int* mean_bit_counts)
+{
+    int i;
+    int shifts;
+    for (i = 0; i < n; i++)
+    {
+        bit_counts[i] = BitCount(binary_near_spectrum ^ binary_far_history[i]);
+        if (far_bit_counts[i] > 0)
+        {
+            shifts = kShiftsAtZero - (kShiftsLinearSlope * far_bit_counts[i]) / 16;
+            dios_ssp_aec_tde_meanestimate(512 * bit_counts[i], shifts, &mean_bit_counts[i]);
+        }
+    }
+}
+
+#ifdef TDE_X86_SIMD
+__attribute__((target("popcnt")))
+static void tde_bitcount_pass_popcnt(unsigned int binary_near_spectrum,
+                                     const unsigned int* binary_far_history,
+                                     const int* far_bit_counts, int n,
+                                     int* bit_counts, int* mean_bit_counts)
+{
+    int i;
+    int shifts;
+    for (i = 0; i < n; i++)
+    {
+        bit_counts[i] = __builtin_popcount(binary_near_spectrum ^ binary_far_history[i]);
+        if (far_bit_counts[i] > 0)
+        {
+            shifts = kShiftsAtZero - (kShiftsLinearSlope * far_bit_counts[i]) / 16;
+            dios_ssp_aec_tde_meanestimate(512 * bit_counts[i], shifts, &mean_bit_counts[i]);
+        }
+    }
+}
+
+// 8 delays per step: nibble table popcount, then the mean estimate as
+// sign(diff) * (|diff| >> shifts), which is what dios_ssp_aec_tde_meanestimate does.
+__attribute__((target("avx2")))
+static void tde_bitcount_pass_avx2(unsigned int binary_near_spectrum,
+                                   const unsigned int* binary_far_history,
+                                   const int* far_bit_counts, int n,
+                                   int* bit_counts, int* mean_bit_counts)
+{
+    int i;
+    const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                         0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    const __m256i ones8 = _mm256_set1_epi8(1);
+    const __m256i ones16 = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i shifts_at_zero = _mm256_set1_epi32(kShiftsAtZero);
+    const __m256i shifts_slope = _mm256_set1_epi32(kShiftsLinearSlope);
+    const __m256i near = _mm256_set1_epi32((int)binary_near_spectrum);
+    __m256i x, cnt, far_bits, shifts, mean, diff, step;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        x = _mm256_xor_si256(near, _mm256_loadu_si256((const __m256i*)(binary_far_history + i)));
+        cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lut, _mm256_and_si256(x, low_mask)),
+                              _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask)));
+        cnt = _mm256_madd_epi16(_mm256_maddubs_epi16(cnt, ones8), ones16);
+        _mm256_storeu_si256((__m256i*)(bit_counts + i), cnt);
+
+        far_bits = _mm256_loadu_si256((const __m256i*)(far_bit_counts + i));
+        shifts = _mm256_sub_epi32(shifts_at_zero, _mm256_srli_epi32(_mm256_mullo_epi32(shifts_slope, far_bits), 4));
+        mean = _mm256_loadu_si256((const __m256i*)(mean_bit_counts + i));
+        diff = _mm256_sub_epi32(_mm256_slli_epi32(cnt, 9), mean);
+        step = _mm256_sign_epi32(_mm256_srlv_epi32(_mm256_abs_epi32(diff), shifts), diff);
+        step = _mm256_and_si256(step, _mm256_cmpgt_epi32(far_bits, zero));
+        _mm256_storeu_si256((__m256i*)(mean_bit_counts + i), _mm256_add_epi32(mean, step));
+    }
+    tde_bitcount_pass_popcnt(binary_near_spectrum, binary_far_history + i, far_bit_counts + i,
+                             n - i, bit_counts + i, mean_bit_counts + i);
+}
+#endif
+
+/* a property of the cpu, not of an instance, so it stays out of saved states */
+static tde_bitcount_pass_fn tde_bitcount_pass = NULL;
+#ifndef DIOS_SSP_NO_THREADS
+static pthread_once_t tde_bitcount_pass_once = PTHREAD_ONCE_INIT;
+#endif
+
+static void tde_select_bitcount_pass(void)
+{
+    tde_bitcount_pass_fn pass = tde_bitcount_pass_scalar;
+
+#ifdef TDE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+    {
+        pass = tde_bitcount_pass_avx2;
+    }
+    else if (__builtin_cpu_supports("popcnt"))
+    {
+        pass = tde_bitcount_pass_popcnt;
+    }
+#endif
+    tde_bitcount_pass = pass;
+}
+
+/* selects the kernel once, also when several instances are created concurrently */
+static void tde_bitcount_pass_init(void)
+{
+#ifndef DIOS_SSP_NO_THREADS
+    pthread_once(&tde_bitcount_pass_once, tde_select_bitcount_pass);
+#else
+    if (tde_bitcount_pass == NULL)
+    {
+        tde_select_bitcount_pass();
+    }
+#endif
+}
+
 /* Collects necessary statistics */
 static void UpdateRobustValidationStatistics(BinaryDelayEstimator* self,
                                              int candidate_delay,
@@ -152,8 +279,6 @@ int dios_ssp_aec_tde_processbinaryspectrum(BinaryDelayEstimator* self, unsigned
     int value_best_candidate = kMaxBitCountsQ9;
     int value_worst_candidate = 0;
     int valley_depth = 0;
-    int shifts = 0;
-    int bit_count = 0;
     int threshold = 0;
     int is_histogram_valid = 0;
     int is_robust = 0;
@@ -163,22 +288,14 @@ int dios_ssp_aec_tde_processbinaryspectrum(BinaryDelayEstimator* self, unsigned
         return -1;
     }
       
+    // XOR-popcount and |mean_bit_counts| smoothing over the whole history in one pass.
+    tde_bitcount_pass(binary_near_spectrum,
+                      self->farend->binary_far_history + self->farend->history_pos,
+                      self->farend->far_bit_counts + self->farend->history_pos,
+                      self->farend->history_size, self->bit_counts, self->mean_bit_counts);
+
     for (i = 0; i < self->farend->history_size; i++)
 	{
-        // Compare with delayed spectra and store the |bit_counts| for each delay.
-        self->bit_counts[i] = (int) BitCount(binary_near_spectrum ^ self->farend->binary_far_history[i]);
-        bit_count = 512 * self->bit_counts[i];
-
-        // Update |mean_bit_counts| only when far-end signal has something to
-        // contribute. If |far_bit_counts| is zero the far-end signal is weak and
-        // we likely have a poor echo condition, hence don't update.
-        if (self->farend->far_bit_counts[i] > 0)
-	    {
-            shifts = kShiftsAtZero;
-            shifts -= (int) (kShiftsLinearSlope * self->farend->far_bit_counts[i]) / 16;
-            dios_ssp_aec_tde_meanestimate(bit_count, shifts, &(self->mean_bit_counts[i]));
-        }
-
         if (self->mean_bit_counts[i] < value_best_candidate)
 	    {
             value_best_candidate = self->mean_bit_counts[i];
@@ -228,7 +345,9 @@ int dios_ssp_aec_tde_processbinaryspectrum(BinaryDelayEstimator* self, unsigned
             self->histogram[self->compare_delay] = (self->histogram[candidate_delay] < self->histogram[self->compare_delay] ? self->histogram[candidate_delay] : 
                                                     self->histogram[self->compare_delay]);
         }	
-	    if ((candidate_delay > self->last_delay + 2) || (self->last_delay > candidate_delay + 2 ))
+	    // the first valid candidate is always taken, a delay of 0 or 1 would otherwise
+	    // leave last_delay (and compare_delay) at the negative initial value
+	    if ((self->last_delay < 0) || (candidate_delay > self->last_delay + 2) || (self->last_delay > candidate_delay + 2 ))
 	    {
 		    self->last_delay = candidate_delay;
 	    }
@@ -241,17 +360,22 @@ int dios_ssp_aec_tde_processbinaryspectrum(BinaryDelayEstimator* self, unsigned
 
 void dios_ssp_aec_tde_addbinaryfarspectrum(BinaryDelayEstimatorFarend* handle, unsigned int binary_far_spectrum)
 {
+    int pos;
+    int far_bit_count;
     if(handle == NULL)
     {
         return;
     }
     
-    // Shift binary spectrum history and insert current |binary_far_spectrum|.
-    memmove(&(handle->binary_far_history[1]), &(handle->binary_far_history[0]), (handle->history_size - 1) * sizeof(unsigned int));
-    handle->binary_far_history[0] = binary_far_spectrum;
-
-    memmove(&(handle->far_bit_counts[1]), &(handle->far_bit_counts[0]), (handle->history_size - 1) * sizeof(int));
-    handle->far_bit_counts[0] = BitCount(binary_far_spectrum);
+    // Step the ring back one slot and insert current |binary_far_spectrum| as
+    // delay 0, older entries move up one delay without being copied.
+    pos = (handle->history_pos == 0 ? handle->history_size : handle->history_pos) - 1;
+    far_bit_count = BitCount(binary_far_spectrum);
+    handle->binary_far_history[pos] = binary_far_spectrum;
+    handle->binary_far_history[pos + handle->history_size] = binary_far_spectrum;
+    handle->far_bit_counts[pos] = far_bit_count;
+    handle->far_bit_counts[pos + handle->history_size] = far_bit_count;
+    handle->history_pos = pos;
 }
 
 /* initialization subfunction */
@@ -262,15 +386,19 @@ void dios_ssp_aec_tde_freebinarydelayestimatorfarend(BinaryDelayEstimatorFarend*
         return;
     }
 
-    free(self->binary_far_history);
+    dios_ssp_share_free(self->binary_far_history);
     self->binary_far_history = NULL;
 
-    free(self->far_bit_counts);
+    dios_ssp_share_free(self->far_bit_counts);
     self->far_bit_counts = NULL;
 
-    free(self);
+    dios_ssp_share_free(self);
 }
 
+static const size_t g_tde_binary_farend_ptr[] = {
+	offsetof(BinaryDelayEstimatorFarend, far_bit_counts), offsetof(BinaryDelayEstimatorFarend, binary_far_history)
+};
+
 BinaryDelayEstimatorFarend* dios_ssp_aec_tde_creatbinarydelayestimatorfarend(int history_size)
 {
     BinaryDelayEstimatorFarend* self = NULL;
@@ -278,7 +406,7 @@ BinaryDelayEstimatorFarend* dios_ssp_aec_tde_creatbinarydelayestimatorfarend(int
     if (history_size > 1)
     {
         // Sanity conditions fulfilled.
-        self = (BinaryDelayEstimatorFarend*)calloc(1, sizeof(BinaryDelayEstimatorFarend));
+        self = (BinaryDelayEstimatorFarend*)dios_ssp_share_calloc_map(1, sizeof(BinaryDelayEstimatorFarend), g_tde_binary_farend_ptr, SHARE_ARENA_MAP_NUM(g_tde_binary_farend_ptr));
     }
     if (self != NULL)
     {
@@ -287,10 +415,10 @@ BinaryDelayEstimatorFarend* dios_ssp_aec_tde_creatbinarydelayestimatorfarend(int
         self->history_size = history_size;
 
         // Allocate memory for history buffers.
-        self->binary_far_history = (unsigned int*)calloc(history_size, sizeof(unsigned int));
+        self->binary_far_history = (unsigned int*)dios_ssp_share_calloc(2 * history_size, sizeof(unsigned int));
         malloc_fail |= (self->binary_far_history == NULL);
 
-        self->far_bit_counts = (int*)calloc(history_size, sizeof(int));
+        self->far_bit_counts = (int*)dios_ssp_share_calloc(2 * history_size, sizeof(int));
         malloc_fail |= (self->far_bit_counts == NULL);
 
         if (malloc_fail)
@@ -309,8 +437,9 @@ void dios_ssp_aec_tde_initbinarydelayestimatorfarend(BinaryDelayEstimatorFarend*
     {
         return;
     }
-    memset(self->binary_far_history, 0, sizeof(unsigned int) * self->history_size);
-    memset(self->far_bit_counts, 0, sizeof(int) * self->history_size);
+    memset(self->binary_far_history, 0, sizeof(unsigned int) * 2 * self->history_size);
+    memset(self->far_bit_counts, 0, sizeof(int) * 2 * self->history_size);
+    self->history_pos = 0;
 }
 
 void dios_ssp_aec_tde_freebinarydelayestimator(BinaryDelayEstimator* self)
@@ -320,23 +449,23 @@ void dios_ssp_aec_tde_freebinarydelayestimator(BinaryDelayEstimator* self)
         return;
     }
 
-    free(self->mean_bit_counts);
+    dios_ssp_share_free(self->mean_bit_counts);
     self->mean_bit_counts = NULL;
 
-    free(self->bit_counts);
+    dios_ssp_share_free(self->bit_counts);
     self->bit_counts = NULL;
 
-    free(self->binary_near_history);
+    dios_ssp_share_free(self->binary_near_history);
     self->binary_near_history = NULL;
 
-    free(self->histogram);
+    dios_ssp_share_free(self->histogram);
     self->histogram = NULL;
 
     // BinaryDelayEstimator does not have ownership of |farend|, hence we do not
     // free the memory here. That should be handled separately by the user.
     self->farend = NULL;
 
-    free(self);
+    dios_ssp_share_free(self);
 }
 void dios_ssp_aec_tde_initbinarydelayestimator(BinaryDelayEstimator* self)
 {
@@ -365,6 +494,12 @@ void dios_ssp_aec_tde_initbinarydelayestimator(BinaryDelayEstimator* self)
     self->last_delay_histogram = 0.f;
 }
 
+static const size_t g_tde_binary_estimator_ptr[] = {
+	offsetof(BinaryDelayEstimator, mean_bit_counts), offsetof(BinaryDelayEstimator, bit_counts),
+	offsetof(BinaryDelayEstimator, binary_near_history), offsetof(BinaryDelayEstimator, histogram),
+	offsetof(BinaryDelayEstimator, farend)
+};
+
 BinaryDelayEstimator* dios_ssp_aec_tde_creatbinarydelayestimator(BinaryDelayEstimatorFarend* farend, int max_lookahead)
 {
     BinaryDelayEstimator* self = NULL;
@@ -372,7 +507,7 @@ BinaryDelayEstimator* dios_ssp_aec_tde_creatbinarydelayestimator(BinaryDelayEsti
     if ((farend != NULL) && (max_lookahead >= 0))
     {
         // Sanity conditions fulfilled.
-        self = (BinaryDelayEstimator*)calloc(1, sizeof(BinaryDelayEstimator));
+        self = (BinaryDelayEstimator*)dios_ssp_share_calloc_map(1, sizeof(BinaryDelayEstimator), g_tde_binary_estimator_ptr, SHARE_ARENA_MAP_NUM(g_tde_binary_estimator_ptr));
     }
 
     if (self != NULL)
@@ -384,19 +519,20 @@ BinaryDelayEstimator* dios_ssp_aec_tde_creatbinarydelayestimator(BinaryDelayEsti
         self->robust_validation_enabled = 1;  //0, Disabled by default.
 
         self->lookahead = max_lookahead;
+        tde_bitcount_pass_init();
 
         
-        self->mean_bit_counts = (int*)calloc((farend->history_size + 1), sizeof(int));
+        self->mean_bit_counts = (int*)dios_ssp_share_calloc((farend->history_size + 1), sizeof(int));
         malloc_fail |= (self->mean_bit_counts == NULL);
 
-        self->bit_counts = (int*)calloc(farend->history_size, sizeof(int));
+        self->bit_counts = (int*)dios_ssp_share_calloc(farend->history_size, sizeof(int));
         malloc_fail |= (self->bit_counts == NULL);
 
         // Allocate memory for history buffers.
-        self->binary_near_history = (unsigned int*)calloc((max_lookahead + 1), sizeof(unsigned int));
+        self->binary_near_history = (unsigned int*)dios_ssp_share_calloc((max_lookahead + 1), sizeof(unsigned int));
         malloc_fail |= (self->binary_near_history == NULL);
 
-        self->histogram = (float*)calloc((farend->history_size + 1), sizeof(float));
+        self->histogram = (float*)dios_ssp_share_calloc((farend->history_size + 1), sizeof(float));
         malloc_fail |= (self->histogram == NULL);
 
         if (malloc_fail)
@@ -31,8 +31,19 @@ typedef struct
     // Binary history variables.
     unsigned int* binary_far_history;
     int history_size;
+    // Both histories are ring buffers stored twice (2 * history_size), so the
+    // newest history_size entries always start contiguously at history_pos,
+    // delay i lives at [history_pos + i].
+    int history_pos;
 } BinaryDelayEstimatorFarend;
 
+// XOR-popcount against the far-end history and |mean_bit_counts| smoothing
+// of |n| delays, see dios_ssp_aec_tde_processbinaryspectrum().
+typedef void (*tde_bitcount_pass_fn)(unsigned int binary_near_spectrum,
+                                     const unsigned int* binary_far_history,
+                                     const int* far_bit_counts, int n,
+                                     int* bit_counts, int* mean_bit_counts);
+
 typedef struct
 {
     // Pointer to bit counts.
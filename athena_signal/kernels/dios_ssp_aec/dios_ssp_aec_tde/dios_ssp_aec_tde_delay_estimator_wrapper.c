@@ -19,6 +19,7 @@ which is an open source.This file is the core module of delay detection function
 
 /* include file */
 #include "dios_ssp_aec_tde_delay_estimator_wrapper.h"
+#include "../../dios_ssp_share/dios_ssp_share_arena.h"
 
 #define BACKGROUND_MUSIC
 
@@ -215,6 +216,7 @@ int dios_ssp_aec_tde_ProcessBlock(AecmCore_t * srv,
     float xfa[PART_LEN1];    /* farend signal frequency domain amplitude */
     float dfaNoisy[PART_LEN1];   /* near end signal frequency domain amplitude */
     int delay;
+    int oldest;
     short zerosDBufNoisy;
     int far_q;
 
@@ -236,18 +238,6 @@ int dios_ssp_aec_tde_ProcessBlock(AecmCore_t * srv,
                                            dfaNoisy);
 
     // Get the delay
-    // Save far-end history and estimate delay
-    // Get new buffer position
-    srv->far_history_pos++;
-    if (srv->far_history_pos >= srv->max_delay_history_size) 
-    {
-        srv->far_history_pos = 0;
-    }
-    // Update Q-domain buffer
-    srv->far_q_domains[srv->far_history_pos] = far_q;
-    // Update far end spectrum buffer
-    memcpy(&(srv->far_history[srv->far_history_pos * PART_LEN1]), xfa, sizeof(float) * PART_LEN1);
-
     if (dios_ssp_aec_tde_addfarspectrum(srv->delay_estimator_farend, xfa, PART_LEN1, far_q) == -1)
     {
         return -1;
@@ -271,24 +261,26 @@ int dios_ssp_aec_tde_ProcessBlock(AecmCore_t * srv,
         delay = srv->fixedDelay;
     }
 
-    // histogram
-    memmove(srv->delayN+1, srv->delayN, (srv->win_slide-1) * sizeof(int)); // DELAY_WIN_SLIDE
-    srv->delayN[0] = delay; //delay_t0;
-    memset(srv->delayHistVect,0, srv->max_delay_size*sizeof(int));
-    for (i = 0; i < srv->win_slide; i++) // DELAY_WIN_SLIDE
+    // histogram of the last win_slide delays, delayN is a ring buffer so only
+    // the oldest delay leaves and the newest one enters the histogram
+    oldest = srv->delayN[srv->delayN_pos];
+    if (oldest >= 0 && oldest < srv->max_delay_size)
     {
-		if (srv->delayN[i] >= 0 && srv->delayN[i] < srv->max_delay_size)
-		{
-			srv->delayHistVect[srv->delayN[i]]++;
-		}
-		else
-		{
-			printf("Delay exceed the estimate range!");
-		}
+        srv->delayHistVect[oldest]--;
+    }
+    srv->delayN[srv->delayN_pos] = delay;
+    srv->delayN_pos = (srv->delayN_pos + 1 == srv->win_slide) ? 0 : srv->delayN_pos + 1;
+    if (delay >= 0 && delay < srv->max_delay_size)
+    {
+        srv->delayHistVect[delay]++;
+    }
+    else
+    {
+        printf("Delay exceed the estimate range!");
     }
 
-    srv->delayHistVect[0] = 0; 
-    max_v = srv->delayHistVect[0]; 
+    // zero delay never wins
+    max_v = 0; 
     max_i = 0; 
     for (i = 1; i < srv->max_delay_size; i++)
     {
@@ -323,13 +315,13 @@ void dios_ssp_aec_tde_freedelayestimator(void* handle)
         return;
     }
 
-    free(self->mean_near_spectrum);
+    dios_ssp_share_free(self->mean_near_spectrum);
     self->mean_near_spectrum = NULL;
 
     dios_ssp_aec_tde_freebinarydelayestimator(self->binary_handle);
     self->binary_handle = NULL;
 
-    free(self);
+    dios_ssp_share_free(self);
 }
 
 void dios_ssp_aec_tde_freedelayestimatorfarend(void* handle)
@@ -341,13 +333,13 @@ void dios_ssp_aec_tde_freedelayestimatorfarend(void* handle)
         return;
     }
 
-    free(self->mean_far_spectrum);
+    dios_ssp_share_free(self->mean_far_spectrum);
     self->mean_far_spectrum = NULL;
 
     dios_ssp_aec_tde_freebinarydelayestimatorfarend(self->binary_farend);
     self->binary_farend = NULL;
 
-    free(self);
+    dios_ssp_share_free(self);
 }
 
 int dios_ssp_aec_tde_initdelayestimatorfarend(void* handle)
@@ -390,6 +382,10 @@ int dios_ssp_aec_tde_initdelayestimator(void* handle)
     return 0;
 }
 
+static const size_t g_tde_farend_ptr[] = {
+	offsetof(DelayEstimatorFarend, mean_far_spectrum), offsetof(DelayEstimatorFarend, binary_farend)
+};
+
 void* dios_ssp_aec_tde_creatdelayestimatorfarend(int spectrum_size, int history_size)
 {
     DelayEstimatorFarend* self = NULL;
@@ -400,7 +396,7 @@ void* dios_ssp_aec_tde_creatdelayestimatorfarend(int spectrum_size, int history_
 
     if (spectrum_size >= kBandLast)
     {
-        self = (DelayEstimatorFarend*)calloc(1, sizeof(DelayEstimator));
+        self = (DelayEstimatorFarend*)dios_ssp_share_calloc_map(1, sizeof(DelayEstimatorFarend), g_tde_farend_ptr, SHARE_ARENA_MAP_NUM(g_tde_farend_ptr));
     }
 
     if (self != NULL)
@@ -412,7 +408,7 @@ void* dios_ssp_aec_tde_creatdelayestimatorfarend(int spectrum_size, int history_
         memory_fail |= (self->binary_farend == NULL);
 
         // Allocate memory for spectrum buffers.
-        self->mean_far_spectrum = (SpectrumType*)calloc(spectrum_size, sizeof(SpectrumType));
+        self->mean_far_spectrum = (SpectrumType*)dios_ssp_share_calloc(spectrum_size, sizeof(SpectrumType));
         memory_fail |= (self->mean_far_spectrum == NULL);
 
         self->spectrum_size = spectrum_size;
@@ -427,6 +423,10 @@ void* dios_ssp_aec_tde_creatdelayestimatorfarend(int spectrum_size, int history_
     return self;
 }
 
+static const size_t g_tde_estimator_ptr[] = {
+	offsetof(DelayEstimator, mean_near_spectrum), offsetof(DelayEstimator, binary_handle)
+};
+
 void* dios_ssp_aec_tde_creatdelayestimator(void* farend_handle, int max_lookahead)
 {
     DelayEstimator* self = NULL;
@@ -434,7 +434,7 @@ void* dios_ssp_aec_tde_creatdelayestimator(void* farend_handle, int max_lookahea
 
     if (farend_handle != NULL)
     {
-        self = (DelayEstimator*)calloc(1, sizeof(DelayEstimator));
+        self = (DelayEstimator*)dios_ssp_share_calloc_map(1, sizeof(DelayEstimator), g_tde_estimator_ptr, SHARE_ARENA_MAP_NUM(g_tde_estimator_ptr));
     }
 
     if (self != NULL)
@@ -446,7 +446,7 @@ void* dios_ssp_aec_tde_creatdelayestimator(void* farend_handle, int max_lookahea
         memory_fail |= (self->binary_handle == NULL);
 
         // Allocate memory for spectrum buffers.
-        self->mean_near_spectrum = (SpectrumType*)calloc(farend->spectrum_size, sizeof(SpectrumType));
+        self->mean_near_spectrum = (SpectrumType*)dios_ssp_share_calloc(farend->spectrum_size, sizeof(SpectrumType));
         memory_fail |= (self->mean_near_spectrum == NULL);
 
         self->spectrum_size = farend->spectrum_size;
@@ -481,10 +481,21 @@ int dios_ssp_aec_tde_robust_validation(void* handle, int enable)
     return 0;
 }
 
+static const size_t g_tde_core_ptr[] = {
+	offsetof(AecmCore_t, farFrameBuf), offsetof(AecmCore_t, nearNoisyFrameBuf),
+	offsetof(AecmCore_t, nearCleanFrameBuf), offsetof(AecmCore_t, outFrameBuf),
+	offsetof(AecmCore_t, delay_estimator_farend), offsetof(AecmCore_t, delay_estimator),
+	offsetof(AecmCore_t, channelStored), offsetof(AecmCore_t, channelAdapt16),
+	offsetof(AecmCore_t, channelAdapt32), offsetof(AecmCore_t, xBuf),
+	offsetof(AecmCore_t, dBufClean), offsetof(AecmCore_t, dBufNoisy),
+	offsetof(AecmCore_t, outBuf), offsetof(AecmCore_t, delayHistVect),
+	offsetof(AecmCore_t, delayN), offsetof(AecmCore_t, rfft_param)
+};
+
 /* initialization */
-int dios_ssp_aec_tde_creatcore(AecmCore_t **aecmInst, int max_delay_size, int win_slide)
+int dios_ssp_aec_tde_creatcore(AecmCore_t **aecmInst, int max_delay_size, int win_slide, void *table_pool)
 {
-    AecmCore_t *srv = (AecmCore_t*)calloc(1, sizeof(AecmCore_t));
+    AecmCore_t *srv = (AecmCore_t*)dios_ssp_share_calloc_map(1, sizeof(AecmCore_t), g_tde_core_ptr, SHARE_ARENA_MAP_NUM(g_tde_core_ptr));
     *aecmInst = srv;
     if (srv == NULL)
     {
@@ -564,8 +575,17 @@ int dios_ssp_aec_tde_creatcore(AecmCore_t **aecmInst, int max_delay_size, int wi
 	//srv->max_long_delay_size = MAX_DELAY_LONG; // 750
     srv->delayHistVect    = NULL; 
     srv->delayN    = NULL; 
-    srv->delayHistVect = (int *)calloc(srv->max_delay_size, sizeof(int)); 
-	srv->delayN = (int *)calloc(srv->win_slide, sizeof(int)); //
+    srv->delayHistVect = (int *)dios_ssp_share_calloc(srv->max_delay_size, sizeof(int)); 
+	srv->delayN = (int *)dios_ssp_share_calloc(srv->win_slide, sizeof(int)); //
+
+    /* created once, dios_ssp_aec_tde_initcore also runs on every reset */
+    srv->rfft_param = dios_ssp_share_rfft_init_pool(PART_LEN2, table_pool);
+    if (srv->rfft_param == NULL)
+    {
+        dios_ssp_aec_tde_freecore(srv);
+        srv = NULL;
+        return -1;
+    }
 
 	return 0;
 }
@@ -599,11 +619,6 @@ int dios_ssp_aec_tde_initcore(AecmCore_t * const srv)
 	{
         return -1;
     }
-    // Set far end histories to zero
-    memset(srv->far_history, 0, sizeof(float) * PART_LEN1 * MAX_DELAY_LONG);
-    memset(srv->far_q_domains, 0, sizeof(int) * MAX_DELAY_LONG);
-	srv->far_history_pos = srv->max_delay_history_size; // increase est. delay range
-
     srv->fixedDelay = -1;
 
     // Shape the initial noise level to an approximate pink noise.
@@ -628,8 +643,9 @@ int dios_ssp_aec_tde_initcore(AecmCore_t * const srv)
     srv->delay_nsample    = 0;
     memset(srv->delayHistVect, 0, srv->max_delay_size * sizeof(int)); 
 	memset(srv->delayN, 0, srv->win_slide * sizeof(int)); 
+	srv->delayHistVect[0] = srv->win_slide;
+	srv->delayN_pos = 0;
 
-    srv->rfft_param = dios_ssp_share_rfft_init(PART_LEN2);
     memset(srv->fft_out, 0, sizeof(srv->fft_out));
     for (i=0; i < PART_LEN2; i++)
     {
@@ -656,16 +672,16 @@ int dios_ssp_aec_tde_freecore(AecmCore_t *srv)
 
     if (srv->delayHistVect != NULL)
     {
-        free(srv->delayHistVect);
+        dios_ssp_share_free(srv->delayHistVect);
         srv->delayHistVect = NULL;
     }
     if (srv->delayN != NULL)
     {
-        free(srv->delayN);
+        dios_ssp_share_free(srv->delayN);
         srv->delayN = NULL;
     }
 
-    free(srv);
+    dios_ssp_share_free(srv);
 
     return 0;
 }
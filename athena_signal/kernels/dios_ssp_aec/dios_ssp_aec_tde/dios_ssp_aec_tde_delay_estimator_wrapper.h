@@ -89,9 +89,6 @@ typedef struct {
     void* delay_estimator;
     unsigned short currentDelay;
 
-    float far_history[PART_LEN1 * MAX_DELAY_LONG];
-    int far_q_domains[MAX_DELAY_LONG];
-    int far_history_pos;
     int max_delay_history_size; 
     
     short fixedDelay;
@@ -127,7 +124,8 @@ typedef struct {
     short vadUpdateCount;
 
     int            *delayHistVect; // 
-    int            *delayN; 
+    int            *delayN;  // ring buffer of the last win_slide delays
+    int            delayN_pos;
     int            delay_nframe;
     int            delay_nsample;
     int            max_delay_size;  // short-term delay
@@ -283,11 +281,12 @@ Description:   // allocates the memory needed by the AECM. The memory needs to b
                   initialized separately using the dios_ssp_aec_tde_initcore() 
                   function.
 Input:         // srv: Instance that should be created
+                  table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // srv: Created instance
 Return:        // 0 - Ok
                  -1 - Error
 **********************************************************************************/
-int dios_ssp_aec_tde_creatcore(AecmCore_t **srv, int max_delay_size, int win_slide);
+int dios_ssp_aec_tde_creatcore(AecmCore_t **srv, int max_delay_size, int win_slide, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_aec_tde_initcore
@@ -21,6 +21,7 @@ functions return 0 on success and -1 on error.
 
 /* include file */
 #include "dios_ssp_aec_tde_ring_buffer.h"
+#include "../../dios_ssp_share/dios_ssp_share_arena.h"
 
 enum Wrap
 {
@@ -37,6 +38,10 @@ struct RingBuffer
 	char* data;
 };
 
+static const size_t g_ring_buffer_ptr[] = {
+	offsetof(RingBuffer, data)
+};
+
 RingBuffer* dios_ssp_aec_tde_creatbuffer(size_t element_count, size_t element_size)
 {
 	RingBuffer* self = NULL;
@@ -45,16 +50,16 @@ RingBuffer* dios_ssp_aec_tde_creatbuffer(size_t element_count, size_t element_si
 		return NULL;
 	}
 
-	self = (RingBuffer*)calloc(1, sizeof(RingBuffer));
+	self = (RingBuffer*)dios_ssp_share_calloc_map(1, sizeof(RingBuffer), g_ring_buffer_ptr, SHARE_ARENA_MAP_NUM(g_ring_buffer_ptr));
 	if (!self)
 	{
 		return NULL;
 	}
 
-	self->data = (char*)calloc(element_count * element_size, sizeof(char));
+	self->data = (char*)dios_ssp_share_calloc(element_count * element_size, sizeof(char));
 	if (!self->data)
 	{
-		free(self);
+		dios_ssp_share_free(self);
 		self = NULL;
 		return NULL;
 	}
@@ -90,6 +95,6 @@ void dios_ssp_aec_tde_freebuffer(void* handle)
 		return;
 	}
 
-	free(self->data);
-	free(self);
+	dios_ssp_share_free(self->data);
+	dios_ssp_share_free(self);
 }
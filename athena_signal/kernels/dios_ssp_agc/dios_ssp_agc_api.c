@@ -27,6 +27,10 @@ Function framework:
 ==============================================================================*/
 
 #include "dios_ssp_agc_api.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
+
+/* the time constants below are given in samples at this rate */
+#define AGC_SAMPLE_RATE (16000)
 
 typedef struct {
     int frame_len;
@@ -278,17 +282,32 @@ float gain_smooth(float gain, objGainSmooth *st_gs, float gain_delay, float vads
 	return(gain_final);
 }
 
-void* dios_ssp_agc_init_api(int frame_len, float peak_val, int mode_type)
+static const size_t g_agc_ptr[] = {
+	offsetof(objAGC, vad_buffer), offsetof(objAGC, gain_agc_buffer),
+	offsetof(objAGC, gain_sort), offsetof(objAGC, st_gc),
+	offsetof(objAGC, st_gs), offsetof(objAGC, st_wake)
+};
+
+static const size_t g_agc_wake_ptr[] = {
+	offsetof(objWakeupGainInfo, kws_gain_buffer), offsetof(objWakeupGainInfo, kws_gain_buffer_sort),
+	offsetof(objWakeupGainInfo, each_kws_gain_buffer), offsetof(objWakeupGainInfo, tick_kws_start),
+	offsetof(objWakeupGainInfo, tick_kws_end), offsetof(objWakeupGainInfo, tick_kws_len),
+	offsetof(objWakeupGainInfo, kws_gain_min_filter), offsetof(objWakeupGainInfo, kws_gain_max_filter),
+	offsetof(objWakeupGainInfo, kws_gain), offsetof(objWakeupGainInfo, kws_gain_max),
+	offsetof(objWakeupGainInfo, kws_gain_min)
+};
+
+void* dios_ssp_agc_init_api(int frame_len, float peak_val, int mode_type, int sample_rate)
 {
     int i,k;
 
 	void* ptr = NULL;
-	ptr = (void*)calloc(1,sizeof(objAGC));
+	ptr = (void*)dios_ssp_share_calloc_map(1, sizeof(objAGC), g_agc_ptr, SHARE_ARENA_MAP_NUM(g_agc_ptr));
 	objAGC *srv;
 	srv = (objAGC *)ptr;
 	srv->mode_type = mode_type;
 	srv->vol_kws_enable_flag = 0;
-	srv->block_len = 1280;
+	srv->block_len = 1280 * sample_rate / AGC_SAMPLE_RATE;
 	srv->frame_len = frame_len;
 	srv->dir_gain_smooth_fac = 0.9f;  //80ms 
 	srv->no_dir_vad_cnt = 0;
@@ -307,9 +326,9 @@ void* dios_ssp_agc_init_api(int frame_len, float peak_val, int mode_type)
 	srv->useful_gain_sort_count = 0;
 
 
-	srv->vad_buffer = (int *)calloc(srv->each_block_frame_num, sizeof(int));
-	srv->gain_agc_buffer = (float *)calloc(srv->each_block_frame_num, sizeof(float));
-	srv->gain_sort = (float *)calloc(srv->each_block_frame_num, sizeof(float));
+	srv->vad_buffer = (int *)dios_ssp_share_calloc(srv->each_block_frame_num, sizeof(int));
+	srv->gain_agc_buffer = (float *)dios_ssp_share_calloc(srv->each_block_frame_num, sizeof(float));
+	srv->gain_sort = (float *)dios_ssp_share_calloc(srv->each_block_frame_num, sizeof(float));
 	for (i = 0; i < srv->each_block_frame_num; i++)
 	{
 		srv->vad_buffer[i] = 0;
@@ -319,19 +338,19 @@ void* dios_ssp_agc_init_api(int frame_len, float peak_val, int mode_type)
 	srv->frame_index = 0;
 	srv->first_flag = 1;
 
-	srv->st_gc = (objGainCalc *)calloc(1, sizeof(objGainCalc));
+	srv->st_gc = (objGainCalc *)dios_ssp_share_calloc(1, sizeof(objGainCalc));
 	srv->st_gc->def_max_peak_val = peak_val;
 	srv->st_gc->defs_max_rms_enrg = 0.70710678118655f * 32767.0f * 0.7f;
 	srv->st_gc->defs_clip_val = 26000.0f;
 	srv->st_gc->frame_len = srv->frame_len;
 	srv->st_gc->peak_val = 0;
 	srv->st_gc->peak_hold_cnt = 0;
-	srv->st_gc->peak_hold_time = (int)(640 / srv->st_gc->frame_len);
-	srv->st_gc->peak_smooth_fac = xsmooth_factor(320.0f / (float)srv->st_gc->frame_len);
+	srv->st_gc->peak_hold_time = (int)(640 * sample_rate / AGC_SAMPLE_RATE / srv->st_gc->frame_len);
+	srv->st_gc->peak_smooth_fac = xsmooth_factor(320.0f * sample_rate / AGC_SAMPLE_RATE / (float)srv->st_gc->frame_len);
 	srv->st_gc->gain_smooth_fac = xsmooth_factor(8.0f);
 	srv->st_gc->first_flag = 1;
 	
-	srv->st_gs = (objGainSmooth *)calloc(1, sizeof(objGainSmooth));
+	srv->st_gs = (objGainSmooth *)dios_ssp_share_calloc(1, sizeof(objGainSmooth));
 	srv->st_gs->gain_min = 3000.0f;
 	srv->st_gs->gain_max = 3000.0f;
 	srv->st_gs->gain_min_tmp = 3000.0f;
@@ -359,7 +378,7 @@ void* dios_ssp_agc_init_api(int frame_len, float peak_val, int mode_type)
 	srv->st_wake = NULL;
 	
 	//init wakeup buffer gain and var.
-	srv->st_wake = (objWakeupGainInfo*)calloc(1, sizeof(objWakeupGainInfo));
+	srv->st_wake = (objWakeupGainInfo*)dios_ssp_share_calloc_map(1, sizeof(objWakeupGainInfo), g_agc_wake_ptr, SHARE_ARENA_MAP_NUM(g_agc_wake_ptr));
 	srv->st_wake->cache_len = 1000;      //buffer the nearest 1000 frames gain = 8s
 	srv->st_wake->max_ushort = 65535;
 	srv->st_wake->max_kws_word_num = 10;
@@ -368,29 +387,29 @@ void* dios_ssp_agc_init_api(int frame_len, float peak_val, int mode_type)
 	srv->st_wake->tick_kws_now = 0;
 	srv->st_wake->tick_kws_last = 0;
 	srv->st_wake->median_filter_len = 5; //median filter len
-	srv->st_wake->kws_gain_buffer = (float*)calloc(srv->st_wake->cache_len, sizeof(float));
-	srv->st_wake->each_kws_gain_buffer = (float**)calloc(srv->st_wake->max_kws_word_num, sizeof(float*));
+	srv->st_wake->kws_gain_buffer = (float*)dios_ssp_share_calloc(srv->st_wake->cache_len, sizeof(float));
+	srv->st_wake->each_kws_gain_buffer = (float**)dios_ssp_share_calloc_ptr(srv->st_wake->max_kws_word_num, sizeof(float*));
 	for (k = 0; k < srv->st_wake->max_kws_word_num; k++) 
     {
-		srv->st_wake->each_kws_gain_buffer[k] = (float*)calloc(srv->st_wake->cache_len, sizeof(float));
+		srv->st_wake->each_kws_gain_buffer[k] = (float*)dios_ssp_share_calloc(srv->st_wake->cache_len, sizeof(float));
 	}
 
-	srv->st_wake->kws_gain_buffer_sort = (float*)calloc(srv->st_wake->max_kws_word_num, sizeof(float));
+	srv->st_wake->kws_gain_buffer_sort = (float*)dios_ssp_share_calloc(srv->st_wake->max_kws_word_num, sizeof(float));
 
-	srv->st_wake->tick_kws_start = (int*)calloc(srv->st_wake->max_kws_word_num, sizeof(int));
-	srv->st_wake->tick_kws_end = (int*)calloc(srv->st_wake->max_kws_word_num, sizeof(int));
-	srv->st_wake->tick_kws_len = (int*)calloc(srv->st_wake->max_kws_word_num, sizeof(int));
+	srv->st_wake->tick_kws_start = (int*)dios_ssp_share_calloc(srv->st_wake->max_kws_word_num, sizeof(int));
+	srv->st_wake->tick_kws_end = (int*)dios_ssp_share_calloc(srv->st_wake->max_kws_word_num, sizeof(int));
+	srv->st_wake->tick_kws_len = (int*)dios_ssp_share_calloc(srv->st_wake->max_kws_word_num, sizeof(int));
 
-	srv->st_wake->kws_gain = (float*)calloc(srv->st_wake->max_kws_word_num, sizeof(float));
-	srv->st_wake->kws_gain_max = (float*)calloc(srv->st_wake->max_kws_word_num, sizeof(float));
-	srv->st_wake->kws_gain_min = (float*)calloc(srv->st_wake->max_kws_word_num, sizeof(float));
+	srv->st_wake->kws_gain = (float*)dios_ssp_share_calloc(srv->st_wake->max_kws_word_num, sizeof(float));
+	srv->st_wake->kws_gain_max = (float*)dios_ssp_share_calloc(srv->st_wake->max_kws_word_num, sizeof(float));
+	srv->st_wake->kws_gain_min = (float*)dios_ssp_share_calloc(srv->st_wake->max_kws_word_num, sizeof(float));
 	
-	srv->st_wake->kws_gain_min_filter = (float**)calloc(srv->st_wake->max_kws_word_num, sizeof(float*));
-	srv->st_wake->kws_gain_max_filter = (float**)calloc(srv->st_wake->max_kws_word_num, sizeof(float*));
+	srv->st_wake->kws_gain_min_filter = (float**)dios_ssp_share_calloc_ptr(srv->st_wake->max_kws_word_num, sizeof(float*));
+	srv->st_wake->kws_gain_max_filter = (float**)dios_ssp_share_calloc_ptr(srv->st_wake->max_kws_word_num, sizeof(float*));
 	for (k = 0; k < srv->st_wake->max_kws_word_num; k++) 
     {
-		srv->st_wake->kws_gain_min_filter[k] = (float*)calloc(srv->st_wake->median_filter_len, sizeof(float));
-		srv->st_wake->kws_gain_max_filter[k] = (float*)calloc(srv->st_wake->median_filter_len, sizeof(float));
+		srv->st_wake->kws_gain_min_filter[k] = (float*)dios_ssp_share_calloc(srv->st_wake->median_filter_len, sizeof(float));
+		srv->st_wake->kws_gain_max_filter[k] = (float*)dios_ssp_share_calloc(srv->st_wake->median_filter_len, sizeof(float));
 	}
 	
     return(ptr);
@@ -614,35 +633,35 @@ int dios_ssp_agc_uninit_api(void* ptr)
     int k;
 
 	objAGC *srv = (objAGC *)ptr;
-	free(srv->st_gc);
-	free(srv->st_gs);
-	free(srv->vad_buffer);
-	free(srv->gain_agc_buffer);
-	free(srv->gain_sort);
+	dios_ssp_share_free(srv->st_gc);
+	dios_ssp_share_free(srv->st_gs);
+	dios_ssp_share_free(srv->vad_buffer);
+	dios_ssp_share_free(srv->gain_agc_buffer);
+	dios_ssp_share_free(srv->gain_sort);
 	
     //wakeup control agc free
 	for (k = 0; k < srv->st_wake->max_kws_word_num; k++) 
     {
-		free(srv->st_wake->kws_gain_min_filter[k]);
-		free(srv->st_wake->kws_gain_max_filter[k]);
+		dios_ssp_share_free(srv->st_wake->kws_gain_min_filter[k]);
+		dios_ssp_share_free(srv->st_wake->kws_gain_max_filter[k]);
 	}
-	free(srv->st_wake->tick_kws_start);
-	free(srv->st_wake->tick_kws_end);
-	free(srv->st_wake->tick_kws_len);
-	free(srv->st_wake->kws_gain);
-	free(srv->st_wake->kws_gain_max);
-	free(srv->st_wake->kws_gain_min);
-	free(srv->st_wake->kws_gain_min_filter);
-	free(srv->st_wake->kws_gain_max_filter);
-	free(srv->st_wake->kws_gain_buffer);
-	free(srv->st_wake->kws_gain_buffer_sort);
+	dios_ssp_share_free(srv->st_wake->tick_kws_start);
+	dios_ssp_share_free(srv->st_wake->tick_kws_end);
+	dios_ssp_share_free(srv->st_wake->tick_kws_len);
+	dios_ssp_share_free(srv->st_wake->kws_gain);
+	dios_ssp_share_free(srv->st_wake->kws_gain_max);
+	dios_ssp_share_free(srv->st_wake->kws_gain_min);
+	dios_ssp_share_free(srv->st_wake->kws_gain_min_filter);
+	dios_ssp_share_free(srv->st_wake->kws_gain_max_filter);
+	dios_ssp_share_free(srv->st_wake->kws_gain_buffer);
+	dios_ssp_share_free(srv->st_wake->kws_gain_buffer_sort);
 	for (k = 0; k < srv->st_wake->max_kws_word_num; k++) 
     {
-		free(srv->st_wake->each_kws_gain_buffer[k]);
+		dios_ssp_share_free(srv->st_wake->each_kws_gain_buffer[k]);
 	}
-	free(srv->st_wake->each_kws_gain_buffer);
-	free(srv->st_wake);
-	free(srv);
+	dios_ssp_share_free(srv->st_wake->each_kws_gain_buffer);
+	dios_ssp_share_free(srv->st_wake);
+	dios_ssp_share_free(srv);
 	return 0;
 }
 
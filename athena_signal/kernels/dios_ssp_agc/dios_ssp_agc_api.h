@@ -29,11 +29,12 @@ Description:   // init agc module
 Input:         // frame_len: frame length
                   peak_val: agc peak value
                   mode_type: agc mode type 
+                  sample_rate: sampling rate in Hz
 Output:        // none
 Return:        // success: return agc module pointer
                   failure: return NULL
 **********************************************************************************/
-void* dios_ssp_agc_init_api(int frame_len, float peak_val, int mode_type);
+void* dios_ssp_agc_init_api(int frame_len, float peak_val, int mode_type, int sample_rate);
 
 /**********************************************************************************
 Function:      // dios_ssp_agc_reset_api
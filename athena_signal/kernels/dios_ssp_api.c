@@ -25,6 +25,8 @@ de-reverberation will be added soon. We are working on them!
 ==============================================================================*/
 
 #include "dios_ssp_api.h"
+#include "./dios_ssp_share/dios_ssp_share_arena.h"
+#include "./dios_ssp_share/dios_ssp_share_pcm.h"
 
 typedef struct {
     /* handle of each module */
@@ -37,36 +39,262 @@ typedef struct {
     void* ptr_gsc;
     void* ptr_doa;
 
+    /* shared stft of DOA and MVDR, each mic is transformed once per frame */
+    int cfg_stft_len;
+    int cfg_stft_shift;
+    void* ptr_stft_fft;
+    objDOACwin* ptr_stft_win;
+    float* ptr_stft_buf;
+    float* ptr_stft_win_data;
+    float* ptr_stft_fft_out;
+    float* ptr_stft_re;
+    float* ptr_stft_im;
+
     /* necessary buffer definition */
 	float* ptr_mic_buf;
 	float* ptr_ref_buf;
 	float* ptr_data_buf;
 
+    /* re-blocking fifos, only used when the frame length is not a multiple
+       of the block length. the output fifo is primed with cfg_delay zeros */
+    short* ptr_mic_fifo;
+    short* ptr_ref_fifo;
+    short* ptr_out_fifo;
+    int fifo_cap;
+    int in_fifo_len;
+    int out_fifo_len;
+
     /* necessary variables */
-    int cfg_frame_len;
+    int cfg_frame_len;   // samples per call of dios_ssp_process_api
+    int cfg_block_len;   // samples per run of the modules
+    int cfg_sample_rate;
+    int cfg_delay;       // delay added by re-blocking
+    int cfg_interleaved; // 1: input channels are interleaved sample by sample
+    int cfg_dither;      // 1: TPDF dither on the output
+    float cfg_doa_resolution;
+    float cfg_doa_elevation_min;
+    float cfg_doa_elevation_max;
+    objSharePcmDither dither;
     int cfg_mic_num;
     int cfg_ref_num;
     PlaneCoord cfg_mic_coord[16];  // maximum mic num, you can change it
     float cfg_wakeup_loc_phi;
+    float cfg_wakeup_loc_elevation;
+    void* table_pool;    // shared read-only tables, NULL when private
+    objShareArena arena; // memory of the instance, a caller buffer or heap chunks
 
     /* necessary variables */
     int dt_st;
     int vad_result;
     PolarCoord *loc_result;  // save source localization result
+
+    /* per-stage timing */
+    int profile_on;
+    objProfileStage profile[SSP_STAGE_NUM];
 } objDios_ssp;
 
-void* dios_ssp_init_api(objSSP_Param *SSP_PARAM)
+/* the profiler calls fold away when DIOS_SSP_PROFILE_ON is 0, and cost one
+   branch per stage when it is compiled in but switched off */
+static long long dios_ssp_stage_begin(const objDios_ssp *srv)
+{
+    if(DIOS_SSP_PROFILE_ON && srv->profile_on)
+    {
+        return dios_ssp_share_profile_now();
+    }
+    return 0;
+}
+
+static void dios_ssp_stage_end(objDios_ssp *srv, int stage, long long t0)
+{
+    if(DIOS_SSP_PROFILE_ON && srv->profile_on)
+    {
+        dios_ssp_share_profile_add(&srv->profile[stage], dios_ssp_share_profile_now() - t0);
+    }
+}
+
+static const size_t g_stft_win_ptr[] = {
+	offsetof(objDOACwin, m_ana_win), offsetof(objDOACwin, m_norm_win),
+	offsetof(objDOACwin, table_pool)
+};
+
+/* DOA and MVDR use the same analysis window and fft, so when both are enabled
+   the stft is computed here once and handed to both of them */
+static void dios_ssp_stft_init(objDios_ssp *srv)
+{
+    srv->cfg_stft_len = DEFAULT_DOA_WIN_SIZE * srv->cfg_sample_rate / DEFAULT_DOA_SAMPLING_FRQ;
+    srv->cfg_stft_shift = DEFAULT_DOA_SHIFT_SIZE * srv->cfg_sample_rate / DEFAULT_DOA_SAMPLING_FRQ;
+    srv->ptr_stft_fft = dios_ssp_share_rfft_init_pool(srv->cfg_stft_len, srv->table_pool);
+    srv->ptr_stft_win = (objDOACwin*)dios_ssp_share_calloc_map(1, sizeof(objDOACwin), g_stft_win_ptr, SHARE_ARENA_MAP_NUM(g_stft_win_ptr));
+    dios_ssp_doa_win_init(srv->ptr_stft_win, srv->cfg_stft_len, srv->cfg_stft_shift, srv->table_pool);
+    srv->ptr_stft_buf = (float*)dios_ssp_share_calloc(srv->cfg_mic_num * srv->cfg_stft_len, sizeof(float));
+    srv->ptr_stft_win_data = (float*)dios_ssp_share_calloc(srv->cfg_stft_len, sizeof(float));
+    srv->ptr_stft_fft_out = (float*)dios_ssp_share_calloc(srv->cfg_stft_len, sizeof(float));
+    srv->ptr_stft_re = (float*)dios_ssp_share_calloc(srv->cfg_mic_num * srv->cfg_stft_len, sizeof(float));
+    srv->ptr_stft_im = (float*)dios_ssp_share_calloc(srv->cfg_mic_num * srv->cfg_stft_len, sizeof(float));
+}
+
+static void dios_ssp_stft_reset(objDios_ssp *srv)
+{
+    memset(srv->ptr_stft_buf, 0, srv->cfg_mic_num * srv->cfg_stft_len * sizeof(float));
+    memset(srv->ptr_stft_re, 0, srv->cfg_mic_num * srv->cfg_stft_len * sizeof(float));
+    memset(srv->ptr_stft_im, 0, srv->cfg_mic_num * srv->cfg_stft_len * sizeof(float));
+}
+
+static void dios_ssp_stft_process(objDios_ssp *srv)
+{
+    int i, ch_idx;
+    int len = srv->cfg_stft_len;
+    int shift = srv->cfg_stft_shift;
+    for(ch_idx = 0; ch_idx < srv->cfg_mic_num; ch_idx++)
+    {
+        float *buf = srv->ptr_stft_buf + ch_idx * len;
+        float *re = srv->ptr_stft_re + ch_idx * len;
+        float *im = srv->ptr_stft_im + ch_idx * len;
+
+        memcpy(buf + len - shift, srv->ptr_mic_buf + ch_idx * shift, shift * sizeof(float));
+        dios_ssp_doa_win_add_ana_win(srv->ptr_stft_win, buf, srv->ptr_stft_win_data);
+        dios_ssp_share_rfft_process(srv->ptr_stft_fft, srv->ptr_stft_win_data, srv->ptr_stft_fft_out);
+        for(i = 0; i < len / 2 + 1; i++)
+        {
+            re[i] = srv->ptr_stft_fft_out[i];
+        }
+        im[0] = im[len / 2] = 0.0;
+        for(i = 1; i < len / 2; i++)
+        {
+            im[i] = -srv->ptr_stft_fft_out[len - i];
+        }
+        memmove(buf, buf + shift, (len - shift) * sizeof(float));
+    }
+}
+
+static void dios_ssp_stft_uninit(objDios_ssp *srv)
+{
+    dios_ssp_share_rfft_uninit(srv->ptr_stft_fft);
+    dios_ssp_doa_win_delete(srv->ptr_stft_win);
+    dios_ssp_share_free(srv->ptr_stft_win);
+    dios_ssp_share_free(srv->ptr_stft_buf);
+    dios_ssp_share_free(srv->ptr_stft_win_data);
+    dios_ssp_share_free(srv->ptr_stft_fft_out);
+    dios_ssp_share_free(srv->ptr_stft_re);
+    dios_ssp_share_free(srv->ptr_stft_im);
+    srv->ptr_stft_fft = NULL;
+}
+
+/* the input keeps less than one block after each call, so delaying the output
+   by block - gcd(frame, block) samples always leaves a whole frame to return */
+static void dios_ssp_fifo_init(objDios_ssp *srv)
+{
+    int a = srv->cfg_frame_len;
+    int b = srv->cfg_block_len;
+    int t;
+    while(b != 0)
+    {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    srv->cfg_delay = srv->cfg_block_len - a;
+    srv->fifo_cap = srv->cfg_frame_len + srv->cfg_block_len;
+    srv->ptr_mic_fifo = (short*)dios_ssp_share_calloc(srv->cfg_mic_num * srv->fifo_cap, sizeof(short));
+    srv->ptr_ref_fifo = (short*)dios_ssp_share_calloc((srv->cfg_ref_num > 0 ? srv->cfg_ref_num : 1) * srv->fifo_cap, sizeof(short));
+    srv->ptr_out_fifo = (short*)dios_ssp_share_calloc(srv->fifo_cap + srv->cfg_delay, sizeof(short));
+    srv->in_fifo_len = 0;
+    srv->out_fifo_len = srv->cfg_delay;
+}
+
+static void dios_ssp_fifo_reset(objDios_ssp *srv)
+{
+    memset(srv->ptr_out_fifo, 0, (srv->fifo_cap + srv->cfg_delay) * sizeof(short));
+    srv->in_fifo_len = 0;
+    srv->out_fifo_len = srv->cfg_delay;
+}
+
+static void dios_ssp_fifo_uninit(objDios_ssp *srv)
+{
+    dios_ssp_share_free(srv->ptr_mic_fifo);
+    dios_ssp_share_free(srv->ptr_ref_fifo);
+    dios_ssp_share_free(srv->ptr_out_fifo);
+    srv->ptr_mic_fifo = NULL;
+    srv->ptr_ref_fifo = NULL;
+    srv->ptr_out_fifo = NULL;
+}
+
+void* dios_ssp_pool_init_api(void)
+{
+    return dios_ssp_share_table_init();
+}
+
+size_t dios_ssp_pool_bytes_api(void* pool, int* table_num)
+{
+    return dios_ssp_share_table_bytes(pool, table_num);
+}
+
+int dios_ssp_pool_uninit_api(void* pool)
+{
+    if(0 != dios_ssp_share_table_uninit(pool))
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
+    return OK_AUDIO_PROCESS;
+}
+
+static int dios_ssp_uninit(objDios_ssp* srv, objSSP_Param *SSP_PARAM);
+
+static const size_t g_ssp_ptr[] = {
+	offsetof(objDios_ssp, ptr_aec), offsetof(objDios_ssp, ptr_vad),
+	offsetof(objDios_ssp, ptr_hpf), offsetof(objDios_ssp, ptr_ns),
+	offsetof(objDios_ssp, ptr_agc), offsetof(objDios_ssp, ptr_mvdr),
+	offsetof(objDios_ssp, ptr_gsc), offsetof(objDios_ssp, ptr_doa),
+	offsetof(objDios_ssp, ptr_stft_fft), offsetof(objDios_ssp, ptr_stft_win),
+	offsetof(objDios_ssp, ptr_stft_buf), offsetof(objDios_ssp, ptr_stft_win_data),
+	offsetof(objDios_ssp, ptr_stft_fft_out), offsetof(objDios_ssp, ptr_stft_re),
+	offsetof(objDios_ssp, ptr_stft_im), offsetof(objDios_ssp, ptr_mic_buf),
+	offsetof(objDios_ssp, ptr_ref_buf), offsetof(objDios_ssp, ptr_data_buf),
+	offsetof(objDios_ssp, ptr_mic_fifo), offsetof(objDios_ssp, ptr_ref_fifo),
+	offsetof(objDios_ssp, ptr_out_fifo), offsetof(objDios_ssp, table_pool),
+	offsetof(objDios_ssp, loc_result)
+};
+
+static void* dios_ssp_init(objSSP_Param *SSP_PARAM)
 {
     int i;
 	void* ptr = NULL;
-	ptr = (void*)calloc(1, sizeof(objDios_ssp));
+    int sample_rate = SSP_PARAM->sample_rate > 0 ? SSP_PARAM->sample_rate : DIOS_SSP_SAMPLE_RATE;
+    if(SSP_PARAM->frame_len > DIOS_SSP_MAX_FRAME_LEN)
+    {
+        printf("frame length %d is not supported!\n", SSP_PARAM->frame_len);
+        return NULL;
+    }
+    if(sample_rate != 8000 && sample_rate != 16000 && sample_rate != 32000 && sample_rate != 48000)
+    {
+        printf("sample rate %d is not supported!\n", sample_rate);
+        return NULL;
+    }
+	ptr = (void*)dios_ssp_share_calloc_map(1, sizeof(objDios_ssp), g_ssp_ptr, SHARE_ARENA_MAP_NUM(g_ssp_ptr));
+    if(ptr == NULL)
+    {
+        return NULL;
+    }
 	objDios_ssp* srv = (objDios_ssp*)ptr;
+    dios_ssp_share_arena_hole(&srv->arena, sizeof(objShareArena));
     
     // params init
-    srv->cfg_frame_len = 128;
+    srv->cfg_sample_rate = sample_rate;
+    SSP_PARAM->sample_rate = sample_rate;
+    srv->cfg_block_len = DIOS_SSP_BLOCK_LEN * sample_rate / DIOS_SSP_SAMPLE_RATE;
+    srv->cfg_frame_len = SSP_PARAM->frame_len > 0 ? SSP_PARAM->frame_len : srv->cfg_block_len;
+    SSP_PARAM->frame_len = srv->cfg_frame_len;
     srv->cfg_mic_num = SSP_PARAM->mic_num;
     srv->cfg_ref_num = SSP_PARAM->ref_num;;
+    srv->cfg_interleaved = SSP_PARAM->interleaved;
+    srv->cfg_dither = SSP_PARAM->dither;
+    srv->cfg_doa_resolution = SSP_PARAM->doa_resolution;
+    srv->cfg_doa_elevation_min = SSP_PARAM->doa_elevation_min;
+    srv->cfg_doa_elevation_max = SSP_PARAM->doa_elevation_max;
+    dios_ssp_share_pcm_dither_init(&srv->dither, 0);
     srv->cfg_wakeup_loc_phi = SSP_PARAM->loc_phi;
+    srv->table_pool = SSP_PARAM->table_pool;
+    dios_ssp_share_arena_ref(srv->table_pool, 1);
     for(i=0; i<srv->cfg_mic_num; i++)
     {
         srv->cfg_mic_coord[i].x = SSP_PARAM->mic_coord[i].x;
@@ -77,49 +305,153 @@ void* dios_ssp_init_api(objSSP_Param *SSP_PARAM)
     // signal process modules init
     if(SSP_PARAM->HPF_KEY == 1)
     {
-        srv->ptr_hpf = dios_ssp_hpf_init_api();
+        srv->ptr_hpf = dios_ssp_hpf_init_api(srv->cfg_sample_rate);
     }
     if(SSP_PARAM->AEC_KEY == 1)
     {
-        srv->ptr_aec = dios_ssp_aec_init_api(srv->cfg_mic_num, srv->cfg_ref_num, srv->cfg_frame_len);
+        srv->ptr_aec = dios_ssp_aec_multithread_init_api(srv->cfg_mic_num, srv->cfg_ref_num, srv->cfg_block_len, srv->cfg_sample_rate, 1, srv->table_pool);
     }
     if(SSP_PARAM->DOA_KEY == 1)
     {
-        srv->ptr_doa = dios_ssp_doa_init_api(srv->cfg_mic_num, (PlaneCoord*)srv->cfg_mic_coord);
+        srv->ptr_doa = dios_ssp_doa_init_api(srv->cfg_mic_num, (PlaneCoord*)srv->cfg_mic_coord, srv->cfg_sample_rate, 
+            srv->cfg_doa_resolution, srv->cfg_doa_elevation_min, srv->cfg_doa_elevation_max, srv->table_pool);
     }
     if(SSP_PARAM->BF_KEY == 1)
     {
-        srv->ptr_mvdr = dios_ssp_mvdr_init_api(srv->cfg_mic_num, (void*)srv->cfg_mic_coord);
+        srv->ptr_mvdr = dios_ssp_mvdr_init_api(srv->cfg_mic_num, (void*)srv->cfg_mic_coord, srv->cfg_sample_rate, srv->table_pool);
     }
     if(SSP_PARAM->BF_KEY == 2)
     {
-        srv->ptr_gsc = dios_ssp_gsc_init_api(srv->cfg_mic_num, (void*)srv->cfg_mic_coord);
+        srv->ptr_gsc = dios_ssp_gsc_multibeam_init_api(srv->cfg_mic_num, (void*)srv->cfg_mic_coord, 1, 1, srv->cfg_sample_rate, srv->table_pool);
+    }
+    if(SSP_PARAM->DOA_KEY == 1 && SSP_PARAM->BF_KEY == 1
+        && DEFAULT_DOA_WIN_SIZE == DEFAULT_MVDR_WIN_SIZE && DEFAULT_DOA_SHIFT_SIZE == DEFAULT_MVDR_SHIFT_SIZE
+        && DEFAULT_DOA_SAMPLING_FRQ == DEFAULT_MVDR_SAMPLING_FRQ
+        && DEFAULT_DOA_SHIFT_SIZE * srv->cfg_sample_rate / DEFAULT_DOA_SAMPLING_FRQ == srv->cfg_block_len)
+    {
+        dios_ssp_stft_init(srv);
     }
     //dios_ssp_aec_config_api(srv->ptr_aec, 0);  // 0: communication mode; 1: asr mode
-    srv->ptr_vad = dios_ssp_vad_init_api();
+    srv->ptr_vad = dios_ssp_vad_init_api(srv->cfg_sample_rate, srv->table_pool);
     if(SSP_PARAM->NS_KEY == 1)
     {
-        srv->ptr_ns = dios_ssp_ns_init_api(srv->cfg_frame_len);
+        srv->ptr_ns = dios_ssp_ns_init_api(srv->cfg_block_len, srv->cfg_sample_rate, srv->table_pool);
     }
     if(SSP_PARAM->AGC_KEY == 1)
     {
-        srv->ptr_agc = dios_ssp_agc_init_api(srv->cfg_frame_len, 26000.0, 0);
+        srv->ptr_agc = dios_ssp_agc_init_api(srv->cfg_block_len, 26000.0, 0, srv->cfg_sample_rate);
     }
 
     // allocate memory
-    srv->ptr_mic_buf = (float*)calloc(srv->cfg_mic_num * srv->cfg_frame_len, sizeof(float));
-    srv->ptr_ref_buf = (float*)calloc(srv->cfg_ref_num * srv->cfg_frame_len, sizeof(float));
-    srv->ptr_data_buf = (float*)calloc(srv->cfg_frame_len, sizeof(float));
-    srv->loc_result = (PolarCoord*)calloc(1, sizeof(PolarCoord));
+    srv->ptr_mic_buf = (float*)dios_ssp_share_calloc(srv->cfg_mic_num * srv->cfg_block_len, sizeof(float));
+    srv->ptr_ref_buf = (float*)dios_ssp_share_calloc(srv->cfg_ref_num * srv->cfg_block_len, sizeof(float));
+    srv->ptr_data_buf = (float*)dios_ssp_share_calloc(srv->cfg_block_len, sizeof(float));
+    srv->loc_result = (PolarCoord*)dios_ssp_share_calloc(1, sizeof(PolarCoord));
+    if(srv->cfg_frame_len % srv->cfg_block_len != 0)
+    {
+        dios_ssp_fifo_init(srv);
+    }
 
     // variables init 
     srv->dt_st = 1;
     srv->vad_result = 1;
     srv->cfg_wakeup_loc_phi = SSP_PARAM->loc_phi;
+    srv->cfg_wakeup_loc_elevation = SSP_PARAM->loc_elevation;
 
 	return ptr;
 }
 
+/* all memory of an instance is carved from one arena, a caller buffer or heap
+   chunks, so the instance can be saved and loaded as one image */
+static void* dios_ssp_init_arena(objSSP_Param *SSP_PARAM, void* buffer, size_t buffer_size)
+{
+    objShareArena arena;
+    objShareArena *prev;
+    objDios_ssp* srv;
+
+    if(0 != dios_ssp_share_arena_init(&arena, buffer, buffer_size))
+    {
+        return NULL;
+    }
+    prev = dios_ssp_share_arena_bind(&arena);
+    srv = (objDios_ssp*)dios_ssp_init(SSP_PARAM);
+    if(srv != NULL && arena.base != NULL && arena.used > arena.size)
+    {
+        /* blocks past the end came from the heap, free them with the arena bound */
+        printf("buffer of %lu bytes is too small, %lu bytes are needed!\n",
+            (unsigned long)buffer_size, (unsigned long)dios_ssp_share_arena_bytes(&arena));
+        dios_ssp_uninit(srv, SSP_PARAM);
+        srv = NULL;
+    }
+    dios_ssp_share_arena_bind(prev);
+    if(srv == NULL)
+    {
+        dios_ssp_share_arena_release(&arena);
+        return NULL;
+    }
+    srv->arena = arena;
+
+    return (void*)srv;
+}
+
+void* dios_ssp_init_api(objSSP_Param *SSP_PARAM)
+{
+    return dios_ssp_init_arena(SSP_PARAM, NULL, 0);
+}
+
+/* the modules write their tables and state while they carve their blocks, so
+   the size is taken from a real instance on the heap rather than a counting pass */
+size_t dios_ssp_buffer_size_api(objSSP_Param *SSP_PARAM)
+{
+    objDios_ssp* srv = (objDios_ssp*)dios_ssp_init_arena(SSP_PARAM, NULL, 0);
+    size_t bytes;
+
+    if(srv == NULL)
+    {
+        return 0;
+    }
+    bytes = dios_ssp_share_arena_bytes(&srv->arena);
+    dios_ssp_uninit_api(srv, SSP_PARAM);
+
+    return bytes;
+}
+
+void* dios_ssp_init_buffer_api(objSSP_Param *SSP_PARAM, void* buffer, size_t buffer_size)
+{
+    if(buffer == NULL)
+    {
+        return NULL;
+    }
+    return dios_ssp_init_arena(SSP_PARAM, buffer, buffer_size);
+}
+
+size_t dios_ssp_state_size_api(void* ptr)
+{
+    if(ptr == NULL)
+    {
+        return 0;
+    }
+    return dios_ssp_share_arena_state_size(&((objDios_ssp*)ptr)->arena);
+}
+
+int dios_ssp_state_save_api(void* ptr, void* state, size_t state_size)
+{
+    if(ptr == NULL || 0 != dios_ssp_share_arena_state_save(&((objDios_ssp*)ptr)->arena, state, state_size))
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
+    return OK_AUDIO_PROCESS;
+}
+
+int dios_ssp_state_load_api(void* ptr, const void* state, size_t state_size)
+{
+    if(ptr == NULL || 0 != dios_ssp_share_arena_state_load(&((objDios_ssp*)ptr)->arena, state, state_size))
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
+    return OK_AUDIO_PROCESS;
+}
+
 int dios_ssp_reset_api(void* ptr, objSSP_Param *SSP_PARAM)
 {
     if(ptr == NULL)
@@ -133,6 +465,11 @@ int dios_ssp_reset_api(void* ptr, objSSP_Param *SSP_PARAM)
     // variables reset
     srv->dt_st = 1;
     srv->vad_result = 1;
+    dios_ssp_share_pcm_dither_init(&srv->dither, 0);
+    if(srv->ptr_mic_fifo != NULL)
+    {
+        dios_ssp_fifo_reset(srv);
+    }
 
     if(SSP_PARAM->HPF_KEY == 1)
     {
@@ -170,6 +507,11 @@ int dios_ssp_reset_api(void* ptr, objSSP_Param *SSP_PARAM)
         }
     }
 
+    if(srv->ptr_stft_fft != NULL)
+    {
+        dios_ssp_stft_reset(srv);
+    }
+
     if(SSP_PARAM->BF_KEY == 2)
     {
         ret = dios_ssp_gsc_reset_api(srv->ptr_gsc);
@@ -206,33 +548,25 @@ int dios_ssp_reset_api(void* ptr, objSSP_Param *SSP_PARAM)
 	return 0;
 }
 
-int dios_ssp_process_api(void* ptr, short* mic_buf, short* ref_buf, short* out_buf, objSSP_Param *SSP_PARAM)
+/* run all modules on one block, channel i of mic and ref starts at i * stride
+   and its samples are step apart */
+static int dios_ssp_process_block(objDios_ssp* srv, const short* mic_buf, int mic_stride, int mic_step, 
+            const short* ref_buf, int ref_stride, int ref_step, short* out_buf, objSSP_Param *SSP_PARAM)
 {
-    if(ptr == NULL)
-    {
-        return ERROR_AUDIO_PROCESS;
-    }
-
-    objDios_ssp* srv = (objDios_ssp*)ptr;
     int ret;
-    int i, j;
+    int i;
+    long long t0;
    
     // get input data, single-channel or multi-channel, with or without reference
     for(i = 0; i < srv->cfg_mic_num; i++)
     {
-        for(j = 0; j < srv->cfg_frame_len; j++)
-        {
-            srv->ptr_mic_buf[i * srv->cfg_frame_len + j] = (float)(mic_buf[i * srv->cfg_frame_len + j]);
-        }
+        dios_ssp_share_pcm_to_float(mic_buf + i * mic_stride, mic_step, srv->ptr_mic_buf + i * srv->cfg_block_len, srv->cfg_block_len);
     }
     if(ref_buf != NULL)
     {
         for(i = 0; i < srv->cfg_ref_num; i++)
         {
-            for(j = 0; j < srv->cfg_frame_len; j++)
-            {
-                srv->ptr_ref_buf[i * srv->cfg_frame_len + j] = (float)(ref_buf[i * srv->cfg_frame_len + j]);
-            }
+            dios_ssp_share_pcm_to_float(ref_buf + i * ref_stride, ref_step, srv->ptr_ref_buf + i * srv->cfg_block_len, srv->cfg_block_len);
         }
     }
 
@@ -240,88 +574,214 @@ int dios_ssp_process_api(void* ptr, short* mic_buf, short* ref_buf, short* out_b
     // hpf process
     if(SSP_PARAM->HPF_KEY == 1)
     {
-        ret = dios_ssp_hpf_process_api(srv->ptr_hpf, srv->ptr_mic_buf, srv->cfg_frame_len);
+        t0 = dios_ssp_stage_begin(srv);
+        ret = dios_ssp_hpf_process_api(srv->ptr_hpf, srv->ptr_mic_buf, srv->cfg_block_len);
         if(ret != 0)
         {
             return ERROR_HPF;
         }
+        dios_ssp_stage_end(srv, SSP_STAGE_HPF, t0);
     }
 
     // aec process
     if(ref_buf != NULL && SSP_PARAM->AEC_KEY == 1)
     {
-
+        t0 = dios_ssp_stage_begin(srv);
         ret = dios_ssp_aec_process_api(srv->ptr_aec, srv->ptr_mic_buf, srv->ptr_ref_buf, &srv->dt_st);
         if(ret != 0)
         {
             return ERROR_AEC;
         }
+        dios_ssp_stage_end(srv, SSP_STAGE_AEC, t0);
     }
 
     // save mic1
-    memcpy(srv->ptr_data_buf, &srv->ptr_mic_buf[0], srv->cfg_frame_len * sizeof(float));
+    memcpy(srv->ptr_data_buf, &srv->ptr_mic_buf[0], srv->cfg_block_len * sizeof(float));
 
-    if(SSP_PARAM->DOA_KEY == 1)
+    if(srv->ptr_stft_fft != NULL && SSP_PARAM->DOA_KEY == 1 && SSP_PARAM->BF_KEY == 1)
     {
-        srv->cfg_wakeup_loc_phi = dios_ssp_doa_process_api(srv->ptr_doa, srv->ptr_mic_buf, srv->vad_result, srv->dt_st);
-    }
-    
-    // MVDR process
-    if(SSP_PARAM->BF_KEY == 1)
-    {
-        ret = dios_ssp_mvdr_process_api(srv->ptr_mvdr, srv->ptr_mic_buf, srv->ptr_data_buf, srv->cfg_wakeup_loc_phi);
+        // DOA + MVDR process on the shared stft
+        t0 = dios_ssp_stage_begin(srv);
+        dios_ssp_stft_process(srv);
+        srv->cfg_wakeup_loc_phi = dios_ssp_doa_process_spectrum_api(srv->ptr_doa, srv->ptr_stft_re, srv->ptr_stft_im, srv->vad_result, srv->dt_st);
+        srv->cfg_wakeup_loc_elevation = dios_ssp_doa_elevation_get(srv->ptr_doa);
+        dios_ssp_stage_end(srv, SSP_STAGE_DOA, t0);
+        t0 = dios_ssp_stage_begin(srv);
+        ret = dios_ssp_mvdr_process_spectrum_api(srv->ptr_mvdr, srv->ptr_stft_re, srv->ptr_stft_im, srv->ptr_data_buf, 
+            srv->cfg_wakeup_loc_phi, srv->cfg_wakeup_loc_elevation);
         if(ret != 0)
         {
             return ERROR_MVDR;
         }
+        dios_ssp_stage_end(srv, SSP_STAGE_BF, t0);
+    }
+    else
+    {
+        if(SSP_PARAM->DOA_KEY == 1)
+        {
+            t0 = dios_ssp_stage_begin(srv);
+            srv->cfg_wakeup_loc_phi = dios_ssp_doa_process_api(srv->ptr_doa, srv->ptr_mic_buf, srv->vad_result, srv->dt_st);
+            srv->cfg_wakeup_loc_elevation = dios_ssp_doa_elevation_get(srv->ptr_doa);
+            dios_ssp_stage_end(srv, SSP_STAGE_DOA, t0);
+        }
+        
+        // MVDR process
+        if(SSP_PARAM->BF_KEY == 1)
+        {
+            t0 = dios_ssp_stage_begin(srv);
+            ret = dios_ssp_mvdr_process_api(srv->ptr_mvdr, srv->ptr_mic_buf, srv->ptr_data_buf, srv->cfg_wakeup_loc_phi, 
+                srv->cfg_wakeup_loc_elevation);
+            if(ret != 0)
+            {
+                return ERROR_MVDR;
+            }
+            dios_ssp_stage_end(srv, SSP_STAGE_BF, t0);
+        }
     }
 
     //GSC process
     if(SSP_PARAM->BF_KEY == 2)
     {
+        t0 = dios_ssp_stage_begin(srv);
         ret = dios_ssp_gsc_process_api(srv->ptr_gsc, srv->ptr_mic_buf, srv->ptr_data_buf, srv->cfg_wakeup_loc_phi);
         if(ret != 0)
         {
             return ERROR_GSC;
         }
+        dios_ssp_stage_end(srv, SSP_STAGE_BF, t0);
     }
     
     // vad process
+    t0 = dios_ssp_stage_begin(srv);
     ret = dios_ssp_vad_process_api(srv->ptr_vad, srv->ptr_data_buf, srv->dt_st);
     if(ret != 0)
     {
         return ERROR_VAD;
     }
     srv->vad_result = dios_ssp_vad_result_get(srv->ptr_vad);
+    dios_ssp_stage_end(srv, SSP_STAGE_VAD, t0);
 
     // ns process
     if(SSP_PARAM->NS_KEY == 1)
     {
+        t0 = dios_ssp_stage_begin(srv);
         ret = dios_ssp_ns_process(srv->ptr_ns, srv->ptr_data_buf);
         if(ret != 0)
         {
             return ERROR_NS;
         }
+        dios_ssp_stage_end(srv, SSP_STAGE_NS, t0);
     }
 
     // agc process
     if(SSP_PARAM->AGC_KEY == 1)
     {
+        t0 = dios_ssp_stage_begin(srv);
         ret = dios_ssp_agc_process_api(srv->ptr_agc, srv->ptr_data_buf, srv->vad_result, 1, srv->dt_st);
         if(ret != 0)
         {
             return ERROR_AGC;
         }
+        dios_ssp_stage_end(srv, SSP_STAGE_AGC, t0);
     }
     // end of wakeup signal process
 
-    // get output data for wakeup
-    for(j = 0; j < srv->cfg_frame_len; j++)
+    // get output data for wakeup, clipped so that loud output does not wrap around
+    dios_ssp_share_pcm_from_float(srv->ptr_data_buf, out_buf, srv->cfg_block_len, srv->cfg_dither ? &srv->dither : NULL);
+
+    return 0;
+}
+
+/* append len samples of ch_num channels to a fifo with channel i at i * cap */
+static void dios_ssp_fifo_push(short* fifo, int cap, int fifo_len, const short* buf, int ch_num, int len, int interleaved)
+{
+    int i, j;
+    for(i = 0; i < ch_num; i++)
     {
-        out_buf[j] = (short)(srv->ptr_data_buf[j]);
+        if(buf == NULL)
+        {
+            memset(fifo + i * cap + fifo_len, 0, len * sizeof(short));
+        }
+        else if(interleaved)
+        {
+            for(j = 0; j < len; j++)
+            {
+                fifo[i * cap + fifo_len + j] = buf[j * ch_num + i];
+            }
+        }
+        else
+        {
+            memcpy(fifo + i * cap + fifo_len, buf + i * len, len * sizeof(short));
+        }
     }
+}
 
-    return 0;
+int dios_ssp_process_api(void* ptr, short* mic_buf, short* ref_buf, short* out_buf, objSSP_Param *SSP_PARAM)
+{
+    if(ptr == NULL)
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
+
+    objDios_ssp* srv = (objDios_ssp*)ptr;
+    int ret = 0;
+    int err = 0;
+    int i, pos;
+    int len = srv->cfg_frame_len;
+    int block = srv->cfg_block_len;
+    int cap = srv->fifo_cap;
+    int mic_step = srv->cfg_interleaved ? srv->cfg_mic_num : 1;
+    int ref_step = srv->cfg_interleaved ? srv->cfg_ref_num : 1;
+
+    if(srv->ptr_mic_fifo == NULL)
+    {
+        // whole blocks, processed straight from the caller's buffers
+        for(pos = 0; pos < len; pos += block)
+        {
+            ret = dios_ssp_process_block(srv, mic_buf + pos * mic_step, srv->cfg_interleaved ? 1 : len, mic_step, 
+                ref_buf == NULL ? NULL : ref_buf + pos * ref_step, srv->cfg_interleaved ? 1 : len, ref_step, 
+                out_buf + pos, SSP_PARAM);
+            if(ret != 0)
+            {
+                return ret;
+            }
+        }
+        return OK_AUDIO_PROCESS;
+    }
+
+    dios_ssp_fifo_push(srv->ptr_mic_fifo, cap, srv->in_fifo_len, mic_buf, srv->cfg_mic_num, len, srv->cfg_interleaved);
+    dios_ssp_fifo_push(srv->ptr_ref_fifo, cap, srv->in_fifo_len, ref_buf, srv->cfg_ref_num, len, srv->cfg_interleaved);
+    srv->in_fifo_len += len;
+
+    // a failed block is output as silence so that the stream stays aligned
+    for(pos = 0; pos + block <= srv->in_fifo_len; pos += block)
+    {
+        ret = dios_ssp_process_block(srv, srv->ptr_mic_fifo + pos, cap, 1, ref_buf == NULL ? NULL : srv->ptr_ref_fifo + pos, cap, 1, 
+            srv->ptr_out_fifo + srv->out_fifo_len, SSP_PARAM);
+        if(ret != 0)
+        {
+            memset(srv->ptr_out_fifo + srv->out_fifo_len, 0, block * sizeof(short));
+            err = (err == 0) ? ret : err;
+        }
+        srv->out_fifo_len += block;
+    }
+
+    srv->in_fifo_len -= pos;
+    for(i = 0; i < srv->cfg_mic_num; i++)
+    {
+        memmove(srv->ptr_mic_fifo + i * cap, srv->ptr_mic_fifo + i * cap + pos, srv->in_fifo_len * sizeof(short));
+    }
+    for(i = 0; i < srv->cfg_ref_num; i++)
+    {
+        memmove(srv->ptr_ref_fifo + i * cap, srv->ptr_ref_fifo + i * cap + pos, srv->in_fifo_len * sizeof(short));
+    }
+
+    // the delay guarantees at least one frame of output here
+    memcpy(out_buf, srv->ptr_out_fifo, len * sizeof(short));
+    srv->out_fifo_len -= len;
+    memmove(srv->ptr_out_fifo, srv->ptr_out_fifo + len, srv->out_fifo_len * sizeof(short));
+
+    return err;
 }
 
 float dios_ssp_doa_result_get_api(void* ptr, objSSP_Param *SSP_PARAM)
@@ -338,6 +798,34 @@ float dios_ssp_doa_result_get_api(void* ptr, objSSP_Param *SSP_PARAM)
     return srv->cfg_wakeup_loc_phi;
 }
 
+float dios_ssp_doa_elevation_get_api(void* ptr, objSSP_Param *SSP_PARAM)
+{
+    if(ptr == NULL) {
+        return ERROR_DOA;
+    }
+
+    if(SSP_PARAM->DOA_KEY != 1) {
+        return ERROR_DOA;
+    }
+
+    objDios_ssp* srv = (objDios_ssp*)ptr;
+    return srv->cfg_wakeup_loc_elevation;
+}
+
+int dios_ssp_doa_source_get_api(void* ptr, objSSP_Param *SSP_PARAM, DoaSource* source, int max_num)
+{
+    if(ptr == NULL || source == NULL) {
+        return ERROR_DOA;
+    }
+
+    if(SSP_PARAM->DOA_KEY != 1) {
+        return ERROR_DOA;
+    }
+
+    objDios_ssp* srv = (objDios_ssp*)ptr;
+    return dios_ssp_doa_source_get(srv->ptr_doa, source, max_num);
+}
+
 int dios_ssp_vad_result_get_api(void* ptr, objSSP_Param *SSP_PARAM)
 {
     if(ptr == NULL) {
@@ -348,8 +836,18 @@ int dios_ssp_vad_result_get_api(void* ptr, objSSP_Param *SSP_PARAM)
     return srv->vad_result;
 }
 
+int dios_ssp_frame_len_get_api(void* ptr)
+{
+    if(ptr == NULL)
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
 
-int dios_ssp_uninit_api(void* ptr, objSSP_Param *SSP_PARAM)
+    objDios_ssp* srv = (objDios_ssp*)ptr;
+    return srv->cfg_frame_len;
+}
+
+int dios_ssp_delay_get_api(void* ptr)
 {
     if(ptr == NULL)
     {
@@ -357,24 +855,86 @@ int dios_ssp_uninit_api(void* ptr, objSSP_Param *SSP_PARAM)
     }
 
     objDios_ssp* srv = (objDios_ssp*)ptr;
+    return srv->cfg_delay;
+}
+
+int dios_ssp_profile_enable_api(void* ptr, int enable)
+{
+    if(ptr == NULL)
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
+
+    objDios_ssp* srv = (objDios_ssp*)ptr;
+    srv->profile_on = (DIOS_SSP_PROFILE_ON && enable) ? 1 : 0;
+    return OK_AUDIO_PROCESS;
+}
+
+int dios_ssp_profile_get_api(void* ptr, int stage, objSSP_StageStat *stat)
+{
+    if(ptr == NULL || stat == NULL || stage < 0 || stage >= SSP_STAGE_NUM)
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
+
+    objDios_ssp* srv = (objDios_ssp*)ptr;
+    const objProfileStage *prof = &srv->profile[stage];
+    memset(stat, 0, sizeof(objSSP_StageStat));
+    if(prof->count > 0)
+    {
+        stat->count = prof->count;
+        stat->min_ns = prof->min_ns;
+        stat->mean_ns = prof->sum_ns / (long long)prof->count;
+        stat->max_ns = prof->max_ns;
+        stat->p99_ns = dios_ssp_share_profile_percentile(prof, 99);
+    }
+    return OK_AUDIO_PROCESS;
+}
+
+int dios_ssp_profile_reset_api(void* ptr)
+{
+    if(ptr == NULL)
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
+
+    objDios_ssp* srv = (objDios_ssp*)ptr;
+    int i;
+    for(i = 0; i < SSP_STAGE_NUM; i++)
+    {
+        dios_ssp_share_profile_reset(&srv->profile[i]);
+    }
+    return OK_AUDIO_PROCESS;
+}
+
+static int dios_ssp_uninit(objDios_ssp* srv, objSSP_Param *SSP_PARAM)
+{
     int ret;
 
     /* free memory */
     if(srv->ptr_mic_buf != NULL)
     {
-        free(srv->ptr_mic_buf);
+        dios_ssp_share_free(srv->ptr_mic_buf);
         srv->ptr_mic_buf = NULL;
     }
     if(srv->ptr_ref_buf != NULL)
     {
-        free(srv->ptr_ref_buf);
+        dios_ssp_share_free(srv->ptr_ref_buf);
         srv->ptr_ref_buf = NULL;
     }
     if(srv->ptr_data_buf != NULL)
     {
-        free(srv->ptr_data_buf);
+        dios_ssp_share_free(srv->ptr_data_buf);
         srv->ptr_data_buf = NULL;
     }
+    if(srv->ptr_stft_fft != NULL)
+    {
+        dios_ssp_stft_uninit(srv);
+    }
+    if(srv->ptr_mic_fifo != NULL)
+    {
+        dios_ssp_fifo_uninit(srv);
+    }
 
     if(SSP_PARAM->HPF_KEY == 1)
     {
@@ -445,8 +1005,29 @@ int dios_ssp_uninit_api(void* ptr, objSSP_Param *SSP_PARAM)
         }
     }
 
-    free(srv->loc_result);
-    free(srv);
+    dios_ssp_share_free(srv->loc_result);
+    dios_ssp_share_free(srv);
 	return OK_AUDIO_PROCESS;
 }
 
+int dios_ssp_uninit_api(void* ptr, objSSP_Param *SSP_PARAM)
+{
+    if(ptr == NULL)
+    {
+        return ERROR_AUDIO_PROCESS;
+    }
+
+    objDios_ssp* srv = (objDios_ssp*)ptr;
+    objShareArena arena = srv->arena;  // srv goes with the arena
+    objShareArena *prev;
+    int ret;
+
+    /* heap chunks are freed here, a caller buffer is left to the caller */
+    prev = dios_ssp_share_arena_bind(&arena);
+    ret = dios_ssp_uninit(srv, SSP_PARAM);
+    dios_ssp_share_arena_bind(prev);
+    dios_ssp_share_arena_release(&arena);
+
+    return ret;
+}
+
@@ -32,6 +32,21 @@ extern "C" {
 #include "./dios_ssp_mvdr/dios_ssp_mvdr_api.h"
 #include "./dios_ssp_doa/dios_ssp_doa_api.h"
 #include "./dios_ssp_gsc/dios_ssp_gsc_api.h"
+#include "./dios_ssp_share/dios_ssp_share_profile.h"
+#include "./dios_ssp_share/dios_ssp_share_table.h"
+
+/* per-stage timing of dios_ssp_process_api, 1: compiled in, 0: compiled out.
+   when compiled in it still has to be switched on by dios_ssp_profile_enable_api */
+#ifndef DIOS_SSP_PROFILE_ON
+#define DIOS_SSP_PROFILE_ON (1)
+#endif
+
+/* all modules run on 8ms blocks, DIOS_SSP_BLOCK_LEN samples at DIOS_SSP_SAMPLE_RATE
+   and sample_rate / 125 in general, other frame lengths are re-blocked inside
+   dios_ssp_process_api. supported rates are 8000, 16000, 32000 and 48000 */
+#define DIOS_SSP_SAMPLE_RATE (16000)
+#define DIOS_SSP_BLOCK_LEN (128)
+#define DIOS_SSP_MAX_FRAME_LEN (8192)
 
 typedef struct
 {
@@ -46,18 +61,158 @@ typedef struct
     int ref_num;
     PlaneCoord mic_coord[16];
     float loc_phi;
+    int frame_len;  // samples per channel of one dios_ssp_process_api call, 0 for
+                    // one block, set to the length in use by dios_ssp_init_api
+    int sample_rate;  // in Hz, 0 for DIOS_SSP_SAMPLE_RATE, set to the rate in use by
+                      // dios_ssp_init_api
+    void* table_pool; // from dios_ssp_pool_init_api, read-only tables such as fft
+                      // twiddles, windows and steering vectors are shared with the
+                      // other instances of the pool. NULL keeps them private
+    int interleaved;  // 0: mic_buf and ref_buf hold frame_len samples of each channel
+                      // one after another, 1: they hold the channels sample by sample
+    int dither;       // 0: the output is truncated, 1: TPDF dither of +/-1 LSB is added
+                      // and the output rounded. it is clipped to the int16 range either way
+    float doa_resolution; // degrees, grid of the DOA search, 0 for DEFAULT_DOA_RESOLUTION
+    float doa_elevation_min; // degrees above the x-y plane of mic_coord, -90 ~ 90, range of
+    float doa_elevation_max; // the DOA search. both 0 for azimuth only
+    float loc_elevation;  // degrees above the x-y plane of mic_coord, elevation of loc_phi for MVDR
 } objSSP_Param;
 
+/* stages timed by the profiler, DOA includes the stft shared with MVDR */
+typedef enum
+{
+    SSP_STAGE_HPF,
+    SSP_STAGE_AEC,
+    SSP_STAGE_DOA,
+    SSP_STAGE_BF,
+    SSP_STAGE_VAD,
+    SSP_STAGE_NS,
+    SSP_STAGE_AGC,
+    SSP_STAGE_NUM
+} SSP_STAGE;
+
+typedef struct
+{
+    unsigned long count;    // number of timed frames
+    long long min_ns;
+    long long mean_ns;
+    long long max_ns;
+    long long p99_ns;       // from a log histogram, at most 12.5% above the true value
+} objSSP_StageStat;
+
 /**********************************************************************************
-Function:      // dios_ssp_init_api
-Description:   // init with SSP_PARAM and allocate memory
-Input:         // SSP_PARAM: object of SSP with necessary parameters
+Function:      // dios_ssp_pool_init_api
+Description:   // create a pool of read-only tables for instances running side by
+                  side, e.g. one per call or per user. each table is built by the
+                  first instance needing it, the others only keep their own state
+Input:         // none
 Output:        // none
+Return:        // success: return table pool pointer
+                  failure: return NULL
+**********************************************************************************/
+void* dios_ssp_pool_init_api(void);
+
+/**********************************************************************************
+Function:      // dios_ssp_pool_bytes_api
+Description:   // memory held by the shared tables of a pool
+Input:         // pool: table pool pointer
+Output:        // table_num: number of tables, may be NULL
+Return:        // bytes of all tables
+**********************************************************************************/
+size_t dios_ssp_pool_bytes_api(void* pool, int* table_num);
+
+/**********************************************************************************
+Function:      // dios_ssp_pool_uninit_api
+Description:   // free a table pool, every instance using it must be uninit first
+Input:         // pool: table pool pointer
+Output:        // none
+Return:        // success: return OK_AUDIO_PROCESS, failure: return ERROR_AUDIO_PROCESS
+**********************************************************************************/
+int dios_ssp_pool_uninit_api(void* pool);
+
+/**********************************************************************************
+Function:      // dios_ssp_init_api
+Description:   // init with SSP_PARAM and allocate memory. a frame_len that is a
+                  multiple of the block length (sample_rate / 125) adds no latency,
+                  any other length up to DIOS_SSP_MAX_FRAME_LEN is re-blocked with
+                  the delay reported by dios_ssp_delay_get_api
+Input:         // SSP_PARAM: object of SSP with necessary parameters, the instance
+                  uses SSP_PARAM->table_pool until dios_ssp_uninit_api
+Output:        // SSP_PARAM->frame_len: frame length in use
+                  SSP_PARAM->sample_rate: sampling rate in use
 Return:        // success: return dios speech signal process pointer
                   failure: return NULL
 **********************************************************************************/
 void* dios_ssp_init_api(objSSP_Param *SSP_PARAM);
 
+/**********************************************************************************
+Function:      // dios_ssp_buffer_size_api
+Description:   // bytes of the buffer dios_ssp_init_buffer_api needs for SSP_PARAM,
+                  found by one init and uninit on the heap. tables shared through
+                  SSP_PARAM->table_pool are not part of it.
+                  the query allocates and costs as much as dios_ssp_init_api, so
+                  run it on the host, e.g. once at build or startup time, and keep
+                  the size for every buffer of the same SSP_PARAM
+Input:         // SSP_PARAM: object of SSP with necessary parameters
+Output:        // SSP_PARAM->frame_len, SSP_PARAM->sample_rate: as dios_ssp_init_api
+Return:        // success: return buffer size in bytes
+                  failure: return 0
+**********************************************************************************/
+size_t dios_ssp_buffer_size_api(objSSP_Param *SSP_PARAM);
+
+/**********************************************************************************
+Function:      // dios_ssp_init_buffer_api
+Description:   // init like dios_ssp_init_api, with all memory of the instance
+                  carved from a caller-owned buffer on 64-byte boundaries instead
+                  of the heap. neither dios_ssp_process_api nor dios_ssp_reset_api
+                  allocate memory. the buffer must stay untouched until
+                  dios_ssp_uninit_api and is then released by the caller
+Input:         // SSP_PARAM: object of SSP with necessary parameters
+                  buffer: memory of the instance, any alignment
+                  buffer_size: at least dios_ssp_buffer_size_api(SSP_PARAM) bytes
+Output:        // SSP_PARAM->frame_len, SSP_PARAM->sample_rate: as dios_ssp_init_api
+Return:        // success: return dios speech signal process pointer
+                  failure: return NULL, also if the buffer is too small
+**********************************************************************************/
+void* dios_ssp_init_buffer_api(objSSP_Param *SSP_PARAM, void* buffer, size_t buffer_size);
+
+/**********************************************************************************
+Function:      // dios_ssp_state_size_api
+Description:   // bytes of the state of an instance, e.g. to move a running call
+                  to another instance without converging again
+Input:         // ptr: dios speech signal process pointer
+Output:        // none
+Return:        // success: return state size in bytes, failure: return 0
+**********************************************************************************/
+size_t dios_ssp_state_size_api(void* ptr);
+
+/**********************************************************************************
+Function:      // dios_ssp_state_save_api
+Description:   // save everything the output depends on: filters, histories,
+                  noise estimates, gains. call it between two frames
+Input:         // ptr: dios speech signal process pointer
+                  state_size: at least dios_ssp_state_size_api(ptr) bytes
+Output:        // state: saved state, versioned
+Return:        // success: return OK_AUDIO_PROCESS, failure: return ERROR_AUDIO_PROCESS
+**********************************************************************************/
+int dios_ssp_state_save_api(void* ptr, void* state, size_t state_size);
+
+/**********************************************************************************
+Function:      // dios_ssp_state_load_api
+Description:   // load a saved state, the output of the following frames is the
+                  same as that of the saved instance. the instance must be set up
+                  with the same SSP_PARAM (table pools may differ) by the same
+                  build of the library, on a machine with the same word size
+                  and byte order
+Input:         // ptr: dios speech signal process pointer
+                  state: state from dios_ssp_state_save_api
+                  state_size: bytes of state
+Output:        // none
+Return:        // success: return OK_AUDIO_PROCESS, failure: return ERROR_AUDIO_PROCESS
+                  if the state is from another version or configuration
+**********************************************************************************/
+int dios_ssp_state_load_api(void* ptr, const void* state, size_t state_size);
+
 /**********************************************************************************
 Function:      // dios_ssp_reset_api
 Description:   // reset dios speech signal process module
@@ -72,12 +227,15 @@ int dios_ssp_reset_api(void* ptr, objSSP_Param *SSP_PARAM);
 Function:      // dios_ssp_process_api
 Description:   // run dios speech signal process module by frames
 Input:         // ptr: dios speech signal process pointer
-                  mic_buf: microphone array data buffer
+                  mic_buf: microphone array data buffer, frame_len samples of
+                           each mic one after another, or frame_len samples of
+                           all mics when SSP_PARAM->interleaved is 1
                   ref_buf: reference data buffer
-                           for mono-channel, the length of ref_buf is 128
-                           for stereo-channel, the length of ref_buf is 128 * 2,
-                           [0 ~ 127] is from left channel
-                           [128 ~ 255] is from right channel
+                           for mono-channel, the length of ref_buf is frame_len
+                           for stereo-channel, the length of ref_buf is frame_len * 2,
+                           [0 ~ frame_len-1] is from left channel
+                           [frame_len ~ 2*frame_len-1] is from right channel,
+                           or left and right by turns when interleaved
                   SSP_PARAM:
 Output:        // out_buf: processed data
 Return:        // success: return OK_AUDIO_PROCESS, failure: return others
@@ -95,6 +253,32 @@ Return:        // success: return DOA float angle value, failure: return ERROR_D
 **********************************************************************************/
 float dios_ssp_doa_result_get_api(void* ptr, objSSP_Param *SSP_PARAM);
 
+/**********************************************************************************
+Function:      // dios_ssp_doa_elevation_get_api
+Description:   // get the elevation of the DOA result on processed frames
+Input:         // ptr: dios speech signal process pointer
+                  SSP_PARAM:
+Output:        // none
+Return:        // success: return DOA elevation in degrees, 0 unless doa_elevation_min
+                  and doa_elevation_max give a range, failure: return ERROR_DOA
+**********************************************************************************/
+float dios_ssp_doa_elevation_get_api(void* ptr, objSSP_Param *SSP_PARAM);
+
+/**********************************************************************************
+Function:      // dios_ssp_doa_source_get_api
+Description:   // get the sound sources tracked by DOA on processed frames, up to
+                  DEFAULT_DOA_MAX_SOURCE_NUM talkers. they are updated on every
+                  frame, the vad is not needed
+Input:         // ptr: dios speech signal process pointer
+                  SSP_PARAM:
+                  max_num: size of source
+Output:        // source: direction, elevation, confidence and id of the sources, most
+                  confident first. a source keeps its id while it is tracked
+Return:        // success: return number of sources, at most
+                  DEFAULT_DOA_MAX_SOURCE_NUM, failure: return ERROR_DOA
+**********************************************************************************/
+int dios_ssp_doa_source_get_api(void* ptr, objSSP_Param *SSP_PARAM, DoaSource* source, int max_num);
+
 /**********************************************************************************
 Function:      // dios_ssp_vad_result_get_api
 Description:   // get VAD result on processed frames
@@ -105,6 +289,57 @@ Return:        // success: return VAD status value, failure: return ERROR_VAD
 **********************************************************************************/
 int dios_ssp_vad_result_get_api(void* ptr, objSSP_Param *SSP_PARAM);
 
+/**********************************************************************************
+Function:      // dios_ssp_frame_len_get_api
+Description:   // get the frame length of dios_ssp_process_api
+Input:         // ptr: dios speech signal process pointer
+Output:        // none
+Return:        // success: return frame length, failure: return ERROR_AUDIO_PROCESS
+**********************************************************************************/
+int dios_ssp_frame_len_get_api(void* ptr);
+
+/**********************************************************************************
+Function:      // dios_ssp_delay_get_api
+Description:   // get the delay added by re-blocking, 0 if the frame length is a
+                  multiple of DIOS_SSP_BLOCK_LEN, otherwise
+                  DIOS_SSP_BLOCK_LEN - gcd(frame_len, DIOS_SSP_BLOCK_LEN) samples
+Input:         // ptr: dios speech signal process pointer
+Output:        // none
+Return:        // success: return delay in samples, failure: return ERROR_AUDIO_PROCESS
+**********************************************************************************/
+int dios_ssp_delay_get_api(void* ptr);
+
+/**********************************************************************************
+Function:      // dios_ssp_profile_enable_api
+Description:   // switch per-stage timing of dios_ssp_process_api on or off, it is
+                  off after init. does nothing if built with DIOS_SSP_PROFILE_ON 0
+Input:         // ptr: dios speech signal process pointer
+                  enable: 1 on, 0 off
+Output:        // none
+Return:        // success: return OK_AUDIO_PROCESS, failure: return others
+**********************************************************************************/
+int dios_ssp_profile_enable_api(void* ptr, int enable);
+
+/**********************************************************************************
+Function:      // dios_ssp_profile_get_api
+Description:   // get running min/mean/max/p99 processing time of one stage
+Input:         // ptr: dios speech signal process pointer
+                  stage: one of SSP_STAGE
+Output:        // stat: statistics since init or the last reset, all zero if
+                        the stage did not run
+Return:        // success: return OK_AUDIO_PROCESS, failure: return others
+**********************************************************************************/
+int dios_ssp_profile_get_api(void* ptr, int stage, objSSP_StageStat *stat);
+
+/**********************************************************************************
+Function:      // dios_ssp_profile_reset_api
+Description:   // clear the timing statistics of all stages
+Input:         // ptr: dios speech signal process pointer
+Output:        // none
+Return:        // success: return OK_AUDIO_PROCESS, failure: return others
+**********************************************************************************/
+int dios_ssp_profile_reset_api(void* ptr);
+
 /**********************************************************************************
 Function:      // dios_ssp_uninit_api
 Description:   // free dios speech signal process module
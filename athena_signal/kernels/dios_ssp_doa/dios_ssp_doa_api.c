@@ -17,27 +17,31 @@ Description: This is a DOA (Direction Of Arrival) module which uses the Capon
 algorithm to get the direction of the sound source. The main function of the 
 Capon algorithm is the Capon beamformer, also called MVDR. The Capon spectrum 
 is estimated by using Rxx matrix and steering vector in frequency domain.
+Only the band around the Capon bins (2k ~ 6kHz by default) is analysed, the
+Rxx update, the smoothing and the steering vectors cover just these bins.
 ==============================================================================*/
 
 #include "dios_ssp_doa_api.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
-int dios_ssp_doa_cal_rxx(objDOA *ptr_doa)
+int dios_ssp_doa_cal_rxx(objDOA *ptr_doa, const float *re, const float *im)
 {
 	float rxx_re = 0, rxx_im = 0;
+	int b = ptr_doa->m_band_lo;
 	if ( ptr_doa->m_first_frame_flag == 1 )
 	{
 		ptr_doa->m_first_frame_flag = 0;
-		for ( int k = 0; k < ptr_doa->m_sp_size; ++k )
+		for ( int k = 0; k < ptr_doa->m_band_len; ++k )
 		{
 			for ( int i = 0; i < ptr_doa->m_channels; ++i )
 			{
-				rxx_re = ptr_doa->m_re[i*ptr_doa->m_fft_size+k]*ptr_doa->m_re[i*ptr_doa->m_fft_size+k] + ptr_doa->m_im[i*ptr_doa->m_fft_size+k]*ptr_doa->m_im[i*ptr_doa->m_fft_size+k] + ptr_doa->m_eps;
+				rxx_re = re[b+i*ptr_doa->m_fft_size+k]*re[b+i*ptr_doa->m_fft_size+k] + im[b+i*ptr_doa->m_fft_size+k]*im[b+i*ptr_doa->m_fft_size+k] + ptr_doa->m_eps;
 				ptr_doa->m_rxx_re[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+i] = rxx_re;
 				
 				for ( int j = i+1; j < ptr_doa->m_channels; ++j )
 				{
-					rxx_re = ptr_doa->m_re[i*ptr_doa->m_fft_size+k]*ptr_doa->m_re[j*ptr_doa->m_fft_size+k] + ptr_doa->m_im[i*ptr_doa->m_fft_size+k]*ptr_doa->m_im[j*ptr_doa->m_fft_size+k];
-					rxx_im = -ptr_doa->m_re[i*ptr_doa->m_fft_size+k]*ptr_doa->m_im[j*ptr_doa->m_fft_size+k] + ptr_doa->m_re[j*ptr_doa->m_fft_size+k]*ptr_doa->m_im[i*ptr_doa->m_fft_size+k];
+					rxx_re = re[b+i*ptr_doa->m_fft_size+k]*re[b+j*ptr_doa->m_fft_size+k] + im[b+i*ptr_doa->m_fft_size+k]*im[b+j*ptr_doa->m_fft_size+k];
+					rxx_im = -re[b+i*ptr_doa->m_fft_size+k]*im[b+j*ptr_doa->m_fft_size+k] + re[b+j*ptr_doa->m_fft_size+k]*im[b+i*ptr_doa->m_fft_size+k];
 					ptr_doa->m_rxx_re[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] = rxx_re;
 					ptr_doa->m_rxx_im[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] = rxx_im;
 				}
@@ -46,17 +50,17 @@ int dios_ssp_doa_cal_rxx(objDOA *ptr_doa)
 	}
 	else
 	{
-		for ( int k = 0; k < ptr_doa->m_sp_size; ++k )
+		for ( int k = 0; k < ptr_doa->m_band_len; ++k )
 		{
 			for ( int i = 0; i < ptr_doa->m_channels; ++i )
 			{
-				rxx_re = ptr_doa->m_re[i*ptr_doa->m_fft_size+k]*ptr_doa->m_re[i*ptr_doa->m_fft_size+k] + ptr_doa->m_im[i*ptr_doa->m_fft_size+k]*ptr_doa->m_im[i*ptr_doa->m_fft_size+k] + ptr_doa->m_eps;
+				rxx_re = re[b+i*ptr_doa->m_fft_size+k]*re[b+i*ptr_doa->m_fft_size+k] + im[b+i*ptr_doa->m_fft_size+k]*im[b+i*ptr_doa->m_fft_size+k] + ptr_doa->m_eps;
 				ptr_doa->m_rxx_re[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+i] = ptr_doa->m_alpha_rxx*ptr_doa->m_rxx_re[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+i] + ptr_doa->m_beta_rxx*rxx_re;
 								
 				for ( int j = i+1; j < ptr_doa->m_channels; ++j )
 				{
-					rxx_re = ptr_doa->m_re[i*ptr_doa->m_fft_size+k]*ptr_doa->m_re[j*ptr_doa->m_fft_size+k] + ptr_doa->m_im[i*ptr_doa->m_fft_size+k]*ptr_doa->m_im[j*ptr_doa->m_fft_size+k];
-					rxx_im = -ptr_doa->m_re[i*ptr_doa->m_fft_size+k]*ptr_doa->m_im[j*ptr_doa->m_fft_size+k] + ptr_doa->m_re[j*ptr_doa->m_fft_size+k]*ptr_doa->m_im[i*ptr_doa->m_fft_size+k];
+					rxx_re = re[b+i*ptr_doa->m_fft_size+k]*re[b+j*ptr_doa->m_fft_size+k] + im[b+i*ptr_doa->m_fft_size+k]*im[b+j*ptr_doa->m_fft_size+k];
+					rxx_im = -re[b+i*ptr_doa->m_fft_size+k]*im[b+j*ptr_doa->m_fft_size+k] + re[b+j*ptr_doa->m_fft_size+k]*im[b+i*ptr_doa->m_fft_size+k];
 					ptr_doa->m_rxx_re[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] = ptr_doa->m_alpha_rxx*ptr_doa->m_rxx_re[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] + ptr_doa->m_beta_rxx*rxx_re;
 					ptr_doa->m_rxx_im[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] = ptr_doa->m_alpha_rxx*ptr_doa->m_rxx_im[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] + ptr_doa->m_beta_rxx*rxx_im;										
 				}	
@@ -67,25 +71,41 @@ int dios_ssp_doa_cal_rxx(objDOA *ptr_doa)
 	return 0;
 }
 
-int dios_ssp_doa_init_steering_vectors_g(objDOA *ptr_doa)
+/* polar angle from the z axis in radians of grid elevation e */
+static float dios_ssp_doa_grid_phi(const objDOA *ptr_doa, int e)
 {
+	return PI * 0.5f - (ptr_doa->m_elev_min + (float)e * ptr_doa->m_delta_elev) * PI / 180.0f;
+}
+
+/* ShareTableBuild of the grid steering vectors, real parts then imaginary 
+   parts, arg is the instance being initialized */
+static int dios_ssp_doa_init_steering_vectors_g(void *table, const void *arg)
+{
+	const objDOA *ptr_doa = (const objDOA*)arg;
+	float *gstv_re = (float*)table;
+	float *gstv_im = gstv_re + ptr_doa->m_grid_num * ptr_doa->m_gstv_dim;
 	float deta = 0.0f;
 	float theta = 0.0f;
-	float phi = PI * 0.5f;
+	float phi = 0.0f;
 	float omega = 0.0f;
-    int i, j, k;
+    int e, i, j, n, g;
 
-	for (i = 0; i < ptr_doa->m_angle_num; ++i )
+	for (e = 0; e < ptr_doa->m_elev_num; ++e )
 	{
-		theta = (float)i * (float)ptr_doa->m_delta_angle * PI / 180.0f;
-		for (k = 0; k < ptr_doa->m_sp_size; ++k )
+		phi = dios_ssp_doa_grid_phi(ptr_doa, e);
+		for (i = 0; i < ptr_doa->m_angle_num; ++i )
 		{
-			omega = 2.0f * PI * ptr_doa->m_deta_fs * (float)k;
-			for (j = 0; j < ptr_doa->m_channels; ++j )
+			g = e * ptr_doa->m_angle_num + i;
+			theta = (float)i * ptr_doa->m_delta_angle * PI / 180.0f;
+			for (n = 0; n < ptr_doa->m_frq_bin_num; ++n )
 			{
-				deta = (float)(omega * (ptr_doa->cood[j].x * cos(theta) * sin(phi) + ptr_doa->cood[j].y * sin(theta) * sin(phi) + ptr_doa->cood[j].z * cos(phi))/ VELOCITY);
-				ptr_doa->m_gstv_re[i*ptr_doa->m_gstv_dim+k*ptr_doa->m_channels+j] = (float)cos(deta);
-				ptr_doa->m_gstv_im[i*ptr_doa->m_gstv_dim+k*ptr_doa->m_channels+j] = (float)sin(deta);
+				omega = 2.0f * PI * ptr_doa->m_deta_fs * (float)ptr_doa->m_doa_fid[n];
+				for (j = 0; j < ptr_doa->m_channels; ++j )
+				{
+					deta = (float)(omega * (ptr_doa->cood[j].x * cos(theta) * sin(phi) + ptr_doa->cood[j].y * sin(theta) * sin(phi) + ptr_doa->cood[j].z * cos(phi))/ VELOCITY);
+					gstv_re[g*ptr_doa->m_gstv_dim+n*ptr_doa->m_channels+j] = (float)cos(deta);
+					gstv_im[g*ptr_doa->m_gstv_dim+n*ptr_doa->m_channels+j] = (float)sin(deta);
+				}
 			}
 		}
 	}
@@ -93,62 +113,239 @@ int dios_ssp_doa_init_steering_vectors_g(objDOA *ptr_doa)
 	return 0;
 }
 
-void* dios_ssp_doa_init_api(int mic_num, PlaneCoord* mic_coord)
+/* steering vector of grid point g into m_stv when the grid has no table. the
+   phase of channel j is omega * tau_j, consecutive bins are m_fid_step or
+   m_fid_step + 1 apart, so it is advanced by one of two rotations per bin */
+static void dios_ssp_doa_steering_vector(objDOA *ptr_doa, int g)
+{
+	float theta = (float)(g % ptr_doa->m_angle_num) * ptr_doa->m_delta_angle * PI / 180.0f;
+	float phi = dios_ssp_doa_grid_phi(ptr_doa, g / ptr_doa->m_angle_num);
+	float w = 2.0f * PI * ptr_doa->m_deta_fs;
+	float tau, re, im, tmp;
+	float rot_re[2], rot_im[2];
+	int d, j, n;
+
+	for (j = 0; j < ptr_doa->m_channels; ++j )
+	{
+		tau = (ptr_doa->cood[j].x * cosf(theta) * sinf(phi) + ptr_doa->cood[j].y * sinf(theta) * sinf(phi) 
+			+ ptr_doa->cood[j].z * cosf(phi)) / VELOCITY;
+		for (d = 0; d < 2; d++)
+		{
+			rot_re[d] = cosf(w * (float)(ptr_doa->m_fid_step + d) * tau);
+			rot_im[d] = sinf(w * (float)(ptr_doa->m_fid_step + d) * tau);
+		}
+		re = cosf(w * (float)ptr_doa->m_doa_fid[0] * tau);
+		im = sinf(w * (float)ptr_doa->m_doa_fid[0] * tau);
+		ptr_doa->m_stv_re[j] = re;
+		ptr_doa->m_stv_im[j] = im;
+		for (n = 1; n < ptr_doa->m_frq_bin_num; ++n )
+		{
+			d = ptr_doa->m_doa_fid[n] - ptr_doa->m_doa_fid[n - 1] - ptr_doa->m_fid_step;
+			if (d == 0 || d == 1)
+			{
+				tmp = re * rot_re[d] - im * rot_im[d];
+				im = re * rot_im[d] + im * rot_re[d];
+				re = tmp;
+			}
+			else
+			{
+				re = cosf(w * (float)ptr_doa->m_doa_fid[n] * tau);
+				im = sinf(w * (float)ptr_doa->m_doa_fid[n] * tau);
+			}
+			ptr_doa->m_stv_re[n*ptr_doa->m_channels+j] = re;
+			ptr_doa->m_stv_im[n*ptr_doa->m_channels+j] = im;
+		}
+	}
+}
+
+static const size_t g_doa_ptr[] = {
+	offsetof(objDOA, m_capon_spectrum), offsetof(objDOA, m_capon_low),
+	offsetof(objDOA, m_doa_fid), offsetof(objDOA, m_irxx_re),
+	offsetof(objDOA, m_irxx_im), offsetof(objDOA, m_vec_re),
+	offsetof(objDOA, m_vec_im), offsetof(objDOA, m_gstv_re),
+	offsetof(objDOA, m_gstv_im), offsetof(objDOA, m_stv_re),
+	offsetof(objDOA, m_stv_im), offsetof(objDOA, m_rxx_avg_re),
+	offsetof(objDOA, m_rxx_avg_im), offsetof(objDOA, m_rxx_re),
+	offsetof(objDOA, m_rxx_im), offsetof(objDOA, m_re),
+	offsetof(objDOA, m_im), offsetof(objDOA, m_win_data),
+	offsetof(objDOA, fft_out), offsetof(objDOA, cood),
+	offsetof(objDOA, doainv), offsetof(objDOA, doawin),
+	offsetof(objDOA, doa_fft), offsetof(objDOA, m_mch_buffer),
+	offsetof(objDOA, table_pool)
+};
+
+static const size_t g_doa_win_ptr[] = {
+	offsetof(objDOACwin, m_ana_win), offsetof(objDOACwin, m_norm_win),
+	offsetof(objDOACwin, table_pool)
+};
+
+void* dios_ssp_doa_init_api(int mic_num, PlaneCoord* mic_coord, int sample_rate, float resolution, 
+	float elevation_min, float elevation_max, void* table_pool)
 {
 	void* st = NULL;
-	st = (void*)calloc(1, sizeof(objDOA));
+	st = (void*)dios_ssp_share_calloc_map(1, sizeof(objDOA), g_doa_ptr, SHARE_ARENA_MAP_NUM(g_doa_ptr));
 	objDOA* ptr_doa = (objDOA*)st;
 
     int i;
+	float d_min;
+	int key_len;
+	float *key;
     ptr_doa->m_channels = mic_num;
 	ptr_doa->cood = mic_coord;
-	ptr_doa->m_fs = DEFAULT_DOA_SAMPLING_FRQ;
-	ptr_doa->m_fft_size = DEFAULT_DOA_WIN_SIZE;
-	ptr_doa->m_shift_size = DEFAULT_DOA_SHIFT_SIZE;
-    ptr_doa->m_delta_angle = DEFAULT_DOA_DELTA_ANGLE;
+	ptr_doa->m_fs = sample_rate;
+	/* window and shift keep their duration at any sampling rate */
+	ptr_doa->m_fft_size = DEFAULT_DOA_WIN_SIZE * sample_rate / DEFAULT_DOA_SAMPLING_FRQ;
+	ptr_doa->m_shift_size = DEFAULT_DOA_SHIFT_SIZE * sample_rate / DEFAULT_DOA_SAMPLING_FRQ;
     ptr_doa->m_low_frq = DEFAULT_DOA_LOW_FRQ;
 	ptr_doa->m_high_frq = DEFAULT_DOA_HIGH_FRQ;
+	if (ptr_doa->m_high_frq > ptr_doa->m_fs / 2 - DEFAULT_DOA_FRQ_SP)
+	{
+		ptr_doa->m_high_frq = ptr_doa->m_fs / 2 - DEFAULT_DOA_FRQ_SP;
+	}
 	ptr_doa->m_frq_sp = DEFAULT_DOA_FRQ_SP;
 	ptr_doa->m_eps = DEFAULT_DOA_EPS;
 	ptr_doa->m_alpha_rxx = DEFAULT_DOA_ALPHA_RXX;
 	ptr_doa->m_beta_rxx = 1-ptr_doa->m_alpha_rxx;
 	ptr_doa->m_deta_fs = ptr_doa->m_fs / (float)ptr_doa->m_fft_size;
-    ptr_doa->m_angle_num = (int)((360.0-0.0)/ ptr_doa->m_delta_angle);
+	/* the grid divides the circle evenly, the coarse pass takes every
+	   m_coarse_stride-th angle of it */
+	if (resolution <= 0.0f)
+	{
+		resolution = DEFAULT_DOA_RESOLUTION;
+	}
+    ptr_doa->m_angle_num = (int)(360.0f / resolution + 0.5f);
+	if (ptr_doa->m_angle_num < DEFAULT_DOA_MIN_ANGLE_NUM)
+	{
+		ptr_doa->m_angle_num = DEFAULT_DOA_MIN_ANGLE_NUM;
+	}
+    ptr_doa->m_delta_angle = 360.0f / ptr_doa->m_angle_num;
+	ptr_doa->m_coarse_stride = (int)(DEFAULT_DOA_COARSE_ANGLE / ptr_doa->m_delta_angle + 0.5f);
+	if (ptr_doa->m_coarse_stride < 1)
+	{
+		ptr_doa->m_coarse_stride = 1;
+	}
+	/* the elevations split the range evenly at about the same resolution */
+	elevation_min = elevation_min < -90.0f ? -90.0f : (elevation_min > 90.0f ? 90.0f : elevation_min);
+	elevation_max = elevation_max < elevation_min ? elevation_min : (elevation_max > 90.0f ? 90.0f : elevation_max);
+	ptr_doa->m_elev_num = (int)((elevation_max - elevation_min) / resolution + 0.5f) + 1;
+	ptr_doa->m_elev_min = elevation_min;
+	ptr_doa->m_delta_elev = ptr_doa->m_elev_num > 1 ? (elevation_max - elevation_min) / (ptr_doa->m_elev_num - 1) : 0.0f;
+	ptr_doa->m_elev_stride = 0;
+	if (ptr_doa->m_elev_num > 1)
+	{
+		ptr_doa->m_elev_stride = (int)(DEFAULT_DOA_COARSE_ANGLE / ptr_doa->m_delta_elev + 0.5f);
+		if (ptr_doa->m_elev_stride < 1)
+		{
+			ptr_doa->m_elev_stride = 1;
+		}
+	}
+	ptr_doa->m_grid_num = ptr_doa->m_angle_num * ptr_doa->m_elev_num;
     ptr_doa->m_angle_smooth = 90.0f;
+	ptr_doa->m_elev_smooth = elevation_min > 0.0f ? elevation_min : (elevation_max < 0.0f ? elevation_max : 0.0f);
     ptr_doa->m_frq_bin_num = (int)((ptr_doa->m_high_frq - ptr_doa->m_low_frq)/ptr_doa->m_frq_sp + 1);
     ptr_doa->m_low_fid = (int)(ptr_doa->m_low_frq*ptr_doa->m_fft_size/ptr_doa->m_fs);
     ptr_doa->m_sp_size = ptr_doa->m_fft_size/2+1;
     ptr_doa->m_rxx_size = ptr_doa->m_channels * ptr_doa->m_channels;
     ptr_doa->m_frq_bin_width = (int)(ptr_doa->m_frq_sp/ptr_doa->m_deta_fs);
+    ptr_doa->m_doa_fid = (int*)dios_ssp_share_calloc(ptr_doa->m_frq_bin_num, sizeof(int));
+    for(i = 0; i < ptr_doa->m_frq_bin_num; ++i)
+	{
+		ptr_doa->m_doa_fid[i] = ptr_doa->m_low_fid + (i*ptr_doa->m_frq_sp*ptr_doa->m_fft_size)/ptr_doa->m_fs;
+	}
+	ptr_doa->m_fid_step = ptr_doa->m_frq_sp * ptr_doa->m_fft_size / ptr_doa->m_fs;
+	/* the smoothing of bin k reads bins k - m_frq_bin_width/2 ~ k + m_frq_bin_width/2 - 1 */
+    ptr_doa->m_band_lo = ptr_doa->m_doa_fid[0] + ptr_doa->m_frq_bin_width/2 - ptr_doa->m_frq_bin_width;
+    ptr_doa->m_band_len = ptr_doa->m_doa_fid[ptr_doa->m_frq_bin_num-1] + ptr_doa->m_frq_bin_width/2 - ptr_doa->m_band_lo;
+
+	/* above VELOCITY / (2 * spacing) of the closest microphones the spectrum has
+	   aliased peaks, the confidence of a source is taken below it */
+	d_min = 0.0f;
+	for (i = 0; i < ptr_doa->m_channels; i++)
+	{
+		for (int j = i + 1; j < ptr_doa->m_channels; j++)
+		{
+			float dx = mic_coord[i].x - mic_coord[j].x;
+			float dy = mic_coord[i].y - mic_coord[j].y;
+			float dz = mic_coord[i].z - mic_coord[j].z;
+			float d = sqrtf(dx * dx + dy * dy + dz * dz);
+			if (d > 0.0f && (d_min == 0.0f || d < d_min))
+			{
+				d_min = d;
+			}
+		}
+	}
+	ptr_doa->m_alias_bin_num = 0;
+	while (ptr_doa->m_alias_bin_num < ptr_doa->m_frq_bin_num && (d_min == 0.0f
+		|| ptr_doa->m_doa_fid[ptr_doa->m_alias_bin_num] * ptr_doa->m_deta_fs < VELOCITY / (2.0f * d_min)))
+	{
+		ptr_doa->m_alias_bin_num++;
+	}
+	if (ptr_doa->m_alias_bin_num == 0)
+	{
+		ptr_doa->m_alias_bin_num = 1;
+	}
 
-    ptr_doa->m_capon_spectrum = (float*)calloc(ptr_doa->m_angle_num, sizeof(float));
-    ptr_doa->m_doa_fid = (int*)calloc(ptr_doa->m_angle_num, sizeof(int));
-    ptr_doa->m_irxx_re = (float*)calloc(ptr_doa->m_sp_size*ptr_doa->m_rxx_size, sizeof(float));
-	ptr_doa->m_irxx_im = (float*)calloc(ptr_doa->m_sp_size*ptr_doa->m_rxx_size, sizeof(float));
-    ptr_doa->m_vec_re = (float*)calloc(ptr_doa->m_channels, sizeof(float));
-	ptr_doa->m_vec_im = (float*)calloc(ptr_doa->m_channels, sizeof(float));
-    ptr_doa->m_gstv_re = (float*)calloc(ptr_doa->m_sp_size*ptr_doa->m_angle_num*ptr_doa->m_channels, sizeof(float));
-	ptr_doa->m_gstv_im = (float*)calloc(ptr_doa->m_sp_size*ptr_doa->m_angle_num*ptr_doa->m_channels, sizeof(float));
-    ptr_doa->m_rxx_in = (float*)calloc(2*ptr_doa->m_rxx_size, sizeof(float));
-    ptr_doa->m_rxx_re = (float*)calloc(ptr_doa->m_sp_size*ptr_doa->m_rxx_size, sizeof(float));
-    ptr_doa->m_rxx_im = (float*)calloc(ptr_doa->m_sp_size*ptr_doa->m_rxx_size, sizeof(float));
-	ptr_doa->m_mch_buffer = (float**)calloc(ptr_doa->m_channels, sizeof(float*));
+    ptr_doa->m_capon_spectrum = (float*)dios_ssp_share_calloc(ptr_doa->m_grid_num, sizeof(float));
+    ptr_doa->m_capon_low = (float*)dios_ssp_share_calloc(ptr_doa->m_grid_num, sizeof(float));
+    ptr_doa->m_irxx_re = (float*)dios_ssp_share_calloc(ptr_doa->m_frq_bin_num*ptr_doa->m_rxx_size, sizeof(float));
+	ptr_doa->m_irxx_im = (float*)dios_ssp_share_calloc(ptr_doa->m_frq_bin_num*ptr_doa->m_rxx_size, sizeof(float));
+    ptr_doa->m_vec_re = (float*)dios_ssp_share_calloc(ptr_doa->m_channels, sizeof(float));
+	ptr_doa->m_vec_im = (float*)dios_ssp_share_calloc(ptr_doa->m_channels, sizeof(float));
+    ptr_doa->m_rxx_avg_re = (float*)dios_ssp_share_calloc(ptr_doa->m_frq_bin_num*ptr_doa->m_rxx_size, sizeof(float));
+    ptr_doa->m_rxx_avg_im = (float*)dios_ssp_share_calloc(ptr_doa->m_frq_bin_num*ptr_doa->m_rxx_size, sizeof(float));
+    ptr_doa->m_rxx_re = (float*)dios_ssp_share_calloc(ptr_doa->m_band_len*ptr_doa->m_rxx_size, sizeof(float));
+    ptr_doa->m_rxx_im = (float*)dios_ssp_share_calloc(ptr_doa->m_band_len*ptr_doa->m_rxx_size, sizeof(float));
+	ptr_doa->m_mch_buffer = (float**)dios_ssp_share_calloc_ptr(ptr_doa->m_channels, sizeof(float*));
 	for (i = 0; i < ptr_doa->m_channels; ++i )
 	{
-		ptr_doa->m_mch_buffer[i] = (float*)calloc(ptr_doa->m_fft_size, sizeof(float));
+		ptr_doa->m_mch_buffer[i] = (float*)dios_ssp_share_calloc(ptr_doa->m_fft_size, sizeof(float));
 	}
-	ptr_doa->doa_fft = dios_ssp_share_rfft_init(ptr_doa->m_fft_size);
-	ptr_doa->fft_out = (float *)calloc(ptr_doa->m_fft_size, sizeof(float));
-	ptr_doa->m_win_data = (float*)calloc(ptr_doa->m_fft_size*ptr_doa->m_channels, sizeof(float));
-	ptr_doa->m_re = (float*)calloc(ptr_doa->m_fft_size*ptr_doa->m_channels, sizeof(float));
-	ptr_doa->m_im = (float*)calloc(ptr_doa->m_fft_size*ptr_doa->m_channels, sizeof(float));	
-	ptr_doa->m_irxx_out = (float*)calloc(2*ptr_doa->m_rxx_size, sizeof(float));
-	ptr_doa->m_gstv_dim = ptr_doa->m_sp_size*ptr_doa->m_channels;	
-	ptr_doa->doainv = dios_ssp_matrix_inv_init(ptr_doa->m_channels);
-	ptr_doa->doawin = (objDOACwin*)calloc(1, sizeof(objDOACwin));
-	dios_ssp_doa_win_init(ptr_doa->doawin, ptr_doa->m_fft_size, ptr_doa->m_shift_size);
-
-	dios_ssp_doa_init_steering_vectors_g(ptr_doa);
+	ptr_doa->doa_fft = dios_ssp_share_rfft_init_pool(ptr_doa->m_fft_size, table_pool);
+	ptr_doa->fft_out = (float *)dios_ssp_share_calloc(ptr_doa->m_fft_size, sizeof(float));
+	ptr_doa->m_win_data = (float*)dios_ssp_share_calloc(ptr_doa->m_fft_size*ptr_doa->m_channels, sizeof(float));
+	ptr_doa->m_re = (float*)dios_ssp_share_calloc(ptr_doa->m_fft_size*ptr_doa->m_channels, sizeof(float));
+	ptr_doa->m_im = (float*)dios_ssp_share_calloc(ptr_doa->m_fft_size*ptr_doa->m_channels, sizeof(float));	
+	ptr_doa->m_gstv_dim = ptr_doa->m_frq_bin_num*ptr_doa->m_channels;	
+	ptr_doa->doainv = dios_ssp_hermitian_inv_init(ptr_doa->m_channels, 0.0f);
+	ptr_doa->doawin = (objDOACwin*)dios_ssp_share_calloc_map(1, sizeof(objDOACwin), g_doa_win_ptr, SHARE_ARENA_MAP_NUM(g_doa_win_ptr));
+	dios_ssp_doa_win_init(ptr_doa->doawin, ptr_doa->m_fft_size, ptr_doa->m_shift_size, table_pool);
+
+	/* the steering vectors only depend on the array and the analysis 
+	   parameters, instances with the same ones share them. a grid with
+	   elevations may be too large to tabulate, its steering vectors are
+	   computed when the search evaluates a point */
+	ptr_doa->table_pool = table_pool;
+	if (2 * (size_t)ptr_doa->m_grid_num * ptr_doa->m_gstv_dim * sizeof(float) > DEFAULT_DOA_STV_TABLE_SIZE)
+	{
+		ptr_doa->m_stv_re = (float*)dios_ssp_share_calloc(ptr_doa->m_gstv_dim, sizeof(float));
+		ptr_doa->m_stv_im = (float*)dios_ssp_share_calloc(ptr_doa->m_gstv_dim, sizeof(float));
+		return st;
+	}
+	key_len = 7 + 3 * ptr_doa->m_channels;
+	key = (float*)dios_ssp_share_calloc(key_len, sizeof(float));
+	key[0] = (float)ptr_doa->m_channels;
+	key[1] = (float)ptr_doa->m_fs;
+	key[2] = (float)ptr_doa->m_fft_size;
+	key[3] = ptr_doa->m_delta_angle;
+	key[4] = (float)ptr_doa->m_elev_num;
+	key[5] = ptr_doa->m_elev_min;
+	key[6] = ptr_doa->m_delta_elev;
+	for (i = 0; i < ptr_doa->m_channels; i++)
+	{
+		key[7 + 3 * i] = ptr_doa->cood[i].x;
+		key[8 + 3 * i] = ptr_doa->cood[i].y;
+		key[9 + 3 * i] = ptr_doa->cood[i].z;
+	}
+	ptr_doa->m_gstv_re = (const float*)dios_ssp_share_table_get(table_pool, "doa_stv", key, key_len * (int)sizeof(float), 
+		2 * ptr_doa->m_grid_num * ptr_doa->m_gstv_dim * sizeof(float), dios_ssp_doa_init_steering_vectors_g, ptr_doa);
+	dios_ssp_share_free(key);
+	if (ptr_doa->m_gstv_re == NULL)
+	{
+		printf("doa steering vector table init error!\n");
+		dios_ssp_doa_uninit_api(ptr_doa);
+		return NULL;
+	}
+	ptr_doa->m_gstv_im = ptr_doa->m_gstv_re + ptr_doa->m_grid_num * ptr_doa->m_gstv_dim;
 	
 	return st;	
 }
@@ -166,10 +363,6 @@ int dios_ssp_doa_reset_api(void *ptr)
 		ptr_doa->fft_out[i] = 0.0;
     }
 
-    for(i = 0; i < ptr_doa->m_frq_bin_num; ++i)
-	{
-		ptr_doa->m_doa_fid[i] = ptr_doa->m_low_fid + (i*ptr_doa->m_frq_sp*ptr_doa->m_fft_size)/ptr_doa->m_fs;
-	}
 	for (i = 0; i < ptr_doa->m_channels; ++i )
 	{
 		memset( ptr_doa->m_mch_buffer[i], 0, sizeof(float)*ptr_doa->m_fft_size );
@@ -177,150 +370,601 @@ int dios_ssp_doa_reset_api(void *ptr)
 	memset( ptr_doa->m_win_data, 0, sizeof(float)*ptr_doa->m_channels*ptr_doa->m_fft_size );
 	memset( ptr_doa->m_re, 0, sizeof(float)*ptr_doa->m_channels*ptr_doa->m_fft_size );
 	memset( ptr_doa->m_im, 0, sizeof(float)*ptr_doa->m_channels*ptr_doa->m_fft_size );
-    memset( ptr_doa->m_capon_spectrum, 0, sizeof(float)*ptr_doa->m_angle_num );
-    memset( ptr_doa->m_irxx_re, 0, sizeof(float)*ptr_doa->m_sp_size*ptr_doa->m_rxx_size );
-	memset( ptr_doa->m_irxx_im, 0, sizeof(float)*ptr_doa->m_sp_size*ptr_doa->m_rxx_size );
+    memset( ptr_doa->m_capon_spectrum, 0, sizeof(float)*ptr_doa->m_grid_num );
+    memset( ptr_doa->m_irxx_re, 0, sizeof(float)*ptr_doa->m_frq_bin_num*ptr_doa->m_rxx_size );
+	memset( ptr_doa->m_irxx_im, 0, sizeof(float)*ptr_doa->m_frq_bin_num*ptr_doa->m_rxx_size );
     memset( ptr_doa->m_vec_re, 0, sizeof(float)*ptr_doa->m_channels );
 	memset( ptr_doa->m_vec_im, 0, sizeof(float)*ptr_doa->m_channels );
-    memset( ptr_doa->m_rxx_in, 0, sizeof(float)*2*ptr_doa->m_rxx_size );
-    memset( ptr_doa->m_rxx_re, 0, sizeof(float)*ptr_doa->m_sp_size*ptr_doa->m_rxx_size );
-	memset( ptr_doa->m_rxx_im, 0, sizeof(float)*ptr_doa->m_sp_size*ptr_doa->m_rxx_size );	
-	memset( ptr_doa->m_irxx_out, 0, sizeof(float)*2*ptr_doa->m_rxx_size );
+    memset( ptr_doa->m_rxx_avg_re, 0, sizeof(float)*ptr_doa->m_frq_bin_num*ptr_doa->m_rxx_size );
+    memset( ptr_doa->m_rxx_avg_im, 0, sizeof(float)*ptr_doa->m_frq_bin_num*ptr_doa->m_rxx_size );
+    memset( ptr_doa->m_rxx_re, 0, sizeof(float)*ptr_doa->m_band_len*ptr_doa->m_rxx_size );
+	memset( ptr_doa->m_rxx_im, 0, sizeof(float)*ptr_doa->m_band_len*ptr_doa->m_rxx_size );	
+	ptr_doa->m_peak_num = 0;
+	memset( ptr_doa->m_track, 0, sizeof(ptr_doa->m_track) );
+	ptr_doa->m_track_id = 0;
 	    
     return 0;
 }
 
-float dios_ssp_doa_process_api(void* ptr, float* in, int vad_result, int dt_st)
+/* 1 if grid elevation e is a pole, where all azimuths are the same direction */
+static int dios_ssp_doa_pole(const objDOA *ptr_doa, int e)
 {
-    int   max_ind = 0;
-	float max_spectrum = 0;
-	float re_temp, im_temp;
+	return fabsf(ptr_doa->m_elev_min + (float)e * ptr_doa->m_delta_elev) > 90.0f - 1e-3f;
+}
 
-    objDOA* ptr_doa;
-	ptr_doa = (objDOA*)ptr;
+/* grid point of azimuth a and elevation e, a wraps around the circle and all
+   azimuths of a pole are the point of azimuth 0 */
+static int dios_ssp_doa_point(const objDOA *ptr_doa, int a, int e)
+{
+	a = (a % ptr_doa->m_angle_num + ptr_doa->m_angle_num) % ptr_doa->m_angle_num;
+	if (ptr_doa->m_elev_num > 1 && dios_ssp_doa_pole(ptr_doa, e))
+	{
+		a = 0;
+	}
 
-	for (int ch_idx = 0; ch_idx < ptr_doa->m_channels; ++ch_idx)
+	return e * ptr_doa->m_angle_num + a;
+}
+
+/* Capon spectrum of grid azimuth a and elevation e summed over the analysed
+   bins, each point is evaluated once per frame, m_capon_spectrum is -1 for the
+   ones not evaluated */
+static float dios_ssp_doa_capon(objDOA *ptr_doa, int a, int e)
+{
+	const float *stv_re, *stv_im;
+	float re_temp, im_temp;
+	float spectrum = 0.0f;
+	int m = dios_ssp_doa_point(ptr_doa, a, e);
+
+	if (ptr_doa->m_capon_spectrum[m] >= 0.0f)
 	{
-		for (int i = 0; i < ptr_doa->m_shift_size; ++i)
+		return ptr_doa->m_capon_spectrum[m];
+	}
+	if (ptr_doa->m_gstv_re != NULL)
+	{
+		stv_re = ptr_doa->m_gstv_re + m * ptr_doa->m_gstv_dim;
+		stv_im = ptr_doa->m_gstv_im + m * ptr_doa->m_gstv_dim;
+	}
+	else
+	{
+		dios_ssp_doa_steering_vector(ptr_doa, m);
+		stv_re = ptr_doa->m_stv_re;
+		stv_im = ptr_doa->m_stv_im;
+	}
+	for ( int n = 0; n < ptr_doa->m_frq_bin_num; ++n)
+	{
+		for (int i = 0; i < ptr_doa->m_channels; i++)
 		{
-			ptr_doa->m_mch_buffer[ch_idx][ptr_doa->m_fft_size - ptr_doa->m_shift_size + i] = in[ch_idx * ptr_doa->m_shift_size + i];
+			re_temp = im_temp = 0;
+			for (int j = 0; j < ptr_doa->m_channels; j++)
+			{
+				re_temp += ptr_doa->m_irxx_re[n*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] * stv_re[n*ptr_doa->m_channels+j] 
+						- ptr_doa->m_irxx_im[n*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] * stv_im[n*ptr_doa->m_channels+j];
+				im_temp += ptr_doa->m_irxx_re[n*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] * stv_im[n*ptr_doa->m_channels+j] 
+						+ ptr_doa->m_irxx_im[n*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] * stv_re[n*ptr_doa->m_channels+j];
+			}
+			ptr_doa->m_vec_re[i] = re_temp;
+			ptr_doa->m_vec_im[i] = im_temp;
 		}
-	}	
+		/* the quadratic form is real, only its real part is accumulated */
+		re_temp = 0;
+		for (int i = 0; i < ptr_doa->m_channels; i++)
+		{
+			re_temp += stv_re[n*ptr_doa->m_channels+i]*ptr_doa->m_vec_re[i] + stv_im[n*ptr_doa->m_channels+i]*ptr_doa->m_vec_im[i];
+		}
+		spectrum += ptr_doa->m_channels / re_temp;
+		if (n == ptr_doa->m_alias_bin_num - 1)
+		{
+			ptr_doa->m_capon_low[m] = spectrum;
+		}
+	}
+	ptr_doa->m_capon_spectrum[m] = spectrum;
 
-	// add ana window		
-	for (int ch_idx = 0; ch_idx < ptr_doa->m_channels; ++ch_idx )
+	return spectrum;
+}
+
+/* move grid point g by +-step_a azimuths or +-step_e elevations towards the
+   larger Capon spectrum, step_e is 0 without elevations */
+static int dios_ssp_doa_climb(objDOA *ptr_doa, int g, int step_a, int step_e)
+{
+	int a = g % ptr_doa->m_angle_num;
+	int e = g / ptr_doa->m_angle_num;
+	int da = 0;
+	int de = 0;
+	float y = dios_ssp_doa_capon(ptr_doa, a, e);
+	float yl = dios_ssp_doa_capon(ptr_doa, a - step_a, e);
+	float yr = dios_ssp_doa_capon(ptr_doa, a + step_a, e);
+	float yd, yu;
+
+	if (yl > y && yl >= yr)
 	{
-		dios_ssp_doa_win_add_ana_win(ptr_doa->doawin, ptr_doa->m_mch_buffer[ch_idx], ptr_doa->m_win_data+ch_idx*ptr_doa->m_fft_size);
+		da = -step_a;
+		y = yl;
 	}
-	// stft 
-	for (int ch_idx = 0; ch_idx < ptr_doa->m_channels; ++ch_idx )
+	else if (yr > y)
 	{
-		dios_ssp_share_rfft_process(ptr_doa->doa_fft, ptr_doa->m_win_data+ch_idx*ptr_doa->m_fft_size, ptr_doa->fft_out);
-		for (int i = 0; i < ptr_doa->m_fft_size / 2 + 1; i++)
+		da = step_a;
+		y = yr;
+	}
+	if (step_e > 0)
+	{
+		yd = e - step_e >= 0 ? dios_ssp_doa_capon(ptr_doa, a, e - step_e) : -1.0f;
+		yu = e + step_e < ptr_doa->m_elev_num ? dios_ssp_doa_capon(ptr_doa, a, e + step_e) : -1.0f;
+		if (yd > y && yd >= yu)
 		{
-			ptr_doa->m_re[i + ch_idx * ptr_doa->m_fft_size] = ptr_doa->fft_out[i];
+			da = 0;
+			de = -step_e;
 		}
-		ptr_doa->m_im[0 + ch_idx * ptr_doa->m_fft_size] = ptr_doa->m_im[ptr_doa->m_fft_size / 2 + ch_idx * ptr_doa->m_fft_size] = 0.0;
-		for (int i = 1; i < ptr_doa->m_fft_size / 2; i++)
+		else if (yu > y)
 		{
-			ptr_doa->m_im[i + ch_idx * ptr_doa->m_fft_size] = -ptr_doa->fft_out[ptr_doa->m_fft_size - i];
+			da = 0;
+			de = step_e;
 		}
 	}
 
-	dios_ssp_doa_cal_rxx(ptr_doa);
+	return dios_ssp_doa_point(ptr_doa, a + da, e + de);
+}
 
-	for ( int n = 0; n < ptr_doa->m_frq_bin_num; ++n)
+/* direction in degrees of the peak at grid point g, interpolated by a parabola
+   through its neighbours along each axis */
+static void dios_ssp_doa_interp(objDOA *ptr_doa, int g, float *angle, float *elevation)
+{
+	int a = g % ptr_doa->m_angle_num;
+	int e = g / ptr_doa->m_angle_num;
+	float y = dios_ssp_doa_capon(ptr_doa, a, e);
+	float yl = dios_ssp_doa_capon(ptr_doa, a - 1, e);
+	float yr = dios_ssp_doa_capon(ptr_doa, a + 1, e);
+	float den = yl - 2.0f * y + yr;
+	float delta = 0.0f;
+
+	if (den < 0.0f)
 	{
-		int k = ptr_doa->m_doa_fid[n];
+		delta = 0.5f * (yl - yr) / den;
+	}
+	*angle = ((float)a + delta) * ptr_doa->m_delta_angle;
+	if (*angle < 0.0f)
+	{
+		*angle += 360.0f;
+	}
+	else if (*angle >= 360.0f)
+	{
+		*angle -= 360.0f;
+	}
 
-		memset( ptr_doa->m_rxx_in, 0, sizeof(float)*2*ptr_doa->m_rxx_size );
-			
-		for ( int i = 0; i < ptr_doa->m_channels; ++i)
+	delta = 0.0f;
+	if (e > 0 && e < ptr_doa->m_elev_num - 1)
+	{
+		yl = dios_ssp_doa_capon(ptr_doa, a, e - 1);
+		yr = dios_ssp_doa_capon(ptr_doa, a, e + 1);
+		den = yl - 2.0f * y + yr;
+		if (den < 0.0f)
+		{
+			delta = 0.5f * (yl - yr) / den;
+		}
+	}
+	*elevation = ptr_doa->m_elev_min + ((float)e + delta) * ptr_doa->m_delta_elev;
+}
+
+/* difference a - b of two directions in degrees, -180 ~ 180 */
+static float dios_ssp_doa_angle_diff(float a, float b)
+{
+	float d = a - b;
+
+	if (d > 180.0f)
+	{
+		d -= 360.0f;
+	}
+	else if (d < -180.0f)
+	{
+		d += 360.0f;
+	}
+
+	return d;
+}
+
+/* great circle distance in degrees between the directions of azimuth and
+   elevation a1, e1 and a2, e2 in degrees, |a1 - a2| in the plane */
+static float dios_ssp_doa_arc(float a1, float e1, float a2, float e2)
+{
+	float sa = sinf(0.5f * (a1 - a2) * PI / 180.0f);
+	float se = sinf(0.5f * (e1 - e2) * PI / 180.0f);
+	float h = se * se + cosf(e1 * PI / 180.0f) * cosf(e2 * PI / 180.0f) * sa * sa;
+
+	return 360.0f / PI * asinf(sqrtf(h < 1.0f ? h : 1.0f));
+}
+
+/* coarse row following grid elevation e, every m_elev_stride-th elevation and
+   the last one, m_elev_num after the last */
+static int dios_ssp_doa_coarse_next(const objDOA *ptr_doa, int e)
+{
+	int last = ptr_doa->m_elev_num - 1;
+
+	if (e == last)
+	{
+		return ptr_doa->m_elev_num;
+	}
+
+	return e + ptr_doa->m_elev_stride < last ? e + ptr_doa->m_elev_stride : last;
+}
+
+/* coarse-to-fine search of the Capon peaks: every m_coarse_stride-th grid angle
+   of the coarse rows first, then the DEFAULT_DOA_MAX_SOURCE_NUM largest coarse
+   peaks are refined with halving steps down to the grid and interpolated. the
+   peaks are stored in m_peak_angle and m_peak_elev with a confidence from
+   m_capon_low, where a single source has no aliased peaks: how far the
+   strongest peak rises above the floor, i.e. the lowest coarse value, times
+   the height of the peak above the floor in dB relative to the strongest one.
+   returns the direction of the strongest peak in degrees */
+static float dios_ssp_doa_search(objDOA *ptr_doa)
+{
+	int num = ptr_doa->m_angle_num;
+	int stride = ptr_doa->m_coarse_stride;
+	int last = ((num - 1) / stride) * stride;
+	int cand[DEFAULT_DOA_MAX_SOURCE_NUM];
+	int peak[DEFAULT_DOA_MAX_SOURCE_NUM];
+	int row[2];
+	int near[3];
+	int cand_num = 0;
+	int a, c, e, i, j, k, m, pole, step, step_e;
+	float y, yn;
+	float floor_level;
+	float top = 0.0f;
+	float angle, elevation;
+
+	for (m = 0; m < ptr_doa->m_grid_num; m++)
+	{
+		ptr_doa->m_capon_spectrum[m] = -1.0f;
+	}
+
+	// 1. coarse grid, its local peaks sorted by height become the candidates
+	for (e = 0; e < ptr_doa->m_elev_num; e = dios_ssp_doa_coarse_next(ptr_doa, e))
+	{
+		for (a = 0; a < num; a += stride)
+		{
+			dios_ssp_doa_capon(ptr_doa, a, e);
+		}
+	}
+	floor_level = ptr_doa->m_capon_low[0];
+	for (e = 0; e < ptr_doa->m_elev_num; e = dios_ssp_doa_coarse_next(ptr_doa, e))
+	{
+		/* the coarse rows below and above, ties go to the lower point */
+		row[0] = e > 0 ? ((e - 1) / ptr_doa->m_elev_stride) * ptr_doa->m_elev_stride : -1;
+		row[1] = e < ptr_doa->m_elev_num - 1 ? dios_ssp_doa_coarse_next(ptr_doa, e) : -1;
+		pole = ptr_doa->m_elev_num > 1 && dios_ssp_doa_pole(ptr_doa, e);
+		for (a = 0; a < num && (a == 0 || !pole); a += stride)
 		{
-			for(int m = 0; m < ptr_doa->m_frq_bin_width; ++m)
-			{	
-				ptr_doa->m_rxx_in[i*ptr_doa->m_channels*2+2*i] += ptr_doa->m_rxx_re[(k-m+ptr_doa->m_frq_bin_width/2-1)*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+i];		
-				ptr_doa->m_rxx_in[i*ptr_doa->m_channels*2+2*i+1] += ptr_doa->m_rxx_im[(k-m+ptr_doa->m_frq_bin_width/2-1)*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+i];
+			m = dios_ssp_doa_point(ptr_doa, a, e);
+			near[0] = a == 0 ? last : a - stride;
+			near[1] = a;
+			near[2] = a == last ? 0 : a + stride;
+			y = ptr_doa->m_capon_spectrum[m];
+			if (ptr_doa->m_capon_low[m] < floor_level)
+			{
+				floor_level = ptr_doa->m_capon_low[m];
 			}
-			ptr_doa->m_rxx_in[i*ptr_doa->m_channels*2+2*i] /= ptr_doa->m_frq_bin_width;
-			ptr_doa->m_rxx_in[i*ptr_doa->m_channels*2+2*i+1] /= ptr_doa->m_frq_bin_width;
-			for ( int j = i+1; j < ptr_doa->m_channels; ++j)
+			if (!pole && (y < dios_ssp_doa_capon(ptr_doa, near[0], e) || y <= dios_ssp_doa_capon(ptr_doa, near[2], e)))
 			{
-				for( int m = 0; m < ptr_doa->m_frq_bin_width; ++m)
+				continue;
+			}
+			for (k = 0; k < 2; k++)
+			{
+				for (j = 0; j < 3 && row[k] >= 0; j++)
 				{
-					ptr_doa->m_rxx_in[i*ptr_doa->m_channels*2+2*j] += ptr_doa->m_rxx_re[(k-m+ptr_doa->m_frq_bin_width/2-1)*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j];
-					ptr_doa->m_rxx_in[i*ptr_doa->m_channels*2+2*j+1] += ptr_doa->m_rxx_im[(k-m+ptr_doa->m_frq_bin_width/2-1)*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j];				
+					yn = dios_ssp_doa_capon(ptr_doa, near[j], row[k]);
+					if (k == 0 ? y < yn : y <= yn)
+					{
+						break;
+					}
+				}
+				if (j < 3 && row[k] >= 0)
+				{
+					break;
 				}
-				ptr_doa->m_rxx_in[i*ptr_doa->m_channels*2+2*j] /= ptr_doa->m_frq_bin_width;
-				ptr_doa->m_rxx_in[i*ptr_doa->m_channels*2+2*j+1] /= ptr_doa->m_frq_bin_width;
-				ptr_doa->m_rxx_in[j*ptr_doa->m_channels*2+2*i] = ptr_doa->m_rxx_in[i*ptr_doa->m_channels*2+2*j];
-				ptr_doa->m_rxx_in[j*ptr_doa->m_channels*2+2*i+1] = -ptr_doa->m_rxx_in[i*ptr_doa->m_channels*2+2*j+1];
 			}
+			if (k < 2)
+			{
+				continue;
+			}
+			if (cand_num == DEFAULT_DOA_MAX_SOURCE_NUM && y <= ptr_doa->m_capon_spectrum[cand[cand_num - 1]])
+			{
+				continue;
+			}
+			i = cand_num < DEFAULT_DOA_MAX_SOURCE_NUM ? cand_num++ : cand_num - 1;
+			for ( ; i > 0 && ptr_doa->m_capon_spectrum[cand[i - 1]] < y; i--)
+			{
+				cand[i] = cand[i - 1];
+			}
+			cand[i] = m;
 		}
-		dios_ssp_matrix_inv_process(ptr_doa->doainv, ptr_doa->m_rxx_in, ptr_doa->m_irxx_out);
-		for ( int i = 0; i < ptr_doa->m_channels; ++i)
+	}
+	if (cand_num == 0)
+	{
+		cand[cand_num++] = 0;
+	}
+
+	// 2. refine the candidates down to the grid, strongest first
+	ptr_doa->m_peak_num = 0;
+	for (i = 0; i < cand_num; i++)
+	{
+		c = cand[i];
+		for (step = stride, step_e = ptr_doa->m_elev_stride; step > 1 || step_e > 1; )
 		{
-			for ( int j = 0; j < ptr_doa->m_channels; ++j)
+			step = (step + 1) / 2;
+			step_e = (step_e + 1) / 2;
+			c = dios_ssp_doa_climb(ptr_doa, c, step, step_e);
+		}
+		for (m = 0; m < ptr_doa->m_grid_num; m++)
+		{
+			step = c;
+			c = dios_ssp_doa_climb(ptr_doa, c, 1, step_e);
+			if (c == step)
 			{
-				ptr_doa->m_irxx_re[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] =  ptr_doa->m_irxx_out[i*ptr_doa->m_channels*2+2*j];
-				ptr_doa->m_irxx_im[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] =  ptr_doa->m_irxx_out[i*ptr_doa->m_channels*2+2*j+1];
+				break;
 			}
 		}
+		y = ptr_doa->m_capon_spectrum[c];
+		for (j = ptr_doa->m_peak_num; j > 0 && ptr_doa->m_capon_spectrum[peak[j - 1]] < y; j--)
+		{
+			peak[j] = peak[j - 1];
+		}
+		peak[j] = c;
+		ptr_doa->m_peak_num++;
 	}
 
-	memset(ptr_doa->m_capon_spectrum, 0, sizeof(float)*ptr_doa->m_angle_num);
-	for ( int n = 0; n < ptr_doa->m_frq_bin_num; ++n)
+	// 3. sub-grid directions, peaks next to a stronger one are the same source
+	cand_num = ptr_doa->m_peak_num;
+	ptr_doa->m_peak_num = 0;
+	for (i = 0; i < cand_num; i++)
 	{
-		int k = ptr_doa->m_doa_fid[n];
-		for ( int m = 0; m < ptr_doa->m_angle_num; ++m )
+		if (ptr_doa->m_capon_low[peak[i]] > top)
+		{
+			top = ptr_doa->m_capon_low[peak[i]];
+		}
+	}
+	for (i = 0; i < cand_num; i++)
+	{
+		dios_ssp_doa_interp(ptr_doa, peak[i], &angle, &elevation);
+		for (j = 0; j < ptr_doa->m_peak_num; j++)
+		{
+			if (dios_ssp_doa_arc(angle, elevation, ptr_doa->m_peak_angle[j], ptr_doa->m_peak_elev[j]) < DEFAULT_DOA_SOURCE_SEP)
+			{
+				break;
+			}
+		}
+		if (j < ptr_doa->m_peak_num)
+		{
+			continue;
+		}
+		y = ptr_doa->m_capon_low[peak[i]];
+		ptr_doa->m_peak_angle[ptr_doa->m_peak_num] = angle;
+		ptr_doa->m_peak_elev[ptr_doa->m_peak_num] = elevation;
+		ptr_doa->m_peak_conf[ptr_doa->m_peak_num] = y > floor_level && floor_level > 0.0f ? 
+			(1.0f - floor_level / top) * logf(y / floor_level) / logf(top / floor_level) : 0.0f;
+		ptr_doa->m_peak_num++;
+	}
+
+	return ptr_doa->m_peak_angle[0];
+}
+
+/* associate the peaks of the frame with the tracks, strongest peak first to the
+   nearest track inside DEFAULT_DOA_TRACK_GATE degrees of arc. a peak no track takes starts a
+   new one in a free slot, or replaces the least confident track if it is more
+   confident than it */
+static void dios_ssp_doa_track(objDOA *ptr_doa)
+{
+	objDOATrack *track = ptr_doa->m_track;
+	int used[DEFAULT_DOA_MAX_SOURCE_NUM] = {0};
+	int i, t, best;
+	float d, dist;
+	float conf;
+
+	for (i = 0; i < ptr_doa->m_peak_num; i++)
+	{
+		conf = ptr_doa->m_peak_conf[i];
+		if (conf < DEFAULT_DOA_SOURCE_MIN_CONF)
 		{
-			for (int i = 0; i < ptr_doa->m_channels; i++)
+			continue;
+		}
+		best = -1;
+		dist = DEFAULT_DOA_TRACK_GATE;
+		for (t = 0; t < DEFAULT_DOA_MAX_SOURCE_NUM; t++)
+		{
+			if (track[t].hit == 0 || used[t])
 			{
-				re_temp = im_temp = 0;
-				for (int j = 0; j < ptr_doa->m_channels; j++)
+				continue;
+			}
+			d = dios_ssp_doa_arc(ptr_doa->m_peak_angle[i], ptr_doa->m_peak_elev[i], track[t].angle, track[t].elevation);
+			if (d < dist)
+			{
+				dist = d;
+				best = t;
+			}
+		}
+		if (best < 0)
+		{
+			for (t = 0; t < DEFAULT_DOA_MAX_SOURCE_NUM; t++)
+			{
+				if (used[t])
+				{
+					continue;
+				}
+				if (best < 0 || track[t].hit == 0 || track[t].confidence < track[best].confidence)
+				{
+					best = t;
+				}
+				if (track[t].hit == 0)
 				{
-					re_temp += ptr_doa->m_irxx_re[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] * ptr_doa->m_gstv_re[m*ptr_doa->m_gstv_dim+k*ptr_doa->m_channels+j] 
-							- ptr_doa->m_irxx_im[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] * ptr_doa->m_gstv_im[m*ptr_doa->m_gstv_dim+k*ptr_doa->m_channels+j];
-					im_temp += ptr_doa->m_irxx_re[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] * ptr_doa->m_gstv_im[m*ptr_doa->m_gstv_dim+k*ptr_doa->m_channels+j] 
-							+ ptr_doa->m_irxx_im[k*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j] * ptr_doa->m_gstv_re[m*ptr_doa->m_gstv_dim+k*ptr_doa->m_channels+j];
+					break;
 				}
-				ptr_doa->m_vec_re[i] = re_temp;
-				ptr_doa->m_vec_im[i] = im_temp;
 			}
-			re_temp = im_temp = 0;
-			for (int i = 0; i < ptr_doa->m_channels; i++)
+			if (best < 0 || (track[best].hit > 0 && track[best].confidence >= conf))
 			{
-				re_temp += ptr_doa->m_gstv_re[m*ptr_doa->m_gstv_dim+k*ptr_doa->m_channels+i]*ptr_doa->m_vec_re[i] + ptr_doa->m_gstv_im[m*ptr_doa->m_gstv_dim+k*ptr_doa->m_channels+i]*ptr_doa->m_vec_im[i];
-				im_temp += ptr_doa->m_gstv_re[m*ptr_doa->m_gstv_dim+k*ptr_doa->m_channels+i]*ptr_doa->m_vec_im[i] - ptr_doa->m_gstv_im[m*ptr_doa->m_gstv_dim+k*ptr_doa->m_channels+i]*ptr_doa->m_vec_re[i];
+				continue;
 			}
-			ptr_doa->m_capon_spectrum[m] += ptr_doa->m_channels / re_temp;
+			track[best].angle = ptr_doa->m_peak_angle[i];
+			track[best].elevation = ptr_doa->m_peak_elev[i];
+			track[best].confidence = conf;
+			track[best].id = ptr_doa->m_track_id++;
+			track[best].hit = 0;
+		}
+		track[best].angle += DEFAULT_DOA_TRACK_ALPHA * dios_ssp_doa_angle_diff(ptr_doa->m_peak_angle[i], track[best].angle);
+		if (track[best].angle < 0.0f)
+		{
+			track[best].angle += 360.0f;
 		}
+		else if (track[best].angle >= 360.0f)
+		{
+			track[best].angle -= 360.0f;
+		}
+		track[best].elevation += DEFAULT_DOA_TRACK_ALPHA * (ptr_doa->m_peak_elev[i] - track[best].elevation);
+		track[best].confidence = DEFAULT_DOA_TRACK_BETA * track[best].confidence + (1.0f - DEFAULT_DOA_TRACK_BETA) * conf;
+		if (track[best].hit < DEFAULT_DOA_TRACK_CONFIRM)
+		{
+			track[best].hit++;
+		}
+		track[best].miss = 0;
+		used[best] = 1;
 	}
 
-	max_ind = 0;
-	max_spectrum = ptr_doa->m_capon_spectrum[0];
-	for ( int m = 1; m < ptr_doa->m_angle_num; ++m )
+	for (t = 0; t < DEFAULT_DOA_MAX_SOURCE_NUM; t++)
 	{
-		if ( ptr_doa->m_capon_spectrum[m] > max_spectrum )
+		if (track[t].hit == 0 || used[t])
+		{
+			continue;
+		}
+		track[t].confidence *= DEFAULT_DOA_TRACK_BETA;
+		if (++track[t].miss > DEFAULT_DOA_TRACK_HOLD)
 		{
-			max_ind = m;
-			max_spectrum = ptr_doa->m_capon_spectrum[m];
+			memset(&track[t], 0, sizeof(objDOATrack));
 		}
 	}
+}
 
-	if(vad_result == 1 || dt_st != 1)
+float dios_ssp_doa_process_api(void* ptr, float* in, int vad_result, int dt_st)
+{
+    objDOA* ptr_doa;
+	ptr_doa = (objDOA*)ptr;
+
+	for (int ch_idx = 0; ch_idx < ptr_doa->m_channels; ++ch_idx)
 	{
-		ptr_doa->m_angle_smooth = (float)(max_ind*ptr_doa->m_delta_angle);
+		for (int i = 0; i < ptr_doa->m_shift_size; ++i)
+		{
+			ptr_doa->m_mch_buffer[ch_idx][ptr_doa->m_fft_size - ptr_doa->m_shift_size + i] = in[ch_idx * ptr_doa->m_shift_size + i];
+		}
 	}	
 
+	// add ana window		
+	for (int ch_idx = 0; ch_idx < ptr_doa->m_channels; ++ch_idx )
+	{
+		dios_ssp_doa_win_add_ana_win(ptr_doa->doawin, ptr_doa->m_mch_buffer[ch_idx], ptr_doa->m_win_data+ch_idx*ptr_doa->m_fft_size);
+	}
+	// stft, only the analysed band is unpacked
+	for (int ch_idx = 0; ch_idx < ptr_doa->m_channels; ++ch_idx )
+	{
+		dios_ssp_share_rfft_process(ptr_doa->doa_fft, ptr_doa->m_win_data+ch_idx*ptr_doa->m_fft_size, ptr_doa->fft_out);
+		for (int i = ptr_doa->m_band_lo; i < ptr_doa->m_band_lo + ptr_doa->m_band_len; i++)
+		{
+			ptr_doa->m_re[i + ch_idx * ptr_doa->m_fft_size] = ptr_doa->fft_out[i];
+			ptr_doa->m_im[i + ch_idx * ptr_doa->m_fft_size] = (i == 0 || i == ptr_doa->m_fft_size / 2) ? 0.0f : -ptr_doa->fft_out[ptr_doa->m_fft_size - i];
+		}
+	}
+
 	for (int ch_idx = 0; ch_idx < ptr_doa->m_channels; ++ch_idx)
 	{
 		memmove(ptr_doa->m_mch_buffer[ch_idx], ptr_doa->m_mch_buffer[ch_idx] + ptr_doa->m_shift_size, sizeof(float) * (ptr_doa->m_fft_size - ptr_doa->m_shift_size));
 	}
 
+	return dios_ssp_doa_process_spectrum_api(ptr, ptr_doa->m_re, ptr_doa->m_im, vad_result, dt_st);
+}
+
+float dios_ssp_doa_process_spectrum_api(void* ptr, const float* re, const float* im, int vad_result, int dt_st)
+{
+	float angle;
+
+    objDOA* ptr_doa;
+	ptr_doa = (objDOA*)ptr;
+
+	dios_ssp_doa_cal_rxx(ptr_doa, re, im);
+
+	// smooth rxx over neighbouring bins, only the upper triangle is needed by the solver
+	for ( int n = 0; n < ptr_doa->m_frq_bin_num; ++n)
+	{
+		int k = ptr_doa->m_doa_fid[n];
+		float *avg_re = ptr_doa->m_rxx_avg_re + n*ptr_doa->m_rxx_size;
+		float *avg_im = ptr_doa->m_rxx_avg_im + n*ptr_doa->m_rxx_size;
+
+		memset( avg_re, 0, sizeof(float)*ptr_doa->m_rxx_size );
+		memset( avg_im, 0, sizeof(float)*ptr_doa->m_rxx_size );
+		for ( int i = 0; i < ptr_doa->m_channels; ++i)
+		{
+			for ( int j = i; j < ptr_doa->m_channels; ++j)
+			{
+				for( int m = 0; m < ptr_doa->m_frq_bin_width; ++m)
+				{
+					avg_re[i*ptr_doa->m_channels+j] += ptr_doa->m_rxx_re[(k-ptr_doa->m_band_lo-m+ptr_doa->m_frq_bin_width/2-1)*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j];
+					avg_im[i*ptr_doa->m_channels+j] += ptr_doa->m_rxx_im[(k-ptr_doa->m_band_lo-m+ptr_doa->m_frq_bin_width/2-1)*ptr_doa->m_rxx_size+i*ptr_doa->m_channels+j];
+				}
+				avg_re[i*ptr_doa->m_channels+j] /= ptr_doa->m_frq_bin_width;
+				avg_im[i*ptr_doa->m_channels+j] /= ptr_doa->m_frq_bin_width;
+			}
+		}
+	}
+	if (0 != dios_ssp_hermitian_inv_process(ptr_doa->doainv, ptr_doa->m_rxx_avg_re, ptr_doa->m_rxx_avg_im, 
+		ptr_doa->m_irxx_re, ptr_doa->m_irxx_im, ptr_doa->m_frq_bin_num))
+	{
+		// keep the previous direction
+		return ptr_doa->m_angle_smooth;
+	}
+
+	angle = dios_ssp_doa_search(ptr_doa);
+	dios_ssp_doa_track(ptr_doa);
+
+	if(vad_result == 1 || dt_st != 1)
+	{
+		ptr_doa->m_angle_smooth = angle;
+		ptr_doa->m_elev_smooth = ptr_doa->m_peak_elev[0];
+	}	
+
     return ptr_doa->m_angle_smooth;
 }
 
+float dios_ssp_doa_elevation_get(void* ptr)
+{
+	objDOA *ptr_doa = (objDOA*)ptr;
+
+	return ptr_doa->m_elev_smooth;
+}
+
+int dios_ssp_doa_source_get(void* ptr, DoaSource* source, int max_num)
+{
+	objDOA *ptr_doa = (objDOA*)ptr;
+	objDOATrack *track = ptr_doa->m_track;
+	int num = 0;
+	int i, t;
+
+	for (t = 0; t < DEFAULT_DOA_MAX_SOURCE_NUM; t++)
+	{
+		if (track[t].hit < DEFAULT_DOA_TRACK_CONFIRM || track[t].confidence < DEFAULT_DOA_SOURCE_MIN_CONF)
+		{
+			continue;
+		}
+		if (num == max_num && (num == 0 || track[t].confidence <= source[num - 1].confidence))
+		{
+			continue;
+		}
+		i = num < max_num ? num++ : num - 1;
+		for ( ; i > 0 && source[i - 1].confidence < track[t].confidence; i--)
+		{
+			source[i] = source[i - 1];
+		}
+		source[i].angle = track[t].angle;
+		source[i].elevation = track[t].elevation;
+		source[i].confidence = track[t].confidence;
+		source[i].id = track[t].id;
+	}
+
+	return num;
+}
+
 int dios_ssp_doa_uninit_api(void *ptr)
 {
     objDOA* ptr_doa;
@@ -328,7 +972,7 @@ int dios_ssp_doa_uninit_api(void *ptr)
 	int ret = 0;
 
 	dios_ssp_doa_win_delete(ptr_doa->doawin);
-    free(ptr_doa->doawin);
+    dios_ssp_share_free(ptr_doa->doawin);
 
 	ret = dios_ssp_share_rfft_uninit(ptr_doa->doa_fft);
 	if (0 != ret)
@@ -336,33 +980,35 @@ int dios_ssp_doa_uninit_api(void *ptr)
 		ptr_doa->doa_fft = NULL;
 	}
 
-	ret = dios_ssp_matrix_inv_delete(ptr_doa->doainv);
+	ret = dios_ssp_hermitian_inv_delete(ptr_doa->doainv);
 	if (0 != ret)
 	{
 		ptr_doa->doainv = NULL;
 	}
 	for (int i = 0; i < ptr_doa->m_channels; ++i )
 	{
-		free(ptr_doa->m_mch_buffer[i]);
-	}
-	free(ptr_doa->fft_out);
-	free(ptr_doa->m_win_data);
-	free(ptr_doa->m_re);
-	free(ptr_doa->m_im);
-	free(ptr_doa->m_mch_buffer);
-    free(ptr_doa->m_capon_spectrum);
-    free(ptr_doa->m_doa_fid);
-    free(ptr_doa->m_irxx_re);
-    free(ptr_doa->m_irxx_im);
-    free(ptr_doa->m_vec_re);
-    free(ptr_doa->m_vec_im);
-    free(ptr_doa->m_gstv_re);
-	free(ptr_doa->m_gstv_im);
-    free(ptr_doa->m_rxx_in);
-    free(ptr_doa->m_rxx_re);
-    free(ptr_doa->m_rxx_im);	
-	free(ptr_doa->m_irxx_out);	
-    free(ptr_doa);
+		dios_ssp_share_free(ptr_doa->m_mch_buffer[i]);
+	}
+	dios_ssp_share_free(ptr_doa->fft_out);
+	dios_ssp_share_free(ptr_doa->m_win_data);
+	dios_ssp_share_free(ptr_doa->m_re);
+	dios_ssp_share_free(ptr_doa->m_im);
+	dios_ssp_share_free(ptr_doa->m_mch_buffer);
+    dios_ssp_share_free(ptr_doa->m_capon_spectrum);
+    dios_ssp_share_free(ptr_doa->m_capon_low);
+    dios_ssp_share_free(ptr_doa->m_doa_fid);
+    dios_ssp_share_free(ptr_doa->m_irxx_re);
+    dios_ssp_share_free(ptr_doa->m_irxx_im);
+    dios_ssp_share_free(ptr_doa->m_vec_re);
+    dios_ssp_share_free(ptr_doa->m_vec_im);
+    dios_ssp_share_table_release(ptr_doa->table_pool, ptr_doa->m_gstv_re);
+    dios_ssp_share_free(ptr_doa->m_stv_re);
+    dios_ssp_share_free(ptr_doa->m_stv_im);
+    dios_ssp_share_free(ptr_doa->m_rxx_avg_re);
+    dios_ssp_share_free(ptr_doa->m_rxx_avg_im);
+    dios_ssp_share_free(ptr_doa->m_rxx_re);
+    dios_ssp_share_free(ptr_doa->m_rxx_im);	
+    dios_ssp_share_free(ptr_doa);
 
     return 0;
 }
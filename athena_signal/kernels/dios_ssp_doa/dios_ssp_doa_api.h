@@ -25,36 +25,66 @@ limitations under the License.
 #include "../dios_ssp_share/dios_ssp_share_rfft.h"
 #include "../dios_ssp_share/dios_ssp_share_cinv.h"
 
+typedef struct
+{
+	float	angle;
+	float	elevation;
+	float	confidence;
+	int		id;
+	int		hit;		// frames associated, up to DEFAULT_DOA_TRACK_CONFIRM, 0 for a free track
+	int		miss;		// frames since the last associated peak
+} objDOATrack;
+
 typedef struct
 {
 	int		m_fs;
 	float	m_eps;
 	int		m_channels;
-	int		m_delta_angle;
+	float	m_delta_angle;		// degrees between the grid angles
+	int		m_coarse_stride;	// grid angles between the points of the coarse pass
+	int		m_elev_num;			// grid elevations, 1 for the plane of the array only
+	float	m_elev_min;			// degrees, lowest grid elevation
+	float	m_delta_elev;		// degrees between the grid elevations
+	int		m_elev_stride;		// grid elevations between the rows of the coarse pass
+	int		m_grid_num;			// m_angle_num * m_elev_num, point e * m_angle_num + a
 	float	m_deta_fs;
 	int		m_fft_size;
 	int		m_sp_size;
 	int		m_shift_size;
 	int		m_angle_num;
     float	m_angle_smooth;
+	float	m_elev_smooth;
     int		m_frq_bin_num;
     float	m_low_frq;
 	float	m_high_frq;
 	int		m_frq_sp;
-    float	*m_capon_spectrum;
+    float	*m_capon_spectrum;	// of the grid points, -1 where the search did not evaluate it
+	float	*m_capon_low;		// the same over the first m_alias_bin_num bins
+	int		m_alias_bin_num;	// analysed bins below the spatial aliasing frequency of the array
+	int		m_peak_num;		// peaks of the current frame, strongest first
+	float	m_peak_angle[DEFAULT_DOA_MAX_SOURCE_NUM];
+	float	m_peak_elev[DEFAULT_DOA_MAX_SOURCE_NUM];
+	float	m_peak_conf[DEFAULT_DOA_MAX_SOURCE_NUM];
+	objDOATrack m_track[DEFAULT_DOA_MAX_SOURCE_NUM];
+	int		m_track_id;		// id of the next track
     int     *m_doa_fid;
+    int		m_fid_step;		// smallest step between the m_doa_fid bins
     int		m_low_fid;
+    int		m_band_lo;		// first bin read by the rxx smoothing
+    int		m_band_len;		// bins m_band_lo ~ m_band_lo + m_band_len - 1 are analysed
     float	*m_irxx_re;
 	float	*m_irxx_im;
     float	*m_vec_re;
 	float	*m_vec_im;
-    float	*m_gstv_re;
-	float	*m_gstv_im;
+    const float	*m_gstv_re;		// grid steering vectors of the m_doa_fid bins, a table of the table pool,
+	const float	*m_gstv_im;		// NULL if larger than DEFAULT_DOA_STV_TABLE_SIZE
+	float	*m_stv_re;			// steering vector of one grid point when there is no table
+	float	*m_stv_im;
     int		m_frq_bin_width;
     // rxx  
 	int		m_rxx_size;
-    float	*m_rxx_in;
-    float	*m_irxx_out;
+    float	*m_rxx_avg_re;
+    float	*m_rxx_avg_im;
     float	*m_rxx_re;
 	float	*m_rxx_im;
 	float	*m_re;
@@ -70,6 +100,7 @@ typedef struct
     objDOACwin *doawin;
 	void *doa_fft;
 	float	**m_mch_buffer;	
+	void	*table_pool;
 }objDOA;
 
 /**********************************************************************************
@@ -77,11 +108,25 @@ Function:      // dios_ssp_doa_init_api
 Description:   // doa init
 Input:         // sensor_num: microphone number
 				  cood: micphone coordinate
+				  sample_rate: sampling rate in Hz, the window and shift are
+				  DEFAULT_DOA_WIN_SIZE and DEFAULT_DOA_SHIFT_SIZE scaled by
+				  sample_rate / DEFAULT_DOA_SAMPLING_FRQ
+				  resolution: grid of the direction search in degrees, rounded
+				  so that it divides 360, 0 for DEFAULT_DOA_RESOLUTION. the
+				  result is interpolated between the grid angles
+				  elevation_min, elevation_max: range of the search in degrees
+				  above the x-y plane of the coordinates, -90 ~ 90, searched
+				  at about the same resolution. both 0 for azimuth only, the
+				  array has to extend along z to resolve the elevation
+				  table_pool: pool of read-only tables shared with other
+				  instances, the steering vectors are shared by instances of
+				  the same array, NULL for private tables
 Output:        // none
 Return:        // success: return doa object pointer (void*)ptr_doa
 				  failure: return NULL
 **********************************************************************************/
-void* dios_ssp_doa_init_api(int mic_num, PlaneCoord* mic_coord);
+void* dios_ssp_doa_init_api(int mic_num, PlaneCoord* mic_coord, int sample_rate, float resolution, 
+	float elevation_min, float elevation_max, void* table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_doa_reset_api
@@ -104,6 +149,48 @@ Return:        // success: return doa result
 **********************************************************************************/
 float dios_ssp_doa_process_api(void* ptr, float* in, int vad_result, int dt_st);
 
+/**********************************************************************************
+Function:      // dios_ssp_doa_process_spectrum_api
+Description:   // doa process on the stft computed by the caller, the analysis
+				  window and fft must be the same as dios_ssp_doa_process_api,
+				  i.e. hamming window of m_fft_size points and m_shift_size
+				  shift (DEFAULT_DOA_WIN_SIZE and DEFAULT_DOA_SHIFT_SIZE at 16kHz)
+Input:         // ptr
+			   // re: real part of the spectrum, re[ch*m_fft_size+k]
+			   // im: imag part of the spectrum, im[ch*m_fft_size+k]
+			   //     k = 0 ~ m_fft_size/2, only the bins m_band_lo ~
+			   //     m_band_lo + m_band_len - 1 are read
+			   // vad_result: vad result
+			   // dt_st: double talk result
+Output:        // none
+Return:        // success: return doa result
+**********************************************************************************/
+float dios_ssp_doa_process_spectrum_api(void* ptr, const float* re, const float* im, int vad_result, int dt_st);
+
+/**********************************************************************************
+Function:      // dios_ssp_doa_elevation_get
+Description:   // elevation of the direction returned by the last process call
+Input:         // ptr
+Output:        // none
+Return:        // elevation in degrees, 0 for azimuth only
+**********************************************************************************/
+float dios_ssp_doa_elevation_get(void* ptr);
+
+/**********************************************************************************
+Function:      // dios_ssp_doa_source_get
+Description:   // sources tracked over the processed frames. up to
+				  DEFAULT_DOA_MAX_SOURCE_NUM peaks of the Capon spectrum are
+				  picked every frame regardless of the vad, and associated with
+				  the tracks by direction. a track is reported once it has been
+				  associated DEFAULT_DOA_TRACK_CONFIRM times and dropped after
+				  DEFAULT_DOA_TRACK_HOLD frames without a peak
+Input:         // ptr
+			   // max_num: size of source
+Output:        // source: the sources, most confident first
+Return:        // number of sources written
+**********************************************************************************/
+int dios_ssp_doa_source_get(void* ptr, DoaSource* source, int max_num);
+
 /**********************************************************************************
 Function:      // dios_ssp_doa_uninit_api
 Description:   // doa free
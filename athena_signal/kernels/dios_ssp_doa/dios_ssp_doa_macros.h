@@ -22,7 +22,18 @@ limitations under the License.
 #define	DEFAULT_DOA_SAMPLING_FRQ	16000
 #define	DEFAULT_DOA_WIN_SIZE		512
 #define	DEFAULT_DOA_SHIFT_SIZE		128
-#define	DEFAULT_DOA_DELTA_ANGLE		5
+#define	DEFAULT_DOA_RESOLUTION		(1.0f)	/* degrees, grid of the direction search */
+#define	DEFAULT_DOA_COARSE_ANGLE	(10.0f)	/* degrees, step of the coarse pass */
+#define	DEFAULT_DOA_STV_TABLE_SIZE	(1 << 20)	/* bytes, steering vectors of larger grids are computed per evaluation */
+#define	DEFAULT_DOA_MAX_SOURCE_NUM	4		/* coarse peaks refined to the grid and tracked */
+#define	DEFAULT_DOA_SOURCE_SEP		(20.0f)	/* degrees, weaker peaks closer to a source are dropped */
+#define	DEFAULT_DOA_SOURCE_MIN_CONF	(0.3f)	/* peaks of lower confidence are no source */
+#define	DEFAULT_DOA_TRACK_GATE		(15.0f)	/* degrees, farthest peak a track is associated with */
+#define	DEFAULT_DOA_TRACK_ALPHA		(0.2f)	/* weight of the associated peak in the track direction */
+#define	DEFAULT_DOA_TRACK_BETA		(0.95f)	/* smoothing of the track confidence */
+#define	DEFAULT_DOA_TRACK_CONFIRM	5		/* frames associated before a track is reported */
+#define	DEFAULT_DOA_TRACK_HOLD		50		/* frames without a peak before a track is dropped */
+#define	DEFAULT_DOA_MIN_ANGLE_NUM	4
 #define	DEFAULT_DOA_LOW_FRQ			2000
 #define	DEFAULT_DOA_HIGH_FRQ		6000
 #define	DEFAULT_DOA_FRQ_SP			200
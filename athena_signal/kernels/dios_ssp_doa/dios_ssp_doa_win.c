@@ -18,69 +18,74 @@ Description: Analysis window and synthesis window of DOA
 
 #include "dios_ssp_doa_win.h" 
 
-void dios_ssp_doa_win_init(objDOACwin *doawin,int fft_size, int shift_size)
+/* ShareTableBuild of the analysis and normalization windows, arg is the window being initialized */
+static int dios_ssp_doa_win_build(void *table, const void *arg)
 {
     int i, j;
-	int tmp;
-	int log_fft_size = 0;
 	float temp;
-	tmp = 1;
+	const objDOACwin *doawin = (const objDOACwin*)arg;
+	float *ana_win = (float*)table;
+	float *norm_win = ana_win + doawin->m_fft_size;
 
-	doawin->m_fft_size = fft_size;
-	doawin->m_shift_size = shift_size;
-
-	if ( doawin->m_shift_size >= doawin->m_fft_size )
-	{
-		printf( "shift_size[%d] >= fft_size[%d].\n", doawin->m_shift_size, doawin->m_fft_size );
-	}
-
-	while ( tmp < doawin->m_fft_size )
-	{
-		log_fft_size += 1;
-		tmp *= 2;
-	}
-	if ( tmp > doawin->m_fft_size )
-	{
-		printf( "FFT Size[%d] should be power of 2.\n", doawin->m_fft_size );
-	}
-	tmp = 1;
-	while ( tmp < doawin->m_shift_size )
-	{
-		tmp *= 2;
-	}
-	if ( tmp > doawin->m_shift_size )
-	{
-		printf( "Shift Size[%d] should be power of 2.\n", doawin->m_shift_size );
-	}
-
-	doawin->m_block_num = doawin->m_fft_size / doawin->m_shift_size;
-	doawin->m_ana_win = (float*)calloc(doawin->m_fft_size, sizeof(float));
-	doawin->m_norm_win = (float*)calloc(doawin->m_fft_size, sizeof(float));
-	
     for (i = 0; i < doawin->m_fft_size; ++i )
     {
-        doawin->m_ana_win[i] = (float)(0.54 - 0.46*cos((2*i)*PI/(doawin->m_fft_size-1)));
+        ana_win[i] = (float)(0.54 - 0.46*cos((2*i)*PI/(doawin->m_fft_size-1)));
     }
     for (i = 0; i < doawin->m_fft_size; ++i )
     {
-        doawin->m_norm_win[i] = doawin->m_ana_win[i] * doawin->m_ana_win[i];
+        norm_win[i] = ana_win[i] * ana_win[i];
     }
     for (i = 0; i < doawin->m_shift_size; ++i )
     {
         temp = 0;
         for (j = 0; j < doawin->m_block_num; ++j )
         {
-            temp += doawin->m_norm_win[i+j*doawin->m_shift_size];
+            temp += norm_win[i+j*doawin->m_shift_size];
         }
-        doawin->m_norm_win[i] = 1.0f / temp;
+        norm_win[i] = 1.0f / temp;
     }
     for (i = 0; i < doawin->m_shift_size; ++i )
     {
         for (j = 1; j < doawin->m_block_num; ++j )
         {
-            doawin->m_norm_win[i+j*doawin->m_shift_size] = doawin->m_norm_win[i];
+            norm_win[i+j*doawin->m_shift_size] = norm_win[i];
         }
     }
+
+	return 0;
+}
+
+void dios_ssp_doa_win_init(objDOACwin *doawin,int fft_size, int shift_size, void *table_pool)
+{
+	int key[2];
+
+	doawin->m_fft_size = fft_size;
+	doawin->m_shift_size = shift_size;
+
+	if ( doawin->m_shift_size >= doawin->m_fft_size )
+	{
+		printf( "shift_size[%d] >= fft_size[%d].\n", doawin->m_shift_size, doawin->m_fft_size );
+	}
+
+	/* the rfft takes 2^k or 3*2^k points, the overlap-add needs whole shifts */
+	if ( doawin->m_fft_size % doawin->m_shift_size != 0 )
+	{
+		printf( "FFT Size[%d] should be a multiple of Shift Size[%d].\n", doawin->m_fft_size, doawin->m_shift_size );
+	}
+
+	doawin->m_block_num = doawin->m_fft_size / doawin->m_shift_size;
+	
+	key[0] = doawin->m_fft_size;
+	key[1] = doawin->m_shift_size;
+	doawin->table_pool = table_pool;
+	doawin->m_ana_win = (const float*)dios_ssp_share_table_get(table_pool, "doa_win", key, sizeof(key), 
+		2 * doawin->m_fft_size * sizeof(float), dios_ssp_doa_win_build, doawin);
+	if (doawin->m_ana_win == NULL)
+	{
+		printf( "doa window table init error!\n" );
+		return;
+	}
+	doawin->m_norm_win = doawin->m_ana_win + doawin->m_fft_size;
 }
 
 int dios_ssp_doa_win_add_ana_win(objDOACwin *doawin, const float *x, float *x_win)
@@ -96,8 +101,7 @@ int dios_ssp_doa_win_add_ana_win(objDOACwin *doawin, const float *x, float *x_wi
 
 int dios_ssp_doa_win_delete(objDOACwin *doawin)
 {
-	free(doawin->m_ana_win);
-	free(doawin->m_norm_win);
+	dios_ssp_share_table_release(doawin->table_pool, doawin->m_ana_win);
 
 	return 0;
 }
@@ -22,6 +22,7 @@ limitations under the License.
 #include <math.h>
 #include <string.h>
 #include "dios_ssp_doa_macros.h"
+#include "../dios_ssp_share/dios_ssp_share_table.h"
 
 typedef struct
 {
@@ -29,8 +30,10 @@ typedef struct
 	int m_shift_size;
 	int m_block_num;
 	
-	float *m_ana_win;
-	float *m_norm_win;
+	/* windows live in one table of the table pool */
+	const float *m_ana_win;
+	const float *m_norm_win;
+	void *table_pool;
 }objDOACwin;
 
 /**********************************************************************************
@@ -39,11 +42,12 @@ Description:   // doa win init
 Input:         // doawin
 				  fft_size
 				  shift_size
+				  table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return doa win object pointer (void*)doawin
 				  failure: return NULL
 **********************************************************************************/
-void dios_ssp_doa_win_init(objDOACwin *doawin,int fft_size, int shift_size);
+void dios_ssp_doa_win_init(objDOACwin *doawin,int fft_size, int shift_size, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_doa_win_add_ana_win
@@ -20,9 +20,10 @@ AIC. The time delay ensures causality of the adaptive filters.
 ==============================================================================*/
 
 #include "dios_ssp_gsc_abm.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
 void dios_ssp_gsc_gscabm_init(objFGSCabm *gscabm, int num_mic, int fft_size, int overlap_sigs, int overlap_fft, int dlysync, float forgetfactor, float stepsize, 
-            float threshdiv0, long rate, float tconst_freezing)
+            float threshdiv0, long rate, float tconst_freezing, void *table_pool)
 {
 	gscabm->Xdline = NULL;
 	gscabm->xrefdline = NULL;
@@ -53,40 +54,40 @@ void dios_ssp_gsc_gscabm_init(objFGSCabm *gscabm, int num_mic, int fft_size, int
 	gscabm->nu.i = 0.f;
 	gscabm->syncdly = dlysync;
 	gscabm->count_sigsegments = 0;
-	gscabm->Xdline = (float**)calloc(gscabm->nmic, sizeof(float*));
+	gscabm->Xdline = (float**)dios_ssp_share_calloc_ptr(gscabm->nmic, sizeof(float*));
 	for (int i_mic = 0; i_mic < gscabm->nmic; i_mic++)
 	{
-		gscabm->Xdline[i_mic] = (float*)calloc(gscabm->fftsize, sizeof(float));
+		gscabm->Xdline[i_mic] = (float*)dios_ssp_share_calloc(gscabm->fftsize, sizeof(float));
 	}
-	gscabm->xrefdline = (float*)calloc(gscabm->fftsize / 2 + gscabm->syncdly, sizeof(float));
-	gscabm->xfref = (xcomplex*)calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
-	gscabm->ytmp = (float*)calloc(gscabm->fftsize, sizeof(float));
-	gscabm->yf = (xcomplex*)calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
-	gscabm->e = (float*)calloc(gscabm->fftsize, sizeof(float));
-	gscabm->E = (float**)calloc(gscabm->nmic, sizeof(float*));
+	gscabm->xrefdline = (float*)dios_ssp_share_calloc(gscabm->fftsize / 2 + gscabm->syncdly, sizeof(float));
+	gscabm->xfref = (xcomplex*)dios_ssp_share_calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
+	gscabm->ytmp = (float*)dios_ssp_share_calloc(gscabm->fftsize, sizeof(float));
+	gscabm->yf = (xcomplex*)dios_ssp_share_calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
+	gscabm->e = (float*)dios_ssp_share_calloc(gscabm->fftsize, sizeof(float));
+	gscabm->E = (float**)dios_ssp_share_calloc_ptr(gscabm->nmic, sizeof(float*));
 	for (int i_mic = 0; i_mic < gscabm->nmic; i_mic++)
 	{
-		gscabm->E[i_mic] = (float*)calloc(gscabm->fftsize / (2 * gscabm->fftoverlap), sizeof(float));
+		gscabm->E[i_mic] = (float*)dios_ssp_share_calloc(gscabm->fftsize / (2 * gscabm->fftoverlap), sizeof(float));
 	}
-	gscabm->ef = (xcomplex*)calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
-	gscabm->muf = (xcomplex*)calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
-	gscabm->nuf = (xcomplex*)calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
-	gscabm->yftmp = (xcomplex*)calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
-	gscabm->pxfref = (float*)calloc(gscabm->fftsize / 2 + 1, sizeof(float));
-	gscabm->sf = (float**)calloc(gscabm->nmic, sizeof(float*));
+	gscabm->ef = (xcomplex*)dios_ssp_share_calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
+	gscabm->muf = (xcomplex*)dios_ssp_share_calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
+	gscabm->nuf = (xcomplex*)dios_ssp_share_calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
+	gscabm->yftmp = (xcomplex*)dios_ssp_share_calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
+	gscabm->pxfref = (float*)dios_ssp_share_calloc(gscabm->fftsize / 2 + 1, sizeof(float));
+	gscabm->sf = (float**)dios_ssp_share_calloc_ptr(gscabm->nmic, sizeof(float*));
 	for (int i_mic = 0; i_mic < gscabm->nmic; i_mic++)
 	{
-		gscabm->sf[i_mic] = (float*)calloc(gscabm->fftsize / 2 + 1, sizeof(float));
+		gscabm->sf[i_mic] = (float*)dios_ssp_share_calloc(gscabm->fftsize / 2 + 1, sizeof(float));
 	}
-	gscabm->pftmp = (float*)calloc(gscabm->fftsize / 2 + 1, sizeof(float));
-	gscabm->hf = (xcomplex**)calloc(gscabm->nmic, sizeof(xcomplex*));
+	gscabm->pftmp = (float*)dios_ssp_share_calloc(gscabm->fftsize / 2 + 1, sizeof(float));
+	gscabm->hf = (xcomplex**)dios_ssp_share_calloc_ptr(gscabm->nmic, sizeof(xcomplex*));
 	for (int i_mic = 0; i_mic < gscabm->nmic; i_mic++)
 	{
-		gscabm->hf[i_mic] = (xcomplex*)calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
+		gscabm->hf[i_mic] = (xcomplex*)dios_ssp_share_calloc(gscabm->fftsize / 2 + 1, sizeof(xcomplex));
 	}
 
-	gscabm->m_upper_bound = (float*)calloc(gscabm->fftsize / 2, sizeof(float));
-	gscabm->m_lower_bound = (float*)calloc(gscabm->fftsize / 2, sizeof(float));
+	gscabm->m_upper_bound = (float*)dios_ssp_share_calloc(gscabm->fftsize / 2, sizeof(float));
+	gscabm->m_lower_bound = (float*)dios_ssp_share_calloc(gscabm->fftsize / 2, sizeof(float));
 
     float deltax = 0.001f;
 	for (int i = 0; i < gscabm->fftsize / 2; i++)
@@ -112,9 +113,9 @@ void dios_ssp_gsc_gscabm_init(objFGSCabm *gscabm, int num_mic, int fft_size, int
 		gscabm->m_upper_bound[gscabm->fftsize / 4 + 3] = 0.1f;
         gscabm->m_upper_bound[gscabm->fftsize / 4 - 3] = 0.1f;
 	}
-	gscabm->abm_FFT =dios_ssp_share_rfft_init(gscabm->fftsize);
-	gscabm->fft_out = (float*)calloc(gscabm->fftsize, sizeof(float));
-	gscabm->fft_in = (float*)calloc(gscabm->fftsize, sizeof(float));
+	gscabm->abm_FFT =dios_ssp_share_rfft_init_pool(gscabm->fftsize, table_pool);
+	gscabm->fft_out = (float*)dios_ssp_share_calloc(gscabm->fftsize, sizeof(float));
+	gscabm->fft_in = (float*)dios_ssp_share_calloc(gscabm->fftsize, sizeof(float));
 
 	/* initialize ABM with coefficients for desired signal from steering 
      * direction and acoustic free-field condition */
@@ -424,39 +425,39 @@ int dios_ssp_gsc_gscabm_delete(objFGSCabm *gscabm)
 	int ret = 0;
 	for (int i_mic = 0; i_mic < gscabm->nmic; i_mic++)
 	{
-		free(gscabm->Xdline[i_mic]);
+		dios_ssp_share_free(gscabm->Xdline[i_mic]);
 	}
-	free(gscabm->Xdline);
-	free(gscabm->xrefdline);
-	free(gscabm->xfref);
-	free(gscabm->ytmp);
-	free(gscabm->yf);
-	free(gscabm->e);
+	dios_ssp_share_free(gscabm->Xdline);
+	dios_ssp_share_free(gscabm->xrefdline);
+	dios_ssp_share_free(gscabm->xfref);
+	dios_ssp_share_free(gscabm->ytmp);
+	dios_ssp_share_free(gscabm->yf);
+	dios_ssp_share_free(gscabm->e);
 	for (int i_mic = 0; i_mic < gscabm->nmic; i_mic++)
 	{
-		free(gscabm->E[i_mic]);
+		dios_ssp_share_free(gscabm->E[i_mic]);
 	}
-	free(gscabm->E);
-	free(gscabm->ef);
-	free(gscabm->muf);
-	free(gscabm->nuf);
-	free(gscabm->yftmp);
-	free(gscabm->pxfref);
+	dios_ssp_share_free(gscabm->E);
+	dios_ssp_share_free(gscabm->ef);
+	dios_ssp_share_free(gscabm->muf);
+	dios_ssp_share_free(gscabm->nuf);
+	dios_ssp_share_free(gscabm->yftmp);
+	dios_ssp_share_free(gscabm->pxfref);
 	for (int i_mic = 0; i_mic < gscabm->nmic; i_mic++)
 	{
-		free(gscabm->sf[i_mic]);
+		dios_ssp_share_free(gscabm->sf[i_mic]);
 	}
-	free(gscabm->sf);
-	free(gscabm->pftmp);
+	dios_ssp_share_free(gscabm->sf);
+	dios_ssp_share_free(gscabm->pftmp);
 	for (int i_mic = 0; i_mic < gscabm->nmic; i_mic++)
 	{
-		free(gscabm->hf[i_mic]);
+		dios_ssp_share_free(gscabm->hf[i_mic]);
 	}
-	free(gscabm->hf);
-	free(gscabm->m_upper_bound);
-	free(gscabm->m_lower_bound);
-	free(gscabm->fft_out);
-	free(gscabm->fft_in);
+	dios_ssp_share_free(gscabm->hf);
+	dios_ssp_share_free(gscabm->m_upper_bound);
+	dios_ssp_share_free(gscabm->m_lower_bound);
+	dios_ssp_share_free(gscabm->fft_out);
+	dios_ssp_share_free(gscabm->fft_in);
 	ret = dios_ssp_share_rfft_uninit(gscabm->abm_FFT);
 	if (0 != ret)
 	{
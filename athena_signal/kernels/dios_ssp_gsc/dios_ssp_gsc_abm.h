@@ -78,13 +78,14 @@ Input:         // num_mic: number of sensors
 									of adaptive filters, prevents freezing of adaptive 
 									filters and improves interference suppression 
 									during periods without desired signal activity 
+					table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return adaptive blocking matrix object pointer
 Others:        // none
 **********************************************************************************/
 void dios_ssp_gsc_gscabm_init(objFGSCabm *gscabm, int num_mic, int fft_size, int overlap_sigs, int overlap_fft, 
             int dlysync, float forgetfactor, float stepsize, 
-            float threshdiv0, long rate, float tconst_freezing);
+            float threshdiv0, long rate, float tconst_freezing, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_gsc_gscabm_initabmfreefield
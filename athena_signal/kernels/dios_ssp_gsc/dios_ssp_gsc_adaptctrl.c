@@ -28,12 +28,26 @@ to obtain better robustness in turn.
 ==============================================================================*/
 
 #include "dios_ssp_gsc_adaptctrl.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
+
+static const size_t g_gsc_npsdosms_ptr[] = {
+	offsetof(objCNPsdOsMs, m_P), offsetof(objCNPsdOsMs, m_N),
+	offsetof(objCNPsdOsMs, m_alpha), offsetof(objCNPsdOsMs, m_temp),
+	offsetof(objCNPsdOsMs, m_beta), offsetof(objCNPsdOsMs, m_P1m),
+	offsetof(objCNPsdOsMs, m_P2m), offsetof(objCNPsdOsMs, m_varP),
+	offsetof(objCNPsdOsMs, m_Qeq), offsetof(objCNPsdOsMs, m_sQeq),
+	offsetof(objCNPsdOsMs, m_sQeqSub), offsetof(objCNPsdOsMs, m_Bmin),
+	offsetof(objCNPsdOsMs, m_Bmin_sub), offsetof(objCNPsdOsMs, m_k_mod),
+	offsetof(objCNPsdOsMs, m_lmin_flag), offsetof(objCNPsdOsMs, m_actmin),
+	offsetof(objCNPsdOsMs, m_actmin_sub), offsetof(objCNPsdOsMs, m_Pmin_u),
+	offsetof(objCNPsdOsMs, m_store)
+};
 
 void dios_ssp_gsc_gscadaptctrl_init(objFGSCadaptctrl *gscadaptctrl, const DWORD dwSampRate, const WORD wNumMic, const WORD wSyncDlyXref, 
             const WORD wSyncDlyYfbf, const WORD wSyncDlyAic, const DWORD dwFftSize, 
             const WORD wFftOverlap, const DWORD dwF0, const DWORD dwF1, const DWORD dwFc, 
             const float corrThresAbm, const float corrThresAic, 
-            const int dwNumSubWindowsMinStat, const int dwSizeSubWindowsMinStat)
+            const int dwNumSubWindowsMinStat, const int dwSizeSubWindowsMinStat, void *table_pool)
 {
 	gscadaptctrl->m_pfBuffer = NULL;
 	gscadaptctrl->m_ppXrefDline = NULL;
@@ -65,36 +79,36 @@ void dios_ssp_gsc_gscadaptctrl_init(objFGSCadaptctrl *gscadaptctrl, const DWORD
 
 	gscadaptctrl->m_delta = 0.001f;
 
-	gscadaptctrl->npsdosms1 =  (objCNPsdOsMs*)calloc(1, sizeof(objCNPsdOsMs));
+	gscadaptctrl->npsdosms1 =  (objCNPsdOsMs*)dios_ssp_share_calloc_map(1, sizeof(objCNPsdOsMs), g_gsc_npsdosms_ptr, SHARE_ARENA_MAP_NUM(g_gsc_npsdosms_ptr));
 	dios_ssp_gsc_rmnpsdosms_init(gscadaptctrl->npsdosms1, (float)(gscadaptctrl->m_dwSampRate), gscadaptctrl->m_nCCSSize, (int)(gscadaptctrl->m_dwFftSize / gscadaptctrl->m_wFftOverlap), dwNumSubWindowsMinStat, dwSizeSubWindowsMinStat);
-	gscadaptctrl->npsdosms2 =  (objCNPsdOsMs*)calloc(1, sizeof(objCNPsdOsMs));
+	gscadaptctrl->npsdosms2 =  (objCNPsdOsMs*)dios_ssp_share_calloc_map(1, sizeof(objCNPsdOsMs), g_gsc_npsdosms_ptr, SHARE_ARENA_MAP_NUM(g_gsc_npsdosms_ptr));
 	dios_ssp_gsc_rmnpsdosms_init(gscadaptctrl->npsdosms2, (float)(gscadaptctrl->m_dwSampRate), gscadaptctrl->m_nCCSSize, (int)(gscadaptctrl->m_dwFftSize / gscadaptctrl->m_wFftOverlap), dwNumSubWindowsMinStat, dwSizeSubWindowsMinStat);
 
-	gscadaptctrl->adapt_FFT = dios_ssp_share_rfft_init((int)gscadaptctrl->m_dwFftSize);
-	gscadaptctrl->fft_out = (float*)calloc(gscadaptctrl->m_dwFftSize, sizeof(float));
-	gscadaptctrl->m_ppXrefDline = (float**)calloc(gscadaptctrl->m_wNumMic, sizeof(float*));
+	gscadaptctrl->adapt_FFT = dios_ssp_share_rfft_init_pool((int)gscadaptctrl->m_dwFftSize, table_pool);
+	gscadaptctrl->fft_out = (float*)dios_ssp_share_calloc(gscadaptctrl->m_dwFftSize, sizeof(float));
+	gscadaptctrl->m_ppXrefDline = (float**)dios_ssp_share_calloc_ptr(gscadaptctrl->m_wNumMic, sizeof(float*));
 	for (int i_mic = 0; i_mic < gscadaptctrl->m_wNumMic; i_mic++)
 	{
-		gscadaptctrl->m_ppXrefDline[i_mic] = (float*)calloc(gscadaptctrl->m_dwFftSize + gscadaptctrl->m_wSyncDlyXref, sizeof(float));
+		gscadaptctrl->m_ppXrefDline[i_mic] = (float*)dios_ssp_share_calloc(gscadaptctrl->m_dwFftSize + gscadaptctrl->m_wSyncDlyXref, sizeof(float));
 	}
-	gscadaptctrl->m_pXfbfDline = (float*)calloc(gscadaptctrl->m_dwFftSize + gscadaptctrl->m_wSyncDlyYfbf, sizeof(float));
-	gscadaptctrl->m_ppcfXref = (xcomplex**)calloc(gscadaptctrl->m_wNumMic, sizeof(xcomplex*));
+	gscadaptctrl->m_pXfbfDline = (float*)dios_ssp_share_calloc(gscadaptctrl->m_dwFftSize + gscadaptctrl->m_wSyncDlyYfbf, sizeof(float));
+	gscadaptctrl->m_ppcfXref = (xcomplex**)dios_ssp_share_calloc_ptr(gscadaptctrl->m_wNumMic, sizeof(xcomplex*));
 	for (int i_mic = 0; i_mic < gscadaptctrl->m_wNumMic; i_mic++)
 	{
-		gscadaptctrl->m_ppcfXref[i_mic] = (xcomplex*)calloc(gscadaptctrl->m_nCCSSize, sizeof(xcomplex));
+		gscadaptctrl->m_ppcfXref[i_mic] = (xcomplex*)dios_ssp_share_calloc(gscadaptctrl->m_nCCSSize, sizeof(xcomplex));
 	}
-	gscadaptctrl->m_pcfXfbf = (xcomplex*)calloc(gscadaptctrl->m_nCCSSize, sizeof(xcomplex));
-	gscadaptctrl->m_pcfXcfbf = (xcomplex*)calloc(gscadaptctrl->m_nCCSSize, sizeof(xcomplex));						
-	gscadaptctrl->m_pfPcfbf = (float*)calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
-	gscadaptctrl->m_pfPfbf = (float*)calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
-	gscadaptctrl->m_pfPref = (float*)calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
-	gscadaptctrl->m_pfBeta = (float*)calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
-	gscadaptctrl->m_pfBetaC = (float*)calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
-	gscadaptctrl->m_pfBuffer = (float*)calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
-	gscadaptctrl->m_ppfCtrlAicDline = (float**)calloc(gscadaptctrl->m_wSyncDlyCtrlAic + 1, sizeof(float*));
+	gscadaptctrl->m_pcfXfbf = (xcomplex*)dios_ssp_share_calloc(gscadaptctrl->m_nCCSSize, sizeof(xcomplex));
+	gscadaptctrl->m_pcfXcfbf = (xcomplex*)dios_ssp_share_calloc(gscadaptctrl->m_nCCSSize, sizeof(xcomplex));						
+	gscadaptctrl->m_pfPcfbf = (float*)dios_ssp_share_calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
+	gscadaptctrl->m_pfPfbf = (float*)dios_ssp_share_calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
+	gscadaptctrl->m_pfPref = (float*)dios_ssp_share_calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
+	gscadaptctrl->m_pfBeta = (float*)dios_ssp_share_calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
+	gscadaptctrl->m_pfBetaC = (float*)dios_ssp_share_calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
+	gscadaptctrl->m_pfBuffer = (float*)dios_ssp_share_calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
+	gscadaptctrl->m_ppfCtrlAicDline = (float**)dios_ssp_share_calloc_ptr(gscadaptctrl->m_wSyncDlyCtrlAic + 1, sizeof(float*));
 	for (int i = 0; i < gscadaptctrl->m_wSyncDlyCtrlAic + 1; i++)
 	{
-		gscadaptctrl->m_ppfCtrlAicDline[i] = (float*)calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
+		gscadaptctrl->m_ppfCtrlAicDline[i] = (float*)dios_ssp_share_calloc(gscadaptctrl->m_nCCSSize, sizeof(float));
 	}
 }
 
@@ -313,10 +327,10 @@ int dios_ssp_gsc_gscadaptctrl_delete(objFGSCadaptctrl *gscadaptctrl)
 {
 	int ret = 0;
 	dios_ssp_gsc_rmnpsdosms_delete(gscadaptctrl->npsdosms1);
-	free(gscadaptctrl->npsdosms1);
+	dios_ssp_share_free(gscadaptctrl->npsdosms1);
 	dios_ssp_gsc_rmnpsdosms_delete(gscadaptctrl->npsdosms2);
-	free(gscadaptctrl->npsdosms2);
-	free(gscadaptctrl->fft_out);
+	dios_ssp_share_free(gscadaptctrl->npsdosms2);
+	dios_ssp_share_free(gscadaptctrl->fft_out);
 	ret = dios_ssp_share_rfft_uninit(gscadaptctrl->adapt_FFT);
 	if (0 != ret)
 	{
@@ -324,28 +338,28 @@ int dios_ssp_gsc_gscadaptctrl_delete(objFGSCadaptctrl *gscadaptctrl)
 	}
 	for (int i_mic = 0; i_mic < gscadaptctrl->m_wNumMic; i_mic++)
 	{
-		free(gscadaptctrl->m_ppXrefDline[i_mic]);
+		dios_ssp_share_free(gscadaptctrl->m_ppXrefDline[i_mic]);
 	}
-	free(gscadaptctrl->m_ppXrefDline);
-	free(gscadaptctrl->m_pXfbfDline);
+	dios_ssp_share_free(gscadaptctrl->m_ppXrefDline);
+	dios_ssp_share_free(gscadaptctrl->m_pXfbfDline);
 	for (int i_mic = 0; i_mic < gscadaptctrl->m_wNumMic; i_mic++)
 	{
-		free(gscadaptctrl->m_ppcfXref[i_mic]);
+		dios_ssp_share_free(gscadaptctrl->m_ppcfXref[i_mic]);
 	}
-	free(gscadaptctrl->m_ppcfXref);
-	free(gscadaptctrl->m_pcfXfbf);
-	free(gscadaptctrl->m_pcfXcfbf);
-	free(gscadaptctrl->m_pfPref);
-	free(gscadaptctrl->m_pfBuffer);
-	free(gscadaptctrl->m_pfPfbf);
-	free(gscadaptctrl->m_pfPcfbf);
-	free(gscadaptctrl->m_pfBeta);
-	free(gscadaptctrl->m_pfBetaC);
+	dios_ssp_share_free(gscadaptctrl->m_ppcfXref);
+	dios_ssp_share_free(gscadaptctrl->m_pcfXfbf);
+	dios_ssp_share_free(gscadaptctrl->m_pcfXcfbf);
+	dios_ssp_share_free(gscadaptctrl->m_pfPref);
+	dios_ssp_share_free(gscadaptctrl->m_pfBuffer);
+	dios_ssp_share_free(gscadaptctrl->m_pfPfbf);
+	dios_ssp_share_free(gscadaptctrl->m_pfPcfbf);
+	dios_ssp_share_free(gscadaptctrl->m_pfBeta);
+	dios_ssp_share_free(gscadaptctrl->m_pfBetaC);
 	for (int i_mic = 0; i_mic < gscadaptctrl->m_wSyncDlyCtrlAic + 1; i_mic++)
 	{
-		free(gscadaptctrl->m_ppfCtrlAicDline[i_mic]);
+		dios_ssp_share_free(gscadaptctrl->m_ppfCtrlAicDline[i_mic]);
 	}
-	free(gscadaptctrl->m_ppfCtrlAicDline);
+	dios_ssp_share_free(gscadaptctrl->m_ppfCtrlAicDline);
 
 	return 0;
 }
@@ -83,6 +83,7 @@ Input:         // dwSampRate: sampling rate
 											statistics (8)
 					dwSizeSubWindowsMinStat: size of sub-windows for minimum 
 											statistics (18)
+					table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return adaptation control object pointer
 Others:        // none
@@ -91,7 +92,7 @@ void dios_ssp_gsc_gscadaptctrl_init(objFGSCadaptctrl *gscadaptctrl, const DWORD
             const WORD wSyncDlyYfbf, const WORD wSyncDlyAic, const DWORD dwFftSize, 
             const WORD wFftOverlap, const DWORD dwF0, const DWORD dwF1, const DWORD dwFc, 
             const float corrThresAbm, const float corrThresAic, 
-            const int dwNumSubWindowsMinStat, const int dwSizeSubWindowsMinStat);
+            const int dwNumSubWindowsMinStat, const int dwSizeSubWindowsMinStat, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_gsc_gscadaptctrl_reset
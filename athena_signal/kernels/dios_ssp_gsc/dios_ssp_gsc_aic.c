@@ -22,12 +22,13 @@ The adaptive interference caneller is only updated when the SNR is low.
 ==============================================================================*/
 
 #include "dios_ssp_gsc_aic.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
 void dios_ssp_gsc_gscaic_init(objFGSCaic *gscaic, int dlysync, int num_mic, int fft_size, float maxNorm, 
             float forgetfactor, float stepsize, float thresConDiv0, 
             float thresDynDiv0, float lobeDynDiv0, int useDynRegularization, 
             int num_taps, int overlap_fft, int overlap_sigs, long rate, 
-            float tconst_freezing)
+            float tconst_freezing, void *table_pool)
 {
 	gscaic->xrefdline = NULL;
 	gscaic->Xfdline = NULL;
@@ -65,62 +66,62 @@ void dios_ssp_gsc_gscaic_init(objFGSCaic *gscaic, int dlysync, int num_mic, int
 	gscaic->nu.i = 0.f;
 	gscaic->count_sigsegments = 0;
 
-	gscaic->xrefdline = (float*)calloc(gscaic->fftsize / 2 + gscaic->syncdly, sizeof(float));
-	gscaic->Xfdline = (xcomplex***)calloc(gscaic->nmic, sizeof(xcomplex**));
+	gscaic->xrefdline = (float*)dios_ssp_share_calloc(gscaic->fftsize / 2 + gscaic->syncdly, sizeof(float));
+	gscaic->Xfdline = (xcomplex***)dios_ssp_share_calloc_ptr(gscaic->nmic, sizeof(xcomplex**));
 	for(int i = 0; i < gscaic->nmic; i++)
 	{
-		gscaic->Xfdline[i] = (xcomplex**)calloc(gscaic->bdlinesize, sizeof(xcomplex*));
+		gscaic->Xfdline[i] = (xcomplex**)dios_ssp_share_calloc_ptr(gscaic->bdlinesize, sizeof(xcomplex*));
 		for(int k = 0; k < gscaic->bdlinesize; k++)
 		{
-			gscaic->Xfdline[i][k] = (xcomplex*)calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
+			gscaic->Xfdline[i][k] = (xcomplex*)dios_ssp_share_calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
 		}
 		
 	}
-	gscaic->Xdline = (float**)calloc(gscaic->nmic, sizeof(float*));
+	gscaic->Xdline = (float**)dios_ssp_share_calloc_ptr(gscaic->nmic, sizeof(float*));
 	for (int i_mic = 0; i_mic < gscaic->nmic; i_mic++)
 	{
-		gscaic->Xdline[i_mic] = (float*)calloc(gscaic->fftsize, sizeof(float));
+		gscaic->Xdline[i_mic] = (float*)dios_ssp_share_calloc(gscaic->fftsize, sizeof(float));
 	}
-	gscaic->Xfbdline = (xcomplex***)calloc(gscaic->nmic, sizeof(xcomplex**));
+	gscaic->Xfbdline = (xcomplex***)dios_ssp_share_calloc_ptr(gscaic->nmic, sizeof(xcomplex**));
 	for(int i = 0; i < gscaic->nmic; i++)
 	{
-		gscaic->Xfbdline[i] = (xcomplex**)calloc(gscaic->pbdlinesize, sizeof(xcomplex*));
+		gscaic->Xfbdline[i] = (xcomplex**)dios_ssp_share_calloc_ptr(gscaic->pbdlinesize, sizeof(xcomplex*));
 		for(int k = 0; k < gscaic->pbdlinesize; k++)
 		{
-			gscaic->Xfbdline[i][k] = (xcomplex*)calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
+			gscaic->Xfbdline[i][k] = (xcomplex*)dios_ssp_share_calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
 		}
 		
 	}
-	gscaic->Xffilt = (xcomplex**)calloc(gscaic->nmic, sizeof(xcomplex*));
+	gscaic->Xffilt = (xcomplex**)dios_ssp_share_calloc_ptr(gscaic->nmic, sizeof(xcomplex*));
 	for (int i_mic = 0; i_mic < gscaic->nmic; i_mic++)
 	{
-		gscaic->Xffilt[i_mic] = (xcomplex*)calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
+		gscaic->Xffilt[i_mic] = (xcomplex*)dios_ssp_share_calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
 	}
-	gscaic->yftmp = (xcomplex*)calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
-	gscaic->ytmp = (float*)calloc(gscaic->fftsize, sizeof(float));
-	gscaic->yhf = (xcomplex*)calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
-	gscaic->Hf = (xcomplex***)calloc(gscaic->nmic, sizeof(xcomplex**));
+	gscaic->yftmp = (xcomplex*)dios_ssp_share_calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
+	gscaic->ytmp = (float*)dios_ssp_share_calloc(gscaic->fftsize, sizeof(float));
+	gscaic->yhf = (xcomplex*)dios_ssp_share_calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
+	gscaic->Hf = (xcomplex***)dios_ssp_share_calloc_ptr(gscaic->nmic, sizeof(xcomplex**));
 	for(int i = 0; i < gscaic->nmic; i++)
 	{
-		gscaic->Hf[i] = (xcomplex**)calloc(gscaic->pbdlinesize, sizeof(xcomplex*));
+		gscaic->Hf[i] = (xcomplex**)dios_ssp_share_calloc_ptr(gscaic->pbdlinesize, sizeof(xcomplex*));
 		for(int k = 0; k < gscaic->pbdlinesize; k++)
 		{
-			gscaic->Hf[i][k] = (xcomplex*)calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
+			gscaic->Hf[i][k] = (xcomplex*)dios_ssp_share_calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
 		}
 		
 	}
-	gscaic->e = (float*)calloc(gscaic->fftsize, sizeof(float));
-	gscaic->z = (float*)calloc(gscaic->fftsize / (2 * gscaic->fftoverlap), sizeof(float));
-	gscaic->ef = (xcomplex*)calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
-	gscaic->pXf = (float*)calloc(gscaic->fftsize / 2 + 1, sizeof(float));
-	gscaic->sftmp = (float*)calloc(gscaic->fftsize / 2 + 1, sizeof(float));
-	gscaic->sf = (float*)calloc(gscaic->fftsize / 2 + 1, sizeof(float));
-	gscaic->muf = (xcomplex*)calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
-	gscaic->nuf = (xcomplex*)calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
-
-	gscaic->aic_FFT = dios_ssp_share_rfft_init(gscaic->fftsize);
-	gscaic->fft_out = (float*)calloc(gscaic->fftsize, sizeof(float));
-	gscaic->fft_in = (float*)calloc(gscaic->fftsize, sizeof(float));
+	gscaic->e = (float*)dios_ssp_share_calloc(gscaic->fftsize, sizeof(float));
+	gscaic->z = (float*)dios_ssp_share_calloc(gscaic->fftsize / (2 * gscaic->fftoverlap), sizeof(float));
+	gscaic->ef = (xcomplex*)dios_ssp_share_calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
+	gscaic->pXf = (float*)dios_ssp_share_calloc(gscaic->fftsize / 2 + 1, sizeof(float));
+	gscaic->sftmp = (float*)dios_ssp_share_calloc(gscaic->fftsize / 2 + 1, sizeof(float));
+	gscaic->sf = (float*)dios_ssp_share_calloc(gscaic->fftsize / 2 + 1, sizeof(float));
+	gscaic->muf = (xcomplex*)dios_ssp_share_calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
+	gscaic->nuf = (xcomplex*)dios_ssp_share_calloc(gscaic->fftsize / 2 + 1, sizeof(xcomplex));
+
+	gscaic->aic_FFT = dios_ssp_share_rfft_init_pool(gscaic->fftsize, table_pool);
+	gscaic->fft_out = (float*)dios_ssp_share_calloc(gscaic->fftsize, sizeof(float));
+	gscaic->fft_in = (float*)dios_ssp_share_calloc(gscaic->fftsize, sizeof(float));
 }
 
 int dios_ssp_gsc_gscaic_reset(objFGSCaic *gscaic)
@@ -468,58 +469,58 @@ int dios_ssp_gsc_gscaic_delete(objFGSCaic *gscaic)
 {
 	int i, k;
 	int ret = 0;
-	free(gscaic->xrefdline);
+	dios_ssp_share_free(gscaic->xrefdline);
 	for(i = 0; i < gscaic->nmic; i++)
 	{
 		for(k = 0; k < gscaic->bdlinesize; k++)
 		{
-			free(gscaic->Xfdline[i][k]);
+			dios_ssp_share_free(gscaic->Xfdline[i][k]);
 		}
-		free(gscaic->Xfdline[i]);
+		dios_ssp_share_free(gscaic->Xfdline[i]);
 	}
-	free(gscaic->Xfdline);
+	dios_ssp_share_free(gscaic->Xfdline);
 	for (int i_mic = 0; i_mic < gscaic->nmic; i_mic++)
 	{
-		free(gscaic->Xdline[i_mic]);
+		dios_ssp_share_free(gscaic->Xdline[i_mic]);
 	}
-	free(gscaic->Xdline);
+	dios_ssp_share_free(gscaic->Xdline);
 	for(i = 0; i < gscaic->nmic; i++)
 	{
 		for(k = 0; k < gscaic->pbdlinesize; k++)
 		{
-			free(gscaic->Xfbdline[i][k]);
+			dios_ssp_share_free(gscaic->Xfbdline[i][k]);
 		}
-		free(gscaic->Xfbdline[i]);
+		dios_ssp_share_free(gscaic->Xfbdline[i]);
 	}
-	free(gscaic->Xfbdline);
+	dios_ssp_share_free(gscaic->Xfbdline);
 	for (int i_mic = 0; i_mic < gscaic->nmic; i_mic++)
 	{
-		free(gscaic->Xffilt[i_mic]);
+		dios_ssp_share_free(gscaic->Xffilt[i_mic]);
 	}
-	free(gscaic->Xffilt);
-	free(gscaic->yftmp);
-	free(gscaic->ytmp);
-	free(gscaic->yhf);
+	dios_ssp_share_free(gscaic->Xffilt);
+	dios_ssp_share_free(gscaic->yftmp);
+	dios_ssp_share_free(gscaic->ytmp);
+	dios_ssp_share_free(gscaic->yhf);
 	for(i = 0; i < gscaic->nmic; i++)
 	{
 		for(k = 0; k < gscaic->pbdlinesize; k++)
 		{
-			free(gscaic->Hf[i][k]);
+			dios_ssp_share_free(gscaic->Hf[i][k]);
 		}
-		free(gscaic->Hf[i]);
+		dios_ssp_share_free(gscaic->Hf[i]);
 	}
-	free(gscaic->Hf);
-	free(gscaic->e);
-	free(gscaic->z);
-	free(gscaic->ef);
-	free(gscaic->pXf);
-	free(gscaic->sftmp);
-	free(gscaic->sf);
-	free(gscaic->muf);
-	free(gscaic->nuf);
-
-	free(gscaic->fft_out);
-	free(gscaic->fft_in);
+	dios_ssp_share_free(gscaic->Hf);
+	dios_ssp_share_free(gscaic->e);
+	dios_ssp_share_free(gscaic->z);
+	dios_ssp_share_free(gscaic->ef);
+	dios_ssp_share_free(gscaic->pXf);
+	dios_ssp_share_free(gscaic->sftmp);
+	dios_ssp_share_free(gscaic->sf);
+	dios_ssp_share_free(gscaic->muf);
+	dios_ssp_share_free(gscaic->nuf);
+
+	dios_ssp_share_free(gscaic->fft_out);
+	dios_ssp_share_free(gscaic->fft_in);
 	ret = dios_ssp_share_rfft_uninit(gscaic->aic_FFT);
 	if (0 != ret)
 	{
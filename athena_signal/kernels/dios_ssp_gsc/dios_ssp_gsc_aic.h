@@ -101,6 +101,7 @@ Input:         // dlysync: delay which is required for synchronization of the
                                     of adaptive filters, prevents freezing of adaptive 
                                     filters and reduces desired signal cancellation 
                                     after long periods with desired signal presence.
+                    table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return gscaic object pointer
 Others:        // none
@@ -109,7 +110,7 @@ void dios_ssp_gsc_gscaic_init(objFGSCaic *gscaic, int dlysync, int num_mic, int
             float forgetfactor, float stepsize, float thresConDiv0, 
             float thresDynDiv0, float lobeDynDiv0, int useDynRegularization, 
             int num_taps, int overlap_fft, int overlap_sigs, long rate, 
-            float tconst_freezing);
+            float tconst_freezing, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_gsc_gscaic_reset
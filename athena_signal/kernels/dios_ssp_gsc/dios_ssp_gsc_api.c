@@ -23,16 +23,34 @@ microphones(mic_coord) beforehand.
 ==============================================================================*/
 
 #include "dios_ssp_gsc_api.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
-void* dios_ssp_gsc_init_api(int mic_num, void* mic_coord)
+void* dios_ssp_gsc_init_api(int mic_num, void* mic_coord, int sample_rate)
 {
+	return dios_ssp_gsc_multibeam_init_api(mic_num, mic_coord, 1, 1, sample_rate, NULL);
+}
+
+static const size_t g_gsc_process_ptr[] = {
+	offsetof(objGSCProcess, ptr_mic_coord), offsetof(objGSCProcess, ptr_source_location),
+	offsetof(objGSCProcess, ptr_input_data_float), offsetof(objGSCProcess, ptr_output_data_short),
+	offsetof(objGSCProcess, ptr_output_data_float), offsetof(objGSCProcess, multigscbeamformer)
+};
+
+void* dios_ssp_gsc_multibeam_init_api(int mic_num, void* mic_coord, int beam_num, int thread_num, int sample_rate, void* table_pool)
+{
+	if(beam_num < 1 || thread_num < 1)
+	{
+		printf("gsc beam number %d or thread number %d is not supported!\n", beam_num, thread_num);
+		return NULL;
+	}
+
 	void* st = NULL;
-	st = (void*)calloc(1, sizeof(objGSCProcess));
+	st = (void*)dios_ssp_share_calloc_map(1, sizeof(objGSCProcess), g_gsc_process_ptr, SHARE_ARENA_MAP_NUM(g_gsc_process_ptr));
 	objGSCProcess* ptr = (objGSCProcess*)st;
 
     PlaneCoord* mic_coord_1 = NULL;
 	mic_coord_1 = (PlaneCoord*)mic_coord;
-	dios_ssp_gsc_init(ptr, mic_num, mic_coord_1);
+	dios_ssp_gsc_init(ptr, mic_num, mic_coord_1, beam_num, thread_num, sample_rate, table_pool);
 
 	return st;
 }
@@ -66,13 +84,37 @@ int dios_ssp_gsc_process_api(void* ptr, float* mic_data, float* out_data, float
 	{
 		memcpy(ptr_gsc->ptr_input_data_float[i], mic_data + i * ptr_gsc->frame_len, sizeof(float) * ptr_gsc->frame_len);
 	}
-	ptr_gsc->source_location.phi = loc_phi * PI / 180.0f;
+	ptr_gsc->ptr_source_location[0].phi = loc_phi * PI / 180.0f;
 	doProcess(ptr_gsc);
 	memcpy(out_data, ptr_gsc->ptr_output_data_float, sizeof(float) * ptr_gsc->frame_len);
 
 	return 0;
 }
 
+int dios_ssp_gsc_multibeam_process_api(void* ptr, float* mic_data, float* out_data, const float* loc_phi)
+{
+	if(ptr == NULL)
+	{
+		printf("gsc handle not init!\n");
+		return ERROR_GSC;
+	}
+	objGSCProcess *ptr_gsc;
+	ptr_gsc= (objGSCProcess*)ptr;
+
+	for (int i = 0; i < ptr_gsc->mic_num; i++)
+	{
+		memcpy(ptr_gsc->ptr_input_data_float[i], mic_data + i * ptr_gsc->frame_len, sizeof(float) * ptr_gsc->frame_len);
+	}
+	for (int bch = 0; bch < ptr_gsc->outbeam_num; bch++)
+	{
+		ptr_gsc->ptr_source_location[bch].phi = loc_phi[bch] * PI / 180.0f;
+	}
+	doProcess(ptr_gsc);
+	memcpy(out_data, ptr_gsc->ptr_output_data_float, sizeof(float) * ptr_gsc->outbeam_num * ptr_gsc->frame_len);
+
+	return 0;
+}
+
 int dios_ssp_gsc_uninit_api(void* ptr)
 {
 	if(ptr == NULL)
@@ -83,6 +125,6 @@ int dios_ssp_gsc_uninit_api(void* ptr)
 	objGSCProcess *ptr_gsc;
 	ptr_gsc= (objGSCProcess*)ptr;
 	dios_ssp_gsc_delete(ptr_gsc);
-	free(ptr_gsc);
+	dios_ssp_share_free(ptr_gsc);
 	return 0;
 }
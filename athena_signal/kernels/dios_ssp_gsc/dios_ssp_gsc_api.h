@@ -28,12 +28,34 @@ Function:      // dios_ssp_gsc_init_api
 Description:   // gsc init
 Input:         // mic_num: microphone number
                   mic_coord: each microphone coordinate (PlaneCoord*)mic_coord
+                  sample_rate: sampling rate in Hz, one frame is sample_rate / 125
+                  samples
 Output:        // none
 Return:        // success: return gsc object pointer (void*)ptr_gsc
                   failure: return NULL
 Others:        // none
 **********************************************************************************/
-void* dios_ssp_gsc_init_api(int mic_num, void* mic_coord);
+void* dios_ssp_gsc_init_api(int mic_num, void* mic_coord, int sample_rate);
+
+/**********************************************************************************
+Function:      // dios_ssp_gsc_multibeam_init_api
+Description:   // multi-beam gsc init, every beam is an independent gsc with its
+                  own steering direction and adaptive filters
+Input:         // mic_num: microphone number
+                  mic_coord: each microphone coordinate (PlaneCoord*)mic_coord
+                  beam_num: number of output beams
+                  thread_num: number of threads processing the beams, 1 means
+                  the beams are processed on the calling thread
+                  sample_rate: sampling rate in Hz
+                  table_pool: pool of read-only tables shared with other instances,
+                  see dios_ssp_share_table.h, NULL for private tables
+Output:        // none
+Return:        // success: return gsc object pointer (void*)ptr_gsc
+                  failure: return NULL
+Others:        // reset and uninit are done by dios_ssp_gsc_reset_api and
+                  dios_ssp_gsc_uninit_api
+**********************************************************************************/
+void* dios_ssp_gsc_multibeam_init_api(int mic_num, void* mic_coord, int beam_num, int thread_num, int sample_rate, void* table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_gsc_reset_api
@@ -57,6 +79,19 @@ Others:        // none
 **********************************************************************************/
 int dios_ssp_gsc_process_api(void* ptr, float* mic_data, float* out_data, float loc_phi);
 
+/**********************************************************************************
+Function:      // dios_ssp_gsc_multibeam_process_api
+Description:   // multi-beam gsc process
+Input:         // ptr: gsc object pointer
+                    mic_data: gsc input data, data type is float
+                    loc_phi: direction of each beam, beam_num values in degree
+Output:        // out_data: gsc output signal, beam_num * frame_len, the output
+                    of beam bch starts at out_data + bch * frame_len
+Return:        // success: return 0, failure: return ERROR_GSC
+Others:        // none
+**********************************************************************************/
+int dios_ssp_gsc_multibeam_process_api(void* ptr, float* mic_data, float* out_data, const float* loc_phi);
+
 /**********************************************************************************
 Function:      // dios_ssp_gsc_uninit_api
 Description:   // gsc delete
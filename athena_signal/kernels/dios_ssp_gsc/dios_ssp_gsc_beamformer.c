@@ -19,10 +19,63 @@ beamformer model contains Fixed Beamformering(FBF).
 ==============================================================================*/
 
 #include "dios_ssp_gsc_beamformer.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
 static const float gsc_c = 340.0f;          /* sound speed */
 
-void dios_ssp_gsc_gscbeamformer_init(objCGSCbeamformer* gscbeamformer, DWORD nMic, DWORD dwSampRate, DWORD dwBlockSize, General_ArrayGeometric type, void *coord)
+static const size_t g_gsc_beamsteer_ptr[] = {
+	offsetof(objCGSCbeamsteer, m_delays), offsetof(objCGSCbeamsteer, m_pDlyLine),
+	offsetof(objCGSCbeamsteer, m_pTaps), offsetof(objCGSCbeamsteer, m_pFFT),
+	offsetof(objCGSCbeamsteer, m_pTapsFreq), offsetof(objCGSCbeamsteer, m_pFFTBuf),
+	offsetof(objCGSCbeamsteer, generalfirdesign)
+};
+
+static const size_t g_gsc_filtsum_ptr[] = {
+	offsetof(objFGSCfiltsumbeamformer, Xdline), offsetof(objFGSCfiltsumbeamformer, xftmp),
+	offsetof(objFGSCfiltsumbeamformer, ytmp), offsetof(objFGSCfiltsumbeamformer, yftmp),
+	offsetof(objFGSCfiltsumbeamformer, filt_FFT), offsetof(objFGSCfiltsumbeamformer, fft_out),
+	offsetof(objFGSCfiltsumbeamformer, fft_in)
+};
+
+static const size_t g_gsc_abm_ptr[] = {
+	offsetof(objFGSCabm, Xdline), offsetof(objFGSCabm, xrefdline),
+	offsetof(objFGSCabm, xfref), offsetof(objFGSCabm, hf),
+	offsetof(objFGSCabm, ytmp), offsetof(objFGSCabm, yftmp),
+	offsetof(objFGSCabm, yf), offsetof(objFGSCabm, e),
+	offsetof(objFGSCabm, E), offsetof(objFGSCabm, ef),
+	offsetof(objFGSCabm, muf), offsetof(objFGSCabm, nuf),
+	offsetof(objFGSCabm, pxfref), offsetof(objFGSCabm, sf),
+	offsetof(objFGSCabm, pftmp), offsetof(objFGSCabm, m_upper_bound),
+	offsetof(objFGSCabm, m_lower_bound), offsetof(objFGSCabm, abm_FFT),
+	offsetof(objFGSCabm, fft_out), offsetof(objFGSCabm, fft_in)
+};
+
+static const size_t g_gsc_aic_ptr[] = {
+	offsetof(objFGSCaic, xrefdline), offsetof(objFGSCaic, Xfdline),
+	offsetof(objFGSCaic, Xfbdline), offsetof(objFGSCaic, Xdline),
+	offsetof(objFGSCaic, Xffilt), offsetof(objFGSCaic, yftmp),
+	offsetof(objFGSCaic, ytmp), offsetof(objFGSCaic, yhf),
+	offsetof(objFGSCaic, Hf), offsetof(objFGSCaic, e),
+	offsetof(objFGSCaic, z), offsetof(objFGSCaic, ef),
+	offsetof(objFGSCaic, pXf), offsetof(objFGSCaic, sftmp),
+	offsetof(objFGSCaic, sf), offsetof(objFGSCaic, muf),
+	offsetof(objFGSCaic, nuf), offsetof(objFGSCaic, aic_FFT),
+	offsetof(objFGSCaic, fft_out), offsetof(objFGSCaic, fft_in)
+};
+
+static const size_t g_gsc_adaptctrl_ptr[] = {
+	offsetof(objFGSCadaptctrl, m_pfFftIn), offsetof(objFGSCadaptctrl, m_ppXrefDline),
+	offsetof(objFGSCadaptctrl, m_pXfbfDline), offsetof(objFGSCadaptctrl, m_ppcfXref),
+	offsetof(objFGSCadaptctrl, m_pcfXcfbf), offsetof(objFGSCadaptctrl, m_pcfXfbf),
+	offsetof(objFGSCadaptctrl, m_pfPref), offsetof(objFGSCadaptctrl, m_pfPfbf),
+	offsetof(objFGSCadaptctrl, m_pfPcfbf), offsetof(objFGSCadaptctrl, m_pfBeta),
+	offsetof(objFGSCadaptctrl, m_pfBetaC), offsetof(objFGSCadaptctrl, m_ppfCtrlAicDline),
+	offsetof(objFGSCadaptctrl, m_pfBuffer), offsetof(objFGSCadaptctrl, npsdosms1),
+	offsetof(objFGSCadaptctrl, npsdosms2), offsetof(objFGSCadaptctrl, adapt_FFT),
+	offsetof(objFGSCadaptctrl, fft_out)
+};
+
+void dios_ssp_gsc_gscbeamformer_init(objCGSCbeamformer* gscbeamformer, DWORD nMic, DWORD dwSampRate, DWORD dwBlockSize, General_ArrayGeometric type, void *coord, void *table_pool)
 {
 	int param = 0;
 	gscbeamformer->m_nMic = (int)nMic;
@@ -61,13 +114,13 @@ void dios_ssp_gsc_gscbeamformer_init(objCGSCbeamformer* gscbeamformer, DWORD nMi
 	gscbeamformer->m_paramABM.fftoverlap > gscbeamformer->m_paramAIC.fftoverlap?gscbeamformer->m_paramABM.fftoverlap : gscbeamformer->m_paramAIC.fftoverlap;
 	gscbeamformer->m_paramGSC.fftlength = 2 * (gscbeamformer->m_paramABM.ntaps < gscbeamformer->m_paramAIC.ntaps?gscbeamformer->m_paramABM.ntaps : gscbeamformer->m_paramAIC.ntaps);
 
-	gscbeamformer->gscbeamsteer =  (objCGSCbeamsteer*)calloc(1, sizeof(objCGSCbeamsteer));
-	dios_ssp_gsc_gscbeamsteer_init(gscbeamformer->gscbeamsteer, gscbeamformer->m_nMic, gscbeamformer->m_nIOBlockSize, gscbeamformer->m_dwSampRate, 32);
+	gscbeamformer->gscbeamsteer =  (objCGSCbeamsteer*)dios_ssp_share_calloc_map(1, sizeof(objCGSCbeamsteer), g_gsc_beamsteer_ptr, SHARE_ARENA_MAP_NUM(g_gsc_beamsteer_ptr));
+	dios_ssp_gsc_gscbeamsteer_init(gscbeamformer->gscbeamsteer, gscbeamformer->m_nMic, gscbeamformer->m_nIOBlockSize, gscbeamformer->m_dwSampRate, 32, table_pool);
 
 	/* initialize the fixed beamformer unit */
 	int ordFbfFilt = 0;
-	gscbeamformer->gscfiltsumbeamformer =  (objFGSCfiltsumbeamformer*)calloc(1, sizeof(objFGSCfiltsumbeamformer));
-	dios_ssp_gsc_gscfiltsumbeamformer_init(gscbeamformer->gscfiltsumbeamformer, gscbeamformer->m_nMic, gscbeamformer->m_paramGSC.fftlength, gscbeamformer->m_paramGSC.fftoverlap);
+	gscbeamformer->gscfiltsumbeamformer =  (objFGSCfiltsumbeamformer*)dios_ssp_share_calloc_map(1, sizeof(objFGSCfiltsumbeamformer), g_gsc_filtsum_ptr, SHARE_ARENA_MAP_NUM(g_gsc_filtsum_ptr));
+	dios_ssp_gsc_gscfiltsumbeamformer_init(gscbeamformer->gscfiltsumbeamformer, gscbeamformer->m_nMic, gscbeamformer->m_paramGSC.fftlength, gscbeamformer->m_paramGSC.fftoverlap, table_pool);
 
 	/* initialize delays for intermodule synchronization 
      * which can only be done after fbf initialization since the order of fbf filters are required */
@@ -83,18 +136,18 @@ void dios_ssp_gsc_gscbeamformer_init(objCGSCbeamformer* gscbeamformer, DWORD nMi
 	gscbeamformer->m_paramSync.nDelayAcRef = (int)floor((float)ordFbfFilt / 2);  /* delay of fbf */
 	
 	/* initialize adaptive blocking matrix */
-	gscbeamformer->gscabm =  (objFGSCabm*)calloc(1, sizeof(objFGSCabm));
+	gscbeamformer->gscabm =  (objFGSCabm*)dios_ssp_share_calloc_map(1, sizeof(objFGSCabm), g_gsc_abm_ptr, SHARE_ARENA_MAP_NUM(g_gsc_abm_ptr));
 	dios_ssp_gsc_gscabm_init(gscbeamformer->gscabm, gscbeamformer->m_nMic, gscbeamformer->m_paramGSC.fftlength, gscbeamformer->m_paramGSC.fftoverlap, gscbeamformer->m_paramABM.fftoverlap,
 		gscbeamformer->m_paramSync.nDelayABM, gscbeamformer->m_paramABM.lambda, gscbeamformer->m_paramABM.mu, gscbeamformer->m_paramGSC.delta_con, gscbeamformer->m_dwSampRate, 
-		gscbeamformer->m_paramABM.tconstfreeze);
+		gscbeamformer->m_paramABM.tconstfreeze, table_pool);
 
 
 	gscbeamformer->m_paramAIC.maxnorm = 0.003f;
 	/* initialize adaptive interference canceller */
-	gscbeamformer->gscaic =  (objFGSCaic*)calloc(1, sizeof(objFGSCaic));
+	gscbeamformer->gscaic =  (objFGSCaic*)dios_ssp_share_calloc_map(1, sizeof(objFGSCaic), g_gsc_aic_ptr, SHARE_ARENA_MAP_NUM(g_gsc_aic_ptr));
 	dios_ssp_gsc_gscaic_init(gscbeamformer->gscaic, gscbeamformer->m_paramSync.nDelayAIC, gscbeamformer->m_nMic, gscbeamformer->m_paramGSC.fftlength, gscbeamformer->m_paramAIC.maxnorm, gscbeamformer->m_paramAIC.lambda, 
 		gscbeamformer->m_paramAIC.mu, gscbeamformer->m_paramGSC.delta_con, gscbeamformer->m_paramGSC.delta_dyn, gscbeamformer->m_paramGSC.s0_dyn, gscbeamformer->m_paramGSC.regularize_dyn, 
-		gscbeamformer->m_paramAIC.ntaps, gscbeamformer->m_paramAIC.fftoverlap, gscbeamformer->m_paramGSC.fftoverlap, gscbeamformer->m_dwSampRate, gscbeamformer->m_paramAIC.tconstfreeze);
+		gscbeamformer->m_paramAIC.ntaps, gscbeamformer->m_paramAIC.fftoverlap, gscbeamformer->m_paramGSC.fftoverlap, gscbeamformer->m_dwSampRate, gscbeamformer->m_paramAIC.tconstfreeze, table_pool);
 
 
 	/* sync delay for ac reference microphone */
@@ -104,40 +157,35 @@ void dios_ssp_gsc_gscbeamformer_init(objCGSCbeamformer* gscbeamformer, DWORD nMi
             * (float)(2 * gscbeamformer->m_paramGSC.fftoverlap) / (float)gscbeamformer->m_paramGSC.fftlength);
 	
     /* initialize adaptation control */
-	gscbeamformer->gscadaptctrl =  (objFGSCadaptctrl*)calloc(1, sizeof(objFGSCadaptctrl));
+	gscbeamformer->gscadaptctrl =  (objFGSCadaptctrl*)dios_ssp_share_calloc_map(1, sizeof(objFGSCadaptctrl), g_gsc_adaptctrl_ptr, SHARE_ARENA_MAP_NUM(g_gsc_adaptctrl_ptr));
 	dios_ssp_gsc_gscadaptctrl_init(gscbeamformer->gscadaptctrl, gscbeamformer->m_dwSampRate, gscbeamformer->m_nMic, acXref, acYfbf, acCtrlAic, gscbeamformer->m_paramGSC.fftlength, 
         gscbeamformer->m_paramGSC.fftoverlap, gscbeamformer->m_paramAC.fmin, gscbeamformer->m_paramAC.fmax, gscbeamformer->m_paramAC.fc, gscbeamformer->m_paramAC.ctabm, gscbeamformer->m_paramAC.ctaic, 
-        gscbeamformer->m_paramAC.U, gscbeamformer->m_paramAC.V);
+        gscbeamformer->m_paramAC.U, gscbeamformer->m_paramAC.V, table_pool);
 
 	
 	/* initialize signals */
 	gscbeamformer->m_nGSCUpdateSize = gscbeamformer->m_paramGSC.fftlength / (2 * gscbeamformer->m_paramGSC.fftoverlap);
 	gscbeamformer->m_nCCSSize = gscbeamformer->m_paramGSC.fftlength / 2 + 1;
 
-	gscbeamformer->m_input = (float**)calloc(gscbeamformer->m_nMic, sizeof(float*));
-	for (int i_mic = 0; i_mic < gscbeamformer->m_nMic; i_mic++)
-	{
-		gscbeamformer->m_input[i_mic] = (float*)calloc(gscbeamformer->m_nIOBlockSize, sizeof(float));
-	}
 	param = gscbeamformer->m_nGSCUpdateSize > gscbeamformer->m_nIOBlockSize ? gscbeamformer->m_nGSCUpdateSize : gscbeamformer->m_nIOBlockSize;
-	gscbeamformer->m_outSteering = (float**)calloc(gscbeamformer->m_nMic, sizeof(float*));
+	gscbeamformer->m_outSteering = (float**)dios_ssp_share_calloc_ptr(gscbeamformer->m_nMic, sizeof(float*));
 	for (int i_mic = 0; i_mic < gscbeamformer->m_nMic; i_mic++)
 	{
-		gscbeamformer->m_outSteering[i_mic] = (float*)calloc(param, sizeof(float));
+		gscbeamformer->m_outSteering[i_mic] = (float*)dios_ssp_share_calloc(param, sizeof(float));
 	}
-	gscbeamformer->m_outFBF = (float*)calloc(gscbeamformer->m_nGSCUpdateSize, sizeof(float));
-	gscbeamformer->m_ctrlABM = (float*)calloc(gscbeamformer->m_nCCSSize, sizeof(float));
-	gscbeamformer->m_ctrlAIC = (float*)calloc(gscbeamformer->m_nCCSSize, sizeof(float));
-	gscbeamformer->m_outABM = (float**)calloc(gscbeamformer->m_nMic, sizeof(float*));
+	gscbeamformer->m_outFBF = (float*)dios_ssp_share_calloc(gscbeamformer->m_nGSCUpdateSize, sizeof(float));
+	gscbeamformer->m_ctrlABM = (float*)dios_ssp_share_calloc(gscbeamformer->m_nCCSSize, sizeof(float));
+	gscbeamformer->m_ctrlAIC = (float*)dios_ssp_share_calloc(gscbeamformer->m_nCCSSize, sizeof(float));
+	gscbeamformer->m_outABM = (float**)dios_ssp_share_calloc_ptr(gscbeamformer->m_nMic, sizeof(float*));
 	for (int i_mic = 0; i_mic < gscbeamformer->m_nMic; i_mic++)
 	{
-		gscbeamformer->m_outABM[i_mic] = (float*)calloc(gscbeamformer->m_nGSCUpdateSize, sizeof(float));
+		gscbeamformer->m_outABM[i_mic] = (float*)dios_ssp_share_calloc(gscbeamformer->m_nGSCUpdateSize, sizeof(float));
 	}
-	gscbeamformer->m_outAIC = (float*)calloc(gscbeamformer->m_nIOBlockSize, sizeof(float));
-	gscbeamformer->m_output = (float*)calloc(gscbeamformer->m_nIOBlockSize, sizeof(float));
+	gscbeamformer->m_outAIC = (float*)dios_ssp_share_calloc(gscbeamformer->m_nIOBlockSize, sizeof(float));
+	gscbeamformer->m_output = (float*)dios_ssp_share_calloc(gscbeamformer->m_nIOBlockSize, sizeof(float));
 
 	gscbeamformer->m_locMic = (PlaneCoord*)coord;
-	gscbeamformer->m_tdoa = (float *)calloc(gscbeamformer->m_nMic, sizeof(float));
+	gscbeamformer->m_tdoa = (float *)dios_ssp_share_calloc(gscbeamformer->m_nMic, sizeof(float));
 	gscbeamformer->m_current_phi = 720.0f * PI / 180.0f;
 	gscbeamformer->m_phi_thr = 5.0f * PI / 180.0f;
 	gscbeamformer->m_current_abm_phi = 360.0f * PI / 180.0f;
@@ -161,7 +209,6 @@ int dios_ssp_gsc_gscbeamformer_reset(objCGSCbeamformer* gscbeamformer)
 	int maxTemp = gscbeamformer->m_nGSCUpdateSize > gscbeamformer->m_nIOBlockSize?gscbeamformer->m_nGSCUpdateSize:gscbeamformer->m_nIOBlockSize;
 	for (int m = 0; m < gscbeamformer->m_nMic; m++)
 	{
-		memset(gscbeamformer->m_input[m], 0, sizeof(float) * gscbeamformer->m_nIOBlockSize);
 		memset(gscbeamformer->m_outSteering[m], 0, sizeof(float) * maxTemp);
 		memset(gscbeamformer->m_outABM[m], 0, sizeof(float) * gscbeamformer->m_nGSCUpdateSize);
 	}
@@ -237,14 +284,9 @@ int dios_ssp_gsc_gscbeamformer_arraysteer(objCGSCbeamformer* gscbeamformer, Pola
 
 int dios_ssp_gsc_gscbeamformer_process(objCGSCbeamformer* gscbeamformer, float** ppInput)
 {
-	int nBlockBytes = sizeof(float) * gscbeamformer->m_nIOBlockSize;
-	for (int i = 0; i < gscbeamformer->m_nMic; i++)
-    {
-		memcpy(gscbeamformer->m_input[i], ppInput[i], nBlockBytes);
-    }
-	
-	/* beam steering to the desired direction */
-	dios_ssp_gsc_gscbeamsteer_process(gscbeamformer->gscbeamsteer, gscbeamformer->m_input, gscbeamformer->m_outSteering);
+	/* beam steering to the desired direction, the input is only read so that
+	 * several beams can be steered from the same input block */
+	dios_ssp_gsc_gscbeamsteer_process(gscbeamformer->gscbeamsteer, ppInput, gscbeamformer->m_outSteering);
 
 	/* perform the gsc beamforming processing */
 	for (int k = 0; k < gscbeamformer->m_nIOBlockSize; k += gscbeamformer->m_nGSCUpdateSize)  /* 128 / 16 = 8 */
@@ -272,37 +314,32 @@ int dios_ssp_gsc_gscbeamformer_process(objCGSCbeamformer* gscbeamformer, float**
 int dios_ssp_gsc_gscbeamformer_delete(objCGSCbeamformer* gscbeamformer)
 {
 	dios_ssp_gsc_gscbeamsteer_delete(gscbeamformer->gscbeamsteer);
-	free(gscbeamformer->gscbeamsteer);
+	dios_ssp_share_free(gscbeamformer->gscbeamsteer);
 	dios_ssp_gsc_gscfiltsumbeamformer_delete(gscbeamformer->gscfiltsumbeamformer);
-	free(gscbeamformer->gscfiltsumbeamformer);
+	dios_ssp_share_free(gscbeamformer->gscfiltsumbeamformer);
 	dios_ssp_gsc_gscabm_delete(gscbeamformer->gscabm);
-	free(gscbeamformer->gscabm);
+	dios_ssp_share_free(gscbeamformer->gscabm);
 	dios_ssp_gsc_gscaic_delete(gscbeamformer->gscaic);
-	free(gscbeamformer->gscaic);
+	dios_ssp_share_free(gscbeamformer->gscaic);
 	dios_ssp_gsc_gscadaptctrl_delete(gscbeamformer->gscadaptctrl);
-	free(gscbeamformer->gscadaptctrl);
+	dios_ssp_share_free(gscbeamformer->gscadaptctrl);
 
 	for (int i_mic = 0; i_mic < gscbeamformer->m_nMic; i_mic++)
 	{
-		free(gscbeamformer->m_input[i_mic]);
-	}
-	free(gscbeamformer->m_input);
-	for (int i_mic = 0; i_mic < gscbeamformer->m_nMic; i_mic++)
-	{
-		free(gscbeamformer->m_outSteering[i_mic]);
+		dios_ssp_share_free(gscbeamformer->m_outSteering[i_mic]);
 	}
-	free(gscbeamformer->m_outSteering);
-	free(gscbeamformer->m_outFBF);
-	free(gscbeamformer->m_ctrlABM);
-	free(gscbeamformer->m_ctrlAIC);
+	dios_ssp_share_free(gscbeamformer->m_outSteering);
+	dios_ssp_share_free(gscbeamformer->m_outFBF);
+	dios_ssp_share_free(gscbeamformer->m_ctrlABM);
+	dios_ssp_share_free(gscbeamformer->m_ctrlAIC);
 	for (int i_mic = 0; i_mic < gscbeamformer->m_nMic; i_mic++)
 	{
-		free(gscbeamformer->m_outABM[i_mic]);
+		dios_ssp_share_free(gscbeamformer->m_outABM[i_mic]);
 	}
-	free(gscbeamformer->m_outABM);
-	free(gscbeamformer->m_outAIC);
-	free(gscbeamformer->m_output);
-	free(gscbeamformer->m_tdoa);
+	dios_ssp_share_free(gscbeamformer->m_outABM);
+	dios_ssp_share_free(gscbeamformer->m_outAIC);
+	dios_ssp_share_free(gscbeamformer->m_output);
+	dios_ssp_share_free(gscbeamformer->m_tdoa);
 
 	return 0;
 }
@@ -28,7 +28,6 @@ limitations under the License.
 
 typedef struct
 {
-	float **m_input;
 	float **m_outSteering;
 	float *m_outFBF;
 	float *m_ctrlABM;
@@ -76,11 +75,12 @@ Description:   // beamformer init
 Input:         // gscbeamformer: gscbeamformer object pointer
                   nMic: microphone number
                   coord: each microphone coordinate (PlaneCoord*)mic_coord
+                  table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return gscbeamformer object pointer
 Others:        // none
 **********************************************************************************/
-void dios_ssp_gsc_gscbeamformer_init(objCGSCbeamformer* gscbeamformer, DWORD nMic, DWORD dwSampRate, DWORD dwBlockSize, General_ArrayGeometric type, void *coord);
+void dios_ssp_gsc_gscbeamformer_init(objCGSCbeamformer* gscbeamformer, DWORD nMic, DWORD dwSampRate, DWORD dwBlockSize, General_ArrayGeometric type, void *coord, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_gsc_gscbeamformer_reset
@@ -105,7 +105,7 @@ int dios_ssp_gsc_gscbeamformer_arraysteer(objCGSCbeamformer* gscbeamformer, Pola
 /**********************************************************************************
 Function:      // dios_ssp_gsc_gscbeamformer_process
 Description:   // process data of one block
-Input:         // prototype: pInput, float data, multi-channel, continuous memory
+Input:         // prototype: pInput, float data, multi-channel, it is not modified
 Output:        // none
 Return:        // success: return 0
 Others:        // none
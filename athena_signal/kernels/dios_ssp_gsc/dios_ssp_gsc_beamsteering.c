@@ -17,121 +17,144 @@ Description: GSC beamformer steering vector.
 ==============================================================================*/
 
 #include "dios_ssp_gsc_beamsteering.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
-void FIRFiltering_Direct(float *pIn, float *pOut, int dwBaseSize, float *FIRTaps, 
-        int dwFIRTaps, float *pDlyLine, int *DlyLineIndex)
+/* direct convolution of a block, the delay line holds the last nTaps - 1
+ * input samples followed by the new block, so no index wraps around. Each
+ * output sums its taps in the order of the former circular buffer version */
+static void FIRFiltering_Direct(const float *pDlyLine, float *pOut, int nBlockSize, const float *FIRTaps, int nTaps)
 {
-	int i; 
-	int numIter = dwBaseSize / dwFIRTaps;
-	int numLeft = dwBaseSize % dwFIRTaps;
-	int oldDlyLineIndex;  /* save the beginning position */
+	const float *pNew = pDlyLine + nTaps - 1;
 
-	/* process the dwFIRTaps length data block */
-	for (i = 0; i < numIter; i++)
+	for (int k = 0; k < nBlockSize; k++)
 	{
-		/* move the dwFIRTaps new samples into the pDlyLine buffer, in order to decrease the copy operations 
-         * because the block copy is quicker than the single sample copy (using the circular buffer) */
-		if ((2 * dwFIRTaps - (*DlyLineIndex)) >= dwFIRTaps)
-		{
-			memcpy(pDlyLine + (*DlyLineIndex), pIn + i * dwFIRTaps, dwFIRTaps * sizeof(float));
-			oldDlyLineIndex = *DlyLineIndex;  /* save beginning position */
-			*DlyLineIndex += dwFIRTaps;  /* new saving position */
-			if (*DlyLineIndex == 2 * dwFIRTaps)
-            {
-				*DlyLineIndex = 0;
-            }
-		}
-		else
-		{
-			memcpy(pDlyLine + (*DlyLineIndex), pIn + i * dwFIRTaps, 
-                    (2 * dwFIRTaps - (*DlyLineIndex)) * sizeof(float));
-			memcpy(pDlyLine, pIn + i * dwFIRTaps + (2 * dwFIRTaps - (*DlyLineIndex)), 
-                    ((*DlyLineIndex) - dwFIRTaps) * sizeof(float));
-			oldDlyLineIndex = *DlyLineIndex;  /* save beginning position */
-			*DlyLineIndex -= dwFIRTaps;  /* new saving position */
-		}
-
-		/* FIR filtering by convolution */
-		for (int k = 0; k < dwFIRTaps; k++)
+		pOut[k] = 0.0f;
+	}
+	for (int j = 0; j < nTaps; j++)
+	{
+		const float *x = pNew - j;
+		float tap = FIRTaps[j];
+		for (int k = 0; k < nBlockSize; k++)
 		{
-			float ftemp = 0.0;
-			for (int j = 0; j < dwFIRTaps; j++)
-            {
-				ftemp += pDlyLine[(oldDlyLineIndex + k - j + 2 * dwFIRTaps) % (2 * dwFIRTaps)] * FIRTaps[j];
-            }
-			pOut[i * dwFIRTaps + k] = ftemp;
+			pOut[k] += x[k] * tap;
 		}
 	}
+}
 
-	/* process the numLeft length data block */
-	if (numLeft > 0)
+/* overlap-save convolution of a block, the delay line holds the last
+ * nFFTLen - nBlockSize input samples followed by the new block, the last
+ * nBlockSize outputs of the circular convolution are free of aliasing */
+static void FIRFiltering_OverlapSave(void *pFFT, const float *pDlyLine, float *pOut, int nBlockSize, 
+        const float *pTapsFreq, int nFFTLen, float *pBuf)
+{
+	int k;
+	float xr, xi, hr, hi;
+
+	dios_ssp_share_rfft_process(pFFT, (float*)pDlyLine, pBuf);
+	pBuf[0] *= pTapsFreq[0];
+	pBuf[nFFTLen / 2] *= pTapsFreq[nFFTLen / 2];
+	for (k = 1; k < nFFTLen / 2; k++)
 	{
-		/* move the numLeft samples into the DlyLine buffer, in order to decrease the copy operations */
-		if ((2 * dwFIRTaps - (*DlyLineIndex)) >= numLeft)
-		{
-			memcpy(pDlyLine + (*DlyLineIndex), pIn + i * dwFIRTaps, numLeft * sizeof(float));
-			oldDlyLineIndex = *DlyLineIndex;  /* save beginning position */
-			*DlyLineIndex += numLeft;  /* new saving position */
-			if (*DlyLineIndex == 2 * dwFIRTaps)
-            {
-				*DlyLineIndex = 0;
-            }
-		}
-		else
-		{
-			memcpy(pDlyLine + (*DlyLineIndex), pIn + i * dwFIRTaps, 
-                    (2 * dwFIRTaps - (*DlyLineIndex)) * sizeof(float));
-			memcpy(pDlyLine, pIn + i * dwFIRTaps + (2 * dwFIRTaps - (*DlyLineIndex)), 
-                    (numLeft + (*DlyLineIndex) - 2 * dwFIRTaps) * sizeof(float));
-			oldDlyLineIndex = *DlyLineIndex;  /* save beginning position */
-			*DlyLineIndex += numLeft - 2 * dwFIRTaps;  /* new saving position */	
-		}
+		/* the imaginary parts are stored negated at nFFTLen - k */
+		xr = pBuf[k];
+		xi = pBuf[nFFTLen - k];
+		hr = pTapsFreq[k];
+		hi = pTapsFreq[nFFTLen - k];
+		pBuf[k] = xr * hr - xi * hi;
+		pBuf[nFFTLen - k] = xr * hi + xi * hr;
+	}
+	dios_ssp_share_irfft_process(pFFT, pBuf, pBuf);
+	memcpy(pOut, pBuf + nFFTLen - nBlockSize, nBlockSize * sizeof(float));
+}
 
-		/* FIR filtering by convolution */
-		for (int k = 0; k < numLeft; k++)
-		{
-			float ftemp = 0.0;
-			for (int j = 0; j < dwFIRTaps; j++)
-            {
-				ftemp += pDlyLine[(oldDlyLineIndex + k - j + 2 * dwFIRTaps) % (2 * dwFIRTaps)] * FIRTaps[j];
-            }
-			pOut[i * dwFIRTaps + k] = ftemp;
-		}
+/* spectrum of the taps of one channel, scaled so that the inverse transform
+ * needs no normalization */
+static void dios_ssp_gsc_gscbeamsteer_tapsfreq(objCGSCbeamsteer* gscbeamsteer, int ch)
+{
+	float *pBuf = gscbeamsteer->m_pFFTBuf;
+	float scale = 1.0f / (float)gscbeamsteer->m_nFFTLen;
+
+	if (gscbeamsteer->m_nFFTLen == 0)
+	{
+		return;
+	}
+	memset(pBuf, 0, gscbeamsteer->m_nFFTLen * sizeof(float));
+	memcpy(pBuf, gscbeamsteer->m_pTaps[ch], gscbeamsteer->m_nTaps * sizeof(float));
+	dios_ssp_share_rfft_process(gscbeamsteer->m_pFFT, pBuf, gscbeamsteer->m_pTapsFreq[ch]);
+	for (int k = 0; k < gscbeamsteer->m_nFFTLen; k++)
+	{
+		gscbeamsteer->m_pTapsFreq[ch][k] *= scale;
 	}
 }
 
-void dios_ssp_gsc_gscbeamsteer_init(objCGSCbeamsteer* gscbeamsteer, int nMic, int nBlockSize, DWORD dwKernelRate, int nTaps)
+static const size_t g_gsc_firdesign_ptr[] = {
+	offsetof(objCGeneralFIRDesigner, m_pTapsBuf), offsetof(objCGeneralFIRDesigner, m_pTapsFreq),
+	offsetof(objCGeneralFIRDesigner, m_mag), offsetof(objCGeneralFIRDesigner, m_phase),
+	offsetof(objCGeneralFIRDesigner, m_win), offsetof(objCGeneralFIRDesigner, gengralfir_FFT),
+	offsetof(objCGeneralFIRDesigner, fft_out), offsetof(objCGeneralFIRDesigner, fft_in)
+};
+
+void dios_ssp_gsc_gscbeamsteer_init(objCGSCbeamsteer* gscbeamsteer, int nMic, int nBlockSize, DWORD dwKernelRate, int nTaps, void *table_pool)
 {
 	gscbeamsteer->m_nMic = nMic;
 	gscbeamsteer->m_nBlockSize = nBlockSize; 
 	gscbeamsteer->m_dwKernelRate = dwKernelRate;
 	gscbeamsteer->m_nTaps = nTaps;
 
-	gscbeamsteer->m_pDlyLine = (float**)calloc(gscbeamsteer->m_nMic, sizeof(float*));
+	/* overlap-save needs nBlockSize + nTaps - 1 points, rounded up to a
+	 * length the rfft supports (2^k or 3 * 2^k) */
+	gscbeamsteer->m_nFFTLen = 0;
+	if (nTaps >= GSC_STEER_FFT_TAPS)
+	{
+		int len = 4;
+		while (len < nBlockSize + nTaps - 1)
+		{
+			len *= 2;
+		}
+		if (len / 4 * 3 >= nBlockSize + nTaps - 1)
+		{
+			len = len / 4 * 3;
+		}
+		gscbeamsteer->m_nFFTLen = len;
+	}
+	gscbeamsteer->m_nDlyLineLen = gscbeamsteer->m_nFFTLen > 0 ? gscbeamsteer->m_nFFTLen : nBlockSize + nTaps - 1;
+
+	gscbeamsteer->m_pDlyLine = (float**)dios_ssp_share_calloc_ptr(gscbeamsteer->m_nMic, sizeof(float*));
 	for (int i_mic = 0; i_mic < gscbeamsteer->m_nMic; i_mic++)
 	{
-		gscbeamsteer->m_pDlyLine[i_mic] = (float*)calloc(2 * gscbeamsteer->m_nTaps, sizeof(float));
+		gscbeamsteer->m_pDlyLine[i_mic] = (float*)dios_ssp_share_calloc(gscbeamsteer->m_nDlyLineLen, sizeof(float));
 	}
-	gscbeamsteer->m_pTaps = (float**)calloc(gscbeamsteer->m_nMic, sizeof(float*));
+	gscbeamsteer->m_pTaps = (float**)dios_ssp_share_calloc_ptr(gscbeamsteer->m_nMic, sizeof(float*));
 	for (int i_mic = 0; i_mic < gscbeamsteer->m_nMic; i_mic++)
 	{
-		gscbeamsteer->m_pTaps[i_mic] = (float*)calloc(gscbeamsteer->m_nTaps, sizeof(float));
+		gscbeamsteer->m_pTaps[i_mic] = (float*)dios_ssp_share_calloc(gscbeamsteer->m_nTaps, sizeof(float));
+	}
+	gscbeamsteer->generalfirdesign =  (objCGeneralFIRDesigner*)dios_ssp_share_calloc_map(1, sizeof(objCGeneralFIRDesigner), g_gsc_firdesign_ptr, SHARE_ARENA_MAP_NUM(g_gsc_firdesign_ptr));
+	dios_ssp_gscfirfilterdesign_init(gscbeamsteer->generalfirdesign, gscbeamsteer->m_nTaps, General_WinBlackman, table_pool);
+
+	if (gscbeamsteer->m_nFFTLen > 0)
+	{
+		gscbeamsteer->m_pFFT = dios_ssp_share_rfft_init_pool(gscbeamsteer->m_nFFTLen, table_pool);
+		gscbeamsteer->m_pFFTBuf = (float*)dios_ssp_share_calloc(gscbeamsteer->m_nFFTLen, sizeof(float));
+		gscbeamsteer->m_pTapsFreq = (float**)dios_ssp_share_calloc_ptr(gscbeamsteer->m_nMic, sizeof(float*));
+		for (int i_mic = 0; i_mic < gscbeamsteer->m_nMic; i_mic++)
+		{
+			gscbeamsteer->m_pTapsFreq[i_mic] = (float*)dios_ssp_share_calloc(gscbeamsteer->m_nFFTLen, sizeof(float));
+		}
 	}
-	gscbeamsteer->generalfirdesign =  (objCGeneralFIRDesigner*)calloc(1, sizeof(objCGeneralFIRDesigner));
-	dios_ssp_gscfirfilterdesign_init(gscbeamsteer->generalfirdesign, gscbeamsteer->m_nTaps, General_WinBlackman);
 	
 	for (int ch = 0; ch < gscbeamsteer->m_nMic; ch++)
     {
 		dios_ssp_gscfirfilterdesign_fractionaldelay(gscbeamsteer->generalfirdesign, -1.0f, 1.0f, (float)(gscbeamsteer->m_nTaps / 2), gscbeamsteer->m_pTaps[ch]);
+		dios_ssp_gsc_gscbeamsteer_tapsfreq(gscbeamsteer, ch);
     }
-	gscbeamsteer->m_nDlyLineIndex = (int*)calloc(gscbeamsteer->m_nMic, sizeof(int));
 }
 
 int dios_ssp_gsc_gscbeamsteer_reset(objCGSCbeamsteer* gscbeamsteer)
 {
 	for (int m = 0; m < gscbeamsteer->m_nMic; m++)
 	{
-		memset(gscbeamsteer->m_pDlyLine[m], 0, sizeof(float) * 2 * gscbeamsteer->m_nTaps);
+		memset(gscbeamsteer->m_pDlyLine[m], 0, sizeof(float) * gscbeamsteer->m_nDlyLineLen);
 	}
 	for (int m = 0; m < gscbeamsteer->m_nMic; m++)
 	{
@@ -141,8 +164,8 @@ int dios_ssp_gsc_gscbeamsteer_reset(objCGSCbeamsteer* gscbeamsteer)
 	for (int ch = 0; ch < gscbeamsteer->m_nMic; ch++)
     {
 		dios_ssp_gscfirfilterdesign_fractionaldelay(gscbeamsteer->generalfirdesign, -1.0f, 1.0f, (float)(gscbeamsteer->m_nTaps / 2), gscbeamsteer->m_pTaps[ch]);
+		dios_ssp_gsc_gscbeamsteer_tapsfreq(gscbeamsteer, ch);
     }
-	memset(gscbeamsteer->m_nDlyLineIndex, 0, sizeof(int) * gscbeamsteer->m_nMic);
 
 	return 0;
 }
@@ -153,6 +176,7 @@ int dios_ssp_gsc_gscbeamsteering(objCGSCbeamsteer* gscbeamsteer, float *delay_sa
 	{
 		float delay = delay_sample[ch] * (float)gscbeamsteer->m_dwKernelRate / (float)dwInputRate;
 		dios_ssp_gscfirfilterdesign_fractionaldelay(gscbeamsteer->generalfirdesign, -1.0f, 1.0f, (float)(gscbeamsteer->m_nTaps / 2) + delay, gscbeamsteer->m_pTaps[ch]);
+		dios_ssp_gsc_gscbeamsteer_tapsfreq(gscbeamsteer, ch);
 	}
 
 	return 0;
@@ -160,9 +184,23 @@ int dios_ssp_gsc_gscbeamsteering(objCGSCbeamsteer* gscbeamsteer, float *delay_sa
 
 int dios_ssp_gsc_gscbeamsteer_process(objCGSCbeamsteer* gscbeamsteer, float **X, float **Y)
 {
+	int nBlockSize = gscbeamsteer->m_nBlockSize;
+	int nHistory = gscbeamsteer->m_nDlyLineLen - nBlockSize;
+
 	for (int ch = 0; ch < gscbeamsteer->m_nMic; ch++)
 	{
-        FIRFiltering_Direct(X[ch], Y[ch], gscbeamsteer->m_nBlockSize, gscbeamsteer->m_pTaps[ch], gscbeamsteer->m_nTaps, gscbeamsteer->m_pDlyLine[ch], &(gscbeamsteer->m_nDlyLineIndex[ch]));
+		float *pDlyLine = gscbeamsteer->m_pDlyLine[ch];
+		memcpy(pDlyLine + nHistory, X[ch], nBlockSize * sizeof(float));
+		if (gscbeamsteer->m_nFFTLen > 0)
+		{
+			FIRFiltering_OverlapSave(gscbeamsteer->m_pFFT, pDlyLine, Y[ch], nBlockSize, gscbeamsteer->m_pTapsFreq[ch], 
+                    gscbeamsteer->m_nFFTLen, gscbeamsteer->m_pFFTBuf);
+		}
+		else
+		{
+			FIRFiltering_Direct(pDlyLine, Y[ch], nBlockSize, gscbeamsteer->m_pTaps[ch], gscbeamsteer->m_nTaps);
+		}
+		memmove(pDlyLine, pDlyLine + nBlockSize, nHistory * sizeof(float));
 	}
 
 	return 0;
@@ -170,17 +208,26 @@ int dios_ssp_gsc_gscbeamsteer_process(objCGSCbeamsteer* gscbeamsteer, float **X,
 int dios_ssp_gsc_gscbeamsteer_delete(objCGSCbeamsteer* gscbeamsteer)
 {
 	dios_ssp_gscfirfilterdesign_delete(gscbeamsteer->generalfirdesign);
-	free(gscbeamsteer->generalfirdesign);
+	dios_ssp_share_free(gscbeamsteer->generalfirdesign);
 	for (int i_mic = 0; i_mic < gscbeamsteer->m_nMic; i_mic++)
 	{
-		free(gscbeamsteer->m_pDlyLine[i_mic]);
+		dios_ssp_share_free(gscbeamsteer->m_pDlyLine[i_mic]);
 	}
-	free(gscbeamsteer->m_pDlyLine);
+	dios_ssp_share_free(gscbeamsteer->m_pDlyLine);
 	for (int i_mic = 0; i_mic < gscbeamsteer->m_nMic; i_mic++)
 	{
-		free(gscbeamsteer->m_pTaps[i_mic]);
+		dios_ssp_share_free(gscbeamsteer->m_pTaps[i_mic]);
+	}
+	dios_ssp_share_free(gscbeamsteer->m_pTaps);
+	if (gscbeamsteer->m_nFFTLen > 0)
+	{
+		dios_ssp_share_rfft_uninit(gscbeamsteer->m_pFFT);
+		dios_ssp_share_free(gscbeamsteer->m_pFFTBuf);
+		for (int i_mic = 0; i_mic < gscbeamsteer->m_nMic; i_mic++)
+		{
+			dios_ssp_share_free(gscbeamsteer->m_pTapsFreq[i_mic]);
+		}
+		dios_ssp_share_free(gscbeamsteer->m_pTapsFreq);
 	}
-	free(gscbeamsteer->m_pTaps);
-	free(gscbeamsteer->m_nDlyLineIndex);
 	return 0;
 }
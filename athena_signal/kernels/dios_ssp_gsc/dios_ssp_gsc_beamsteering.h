@@ -19,6 +19,13 @@ limitations under the License.
 
 #include "dios_ssp_gsc_firfilterdesign.h"
 #include "dios_ssp_gsc_dsptools.h"
+#include "../dios_ssp_share/dios_ssp_share_rfft.h"
+
+/* steering filters with at least this many taps are applied by overlap-save
+   FFT convolution, shorter ones in the time domain */
+#ifndef GSC_STEER_FFT_TAPS
+#define GSC_STEER_FFT_TAPS (32)
+#endif
 
 typedef struct
 {
@@ -27,9 +34,13 @@ typedef struct
 	int m_nTaps;           /* number of taps to use */
 	int m_nBlockSize;      /* size of one block in samples */
 	float *m_delays;       /* vector with intersensor delays */
-	float **m_pDlyLine;
+	int m_nDlyLineLen;     /* delay line length, the newest block is at the end */
+	float **m_pDlyLine;    /* [history | new block] per microphone */
 	float **m_pTaps;
-	int *m_nDlyLineIndex;
+	int m_nFFTLen;         /* overlap-save FFT length, 0 for time-domain filtering */
+	void *m_pFFT;
+	float **m_pTapsFreq;   /* spectrum of m_pTaps scaled by 1 / m_nFFTLen */
+	float *m_pFFTBuf;
 
 	objCGeneralFIRDesigner *generalfirdesign;
 	
@@ -43,10 +54,11 @@ Input:         // gscbeamsteer: gscbeamsteer object pointer
 				  nBlockSize: size of one block in samples
 				  dwKernelRate: sampling rate
 				  nTaps: number of taps to use
+				  table_pool: pool of shared read-only tables, NULL for private ones
 Return:        // success: return gscbeamsteer object pointer
 Others:        // none
 **********************************************************************************/
-void dios_ssp_gsc_gscbeamsteer_init(objCGSCbeamsteer* gscbeamsteer, int nMic, int nBlockSize, DWORD dwKernelRate, int nTaps);
+void dios_ssp_gsc_gscbeamsteer_init(objCGSCbeamsteer* gscbeamsteer, int nMic, int nBlockSize, DWORD dwKernelRate, int nTaps, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_gsc_gscbeamsteer_reset
@@ -70,7 +82,8 @@ int dios_ssp_gsc_gscbeamsteering(objCGSCbeamsteer* gscbeamsteer, float *delay_sa
 
 /**********************************************************************************
 Function:      // dios_ssp_gsc_gscbeamsteer_process
-Description:   // do delay-filtering processing
+Description:   // do delay-filtering processing, by overlap-save FFT convolution
+                  if m_nTaps >= GSC_STEER_FFT_TAPS, by direct convolution otherwise
 Input:         // X: input signals
 Output:        // Y: output delayed signals
 Return:        // success: return 0
@@ -22,8 +22,9 @@ usuallrealized by short fractional delay filters.
 ==============================================================================*/
 
 #include "dios_ssp_gsc_filtsumbeamformer.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
-void dios_ssp_gsc_gscfiltsumbeamformer_init(objFGSCfiltsumbeamformer* gscfiltsumbeamformer, int num_mic, int fft_size, int fft_overlap)
+void dios_ssp_gsc_gscfiltsumbeamformer_init(objFGSCfiltsumbeamformer* gscfiltsumbeamformer, int num_mic, int fft_size, int fft_overlap, void *table_pool)
 {
 	/* reset all pointers to NULL */
 	gscfiltsumbeamformer->Xdline = NULL;
@@ -38,18 +39,18 @@ void dios_ssp_gsc_gscfiltsumbeamformer_init(objFGSCfiltsumbeamformer* gscfiltsum
 	gscfiltsumbeamformer->filtord = 0;  /* 0 for delay-and-sum beamformer */
 	
 	/* initialize delayline for fbf inputs in time domain [old|new] */
-	gscfiltsumbeamformer->Xdline = (float**)calloc(gscfiltsumbeamformer->nmic, sizeof(float*));
+	gscfiltsumbeamformer->Xdline = (float**)dios_ssp_share_calloc_ptr(gscfiltsumbeamformer->nmic, sizeof(float*));
 	for (int i_mic = 0; i_mic < gscfiltsumbeamformer->nmic; i_mic++)
 	{
-		gscfiltsumbeamformer->Xdline[i_mic] = (float*)calloc(gscfiltsumbeamformer->fftlength, sizeof(float));
+		gscfiltsumbeamformer->Xdline[i_mic] = (float*)dios_ssp_share_calloc(gscfiltsumbeamformer->fftlength, sizeof(float));
 	}
-	gscfiltsumbeamformer->xftmp = (xcomplex*)calloc(gscfiltsumbeamformer->fftlength / 2 + 1, sizeof(xcomplex));
-	gscfiltsumbeamformer->ytmp = (float*)calloc(gscfiltsumbeamformer->fftlength, sizeof(float));
-	gscfiltsumbeamformer->yftmp = (xcomplex*)calloc(gscfiltsumbeamformer->fftlength / 2 + 1, sizeof(xcomplex));
+	gscfiltsumbeamformer->xftmp = (xcomplex*)dios_ssp_share_calloc(gscfiltsumbeamformer->fftlength / 2 + 1, sizeof(xcomplex));
+	gscfiltsumbeamformer->ytmp = (float*)dios_ssp_share_calloc(gscfiltsumbeamformer->fftlength, sizeof(float));
+	gscfiltsumbeamformer->yftmp = (xcomplex*)dios_ssp_share_calloc(gscfiltsumbeamformer->fftlength / 2 + 1, sizeof(xcomplex));
 	
-	gscfiltsumbeamformer->filt_FFT = dios_ssp_share_rfft_init(gscfiltsumbeamformer->fftlength);
-	gscfiltsumbeamformer->fft_out = (float*)calloc(gscfiltsumbeamformer->fftlength, sizeof(float));
-	gscfiltsumbeamformer->fft_in = (float*)calloc(gscfiltsumbeamformer->fftlength, sizeof(float));
+	gscfiltsumbeamformer->filt_FFT = dios_ssp_share_rfft_init_pool(gscfiltsumbeamformer->fftlength, table_pool);
+	gscfiltsumbeamformer->fft_out = (float*)dios_ssp_share_calloc(gscfiltsumbeamformer->fftlength, sizeof(float));
+	gscfiltsumbeamformer->fft_in = (float*)dios_ssp_share_calloc(gscfiltsumbeamformer->fftlength, sizeof(float));
 }
 
 int dios_ssp_gsc_gscfiltsumbeamformer_reset(objFGSCfiltsumbeamformer* gscfiltsumbeamformer)
@@ -135,15 +136,15 @@ int dios_ssp_gsc_gscfiltsumbeamformer_delete(objFGSCfiltsumbeamformer* gscfiltsu
 	int ret = 0;
 	for (int i_mic = 0; i_mic < gscfiltsumbeamformer->nmic; i_mic++)
 	{
-		free(gscfiltsumbeamformer->Xdline[i_mic]);
+		dios_ssp_share_free(gscfiltsumbeamformer->Xdline[i_mic]);
 	}
-	free(gscfiltsumbeamformer->Xdline);
+	dios_ssp_share_free(gscfiltsumbeamformer->Xdline);
 	
-	free(gscfiltsumbeamformer->xftmp);
-	free(gscfiltsumbeamformer->ytmp);
-	free(gscfiltsumbeamformer->yftmp);
-	free(gscfiltsumbeamformer->fft_out);
-	free(gscfiltsumbeamformer->fft_in);
+	dios_ssp_share_free(gscfiltsumbeamformer->xftmp);
+	dios_ssp_share_free(gscfiltsumbeamformer->ytmp);
+	dios_ssp_share_free(gscfiltsumbeamformer->yftmp);
+	dios_ssp_share_free(gscfiltsumbeamformer->fft_out);
+	dios_ssp_share_free(gscfiltsumbeamformer->fft_in);
 	ret = dios_ssp_share_rfft_uninit(gscfiltsumbeamformer->filt_FFT);
 	if (0 != ret)
 	{
@@ -42,11 +42,12 @@ typedef struct
 Function:      // dios_ssp_gsc_gscfiltsumbeamformer_init
 Description:   // fixed beamformer init
 Input:         // gscfiltsumbeamformer: fixed beamformer object pointer
+                  table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return gscfiltsumbeamformer
 Others:        // none
 **********************************************************************************/
-void dios_ssp_gsc_gscfiltsumbeamformer_init(objFGSCfiltsumbeamformer* gscfiltsumbeamformer, int num_mic, int fft_size, int fft_overlap);
+void dios_ssp_gsc_gscfiltsumbeamformer_init(objFGSCfiltsumbeamformer* gscfiltsumbeamformer, int num_mic, int fft_size, int fft_overlap, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_gsc_gscfiltsumbeamformer_reset
@@ -17,6 +17,7 @@ Description: define and implement FIR filter designing
 ==============================================================================*/
 
 #include "dios_ssp_gsc_firfilterdesign.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
 void WinBlackman(float *win, int len)
 {
@@ -48,7 +49,7 @@ void WinHanning(float *win, int len)
     }
 }
 
-void dios_ssp_gscfirfilterdesign_init(objCGeneralFIRDesigner *generalfirdesign, int len, General_WindowType winType)
+void dios_ssp_gscfirfilterdesign_init(objCGeneralFIRDesigner *generalfirdesign, int len, General_WindowType winType, void *table_pool)
 {
 	/* calculate FFT_len and make FFT_len >= FIR_len */
 	generalfirdesign->m_nFIRLen = len;
@@ -64,19 +65,19 @@ void dios_ssp_gscfirfilterdesign_init(objCGeneralFIRDesigner *generalfirdesign,
 	/* if FFT_len > FIR_len, use local taps buffer */
 	if (generalfirdesign->m_nFFTLen > generalfirdesign->m_nFIRLen)
     {
-		generalfirdesign->m_pTapsBuf = (float*)calloc(generalfirdesign->m_nFFTLen, sizeof(float));
+		generalfirdesign->m_pTapsBuf = (float*)dios_ssp_share_calloc(generalfirdesign->m_nFFTLen, sizeof(float));
     }
 	else
     {
 		generalfirdesign->m_pTapsBuf = NULL;
     }
 
-	generalfirdesign->gengralfir_FFT = dios_ssp_share_rfft_init(generalfirdesign->m_nFFTLen);
-	generalfirdesign->fft_out = (float*)calloc(generalfirdesign->m_nFFTLen, sizeof(float));
-	generalfirdesign->fft_in = (float*)calloc(generalfirdesign->m_nFFTLen, sizeof(float));
-	generalfirdesign->m_pTapsFreq = (xcomplex*)calloc(generalfirdesign->m_nCSize, sizeof(xcomplex));
-	generalfirdesign->m_mag = (float*)calloc(generalfirdesign->m_nCSize, sizeof(float));
-	generalfirdesign->m_phase = (float*)calloc(generalfirdesign->m_nCSize, sizeof(float));
+	generalfirdesign->gengralfir_FFT = dios_ssp_share_rfft_init_pool(generalfirdesign->m_nFFTLen, table_pool);
+	generalfirdesign->fft_out = (float*)dios_ssp_share_calloc(generalfirdesign->m_nFFTLen, sizeof(float));
+	generalfirdesign->fft_in = (float*)dios_ssp_share_calloc(generalfirdesign->m_nFFTLen, sizeof(float));
+	generalfirdesign->m_pTapsFreq = (xcomplex*)dios_ssp_share_calloc(generalfirdesign->m_nCSize, sizeof(xcomplex));
+	generalfirdesign->m_mag = (float*)dios_ssp_share_calloc(generalfirdesign->m_nCSize, sizeof(float));
+	generalfirdesign->m_phase = (float*)dios_ssp_share_calloc(generalfirdesign->m_nCSize, sizeof(float));
 
 	if (winType == General_WinRect)
     {
@@ -84,7 +85,7 @@ void dios_ssp_gscfirfilterdesign_init(objCGeneralFIRDesigner *generalfirdesign,
     }
 	else
 	{
-		generalfirdesign->m_win = (float*)calloc(generalfirdesign->m_nFIRLen, sizeof(float));
+		generalfirdesign->m_win = (float*)dios_ssp_share_calloc(generalfirdesign->m_nFIRLen, sizeof(float));
 		switch (winType)
 		{
         case General_WinBlackman:
@@ -281,13 +282,13 @@ int dios_ssp_gscfirfilterdesign_fractionaldelay(objCGeneralFIRDesigner *generalf
 int dios_ssp_gscfirfilterdesign_delete(objCGeneralFIRDesigner *generalfirdesign)
 {
 	int ret = 0;
-	free(generalfirdesign->m_pTapsFreq);
-	free(generalfirdesign->m_mag);
-	free(generalfirdesign->m_phase);
-	free(generalfirdesign->m_win);
-	free(generalfirdesign->m_pTapsBuf);
-	free(generalfirdesign->fft_out);
-	free(generalfirdesign->fft_in);
+	dios_ssp_share_free(generalfirdesign->m_pTapsFreq);
+	dios_ssp_share_free(generalfirdesign->m_mag);
+	dios_ssp_share_free(generalfirdesign->m_phase);
+	dios_ssp_share_free(generalfirdesign->m_win);
+	dios_ssp_share_free(generalfirdesign->m_pTapsBuf);
+	dios_ssp_share_free(generalfirdesign->fft_out);
+	dios_ssp_share_free(generalfirdesign->fft_in);
 	ret = dios_ssp_share_rfft_uninit(generalfirdesign->gengralfir_FFT);
 	if (0 != ret)
 	{
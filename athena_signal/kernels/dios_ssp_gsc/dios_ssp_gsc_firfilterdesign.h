@@ -47,11 +47,12 @@ typedef struct
 Function:      // dios_ssp_gscfirfilterdesign_init
 Description:   // fir filter design init
 Input:         // generalfirdesign: generalfirdesign object pointer
+                  table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return generalfirdesign object pointer
 Others:        // none
 **********************************************************************************/
-void dios_ssp_gscfirfilterdesign_init(objCGeneralFIRDesigner *generalfirdesign, int len, General_WindowType winType);
+void dios_ssp_gscfirfilterdesign_init(objCGeneralFIRDesigner *generalfirdesign, int len, General_WindowType winType, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_gscfirfilterdesign_fractionaldelay
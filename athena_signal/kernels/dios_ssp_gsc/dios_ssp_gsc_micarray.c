@@ -18,30 +18,42 @@ processing function.
 ==============================================================================*/
 
 #include "dios_ssp_gsc_micarray.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
-static const int gsc_sampling_rate = 16000; /* sampling rate */
-static const int gsc_block_len = 128;       /* frame len */
+static const int gsc_sampling_rate = 16000; /* reference sampling rate */
+static const int gsc_block_len = 128;       /* frame len at gsc_sampling_rate */
 
-void dios_ssp_gsc_init(objGSCProcess *ptr_gsc, int mic_num, PlaneCoord* mic_coord)
+static const size_t g_gsc_multibeamformer_ptr[] = {
+	offsetof(objCMultiGSCbeamformer, m_pOutput), offsetof(objCMultiGSCbeamformer, m_pSrcLoc),
+	offsetof(objCMultiGSCbeamformer, m_ppInput), offsetof(objCMultiGSCbeamformer, gscbeamformer),
+	offsetof(objCMultiGSCbeamformer, workpool)
+};
+
+void dios_ssp_gsc_init(objGSCProcess *ptr_gsc, int mic_num, PlaneCoord* mic_coord, int beam_num, int thread_num, int sample_rate, void *table_pool)
 {
-	/* parameter initialization */
-	ptr_gsc->nfs = gsc_sampling_rate;
-	ptr_gsc->frame_len = gsc_block_len;
+	/* parameter initialization, one frame is 8ms at any sampling rate */
+	ptr_gsc->nfs = sample_rate;
+	ptr_gsc->frame_len = gsc_block_len * sample_rate / gsc_sampling_rate;
 	ptr_gsc->mic_num = mic_num;
-	ptr_gsc->outbeam_num = 1;
+	ptr_gsc->outbeam_num = beam_num;
+	ptr_gsc->thread_num = thread_num;
 	ptr_gsc->loca_use_flag = 1;
 	ptr_gsc->type = General_ArrayArbitrary;
-	ptr_gsc->source_location.rho = 4.0f;
-	ptr_gsc->source_location.theta = 0.0f;
-	ptr_gsc->source_location.phi = 0.0f;
-	ptr_gsc->ptr_input_data_float = (float**)calloc(ptr_gsc->mic_num, sizeof(float*));
+	ptr_gsc->ptr_source_location = (PolarCoord*)dios_ssp_share_calloc(ptr_gsc->outbeam_num, sizeof(PolarCoord));
+	for (int bch = 0; bch < ptr_gsc->outbeam_num; bch++)
+	{
+		ptr_gsc->ptr_source_location[bch].rho = 4.0f;
+		ptr_gsc->ptr_source_location[bch].theta = 0.0f;
+		ptr_gsc->ptr_source_location[bch].phi = 0.0f;
+	}
+	ptr_gsc->ptr_input_data_float = (float**)dios_ssp_share_calloc_ptr(ptr_gsc->mic_num, sizeof(float*));
 	for (int i_mic = 0; i_mic < ptr_gsc->mic_num; i_mic++)
 	{
-		ptr_gsc->ptr_input_data_float[i_mic] = (float*)calloc(ptr_gsc->frame_len, sizeof(float));
+		ptr_gsc->ptr_input_data_float[i_mic] = (float*)dios_ssp_share_calloc(ptr_gsc->frame_len, sizeof(float));
 	}
 
 	/* input parameter and signal buffer init */
-	ptr_gsc->ptr_mic_coord = (PlaneCoord*)calloc(mic_num, sizeof(PlaneCoord));
+	ptr_gsc->ptr_mic_coord = (PlaneCoord*)dios_ssp_share_calloc(mic_num, sizeof(PlaneCoord));
 	for (int i = 0; i < mic_num; i++)
 	{
 		ptr_gsc->ptr_mic_coord[i].x = mic_coord[i].x;
@@ -50,11 +62,11 @@ void dios_ssp_gsc_init(objGSCProcess *ptr_gsc, int mic_num, PlaneCoord* mic_coor
 	}
 
 	/* output signal buffer init */
-	ptr_gsc->ptr_output_data_float = (float*)calloc(ptr_gsc->frame_len, sizeof(float));
-	ptr_gsc->ptr_output_data_short = (short*)calloc(ptr_gsc->frame_len, sizeof(short));
+	ptr_gsc->ptr_output_data_float = (float*)dios_ssp_share_calloc(ptr_gsc->outbeam_num * ptr_gsc->frame_len, sizeof(float));
+	ptr_gsc->ptr_output_data_short = (short*)dios_ssp_share_calloc(ptr_gsc->outbeam_num * ptr_gsc->frame_len, sizeof(short));
 
-	ptr_gsc->multigscbeamformer = (objCMultiGSCbeamformer*)calloc(1, sizeof(objCMultiGSCbeamformer));
-	dios_ssp_gsc_multibeamformer_init(ptr_gsc->multigscbeamformer, ptr_gsc->mic_num, ptr_gsc->outbeam_num, ptr_gsc->nfs, ptr_gsc->frame_len, ptr_gsc->type, ptr_gsc->ptr_mic_coord);
+	ptr_gsc->multigscbeamformer = (objCMultiGSCbeamformer*)dios_ssp_share_calloc_map(1, sizeof(objCMultiGSCbeamformer), g_gsc_multibeamformer_ptr, SHARE_ARENA_MAP_NUM(g_gsc_multibeamformer_ptr));
+	dios_ssp_gsc_multibeamformer_init(ptr_gsc->multigscbeamformer, ptr_gsc->mic_num, ptr_gsc->outbeam_num, ptr_gsc->nfs, ptr_gsc->frame_len, ptr_gsc->type, ptr_gsc->ptr_mic_coord, ptr_gsc->thread_num, table_pool);
 
 }
 
@@ -65,27 +77,31 @@ void dios_ssp_gsc_reset(objGSCProcess *ptr_gsc)
 
 void doProcess(objGSCProcess *ptr_gsc)
 {	
-	dios_ssp_gsc_multibeamformer_arraysteer(ptr_gsc->multigscbeamformer, &(ptr_gsc->source_location));
+	dios_ssp_gsc_multibeamformer_arraysteer(ptr_gsc->multigscbeamformer, ptr_gsc->ptr_source_location);
 	dios_ssp_gsc_multibeamformer_process(ptr_gsc->multigscbeamformer, ptr_gsc->ptr_input_data_float);
 	float** gsc_bfout = ptr_gsc->multigscbeamformer->m_pOutput;
-	memcpy(ptr_gsc->ptr_output_data_float, gsc_bfout[0], ptr_gsc->frame_len * sizeof(float));
+	for (int bch = 0; bch < ptr_gsc->outbeam_num; bch++)
+	{
+		memcpy(ptr_gsc->ptr_output_data_float + bch * ptr_gsc->frame_len, gsc_bfout[bch], ptr_gsc->frame_len * sizeof(float));
+	}
 }
 
 void dios_ssp_gsc_delete(objGSCProcess *ptr_gsc)
 {
-	free((void*)ptr_gsc->ptr_mic_coord);
-	free((void*)ptr_gsc->ptr_output_data_short);
-	free((void*)ptr_gsc->ptr_output_data_float);
+	dios_ssp_share_free((void*)ptr_gsc->ptr_mic_coord);
+	dios_ssp_share_free((void*)ptr_gsc->ptr_source_location);
+	dios_ssp_share_free((void*)ptr_gsc->ptr_output_data_short);
+	dios_ssp_share_free((void*)ptr_gsc->ptr_output_data_float);
 	for (int i_mic = 0; i_mic < ptr_gsc->mic_num; i_mic++)
 	{
-		free(ptr_gsc->ptr_input_data_float[i_mic]);
+		dios_ssp_share_free(ptr_gsc->ptr_input_data_float[i_mic]);
 	}
-	free(ptr_gsc->ptr_input_data_float);
+	dios_ssp_share_free(ptr_gsc->ptr_input_data_float);
 
 	if(ptr_gsc->multigscbeamformer != NULL)
 	{
 		dios_ssp_gsc_multibeamformer_delete(ptr_gsc->multigscbeamformer);
 	}
-	free(ptr_gsc->multigscbeamformer);
+	dios_ssp_share_free(ptr_gsc->multigscbeamformer);
 
 }
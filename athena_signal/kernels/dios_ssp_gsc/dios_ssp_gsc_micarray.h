@@ -31,15 +31,16 @@ typedef struct
 	int frame_len;
 	int mic_num;
 	int outbeam_num;
+	int thread_num;
 	int loca_use_flag;
 	float wakeup_loca;
 	PlaneCoord* ptr_mic_coord;
 	
 	/* input parameter and signal */
-	PolarCoord source_location;
+	PolarCoord* ptr_source_location;    /* one location for each beam */
 	float** ptr_input_data_float;
 
-	/* output signal */
+	/* output signal, outbeam_num * frame_len */
 	short* ptr_output_data_short;
 	float* ptr_output_data_float;
 	
@@ -53,12 +54,16 @@ Function:      // dios_ssp_gsc_init
 Description:   // gsc init
 Input:         // mic_num: microphone number
                   mic_coord: each microphone coordinate (PlaneCoord*)mic_coord
+                  beam_num: number of output beams
+                  thread_num: number of threads processing the beams
+                  sample_rate: sampling rate in Hz, the frame is sample_rate / 125
+                  table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return gsc object pointer (void*)ptr_gsc
                   failure: return NULL
 Others:        // none
 **********************************************************************************/
-void dios_ssp_gsc_init(objGSCProcess *ptr_gsc, int mic_num, PlaneCoord* mic_coord);
+void dios_ssp_gsc_init(objGSCProcess *ptr_gsc, int mic_num, PlaneCoord* mic_coord, int beam_num, int thread_num, int sample_rate, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_gsc_reset
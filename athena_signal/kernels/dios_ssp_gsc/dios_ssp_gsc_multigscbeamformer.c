@@ -18,23 +18,55 @@ processing function.
 ==============================================================================*/
 
 #include "dios_ssp_gsc_multigscbeamformer.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
-void dios_ssp_gsc_multibeamformer_init(objCMultiGSCbeamformer* multigscbeamformer, DWORD nMic, DWORD nBeam, DWORD dwSampRate, DWORD dwBlockSize, General_ArrayGeometric type, void *coord)
+/* one task per beam, each beam has its own steering, ABM and AIC state and
+ * only reads the shared input block, so beams can run on different threads */
+static void dios_ssp_gsc_multibeamformer_beamtask(void *arg, int bch)
 {
-    multigscbeamformer->gscbeamformer =  (objCGSCbeamformer*)calloc(1, sizeof(objCGSCbeamformer));
-    dios_ssp_gsc_gscbeamformer_init(multigscbeamformer->gscbeamformer, nMic, dwSampRate, dwBlockSize, type, coord);
+    objCMultiGSCbeamformer* multigscbeamformer = (objCMultiGSCbeamformer*)arg;
+    objCGSCbeamformer* gscbeamformer = multigscbeamformer->gscbeamformer[bch];
 
-    multigscbeamformer->m_pOutput = NULL;
+    dios_ssp_gsc_gscbeamformer_arraysteer(gscbeamformer, multigscbeamformer->m_pSrcLoc[bch]);
+    dios_ssp_gsc_gscbeamformer_process(gscbeamformer, multigscbeamformer->m_ppInput);
+}
+
+static const size_t g_gsc_beamformer_ptr[] = {
+	offsetof(objCGSCbeamformer, m_outSteering), offsetof(objCGSCbeamformer, m_outFBF),
+	offsetof(objCGSCbeamformer, m_ctrlABM), offsetof(objCGSCbeamformer, m_ctrlAIC),
+	offsetof(objCGSCbeamformer, m_outABM), offsetof(objCGSCbeamformer, m_outAIC),
+	offsetof(objCGSCbeamformer, m_output), offsetof(objCGSCbeamformer, m_locMic),
+	offsetof(objCGSCbeamformer, m_tdoa), offsetof(objCGSCbeamformer, gscbeamsteer),
+	offsetof(objCGSCbeamformer, gscfiltsumbeamformer), offsetof(objCGSCbeamformer, gscabm),
+	offsetof(objCGSCbeamformer, gscaic), offsetof(objCGSCbeamformer, gscadaptctrl)
+};
+
+void dios_ssp_gsc_multibeamformer_init(objCMultiGSCbeamformer* multigscbeamformer, DWORD nMic, DWORD nBeam, DWORD dwSampRate, DWORD dwBlockSize, General_ArrayGeometric type, void *coord, int nThread, void *table_pool)
+{
     multigscbeamformer->m_nBeam = nBeam;
-    multigscbeamformer->m_pOutput = (float**)calloc(multigscbeamformer->m_nBeam, sizeof(float*));
+    multigscbeamformer->gscbeamformer = (objCGSCbeamformer**)dios_ssp_share_calloc_ptr(multigscbeamformer->m_nBeam, sizeof(objCGSCbeamformer*));
+    multigscbeamformer->m_pOutput = (float**)dios_ssp_share_calloc_ptr(multigscbeamformer->m_nBeam, sizeof(float*));
+    multigscbeamformer->m_pSrcLoc = (PolarCoord*)dios_ssp_share_calloc(multigscbeamformer->m_nBeam, sizeof(PolarCoord));
+    multigscbeamformer->m_ppInput = NULL;
+    for (DWORD bch = 0; bch < multigscbeamformer->m_nBeam; bch++)
+    {
+        multigscbeamformer->gscbeamformer[bch] = (objCGSCbeamformer*)dios_ssp_share_calloc_map(1, sizeof(objCGSCbeamformer), g_gsc_beamformer_ptr, SHARE_ARENA_MAP_NUM(g_gsc_beamformer_ptr));
+        dios_ssp_gsc_gscbeamformer_init(multigscbeamformer->gscbeamformer[bch], nMic, dwSampRate, dwBlockSize, type, coord, table_pool);
+        multigscbeamformer->m_pOutput[bch] = multigscbeamformer->gscbeamformer[bch]->m_output;
+    }
+
+    multigscbeamformer->workpool = NULL;
+    if (nThread > 1 && nBeam > 1)
+    {
+        multigscbeamformer->workpool = dios_ssp_share_workpool_init(nThread < (int)nBeam ? nThread : (int)nBeam);
+    }
 }
 
 int dios_ssp_gsc_multibeamformer_reset(objCMultiGSCbeamformer* multigscbeamformer)
 {
-    dios_ssp_gsc_gscbeamformer_reset(multigscbeamformer->gscbeamformer);
     for(DWORD bch = 0; bch < multigscbeamformer->m_nBeam; bch++)
     {
-       multigscbeamformer->m_pOutput[bch] = multigscbeamformer->gscbeamformer->m_output;
+        dios_ssp_gsc_gscbeamformer_reset(multigscbeamformer->gscbeamformer[bch]);
     }
     
     return 0;
@@ -44,25 +76,34 @@ int dios_ssp_gsc_multibeamformer_arraysteer(objCMultiGSCbeamformer* multigscbeam
 {
     for (DWORD bch = 0; bch < multigscbeamformer->m_nBeam; bch++)
     {
-        dios_ssp_gsc_gscbeamformer_arraysteer(multigscbeamformer->gscbeamformer, pSrcLoc[bch]);
+        multigscbeamformer->m_pSrcLoc[bch] = pSrcLoc[bch];
     }
     return 0;
 }
 
 int dios_ssp_gsc_multibeamformer_process(objCMultiGSCbeamformer* multigscbeamformer, float** ppInput)
 {
-    for (DWORD bch = 0; bch < multigscbeamformer->m_nBeam; bch++)
-    {
-        dios_ssp_gsc_gscbeamformer_process(multigscbeamformer->gscbeamformer, ppInput);
-    }
+    multigscbeamformer->m_ppInput = ppInput;
+    dios_ssp_share_workpool_run(multigscbeamformer->workpool, dios_ssp_gsc_multibeamformer_beamtask, multigscbeamformer, (int)multigscbeamformer->m_nBeam);
+    multigscbeamformer->m_ppInput = NULL;
+
     return 0;
 }
 
 int dios_ssp_gsc_multibeamformer_delete(objCMultiGSCbeamformer* multigscbeamformer)
 {
-    dios_ssp_gsc_gscbeamformer_delete(multigscbeamformer->gscbeamformer);
-    free(multigscbeamformer->gscbeamformer);
-    free(multigscbeamformer->m_pOutput);
+    if (multigscbeamformer->workpool != NULL)
+    {
+        dios_ssp_share_workpool_uninit(multigscbeamformer->workpool);
+    }
+    for (DWORD bch = 0; bch < multigscbeamformer->m_nBeam; bch++)
+    {
+        dios_ssp_gsc_gscbeamformer_delete(multigscbeamformer->gscbeamformer[bch]);
+        dios_ssp_share_free(multigscbeamformer->gscbeamformer[bch]);
+    }
+    dios_ssp_share_free(multigscbeamformer->gscbeamformer);
+    dios_ssp_share_free(multigscbeamformer->m_pOutput);
+    dios_ssp_share_free(multigscbeamformer->m_pSrcLoc);
 
     return 0;
 }
@@ -29,12 +29,16 @@ limitations under the License.
 #include "dios_ssp_gsc_aic.h"
 #include "dios_ssp_gsc_adaptctrl.h"
 #include "../dios_ssp_share/dios_ssp_share_typedefs.h"
+#include "../dios_ssp_share/dios_ssp_share_workpool.h"
 
 typedef struct
 {
 	DWORD m_nBeam;
-	float **m_pOutput;
-	objCGSCbeamformer *gscbeamformer;
+	float **m_pOutput;               /* m_pOutput[bch], output block of each beam */
+	PolarCoord *m_pSrcLoc;           /* steering direction of each beam */
+	float **m_ppInput;               /* input block shared by all beams */
+	objCGSCbeamformer **gscbeamformer;
+	void *workpool;
 	
 }objCMultiGSCbeamformer;
 
@@ -43,12 +47,16 @@ Function:      // dios_ssp_gsc_multibeamformer_init
 Description:   // multibeamformer init
 Input:         // multigscbeamformer: multigscbeamformer object pointer
                   nMic: microphone number
+                  nBeam: number of independent gsc beams
                   mic_coord: each microphone coordinate (PlaneCoord*)mic_coord
+                  nThread: number of threads processing the beams, 1 means the
+                  beams are processed one after another on the caller
+                  table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return multigscbeamformer object pointer
 Others:        // none
 **********************************************************************************/
-void dios_ssp_gsc_multibeamformer_init(objCMultiGSCbeamformer* multigscbeamformer, DWORD nMic, DWORD nBeam, DWORD dwSampRate, DWORD dwBlockSize, General_ArrayGeometric type, void *coord);
+void dios_ssp_gsc_multibeamformer_init(objCMultiGSCbeamformer* multigscbeamformer, DWORD nMic, DWORD nBeam, DWORD dwSampRate, DWORD dwBlockSize, General_ArrayGeometric type, void *coord, int nThread, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_gsc_multibeamformer_reset
@@ -62,8 +70,10 @@ int dios_ssp_gsc_multibeamformer_reset(objCMultiGSCbeamformer* multigscbeamforme
 
 /**********************************************************************************
 Function:      // dios_ssp_gsc_multibeamformer_arraysteer
-Description:   // multibeamformer steering
-Input:         // prototype: pSrcLoc, polar coordinates of source locations
+Description:   // multibeamformer steering, the beams are steered at the next
+                  process call
+Input:         // prototype: pSrcLoc, polar coordinates of source locations,
+                  one for each beam
 Output:        // none
 Return:        // success: return 0
 Others:        // none
@@ -72,7 +82,8 @@ int dios_ssp_gsc_multibeamformer_arraysteer(objCMultiGSCbeamformer* multigscbeam
 
 /**********************************************************************************
 Function:      // dios_ssp_gsc_multibeamformer_process
-Description:   // process data of one block
+Description:   // process data of one block, all beams are processed on the
+                  same input, output of beam bch is in m_pOutput[bch]
 Input:         // prototype: pInput, float data, multi-channel, continuous memory
 Output:        // none
 Return:        // success: return 0
@@ -18,6 +18,7 @@ smoothing and minimum statistics.
 ==============================================================================*/
 
 #include "dios_ssp_gsc_rmNPsdOsMs.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
 float dios_ssp_gsc_rmnpsdosms_calculateM(int D)
 {	
@@ -327,28 +328,28 @@ void dios_ssp_gsc_rmnpsdosms_init(objCNPsdOsMs *npsdosms1, float fs, int L, int
 	npsdosms1->m_sumN = 0.f;
 	npsdosms1->m_SNR = 100.f;
 
-	npsdosms1->m_P = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_N = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_alpha = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_temp = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_beta = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_P1m = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_P2m = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_varP = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_Qeq = (float*)calloc(npsdosms1->m_L, sizeof(float));	
-	npsdosms1->m_sQeq = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_sQeqSub = (float*)calloc(npsdosms1->m_L, sizeof(float));	
-	npsdosms1->m_Bmin = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_Bmin_sub = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_k_mod = (float*)calloc(npsdosms1->m_L, sizeof(float));	
-	npsdosms1->m_lmin_flag = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_actmin = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_actmin_sub = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_Pmin_u = (float*)calloc(npsdosms1->m_L, sizeof(float));
-	npsdosms1->m_store = (float**)calloc(npsdosms1->m_L, sizeof(float*));
+	npsdosms1->m_P = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_N = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_alpha = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_temp = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_beta = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_P1m = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_P2m = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_varP = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_Qeq = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));	
+	npsdosms1->m_sQeq = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_sQeqSub = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));	
+	npsdosms1->m_Bmin = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_Bmin_sub = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_k_mod = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));	
+	npsdosms1->m_lmin_flag = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_actmin = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_actmin_sub = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_Pmin_u = (float*)dios_ssp_share_calloc(npsdosms1->m_L, sizeof(float));
+	npsdosms1->m_store = (float**)dios_ssp_share_calloc_ptr(npsdosms1->m_L, sizeof(float*));
 	for (int l = 0; l < npsdosms1->m_L; l++)
 	{
-		npsdosms1->m_store[l] = (float*)calloc(npsdosms1->m_U, sizeof(float));
+		npsdosms1->m_store[l] = (float*)dios_ssp_share_calloc(npsdosms1->m_U, sizeof(float));
 	}
 
     memset(npsdosms1->m_k_mod, 0, npsdosms1->m_L);
@@ -482,29 +483,29 @@ int dios_ssp_gsc_rmnpsdosms_process(objCNPsdOsMs *npsdosms1, float *pPSDInput)
 
 int dios_ssp_gsc_rmnpsdosms_delete(objCNPsdOsMs *npsdosms1)
 {
-	free(npsdosms1->m_P);
-	free(npsdosms1->m_N);
-	free(npsdosms1->m_alpha);
-	free(npsdosms1->m_temp);
-	free(npsdosms1->m_beta);
-	free(npsdosms1->m_P1m);
-	free(npsdosms1->m_P2m);
-	free(npsdosms1->m_varP);
-	free(npsdosms1->m_Qeq);
-	free(npsdosms1->m_sQeq);
-	free(npsdosms1->m_sQeqSub);
-	free(npsdosms1->m_Bmin);
-	free(npsdosms1->m_Bmin_sub);
-	free(npsdosms1->m_k_mod);
-	free(npsdosms1->m_lmin_flag);
-	free(npsdosms1->m_actmin);
-	free(npsdosms1->m_actmin_sub);
-	free(npsdosms1->m_Pmin_u);
+	dios_ssp_share_free(npsdosms1->m_P);
+	dios_ssp_share_free(npsdosms1->m_N);
+	dios_ssp_share_free(npsdosms1->m_alpha);
+	dios_ssp_share_free(npsdosms1->m_temp);
+	dios_ssp_share_free(npsdosms1->m_beta);
+	dios_ssp_share_free(npsdosms1->m_P1m);
+	dios_ssp_share_free(npsdosms1->m_P2m);
+	dios_ssp_share_free(npsdosms1->m_varP);
+	dios_ssp_share_free(npsdosms1->m_Qeq);
+	dios_ssp_share_free(npsdosms1->m_sQeq);
+	dios_ssp_share_free(npsdosms1->m_sQeqSub);
+	dios_ssp_share_free(npsdosms1->m_Bmin);
+	dios_ssp_share_free(npsdosms1->m_Bmin_sub);
+	dios_ssp_share_free(npsdosms1->m_k_mod);
+	dios_ssp_share_free(npsdosms1->m_lmin_flag);
+	dios_ssp_share_free(npsdosms1->m_actmin);
+	dios_ssp_share_free(npsdosms1->m_actmin_sub);
+	dios_ssp_share_free(npsdosms1->m_Pmin_u);
 	for (int l = 0; l < npsdosms1->m_L; l++)
 	{
-		free(npsdosms1->m_store[l]);
+		dios_ssp_share_free(npsdosms1->m_store[l]);
 	}
-	free(npsdosms1->m_store);
+	dios_ssp_share_free(npsdosms1->m_store);
 
 	return 0;
 }
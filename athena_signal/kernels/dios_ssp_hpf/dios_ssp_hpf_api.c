@@ -17,11 +17,16 @@ Description: High-pass filtering is implemented using cascaded-iir-filter.
 The cut-off frequency is 200Hz in this program. You can rewrite the iir filter
 coefficients and gains, with the help of filter design toolbox in MATLAB,
 to generate high-pass filter with cut-off frequency you set.
+The coefficients are designed at 16kHz; for other sampling rates each section
+is mapped back to its analog prototype and re-discretized with the bilinear
+transform, so the cut-off frequency stays the same.
 ==============================================================================*/
 
 #include "dios_ssp_hpf_api.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
 #define SECTION_NUM 2
+#define HPF_SAMPLE_RATE 16000
 
 // struct of filter coefficients
 typedef struct 
@@ -68,11 +73,30 @@ float hpf_calc(objHPF *srv, float x)
     return y;
 }
 
-void* dios_ssp_hpf_init_api(void)
+// Re-discretize one 16kHz section (1 - 2z^-1 + z^-2) / (1 + a1z^-1 + a2z^-2) 
+// at sample_rate. With z^-1 = (1 - s) / (1 + s) the denominator becomes 
+// A*s^2 + B*s + C and the numerator 4*s^2; changing the rate scales s by 
+// r = 16000 / sample_rate, i.e. B *= r and C *= r^2.
+static void hpf_section_resample(objHPF *srv, int section, int sample_rate)
+{
+    double a1 = srv->den_1[section];
+    double a2 = srv->den_2[section];
+    double r = (double)HPF_SAMPLE_RATE / sample_rate;
+    double A = 1.0 - a1 + a2;
+    double B = 2.0 * (1.0 - a2) * r;
+    double C = (1.0 + a1 + a2) * r * r;
+    double k = 4.0 / (A + B + C);
+
+    srv->den_1[section] = (float)(0.5 * k * (C - A));
+    srv->den_2[section] = (float)(1.0 - 0.5 * k * B);
+    srv->hpf_gain[section] = (float)(srv->hpf_gain[section] * k);
+}
+
+void* dios_ssp_hpf_init_api(int sample_rate)
 {
     void* ptr = NULL;
     objHPF *srv;
-	ptr = (void*)calloc(1, sizeof(objHPF));
+	ptr = (void*)dios_ssp_share_calloc(1, sizeof(objHPF));
     srv = (objHPF *)ptr;
     int i;
 
@@ -99,6 +123,14 @@ void* dios_ssp_hpf_init_api(void)
     srv->den_2[1] = 0.8855f;
     srv->hpf_gain[1] = 0.9417f;
 
+    if (sample_rate != HPF_SAMPLE_RATE)
+    {
+        for(i = 0; i < SECTION_NUM; i++)
+        {
+            hpf_section_resample(srv, i, sample_rate);
+        }
+    }
+
     return ptr;
 }
 
@@ -148,7 +180,7 @@ int dios_ssp_hpf_uninit_api(void* ptr)
 	}
 	objHPF *srv;
     srv = (objHPF *) ptr;
-    free(srv);
+    dios_ssp_share_free(srv);
 	return 0;
 }
 
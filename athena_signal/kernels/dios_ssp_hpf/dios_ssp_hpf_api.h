@@ -22,12 +22,12 @@ limitations under the License.
 /**********************************************************************************
 Function:      // dios_ssp_hpf_init_api
 Description:   // init hpf module
-Input:         // none
+Input:         // sample_rate: sampling rate in Hz
 Output:        // none
 Return:        // success: return hpf module pointer
                   failure: return NULL
 **********************************************************************************/
-void* dios_ssp_hpf_init_api(void);
+void* dios_ssp_hpf_init_api(int sample_rate);
 
 /**********************************************************************************
 Function:      // dios_ssp_hpf_reset_api
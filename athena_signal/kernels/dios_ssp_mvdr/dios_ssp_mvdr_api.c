@@ -24,13 +24,36 @@ microphones(mic_coord) beforehand.
 ==============================================================================*/
 
 #include "dios_ssp_mvdr_api.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
-void* dios_ssp_mvdr_init_api(int mic_num, void* mic_coord)
+static const size_t g_mvdr_ptr[] = {
+	offsetof(objMVDR, m_mch_buffer), offsetof(objMVDR, m_win_data),
+	offsetof(objMVDR, m_re), offsetof(objMVDR, m_im),
+	offsetof(objMVDR, m_re_temp), offsetof(objMVDR, m_im_temp),
+	offsetof(objMVDR, m_stv_re), offsetof(objMVDR, m_stv_im),
+	offsetof(objMVDR, m_rnn_re), offsetof(objMVDR, m_rnn_im),
+	offsetof(objMVDR, m_lnn_re), offsetof(objMVDR, m_lnn_im),
+	offsetof(objMVDR, m_lnn_valid), offsetof(objMVDR, m_rw_re),
+	offsetof(objMVDR, m_rw_im), offsetof(objMVDR, m_weight_sd_re),
+	offsetof(objMVDR, m_weight_sd_im), offsetof(objMVDR, m_ns_ps_cur_mic),
+	offsetof(objMVDR, m_ns_ps), offsetof(objMVDR, m_P),
+	offsetof(objMVDR, m_Ptmp), offsetof(objMVDR, m_Pmin),
+	offsetof(objMVDR, m_pk), offsetof(objMVDR, m_xn_re),
+	offsetof(objMVDR, m_xn_im), offsetof(objMVDR, m_weight_re),
+	offsetof(objMVDR, m_weight_im), offsetof(objMVDR, m_mvdr_out_re),
+	offsetof(objMVDR, m_mvdr_out_im), offsetof(objMVDR, m_out_bf),
+	offsetof(objMVDR, cood), offsetof(objMVDR, mvdrwin),
+	offsetof(objMVDR, mvdrinv), offsetof(objMVDR, mvdr_fft),
+	offsetof(objMVDR, fft_in), offsetof(objMVDR, fft_out),
+	offsetof(objMVDR, dist), offsetof(objMVDR, table_pool)
+};
+
+void* dios_ssp_mvdr_init_api(int mic_num, void* mic_coord, int sample_rate, void* table_pool)
 {
 	void* st = NULL;
-	st = (void*)calloc(1, sizeof(objMVDR));
+	st = (void*)dios_ssp_share_calloc_map(1, sizeof(objMVDR), g_mvdr_ptr, SHARE_ARENA_MAP_NUM(g_mvdr_ptr));
 	objMVDR* ptr = (objMVDR*)st;
-	dios_ssp_mvdr_init(ptr, mic_num, (PlaneCoord*)mic_coord);
+	dios_ssp_mvdr_init(ptr, mic_num, (PlaneCoord*)mic_coord, sample_rate, table_pool);
 
 	return st;	
 }
@@ -50,15 +73,39 @@ int dios_ssp_mvdr_reset_api(void *ptr)
 	return 0;
 }
 
-int dios_ssp_mvdr_process_api(void* ptr, float* mic_data, float* out_data, float loc_phi)
+/* elevation in whole degrees, -90 ~ 90 */
+static int dios_ssp_mvdr_elevation(float loc_elevation)
+{
+	if (loc_elevation < -90.0f)
+	{
+		return -90;
+	}
+	if (loc_elevation > 90.0f)
+	{
+		return 90;
+	}
+
+	return (int)floorf(loc_elevation + 0.5f);
+}
+
+int dios_ssp_mvdr_process_api(void* ptr, float* mic_data, float* out_data, float loc_phi, float loc_elevation)
 {
 	int angle;
-	angle = (int)(loc_phi + 0.5);
+	angle = (int)(loc_phi + 0.5) % 360;
 	objMVDR *ptr_mvdr;
 	ptr_mvdr= (objMVDR*)ptr;
-	dios_ssp_mvdr_process(ptr_mvdr, mic_data, out_data, angle);
 	
-	return 0;
+	return dios_ssp_mvdr_process(ptr_mvdr, mic_data, out_data, angle, dios_ssp_mvdr_elevation(loc_elevation));
+}
+
+int dios_ssp_mvdr_process_spectrum_api(void* ptr, const float* mic_re, const float* mic_im, float* out_data, float loc_phi, float loc_elevation)
+{
+	int angle;
+	angle = (int)(loc_phi + 0.5) % 360;
+	objMVDR *ptr_mvdr;
+	ptr_mvdr= (objMVDR*)ptr;
+	
+	return dios_ssp_mvdr_process_spectrum(ptr_mvdr, mic_re, mic_im, out_data, angle, dios_ssp_mvdr_elevation(loc_elevation));
 }
 
 int dios_ssp_mvdr_uninit_api(void *ptr)
@@ -66,7 +113,7 @@ int dios_ssp_mvdr_uninit_api(void *ptr)
 	objMVDR *ptr_mvdr;
 	ptr_mvdr= (objMVDR*)ptr;
 	dios_ssp_mvdr_delete(ptr_mvdr);
-    free(ptr_mvdr);
+    dios_ssp_share_free(ptr_mvdr);
 
 	return 0;
 }
@@ -25,11 +25,17 @@ Function:      // dios_ssp_mvdr_init_api
 Description:   // mvdr init
 Input:         // mic_num: microphone number
 				  mic_coord: each microphone coordinate (PlaneCoord*)mic_coord
+				  sample_rate: sampling rate in Hz, the window and shift are
+				  DEFAULT_MVDR_WIN_SIZE and DEFAULT_MVDR_SHIFT_SIZE scaled by
+				  sample_rate / DEFAULT_MVDR_SAMPLING_FRQ
+				  table_pool: pool of read-only tables shared with other
+				  instances, the initial superdirective weights are shared
+				  by instances of the same array, NULL for private tables
 Output:        // none
 Return:        // success: return mvdr object pointer (void*)ptr_mvdr
                   failure: return NULL
 **********************************************************************************/
-void* dios_ssp_mvdr_init_api(int mic_num, void* mic_coord);
+void* dios_ssp_mvdr_init_api(int mic_num, void* mic_coord, int sample_rate, void* table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_mvdr_reset_api
@@ -46,10 +52,30 @@ Description:   // mvdr process
 Input:         // ptr: mvdr object pointer
                   mic_data: mvdr input data, data type is float
                   loc_phi: direction of wakeup
+                  loc_elevation: elevation of wakeup in degrees above the x-y
+                  plane of the coordinates, -90 ~ 90, 0 in the plane. the
+                  steering vector is computed for a grid of
+                  DEFAULT_MVDR_DELTA_ANGLE in both angles when the direction
+                  moves to another grid point
 Output:        // out_data: mvdr output signal
 Return:        // success: return 0, failure: return ERROR_MVDR
 **********************************************************************************/
-int dios_ssp_mvdr_process_api(void* ptr, float* mic_data, float* out_data, float loc_phi);
+int dios_ssp_mvdr_process_api(void* ptr, float* mic_data, float* out_data, float loc_phi, float loc_elevation);
+
+/**********************************************************************************
+Function:      // dios_ssp_mvdr_process_spectrum_api
+Description:   // mvdr process on the stft computed by the caller, e.g. shared
+                  with doa, the analysis window and fft must be the same as
+                  dios_ssp_mvdr_process_api
+Input:         // ptr: mvdr object pointer
+                  mic_re: real part of the spectrum, mic_re[ch*m_fft_size+k]
+                  mic_im: imag part of the spectrum, mic_im[ch*m_fft_size+k]
+                  loc_phi: direction of wakeup
+                  loc_elevation: elevation of wakeup, see dios_ssp_mvdr_process_api
+Output:        // out_data: mvdr output signal
+Return:        // success: return 0, failure: return ERROR_MVDR
+**********************************************************************************/
+int dios_ssp_mvdr_process_spectrum_api(void* ptr, const float* mic_re, const float* mic_im, float* out_data, float loc_phi, float loc_elevation);
 
 /**********************************************************************************
 Function:      // dios_ssp_mvdr_uninit_api
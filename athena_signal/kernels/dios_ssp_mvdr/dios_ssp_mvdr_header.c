@@ -18,42 +18,37 @@ estimation using MCRA, and the autocorrelation matrix Rnn estimation.
 ==============================================================================*/
 
 #include "dios_ssp_mvdr_header.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
-int dios_ssp_mvdr_init_diffuse_rnn(objMVDR *ptr_mvdr)
+int dios_ssp_mvdr_init_diffuse_rnn(const objMVDR *ptr_mvdr, float *sd_irnn_re, float *sd_irnn_im)
 {
     int i, j, k;
 	float f = 0, temp = 0;
+	float *sd_rnn_re = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));
+
+	if (sd_rnn_re == NULL)
+	{
+		return ERROR_MVDR;
+	}
 	for (k = 1; k < ptr_mvdr->m_sp_size; k++)
 	{
 		f = ptr_mvdr->m_deta_fs*k;
 		for (i = 0; i < ptr_mvdr->m_channels; i++)
 		{
-			ptr_mvdr->m_sd_rnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+i] = 1.0f*(1+ptr_mvdr->m_sd_factor)+ptr_mvdr->m_sd_eps;
+			sd_rnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+i] = 1.0f*(1+ptr_mvdr->m_sd_factor)+ptr_mvdr->m_sd_eps;
 			for (j = i+1; j < ptr_mvdr->m_channels; j++)
 			{				
 				temp = 2 * PI * f * ptr_mvdr->dist[i * ptr_mvdr->m_channels + j] / VELOCITY;
-				ptr_mvdr->m_sd_rnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j] = (float)(sin(temp)/temp);
-				ptr_mvdr->m_sd_rnn_re[k*ptr_mvdr->m_rxx_size+j*ptr_mvdr->m_channels+i] = ptr_mvdr->m_sd_rnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j];
-			}
-		}
-		for (i = 0; i < ptr_mvdr->m_channels; i++)
-		{
-			for (j = 0; j < ptr_mvdr->m_channels; j++)
-			{
-				ptr_mvdr->m_rxx_in[i*ptr_mvdr->m_channels*2+2*j] = ptr_mvdr->m_sd_rnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j];
-				ptr_mvdr->m_rxx_in[i*ptr_mvdr->m_channels*2+2*j+1] = 0;
-			}
-		}
-		dios_ssp_matrix_inv_process(ptr_mvdr->mvdrinv, ptr_mvdr->m_rxx_in, ptr_mvdr->m_irxx_out);	
-		for (i = 0; i < ptr_mvdr->m_channels; ++i)
-		{
-			for (j = 0; j < ptr_mvdr->m_channels; ++j)
-			{
-				ptr_mvdr->m_sd_irnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j] = ptr_mvdr->m_irxx_out[i*ptr_mvdr->m_channels*2+2*j];
-				ptr_mvdr->m_sd_irnn_im[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j] = ptr_mvdr->m_irxx_out[i*ptr_mvdr->m_channels*2+2*j+1];
+				sd_rnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j] = (float)(sin(temp)/temp);
+				sd_rnn_re[k*ptr_mvdr->m_rxx_size+j*ptr_mvdr->m_channels+i] = sd_rnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j];
 			}
 		}
 	}
+	// a bin that cannot be inverted gets a zero inverse, dios_ssp_mvdr_init_sd_weights
+	// falls back to delay-and-sum weights there
+	dios_ssp_hermitian_inv_process(ptr_mvdr->mvdrinv, sd_rnn_re+ptr_mvdr->m_rxx_size, NULL, 
+		sd_irnn_re+ptr_mvdr->m_rxx_size, sd_irnn_im+ptr_mvdr->m_rxx_size, ptr_mvdr->m_sp_size-1);
+	dios_ssp_share_free(sd_rnn_re);
 
 	return 0;
 }
@@ -61,207 +56,244 @@ int dios_ssp_mvdr_init_diffuse_rnn(objMVDR *ptr_mvdr)
 int dios_ssp_mvdr_alloc_mem(objMVDR *ptr_mvdr)
 {
     int i;
-	ptr_mvdr->m_mch_buffer = (float**)calloc(ptr_mvdr->m_channels, sizeof(float*));
+	ptr_mvdr->m_mch_buffer = (float**)dios_ssp_share_calloc_ptr(ptr_mvdr->m_channels, sizeof(float*));
 	for (i = 0; i < ptr_mvdr->m_channels; ++i )
 	{
-		ptr_mvdr->m_mch_buffer[i] = (float*)calloc(ptr_mvdr->m_fft_size, sizeof(float));
+		ptr_mvdr->m_mch_buffer[i] = (float*)dios_ssp_share_calloc(ptr_mvdr->m_fft_size, sizeof(float));
 	}
 	
-	ptr_mvdr->m_win_data = (float*)calloc(ptr_mvdr->m_fft_size*ptr_mvdr->m_channels, sizeof(float));
-	ptr_mvdr->m_re = (float*)calloc(ptr_mvdr->m_fft_size*ptr_mvdr->m_channels, sizeof(float));
-	ptr_mvdr->m_im = (float*)calloc(ptr_mvdr->m_fft_size*ptr_mvdr->m_channels, sizeof(float));
-	ptr_mvdr->m_re_temp = (float*)calloc(ptr_mvdr->m_fft_size*ptr_mvdr->m_channels, sizeof(float));	
-	ptr_mvdr->m_im_temp = (float*)calloc(ptr_mvdr->m_fft_size*ptr_mvdr->m_channels, sizeof(float));
+	ptr_mvdr->m_win_data = (float*)dios_ssp_share_calloc(ptr_mvdr->m_fft_size*ptr_mvdr->m_channels, sizeof(float));
+	ptr_mvdr->m_re = (float*)dios_ssp_share_calloc(ptr_mvdr->m_fft_size*ptr_mvdr->m_channels, sizeof(float));
+	ptr_mvdr->m_im = (float*)dios_ssp_share_calloc(ptr_mvdr->m_fft_size*ptr_mvdr->m_channels, sizeof(float));
+	ptr_mvdr->m_re_temp = (float*)dios_ssp_share_calloc(ptr_mvdr->m_fft_size*ptr_mvdr->m_channels, sizeof(float));	
+	ptr_mvdr->m_im_temp = (float*)dios_ssp_share_calloc(ptr_mvdr->m_fft_size*ptr_mvdr->m_channels, sizeof(float));
 	
-	ptr_mvdr->m_rnn_re = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));
-	ptr_mvdr->m_rnn_im = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));	
-	ptr_mvdr->m_irnn_re = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));
-	ptr_mvdr->m_irnn_im = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));
+	ptr_mvdr->m_rnn_re = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));
+	ptr_mvdr->m_rnn_im = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));	
+	ptr_mvdr->m_lnn_re = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));
+	ptr_mvdr->m_lnn_im = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));
+	ptr_mvdr->m_lnn_valid = (int*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size, sizeof(int));
+	ptr_mvdr->m_rw_re = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float));
+	ptr_mvdr->m_rw_im = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float));
 	
-	ptr_mvdr->m_rxx_in = (float*)calloc(2*ptr_mvdr->m_rxx_size, sizeof(float));
-	ptr_mvdr->m_irxx_out = (float*)calloc(2*ptr_mvdr->m_rxx_size, sizeof(float));
-	
-	ptr_mvdr->m_sd_rnn_re = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));
-	ptr_mvdr->m_sd_irnn_re = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));
-	ptr_mvdr->m_sd_irnn_im = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));
-	
-	ptr_mvdr->m_weight_sd_group_re = (float*)calloc(ptr_mvdr->m_angle_num*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float));
-	ptr_mvdr->m_weight_sd_group_im = (float*)calloc(ptr_mvdr->m_angle_num*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float));
+	ptr_mvdr->m_weight_re = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float));
+	ptr_mvdr->m_weight_im = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float));
 
-	ptr_mvdr->m_weight_re = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float));
-	ptr_mvdr->m_weight_im = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float));
+	ptr_mvdr->m_mvdr_out_re = (float*)dios_ssp_share_calloc(ptr_mvdr->m_fft_size, sizeof(float));
+	ptr_mvdr->m_mvdr_out_im = (float*)dios_ssp_share_calloc(ptr_mvdr->m_fft_size, sizeof(float));
+	ptr_mvdr->m_out_bf = (float*)dios_ssp_share_calloc(ptr_mvdr->m_fft_size, sizeof(float));
 
-	ptr_mvdr->m_mvdr_out_re = (float*)calloc(ptr_mvdr->m_fft_size, sizeof(float));
-	ptr_mvdr->m_mvdr_out_im = (float*)calloc(ptr_mvdr->m_fft_size, sizeof(float));
-	ptr_mvdr->m_out_bf = (float*)calloc(ptr_mvdr->m_fft_size, sizeof(float));
-
-    // grid steering vectors
-	ptr_mvdr->m_gstv_re = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_angle_num*ptr_mvdr->m_channels, sizeof(float));
-	ptr_mvdr->m_gstv_im = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_angle_num*ptr_mvdr->m_channels, sizeof(float));
-	ptr_mvdr->m_stv_re = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float));
-	ptr_mvdr->m_stv_im = (float*)calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float));
+	ptr_mvdr->m_stv_re = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float));
+	ptr_mvdr->m_stv_im = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float));
 
 	// mcra 
-	ptr_mvdr->m_ns_ps_cur_mic = (float*)calloc(ptr_mvdr->m_fft_size, sizeof(float));
-    ptr_mvdr->m_ns_theta_cur_mic = (float*)calloc(ptr_mvdr->m_fft_size, sizeof(float));
-	ptr_mvdr->m_ns_ps = (float*)calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
-	ptr_mvdr->m_P = (float*)calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
-	ptr_mvdr->m_Ptmp = (float*)calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
-	ptr_mvdr->m_Pmin = (float*)calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
-	ptr_mvdr->m_pk = (float*)calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
-	ptr_mvdr->m_xn_re = (float*)calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
-	ptr_mvdr->m_xn_im = (float*)calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
+	ptr_mvdr->m_ns_ps_cur_mic = (float*)dios_ssp_share_calloc(ptr_mvdr->m_fft_size, sizeof(float));
+	ptr_mvdr->m_ns_ps = (float*)dios_ssp_share_calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
+	ptr_mvdr->m_P = (float*)dios_ssp_share_calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
+	ptr_mvdr->m_Ptmp = (float*)dios_ssp_share_calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
+	ptr_mvdr->m_Pmin = (float*)dios_ssp_share_calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
+	ptr_mvdr->m_pk = (float*)dios_ssp_share_calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
+	ptr_mvdr->m_xn_re = (float*)dios_ssp_share_calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
+	ptr_mvdr->m_xn_im = (float*)dios_ssp_share_calloc(ptr_mvdr->m_channels*ptr_mvdr->m_fft_size, sizeof(float));
 	
 	dios_ssp_mvdr_reset(ptr_mvdr);
 
 	return 0;
 }
 
-int dios_ssp_mvdr_init_steering_vectors_g(objMVDR *ptr_mvdr)
+/* steering vector of grid point g, azimuth g % m_angle_num and elevation 
+   g / m_angle_num of the DEFAULT_MVDR_DELTA_ANGLE grid, all bins */
+void dios_ssp_mvdr_init_steering_vector(const objMVDR *ptr_mvdr, int g, float *stv_re, float *stv_im)
 {
 	float deta = 0.0f;
-	float theta = 0.0f;
-	float phi = PI * 0.5f;
+	float theta = (float)(g % ptr_mvdr->m_angle_num) * (float)ptr_mvdr->m_delta_angle * PI / 180.0f;
+	float phi = PI * 0.5f - (float)((g / ptr_mvdr->m_angle_num) * ptr_mvdr->m_delta_angle - 90) * PI / 180.0f;
 	float omega = 0.0f;
-    int i, j, k;
+	double proj;
+    int j, k;
 
-	for (i = 0; i < ptr_mvdr->m_angle_num; ++i )
+	for (j = 0; j < ptr_mvdr->m_channels; ++j )
 	{
-		theta = (float)i * (float)ptr_mvdr->m_delta_angle * PI / 180.0f;
+		/* distance along the direction, the phase of bin k is omega * proj / VELOCITY */
+		proj = ptr_mvdr->cood[j].x * cos(theta) * sin(phi) + ptr_mvdr->cood[j].y * sin(theta) * sin(phi) + ptr_mvdr->cood[j].z * cos(phi);
 		for (k = 0; k < ptr_mvdr->m_sp_size; ++k )
 		{
 			omega = 2.0f * PI * ptr_mvdr->m_deta_fs * (float)k;
-			for (j = 0; j < ptr_mvdr->m_channels; ++j )
-			{
-				deta = (float)(omega  * (ptr_mvdr->cood[j].x * cos(theta) * sin(phi) + ptr_mvdr->cood[j].y * sin(theta) * sin(phi) + ptr_mvdr->cood[j].z * cos(phi))/ VELOCITY);
-				ptr_mvdr->m_gstv_re[i*ptr_mvdr->m_gstv_dim+k*ptr_mvdr->m_channels+j] = (float)cos(deta);
-				ptr_mvdr->m_gstv_im[i*ptr_mvdr->m_gstv_dim+k*ptr_mvdr->m_channels+j] = (float)sin(deta);
-			}
+			deta = (float)(omega * proj / VELOCITY);
+			stv_re[k*ptr_mvdr->m_channels+j] = (float)cos(deta);
+			stv_im[k*ptr_mvdr->m_channels+j] = (float)sin(deta);
 		}
 	}
+}
 
-	return 0;
+/* grid point nearest below azimuth angle and nearest to elevation, degrees */
+static int dios_ssp_mvdr_grid_point(const objMVDR *ptr_mvdr, int angle, int elevation)
+{
+	int e = (elevation + 90 + ptr_mvdr->m_delta_angle / 2) / ptr_mvdr->m_delta_angle;
+
+	if (e > ptr_mvdr->m_elev_num - 1)
+	{
+		e = ptr_mvdr->m_elev_num - 1;
+	}
+
+	return e * ptr_mvdr->m_angle_num + angle / ptr_mvdr->m_delta_angle;
 }
 
-int dios_ssp_mvdr_init_sd_weights(objMVDR *ptr_mvdr)
+int dios_ssp_mvdr_init_sd_weights(const objMVDR *ptr_mvdr, const float *stv_re, const float *stv_im, 
+	float *weight_sd_re, float *weight_sd_im)
 {
-    int i, j, k, m;
-	dios_ssp_mvdr_init_diffuse_rnn(ptr_mvdr);
+    int i, j, k;
+	float *sd_irnn_re = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));
+	float *sd_irnn_im = (float*)dios_ssp_share_calloc(ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size, sizeof(float));
+
+	if (sd_irnn_re == NULL || sd_irnn_im == NULL 
+		|| 0 != dios_ssp_mvdr_init_diffuse_rnn(ptr_mvdr, sd_irnn_re, sd_irnn_im))
+	{
+		dios_ssp_share_free(sd_irnn_re);
+		dios_ssp_share_free(sd_irnn_im);
+		return ERROR_MVDR;
+	}
 	
 	float re_temp, im_temp, power, re_temp2, im_temp2;	
 	
-	for (m = 0; m < ptr_mvdr->m_angle_num; m++)
-	{
-		for (k = 1; k < ptr_mvdr->m_fft_size/2; k++ )	
-		{		
-			for (i = 0; i < ptr_mvdr->m_channels; i++)		
-			{			
-				re_temp = im_temp = 0;			
-				for (j = 0; j < ptr_mvdr->m_channels; j++)			
-				{				
-					re_temp += ptr_mvdr->m_sd_irnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j]*ptr_mvdr->m_gstv_re[m*ptr_mvdr->m_gstv_dim+k*ptr_mvdr->m_channels+j] 
-								- ptr_mvdr->m_sd_irnn_im[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j]*ptr_mvdr->m_gstv_im[m*ptr_mvdr->m_gstv_dim+k*ptr_mvdr->m_channels+j];
-					im_temp += ptr_mvdr->m_sd_irnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j]*ptr_mvdr->m_gstv_im[m*ptr_mvdr->m_gstv_dim+k*ptr_mvdr->m_channels+j] 
-							+ ptr_mvdr->m_sd_irnn_im[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j]*ptr_mvdr->m_gstv_re[m*ptr_mvdr->m_gstv_dim+k*ptr_mvdr->m_channels+j];
-				}						
-				ptr_mvdr->m_weight_sd_group_re[m*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels+k*ptr_mvdr->m_channels+i] = re_temp;		
-				ptr_mvdr->m_weight_sd_group_im[m*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels+k*ptr_mvdr->m_channels+i] = im_temp;		
-			}					
-			re_temp = im_temp = 0;		
-			for (i = 0; i < ptr_mvdr->m_channels; i++ )		
-			{			
-				re_temp += ptr_mvdr->m_gstv_re[m*ptr_mvdr->m_gstv_dim+k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_weight_sd_group_re[m*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels+k*ptr_mvdr->m_channels+i] 
-						+ ptr_mvdr->m_gstv_im[m*ptr_mvdr->m_gstv_dim+k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_weight_sd_group_im[m*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels+k*ptr_mvdr->m_channels+i];
-				im_temp += ptr_mvdr->m_gstv_re[m*ptr_mvdr->m_gstv_dim+k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_weight_sd_group_im[m*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels+k*ptr_mvdr->m_channels+i] 
-						- ptr_mvdr->m_gstv_im[m*ptr_mvdr->m_gstv_dim+k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_weight_sd_group_re[m*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels+k*ptr_mvdr->m_channels+i];
-			}				
-			power = re_temp*re_temp + im_temp*im_temp;
-			for (i = 0; i < ptr_mvdr->m_channels; i++)		
-			{	
-				re_temp2 = (re_temp*ptr_mvdr->m_weight_sd_group_re[m*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels+k*ptr_mvdr->m_channels+i]
-						+im_temp*ptr_mvdr->m_weight_sd_group_im[m*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels+k*ptr_mvdr->m_channels+i])/power;
-				im_temp2 = (re_temp*ptr_mvdr->m_weight_sd_group_im[m*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels+k*ptr_mvdr->m_channels+i]
-						-im_temp*ptr_mvdr->m_weight_sd_group_re[m*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels+k*ptr_mvdr->m_channels+i])/power; 
-
-				ptr_mvdr->m_weight_sd_group_re[m*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels+k*ptr_mvdr->m_channels+i] = re_temp2;			
-				ptr_mvdr->m_weight_sd_group_im[m*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels+k*ptr_mvdr->m_channels+i] = im_temp2;
+	for (k = 1; k < ptr_mvdr->m_fft_size/2; k++ )	
+	{		
+		for (i = 0; i < ptr_mvdr->m_channels; i++)		
+		{			
+			re_temp = im_temp = 0;			
+			for (j = 0; j < ptr_mvdr->m_channels; j++)			
+			{				
+				re_temp += sd_irnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j]*stv_re[k*ptr_mvdr->m_channels+j] 
+							- sd_irnn_im[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j]*stv_im[k*ptr_mvdr->m_channels+j];
+				im_temp += sd_irnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j]*stv_im[k*ptr_mvdr->m_channels+j] 
+						+ sd_irnn_im[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j]*stv_re[k*ptr_mvdr->m_channels+j];
+			}						
+			weight_sd_re[k*ptr_mvdr->m_channels+i] = re_temp;		
+			weight_sd_im[k*ptr_mvdr->m_channels+i] = im_temp;		
+		}					
+		re_temp = im_temp = 0;		
+		for (i = 0; i < ptr_mvdr->m_channels; i++ )		
+		{			
+			re_temp += stv_re[k*ptr_mvdr->m_channels+i]*weight_sd_re[k*ptr_mvdr->m_channels+i] 
+					+ stv_im[k*ptr_mvdr->m_channels+i]*weight_sd_im[k*ptr_mvdr->m_channels+i];
+			im_temp += stv_re[k*ptr_mvdr->m_channels+i]*weight_sd_im[k*ptr_mvdr->m_channels+i] 
+					- stv_im[k*ptr_mvdr->m_channels+i]*weight_sd_re[k*ptr_mvdr->m_channels+i];
+		}				
+		power = re_temp*re_temp + im_temp*im_temp;
+		if (!(power > 0))
+		{
+			// the diffuse rnn of this bin could not be inverted, use delay-and-sum
+			for (i = 0; i < ptr_mvdr->m_channels; i++)
+			{
+				weight_sd_re[k*ptr_mvdr->m_channels+i] = stv_re[k*ptr_mvdr->m_channels+i] / ptr_mvdr->m_channels;
+				weight_sd_im[k*ptr_mvdr->m_channels+i] = stv_im[k*ptr_mvdr->m_channels+i] / ptr_mvdr->m_channels;
 			}
+			continue;
+		}
+		for (i = 0; i < ptr_mvdr->m_channels; i++)		
+		{	
+			re_temp2 = (re_temp*weight_sd_re[k*ptr_mvdr->m_channels+i]
+					+im_temp*weight_sd_im[k*ptr_mvdr->m_channels+i])/power;
+			im_temp2 = (re_temp*weight_sd_im[k*ptr_mvdr->m_channels+i]
+					-im_temp*weight_sd_re[k*ptr_mvdr->m_channels+i])/power; 
+
+			weight_sd_re[k*ptr_mvdr->m_channels+i] = re_temp2;			
+			weight_sd_im[k*ptr_mvdr->m_channels+i] = im_temp2;
 		}
 	}
 	
-	int ang_region = ptr_mvdr->m_angle_pre/ptr_mvdr->m_delta_angle;
-	memcpy(ptr_mvdr->m_weight_re, ptr_mvdr->m_weight_sd_group_re+ang_region*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels);
-	memcpy(ptr_mvdr->m_weight_im, ptr_mvdr->m_weight_sd_group_im+ang_region*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels);
+	dios_ssp_share_free(sd_irnn_re);
+	dios_ssp_share_free(sd_irnn_im);
 
 	return 0;
 }
 
-int dios_ssp_mvdr_free_mem(objMVDR *ptr_mvdr)
+/* ShareTableBuild of the superdirective weights of the initial direction, real
+   parts then imaginary parts, arg is the instance being initialized */
+static int dios_ssp_mvdr_table_build(void *table, const void *arg)
 {
-    int i;
+	const objMVDR *ptr_mvdr = (const objMVDR*)arg;
+	float *weight_sd_re = (float*)table;
+	float *weight_sd_im = weight_sd_re + ptr_mvdr->m_gstv_dim;
+	float *stv_re = (float*)dios_ssp_share_calloc(2 * ptr_mvdr->m_gstv_dim, sizeof(float));
+	int ret;
 
-	for (i = 0; i < ptr_mvdr->m_channels; ++i )
+	if (stv_re == NULL)
 	{
-		free(ptr_mvdr->m_mch_buffer[i]);
+		return ERROR_MVDR;
 	}
-	free(ptr_mvdr->m_mch_buffer);
-	free(ptr_mvdr->m_win_data);
-	free(ptr_mvdr->m_re);
-	free(ptr_mvdr->m_im);	
-	free(ptr_mvdr->m_re_temp);
-	free(ptr_mvdr->m_im_temp);
-	
-	free(ptr_mvdr->m_rnn_re);
-	free(ptr_mvdr->m_rnn_im);
-	free(ptr_mvdr->m_irnn_re);
-	free(ptr_mvdr->m_irnn_im);
-	
-	free(ptr_mvdr->m_rxx_in);
-	free(ptr_mvdr->m_irxx_out);
+	dios_ssp_mvdr_init_steering_vector(ptr_mvdr, dios_ssp_mvdr_grid_point(ptr_mvdr, DEFAULT_MVDR_INIT_ANGLE, 0), 
+		stv_re, stv_re + ptr_mvdr->m_gstv_dim);
+	ret = dios_ssp_mvdr_init_sd_weights(ptr_mvdr, stv_re, stv_re + ptr_mvdr->m_gstv_dim, weight_sd_re, weight_sd_im);
+	dios_ssp_share_free(stv_re);
 
-	free(ptr_mvdr->m_sd_rnn_re);
-	free(ptr_mvdr->m_sd_irnn_re);
-	free(ptr_mvdr->m_sd_irnn_im);
-	
-	free(ptr_mvdr->m_weight_sd_group_re);
-	free(ptr_mvdr->m_weight_sd_group_im);
+	return ret;
+}
 
-	free(ptr_mvdr->m_weight_re);
-	free(ptr_mvdr->m_weight_im);
+int dios_ssp_mvdr_free_mem(objMVDR *ptr_mvdr)
+{
+    int i;
 
-	free(ptr_mvdr->m_mvdr_out_re);
-	free(ptr_mvdr->m_mvdr_out_im);
-	free(ptr_mvdr->m_out_bf);
-	
-	free(ptr_mvdr->m_gstv_re);
-	free(ptr_mvdr->m_gstv_im);
-	free(ptr_mvdr->m_stv_re);
-	free(ptr_mvdr->m_stv_im);
+	for (i = 0; i < ptr_mvdr->m_channels; ++i )
+	{
+		dios_ssp_share_free(ptr_mvdr->m_mch_buffer[i]);
+	}
+	dios_ssp_share_free(ptr_mvdr->m_mch_buffer);
+	dios_ssp_share_free(ptr_mvdr->m_win_data);
+	dios_ssp_share_free(ptr_mvdr->m_re);
+	dios_ssp_share_free(ptr_mvdr->m_im);	
+	dios_ssp_share_free(ptr_mvdr->m_re_temp);
+	dios_ssp_share_free(ptr_mvdr->m_im_temp);
+	
+	dios_ssp_share_free(ptr_mvdr->m_rnn_re);
+	dios_ssp_share_free(ptr_mvdr->m_rnn_im);
+	dios_ssp_share_free(ptr_mvdr->m_lnn_re);
+	dios_ssp_share_free(ptr_mvdr->m_lnn_im);
+	dios_ssp_share_free(ptr_mvdr->m_lnn_valid);
+	dios_ssp_share_free(ptr_mvdr->m_rw_re);
+	dios_ssp_share_free(ptr_mvdr->m_rw_im);
+	
+	dios_ssp_share_free(ptr_mvdr->m_weight_re);
+	dios_ssp_share_free(ptr_mvdr->m_weight_im);
+
+	dios_ssp_share_free(ptr_mvdr->m_mvdr_out_re);
+	dios_ssp_share_free(ptr_mvdr->m_mvdr_out_im);
+	dios_ssp_share_free(ptr_mvdr->m_out_bf);
+	
+	dios_ssp_share_free(ptr_mvdr->m_stv_re);
+	dios_ssp_share_free(ptr_mvdr->m_stv_im);
 	
     // mcra
-	free(ptr_mvdr->m_ns_ps_cur_mic);
-	free(ptr_mvdr->m_ns_theta_cur_mic);
-	free(ptr_mvdr->m_ns_ps);
-	free(ptr_mvdr->m_P);
-	free(ptr_mvdr->m_Ptmp);
-	free(ptr_mvdr->m_Pmin);
-	free(ptr_mvdr->m_pk);
-	free(ptr_mvdr->m_xn_re);
-	free(ptr_mvdr->m_xn_im);
+	dios_ssp_share_free(ptr_mvdr->m_ns_ps_cur_mic);
+	dios_ssp_share_free(ptr_mvdr->m_ns_ps);
+	dios_ssp_share_free(ptr_mvdr->m_P);
+	dios_ssp_share_free(ptr_mvdr->m_Ptmp);
+	dios_ssp_share_free(ptr_mvdr->m_Pmin);
+	dios_ssp_share_free(ptr_mvdr->m_pk);
+	dios_ssp_share_free(ptr_mvdr->m_xn_re);
+	dios_ssp_share_free(ptr_mvdr->m_xn_im);
 
 	return 0;
 }
 
-void dios_ssp_mvdr_init(objMVDR *ptr_mvdr, int sensor_num, PlaneCoord* cood)
+static const size_t g_mvdr_win_ptr[] = {
+	offsetof(objMVDRCwin, m_ana_win), offsetof(objMVDRCwin, m_norm_win),
+	offsetof(objMVDRCwin, m_syn_win), offsetof(objMVDRCwin, table_pool)
+};
+
+void dios_ssp_mvdr_init(objMVDR *ptr_mvdr, int sensor_num, PlaneCoord* cood, int sample_rate, void *table_pool)
 {
     int i, j;
+	int key_len;
+	float *key;
 
-    ptr_mvdr->m_fs = DEFAULT_MVDR_SAMPLING_FRQ;
+    ptr_mvdr->m_fs = sample_rate;
 	
 	ptr_mvdr->m_channels = sensor_num;
 
-	ptr_mvdr->m_fft_size = DEFAULT_MVDR_WIN_SIZE;
-	ptr_mvdr->m_shift_size = DEFAULT_MVDR_SHIFT_SIZE;
+	/* window and shift keep their duration at any sampling rate */
+	ptr_mvdr->m_fft_size = DEFAULT_MVDR_WIN_SIZE * sample_rate / DEFAULT_MVDR_SAMPLING_FRQ;
+	ptr_mvdr->m_shift_size = DEFAULT_MVDR_SHIFT_SIZE * sample_rate / DEFAULT_MVDR_SAMPLING_FRQ;
 	
 	ptr_mvdr->m_delta_angle = DEFAULT_MVDR_DELTA_ANGLE;
 	
@@ -276,6 +308,8 @@ void dios_ssp_mvdr_init(objMVDR *ptr_mvdr, int sensor_num, PlaneCoord* cood)
     ptr_mvdr->m_alpha_d = DEFAULT_MVDR_ALPHA_D;
     ptr_mvdr->m_L = DEFAULT_MVDR_L;
     ptr_mvdr->m_delta_thres = DEFAULT_MVDR_DELTA_THRES;
+	ptr_mvdr->m_rank1_thres = DEFAULT_MVDR_RANK1_THRES;
+	ptr_mvdr->m_refresh_frames = DEFAULT_MVDR_REFRESH_FRAMES;
 
     ptr_mvdr->m_deta_fs = ptr_mvdr->m_fs / (float)ptr_mvdr->m_fft_size;
 	ptr_mvdr->m_sp_size = ptr_mvdr->m_fft_size/2+1;	
@@ -287,7 +321,7 @@ void dios_ssp_mvdr_init(objMVDR *ptr_mvdr, int sensor_num, PlaneCoord* cood)
 
 	ptr_mvdr->cood = cood;
 
-	ptr_mvdr->dist = (float*)calloc(ptr_mvdr->m_channels * ptr_mvdr->m_channels, sizeof(float));
+	ptr_mvdr->dist = (float*)dios_ssp_share_calloc(ptr_mvdr->m_channels * ptr_mvdr->m_channels, sizeof(float));
 	for (i = 0; i < ptr_mvdr->m_channels; i++)
 	{
 		for (j = i+1; j < ptr_mvdr->m_channels; j++)
@@ -295,27 +329,58 @@ void dios_ssp_mvdr_init(objMVDR *ptr_mvdr, int sensor_num, PlaneCoord* cood)
 			ptr_mvdr->dist[i* ptr_mvdr->m_channels + j] = (float)sqrt(pow(ptr_mvdr->cood[i].x - ptr_mvdr->cood[j].x, 2) + pow(ptr_mvdr->cood[i].y * ptr_mvdr->cood[i].y, 2) + pow(ptr_mvdr->cood[i].z * ptr_mvdr->cood[i].z, 2));
 		}
 	}
-	ptr_mvdr->mvdrinv = dios_ssp_matrix_inv_init(ptr_mvdr->m_channels);
+	ptr_mvdr->mvdrinv = dios_ssp_hermitian_inv_init(ptr_mvdr->m_channels, 0.0f);
 	ptr_mvdr->m_angle_num = (int)((360.0-0.0)/ ptr_mvdr->m_delta_angle);
-	ptr_mvdr->mvdrwin = (objMVDRCwin*)calloc(1, sizeof(objMVDRCwin));
-	dios_ssp_mvdr_win_init(ptr_mvdr->mvdrwin, ptr_mvdr->m_fft_size, ptr_mvdr->m_shift_size);
+	ptr_mvdr->m_elev_num = 180 / ptr_mvdr->m_delta_angle + 1;
+	ptr_mvdr->mvdrwin = (objMVDRCwin*)dios_ssp_share_calloc_map(1, sizeof(objMVDRCwin), g_mvdr_win_ptr, SHARE_ARENA_MAP_NUM(g_mvdr_win_ptr));
+	dios_ssp_mvdr_win_init(ptr_mvdr->mvdrwin, ptr_mvdr->m_fft_size, ptr_mvdr->m_shift_size, table_pool);
 	
-	ptr_mvdr->mvdr_fft = dios_ssp_share_rfft_init(ptr_mvdr->m_fft_size);
-	ptr_mvdr->fft_in = (float *)calloc(ptr_mvdr->m_fft_size, sizeof(float));
-	ptr_mvdr->fft_out = (float *)calloc(ptr_mvdr->m_fft_size, sizeof(float));
+	ptr_mvdr->mvdr_fft = dios_ssp_share_rfft_init_pool(ptr_mvdr->m_fft_size, table_pool);
+	ptr_mvdr->fft_in = (float *)dios_ssp_share_calloc(ptr_mvdr->m_fft_size, sizeof(float));
+	ptr_mvdr->fft_out = (float *)dios_ssp_share_calloc(ptr_mvdr->m_fft_size, sizeof(float));
 
 	dios_ssp_mvdr_alloc_mem(ptr_mvdr);
 	
-	dios_ssp_mvdr_init_steering_vectors_g(ptr_mvdr);
-	
-	dios_ssp_mvdr_init_sd_weights(ptr_mvdr);
+	/* the superdirective weights only depend on the array and the analysis
+	   parameters, instances with the same ones share them. the steering
+	   vectors of the azimuth x elevation grid are not tabulated, the one of
+	   the direction is computed when the direction changes */
+	ptr_mvdr->table_pool = table_pool;
+	key_len = 6 + 3 * ptr_mvdr->m_channels;
+	key = (float*)dios_ssp_share_calloc(key_len, sizeof(float));
+	key[0] = (float)ptr_mvdr->m_channels;
+	key[1] = (float)ptr_mvdr->m_fs;
+	key[2] = (float)ptr_mvdr->m_fft_size;
+	key[3] = (float)ptr_mvdr->m_delta_angle;
+	key[4] = ptr_mvdr->m_sd_factor;
+	key[5] = ptr_mvdr->m_sd_eps;
+	for (i = 0; i < ptr_mvdr->m_channels; i++)
+	{
+		key[6 + 3 * i] = ptr_mvdr->cood[i].x;
+		key[7 + 3 * i] = ptr_mvdr->cood[i].y;
+		key[8 + 3 * i] = ptr_mvdr->cood[i].z;
+	}
+	ptr_mvdr->m_weight_sd_re = (const float*)dios_ssp_share_table_get(table_pool, "mvdr_sd", key, key_len * (int)sizeof(float), 
+		2 * ptr_mvdr->m_gstv_dim * sizeof(float), dios_ssp_mvdr_table_build, ptr_mvdr);
+	dios_ssp_share_free(key);
+	if (ptr_mvdr->m_weight_sd_re == NULL)
+	{
+		printf("mvdr superdirective weight table init error!\n");
+		return;
+	}
+	ptr_mvdr->m_weight_sd_im = ptr_mvdr->m_weight_sd_re + ptr_mvdr->m_gstv_dim;
+
+	memcpy(ptr_mvdr->m_weight_re, ptr_mvdr->m_weight_sd_re, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels);
+	memcpy(ptr_mvdr->m_weight_im, ptr_mvdr->m_weight_sd_im, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels);
 }
 
 void dios_ssp_mvdr_reset(objMVDR *ptr_mvdr)
 {
     int i, k;
 	ptr_mvdr->m_frame_sum = 0;
-	ptr_mvdr->m_angle_pre = 89;
+	ptr_mvdr->m_angle_pre = DEFAULT_MVDR_INIT_ANGLE;
+	ptr_mvdr->m_elev_pre = 0;
+	ptr_mvdr->m_stv_point = -1;
 	for (i = 0; i < ptr_mvdr->m_channels; ++i )
 	{
 		memset( ptr_mvdr->m_mch_buffer[i], 0, sizeof(float)*ptr_mvdr->m_fft_size );
@@ -327,10 +392,11 @@ void dios_ssp_mvdr_reset(objMVDR *ptr_mvdr)
 	memset( ptr_mvdr->m_im_temp, 0, sizeof(float)*ptr_mvdr->m_channels*ptr_mvdr->m_fft_size );
 	memset( ptr_mvdr->m_rnn_re, 0, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size );
 	memset( ptr_mvdr->m_rnn_im, 0, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size );
-	memset( ptr_mvdr->m_irnn_re, 0, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size );
-	memset( ptr_mvdr->m_irnn_im, 0, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size );
-	memset( ptr_mvdr->m_rxx_in, 0, sizeof(float)*2*ptr_mvdr->m_rxx_size );
-	memset( ptr_mvdr->m_irxx_out, 0, sizeof(float)*2*ptr_mvdr->m_rxx_size );
+	memset( ptr_mvdr->m_lnn_re, 0, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size );
+	memset( ptr_mvdr->m_lnn_im, 0, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_rxx_size );
+	memset( ptr_mvdr->m_lnn_valid, 0, sizeof(int)*ptr_mvdr->m_sp_size );
+	memset( ptr_mvdr->m_rw_re, 0, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels );
+	memset( ptr_mvdr->m_rw_im, 0, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels );
 	memset( ptr_mvdr->m_mvdr_out_re, 0, sizeof(float)*ptr_mvdr->m_fft_size );
 	memset( ptr_mvdr->m_mvdr_out_im, 0, sizeof(float)*ptr_mvdr->m_fft_size );
 	memset( ptr_mvdr->m_out_bf, 0, sizeof(float)*ptr_mvdr->m_fft_size );
@@ -344,7 +410,6 @@ void dios_ssp_mvdr_reset(objMVDR *ptr_mvdr)
 	}
 	// mcra
 	memset( ptr_mvdr->m_ns_ps_cur_mic, 0, sizeof(float)*ptr_mvdr->m_fft_size );
-	memset( ptr_mvdr->m_ns_theta_cur_mic, 0, sizeof(float)*ptr_mvdr->m_fft_size );
 	memset( ptr_mvdr->m_ns_ps, 0, sizeof(float)*ptr_mvdr->m_channels*ptr_mvdr->m_fft_size );
 	memset( ptr_mvdr->m_P, 0, sizeof(float)*ptr_mvdr->m_channels*ptr_mvdr->m_fft_size );
 	memset( ptr_mvdr->m_Ptmp, 0, sizeof(float)*ptr_mvdr->m_channels*ptr_mvdr->m_fft_size );
@@ -362,9 +427,9 @@ void dios_ssp_mvdr_reset(objMVDR *ptr_mvdr)
 	
 }
 
-int dios_ssp_mvdr_process(objMVDR *ptr_mvdr, float* in, float* out, int angle)
+int dios_ssp_mvdr_process(objMVDR *ptr_mvdr, float* in, float* out, int angle, int elevation)
 {
-	int i, k, ch_idx = 0;
+	int i, ch_idx = 0;
 	for ( ch_idx = 0; ch_idx < ptr_mvdr->m_channels; ++ch_idx )
 	{
 		for (i = 0; i < ptr_mvdr->m_shift_size; ++i )
@@ -373,15 +438,6 @@ int dios_ssp_mvdr_process(objMVDR *ptr_mvdr, float* in, float* out, int angle)
 		}
 	}
 	
-	if( angle != ptr_mvdr->m_angle_pre )
-	{
-		int ang_region = angle/ptr_mvdr->m_delta_angle;
-		memcpy(ptr_mvdr->m_stv_re, ptr_mvdr->m_gstv_re+ang_region*ptr_mvdr->m_gstv_dim, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels);
-		memcpy(ptr_mvdr->m_stv_im, ptr_mvdr->m_gstv_im+ang_region*ptr_mvdr->m_gstv_dim, sizeof(float)*ptr_mvdr->m_sp_size*ptr_mvdr->m_channels);
-		ptr_mvdr->m_angle_pre = angle;
-	}
-	
-	ptr_mvdr->m_frame_sum++;
 	// add ana window		
 	for ( ch_idx = 0; ch_idx < ptr_mvdr->m_channels; ++ch_idx )
 	{
@@ -401,20 +457,46 @@ int dios_ssp_mvdr_process(objMVDR *ptr_mvdr, float* in, float* out, int angle)
 			ptr_mvdr->m_im[i + ch_idx * ptr_mvdr->m_fft_size] = -ptr_mvdr->fft_out[ptr_mvdr->m_fft_size - i];
 		}
 	}
+
+	for (ch_idx = 0; ch_idx < ptr_mvdr->m_channels; ++ch_idx)
+	{
+		memmove(ptr_mvdr->m_mch_buffer[ch_idx], ptr_mvdr->m_mch_buffer[ch_idx] + ptr_mvdr->m_shift_size, sizeof(float) * (ptr_mvdr->m_fft_size - ptr_mvdr->m_shift_size));
+	}
+
+	return dios_ssp_mvdr_process_spectrum(ptr_mvdr, ptr_mvdr->m_re, ptr_mvdr->m_im, out, angle, elevation);
+}
+
+int dios_ssp_mvdr_process_spectrum(objMVDR *ptr_mvdr, const float* re, const float* im, float* out, int angle, int elevation)
+{
+	int i, k;
+	int ret = 0;
+	if( angle != ptr_mvdr->m_angle_pre || elevation != ptr_mvdr->m_elev_pre )
+	{
+		int point = dios_ssp_mvdr_grid_point(ptr_mvdr, angle, elevation);
+		if (point != ptr_mvdr->m_stv_point)
+		{
+			dios_ssp_mvdr_init_steering_vector(ptr_mvdr, point, ptr_mvdr->m_stv_re, ptr_mvdr->m_stv_im);
+			ptr_mvdr->m_stv_point = point;
+		}
+		ptr_mvdr->m_angle_pre = angle;
+		ptr_mvdr->m_elev_pre = elevation;
+	}
+	
+	ptr_mvdr->m_frame_sum++;
 	
-	dios_ssp_mvdr_mcra(ptr_mvdr);
+	dios_ssp_mvdr_mcra(ptr_mvdr, re, im);
 
 	dios_ssp_mvdr_cal_rxx(ptr_mvdr);
 
-	dios_ssp_mvdr_cal_weights_adpmvdr(ptr_mvdr);
+	ret = dios_ssp_mvdr_cal_weights_adpmvdr(ptr_mvdr);
 		
 	for (k = 1; k < ptr_mvdr->m_fft_size/2; k++ )
 	{
 		ptr_mvdr->m_mvdr_out_re[k] = ptr_mvdr->m_mvdr_out_im[k] = 0;
 		for (i = 0; i < ptr_mvdr->m_channels; ++i )
 		{
-			ptr_mvdr->m_mvdr_out_re[k] += ptr_mvdr->m_weight_re[k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_re[i*ptr_mvdr->m_fft_size+k] + ptr_mvdr->m_weight_im[k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_im[i*ptr_mvdr->m_fft_size+k];
-			ptr_mvdr->m_mvdr_out_im[k] += ptr_mvdr->m_weight_re[k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_im[i*ptr_mvdr->m_fft_size+k] - ptr_mvdr->m_weight_im[k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_re[i*ptr_mvdr->m_fft_size+k];
+			ptr_mvdr->m_mvdr_out_re[k] += ptr_mvdr->m_weight_re[k*ptr_mvdr->m_channels+i]*re[i*ptr_mvdr->m_fft_size+k] + ptr_mvdr->m_weight_im[k*ptr_mvdr->m_channels+i]*im[i*ptr_mvdr->m_fft_size+k];
+			ptr_mvdr->m_mvdr_out_im[k] += ptr_mvdr->m_weight_re[k*ptr_mvdr->m_channels+i]*im[i*ptr_mvdr->m_fft_size+k] - ptr_mvdr->m_weight_im[k*ptr_mvdr->m_channels+i]*re[i*ptr_mvdr->m_fft_size+k];
 		}
 		ptr_mvdr->m_mvdr_out_re[ptr_mvdr->m_fft_size-k] = ptr_mvdr->m_mvdr_out_re[k];
 		ptr_mvdr->m_mvdr_out_im[ptr_mvdr->m_fft_size-k] = -ptr_mvdr->m_mvdr_out_im[k];
@@ -446,81 +528,91 @@ int dios_ssp_mvdr_process(objMVDR *ptr_mvdr, float* in, float* out, int angle)
 		out[i] = ptr_mvdr->m_out_bf[i];
 	}
 
-	for (ch_idx = 0; ch_idx < ptr_mvdr->m_channels; ++ch_idx)
-	{
-		memmove(ptr_mvdr->m_mch_buffer[ch_idx], ptr_mvdr->m_mch_buffer[ch_idx] + ptr_mvdr->m_shift_size, sizeof(float) * (ptr_mvdr->m_fft_size - ptr_mvdr->m_shift_size));
-	}
 	memmove( ptr_mvdr->m_out_bf, ptr_mvdr->m_out_bf + ptr_mvdr->m_shift_size, sizeof(float) * (ptr_mvdr->m_fft_size - ptr_mvdr->m_shift_size) );
 	memset( ptr_mvdr->m_out_bf + ptr_mvdr->m_fft_size - ptr_mvdr->m_shift_size, 0, sizeof(float) * ptr_mvdr->m_shift_size);
 
-	return 0;
+	return ret;
 }
 
-int dios_ssp_mvdr_mcra(objMVDR *ptr_mvdr)
+int dios_ssp_mvdr_mcra(objMVDR *ptr_mvdr, const float* re, const float* im)
 {
     int i, k;
+	int sp_size = ptr_mvdr->m_sp_size;
+	float ik = 0, adk = 0, gain = 0;
+	float *ps_cur = ptr_mvdr->m_ns_ps_cur_mic;
 	for(i = 0; i < ptr_mvdr->m_channels; ++i)
 	{
-	
-		float Srk = 0, ik = 0, adk = 0, xn_amp = 0;
-	
-		for(k = 0; k < ptr_mvdr->m_fft_size; ++k)
+		const float *x_re = re + i*ptr_mvdr->m_fft_size;
+		const float *x_im = im + i*ptr_mvdr->m_fft_size;
+		float *ns_ps = ptr_mvdr->m_ns_ps + i*ptr_mvdr->m_fft_size;
+		float *P = ptr_mvdr->m_P + i*ptr_mvdr->m_fft_size;
+		float *Ptmp = ptr_mvdr->m_Ptmp + i*ptr_mvdr->m_fft_size;
+		float *Pmin = ptr_mvdr->m_Pmin + i*ptr_mvdr->m_fft_size;
+		float *pk = ptr_mvdr->m_pk + i*ptr_mvdr->m_fft_size;
+		float *xn_re = ptr_mvdr->m_xn_re + i*ptr_mvdr->m_fft_size;
+		float *xn_im = ptr_mvdr->m_xn_im + i*ptr_mvdr->m_fft_size;
+	
+		for(k = 0; k < sp_size; ++k)
 		{
-			ptr_mvdr->m_ns_ps_cur_mic[k] = ptr_mvdr->m_re[i*ptr_mvdr->m_fft_size+k]*ptr_mvdr->m_re[i*ptr_mvdr->m_fft_size+k] + ptr_mvdr->m_im[i*ptr_mvdr->m_fft_size+k]*ptr_mvdr->m_im[i*ptr_mvdr->m_fft_size+k];
-			ptr_mvdr->m_ns_theta_cur_mic[k] = (float)atan2(ptr_mvdr->m_im[i*ptr_mvdr->m_fft_size+k], ptr_mvdr->m_re[i*ptr_mvdr->m_fft_size+k]);
+			ps_cur[k] = x_re[k]*x_re[k] + x_im[k]*x_im[k];
 		}
 
 		if( ptr_mvdr->m_frame_sum == 1 )
 		{
-			memcpy(ptr_mvdr->m_ns_ps+i*ptr_mvdr->m_fft_size, ptr_mvdr->m_ns_ps_cur_mic, sizeof(float)*ptr_mvdr->m_fft_size);
-			memcpy(ptr_mvdr->m_P+i*ptr_mvdr->m_fft_size, ptr_mvdr->m_ns_ps_cur_mic, sizeof(float)*ptr_mvdr->m_fft_size);
-			memcpy(ptr_mvdr->m_Ptmp+i*ptr_mvdr->m_fft_size, ptr_mvdr->m_ns_ps_cur_mic, sizeof(float)*ptr_mvdr->m_fft_size);
-			memcpy(ptr_mvdr->m_Pmin+i*ptr_mvdr->m_fft_size, ptr_mvdr->m_ns_ps_cur_mic, sizeof(float)*ptr_mvdr->m_fft_size);
+			memcpy(ns_ps, ps_cur, sizeof(float)*sp_size);
+			memcpy(P, ps_cur, sizeof(float)*sp_size);
+			memcpy(Ptmp, ps_cur, sizeof(float)*sp_size);
+			memcpy(Pmin, ps_cur, sizeof(float)*sp_size);
 		}
 		else
 		{
-			for(k = 0; k < ptr_mvdr->m_sp_size; ++k)
+			for(k = 0; k < sp_size; ++k)
 			{
-				ptr_mvdr->m_P[i*ptr_mvdr->m_fft_size+k] = ptr_mvdr->m_alpha_s*ptr_mvdr->m_P[i*ptr_mvdr->m_fft_size+k] + (1 - ptr_mvdr->m_alpha_s)*ptr_mvdr->m_ns_ps_cur_mic[k];
+				P[k] = ptr_mvdr->m_alpha_s*P[k] + (1 - ptr_mvdr->m_alpha_s)*ps_cur[k];
 			}
 		}
 
 		if( ptr_mvdr->m_frame_sum % ptr_mvdr->m_L == 0 )
 		{
-			for(k = 0; k < ptr_mvdr->m_sp_size; ++k)
+			for(k = 0; k < sp_size; ++k)
 			{
-				ptr_mvdr->m_Pmin[i*ptr_mvdr->m_fft_size+k] = (ptr_mvdr->m_Ptmp[i*ptr_mvdr->m_fft_size+k] < ptr_mvdr->m_P[i*ptr_mvdr->m_fft_size+k])?ptr_mvdr->m_Ptmp[i*ptr_mvdr->m_fft_size+k]:ptr_mvdr->m_P[i*ptr_mvdr->m_fft_size+k];
-				ptr_mvdr->m_Ptmp[i*ptr_mvdr->m_fft_size+k] = ptr_mvdr->m_P[i*ptr_mvdr->m_fft_size+k];
+				Pmin[k] = (Ptmp[k] < P[k])?Ptmp[k]:P[k];
+				Ptmp[k] = P[k];
 			}
 		}
 		else
 		{
-			for(k = 0; k < ptr_mvdr->m_sp_size; ++k)
+			for(k = 0; k < sp_size; ++k)
 			{
-				ptr_mvdr->m_Pmin[i*ptr_mvdr->m_fft_size+k] = (ptr_mvdr->m_Pmin[i*ptr_mvdr->m_fft_size+k] < ptr_mvdr->m_P[i*ptr_mvdr->m_fft_size+k])?ptr_mvdr->m_Pmin[i*ptr_mvdr->m_fft_size+k]:ptr_mvdr->m_P[i*ptr_mvdr->m_fft_size+k];
-				ptr_mvdr->m_Ptmp[i*ptr_mvdr->m_fft_size+k] = (ptr_mvdr->m_Ptmp[i*ptr_mvdr->m_fft_size+k] < ptr_mvdr->m_P[i*ptr_mvdr->m_fft_size+k])?ptr_mvdr->m_Ptmp[i*ptr_mvdr->m_fft_size+k]:ptr_mvdr->m_P[i*ptr_mvdr->m_fft_size+k];
+				Pmin[k] = (Pmin[k] < P[k])?Pmin[k]:P[k];
+				Ptmp[k] = (Ptmp[k] < P[k])?Ptmp[k]:P[k];
 			}
 		}
 
-		for(k = 0; k < ptr_mvdr->m_sp_size; ++k)
+		for(k = 0; k < sp_size; ++k)
 		{
-			Srk = ptr_mvdr->m_P[i*ptr_mvdr->m_fft_size+k]/ptr_mvdr->m_Pmin[i*ptr_mvdr->m_fft_size+k];
-			ik = (Srk > ptr_mvdr->m_delta_thres)?1.0f:0.0f;
-			ptr_mvdr->m_pk[i*ptr_mvdr->m_fft_size+k] = ptr_mvdr->m_alpha_p*ptr_mvdr->m_pk[i*ptr_mvdr->m_fft_size+k] + (1 - ptr_mvdr->m_alpha_p)*ik;
-			adk = ptr_mvdr->m_alpha_d + (1 - ptr_mvdr->m_alpha_d)*ptr_mvdr->m_pk[i*ptr_mvdr->m_fft_size+k];
-			ptr_mvdr->m_ns_ps[i*ptr_mvdr->m_fft_size+k] = adk*ptr_mvdr->m_ns_ps[i*ptr_mvdr->m_fft_size+k] + (1 - adk)*ptr_mvdr->m_ns_ps_cur_mic[k];
+			// P/Pmin > delta without the division
+			ik = (P[k] > ptr_mvdr->m_delta_thres*Pmin[k])?1.0f:0.0f;
+			pk[k] = ptr_mvdr->m_alpha_p*pk[k] + (1 - ptr_mvdr->m_alpha_p)*ik;
+			adk = ptr_mvdr->m_alpha_d + (1 - ptr_mvdr->m_alpha_d)*pk[k];
+			ns_ps[k] = adk*ns_ps[k] + (1 - adk)*ps_cur[k];
 		}
 
-		for(k = 1; k < ptr_mvdr->m_fft_size/2; ++k)
+		// noise amplitude with the phase of the current bin, sqrt(ns_ps)*x/|x|, 
+		// a zero bin has phase 0 as with atan2
+		for(k = 0; k < sp_size; ++k)
 		{
-			ptr_mvdr->m_ns_ps[i*ptr_mvdr->m_fft_size+ptr_mvdr->m_fft_size-k] = ptr_mvdr->m_ns_ps[i*ptr_mvdr->m_fft_size+k];
-		}
-
-		for(k = 0; k < ptr_mvdr->m_fft_size; ++k)
-		{
-			xn_amp = (float)sqrt(ptr_mvdr->m_ns_ps[i*ptr_mvdr->m_fft_size+k]);
-			ptr_mvdr->m_xn_re[i*ptr_mvdr->m_fft_size+k] = (float)(xn_amp*cos(ptr_mvdr->m_ns_theta_cur_mic[k]));
-			ptr_mvdr->m_xn_im[i*ptr_mvdr->m_fft_size+k] = (float)(xn_amp*sin(ptr_mvdr->m_ns_theta_cur_mic[k]));
+			if (ps_cur[k] > 0)
+			{
+				gain = sqrtf(ns_ps[k]/ps_cur[k]);
+				xn_re[k] = gain*x_re[k];
+				xn_im[k] = gain*x_im[k];
+			}
+			else
+			{
+				xn_re[k] = sqrtf(ns_ps[k]);
+				xn_im[k] = 0;
+			}
 		}
 	}
 
@@ -586,63 +678,77 @@ int dios_ssp_mvdr_cal_rxx(objMVDR *ptr_mvdr)
 int dios_ssp_mvdr_cal_weights_adpmvdr(objMVDR *ptr_mvdr)
 {
     int i, j, k;
-	for(k = 1; k < ptr_mvdr->m_sp_size; ++k)
+	int refresh;
+	float *l_re, *l_im;
+	float x_re, x_im, x_pow, tr_rnn, tr_lnn, gamma;
+	float re_temp = 0, im_temp = 0, power = 0;
+
+	for (k = 1; k < ptr_mvdr->m_sp_size; k++ )
 	{
-		for (i = 0; i < ptr_mvdr->m_channels; i++)
+		l_re = ptr_mvdr->m_lnn_re + k*ptr_mvdr->m_rxx_size;
+		l_im = ptr_mvdr->m_lnn_im + k*ptr_mvdr->m_rxx_size;
+		refresh = (ptr_mvdr->m_frame_sum == 1) || !ptr_mvdr->m_lnn_valid[k] 
+				|| ((ptr_mvdr->m_frame_sum + k) % ptr_mvdr->m_refresh_frames == 0);
+		if (!refresh)
 		{
-			ptr_mvdr->m_rxx_in[i*ptr_mvdr->m_channels*2+2*i] = ptr_mvdr->m_rnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+i];
-			ptr_mvdr->m_rxx_in[i*ptr_mvdr->m_channels*2+2*i+1] = ptr_mvdr->m_rnn_im[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+i];
-			for (j = i+1; j < ptr_mvdr->m_channels; j++)
+			// rnn = alpha*rnn + beta*(xn*xn^H + eps*I), the loading is folded into
+			// the scale of the old factor so that the traces of both sides agree
+			x_pow = tr_rnn = tr_lnn = 0;
+			for (i = 0; i < ptr_mvdr->m_channels; i++ )
 			{
-				ptr_mvdr->m_rxx_in[i*ptr_mvdr->m_channels*2+2*j] = ptr_mvdr->m_rnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j];
-				ptr_mvdr->m_rxx_in[i*ptr_mvdr->m_channels*2+2*j+1] = ptr_mvdr->m_rnn_im[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j];
-				ptr_mvdr->m_rxx_in[j*ptr_mvdr->m_channels*2+2*i] = ptr_mvdr->m_rxx_in[i*ptr_mvdr->m_channels*2+2*j];
-				ptr_mvdr->m_rxx_in[j*ptr_mvdr->m_channels*2+2*i+1] = -ptr_mvdr->m_rxx_in[i*ptr_mvdr->m_channels*2+2*j+1];
+				x_re = ptr_mvdr->m_xn_re[i*ptr_mvdr->m_fft_size+k];
+				x_im = ptr_mvdr->m_xn_im[i*ptr_mvdr->m_fft_size+k];
+				x_pow += x_re*x_re + x_im*x_im;
+				tr_rnn += ptr_mvdr->m_rnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+i];
+				for (j = 0; j <= i; j++ )
+				{
+					tr_lnn += l_re[i*ptr_mvdr->m_channels+j]*l_re[i*ptr_mvdr->m_channels+j] 
+							+ l_im[i*ptr_mvdr->m_channels+j]*l_im[i*ptr_mvdr->m_channels+j];
+				}
 			}
-		}
-		dios_ssp_matrix_inv_process(ptr_mvdr->mvdrinv, ptr_mvdr->m_rxx_in, ptr_mvdr->m_irxx_out);
-		for (i = 0; i < ptr_mvdr->m_channels; ++i)
-		{
-			for (j = 0; j < ptr_mvdr->m_channels; ++j)
+			// refactorize on a large update, which is taken as a change of the noise 
+			// field, and where the loading is a noticeable part of rnn
+			refresh = !(tr_lnn > 0) || (ptr_mvdr->m_beta_rnn*x_pow > ptr_mvdr->m_rank1_thres*tr_rnn) 
+					|| (ptr_mvdr->m_channels*ptr_mvdr->m_rnn_eps > ptr_mvdr->m_rank1_thres*tr_rnn);
+			if (!refresh)
 			{
-				ptr_mvdr->m_irnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j] = ptr_mvdr->m_irxx_out[i*ptr_mvdr->m_channels*2+2*j];
-				ptr_mvdr->m_irnn_im[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j] = ptr_mvdr->m_irxx_out[i*ptr_mvdr->m_channels*2+2*j+1];
+				gamma = (tr_rnn - ptr_mvdr->m_beta_rnn*x_pow)/tr_lnn;
+				refresh = (0 != dios_ssp_hermitian_chol_update(ptr_mvdr->mvdrinv, l_re, l_im, gamma, 
+					ptr_mvdr->m_beta_rnn, ptr_mvdr->m_xn_re+k, ptr_mvdr->m_xn_im+k, ptr_mvdr->m_fft_size));
 			}
 		}
+		if (refresh)
+		{
+			ptr_mvdr->m_lnn_valid[k] = (0 == dios_ssp_hermitian_chol_process(ptr_mvdr->mvdrinv, ptr_mvdr->m_rnn_re+k*ptr_mvdr->m_rxx_size, 
+				ptr_mvdr->m_rnn_im+k*ptr_mvdr->m_rxx_size, l_re, l_im, 1));
+		}
 	}
-	
-	float re_temp = 0, im_temp = 0, power = 0, re_temp2 = 0, im_temp2 = 0;
+
+	// rnn^-1*d of all bins in one batch, a bin without valid factor gets zero
+	dios_ssp_hermitian_chol_solve(ptr_mvdr->mvdrinv, ptr_mvdr->m_lnn_re+ptr_mvdr->m_rxx_size, ptr_mvdr->m_lnn_im+ptr_mvdr->m_rxx_size, 
+		ptr_mvdr->m_stv_re+ptr_mvdr->m_channels, ptr_mvdr->m_stv_im+ptr_mvdr->m_channels, 
+		ptr_mvdr->m_rw_re+ptr_mvdr->m_channels, ptr_mvdr->m_rw_im+ptr_mvdr->m_channels, ptr_mvdr->m_sp_size-1);
+
 	for (k = 1; k < ptr_mvdr->m_sp_size; k++ )	
 	{		
-		for (i = 0; i < ptr_mvdr->m_channels; i++)		
-		{			
-			re_temp = im_temp = 0;			
-			for (j = 0; j < ptr_mvdr->m_channels; j++)			
-			{				
-				re_temp += ptr_mvdr->m_irnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j]*ptr_mvdr->m_stv_re[k*ptr_mvdr->m_channels+j] 
-						- ptr_mvdr->m_irnn_im[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j]*ptr_mvdr->m_stv_im[k*ptr_mvdr->m_channels+j];
-				im_temp += ptr_mvdr->m_irnn_re[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j]*ptr_mvdr->m_stv_im[k*ptr_mvdr->m_channels+j] 
-						+ ptr_mvdr->m_irnn_im[k*ptr_mvdr->m_rxx_size+i*ptr_mvdr->m_channels+j]*ptr_mvdr->m_stv_re[k*ptr_mvdr->m_channels+j];
-			}						
-			ptr_mvdr->m_weight_re[k*ptr_mvdr->m_channels+i] = re_temp;		
-			ptr_mvdr->m_weight_im[k*ptr_mvdr->m_channels+i] = im_temp;		
-		}					
 		re_temp = im_temp = 0;		
 		for (i = 0; i < ptr_mvdr->m_channels; i++ )		
 		{			
-			re_temp += ptr_mvdr->m_stv_re[k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_weight_re[k*ptr_mvdr->m_channels+i] 
-					+ ptr_mvdr->m_stv_im[k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_weight_im[k*ptr_mvdr->m_channels+i];
-			im_temp += ptr_mvdr->m_stv_re[k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_weight_im[k*ptr_mvdr->m_channels+i] 
-					- ptr_mvdr->m_stv_im[k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_weight_re[k*ptr_mvdr->m_channels+i];
+			re_temp += ptr_mvdr->m_stv_re[k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_rw_re[k*ptr_mvdr->m_channels+i] 
+					+ ptr_mvdr->m_stv_im[k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_rw_im[k*ptr_mvdr->m_channels+i];
+			im_temp += ptr_mvdr->m_stv_re[k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_rw_im[k*ptr_mvdr->m_channels+i] 
+					- ptr_mvdr->m_stv_im[k*ptr_mvdr->m_channels+i]*ptr_mvdr->m_rw_re[k*ptr_mvdr->m_channels+i];
 		}				
 		power = re_temp*re_temp + im_temp*im_temp;
+		if (!ptr_mvdr->m_lnn_valid[k] || !(power > 0))
+		{
+			// keep the weights of the previous frame, the other bins are still updated
+			continue;
+		}
 		for (i = 0; i < ptr_mvdr->m_channels; i++)		
 		{	
-			re_temp2 = (re_temp*ptr_mvdr->m_weight_re[k*ptr_mvdr->m_channels+i]+im_temp*ptr_mvdr->m_weight_im[k*ptr_mvdr->m_channels+i])/power;
-			im_temp2 = (re_temp*ptr_mvdr->m_weight_im[k*ptr_mvdr->m_channels+i]-im_temp*ptr_mvdr->m_weight_re[k*ptr_mvdr->m_channels+i])/power; 
-
-			ptr_mvdr->m_weight_re[k*ptr_mvdr->m_channels+i] = re_temp2;			
-			ptr_mvdr->m_weight_im[k*ptr_mvdr->m_channels+i] = im_temp2;		
+			ptr_mvdr->m_weight_re[k*ptr_mvdr->m_channels+i] = (re_temp*ptr_mvdr->m_rw_re[k*ptr_mvdr->m_channels+i]+im_temp*ptr_mvdr->m_rw_im[k*ptr_mvdr->m_channels+i])/power;			
+			ptr_mvdr->m_weight_im[k*ptr_mvdr->m_channels+i] = (re_temp*ptr_mvdr->m_rw_im[k*ptr_mvdr->m_channels+i]-im_temp*ptr_mvdr->m_rw_re[k*ptr_mvdr->m_channels+i])/power;		
 		}
 	}
 
@@ -652,21 +758,22 @@ int dios_ssp_mvdr_cal_weights_adpmvdr(objMVDR *ptr_mvdr)
 void dios_ssp_mvdr_delete(objMVDR *ptr_mvdr)
 {
 	int ret = 0;
-	free(ptr_mvdr->dist);
+	dios_ssp_share_free(ptr_mvdr->dist);
 	dios_ssp_mvdr_win_delete(ptr_mvdr->mvdrwin);
-	free(ptr_mvdr->mvdrwin);
-	free(ptr_mvdr->fft_out);
-	free(ptr_mvdr->fft_in);
+	dios_ssp_share_free(ptr_mvdr->mvdrwin);
+	dios_ssp_share_free(ptr_mvdr->fft_out);
+	dios_ssp_share_free(ptr_mvdr->fft_in);
 	ret = dios_ssp_share_rfft_uninit(ptr_mvdr->mvdr_fft);
 	if (0 != ret)
 	{
 		ptr_mvdr->mvdr_fft = NULL;
 	}
-	ret = dios_ssp_matrix_inv_delete(ptr_mvdr->mvdrinv);
+	ret = dios_ssp_hermitian_inv_delete(ptr_mvdr->mvdrinv);
 	if (0 != ret)
 	{
 		ptr_mvdr->mvdrinv = NULL;
 	}
+	dios_ssp_share_table_release(ptr_mvdr->table_pool, ptr_mvdr->m_weight_sd_re);
 	dios_ssp_mvdr_free_mem(ptr_mvdr);
 }
 
@@ -21,11 +21,13 @@ limitations under the License.
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include "../dios_ssp_return_defs.h"
 #include "dios_ssp_mvdr_macros.h"
 #include "dios_ssp_mvdr_win.h"
 #include "../dios_ssp_share/dios_ssp_share_typedefs.h"
 #include "../dios_ssp_share/dios_ssp_share_rfft.h"
 #include "../dios_ssp_share/dios_ssp_share_cinv.h"
+#include "../dios_ssp_share/dios_ssp_share_table.h"
 
 typedef struct
 {
@@ -43,9 +45,12 @@ typedef struct
     float   m_alpha_d;
     int     m_L;
     float   m_delta_thres;
+	float	m_rank1_thres;
+	int		m_refresh_frames;
 	float	m_deta_fs;
 	int		m_sp_size;
-	int		m_angle_num;
+	int		m_angle_num;	// grid azimuths
+	int		m_elev_num;		// grid elevations, -90 ~ 90 degrees
 	float	m_beta_rnn;
 
 	// frame index
@@ -59,39 +64,37 @@ typedef struct
 	float	*m_re_temp;
 	float	*m_im_temp;
 	
-	// steering
+	// steering vector of the grid point of the direction, computed when the
+	// direction moves to another point
 	int		m_gstv_dim;
-	float	*m_gstv_re;
-	float	*m_gstv_im;
 	float	*m_stv_re;
 	float	*m_stv_im;
+	int		m_stv_point;	// grid point in m_stv, -1 before the first direction
 	
 	// rxx  
 	int		m_rxx_size;
-	float	*m_rxx_in;
-	float	*m_irxx_out;
 
 	// rnn
 	float	*m_rnn_re;
 	float	*m_rnn_im;
-	float	*m_irnn_re;
-	float	*m_irnn_im;
+	// cholesky factor of rnn, kept up to date by rank-1 updates
+	float	*m_lnn_re;
+	float	*m_lnn_im;
+	int		*m_lnn_valid;
+	// rnn^-1*stv
+	float	*m_rw_re;
+	float	*m_rw_im;
 	
 	// capon spectrum
 	int		m_angle_pre;
+	int		m_elev_pre;
 
-	// sd rnn 	
-	float	*m_sd_rnn_re;		
-	float	*m_sd_irnn_re;	
-	float	*m_sd_irnn_im;
-	
-	// mvdr
-	float	*m_weight_sd_group_re;
-	float   *m_weight_sd_group_im;
+	// mvdr, superdirective weights of the initial direction, a table of the table pool
+	const float	*m_weight_sd_re;
+	const float	*m_weight_sd_im;
 
 	// mcra
 	float	*m_ns_ps_cur_mic;
-	float	*m_ns_theta_cur_mic;
 	float	*m_ns_ps;
 	float	*m_P;
 	float	*m_Ptmp;
@@ -114,6 +117,7 @@ typedef struct
 	float *fft_in;
 	float *fft_out;
 	float* dist;
+	void *table_pool;
 }objMVDR;
 
 /**********************************************************************************
@@ -122,11 +126,13 @@ Description:   // mvdr init
 Input:         // ptr_mvdr:
 				  sensor_num: microphone number
 				  cood: micphone coordinate
+				  sample_rate: sampling rate in Hz
+				  table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return mvdr object pointer (void*)ptr_mvdr
 				  failure: return NULL
 **********************************************************************************/
-void dios_ssp_mvdr_init(objMVDR *ptr_mvdr, int sensor_num, PlaneCoord* cood);
+void dios_ssp_mvdr_init(objMVDR *ptr_mvdr, int sensor_num, PlaneCoord* cood, int sample_rate, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_mvdr_reset
@@ -143,20 +149,41 @@ Function:      // dios_ssp_mvdr_process
 Description:   // mvdr process
 Input:         // ptr_mvdr:
 				  in: microphone data
-				  angle: micphone sound source angle
+				  angle: micphone sound source angle, 0 ~ 359 degrees
+				  elevation: sound source elevation, -90 ~ 90 degrees
+Output:        // out: mvdr process result
+Return:        // success: return 0
+				  failure: return ERROR_MVDR
+**********************************************************************************/
+int dios_ssp_mvdr_process(objMVDR *ptr_mvdr, float* in, float* out, int angle, int elevation);
+
+/**********************************************************************************
+Function:      // dios_ssp_mvdr_process_spectrum
+Description:   // mvdr process on the stft computed by the caller, the analysis
+				  window and fft must be the same as dios_ssp_mvdr_process
+Input:         // ptr_mvdr:
+				  re: real part of the spectrum, re[ch*m_fft_size+k]
+				  im: imag part of the spectrum, im[ch*m_fft_size+k]
+				      k = 0 ~ m_fft_size/2, the rest is expected to be zero
+				  angle: micphone sound source angle, 0 ~ 359 degrees
+				  elevation: sound source elevation, -90 ~ 90 degrees
 Output:        // out: mvdr process result
+Return:        // success: return 0
+				  failure: return ERROR_MVDR
 **********************************************************************************/
-int dios_ssp_mvdr_process(objMVDR *ptr_mvdr, float* in, float* out, int angle);
+int dios_ssp_mvdr_process_spectrum(objMVDR *ptr_mvdr, const float* re, const float* im, float* out, int angle, int elevation);
 
 /**********************************************************************************
 Function:      // dios_ssp_mvdr_mcra
 Description:   // mcra process
 Input:         // ptr_mvdr:
+				  re: real part of the microphone spectrum
+				  im: imag part of the microphone spectrum
 Output:        // none
 Return:        // success: return 0
 				  failure: return NULL
 **********************************************************************************/
-int dios_ssp_mvdr_mcra(objMVDR *ptr_mvdr);
+int dios_ssp_mvdr_mcra(objMVDR *ptr_mvdr, const float* re, const float* im);
 
 /**********************************************************************************
 Function:      // dios_ssp_mvdr_cal_rxx
@@ -170,11 +197,15 @@ int dios_ssp_mvdr_cal_rxx(objMVDR *ptr_mvdr);
 
 /**********************************************************************************
 Function:      // dios_ssp_mvdr_cal_weights_adpmvdr
-Description:   // calculate mvdr adaptive weight
+Description:   // calculate mvdr adaptive weight w = rnn^-1*d/(d^H*rnn^-1*d), rnn^-1*d
+				  of all bins is solved in one batch from the cholesky factor of
+				  rnn. the factor follows the recursive rnn average by rank-1
+				  updates and is recomputed on large updates and every
+				  m_refresh_frames frames
 Input:         // ptr_mvdr:
 Output:        // none
-Return:        // success: return 0
-				  failure: return NULL
+Return:        // return 0, a bin whose rnn could not be factorized keeps the
+				  weights of the previous frame
 **********************************************************************************/
 int dios_ssp_mvdr_cal_weights_adpmvdr(objMVDR *ptr_mvdr);
 
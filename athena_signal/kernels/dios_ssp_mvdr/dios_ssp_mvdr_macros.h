@@ -22,7 +22,8 @@ limitations under the License.
 #define	DEFAULT_MVDR_SAMPLING_FRQ		16000
 #define	DEFAULT_MVDR_WIN_SIZE			512
 #define	DEFAULT_MVDR_SHIFT_SIZE			128
-#define	DEFAULT_MVDR_DELTA_ANGLE		5
+#define	DEFAULT_MVDR_DELTA_ANGLE		5		/* degrees, azimuth and elevation grid of the steering vectors */
+#define	DEFAULT_MVDR_INIT_ANGLE			89		/* degrees, azimuth of the initial superdirective weights */
 #define DEFAULT_MVDR_SD_FACTOR			(0.01f)
 #define DEFAULT_MVDR_SD_EPS				(0.000001f)
 #define	DEFAULT_MVDR_RNN_EPS			100
@@ -32,6 +33,8 @@ limitations under the License.
 #define DEFAULT_MVDR_ALPHA_D            (0.95f)
 #define DEFAULT_MVDR_L                  50
 #define DEFAULT_MVDR_DELTA_THRES        1.5
+#define DEFAULT_MVDR_RANK1_THRES        (0.1f)
+#define DEFAULT_MVDR_REFRESH_FRAMES     16
 
 #endif /* _DIOS_SSP_MVDR_MACROS_H_ */
 
@@ -18,74 +18,81 @@ Description: Analysis window and synthesis window of MVDR
 
 #include "dios_ssp_mvdr_win.h" 
 
-void dios_ssp_mvdr_win_init(objMVDRCwin *mvdrwin,int fft_size, int shift_size)
+/* ShareTableBuild of the analysis and normalization windows followed by the
+   synthesis window, arg is the window being initialized */
+static int dios_ssp_mvdr_win_build(void *table, const void *arg)
 {
     int i, j;
-	int tmp;
-	int log_fft_size = 0;
 	float temp;
-	tmp = 1;
+	const objMVDRCwin *mvdrwin = (const objMVDRCwin*)arg;
+	float *ana_win = (float*)table;
+	float *norm_win = ana_win + mvdrwin->m_fft_size;
+	float *syn_win = norm_win + mvdrwin->m_fft_size;
 
-	mvdrwin->m_fft_size = fft_size;
-	mvdrwin->m_shift_size = shift_size;
-
-	if ( mvdrwin->m_shift_size >= mvdrwin->m_fft_size )
-	{
-		printf( "shift_size[%d] >= fft_size[%d].\n", mvdrwin->m_shift_size, mvdrwin->m_fft_size );
-	}
-
-	while ( tmp < mvdrwin->m_fft_size )
-	{
-		log_fft_size += 1;
-		tmp *= 2;
-	}
-	if ( tmp > mvdrwin->m_fft_size )
-	{
-		printf( "FFT Size[%d] should be power of 2.\n", mvdrwin->m_fft_size );
-	}
-	tmp = 1;
-	while ( tmp < mvdrwin->m_shift_size )
-	{
-		tmp *= 2;
-	}
-	if ( tmp > mvdrwin->m_shift_size )
-	{
-		printf( "Shift Size[%d] should be power of 2.\n", mvdrwin->m_shift_size );
-	}
-
-	mvdrwin->m_block_num = mvdrwin->m_fft_size / mvdrwin->m_shift_size;
-	mvdrwin->m_ana_win = (float*)calloc(mvdrwin->m_fft_size, sizeof(float));
-	mvdrwin->m_syn_win = (float*)calloc(mvdrwin->m_fft_size, sizeof(float));
-	mvdrwin->m_norm_win = (float*)calloc(mvdrwin->m_fft_size, sizeof(float));
-	
     for (i = 0; i < mvdrwin->m_fft_size; ++i )
     {
-        mvdrwin->m_ana_win[i] = (float)(0.54 - 0.46*cos((2*i)*PI/(mvdrwin->m_fft_size-1)));
+        ana_win[i] = (float)(0.54 - 0.46*cos((2*i)*PI/(mvdrwin->m_fft_size-1)));
     }
     for (i = 0; i < mvdrwin->m_fft_size; ++i )
     {
-        mvdrwin->m_norm_win[i] = mvdrwin->m_ana_win[i] * mvdrwin->m_ana_win[i];
+        norm_win[i] = ana_win[i] * ana_win[i];
     }
     for (i = 0; i < mvdrwin->m_shift_size; ++i )
     {
         temp = 0;
         for (j = 0; j < mvdrwin->m_block_num; ++j )
         {
-            temp += mvdrwin->m_norm_win[i+j*mvdrwin->m_shift_size];
+            temp += norm_win[i+j*mvdrwin->m_shift_size];
         }
-        mvdrwin->m_norm_win[i] = 1.0f / temp;
+        norm_win[i] = 1.0f / temp;
     }
     for (i = 0; i < mvdrwin->m_shift_size; ++i )
     {
         for (j = 1; j < mvdrwin->m_block_num; ++j )
         {
-            mvdrwin->m_norm_win[i+j*mvdrwin->m_shift_size] = mvdrwin->m_norm_win[i];
+            norm_win[i+j*mvdrwin->m_shift_size] = norm_win[i];
         }
     }
     for (i = 0; i < mvdrwin->m_fft_size; ++i )
     {
-        mvdrwin->m_syn_win[i] = mvdrwin->m_norm_win[i] * mvdrwin->m_ana_win[i]; 
+        syn_win[i] = norm_win[i] * ana_win[i]; 
     }
+
+	return 0;
+}
+
+void dios_ssp_mvdr_win_init(objMVDRCwin *mvdrwin,int fft_size, int shift_size, void *table_pool)
+{
+	int key[2];
+
+	mvdrwin->m_fft_size = fft_size;
+	mvdrwin->m_shift_size = shift_size;
+
+	if ( mvdrwin->m_shift_size >= mvdrwin->m_fft_size )
+	{
+		printf( "shift_size[%d] >= fft_size[%d].\n", mvdrwin->m_shift_size, mvdrwin->m_fft_size );
+	}
+
+	/* the rfft takes 2^k or 3*2^k points, the overlap-add needs whole shifts */
+	if ( mvdrwin->m_fft_size % mvdrwin->m_shift_size != 0 )
+	{
+		printf( "FFT Size[%d] should be a multiple of Shift Size[%d].\n", mvdrwin->m_fft_size, mvdrwin->m_shift_size );
+	}
+
+	mvdrwin->m_block_num = mvdrwin->m_fft_size / mvdrwin->m_shift_size;
+	
+	key[0] = mvdrwin->m_fft_size;
+	key[1] = mvdrwin->m_shift_size;
+	mvdrwin->table_pool = table_pool;
+	mvdrwin->m_ana_win = (const float*)dios_ssp_share_table_get(table_pool, "mvdr_win", key, sizeof(key), 
+		3 * mvdrwin->m_fft_size * sizeof(float), dios_ssp_mvdr_win_build, mvdrwin);
+	if (mvdrwin->m_ana_win == NULL)
+	{
+		printf( "mvdr window table init error!\n" );
+		return;
+	}
+	mvdrwin->m_norm_win = mvdrwin->m_ana_win + mvdrwin->m_fft_size;
+	mvdrwin->m_syn_win = mvdrwin->m_norm_win + mvdrwin->m_fft_size;
 }
 
 int dios_ssp_mvdr_win_add_ana_win(objMVDRCwin *mvdrwin, const float *x, float *x_win)
@@ -112,9 +119,7 @@ int dios_ssp_mvdr_win_add_syn_win(objMVDRCwin *mvdrwin, const float *x, float *x
 
 int dios_ssp_mvdr_win_delete(objMVDRCwin *mvdrwin)
 {
-	free(mvdrwin->m_ana_win);
-	free(mvdrwin->m_syn_win);
-	free(mvdrwin->m_norm_win);
+	dios_ssp_share_table_release(mvdrwin->table_pool, mvdrwin->m_ana_win);
 
 	return 0;
 }
@@ -22,6 +22,7 @@ limitations under the License.
 #include <math.h>
 #include <string.h>
 #include "dios_ssp_mvdr_macros.h"
+#include "../dios_ssp_share/dios_ssp_share_table.h"
 
 typedef struct
 {
@@ -29,9 +30,11 @@ typedef struct
 	int m_shift_size;
 	int m_block_num;
 	
-	float *m_ana_win;
-	float *m_norm_win;
-	float *m_syn_win;
+	/* windows live in one table of the table pool */
+	const float *m_ana_win;
+	const float *m_norm_win;
+	const float *m_syn_win;
+	void *table_pool;
 }objMVDRCwin;
 
 /**********************************************************************************
@@ -40,11 +43,12 @@ Description:   // mvdr win init
 Input:         // mvdrwin
 				  fft_size
 				  shift_size
+				  table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return mvdr win object pointer (void*)mvdrwin
 				  failure: return NULL
 **********************************************************************************/
-void dios_ssp_mvdr_win_init(objMVDRCwin *mvdrwin,int fft_size, int shift_size);
+void dios_ssp_mvdr_win_init(objMVDRCwin *mvdrwin,int fft_size, int shift_size, void *table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_mvdr_win_add_ana_win
@@ -22,12 +22,20 @@ which includes the following steps:
 Details can be found in "Noise Estimation by Minima Controlled Recursive
 Averaging for Robust Speech Enhancement" and "Noise Spectrum Estimation in
 Adverse Environments: Improved Minima Controlled Recursive Averaging"
+In the fixed-point build the windows, the FFTs, the gain multiply and the
+overlap-add run in integer, the noise estimation and the gain calculation stay
+in float.
 ==============================================================================*/
 
 #include "dios_ssp_ns_api.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
 #define PI (3.141592653589793f)
 
+#if DIOS_SSP_FIXED_POINT
+#define NS_FIX_OUT_FRAC (15)  /* overlap-add output in Q15 */
+#endif
+
 static float a[7] = { 1.0f, 3.5156229f, 3.0899424f, 1.2067492f, 0.2659732f, 0.0360768f, 0.0045813f };
 static float b[7] = { 0.5f, 0.87890594f, 0.51498869f, 0.15084934f,0.02658773f,0.00301532f,0.00032411f}; 
 static float c[9] = { 0.39894228f, 0.01328592f, 0.00225319f, -0.00157565f, 0.00916281f, 
@@ -92,6 +100,43 @@ static float first_modified_Bessel( int n, float x )
 	return p;
 }
 
+/* the mmse-stsa gain with speech absence probability q = 0.3 factorizes as
+   G = sqrt(pi)/2*sqrt(vk)/gamma*M(vk) * 1/(1+q/(1-q)*(1+ksi)*exp(-vk)) with 
+   M(v) = exp(-v/2)*((1+v)*I0(v/2)+v*I1(v/2)), so M and exp(-v) are tabulated 
+   once over vk and interpolated linearly, shared read-only by all instances */
+static float ns_gain_tab_m[NS_GAIN_TAB_LEN];
+static float ns_gain_tab_e[NS_GAIN_TAB_LEN];
+#ifndef DIOS_SSP_NO_THREADS
+static pthread_once_t ns_gain_tab_once = PTHREAD_ONCE_INIT;
+#else
+static int ns_gain_tab_done = 0;
+#endif
+
+static void ns_gain_tab_build(void)
+{
+	int i;
+	float v;
+	for (i = 0; i < NS_GAIN_TAB_LEN; ++i)
+	{
+		v = (float)i / NS_GAIN_TAB_RES;
+		ns_gain_tab_m[i] = (float)exp(-0.5*v) * ((1+v)*first_modified_Bessel(0, v/2) + v*first_modified_Bessel(1, v/2));
+		ns_gain_tab_e[i] = (float)exp(-v);
+	}
+}
+
+static void ns_gain_tab_init(void)
+{
+#ifndef DIOS_SSP_NO_THREADS
+	pthread_once(&ns_gain_tab_once, ns_gain_tab_build);
+#else
+	if (!ns_gain_tab_done)
+	{
+		ns_gain_tab_build();
+		ns_gain_tab_done = 1;
+	}
+#endif
+}
+
 typedef struct {
     int frame_len;
     int m_wav_len2;
@@ -113,6 +158,14 @@ typedef struct {
     float *m_ana_win;
 	float *m_syn_win;
 	float *m_norm_win;
+#if DIOS_SSP_FIXED_POINT
+	int m_syn_frac;       // m_syn_win_fix = m_syn_win / m_fft_size * 2^m_syn_frac
+	int *m_ana_win_fix;   // Q31
+	int *m_syn_win_fix;
+	int *m_gain_fix;      // Q15
+	int *m_frame_fix;     // windowed frame, then its spectrum, then the synthesized frame
+	int *m_out_fix;       // overlap-add output in Q NS_FIX_OUT_FRAC
+#endif
 
     //stft_process & istft_process
     int m_log_fft_size;
@@ -164,77 +217,114 @@ typedef struct {
      float m_min_gain;
 } objNSMMSE;
 
-void* dios_ssp_ns_init_api(int frame_len)
+static const size_t g_ns_ptr[] = {
+	offsetof(objNSMMSE, m_out_mmse_data), offsetof(objNSMMSE, m_wav_buffer),
+	offsetof(objNSMMSE, m_out_buffer), offsetof(objNSMMSE, m_win_wav),
+	offsetof(objNSMMSE, m_re), offsetof(objNSMMSE, m_im),
+	offsetof(objNSMMSE, m_ana_win), offsetof(objNSMMSE, m_syn_win),
+	offsetof(objNSMMSE, m_norm_win),
+#if DIOS_SSP_FIXED_POINT
+	offsetof(objNSMMSE, m_ana_win_fix), offsetof(objNSMMSE, m_syn_win_fix),
+	offsetof(objNSMMSE, m_gain_fix), offsetof(objNSMMSE, m_frame_fix),
+	offsetof(objNSMMSE, m_out_fix),
+#endif
+	offsetof(objNSMMSE, m_rev), offsetof(objNSMMSE, m_sin_fft),
+	offsetof(objNSMMSE, m_cos_fft), offsetof(objNSMMSE, m_tmp),
+	offsetof(objNSMMSE, fftin_buffer), offsetof(objNSMMSE, fft_out),
+	offsetof(objNSMMSE, rfft_param), offsetof(objNSMMSE, m_sp_smooth),
+	offsetof(objNSMMSE, m_sp), offsetof(objNSMMSE, m_freq_win),
+	offsetof(objNSMMSE, m_sp_ff), offsetof(objNSMMSE, m_sp_sf),
+	offsetof(objNSMMSE, m_sp_ff_pre), offsetof(objNSMMSE, m_sp_noise),
+	offsetof(objNSMMSE, m_ratio), offsetof(objNSMMSE, m_thres),
+	offsetof(objNSMMSE, m_I), offsetof(objNSMMSE, m_prob),
+	offsetof(objNSMMSE, m_gammak), offsetof(objNSMMSE, m_sp_snr),
+	offsetof(objNSMMSE, m_gain)
+};
+
+void* dios_ssp_ns_init_api(int frame_len, int sample_rate, void* table_pool)
 {
 	void* ptr = NULL;
-	ptr = (void*)calloc(1, sizeof(objNSMMSE));
+	ptr = (void*)dios_ssp_share_calloc_map(1, sizeof(objNSMMSE), g_ns_ptr, SHARE_ARENA_MAP_NUM(g_ns_ptr));
 	objNSMMSE* srv = (objNSMMSE*)ptr;
 
 	srv->frame_len = frame_len;
 	srv->m_wav_len2 = 0;
 	srv->m_buffer_len = 5120;
-	srv->m_max_pack_len = NS_SAMPLE_RATE + 512;
-    srv->m_out_mmse_data = (float *)calloc(2 * srv->frame_len, sizeof(float));
+	srv->m_max_pack_len = sample_rate + 512 * sample_rate / NS_SAMPLE_RATE;
+    srv->m_out_mmse_data = (float *)dios_ssp_share_calloc(2 * srv->frame_len, sizeof(float));
 	
-	srv->m_shift_size = NS_FFT_LEN / 2;
-    srv->m_fft_size  = NS_FFT_LEN;
+	srv->m_shift_size = NS_FFT_LEN / 2 * sample_rate / NS_SAMPLE_RATE;
+    srv->m_fft_size  = NS_FFT_LEN * sample_rate / NS_SAMPLE_RATE;
     srv->m_frame_sum = 0;
-    srv->m_wav_buffer = (float *)calloc(srv->m_max_pack_len, sizeof(float));
-    srv->m_out_buffer = (float *)calloc(srv->m_max_pack_len, sizeof(float));
-    srv->m_win_wav = (float *)calloc(srv->m_fft_size, sizeof(float));
-    srv->m_re = (float *)calloc(srv->m_fft_size, sizeof(float));
-    srv->m_im = (float *)calloc(srv->m_fft_size, sizeof(float));
-
-	srv->m_ana_win = (float *)calloc(srv->m_fft_size, sizeof(float));
-	srv->m_syn_win = (float *)calloc(srv->m_fft_size, sizeof(float));
-	srv->m_norm_win = (float *)calloc(srv->m_fft_size, sizeof(float));
+    srv->m_wav_buffer = (float *)dios_ssp_share_calloc(srv->m_max_pack_len, sizeof(float));
+    srv->m_out_buffer = (float *)dios_ssp_share_calloc(srv->m_max_pack_len, sizeof(float));
+    srv->m_win_wav = (float *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(float));
+    srv->m_re = (float *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(float));
+    srv->m_im = (float *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(float));
+
+	srv->m_ana_win = (float *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(float));
+	srv->m_syn_win = (float *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(float));
+	srv->m_norm_win = (float *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(float));
+#if DIOS_SSP_FIXED_POINT
+	srv->m_ana_win_fix = (int *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(int));
+	srv->m_syn_win_fix = (int *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(int));
+	srv->m_gain_fix = (int *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(int));
+	srv->m_frame_fix = (int *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(int));
+	srv->m_out_fix = (int *)dios_ssp_share_calloc(srv->m_max_pack_len, sizeof(int));
+#endif
 
 	srv->m_log_fft_size = 0;
-    srv->m_rev = (int *)calloc(srv->m_fft_size, sizeof(int));
-    srv->m_sin_fft = (float *)calloc(srv->m_fft_size, sizeof(float));
-	srv->m_cos_fft = (float *)calloc(srv->m_fft_size, sizeof(float));
-	srv->m_tmp = (float *)calloc(srv->m_fft_size, sizeof(float));
-	srv->fftin_buffer = (float*)calloc(NS_FFT_LEN, sizeof(float));
-	srv->fft_out = (float *)calloc(srv->m_fft_size, sizeof(float));
-	srv->m_ind_2k = 2000 * srv->m_fft_size / NS_SAMPLE_RATE;//m_fs-sample
-	srv->m_ind_4k = 4000 * srv->m_fft_size / NS_SAMPLE_RATE;
-    srv->m_ind_6k = 6000 * srv->m_fft_size / NS_SAMPLE_RATE;
+    srv->m_rev = (int *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(int));
+    srv->m_sin_fft = (float *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(float));
+	srv->m_cos_fft = (float *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(float));
+	srv->m_tmp = (float *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(float));
+	srv->fftin_buffer = (float*)dios_ssp_share_calloc(srv->m_fft_size, sizeof(float));
+	srv->fft_out = (float *)dios_ssp_share_calloc(srv->m_fft_size, sizeof(float));
+	srv->m_ind_2k = 2000 * srv->m_fft_size / sample_rate;//m_fs-sample
+	srv->m_ind_4k = 4000 * srv->m_fft_size / sample_rate;
+    srv->m_ind_6k = 6000 * srv->m_fft_size / sample_rate;
     srv->m_thres_02 = 2.0f;
     srv->m_thres_24 = 2.0f;
     srv->m_thres_46 = 2.0f;
     srv->m_thres_68 = 2.0f;
 	srv->m_sp_size = srv->m_fft_size / 2 +1;
+	if (srv->m_ind_6k > srv->m_sp_size) // above the nyquist frequency at 8kHz
+	{
+		srv->m_ind_6k = srv->m_sp_size;
+	}
     srv->m_freq_win_len = 8;//DEFAULT_MMSE_HALF_FRQ_WIN_LEN
-    srv->m_sp_smooth = (float *)calloc(srv->m_fft_size / 2 + 1, sizeof(float));
-    srv->m_sp = (float *)calloc(srv->m_fft_size / 2 + 1, sizeof(float));
-    srv->m_freq_win = (float *)calloc(2 * srv->m_freq_win_len + 1, sizeof(float));
+    srv->m_sp_smooth = (float *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(float));
+    srv->m_sp = (float *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(float));
+    srv->m_freq_win = (float *)dios_ssp_share_calloc(2 * srv->m_freq_win_len + 1, sizeof(float));
     srv->m_ini_frame_num = 20;
-    srv->m_sp_ff = (float *)calloc(srv->m_fft_size / 2 + 1, sizeof(float));
-    srv->m_sp_sf = (float *)calloc(srv->m_fft_size / 2 + 1, sizeof(float));
-    srv->m_sp_ff_pre = (float *)calloc(srv->m_fft_size / 2 + 1, sizeof(float));
-    srv->m_sp_noise = (float *)calloc(srv->m_fft_size / 2 + 1, sizeof(float));
+    srv->m_sp_ff = (float *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(float));
+    srv->m_sp_sf = (float *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(float));
+    srv->m_sp_ff_pre = (float *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(float));
+    srv->m_sp_noise = (float *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(float));
     srv->m_alfa_ff = 0.9f;
     srv->m_alfa_sf = 0.99f;
     srv->m_beta_sf = 0.96f;
-    srv->m_ratio = (float *)calloc(srv->m_fft_size / 2 + 1, sizeof(float));
+    srv->m_ratio = (float *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(float));
     srv->m_eps = 1073.0f;
-    srv->m_thres = (float *)calloc(srv->m_fft_size / 2 + 1, sizeof(float));
-    srv->m_I = (char *)calloc(srv->m_fft_size / 2 + 1, sizeof(char));
+    srv->m_thres = (float *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(float));
+    srv->m_I = (char *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(char));
     srv->m_global_prob = 1.0f;
     srv->m_alfa_fb_prob = 0.0;
-    srv->m_prob = (float *)calloc(srv->m_fft_size / 2 + 1, sizeof(float));
+    srv->m_prob = (float *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(float));
     srv->m_alfa_prob = 0.99f;
     srv->m_alfa_noise = 0.999f;
 
-	srv->m_gammak = (float *)calloc(srv->m_fft_size / 2 + 1, sizeof(float));
+	srv->m_gammak = (float *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(float));
     srv->m_gammak_min = 40.0f;
-    srv->m_sp_snr = (float *)calloc(srv->m_fft_size / 2 + 1, sizeof(float));
+    srv->m_sp_snr = (float *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(float));
     srv->m_alfa_snr = 0.9f;
-    srv->m_gain = (float *)calloc(srv->m_fft_size / 2 + 1, sizeof(float));
+    srv->m_gain = (float *)dios_ssp_share_calloc(srv->m_fft_size / 2 + 1, sizeof(float));
     srv->m_min_gain = 0.25f;
 
 	//FFT initialization
-    srv->rfft_param = dios_ssp_share_rfft_init(NS_FFT_LEN);
+    srv->rfft_param = dios_ssp_share_rfft_init_pool(srv->m_fft_size, table_pool);
+
+	ns_gain_tab_init();
 	
 	return ptr;
 }    
@@ -273,7 +363,7 @@ int dios_ssp_ns_reset_api(void* ptr)
 	{
 		srv->m_norm_win[j] = srv->m_ana_win[j] * srv->m_ana_win[j];
 	}
-	for (i = 0; i <srv->m_fft_size; i++)
+	for (i = 0; i <srv->m_shift_size; i++)
 	{
         temp = 0;
         for (j = 0; j < m_block_num; ++j )
@@ -293,6 +383,29 @@ int dios_ssp_ns_reset_api(void* ptr)
     {
         srv->m_syn_win[i] = srv->m_norm_win[i] * srv->m_ana_win[i]; 
     }
+#if DIOS_SSP_FIXED_POINT
+    {
+        /* the synthesis window takes the 1/N of the inverse FFT, its largest
+           tap just fits in Q31 */
+        float peak = 0.0f;
+        int e = 0;
+        long long v;
+        for (i = 0; i < srv->m_fft_size; ++i )
+        {
+            peak = srv->m_syn_win[i] > peak ? srv->m_syn_win[i] : peak;
+        }
+        frexpf(peak / srv->m_fft_size, &e);
+        srv->m_syn_frac = 31 - e;
+        for (i = 0; i < srv->m_fft_size; ++i )
+        {
+            v = llrint(ldexp(srv->m_ana_win[i], 31));
+            srv->m_ana_win_fix[i] = FIX_SAT32(v);
+            v = llrint(ldexp(srv->m_syn_win[i] / srv->m_fft_size, srv->m_syn_frac));
+            srv->m_syn_win_fix[i] = FIX_SAT32(v);
+        }
+        memset(srv->m_out_fix, 0, srv->m_max_pack_len * sizeof(int));
+    }
+#endif
 
 	srv->m_log_fft_size = 0;
 	int tmp = 1;
@@ -513,29 +626,27 @@ int mmse_gain(objNSMMSE* srv)
 		srv->m_sp_snr[i] = srv->m_alfa_snr*srv->m_sp_snr[i]+(1-srv->m_alfa_snr)*tmp;
 	}
 	
-	float vk, j00, j11, tmpA, tmpB, tmpC; 
-	float evk, Lambda, pSAP;
+	float vk, pos, frac, m_vk, e_vk, tmpA;
+	int idx;
 	for (i = 0; i < srv->m_sp_size; ++i )
 	{
 		vk = srv->m_sp_snr[i]*srv->m_gammak[i]/(1+srv->m_sp_snr[i]);
-		j00 = first_modified_Bessel( 0, vk/2 );
-		j11 = first_modified_Bessel( 1, vk/2 );
-		tmpC = (float)exp( -0.5*vk );
+		pos = vk * NS_GAIN_TAB_RES;
+		pos = pos < 0 ? 0 : (pos > NS_GAIN_TAB_VMAX * NS_GAIN_TAB_RES ? NS_GAIN_TAB_VMAX * NS_GAIN_TAB_RES : pos);
+		idx = (int)pos;
+		frac = pos - idx;
+		m_vk = ns_gain_tab_m[idx] + frac * (ns_gain_tab_m[idx+1] - ns_gain_tab_m[idx]);
+		e_vk = ns_gain_tab_e[idx] + frac * (ns_gain_tab_e[idx+1] - ns_gain_tab_e[idx]);
         if (srv->m_gammak[i] < 1.0e-3)
         {
             tmpA = 0; // Limitation 
         }   
         else
         {
-            tmpA = (float)sqrt(PI) / 2 * (float)pow( vk, 0.5 ) * tmpC / srv->m_gammak[i] ;
+            tmpA = (float)sqrt(PI) / 2 * sqrtf( vk ) * m_vk / srv->m_gammak[i] ;
         }
-		tmpB = (1+vk)*j00+vk*j11;
-		evk = (float)exp( vk );
-		Lambda = (1-0.3f) / 0.3f * evk / ( 1+srv->m_sp_snr[i] );
-		pSAP = Lambda/(Lambda+1 );
-		
-		tmp = tmpA*tmpB*pSAP;
-		srv->m_gain[i] = tmp;
+		// p(H1|Y) = Lambda/(1+Lambda), Lambda = (1-q)/q*exp(vk)/(1+ksi)
+		srv->m_gain[i] = tmpA / (1 + 0.3f / (1-0.3f) * (1+srv->m_sp_snr[i]) * e_vk);
 	}
 	for (i = 0; i < srv->m_sp_size; ++i )
 	{	
@@ -548,6 +659,15 @@ int mmse_gain(objNSMMSE* srv)
 			srv->m_gain[i] = 1;
 		}
 	}
+#if DIOS_SSP_FIXED_POINT
+	/* the spectrum is kept in m_frame_fix, re at i and -im at N - i */
+	for (i = 1; i < srv->m_fft_size/2; ++i )
+	{
+		srv->m_gain_fix[i] = (int)lrintf(srv->m_gain[i] * FIX_Q15_ONE);
+		srv->m_frame_fix[i] = FIX_MUL_Q15(srv->m_frame_fix[i], srv->m_gain_fix[i]);
+		srv->m_frame_fix[srv->m_fft_size-i] = FIX_MUL_Q15(srv->m_frame_fix[srv->m_fft_size-i], srv->m_gain_fix[i]);
+	}
+#else
 	for (i = 1; i < srv->m_fft_size/2; ++i )
 	{
 		srv->m_re[i] *= srv->m_gain[i];
@@ -555,6 +675,7 @@ int mmse_gain(objNSMMSE* srv)
 		srv->m_re[srv->m_fft_size-i] = srv->m_re[i];
 		srv->m_im[srv->m_fft_size-i] = -srv->m_im[i];
 	}
+#endif
 
 	return 0;
 }
@@ -573,30 +694,63 @@ int mmse_process(objNSMMSE* srv, float *in_data, float *out_data)
 	for ( sta = 0; sta + srv->m_fft_size <= srv->m_wav_len2; sta += srv->m_shift_size )
 	{
 		srv->m_frame_sum ++;
+#if DIOS_SSP_FIXED_POINT
+		// 1. add anaylsis window
+		int exp = dios_ssp_share_fixed_from_float(srv->m_wav_buffer+sta, srv->m_frame_fix, srv->m_fft_size, 1);
+		for (i = 0; i < srv->m_fft_size; ++i )
+		{
+			srv->m_frame_fix[i] = FIX_MUL_Q31(srv->m_frame_fix[i], srv->m_ana_win_fix[i]);
+		}
+		// 2. stft, the noise estimation reads the spectrum in float
+		dios_ssp_share_rfft_process_fix(srv->rfft_param, srv->m_frame_fix, srv->m_frame_fix, &exp);
+		dios_ssp_share_fixed_to_float(srv->m_frame_fix, exp, srv->fft_out, srv->m_fft_size);
+#else
 		// 1. add anaylsis window
 		add_ana_win(srv, srv->m_wav_buffer+sta, srv->m_win_wav); 
 		// 2. stft
 		dios_ssp_share_rfft_process(srv->rfft_param, srv->m_win_wav, srv->fft_out);
-		for (i = 0; i < NS_SUBBAND_NUM; i++)
+#endif
+		for (i = 0; i < srv->m_sp_size; i++)
 		{
 			srv->m_re[i] = srv->fft_out[i];
 		}
-		srv->m_im[0] = srv->m_im[NS_FFT_LEN / 2] = 0.0;
-		for (i = 1; i < NS_SUBBAND_NUM - 1; i++)
+		srv->m_im[0] = srv->m_im[srv->m_fft_size / 2] = 0.0;
+		for (i = 1; i < srv->m_sp_size - 1; i++)
 		{
-			srv->m_im[i] = -srv->fft_out[NS_FFT_LEN - i];
+			srv->m_im[i] = -srv->fft_out[srv->m_fft_size - i];
 		}
 		// 3. noise estimation
 		mcra2(srv);
 		// 4. mmse gain
 		mmse_gain(srv);
+#if DIOS_SSP_FIXED_POINT
+		// 5. istft
+		dios_ssp_share_irfft_process_fix(srv->rfft_param, srv->m_frame_fix, srv->m_frame_fix, &exp);
+		// 6. add synthesis window, 1/N included, 7. ola
+		int shift = srv->m_syn_frac - exp - NS_FIX_OUT_FRAC;
+		long long acc;
+		for (i = 0; i < srv->m_fft_size; ++i )
+		{
+			acc = (long long)srv->m_frame_fix[i] * srv->m_syn_win_fix[i];
+			if (shift > 0)
+			{
+				acc = shift < 63 ? (acc + (1LL << (shift - 1))) >> shift : 0;
+			}
+			else
+			{
+				acc = FIX_SAT32(acc) * (1LL << (-shift < 31 ? -shift : 31));
+			}
+			acc += srv->m_out_fix[i+sta];
+			srv->m_out_fix[i+sta] = FIX_SAT32(acc);
+		}
+#else
 		// 5. istft
 		srv->fftin_buffer[0] = srv->m_re[0];
-		srv->fftin_buffer[srv->frame_len] = srv->m_re[srv->frame_len];
-		for (i = 1; i < srv->frame_len; i++) 
+		srv->fftin_buffer[srv->m_shift_size] = srv->m_re[srv->m_shift_size];
+		for (i = 1; i < srv->m_shift_size; i++) 
 		{
 			srv->fftin_buffer[i] = srv->m_re[i];
-			srv->fftin_buffer[NS_FFT_LEN - i] = -srv->m_im[i];
+			srv->fftin_buffer[srv->m_fft_size - i] = -srv->m_im[i];
 		}
 		dios_ssp_share_irfft_process(srv->rfft_param, srv->fftin_buffer, srv->m_win_wav);
 		for (i = 0; i < srv->m_fft_size; ++i)
@@ -611,8 +765,17 @@ int mmse_process(objNSMMSE* srv, float *in_data, float *out_data)
 		{
 			srv->m_out_buffer[i+sta] += srv->m_re[i];
 		}
+#endif
 	}
 	
+#if DIOS_SSP_FIXED_POINT
+	for (i = 0; i < sta; ++i )
+	{
+		srv->m_out_buffer[i] = ldexpf((float)srv->m_out_fix[i], -NS_FIX_OUT_FRAC);
+	}
+	memmove( srv->m_out_fix, srv->m_out_fix+sta, sizeof(int)*(srv->m_fft_size-srv->m_shift_size) );
+	memset( srv->m_out_fix+srv->m_fft_size-srv->m_shift_size, 0, sizeof(int)*sta ); 
+#endif
 	for (i = 0; i < sta; ++i )
 	{
 		if ( srv->m_out_buffer[i] > 32767 )
@@ -663,37 +826,44 @@ int dios_ssp_ns_uninit_api(void* ptr)
 	}
 	objNSMMSE *srv = (objNSMMSE *)ptr;
 
-	free(srv->m_out_mmse_data);
-	free(srv->m_wav_buffer);
-	free(srv->m_out_buffer);
-	free(srv->m_win_wav);
-	free(srv->m_re);
-	free(srv->m_im);
-	free(srv->m_ana_win);
-	free(srv->m_syn_win);
-	free(srv->m_norm_win);
-
-	free(srv->m_rev);
-	free(srv->m_sin_fft);
-	free(srv->m_cos_fft);
-	free(srv->m_tmp);
-	free(srv->fftin_buffer);
-	free(srv->fft_out);
-	free(srv->m_sp_smooth);
-	free(srv->m_sp);
-	free(srv->m_freq_win);
-	free(srv->m_sp_ff);
-	free(srv->m_sp_sf);
-	free(srv->m_sp_ff_pre);
-	free(srv->m_sp_noise);
-	free(srv->m_ratio);
-	free(srv->m_thres);
-
-	free(srv->m_I);
-	free(srv->m_prob);
-	free(srv->m_gammak);
-	free(srv->m_sp_snr);
-	free(srv->m_gain);
+	dios_ssp_share_free(srv->m_out_mmse_data);
+	dios_ssp_share_free(srv->m_wav_buffer);
+	dios_ssp_share_free(srv->m_out_buffer);
+	dios_ssp_share_free(srv->m_win_wav);
+	dios_ssp_share_free(srv->m_re);
+	dios_ssp_share_free(srv->m_im);
+	dios_ssp_share_free(srv->m_ana_win);
+	dios_ssp_share_free(srv->m_syn_win);
+	dios_ssp_share_free(srv->m_norm_win);
+#if DIOS_SSP_FIXED_POINT
+	dios_ssp_share_free(srv->m_ana_win_fix);
+	dios_ssp_share_free(srv->m_syn_win_fix);
+	dios_ssp_share_free(srv->m_gain_fix);
+	dios_ssp_share_free(srv->m_frame_fix);
+	dios_ssp_share_free(srv->m_out_fix);
+#endif
+
+	dios_ssp_share_free(srv->m_rev);
+	dios_ssp_share_free(srv->m_sin_fft);
+	dios_ssp_share_free(srv->m_cos_fft);
+	dios_ssp_share_free(srv->m_tmp);
+	dios_ssp_share_free(srv->fftin_buffer);
+	dios_ssp_share_free(srv->fft_out);
+	dios_ssp_share_free(srv->m_sp_smooth);
+	dios_ssp_share_free(srv->m_sp);
+	dios_ssp_share_free(srv->m_freq_win);
+	dios_ssp_share_free(srv->m_sp_ff);
+	dios_ssp_share_free(srv->m_sp_sf);
+	dios_ssp_share_free(srv->m_sp_ff_pre);
+	dios_ssp_share_free(srv->m_sp_noise);
+	dios_ssp_share_free(srv->m_ratio);
+	dios_ssp_share_free(srv->m_thres);
+
+	dios_ssp_share_free(srv->m_I);
+	dios_ssp_share_free(srv->m_prob);
+	dios_ssp_share_free(srv->m_gammak);
+	dios_ssp_share_free(srv->m_sp_snr);
+	dios_ssp_share_free(srv->m_gain);
 	
 	ret = dios_ssp_share_rfft_uninit(srv->rfft_param);
 	if (0 != ret)
@@ -701,6 +871,6 @@ int dios_ssp_ns_uninit_api(void* ptr)
 		srv->rfft_param = NULL;
 	}
 
-	free(srv);
+	dios_ssp_share_free(srv);
 	return 0;
 }
@@ -22,17 +22,22 @@ limitations under the License.
 #include <stdlib.h>
 #include <math.h>
 #include "../dios_ssp_share/dios_ssp_share_rfft.h"
+#include "../dios_ssp_share/dios_ssp_share_workpool.h"
 #include "dios_ssp_ns_macros.h"
 
 /**********************************************************************************
 Function:      // dios_ssp_ns_init_api
 Description:   // init ns module
 Input:         // frame_len: frame length
+                  sample_rate: sampling rate in Hz, the STFT is scaled from the 
+                  16kHz layout so that the hop stays 8ms
+                  table_pool: pool of read-only tables shared with other 
+                  instances, NULL for private tables
 Output:        // none
 Return:        // success: return ns module pointer
                   failure: return NULL
 **********************************************************************************/
-void* dios_ssp_ns_init_api(int frame_len);
+void* dios_ssp_ns_init_api(int frame_len, int sample_rate, void* table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_ns_reset_api
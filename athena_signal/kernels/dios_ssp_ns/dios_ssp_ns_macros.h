@@ -20,6 +20,10 @@ limitations under the License.
 #define NS_SAMPLE_RATE					  (16000)
 #define NS_FFT_LEN                        (256)
 #define NS_SUBBAND_NUM                    (NS_FFT_LEN/2+1)
+/* mmse gain table over vk = ksi*gamma/(1+ksi), gamma is limited to 40 so vk < 40 */
+#define NS_GAIN_TAB_VMAX                  (40)
+#define NS_GAIN_TAB_RES                   (16)
+#define NS_GAIN_TAB_LEN                   (NS_GAIN_TAB_VMAX*NS_GAIN_TAB_RES+2)
 	
 #endif /* _DIOS_SSP_NS_MACROS_H_ */
 
@@ -0,0 +1,632 @@
+/* Copyright (C) 2017 Beijing Didi Infinity Technology and Development Co.,Ltd.
+All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Description: Bump allocator on a caller-owned buffer or on heap chunks. The
+bound arena is per thread, so instances set up on different threads do not see
+each other's arena.
+
+A block taken with dios_ssp_share_calloc_map is followed by its pointer map, a
+block of its own that holds the image offset of the map before it, the image
+offset, element number and element size of the block and the offsets of the
+pointers in an element. Only image offsets are in a map, so the maps of two
+instances of the same configuration are the same.
+
+A saved state is a header, the address ranges of the image pieces (one for a
+buffer, one per chunk), the reference ranges and then the image. On load the
+image is copied as it is, then every pointer named by a map is moved to the
+same offset here if it points into the saved ranges or references. A pointer
+just past the end of a piece stays at that end, so it is told apart from the
+start of the next piece. Other words are never taken for pointers, whatever
+their value.
+==============================================================================*/
+
+#include "dios_ssp_share_arena.h"
+
+typedef struct
+{
+	char magic[4];
+	int version;
+	int word_size;
+	unsigned int layout;
+	size_t image_size;
+	int range_num;
+	int ref_num;
+}objShareStateHeader;
+
+typedef struct
+{
+	size_t addr;
+	size_t offset;
+	size_t size;
+}objShareStateRange;
+
+typedef struct
+{
+	size_t prev;	// image offset + 1 of the map before, 0 for none
+	size_t block;	// image offset of the block
+	size_t num;		// elements of the block
+	size_t size;	// element size in bytes
+	size_t ptr_num;	// pointers per element, their offsets follow
+}objShareArenaMap;
+
+typedef struct
+{
+	objShareArena *arena;
+	const objShareStateRange *range;	// saved pieces, unaligned
+	int range_num;
+	const objShareStateRange *ref;		// saved references, unaligned
+	int ref_num;
+	const char *image;					// saved image
+}objShareStateLoad;
+
+#ifdef DIOS_SSP_NO_THREADS
+static objShareArena *g_share_arena = NULL;
+#else
+static __thread objShareArena *g_share_arena = NULL;
+#endif
+
+static size_t dios_ssp_share_arena_round(size_t bytes)
+{
+	return (bytes + SHARE_ARENA_ALIGN - 1) & ~(size_t)(SHARE_ARENA_ALIGN - 1);
+}
+
+static int dios_ssp_share_arena_piece_num(const objShareArena *arena)
+{
+	const objShareArenaChunk *c;
+	int num = 0;
+
+	if (arena->base != NULL)
+	{
+		return 1;
+	}
+	for (c = arena->chunk; c != NULL; c = c->next)
+	{
+		num++;
+	}
+
+	return num;
+}
+
+int dios_ssp_share_arena_init(objShareArena *arena, void *buffer, size_t size)
+{
+	size_t addr;
+
+	if (arena == NULL)
+	{
+		return -1;
+	}
+	memset(arena, 0, sizeof(objShareArena));
+	if (buffer == NULL)
+	{
+		return 0;
+	}
+	addr = dios_ssp_share_arena_round((size_t)buffer);
+	if (addr - (size_t)buffer > size)
+	{
+		return -1;
+	}
+	arena->base = (char*)addr;
+	arena->size = size - (addr - (size_t)buffer);
+
+	return 0;
+}
+
+objShareArena *dios_ssp_share_arena_bind(objShareArena *arena)
+{
+	objShareArena *prev = g_share_arena;
+	g_share_arena = arena;
+
+	return prev;
+}
+
+size_t dios_ssp_share_arena_bytes(const objShareArena *arena)
+{
+	return arena->used + SHARE_ARENA_ALIGN;
+}
+
+void dios_ssp_share_arena_release(objShareArena *arena)
+{
+	objShareArenaChunk *c = arena->chunk;
+	objShareArenaChunk *next;
+
+	while (c != NULL)
+	{
+		next = c->next;
+		free(c);
+		c = next;
+	}
+	arena->chunk = NULL;
+}
+
+void dios_ssp_share_arena_hole(const void *ptr, size_t size)
+{
+	objShareArena *arena = g_share_arena;
+
+	if (arena == NULL || ptr == NULL)
+	{
+		return;
+	}
+	if (arena->hole_num < SHARE_ARENA_MAX_RANGES)
+	{
+		arena->hole[arena->hole_num].base = (const char*)ptr;
+		arena->hole[arena->hole_num].size = size;
+	}
+	arena->hole_num++;
+}
+
+void dios_ssp_share_arena_ref(const void *ptr, size_t size)
+{
+	objShareArena *arena = g_share_arena;
+
+	if (arena == NULL || ptr == NULL)
+	{
+		return;
+	}
+	if (arena->ref_num < SHARE_ARENA_MAX_RANGES)
+	{
+		arena->ref[arena->ref_num].base = (const char*)ptr;
+		arena->ref[arena->ref_num].size = size;
+	}
+	arena->ref_num++;
+}
+
+size_t dios_ssp_share_arena_state_size(const objShareArena *arena)
+{
+	if (arena->hole_num > SHARE_ARENA_MAX_RANGES || arena->ref_num > SHARE_ARENA_MAX_RANGES
+		|| (arena->base != NULL && arena->used > arena->size))
+	{
+		return 0;
+	}
+
+	return sizeof(objShareStateHeader)
+		+ (dios_ssp_share_arena_piece_num(arena) + arena->ref_num) * sizeof(objShareStateRange)
+		+ arena->used;
+}
+
+int dios_ssp_share_arena_state_save(const objShareArena *arena, void *state, size_t state_size)
+{
+	objShareStateHeader header;
+	objShareStateRange range;
+	const objShareArenaChunk *c;
+	char *dst = (char*)state;
+	char *image;
+	int range_num = dios_ssp_share_arena_piece_num(arena);
+	size_t need = dios_ssp_share_arena_state_size(arena);
+	int i;
+
+	if (state == NULL || need == 0 || state_size < need)
+	{
+		return -1;
+	}
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "DSSP", 4);
+	header.version = SHARE_STATE_VERSION;
+	header.word_size = (int)sizeof(size_t);
+	header.layout = arena->layout;
+	header.image_size = arena->used;
+	header.range_num = range_num;
+	header.ref_num = arena->ref_num;
+	memcpy(dst, &header, sizeof(header));
+	dst += sizeof(header);
+	image = dst + (range_num + arena->ref_num) * sizeof(objShareStateRange);
+
+	if (arena->base != NULL)
+	{
+		range.addr = (size_t)arena->base;
+		range.offset = 0;
+		range.size = arena->used;
+		memcpy(dst, &range, sizeof(range));
+		memcpy(image, arena->base, arena->used);
+	}
+	else
+	{
+		/* newest chunk first, its range goes last */
+		i = range_num;
+		for (c = arena->chunk; c != NULL; c = c->next)
+		{
+			i--;
+			range.addr = (size_t)c->base;
+			range.offset = c->offset;
+			range.size = c->used;
+			memcpy(dst + i * sizeof(range), &range, sizeof(range));
+			memcpy(image + c->offset, c->base, c->used);
+		}
+	}
+	dst += range_num * sizeof(range);
+	for (i = 0; i < arena->ref_num; i++)
+	{
+		range.addr = (size_t)arena->ref[i].base;
+		range.offset = 0;
+		range.size = arena->ref[i].size;
+		memcpy(dst + i * sizeof(range), &range, sizeof(range));
+	}
+
+	return 0;
+}
+
+/* address of image offset here, at_end picks the end of a piece over the
+   start of the next one */
+static char *dios_ssp_share_arena_addr(const objShareArena *arena, size_t offset, int at_end)
+{
+	const objShareArenaChunk *c;
+	char *end = NULL;
+
+	if (arena->base != NULL)
+	{
+		return offset <= arena->used ? arena->base + offset : NULL;
+	}
+	for (c = arena->chunk; c != NULL; c = c->next)
+	{
+		if (offset == c->offset + c->used)
+		{
+			end = c->base + c->used;
+			if (at_end)
+			{
+				return end;
+			}
+		}
+		else if (offset >= c->offset && offset < c->offset + c->used)
+		{
+			return c->base + (offset - c->offset);
+		}
+	}
+
+	return end;
+}
+
+/* where a saved pointer goes here, NULL if it points outside the saved
+   ranges and references */
+static char *dios_ssp_share_arena_move(const objShareStateLoad *load, size_t word)
+{
+	objShareStateRange range;
+	size_t end_offset = 0;
+	int at_end = 0;
+	int i;
+
+	for (i = 0; i < load->range_num; i++)
+	{
+		memcpy(&range, load->range + i, sizeof(range));
+		if (word >= range.addr && word < range.addr + range.size)
+		{
+			return dios_ssp_share_arena_addr(load->arena, range.offset + (word - range.addr), 0);
+		}
+		if (word == range.addr + range.size)
+		{
+			end_offset = range.offset + range.size;
+			at_end = 1;
+		}
+	}
+	if (at_end)
+	{
+		return dios_ssp_share_arena_addr(load->arena, end_offset, 1);
+	}
+	for (i = 0; i < load->ref_num; i++)
+	{
+		memcpy(&range, load->ref + i, sizeof(range));
+		if (word >= range.addr && word <= range.addr + range.size)
+		{
+			return (char*)load->arena->ref[i].base + (word - range.addr);
+		}
+	}
+
+	return NULL;
+}
+
+static int dios_ssp_share_arena_in_hole(const objShareArena *arena, const char *ptr)
+{
+	int i;
+
+	for (i = 0; i < arena->hole_num; i++)
+	{
+		if (ptr >= arena->hole[i].base && ptr < arena->hole[i].base + arena->hole[i].size)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/* load one piece of the image, skipping the holes in it */
+static void dios_ssp_share_arena_load_piece(const objShareArena *arena, char *base, const char *src, size_t bytes)
+{
+	char *pos = base;
+	char *end = base + bytes;
+	char *hole_start;
+	char *hole_end;
+	int next;
+	int i;
+
+	while (pos < end)
+	{
+		/* first hole at or after pos */
+		next = -1;
+		for (i = 0; i < arena->hole_num; i++)
+		{
+			hole_end = (char*)arena->hole[i].base + arena->hole[i].size;
+			if (hole_end > pos && (char*)arena->hole[i].base < end
+				&& (next < 0 || arena->hole[i].base < arena->hole[next].base))
+			{
+				next = i;
+			}
+		}
+		if (next < 0)
+		{
+			memcpy(pos, src + (pos - base), end - pos);
+			break;
+		}
+		hole_start = (char*)arena->hole[next].base;
+		hole_end = hole_start + arena->hole[next].size;
+		if (hole_start > pos)
+		{
+			memcpy(pos, src + (pos - base), hole_start - pos);
+		}
+		pos = hole_end < end ? hole_end : end;
+	}
+}
+
+/* pointer map at image offset + 1 here, NULL if it does not fit in the image
+   or does not match the saved one */
+static const objShareArenaMap *dios_ssp_share_arena_map(const objShareStateLoad *load, size_t map)
+{
+	const objShareArena *arena = load->arena;
+	const objShareArenaMap *m;
+	const size_t *ptr;
+	size_t bytes;
+	size_t i;
+
+	if (map == 0 || map - 1 + sizeof(objShareArenaMap) > arena->used)
+	{
+		return NULL;
+	}
+	m = (const objShareArenaMap*)dios_ssp_share_arena_addr(arena, map - 1, 0);
+	if (m == NULL || m->prev >= map || m->size < sizeof(size_t)
+		|| m->ptr_num > (arena->used - (map - 1) - sizeof(objShareArenaMap)) / sizeof(size_t)
+		|| m->block > arena->used || m->num > (arena->used - m->block) / m->size)
+	{
+		return NULL;
+	}
+	ptr = (const size_t*)(m + 1);
+	for (i = 0; i < m->ptr_num; i++)
+	{
+		if (ptr[i] > m->size - sizeof(size_t))
+		{
+			return NULL;
+		}
+	}
+	bytes = sizeof(objShareArenaMap) + m->ptr_num * sizeof(size_t);
+	if (0 != memcmp(m, load->image + map - 1, bytes))
+	{
+		return NULL;
+	}
+
+	return m;
+}
+
+/* move the pointers of one map to where they point here */
+static void dios_ssp_share_arena_load_map(const objShareStateLoad *load, const objShareArenaMap *m)
+{
+	const size_t *ptr = (const size_t*)(m + 1);
+	size_t offset;
+	size_t word;
+	char *dst;
+	char *moved;
+	size_t n;
+	size_t i;
+
+	for (n = 0; n < m->num; n++)
+	{
+		for (i = 0; i < m->ptr_num; i++)
+		{
+			offset = m->block + n * m->size + ptr[i];
+			dst = dios_ssp_share_arena_addr(load->arena, offset, 0);
+			memcpy(&word, load->image + offset, sizeof(size_t));
+			if (word == 0 || dst == NULL || dios_ssp_share_arena_in_hole(load->arena, dst))
+			{
+				continue;
+			}
+			moved = dios_ssp_share_arena_move(load, word);
+			if (moved != NULL)
+			{
+				word = (size_t)moved;
+				memcpy(dst, &word, sizeof(size_t));
+			}
+		}
+	}
+}
+
+int dios_ssp_share_arena_state_load(objShareArena *arena, const void *state, size_t state_size)
+{
+	objShareStateHeader header;
+	objShareStateLoad load;
+	const objShareArenaChunk *c;
+	const objShareArenaMap *m;
+	const char *src = (const char*)state;
+	size_t map;
+
+	if (state == NULL || state_size < sizeof(header) || dios_ssp_share_arena_state_size(arena) == 0)
+	{
+		return -1;
+	}
+	memcpy(&header, src, sizeof(header));
+	if (0 != memcmp(header.magic, "DSSP", 4) || header.version != SHARE_STATE_VERSION
+		|| header.word_size != (int)sizeof(size_t) || header.layout != arena->layout
+		|| header.image_size != arena->used || header.ref_num != arena->ref_num
+		|| header.range_num < 1 || state_size < sizeof(header)
+		+ (header.range_num + header.ref_num) * sizeof(objShareStateRange) + header.image_size)
+	{
+		return -1;
+	}
+	load.arena = arena;
+	load.range = (const objShareStateRange*)(src + sizeof(header));
+	load.range_num = header.range_num;
+	load.ref = load.range + header.range_num;
+	load.ref_num = header.ref_num;
+	load.image = (const char*)(load.ref + header.ref_num);
+
+	/* the maps are copied with the image, they have to be the saved ones */
+	for (map = arena->map; map != 0; map = m->prev)
+	{
+		m = dios_ssp_share_arena_map(&load, map);
+		if (m == NULL)
+		{
+			return -1;
+		}
+	}
+
+	if (arena->base != NULL)
+	{
+		dios_ssp_share_arena_load_piece(arena, arena->base, load.image, arena->used);
+	}
+	for (c = arena->chunk; c != NULL; c = c->next)
+	{
+		dios_ssp_share_arena_load_piece(arena, c->base, load.image + c->offset, c->used);
+	}
+	for (map = arena->map; map != 0; map = m->prev)
+	{
+		m = (const objShareArenaMap*)dios_ssp_share_arena_addr(arena, map - 1, 0);
+		dios_ssp_share_arena_load_map(&load, m);
+	}
+
+	return 0;
+}
+
+void *dios_ssp_share_calloc(size_t num, size_t size)
+{
+	objShareArena *arena = g_share_arena;
+	objShareArenaChunk *c;
+	size_t bytes;
+	size_t cap;
+	void *ptr;
+
+	if (arena == NULL)
+	{
+		return calloc(num, size);
+	}
+	if (size != 0 && num > ((size_t)-1 - SHARE_ARENA_ALIGN) / size)
+	{
+		return NULL;
+	}
+	bytes = dios_ssp_share_arena_round(num * size);
+	arena->layout = arena->layout * 31u + (unsigned int)bytes;
+	if (arena->base == NULL)
+	{
+		c = arena->chunk;
+		if (c == NULL || bytes > c->size - c->used)
+		{
+			cap = bytes > SHARE_ARENA_CHUNK ? bytes : SHARE_ARENA_CHUNK;
+			c = (objShareArenaChunk*)calloc(1, sizeof(objShareArenaChunk) + SHARE_ARENA_ALIGN + cap);
+			if (c == NULL)
+			{
+				return NULL;
+			}
+			c->base = (char*)dios_ssp_share_arena_round((size_t)(c + 1));
+			c->offset = arena->used;
+			c->size = cap;
+			c->next = arena->chunk;
+			arena->chunk = c;
+		}
+		ptr = c->base + c->used;
+		c->used += bytes;
+		arena->used += bytes;
+		return ptr;
+	}
+	if (arena->used > arena->size || bytes > arena->size - arena->used)
+	{
+		/* the owner sees used > size afterwards and undoes the whole init */
+		arena->used += bytes;
+		return calloc(num, size);
+	}
+	ptr = arena->base + arena->used;
+	arena->used += bytes;
+	memset(ptr, 0, num * size);
+
+	return ptr;
+}
+
+void *dios_ssp_share_calloc_map(size_t num, size_t size, const size_t *ptr, int ptr_num)
+{
+	objShareArena *arena = g_share_arena;
+	objShareArenaMap *m;
+	size_t block;
+	size_t map;
+	void *mem;
+
+	if (arena == NULL || ptr_num <= 0)
+	{
+		return dios_ssp_share_calloc(num, size);
+	}
+	block = arena->used;
+	mem = dios_ssp_share_calloc(num, size);
+	if (mem == NULL)
+	{
+		return NULL;
+	}
+	map = arena->used;
+	m = (objShareArenaMap*)dios_ssp_share_calloc(1, sizeof(objShareArenaMap) + ptr_num * sizeof(size_t));
+	if (arena->base != NULL && arena->used > arena->size)
+	{
+		/* the init is undone anyway, only the size counts */
+		free(m);
+		return mem;
+	}
+	if (m == NULL)
+	{
+		dios_ssp_share_free(mem);
+		return NULL;
+	}
+	m->prev = arena->map;
+	m->block = block;
+	m->num = num;
+	m->size = size;
+	m->ptr_num = ptr_num;
+	memcpy(m + 1, ptr, ptr_num * sizeof(size_t));
+	arena->map = map + 1;
+
+	return mem;
+}
+
+void *dios_ssp_share_calloc_ptr(size_t num, size_t size)
+{
+	static const size_t ptr[1] = {0};
+
+	return dios_ssp_share_calloc_map(num, size, ptr, 1);
+}
+
+void dios_ssp_share_free(void *ptr)
+{
+	objShareArena *arena = g_share_arena;
+	const objShareArenaChunk *c;
+
+	if (ptr == NULL)
+	{
+		return;
+	}
+	if (arena != NULL)
+	{
+		if (arena->base != NULL && (char*)ptr >= arena->base && (char*)ptr < arena->base + arena->size)
+		{
+			return;
+		}
+		for (c = arena->chunk; c != NULL; c = c->next)
+		{
+			if ((char*)ptr >= c->base && (char*)ptr < c->base + c->size)
+			{
+				return;
+			}
+		}
+	}
+	free(ptr);
+}
@@ -0,0 +1,233 @@
+/* Copyright (C) 2017 Beijing Didi Infinity Technology and Development Co.,Ltd.
+All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Description: Memory of all modules is taken with dios_ssp_share_calloc and
+given back with dios_ssp_share_free. Without an arena these are calloc and
+free. While an arena is bound to the calling thread, blocks are carved one
+after another on SHARE_ARENA_ALIGN boundaries and free does nothing, the
+memory is released as a whole by the owner of the arena. The blocks come from
+a caller buffer, or from heap chunks when the arena has no buffer. When a
+buffer runs out the rest comes from the heap and used ends up above size, so
+the owner can tell and free everything with the arena still bound.
+
+Either way the blocks are laid out in one image, the offset of a block only
+depends on the sizes of the blocks before it. The state of an instance is that
+image, saved with the addresses it had, so pointers can be moved to another
+instance of the same configuration when it is loaded there. Blocks of
+dios_ssp_share_calloc hold no pointers. Blocks that do are taken with
+dios_ssp_share_calloc_map, which notes where their pointers are, or with
+dios_ssp_share_calloc_ptr for arrays of pointers. Memory that is not state
+(thread handles, the arena itself) is marked as a hole and memory used but not
+owned (pooled tables) as a reference.
+==============================================================================*/
+
+#ifndef _DIOS_SSP_SHARE_ARENA_H_
+#define _DIOS_SSP_SHARE_ARENA_H_
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dios_ssp_share_workpool.h"
+
+#define SHARE_ARENA_ALIGN		(64)
+#define SHARE_ARENA_CHUNK		(256 * 1024)
+#define SHARE_ARENA_MAX_RANGES	(32)
+#define SHARE_STATE_VERSION		(2)
+
+/* number of pointers in a map of dios_ssp_share_calloc_map */
+#define SHARE_ARENA_MAP_NUM(map)	((int)(sizeof(map) / sizeof((map)[0])))
+
+typedef struct objShareArenaChunk_
+{
+	struct objShareArenaChunk_ *next;
+	char *base;		// first aligned byte of the chunk
+	size_t offset;	// image offset of base
+	size_t size;	// usable bytes from base
+	size_t used;	// bytes carved so far
+}objShareArenaChunk;
+
+typedef struct
+{
+	const char *base;
+	size_t size;
+}objShareArenaRange;
+
+typedef struct
+{
+	char *base;		// first aligned byte of the buffer, NULL for heap chunks
+	size_t size;	// usable bytes from base
+	size_t used;	// image bytes carved so far, above size when the buffer
+					// was too small
+	objShareArenaChunk *chunk;	// heap chunks, newest first
+	unsigned int layout;		// hash of the block sizes in order
+	size_t map;		// image offset + 1 of the newest pointer map, 0 for none
+	int hole_num;
+	objShareArenaRange hole[SHARE_ARENA_MAX_RANGES];
+	int ref_num;
+	objShareArenaRange ref[SHARE_ARENA_MAX_RANGES];
+}objShareArena;
+
+/**********************************************************************************
+Function:      // dios_ssp_share_arena_init
+Description:   // set up an arena on a caller-owned buffer or on heap chunks
+Input:         // arena: arena object
+                  buffer: memory to carve from, any alignment. NULL takes
+                          SHARE_ARENA_CHUNK chunks from the heap as needed
+                  size: buffer size in bytes
+Output:        // none
+Return:        // success: return 0, failure: return -1
+**********************************************************************************/
+int dios_ssp_share_arena_init(objShareArena *arena, void *buffer, size_t size);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_arena_bind
+Description:   // make arena the one used by dios_ssp_share_calloc and
+                  dios_ssp_share_free on the calling thread
+Input:         // arena: arena object, NULL goes back to calloc and free
+Output:        // none
+Return:        // the arena bound before, to be bound again afterwards
+**********************************************************************************/
+objShareArena *dios_ssp_share_arena_bind(objShareArena *arena);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_arena_bytes
+Description:   // buffer size that holds the image carved so far, whatever the
+                  alignment of the buffer
+Input:         // arena: arena object
+Output:        // none
+Return:        // bytes
+**********************************************************************************/
+size_t dios_ssp_share_arena_bytes(const objShareArena *arena);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_arena_release
+Description:   // free the heap chunks of an arena, blocks carved from them must
+                  not be used any more
+Input:         // arena: arena object, not bound
+Output:        // none
+Return:        // none
+**********************************************************************************/
+void dios_ssp_share_arena_release(objShareArena *arena);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_arena_hole
+Description:   // mark memory of the bound arena that is not state, it keeps its
+                  content when a state is loaded. ignored if no arena is bound
+Input:         // ptr: memory pointer
+                  size: bytes
+Output:        // none
+Return:        // none
+**********************************************************************************/
+void dios_ssp_share_arena_hole(const void *ptr, size_t size);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_arena_ref
+Description:   // note memory outside the bound arena that its blocks point to,
+                  e.g. a pooled table. references are matched by the order in
+                  which they are noted. ignored if no arena is bound
+Input:         // ptr: memory pointer
+                  size: bytes
+Output:        // none
+Return:        // none
+**********************************************************************************/
+void dios_ssp_share_arena_ref(const void *ptr, size_t size);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_arena_state_size
+Description:   // bytes of the state of an arena
+Input:         // arena: arena object
+Output:        // none
+Return:        // success: return bytes, failure: return 0 if the arena can not
+                  be saved, e.g. too many holes or references
+**********************************************************************************/
+size_t dios_ssp_share_arena_state_size(const objShareArena *arena);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_arena_state_save
+Description:   // copy the image of an arena with its addresses to state
+Input:         // arena: arena object
+                  state_size: bytes of state
+Output:        // state: saved state
+Return:        // success: return 0, failure: return -1
+**********************************************************************************/
+int dios_ssp_share_arena_state_save(const objShareArena *arena, void *state, size_t state_size);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_arena_state_load
+Description:   // overwrite the image of an arena with a saved one of the same
+                  layout. the pointers noted by dios_ssp_share_calloc_map and
+                  dios_ssp_share_calloc_ptr are moved to the same place in this
+                  arena if they point into the saved image or its references,
+                  and are kept as saved otherwise
+Input:         // arena: arena object
+                  state: saved state
+                  state_size: bytes of state
+Output:        // none
+Return:        // success: return 0, failure: return -1 if the state is not
+                  from an arena of the same layout
+**********************************************************************************/
+int dios_ssp_share_arena_state_load(objShareArena *arena, const void *state, size_t state_size);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_calloc
+Description:   // zeroed memory of num * size bytes from the bound arena, or from
+                  the heap if none is bound
+Input:         // num: number of elements
+                  size: element size in bytes
+Output:        // none
+Return:        // success: return memory pointer
+                  failure: return NULL
+**********************************************************************************/
+void *dios_ssp_share_calloc(size_t num, size_t size);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_calloc_map
+Description:   // dios_ssp_share_calloc for elements that hold pointers, the
+                  offsets of the pointers are noted with the block in the bound
+                  arena
+Input:         // num: number of elements
+                  size: element size in bytes
+                  ptr: byte offsets of the pointers in an element, e.g. offsetof
+                  ptr_num: number of offsets
+Output:        // none
+Return:        // success: return memory pointer
+                  failure: return NULL
+**********************************************************************************/
+void *dios_ssp_share_calloc_map(size_t num, size_t size, const size_t *ptr, int ptr_num);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_calloc_ptr
+Description:   // dios_ssp_share_calloc for an array of pointers
+Input:         // num: number of pointers
+                  size: pointer size in bytes, sizeof(void*)
+Output:        // none
+Return:        // success: return memory pointer
+                  failure: return NULL
+**********************************************************************************/
+void *dios_ssp_share_calloc_ptr(size_t num, size_t size);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_free
+Description:   // give back memory of dios_ssp_share_calloc, dios_ssp_share_calloc_map
+                  or dios_ssp_share_calloc_ptr, blocks of the bound arena are
+                  left to its owner
+Input:         // ptr: memory pointer, NULL is ignored
+Output:        // none
+Return:        // none
+**********************************************************************************/
+void dios_ssp_share_free(void *ptr);
+
+#endif /* _DIOS_SSP_SHARE_ARENA_H_ */
@@ -13,44 +13,60 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 
-Description: Calculate the inverse of complex matrix.
+Description: Calculate the inverse of complex matrix. dios_ssp_matrix_inv_process 
+uses full pivoting gauss-jordan elimination for general matrices, while 
+dios_ssp_hermitian_inv_process inverts a batch of hermitian positive definite 
+matrices (e.g. the per bin covariance matrices of MVDR and DOA) by cholesky 
+factorization with diagonal loading. where only R^-1*b is needed the factor can 
+be kept with dios_ssp_hermitian_chol_process, updated by rank-1 terms with 
+dios_ssp_hermitian_chol_update and solved with dios_ssp_hermitian_chol_solve.
 ==============================================================================*/
 
 #include  "dios_ssp_share_cinv.h"
+#include "dios_ssp_share_arena.h"
+
+static const size_t g_matrix_inv_ptr[] = {
+	offsetof(objMATRIXinv, ar), offsetof(objMATRIXinv, ai),
+	offsetof(objMATRIXinv, mat_temp), offsetof(objMATRIXinv, mat_temp2),
+	offsetof(objMATRIXinv, is), offsetof(objMATRIXinv, js)
+};
 
 void *dios_ssp_matrix_inv_init(int Rdim)
 {
     void *matrix_inv = NULL;
-    matrix_inv = (void*)calloc(1, sizeof(objMATRIXinv));
+    matrix_inv = (void*)dios_ssp_share_calloc_map(1, sizeof(objMATRIXinv), g_matrix_inv_ptr, SHARE_ARENA_MAP_NUM(g_matrix_inv_ptr));
     objMATRIXinv *matrixinv;
     matrixinv = (objMATRIXinv*)matrix_inv;
 	int i;
 
 	matrixinv->dim = Rdim;
-	matrixinv->ar = (float**)calloc(matrixinv->dim, sizeof(float*));
+	matrixinv->ar = (float**)dios_ssp_share_calloc_ptr(matrixinv->dim, sizeof(float*));
 	for(i = 0; i < matrixinv->dim; ++i)
 	{
-		matrixinv->ar[i] = (float*)calloc(matrixinv->dim, sizeof(float));
+		matrixinv->ar[i] = (float*)dios_ssp_share_calloc(matrixinv->dim, sizeof(float));
 	}
 		
-	matrixinv->ai = (float**)calloc(matrixinv->dim, sizeof(float*));
+	matrixinv->ai = (float**)dios_ssp_share_calloc_ptr(matrixinv->dim, sizeof(float*));
 	for(i = 0; i < matrixinv->dim; ++i)
 	{
-		matrixinv->ai[i] = (float*)calloc(matrixinv->dim, sizeof(float));
+		matrixinv->ai[i] = (float*)dios_ssp_share_calloc(matrixinv->dim, sizeof(float));
 	}
 	
-	matrixinv->mat_temp = (float**)calloc(matrixinv->dim, sizeof(float*));
+	matrixinv->mat_temp = (float**)dios_ssp_share_calloc_ptr(matrixinv->dim, sizeof(float*));
 	for(i = 0; i < matrixinv->dim; ++i)
 	{
-		matrixinv->mat_temp[i] = (float*)calloc(matrixinv->dim, sizeof(float));
+		matrixinv->mat_temp[i] = (float*)dios_ssp_share_calloc(matrixinv->dim, sizeof(float));
 	}
 
-	matrixinv->mat_temp2 = (float**)calloc(matrixinv->dim, sizeof(float*));
+	matrixinv->mat_temp2 = (float**)dios_ssp_share_calloc_ptr(matrixinv->dim, sizeof(float*));
 	for(i = 0; i < matrixinv->dim; ++i)
 	{
-		matrixinv->mat_temp2[i] = (float*)calloc(matrixinv->dim, sizeof(float));
+		matrixinv->mat_temp2[i] = (float*)dios_ssp_share_calloc(matrixinv->dim, sizeof(float));
 	}
 
+	matrixinv->is = (int*)dios_ssp_share_calloc(matrixinv->dim, sizeof(int));
+	matrixinv->js = (int*)dios_ssp_share_calloc(matrixinv->dim, sizeof(int));
+
     return (matrix_inv);
 }
 
@@ -59,9 +75,8 @@ int dios_ssp_matrix_inv_process(void *matrix_inv, float *R, float *Rinv)
     objMATRIXinv *matrixinv;
     matrixinv = (objMATRIXinv*)matrix_inv;
 
-	int *is,*js;
-	is = (int *)calloc(matrixinv->dim, sizeof(int));
-	js = (int *)calloc(matrixinv->dim, sizeof(int));
+	int *is = matrixinv->is;
+	int *js = matrixinv->js;
 	int i, j, k;
 	float p, q, s, t, d, b;
 	for(i = 0; i<matrixinv->dim; i++)		
@@ -90,10 +105,8 @@ int dios_ssp_matrix_inv_process(void *matrix_inv, float *R, float *Rinv)
 		}
 		if (d+1.0==1.0)
 		{
-			free(is);
-			free(js);
-			printf("The matrix is singular!");
-			exit(-1);
+			printf("The matrix is singular!\n");
+			return -1;
 		}
 		if (is[k]!=k)
 		{
@@ -177,9 +190,6 @@ int dios_ssp_matrix_inv_process(void *matrix_inv, float *R, float *Rinv)
 		}
 	}
 	
-	free(is);
-	free(js);
-	
 	return 0;
 }
 
@@ -191,18 +201,385 @@ int dios_ssp_matrix_inv_delete(void *matrix_inv)
     int i;
 	for(i = 0; i < matrixinv->dim; ++i)
 	{
-		free(matrixinv->ar[i]);
-		free(matrixinv->ai[i]);
-		free(matrixinv->mat_temp[i]);
-		free(matrixinv->mat_temp2[i]);
+		dios_ssp_share_free(matrixinv->ar[i]);
+		dios_ssp_share_free(matrixinv->ai[i]);
+		dios_ssp_share_free(matrixinv->mat_temp[i]);
+		dios_ssp_share_free(matrixinv->mat_temp2[i]);
 	}
 	
-	free(matrixinv->ar);
-	free(matrixinv->ai);
-	free(matrixinv->mat_temp);
-	free(matrixinv->mat_temp2);
-    free(matrixinv);
+	dios_ssp_share_free(matrixinv->ar);
+	dios_ssp_share_free(matrixinv->ai);
+	dios_ssp_share_free(matrixinv->mat_temp);
+	dios_ssp_share_free(matrixinv->mat_temp2);
+	dios_ssp_share_free(matrixinv->is);
+	dios_ssp_share_free(matrixinv->js);
+    dios_ssp_share_free(matrixinv);
+
+	return 0;
+}
+
+static const size_t g_herm_inv_ptr[] = {
+	offsetof(objHERMinv, l_re), offsetof(objHERMinv, l_im),
+	offsetof(objHERMinv, li_re), offsetof(objHERMinv, li_im)
+};
+
+void *dios_ssp_hermitian_inv_init(int dim, float loading)
+{
+	if (dim < 1 || dim > HERM_INV_MAX_DIM || loading < 0.0f)
+	{
+		printf("hermitian inverse dim %d or loading %f is not supported!\n", dim, loading);
+		return NULL;
+	}
+
+	objHERMinv *herminv = (objHERMinv*)dios_ssp_share_calloc_map(1, sizeof(objHERMinv), g_herm_inv_ptr, SHARE_ARENA_MAP_NUM(g_herm_inv_ptr));
+	herminv->dim = dim;
+	herminv->loading = loading;
+	herminv->l_re = (double*)dios_ssp_share_calloc(dim * dim, sizeof(double));
+	herminv->l_im = (double*)dios_ssp_share_calloc(dim * dim, sizeof(double));
+	herminv->li_re = (double*)dios_ssp_share_calloc(dim * dim, sizeof(double));
+	herminv->li_im = (double*)dios_ssp_share_calloc(dim * dim, sizeof(double));
+
+	return herminv;
+}
+
+/* cholesky factorization of R + load*I, R given by its upper triangle, 
+   the factor L is lower triangular with real diagonal */
+static int dios_ssp_hermitian_cholesky(objHERMinv *herminv, const float *r_re, const float *r_im, 
+	double load, double tol)
+{
+	int n = herminv->dim;
+	double *l_re = herminv->l_re;
+	double *l_im = herminv->l_im;
+	int i, j, k;
+	double d, s_re, s_im, inv;
+
+	for (j = 0; j < n; j++)
+	{
+		d = (double)r_re[j*n+j] + load;
+		for (k = 0; k < j; k++)
+		{
+			d -= l_re[j*n+k] * l_re[j*n+k] + l_im[j*n+k] * l_im[j*n+k];
+		}
+		/* also catches NaN */
+		if (!(d > tol))
+		{
+			return -1;
+		}
+		d = sqrt(d);
+		l_re[j*n+j] = d;
+		l_im[j*n+j] = 0.0;
+		inv = 1.0 / d;
+		for (i = j + 1; i < n; i++)
+		{
+			/* R[i][j] = conj(R[j][i]) */
+			s_re = (double)r_re[j*n+i];
+			s_im = (r_im == NULL) ? 0.0 : -(double)r_im[j*n+i];
+			for (k = 0; k < j; k++)
+			{
+				s_re -= l_re[i*n+k] * l_re[j*n+k] + l_im[i*n+k] * l_im[j*n+k];
+				s_im -= l_im[i*n+k] * l_re[j*n+k] - l_re[i*n+k] * l_im[j*n+k];
+			}
+			l_re[i*n+j] = s_re * inv;
+			l_im[i*n+j] = s_im * inv;
+		}
+	}
+
+	return 0;
+}
+
+/* R^-1 = L^-H * L^-1 */
+static void dios_ssp_hermitian_cholesky_inv(objHERMinv *herminv, float *rinv_re, float *rinv_im)
+{
+	int n = herminv->dim;
+	double *l_re = herminv->l_re;
+	double *l_im = herminv->l_im;
+	double *li_re = herminv->li_re;
+	double *li_im = herminv->li_im;
+	int i, j, k;
+	double s_re, s_im;
+
+	for (j = 0; j < n; j++)
+	{
+		li_re[j*n+j] = 1.0 / l_re[j*n+j];
+		li_im[j*n+j] = 0.0;
+		for (i = j + 1; i < n; i++)
+		{
+			s_re = s_im = 0.0;
+			for (k = j; k < i; k++)
+			{
+				s_re += l_re[i*n+k] * li_re[k*n+j] - l_im[i*n+k] * li_im[k*n+j];
+				s_im += l_re[i*n+k] * li_im[k*n+j] + l_im[i*n+k] * li_re[k*n+j];
+			}
+			li_re[i*n+j] = -s_re / l_re[i*n+i];
+			li_im[i*n+j] = -s_im / l_re[i*n+i];
+		}
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		for (j = i; j < n; j++)
+		{
+			s_re = s_im = 0.0;
+			for (k = j; k < n; k++)
+			{
+				s_re += li_re[k*n+i] * li_re[k*n+j] + li_im[k*n+i] * li_im[k*n+j];
+				s_im += li_re[k*n+i] * li_im[k*n+j] - li_im[k*n+i] * li_re[k*n+j];
+			}
+			rinv_re[i*n+j] = (float)s_re;
+			rinv_re[j*n+i] = (float)s_re;
+			if (rinv_im != NULL)
+			{
+				rinv_im[i*n+j] = (i == j) ? 0.0f : (float)s_im;
+				rinv_im[j*n+i] = (i == j) ? 0.0f : -(float)s_im;
+			}
+		}
+	}
+}
+
+/* factorize R, retried with increasing diagonal loading when R is not positive 
+   definite, the factor is left in herminv->l_re/l_im */
+static int dios_ssp_hermitian_factor(objHERMinv *herminv, const float *r_re, const float *r_im)
+{
+	int n = herminv->dim;
+	int i, retry;
+	int status = -1;
+	double mean_diag, load, tol;
+
+	mean_diag = 0.0;
+	for (i = 0; i < n; i++)
+	{
+		mean_diag += r_re[i*n+i];
+	}
+	mean_diag /= n;
+
+	if (mean_diag > 0.0 && mean_diag < HUGE_VAL)
+	{
+		tol = mean_diag * n * DBL_EPSILON;
+		load = herminv->loading * mean_diag;
+		status = dios_ssp_hermitian_cholesky(herminv, r_re, r_im, load, tol);
+		for (retry = 0; retry < HERM_INV_MAX_RETRY && status != 0; retry++)
+		{
+			load = (load < HERM_INV_MIN_LOADING * mean_diag) ? HERM_INV_MIN_LOADING * mean_diag : load * 10.0;
+			status = dios_ssp_hermitian_cholesky(herminv, r_re, r_im, load, tol);
+		}
+	}
+
+	return status;
+}
+
+int dios_ssp_hermitian_inv_process(void *herm_inv, const float *r_re, const float *r_im, 
+	float *rinv_re, float *rinv_im, int num)
+{
+	if (herm_inv == NULL)
+	{
+		return -1;
+	}
+	objHERMinv *herminv = (objHERMinv*)herm_inv;
+	int n = herminv->dim;
+	int size = n * n;
+	int ret = 0;
+	int b;
+
+	for (b = 0; b < num; b++)
+	{
+		const float *br_re = r_re + b * size;
+		const float *br_im = (r_im == NULL) ? NULL : r_im + b * size;
+		float *binv_re = rinv_re + b * size;
+		float *binv_im = (rinv_im == NULL) ? NULL : rinv_im + b * size;
+
+		if (dios_ssp_hermitian_factor(herminv, br_re, br_im) == 0)
+		{
+			dios_ssp_hermitian_cholesky_inv(herminv, binv_re, binv_im);
+		}
+		else
+		{
+			memset(binv_re, 0, sizeof(float) * size);
+			if (binv_im != NULL)
+			{
+				memset(binv_im, 0, sizeof(float) * size);
+			}
+			ret = -1;
+		}
+	}
+
+	return ret;
+}
+
+int dios_ssp_hermitian_chol_process(void *herm_inv, const float *r_re, const float *r_im, 
+	float *l_re, float *l_im, int num)
+{
+	if (herm_inv == NULL)
+	{
+		return -1;
+	}
+	objHERMinv *herminv = (objHERMinv*)herm_inv;
+	int n = herminv->dim;
+	int size = n * n;
+	int ret = 0;
+	int b, i, j;
+
+	for (b = 0; b < num; b++)
+	{
+		const float *br_im = (r_im == NULL) ? NULL : r_im + b * size;
+		float *bl_re = l_re + b * size;
+		float *bl_im = l_im + b * size;
+
+		memset(bl_re, 0, sizeof(float) * size);
+		memset(bl_im, 0, sizeof(float) * size);
+		if (dios_ssp_hermitian_factor(herminv, r_re + b * size, br_im) == 0)
+		{
+			for (i = 0; i < n; i++)
+			{
+				for (j = 0; j <= i; j++)
+				{
+					bl_re[i*n+j] = (float)herminv->l_re[i*n+j];
+					bl_im[i*n+j] = (float)herminv->l_im[i*n+j];
+				}
+			}
+		}
+		else
+		{
+			ret = -1;
+		}
+	}
+
+	return ret;
+}
+
+int dios_ssp_hermitian_chol_update(void *herm_inv, float *l_re, float *l_im, float alpha, 
+	float beta, const float *x_re, const float *x_im, int stride)
+{
+	if (herm_inv == NULL || !(alpha > 0.0f) || beta < 0.0f)
+	{
+		return -1;
+	}
+	objHERMinv *herminv = (objHERMinv*)herm_inv;
+	int n = herminv->dim;
+	float v_re[HERM_INV_MAX_DIM];
+	float v_im[HERM_INV_MAX_DIM];
+	float sa = sqrtf(alpha);
+	float sb = sqrtf(beta);
+	float d, r, c, inv, s_re, s_im, a_re, a_im;
+	int i, k;
+
+	if (!(l_re[0] > 0.0f))
+	{
+		return -1;
+	}
+	for (i = 0; i < n; i++)
+	{
+		v_re[i] = sb * x_re[i*stride];
+		v_im[i] = sb * x_im[i*stride];
+	}
+
+	/* a sequence of givens rotations of [sqrt(alpha)*L, sqrt(beta)*x], column k
+	   of L against v, zeroes v and keeps L lower triangular with real diagonal */
+	for (k = 0; k < n; k++)
+	{
+		d = sa * l_re[k*n+k];
+		r = sqrtf(d * d + v_re[k] * v_re[k] + v_im[k] * v_im[k]);
+		if (!(r > 0.0f) || !(r < FLT_MAX))
+		{
+			return -1;
+		}
+		inv = 1.0f / r;
+		c = d * inv;
+		s_re = v_re[k] * inv;
+		s_im = v_im[k] * inv;
+		l_re[k*n+k] = r;
+		for (i = k + 1; i < n; i++)
+		{
+			a_re = sa * l_re[i*n+k];
+			a_im = sa * l_im[i*n+k];
+			/* l = c*l + conj(s)*v, v = c*v - s*l */
+			l_re[i*n+k] = c * a_re + s_re * v_re[i] + s_im * v_im[i];
+			l_im[i*n+k] = c * a_im + s_re * v_im[i] - s_im * v_re[i];
+			v_re[i] = c * v_re[i] - (s_re * a_re - s_im * a_im);
+			v_im[i] = c * v_im[i] - (s_re * a_im + s_im * a_re);
+		}
+	}
 
 	return 0;
 }
 
+int dios_ssp_hermitian_chol_solve(void *herm_inv, const float *l_re, const float *l_im, 
+	const float *b_re, const float *b_im, float *x_re, float *x_im, int num)
+{
+	if (herm_inv == NULL)
+	{
+		return -1;
+	}
+	objHERMinv *herminv = (objHERMinv*)herm_inv;
+	int n = herminv->dim;
+	int size = n * n;
+	float d_inv[HERM_INV_MAX_DIM];
+	int ret = 0;
+	int b, i, k;
+	float s_re, s_im;
+
+	for (b = 0; b < num; b++)
+	{
+		const float *bl_re = l_re + b * size;
+		const float *bl_im = l_im + b * size;
+		const float *bb_re = b_re + b * n;
+		const float *bb_im = b_im + b * n;
+		float *bx_re = x_re + b * n;
+		float *bx_im = x_im + b * n;
+
+		if (!(bl_re[0] > 0.0f))
+		{
+			memset(bx_re, 0, sizeof(float) * n);
+			memset(bx_im, 0, sizeof(float) * n);
+			ret = -1;
+			continue;
+		}
+
+		/* L*y = b, y is kept in x */
+		for (i = 0; i < n; i++)
+		{
+			d_inv[i] = 1.0f / bl_re[i*n+i];
+			s_re = bb_re[i];
+			s_im = bb_im[i];
+			for (k = 0; k < i; k++)
+			{
+				s_re -= bl_re[i*n+k] * bx_re[k] - bl_im[i*n+k] * bx_im[k];
+				s_im -= bl_re[i*n+k] * bx_im[k] + bl_im[i*n+k] * bx_re[k];
+			}
+			bx_re[i] = s_re * d_inv[i];
+			bx_im[i] = s_im * d_inv[i];
+		}
+
+		/* L^H*x = y */
+		for (i = n - 1; i >= 0; i--)
+		{
+			s_re = bx_re[i];
+			s_im = bx_im[i];
+			for (k = i + 1; k < n; k++)
+			{
+				s_re -= bl_re[k*n+i] * bx_re[k] + bl_im[k*n+i] * bx_im[k];
+				s_im -= bl_re[k*n+i] * bx_im[k] - bl_im[k*n+i] * bx_re[k];
+			}
+			bx_re[i] = s_re * d_inv[i];
+			bx_im[i] = s_im * d_inv[i];
+		}
+	}
+
+	return ret;
+}
+
+int dios_ssp_hermitian_inv_delete(void *herm_inv)
+{
+	if (herm_inv == NULL)
+	{
+		return -1;
+	}
+	objHERMinv *herminv = (objHERMinv*)herm_inv;
+
+	dios_ssp_share_free(herminv->l_re);
+	dios_ssp_share_free(herminv->l_im);
+	dios_ssp_share_free(herminv->li_re);
+	dios_ssp_share_free(herminv->li_im);
+	dios_ssp_share_free(herminv);
+
+	return 0;
+}
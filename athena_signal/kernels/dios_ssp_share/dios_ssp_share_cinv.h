@@ -19,6 +19,13 @@ limitations under the License.
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+
+#define HERM_INV_MAX_DIM		(16)
+#define HERM_INV_MIN_LOADING	(1e-6f)
+#define HERM_INV_MAX_RETRY		(4)
 
 typedef struct
 {
@@ -27,11 +34,122 @@ typedef struct
 	float **ai;
 	float **mat_temp;
 	float **mat_temp2;
+	int *is;
+	int *js;
 }objMATRIXinv;
 
+typedef struct
+{
+	int dim;
+	float loading;
+	double *l_re;
+	double *l_im;
+	double *li_re;
+	double *li_im;
+}objHERMinv;
+
 void *dios_ssp_matrix_inv_init(int Rdim);
 int dios_ssp_matrix_inv_process(void *matrix_inv, float *R, float *Rinv);
 int dios_ssp_matrix_inv_delete(void *matrix_inv);
 
+/**********************************************************************************
+Function:      // dios_ssp_hermitian_inv_init
+Description:   // init batched inverse of hermitian positive definite matrices
+Input:         // dim: matrix dimension, 1 ~ HERM_INV_MAX_DIM
+                  loading: diagonal loading relative to the mean of the diagonal,
+                  0 means no loading unless the cholesky factorization breaks down
+Output:        // none
+Return:        // success: return hermitian inverse pointer
+                  failure: return NULL
+**********************************************************************************/
+void *dios_ssp_hermitian_inv_init(int dim, float loading);
+
+/**********************************************************************************
+Function:      // dios_ssp_hermitian_inv_process
+Description:   // invert num hermitian matrices by cholesky factorization R = L*L^H,
+                  matrix b is stored row-major at offset b*dim*dim in split
+                  real/imag arrays, only the upper triangle (j >= i) of R is read
+                  and the full inverse is written. a matrix that is not positive
+                  definite is retried with increasing diagonal loading, starting
+                  at HERM_INV_MIN_LOADING of the mean diagonal. no memory is
+                  allocated
+Input:         // herm_inv: hermitian inverse pointer
+                  r_re: real part of the matrices
+                  r_im: imag part of the matrices, NULL for real symmetric ones
+                  num: number of matrices
+Output:        // rinv_re: real part of the inverse matrices
+                  rinv_im: imag part of the inverse matrices, may be NULL
+Return:        // success: return 0
+                  failure: return -1 if any matrix could not be inverted, its
+                  inverse is set to zero and the other matrices are still done
+**********************************************************************************/
+int dios_ssp_hermitian_inv_process(void *herm_inv, const float *r_re, const float *r_im, 
+	float *rinv_re, float *rinv_im, int num);
+
+/**********************************************************************************
+Function:      // dios_ssp_hermitian_chol_process
+Description:   // cholesky factorization R = L*L^H of num hermitian matrices, stored
+                  and loaded like dios_ssp_hermitian_inv_process. L is written
+                  row-major with its strict upper triangle set to zero
+Input:         // herm_inv: hermitian inverse pointer
+                  r_re: real part of the matrices
+                  r_im: imag part of the matrices, NULL for real symmetric ones
+                  num: number of matrices
+Output:        // l_re: real part of the factors
+                  l_im: imag part of the factors
+Return:        // success: return 0
+                  failure: return -1 if any matrix could not be factorized, its
+                  factor is set to zero and the other matrices are still done
+**********************************************************************************/
+int dios_ssp_hermitian_chol_process(void *herm_inv, const float *r_re, const float *r_im, 
+	float *l_re, float *l_im, int num);
+
+/**********************************************************************************
+Function:      // dios_ssp_hermitian_chol_update
+Description:   // rank-1 update of one cholesky factor in place, L*L^H becomes
+                  alpha*L*L^H + beta*x*x^H, O(dim^2) instead of a new factorization
+Input:         // herm_inv: hermitian inverse pointer
+                  l_re: real part of the factor
+                  l_im: imag part of the factor
+                  alpha: scale of the old matrix, > 0
+                  beta: weight of the rank-1 term, >= 0
+                  x_re: real part of the update vector
+                  x_im: imag part of the update vector
+                  stride: distance between two elements of x
+Output:        // l_re, l_im: updated factor
+Return:        // success: return 0
+                  failure: return -1, the factor is no longer valid
+**********************************************************************************/
+int dios_ssp_hermitian_chol_update(void *herm_inv, float *l_re, float *l_im, float alpha, 
+	float beta, const float *x_re, const float *x_im, int stride);
+
+/**********************************************************************************
+Function:      // dios_ssp_hermitian_chol_solve
+Description:   // solve L*L^H*x = b for num factors by forward and back substitution,
+                  the vector of matrix b is stored at offset b*dim
+Input:         // herm_inv: hermitian inverse pointer
+                  l_re: real part of the factors
+                  l_im: imag part of the factors
+                  b_re: real part of the right hand sides
+                  b_im: imag part of the right hand sides
+                  num: number of factors
+Output:        // x_re: real part of the solutions
+                  x_im: imag part of the solutions
+Return:        // success: return 0
+                  failure: return -1 if any factor is zero, its solution is set
+                  to zero and the other solutions are still done
+**********************************************************************************/
+int dios_ssp_hermitian_chol_solve(void *herm_inv, const float *l_re, const float *l_im, 
+	const float *b_re, const float *b_im, float *x_re, float *x_im, int num);
+
+/**********************************************************************************
+Function:      // dios_ssp_hermitian_inv_delete
+Description:   // free batched hermitian inverse
+Input:         // herm_inv: hermitian inverse pointer
+Output:        // none
+Return:        // success: return 0, failure: return -1
+**********************************************************************************/
+int dios_ssp_hermitian_inv_delete(void *herm_inv);
+
 #endif /* _DIOS_SSP_SHARE_CINV_H_ */
 
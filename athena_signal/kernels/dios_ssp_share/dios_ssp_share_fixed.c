@@ -0,0 +1,157 @@
+/* Copyright (C) 2017 Beijing Didi Infinity Technology and Development Co.,Ltd.
+All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Description: Basic operation for the fixed-point build: headroom and block
+floating point conversion.
+==============================================================================*/
+
+#include "dios_ssp_share_fixed.h"
+
+/* number of significant bits of x, 0 for x = 0 */
+static int fixed_bit_len(unsigned long long x)
+{
+#if defined(__GNUC__)
+	return x ? 64 - __builtin_clzll(x) : 0;
+#else
+	int bits = 0;
+	while (x >> bits)
+	{
+		bits++;
+	}
+	return bits;
+#endif
+}
+
+int dios_ssp_share_fixed_headroom(const int *x, int len)
+{
+	unsigned int acc = 0;
+	int i;
+
+	/* the OR of the magnitudes has the same bit length as the largest one */
+	for (i = 0; i < len; i++)
+	{
+		acc |= x[i] < 0 ? 0u - (unsigned int)x[i] : (unsigned int)x[i];
+	}
+
+	return 31 - fixed_bit_len(acc);
+}
+
+int dios_ssp_share_fixed_bits64(const long long *x, int len)
+{
+	unsigned long long acc = 0;
+	int i;
+
+	for (i = 0; i < len; i++)
+	{
+		acc |= x[i] < 0 ? 0ull - (unsigned long long)x[i] : (unsigned long long)x[i];
+	}
+
+	return fixed_bit_len(acc);
+}
+
+void dios_ssp_share_fixed_shift(int *x, int len, int shift)
+{
+	int i;
+	long long v;
+	long long round;
+
+	if (shift > 0)
+	{
+		shift = shift > 32 ? 32 : shift;
+		for (i = 0; i < len; i++)
+		{
+			v = (long long)x[i] * (1LL << shift);
+			x[i] = FIX_SAT32(v);
+		}
+	}
+	else if (shift < 0)
+	{
+		shift = -shift;
+		if (shift > 32)
+		{
+			memset(x, 0, len * sizeof(int));
+			return;
+		}
+		round = 1LL << (shift - 1);
+		for (i = 0; i < len; i++)
+		{
+			x[i] = (int)(((long long)x[i] + round) >> shift);
+		}
+	}
+}
+
+void dios_ssp_share_fixed_guard(int *x, int len, int bits, int *exp)
+{
+	int headroom = dios_ssp_share_fixed_headroom(x, len);
+
+	if (headroom < bits)
+	{
+		dios_ssp_share_fixed_shift(x, len, headroom - bits);
+		*exp += bits - headroom;
+	}
+}
+
+int dios_ssp_share_fixed_from_float(const float *in, int *out, int len, int headroom)
+{
+	int i;
+	int e = 0;
+	int exp;
+	float peak = 0.0f;
+	double scale;
+	long long v;
+
+	for (i = 0; i < len; i++)
+	{
+		if (fabsf(in[i]) > peak)
+		{
+			peak = fabsf(in[i]);
+		}
+	}
+	if (peak == 0.0f)
+	{
+		memset(out, 0, len * sizeof(int));
+		return 0;
+	}
+	if (isinf(peak))
+	{
+		e = 129;
+	}
+	else
+	{
+		frexpf(peak, &e);
+	}
+
+	/* peak < 2^e, so peak * 2^-exp < 2^(31 - headroom) before rounding */
+	exp = e - (31 - headroom);
+	scale = ldexp(1.0, -exp);
+	for (i = 0; i < len; i++)
+	{
+		v = llrint(in[i] * scale);
+		out[i] = FIX_SAT32(v);
+	}
+
+	return exp;
+}
+
+void dios_ssp_share_fixed_to_float(const int *in, int exp, float *out, int len)
+{
+	int i;
+	double scale = ldexp(1.0, exp);
+
+	for (i = 0; i < len; i++)
+	{
+		out[i] = (float)(in[i] * scale);
+	}
+}
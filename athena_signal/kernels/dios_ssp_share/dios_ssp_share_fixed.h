@@ -0,0 +1,122 @@
+/* Copyright (C) 2017 Beijing Didi Infinity Technology and Development Co.,Ltd.
+All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Description: Basic operation for the fixed-point build: Q15/Q31 multiplies
+and block floating point. A block is an int32 array sharing one exponent,
+value = x * 2^exp. The headroom of a block is the number of bits every
+element can be shifted left without overflow, a stage that can grow its input
+by up to 2^g first makes sure the block has g bits of headroom.
+==============================================================================*/
+
+#ifndef _DIOS_SSP_SHARE_FIXED_H_
+#define _DIOS_SSP_SHARE_FIXED_H_
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* 1: the rfft, the subband filterbank, the AEC filters and the NS gain path run
+   in fixed point, 0: everything runs in float */
+#ifndef DIOS_SSP_FIXED_POINT
+#define DIOS_SSP_FIXED_POINT (0)
+#endif
+
+#define FIX_Q15_ONE		(32767)
+#define FIX_Q31_ONE		(2147483647)
+
+/* Q31 * Q31 and Q31 * Q15, rounded to nearest */
+#define FIX_MUL_Q31(a, b)	((int)(((long long)(a) * (b) + 0x40000000LL) >> 31))
+#define FIX_MUL_Q15(a, b)	((int)(((long long)(a) * (b) + 0x4000) >> 15))
+
+/* real and imaginary part of the complex product (ar + i*ai) * (br + i*bi),
+   with b in Q31, rounded once */
+#define FIX_CMUL_RE_Q31(ar, ai, br, bi)	((int)(((long long)(ar) * (br) - (long long)(ai) * (bi) + 0x40000000LL) >> 31))
+#define FIX_CMUL_IM_Q31(ar, ai, br, bi)	((int)(((long long)(ar) * (bi) + (long long)(ai) * (br) + 0x40000000LL) >> 31))
+
+/* saturate a 64-bit value to int32 */
+#define FIX_SAT32(x)	((x) > 2147483647LL ? 2147483647 : ((x) < -2147483647LL - 1 ? (int)(-2147483647LL - 1) : (int)(x)))
+
+/**********************************************************************************
+Function:      // dios_ssp_share_fixed_headroom
+Description:   // headroom of a block, every element satisfies |x| < 2^(31 - headroom)
+Input:         // x: int32 block
+                  len: number of elements
+Output:        // none
+Return:        // headroom in bits, 31 for an all zero block, -1 if an element
+                  is -2^31
+**********************************************************************************/
+int dios_ssp_share_fixed_headroom(const int *x, int len);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_fixed_bits64
+Description:   // number of bits the largest element of an int64 block needs
+                  besides the sign, i.e. every element satisfies |x| < 2^bits
+Input:         // x: int64 block
+                  len: number of elements
+Output:        // none
+Return:        // bits, 0 for an all zero block
+**********************************************************************************/
+int dios_ssp_share_fixed_bits64(const long long *x, int len);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_fixed_shift
+Description:   // x[i] = x[i] * 2^shift, a right shift rounds to nearest and a
+                  left shift saturates
+Input:         // x: int32 block
+                  len: number of elements
+                  shift: bits to shift left, negative to shift right
+Output:        // x: shifted block
+Return:        // none
+**********************************************************************************/
+void dios_ssp_share_fixed_shift(int *x, int len, int shift);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_fixed_guard
+Description:   // make sure a block has at least bits of headroom, shifting it
+                  right if it has less
+Input:         // x: int32 block
+                  len: number of elements
+                  bits: headroom the next stage needs
+                  exp: exponent of the block
+Output:        // x: block with enough headroom
+                  exp: exponent, increased by the right shift
+Return:        // none
+**********************************************************************************/
+void dios_ssp_share_fixed_guard(int *x, int len, int bits, int *exp);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_fixed_from_float
+Description:   // convert floats to a block, the exponent is chosen so that the
+                  largest element just fits |out[i]| <= 2^(31 - headroom)
+Input:         // in: float samples
+                  len: number of elements
+                  headroom: headroom to leave, 0 ~ 30
+Output:        // out: int32 block
+Return:        // exponent of the block, in[i] = out[i] * 2^exp
+**********************************************************************************/
+int dios_ssp_share_fixed_from_float(const float *in, int *out, int len, int headroom);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_fixed_to_float
+Description:   // out[i] = in[i] * 2^exp
+Input:         // in: int32 block
+                  exp: exponent of the block
+                  len: number of elements
+Output:        // out: float samples, it may be the same buffer as in
+Return:        // none
+**********************************************************************************/
+void dios_ssp_share_fixed_to_float(const int *in, int exp, float *out, int len);
+
+#endif /* _DIOS_SSP_SHARE_FIXED_H_ */
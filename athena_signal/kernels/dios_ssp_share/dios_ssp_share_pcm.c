@@ -0,0 +1,316 @@
+/* Copyright (C) 2017 Beijing Didi Infinity Technology and Development Co.,Ltd.
+All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Description: Contiguous conversions are dispatched at first use to SSE2/AVX2
+kernels when the CPU supports them, strided input is gathered by the scalar
+kernel. The SIMD kernels clip, draw the dither and round exactly like the
+scalar ones, so the output does not depend on the CPU.
+==============================================================================*/
+
+#include <math.h>
+#include "dios_ssp_share_pcm.h"
+#include "dios_ssp_share_workpool.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PCM_X86_SIMD
+#include <immintrin.h>
+#endif
+
+#define PCM_MIN				(-32768.0f)
+#define PCM_MAX				(32767.0f)
+#define PCM_DITHER_SCALE	(1.0f / 16777216.0f)	/* 2^-24, one 24-bit draw to [0, 1) */
+
+typedef void (*pcm_to_float_fn)(const short *in, float *out, int len);
+typedef void (*pcm_from_float_fn)(const float *in, short *out, int len, unsigned int *lane);
+
+static pcm_to_float_fn pcm_to_float = NULL;
+static pcm_from_float_fn pcm_from_float = NULL;
+static pcm_from_float_fn pcm_from_float_dither = NULL;
+#ifndef DIOS_SSP_NO_THREADS
+static pthread_once_t pcm_kernel_once = PTHREAD_ONCE_INIT;
+#endif
+
+static unsigned int pcm_xorshift(unsigned int x)
+{
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return x;
+}
+
+/* difference of two uniform draws, triangular in (-1, 1) LSB. both draws
+   have 24 bits, so the difference is exact in float */
+static float pcm_dither_draw(unsigned int *lane)
+{
+	unsigned int a = pcm_xorshift(*lane);
+	unsigned int b = pcm_xorshift(a);
+
+	*lane = b;
+	return (float)(int)(a >> 8) * PCM_DITHER_SCALE - (float)(int)(b >> 8) * PCM_DITHER_SCALE;
+}
+
+/* same operand order as maxps/minps, a NaN input ends up at PCM_MIN */
+static float pcm_clip(float x)
+{
+	x = (x > PCM_MIN) ? x : PCM_MIN;
+	x = (x < PCM_MAX) ? x : PCM_MAX;
+	return x;
+}
+
+static void pcm_to_float_scalar(const short *in, float *out, int len)
+{
+	int i;
+
+	for (i = 0; i < len; i++)
+	{
+		out[i] = (float)in[i];
+	}
+}
+
+static void pcm_from_float_scalar(const float *in, short *out, int len, unsigned int *lane)
+{
+	int i;
+
+	for (i = 0; i < len; i++)
+	{
+		out[i] = (short)(int)pcm_clip(in[i]);
+	}
+}
+
+static void pcm_from_float_dither_scalar(const float *in, short *out, int len, unsigned int *lane)
+{
+	int i;
+
+	for (i = 0; i < len; i++)
+	{
+		out[i] = (short)lrintf(pcm_clip(in[i] + pcm_dither_draw(&lane[i % SHARE_PCM_DITHER_LANES])));
+	}
+}
+
+#ifdef PCM_X86_SIMD
+/* the SIMD kernels do 8 samples per step, the rest goes to the scalar kernels.
+   8 is a multiple of the lane number, so the tail starts at lane 0 */
+__attribute__((target("sse2")))
+static void pcm_to_float_sse2(const short *in, float *out, int len)
+{
+	int i;
+	__m128i x;
+
+	for (i = 0; i + 8 <= len; i += 8)
+	{
+		x = _mm_loadu_si128((const __m128i*)(in + i));
+		_mm_storeu_ps(out + i, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16)));
+		_mm_storeu_ps(out + i + 4, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16)));
+	}
+	pcm_to_float_scalar(in + i, out + i, len - i);
+}
+
+__attribute__((target("sse2")))
+static void pcm_from_float_sse2(const float *in, short *out, int len, unsigned int *lane)
+{
+	int i;
+	__m128 lo = _mm_set1_ps(PCM_MIN);
+	__m128 hi = _mm_set1_ps(PCM_MAX);
+	__m128 a, b;
+
+	for (i = 0; i + 8 <= len; i += 8)
+	{
+		a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), lo), hi);
+		b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), lo), hi);
+		_mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b)));
+	}
+	pcm_from_float_scalar(in + i, out + i, len - i, lane);
+}
+
+__attribute__((target("sse2")))
+static __m128 pcm_dither_draw_sse2(__m128i *s)
+{
+	__m128i a = *s;
+	__m128i b;
+	__m128 scale = _mm_set1_ps(PCM_DITHER_SCALE);
+
+	a = _mm_xor_si128(a, _mm_slli_epi32(a, 13));
+	a = _mm_xor_si128(a, _mm_srli_epi32(a, 17));
+	a = _mm_xor_si128(a, _mm_slli_epi32(a, 5));
+	b = _mm_xor_si128(a, _mm_slli_epi32(a, 13));
+	b = _mm_xor_si128(b, _mm_srli_epi32(b, 17));
+	b = _mm_xor_si128(b, _mm_slli_epi32(b, 5));
+	*s = b;
+	return _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(a, 8)), scale),
+		_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(b, 8)), scale));
+}
+
+__attribute__((target("sse2")))
+static void pcm_from_float_dither_sse2(const float *in, short *out, int len, unsigned int *lane)
+{
+	int i;
+	__m128 lo = _mm_set1_ps(PCM_MIN);
+	__m128 hi = _mm_set1_ps(PCM_MAX);
+	__m128i s0 = _mm_loadu_si128((const __m128i*)lane);
+	__m128i s1 = _mm_loadu_si128((const __m128i*)(lane + 4));
+	__m128 a, b;
+
+	for (i = 0; i + 8 <= len; i += 8)
+	{
+		a = _mm_add_ps(_mm_loadu_ps(in + i), pcm_dither_draw_sse2(&s0));
+		b = _mm_add_ps(_mm_loadu_ps(in + i + 4), pcm_dither_draw_sse2(&s1));
+		a = _mm_min_ps(_mm_max_ps(a, lo), hi);
+		b = _mm_min_ps(_mm_max_ps(b, lo), hi);
+		_mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b)));
+	}
+	_mm_storeu_si128((__m128i*)lane, s0);
+	_mm_storeu_si128((__m128i*)(lane + 4), s1);
+	pcm_from_float_dither_scalar(in + i, out + i, len - i, lane);
+}
+
+__attribute__((target("avx2")))
+static void pcm_to_float_avx2(const short *in, float *out, int len)
+{
+	int i;
+
+	for (i = 0; i + 8 <= len; i += 8)
+	{
+		_mm256_storeu_ps(out + i, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in + i)))));
+	}
+	pcm_to_float_scalar(in + i, out + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static void pcm_from_float_avx2(const float *in, short *out, int len, unsigned int *lane)
+{
+	int i;
+	__m256 lo = _mm256_set1_ps(PCM_MIN);
+	__m256 hi = _mm256_set1_ps(PCM_MAX);
+	__m256i x;
+
+	for (i = 0; i + 8 <= len; i += 8)
+	{
+		x = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + i), lo), hi));
+		_mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1)));
+	}
+	pcm_from_float_scalar(in + i, out + i, len - i, lane);
+}
+
+__attribute__((target("avx2")))
+static void pcm_from_float_dither_avx2(const float *in, short *out, int len, unsigned int *lane)
+{
+	int i;
+	__m256 lo = _mm256_set1_ps(PCM_MIN);
+	__m256 hi = _mm256_set1_ps(PCM_MAX);
+	__m256 scale = _mm256_set1_ps(PCM_DITHER_SCALE);
+	__m256i s = _mm256_loadu_si256((const __m256i*)lane);
+	__m256i a, x;
+	__m256 d;
+
+	for (i = 0; i + 8 <= len; i += 8)
+	{
+		a = _mm256_xor_si256(s, _mm256_slli_epi32(s, 13));
+		a = _mm256_xor_si256(a, _mm256_srli_epi32(a, 17));
+		a = _mm256_xor_si256(a, _mm256_slli_epi32(a, 5));
+		s = _mm256_xor_si256(a, _mm256_slli_epi32(a, 13));
+		s = _mm256_xor_si256(s, _mm256_srli_epi32(s, 17));
+		s = _mm256_xor_si256(s, _mm256_slli_epi32(s, 5));
+		d = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(a, 8)), scale),
+			_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(s, 8)), scale));
+		x = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(_mm256_add_ps(_mm256_loadu_ps(in + i), d), lo), hi));
+		_mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1)));
+	}
+	_mm256_storeu_si256((__m256i*)lane, s);
+	pcm_from_float_dither_scalar(in + i, out + i, len - i, lane);
+}
+#endif
+
+static void pcm_select_kernel(void)
+{
+	pcm_to_float_fn to_float = pcm_to_float_scalar;
+	pcm_from_float_fn from_float = pcm_from_float_scalar;
+	pcm_from_float_fn from_float_dither = pcm_from_float_dither_scalar;
+
+#ifdef PCM_X86_SIMD
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+	{
+		to_float = pcm_to_float_avx2;
+		from_float = pcm_from_float_avx2;
+		from_float_dither = pcm_from_float_dither_avx2;
+	}
+	else if (__builtin_cpu_supports("sse2"))
+	{
+		to_float = pcm_to_float_sse2;
+		from_float = pcm_from_float_sse2;
+		from_float_dither = pcm_from_float_dither_sse2;
+	}
+#endif
+	pcm_to_float = to_float;
+	pcm_from_float = from_float;
+	pcm_from_float_dither = from_float_dither;
+}
+
+/* selects the kernels once, also when several threads convert concurrently */
+static void pcm_kernel_init(void)
+{
+#ifndef DIOS_SSP_NO_THREADS
+	pthread_once(&pcm_kernel_once, pcm_select_kernel);
+#else
+	if (pcm_to_float == NULL)
+	{
+		pcm_select_kernel();
+	}
+#endif
+}
+
+void dios_ssp_share_pcm_dither_init(objSharePcmDither *dither, unsigned int seed)
+{
+	int i;
+
+	/* xorshift32 must not start from 0 */
+	for (i = 0; i < SHARE_PCM_DITHER_LANES; i++)
+	{
+		dither->state[i] = pcm_xorshift(seed + 0x9e3779b9u * (unsigned int)(i + 1));
+		if (dither->state[i] == 0)
+		{
+			dither->state[i] = 0x9e3779b9u;
+		}
+	}
+}
+
+void dios_ssp_share_pcm_to_float(const short *in, int step, float *out, int len)
+{
+	int i;
+
+	if (step != 1)
+	{
+		for (i = 0; i < len; i++)
+		{
+			out[i] = (float)in[i * step];
+		}
+		return;
+	}
+	pcm_kernel_init();
+	pcm_to_float(in, out, len);
+}
+
+void dios_ssp_share_pcm_from_float(const float *in, short *out, int len, objSharePcmDither *dither)
+{
+	pcm_kernel_init();
+	if (dither == NULL)
+	{
+		pcm_from_float(in, out, len, NULL);
+	}
+	else
+	{
+		pcm_from_float_dither(in, out, len, dither->state);
+	}
+}
@@ -0,0 +1,72 @@
+/* Copyright (C) 2017 Beijing Didi Infinity Technology and Development Co.,Ltd.
+All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Description: Conversion between the int16 samples at the boundaries of the
+pipeline and the float samples the modules work on. int16 to float is exact.
+float to int16 saturates at the int16 range, so loud output clips instead of
+wrapping around. Without dither it truncates toward zero like a plain cast,
+with TPDF dither of +/-1 LSB it rounds to nearest.
+==============================================================================*/
+
+#ifndef _DIOS_SSP_SHARE_PCM_H_
+#define _DIOS_SSP_SHARE_PCM_H_
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SHARE_PCM_DITHER_LANES	(8)
+
+/* one xorshift32 generator per lane, sample i of a call draws from lane
+   i % SHARE_PCM_DITHER_LANES, so all kernels give the same noise */
+typedef struct
+{
+	unsigned int state[SHARE_PCM_DITHER_LANES];
+}objSharePcmDither;
+
+/**********************************************************************************
+Function:      // dios_ssp_share_pcm_dither_init
+Description:   // seed a dither generator
+Input:         // dither: dither generator
+                  seed: any value, the same seed gives the same noise
+Output:        // none
+Return:        // none
+**********************************************************************************/
+void dios_ssp_share_pcm_dither_init(objSharePcmDither *dither, unsigned int seed);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_pcm_to_float
+Description:   // out[i] = in[i * step], i = 0 ~ len-1
+Input:         // in: int16 samples
+                  step: distance between two samples of in, 1 for one channel
+                        and the channel number for interleaved data
+                  len: number of samples
+Output:        // out: float samples
+Return:        // none
+**********************************************************************************/
+void dios_ssp_share_pcm_to_float(const short *in, int step, float *out, int len);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_pcm_from_float
+Description:   // out[i] = in[i] clipped to -32768 ~ 32767, truncated toward zero,
+                  or with dither added and rounded to nearest
+Input:         // in: float samples
+                  len: number of samples
+                  dither: dither generator, NULL for no dither
+Output:        // out: int16 samples
+Return:        // none
+**********************************************************************************/
+void dios_ssp_share_pcm_from_float(const float *in, short *out, int len, objSharePcmDither *dither);
+
+#endif /* _DIOS_SSP_SHARE_PCM_H_ */
@@ -0,0 +1,132 @@
+/* Copyright (C) 2017 Beijing Didi Infinity Technology and Development Co.,Ltd.
+All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Description: Per-stage latency counters, see dios_ssp_share_profile.h. The
+histogram bin of a value v is its exponent and the PROFILE_SUB_BITS bits
+below the leading one, so recording a time is a few integer operations.
+==============================================================================*/
+
+#include "dios_ssp_share_profile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+long long dios_ssp_share_profile_now(void)
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq, cnt;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&cnt);
+	return (long long)((double)cnt.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+#endif
+}
+
+static int profile_bin(long long ns)
+{
+	int e = 0;
+	unsigned long long v = (unsigned long long)ns;
+	if (v < (1u << PROFILE_SUB_BITS))
+	{
+		return (int)v;
+	}
+	while ((v >> e) >= (2u << PROFILE_SUB_BITS))
+	{
+		e++;
+	}
+	return ((e + 1) << PROFILE_SUB_BITS) + (int)((v >> e) & ((1u << PROFILE_SUB_BITS) - 1));
+}
+
+/* largest value falling into bin */
+static long long profile_bin_upper(int bin)
+{
+	int e;
+	long long base;
+	if (bin < (1 << PROFILE_SUB_BITS))
+	{
+		return bin;
+	}
+	e = (bin >> PROFILE_SUB_BITS) - 1;
+	base = (1 << PROFILE_SUB_BITS) + (bin & ((1 << PROFILE_SUB_BITS) - 1));
+	return ((base + 1) << e) - 1;
+}
+
+void dios_ssp_share_profile_reset(objProfileStage *stage)
+{
+	memset(stage, 0, sizeof(objProfileStage));
+}
+
+void dios_ssp_share_profile_add(objProfileStage *stage, long long ns)
+{
+	int bin;
+	if (ns < 0)
+	{
+		ns = 0;
+	}
+	if (stage->count == 0 || ns < stage->min_ns)
+	{
+		stage->min_ns = ns;
+	}
+	if (ns > stage->max_ns)
+	{
+		stage->max_ns = ns;
+	}
+	stage->count++;
+	stage->sum_ns += ns;
+	bin = profile_bin(ns);
+	stage->hist[bin < PROFILE_HIST_SIZE ? bin : PROFILE_HIST_SIZE - 1]++;
+}
+
+long long dios_ssp_share_profile_percentile(const objProfileStage *stage, int pct)
+{
+	unsigned long rank;
+	unsigned long acc = 0;
+	int bin;
+	long long value;
+	if (stage->count == 0)
+	{
+		return 0;
+	}
+	rank = (pct * stage->count + 99) / 100;
+	if (rank < 1)
+	{
+		rank = 1;
+	}
+	for (bin = 0; bin < PROFILE_HIST_SIZE; bin++)
+	{
+		acc += stage->hist[bin];
+		if (acc >= rank)
+		{
+			break;
+		}
+	}
+	value = profile_bin_upper(bin);
+	/* the bin edge can overshoot the extremes that are known exactly */
+	if (value > stage->max_ns)
+	{
+		value = stage->max_ns;
+	}
+	if (value < stage->min_ns)
+	{
+		value = stage->min_ns;
+	}
+	return value;
+}
@@ -0,0 +1,80 @@
+/* Copyright (C) 2017 Beijing Didi Infinity Technology and Development Co.,Ltd.
+All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Description: Per-stage latency counters. Each stage keeps count, min, max, sum
+and a log-scale histogram of its processing time in nanoseconds, so running
+min/mean/max/p99 are available at any time without storing every sample.
+==============================================================================*/
+
+#ifndef _DIOS_SSP_SHARE_PROFILE_H_
+#define _DIOS_SSP_SHARE_PROFILE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 8 bins per power of two, p99 is reported as the upper edge of its bin,
+   i.e. at most 12.5% above the true value */
+#define PROFILE_SUB_BITS		(3)
+#define PROFILE_HIST_SIZE		(512)
+
+typedef struct
+{
+	unsigned long count;
+	long long min_ns;
+	long long max_ns;
+	long long sum_ns;
+	unsigned int hist[PROFILE_HIST_SIZE];
+}objProfileStage;
+
+/**********************************************************************************
+Function:      // dios_ssp_share_profile_now
+Description:   // monotonic clock in nanoseconds
+Input:         // none
+Output:        // none
+Return:        // current time in nanoseconds
+**********************************************************************************/
+long long dios_ssp_share_profile_now(void);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_profile_reset
+Description:   // clear the counters of one stage
+Input:         // stage: stage counters
+Output:        // none
+Return:        // none
+**********************************************************************************/
+void dios_ssp_share_profile_reset(objProfileStage *stage);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_profile_add
+Description:   // record one processing time of a stage
+Input:         // stage: stage counters
+                  ns: elapsed time in nanoseconds
+Output:        // none
+Return:        // none
+**********************************************************************************/
+void dios_ssp_share_profile_add(objProfileStage *stage, long long ns);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_profile_percentile
+Description:   // nearest-rank percentile from the histogram
+Input:         // stage: stage counters
+                  pct: percentile, 1 ~ 100
+Output:        // none
+Return:        // percentile in nanoseconds, 0 if nothing was recorded
+**********************************************************************************/
+long long dios_ssp_share_profile_percentile(const objProfileStage *stage, int pct);
+
+#endif /* _DIOS_SSP_SHARE_PROFILE_H_ */
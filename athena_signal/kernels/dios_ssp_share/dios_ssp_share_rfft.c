@@ -14,49 +14,914 @@ See the License for the specific language governing permissions and
 limitations under the License.
 
 Description: Basic operation: FFT and IFFT.
+A real FFT of length N is computed as a complex FFT of length N/2 on the
+even/odd samples followed by a split step. The complex FFT works on a split
+real/imag layout held in the caller's output buffer (first half real, second
+half imag), uses radix-4 butterflies (plus one radix-2 pass when log2(N/2) is
+odd), and all bit-reversal and twiddle tables are planned in init. N may also
+be 3 * 2^k, in which case the power-of-2 passes run on the three decimated
+sub-sequences side by side and one radix-3 stage combines them. Forward
+transform is decimation-in-time, inverse is decimation-in-frequency, so both
+directions need just one in-place bit-reversal permutation. Butterfly passes
+are dispatched at init to SSE2/AVX2 kernels when the CPU supports them.
+With DIOS_SSP_FIXED_POINT the same plan runs on int32 blocks with Q31
+twiddles, see dios_ssp_share_rfft_process_fix.
 ==============================================================================*/
 
 /* include file */
 #include "dios_ssp_share_rfft.h"
+#include "dios_ssp_share_arena.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RFFT_X86_SIMD
+#include <immintrin.h>
+#endif
+
+#define RFFT_MAX_STAGE (32)
+#define RFFT_PI        (3.14159265358979323846)
+
+typedef void (*rfft_radix4_pass_fn)(float *re, float *im, int n, int h, const float *tw);
 
 typedef struct {
     int fft_len;
-    int Mq_max;
-    float *wr;
-    float *wi;
+    int half_len;       /* complex fft length, fft_len / 2 */
+    int sub_len;        /* power-of-2 part of half_len */
+    int radix3_flag;    /* 1: half_len = 3 * sub_len */
+    /* bitrev, wr, wi, tw and tw3 point into one read-only table, shared
+       through table_pool by all rffts of the same length */
+    void *table_pool;
+    void *table;
+    int *bitrev;        /* bit-reversal permutation of fft_len points */
+    float *tw3;         /* radix-3 twiddles [w1r, w1i, w2r, w2i] of length sub_len, w = exp(-2*pi*i*k/half_len) */
+    float *scratch;     /* fft_len points, the radix-3 permutation is not an involution */
+    float *wr;          /* split step twiddles cos(2*pi*k/fft_len), k = 0 ~ half_len/2 */
+    float *wi;          /* split step twiddles -sin(2*pi*k/fft_len) */
+    float *tw;          /* radix-4 twiddles for every stage, see dios_ssp_share_rfft_init */
+    int tw_len;
+    int radix2_flag;    /* 1: log2(half_len) is odd, one radix-2 pass is needed */
+    int stage_num;      /* radix-4 stage number */
+    int stage_h[RFFT_MAX_STAGE];
+    int stage_tw[RFFT_MAX_STAGE];
+    int bits;           /* log2 of the power-of-2 part of fft_len */
+    rfft_radix4_pass_fn dit_pass;
+    rfft_radix4_pass_fn dif_pass;
+#if DIOS_SSP_FIXED_POINT
+    int *wr_q;          /* Q31 copies of wr, wi, tw and tw3, in the same table */
+    int *wi_q;
+    int *tw_q;
+    int *tw3_q;
+    int *fix_buf;       /* fft_len points, block of the float entry points */
+#endif
 } RFFT_PARAM;
 
-void *dios_ssp_share_rfft_init(int fft_len)
+#if !DIOS_SSP_FIXED_POINT
+/* radix-2 pass with unit twiddles, shared by the first DIT stage and the last DIF stage */
+static void rfft_radix2_pass(float *re, float *im, int n)
 {
-    void *rfft_handle = NULL;
-    rfft_handle = (void*)calloc(1, sizeof(RFFT_PARAM));
-    RFFT_PARAM *rfft_param;
-    rfft_param = (RFFT_PARAM*)rfft_handle;
+    int j;
+    float xr, xi;
+    for (j = 0; j < n; j += 2)
+    {
+        xr = re[j + 1];
+        xi = im[j + 1];
+        re[j + 1] = re[j] - xr;
+        im[j + 1] = im[j] - xi;
+        re[j] += xr;
+        im[j] += xi;
+    }
+}
+
+/* radix-3 DIT stage, combines the three sub-ffts of length m held one after
+ * another into the complex fft of length 3 * m */
+static void rfft_dit_radix3(float *re, float *im, int m, const float *tw3)
+{
+    const float s3 = 0.86602540378443864676f;
+    int k;
+    float ar, ai, br, bi, cr, ci;
+    float t1r, t1i, t2r, t2i, sr, si;
+    for (k = 0; k < m; k++)
+    {
+        ar = re[k];
+        ai = im[k];
+        br = tw3[k] * re[m + k] - tw3[m + k] * im[m + k];
+        bi = tw3[k] * im[m + k] + tw3[m + k] * re[m + k];
+        cr = tw3[2 * m + k] * re[2 * m + k] - tw3[3 * m + k] * im[2 * m + k];
+        ci = tw3[2 * m + k] * im[2 * m + k] + tw3[3 * m + k] * re[2 * m + k];
+        t1r = br + cr;
+        t1i = bi + ci;
+        t2r = s3 * (br - cr);
+        t2i = s3 * (bi - ci);
+        sr = ar - 0.5f * t1r;
+        si = ai - 0.5f * t1i;
+        re[k] = ar + t1r;
+        im[k] = ai + t1i;
+        re[m + k] = sr + t2i;
+        im[m + k] = si - t2r;
+        re[2 * m + k] = sr - t2i;
+        im[2 * m + k] = si + t2r;
+    }
+}
+
+/* radix-3 DIF stage, splits the complex fft of length 3 * m into three
+ * sub-ffts of length m, the sub-fft r gives the outputs 3 * j + r */
+static void rfft_dif_radix3(float *re, float *im, int m, const float *tw3)
+{
+    const float s3 = 0.86602540378443864676f;
+    int k;
+    float ar, ai, t1r, t1i, t2r, t2i, sr, si;
+    float yr, yi;
+    for (k = 0; k < m; k++)
+    {
+        ar = re[k];
+        ai = im[k];
+        t1r = re[m + k] + re[2 * m + k];
+        t1i = im[m + k] + im[2 * m + k];
+        t2r = s3 * (re[m + k] - re[2 * m + k]);
+        t2i = s3 * (im[m + k] - im[2 * m + k]);
+        sr = ar - 0.5f * t1r;
+        si = ai - 0.5f * t1i;
+        re[k] = ar + t1r;
+        im[k] = ai + t1i;
+        yr = sr + t2i;
+        yi = si - t2r;
+        re[m + k] = tw3[k] * yr - tw3[m + k] * yi;
+        im[m + k] = tw3[k] * yi + tw3[m + k] * yr;
+        yr = sr - t2i;
+        yi = si + t2r;
+        re[2 * m + k] = tw3[2 * m + k] * yr - tw3[3 * m + k] * yi;
+        im[2 * m + k] = tw3[2 * m + k] * yi + tw3[3 * m + k] * yr;
+    }
+}
+
+#endif
+
+/* radix-4 DIT butterflies over blocks of 4 * h, input in bit-reversed order.
+ * tw holds [w1r, w1i, w2r, w2i, w3r, w3i], each of length h, with w = exp(-2*pi*i/(4*h)) */
+static void rfft_dit_radix4_scalar(float *re, float *im, int n, int h, const float *tw)
+{
+    int blk, j;
+    float *r0, *r1, *r2, *r3;
+    float *i0, *i1, *i2, *i3;
+    float c1r, c1i, c2r, c2i, c3r, c3i;
+    float s0r, s0i, d0r, d0i, s1r, s1i, d1r, d1i;
+
+    for (blk = 0; blk < n; blk += 4 * h)
+    {
+        r0 = re + blk; r1 = r0 + h; r2 = r1 + h; r3 = r2 + h;
+        i0 = im + blk; i1 = i0 + h; i2 = i1 + h; i3 = i2 + h;
+        for (j = 0; j < h; j++)
+        {
+            c1r = tw[j] * r2[j] - tw[h + j] * i2[j];
+            c1i = tw[j] * i2[j] + tw[h + j] * r2[j];
+            c2r = tw[2 * h + j] * r1[j] - tw[3 * h + j] * i1[j];
+            c2i = tw[2 * h + j] * i1[j] + tw[3 * h + j] * r1[j];
+            c3r = tw[4 * h + j] * r3[j] - tw[5 * h + j] * i3[j];
+            c3i = tw[4 * h + j] * i3[j] + tw[5 * h + j] * r3[j];
+            s0r = r0[j] + c2r; s0i = i0[j] + c2i;
+            d0r = r0[j] - c2r; d0i = i0[j] - c2i;
+            s1r = c1r + c3r; s1i = c1i + c3i;
+            d1r = c1r - c3r; d1i = c1i - c3i;
+            r0[j] = s0r + s1r; i0[j] = s0i + s1i;
+            r2[j] = s0r - s1r; i2[j] = s0i - s1i;
+            r1[j] = d0r + d1i; i1[j] = d0i - d1r;
+            r3[j] = d0r - d1i; i3[j] = d0i + d1r;
+        }
+    }
+}
+
+/* radix-4 DIF butterflies over blocks of 4 * h, output in bit-reversed order */
+static void rfft_dif_radix4_scalar(float *re, float *im, int n, int h, const float *tw)
+{
+    int blk, j;
+    float *r0, *r1, *r2, *r3;
+    float *i0, *i1, *i2, *i3;
+    float s0r, s0i, d0r, d0i, s1r, s1i, d1r, d1i;
+    float xr, xi;
+
+    for (blk = 0; blk < n; blk += 4 * h)
+    {
+        r0 = re + blk; r1 = r0 + h; r2 = r1 + h; r3 = r2 + h;
+        i0 = im + blk; i1 = i0 + h; i2 = i1 + h; i3 = i2 + h;
+        for (j = 0; j < h; j++)
+        {
+            s0r = r0[j] + r2[j]; s0i = i0[j] + i2[j];
+            d0r = r0[j] - r2[j]; d0i = i0[j] - i2[j];
+            s1r = r1[j] + r3[j]; s1i = i1[j] + i3[j];
+            d1r = r1[j] - r3[j]; d1i = i1[j] - i3[j];
+            r0[j] = s0r + s1r; i0[j] = s0i + s1i;
+            xr = s0r - s1r; xi = s0i - s1i;
+            r1[j] = tw[2 * h + j] * xr - tw[3 * h + j] * xi;
+            i1[j] = tw[2 * h + j] * xi + tw[3 * h + j] * xr;
+            xr = d0r + d1i; xi = d0i - d1r;
+            r2[j] = tw[j] * xr - tw[h + j] * xi;
+            i2[j] = tw[j] * xi + tw[h + j] * xr;
+            xr = d0r - d1i; xi = d0i + d1r;
+            r3[j] = tw[4 * h + j] * xr - tw[5 * h + j] * xi;
+            i3[j] = tw[4 * h + j] * xi + tw[5 * h + j] * xr;
+        }
+    }
+}
+
+#ifdef RFFT_X86_SIMD
+/* the SIMD kernels follow the scalar operation order exactly, for h below the
+ * vector width they fall back to the scalar kernels */
+__attribute__((target("sse2")))
+static void rfft_dit_radix4_sse2(float *re, float *im, int n, int h, const float *tw)
+{
+    int blk, j;
+    float *r0, *r1, *r2, *r3;
+    float *i0, *i1, *i2, *i3;
+    __m128 a0r, a0i, a1r, a1i, a2r, a2i, a3r, a3i;
+    __m128 w1r, w1i, w2r, w2i, w3r, w3i;
+    __m128 c1r, c1i, c2r, c2i, c3r, c3i;
+    __m128 s0r, s0i, d0r, d0i, s1r, s1i, d1r, d1i;
+
+    if (h < 4)
+    {
+        rfft_dit_radix4_scalar(re, im, n, h, tw);
+        return;
+    }
+    for (blk = 0; blk < n; blk += 4 * h)
+    {
+        r0 = re + blk; r1 = r0 + h; r2 = r1 + h; r3 = r2 + h;
+        i0 = im + blk; i1 = i0 + h; i2 = i1 + h; i3 = i2 + h;
+        for (j = 0; j < h; j += 4)
+        {
+            a0r = _mm_loadu_ps(r0 + j); a0i = _mm_loadu_ps(i0 + j);
+            a1r = _mm_loadu_ps(r1 + j); a1i = _mm_loadu_ps(i1 + j);
+            a2r = _mm_loadu_ps(r2 + j); a2i = _mm_loadu_ps(i2 + j);
+            a3r = _mm_loadu_ps(r3 + j); a3i = _mm_loadu_ps(i3 + j);
+            w1r = _mm_loadu_ps(tw + j); w1i = _mm_loadu_ps(tw + h + j);
+            w2r = _mm_loadu_ps(tw + 2 * h + j); w2i = _mm_loadu_ps(tw + 3 * h + j);
+            w3r = _mm_loadu_ps(tw + 4 * h + j); w3i = _mm_loadu_ps(tw + 5 * h + j);
+            c1r = _mm_sub_ps(_mm_mul_ps(w1r, a2r), _mm_mul_ps(w1i, a2i));
+            c1i = _mm_add_ps(_mm_mul_ps(w1r, a2i), _mm_mul_ps(w1i, a2r));
+            c2r = _mm_sub_ps(_mm_mul_ps(w2r, a1r), _mm_mul_ps(w2i, a1i));
+            c2i = _mm_add_ps(_mm_mul_ps(w2r, a1i), _mm_mul_ps(w2i, a1r));
+            c3r = _mm_sub_ps(_mm_mul_ps(w3r, a3r), _mm_mul_ps(w3i, a3i));
+            c3i = _mm_add_ps(_mm_mul_ps(w3r, a3i), _mm_mul_ps(w3i, a3r));
+            s0r = _mm_add_ps(a0r, c2r); s0i = _mm_add_ps(a0i, c2i);
+            d0r = _mm_sub_ps(a0r, c2r); d0i = _mm_sub_ps(a0i, c2i);
+            s1r = _mm_add_ps(c1r, c3r); s1i = _mm_add_ps(c1i, c3i);
+            d1r = _mm_sub_ps(c1r, c3r); d1i = _mm_sub_ps(c1i, c3i);
+            _mm_storeu_ps(r0 + j, _mm_add_ps(s0r, s1r)); _mm_storeu_ps(i0 + j, _mm_add_ps(s0i, s1i));
+            _mm_storeu_ps(r2 + j, _mm_sub_ps(s0r, s1r)); _mm_storeu_ps(i2 + j, _mm_sub_ps(s0i, s1i));
+            _mm_storeu_ps(r1 + j, _mm_add_ps(d0r, d1i)); _mm_storeu_ps(i1 + j, _mm_sub_ps(d0i, d1r));
+            _mm_storeu_ps(r3 + j, _mm_sub_ps(d0r, d1i)); _mm_storeu_ps(i3 + j, _mm_add_ps(d0i, d1r));
+        }
+    }
+}
+
+__attribute__((target("sse2")))
+static void rfft_dif_radix4_sse2(float *re, float *im, int n, int h, const float *tw)
+{
+    int blk, j;
+    float *r0, *r1, *r2, *r3;
+    float *i0, *i1, *i2, *i3;
+    __m128 a0r, a0i, a1r, a1i, a2r, a2i, a3r, a3i;
+    __m128 wr, wi, xr, xi;
+    __m128 s0r, s0i, d0r, d0i, s1r, s1i, d1r, d1i;
+
+    if (h < 4)
+    {
+        rfft_dif_radix4_scalar(re, im, n, h, tw);
+        return;
+    }
+    for (blk = 0; blk < n; blk += 4 * h)
+    {
+        r0 = re + blk; r1 = r0 + h; r2 = r1 + h; r3 = r2 + h;
+        i0 = im + blk; i1 = i0 + h; i2 = i1 + h; i3 = i2 + h;
+        for (j = 0; j < h; j += 4)
+        {
+            a0r = _mm_loadu_ps(r0 + j); a0i = _mm_loadu_ps(i0 + j);
+            a1r = _mm_loadu_ps(r1 + j); a1i = _mm_loadu_ps(i1 + j);
+            a2r = _mm_loadu_ps(r2 + j); a2i = _mm_loadu_ps(i2 + j);
+            a3r = _mm_loadu_ps(r3 + j); a3i = _mm_loadu_ps(i3 + j);
+            s0r = _mm_add_ps(a0r, a2r); s0i = _mm_add_ps(a0i, a2i);
+            d0r = _mm_sub_ps(a0r, a2r); d0i = _mm_sub_ps(a0i, a2i);
+            s1r = _mm_add_ps(a1r, a3r); s1i = _mm_add_ps(a1i, a3i);
+            d1r = _mm_sub_ps(a1r, a3r); d1i = _mm_sub_ps(a1i, a3i);
+            _mm_storeu_ps(r0 + j, _mm_add_ps(s0r, s1r)); _mm_storeu_ps(i0 + j, _mm_add_ps(s0i, s1i));
+            xr = _mm_sub_ps(s0r, s1r); xi = _mm_sub_ps(s0i, s1i);
+            wr = _mm_loadu_ps(tw + 2 * h + j); wi = _mm_loadu_ps(tw + 3 * h + j);
+            _mm_storeu_ps(r1 + j, _mm_sub_ps(_mm_mul_ps(wr, xr), _mm_mul_ps(wi, xi)));
+            _mm_storeu_ps(i1 + j, _mm_add_ps(_mm_mul_ps(wr, xi), _mm_mul_ps(wi, xr)));
+            xr = _mm_add_ps(d0r, d1i); xi = _mm_sub_ps(d0i, d1r);
+            wr = _mm_loadu_ps(tw + j); wi = _mm_loadu_ps(tw + h + j);
+            _mm_storeu_ps(r2 + j, _mm_sub_ps(_mm_mul_ps(wr, xr), _mm_mul_ps(wi, xi)));
+            _mm_storeu_ps(i2 + j, _mm_add_ps(_mm_mul_ps(wr, xi), _mm_mul_ps(wi, xr)));
+            xr = _mm_sub_ps(d0r, d1i); xi = _mm_add_ps(d0i, d1r);
+            wr = _mm_loadu_ps(tw + 4 * h + j); wi = _mm_loadu_ps(tw + 5 * h + j);
+            _mm_storeu_ps(r3 + j, _mm_sub_ps(_mm_mul_ps(wr, xr), _mm_mul_ps(wi, xi)));
+            _mm_storeu_ps(i3 + j, _mm_add_ps(_mm_mul_ps(wr, xi), _mm_mul_ps(wi, xr)));
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static void rfft_dit_radix4_avx2(float *re, float *im, int n, int h, const float *tw)
+{
+    int blk, j;
+    float *r0, *r1, *r2, *r3;
+    float *i0, *i1, *i2, *i3;
+    __m256 a0r, a0i, a1r, a1i, a2r, a2i, a3r, a3i;
+    __m256 w1r, w1i, w2r, w2i, w3r, w3i;
+    __m256 c1r, c1i, c2r, c2i, c3r, c3i;
+    __m256 s0r, s0i, d0r, d0i, s1r, s1i, d1r, d1i;
+
+    if (h < 8)
+    {
+        rfft_dit_radix4_sse2(re, im, n, h, tw);
+        return;
+    }
+    for (blk = 0; blk < n; blk += 4 * h)
+    {
+        r0 = re + blk; r1 = r0 + h; r2 = r1 + h; r3 = r2 + h;
+        i0 = im + blk; i1 = i0 + h; i2 = i1 + h; i3 = i2 + h;
+        for (j = 0; j < h; j += 8)
+        {
+            a0r = _mm256_loadu_ps(r0 + j); a0i = _mm256_loadu_ps(i0 + j);
+            a1r = _mm256_loadu_ps(r1 + j); a1i = _mm256_loadu_ps(i1 + j);
+            a2r = _mm256_loadu_ps(r2 + j); a2i = _mm256_loadu_ps(i2 + j);
+            a3r = _mm256_loadu_ps(r3 + j); a3i = _mm256_loadu_ps(i3 + j);
+            w1r = _mm256_loadu_ps(tw + j); w1i = _mm256_loadu_ps(tw + h + j);
+            w2r = _mm256_loadu_ps(tw + 2 * h + j); w2i = _mm256_loadu_ps(tw + 3 * h + j);
+            w3r = _mm256_loadu_ps(tw + 4 * h + j); w3i = _mm256_loadu_ps(tw + 5 * h + j);
+            c1r = _mm256_sub_ps(_mm256_mul_ps(w1r, a2r), _mm256_mul_ps(w1i, a2i));
+            c1i = _mm256_add_ps(_mm256_mul_ps(w1r, a2i), _mm256_mul_ps(w1i, a2r));
+            c2r = _mm256_sub_ps(_mm256_mul_ps(w2r, a1r), _mm256_mul_ps(w2i, a1i));
+            c2i = _mm256_add_ps(_mm256_mul_ps(w2r, a1i), _mm256_mul_ps(w2i, a1r));
+            c3r = _mm256_sub_ps(_mm256_mul_ps(w3r, a3r), _mm256_mul_ps(w3i, a3i));
+            c3i = _mm256_add_ps(_mm256_mul_ps(w3r, a3i), _mm256_mul_ps(w3i, a3r));
+            s0r = _mm256_add_ps(a0r, c2r); s0i = _mm256_add_ps(a0i, c2i);
+            d0r = _mm256_sub_ps(a0r, c2r); d0i = _mm256_sub_ps(a0i, c2i);
+            s1r = _mm256_add_ps(c1r, c3r); s1i = _mm256_add_ps(c1i, c3i);
+            d1r = _mm256_sub_ps(c1r, c3r); d1i = _mm256_sub_ps(c1i, c3i);
+            _mm256_storeu_ps(r0 + j, _mm256_add_ps(s0r, s1r)); _mm256_storeu_ps(i0 + j, _mm256_add_ps(s0i, s1i));
+            _mm256_storeu_ps(r2 + j, _mm256_sub_ps(s0r, s1r)); _mm256_storeu_ps(i2 + j, _mm256_sub_ps(s0i, s1i));
+            _mm256_storeu_ps(r1 + j, _mm256_add_ps(d0r, d1i)); _mm256_storeu_ps(i1 + j, _mm256_sub_ps(d0i, d1r));
+            _mm256_storeu_ps(r3 + j, _mm256_sub_ps(d0r, d1i)); _mm256_storeu_ps(i3 + j, _mm256_add_ps(d0i, d1r));
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static void rfft_dif_radix4_avx2(float *re, float *im, int n, int h, const float *tw)
+{
+    int blk, j;
+    float *r0, *r1, *r2, *r3;
+    float *i0, *i1, *i2, *i3;
+    __m256 a0r, a0i, a1r, a1i, a2r, a2i, a3r, a3i;
+    __m256 wr, wi, xr, xi;
+    __m256 s0r, s0i, d0r, d0i, s1r, s1i, d1r, d1i;
+
+    if (h < 8)
+    {
+        rfft_dif_radix4_sse2(re, im, n, h, tw);
+        return;
+    }
+    for (blk = 0; blk < n; blk += 4 * h)
+    {
+        r0 = re + blk; r1 = r0 + h; r2 = r1 + h; r3 = r2 + h;
+        i0 = im + blk; i1 = i0 + h; i2 = i1 + h; i3 = i2 + h;
+        for (j = 0; j < h; j += 8)
+        {
+            a0r = _mm256_loadu_ps(r0 + j); a0i = _mm256_loadu_ps(i0 + j);
+            a1r = _mm256_loadu_ps(r1 + j); a1i = _mm256_loadu_ps(i1 + j);
+            a2r = _mm256_loadu_ps(r2 + j); a2i = _mm256_loadu_ps(i2 + j);
+            a3r = _mm256_loadu_ps(r3 + j); a3i = _mm256_loadu_ps(i3 + j);
+            s0r = _mm256_add_ps(a0r, a2r); s0i = _mm256_add_ps(a0i, a2i);
+            d0r = _mm256_sub_ps(a0r, a2r); d0i = _mm256_sub_ps(a0i, a2i);
+            s1r = _mm256_add_ps(a1r, a3r); s1i = _mm256_add_ps(a1i, a3i);
+            d1r = _mm256_sub_ps(a1r, a3r); d1i = _mm256_sub_ps(a1i, a3i);
+            _mm256_storeu_ps(r0 + j, _mm256_add_ps(s0r, s1r)); _mm256_storeu_ps(i0 + j, _mm256_add_ps(s0i, s1i));
+            xr = _mm256_sub_ps(s0r, s1r); xi = _mm256_sub_ps(s0i, s1i);
+            wr = _mm256_loadu_ps(tw + 2 * h + j); wi = _mm256_loadu_ps(tw + 3 * h + j);
+            _mm256_storeu_ps(r1 + j, _mm256_sub_ps(_mm256_mul_ps(wr, xr), _mm256_mul_ps(wi, xi)));
+            _mm256_storeu_ps(i1 + j, _mm256_add_ps(_mm256_mul_ps(wr, xi), _mm256_mul_ps(wi, xr)));
+            xr = _mm256_add_ps(d0r, d1i); xi = _mm256_sub_ps(d0i, d1r);
+            wr = _mm256_loadu_ps(tw + j); wi = _mm256_loadu_ps(tw + h + j);
+            _mm256_storeu_ps(r2 + j, _mm256_sub_ps(_mm256_mul_ps(wr, xr), _mm256_mul_ps(wi, xi)));
+            _mm256_storeu_ps(i2 + j, _mm256_add_ps(_mm256_mul_ps(wr, xi), _mm256_mul_ps(wi, xr)));
+            xr = _mm256_sub_ps(d0r, d1i); xi = _mm256_add_ps(d0i, d1r);
+            wr = _mm256_loadu_ps(tw + 4 * h + j); wi = _mm256_loadu_ps(tw + 5 * h + j);
+            _mm256_storeu_ps(r3 + j, _mm256_sub_ps(_mm256_mul_ps(wr, xr), _mm256_mul_ps(wi, xi)));
+            _mm256_storeu_ps(i3 + j, _mm256_add_ps(_mm256_mul_ps(wr, xi), _mm256_mul_ps(wi, xr)));
+        }
+    }
+}
+#endif
+
+static void rfft_select_kernel(RFFT_PARAM *rfft_param)
+{
+    rfft_param->dit_pass = rfft_dit_radix4_scalar;
+    rfft_param->dif_pass = rfft_dif_radix4_scalar;
+#ifdef RFFT_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        rfft_param->dit_pass = rfft_dit_radix4_avx2;
+        rfft_param->dif_pass = rfft_dif_radix4_avx2;
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        rfft_param->dit_pass = rfft_dit_radix4_sse2;
+        rfft_param->dif_pass = rfft_dif_radix4_sse2;
+    }
+#endif
+}
+
+#if !DIOS_SSP_FIXED_POINT
+/* in-place or out-of-place bit-reversal permutation of fft_len points, it maps
+ * interleaved even/odd samples onto the bit-reversed split real/imag layout and back,
+ * inverse selects the way back, which only differs for the radix-3 plan */
+static void rfft_bitrev_permute(const RFFT_PARAM *rfft_param, const float *inbuffer, float *outbuffer, int inverse)
+{
+    int i;
+    int k;
+    float xr;
+    const int *bitrev = rfft_param->bitrev;
+
+    if (rfft_param->radix3_flag)
+    {
+        if (inbuffer == outbuffer)
+        {
+            memcpy(rfft_param->scratch, inbuffer, rfft_param->fft_len * sizeof(float));
+            inbuffer = rfft_param->scratch;
+        }
+        for (i = 0; i < rfft_param->fft_len; i++)
+        {
+            if (inverse)
+            {
+                outbuffer[i] = inbuffer[bitrev[i]];
+            }
+            else
+            {
+                outbuffer[bitrev[i]] = inbuffer[i];
+            }
+        }
+        return;
+    }
+    if (inbuffer != outbuffer)
+    {
+        for (i = 0; i < rfft_param->fft_len; i++)
+        {
+            outbuffer[bitrev[i]] = inbuffer[i];
+        }
+        return;
+    }
+    for (i = 0; i < rfft_param->fft_len; i++)
+    {
+        k = bitrev[i];
+        if (i < k)
+        {
+            xr = outbuffer[i];
+            outbuffer[i] = outbuffer[k];
+            outbuffer[k] = xr;
+        }
+    }
+}
+#endif
+
+#if DIOS_SSP_FIXED_POINT
+/* headroom in bits a stage of the fixed-point plan needs: a radix-2 pass at
+ * most doubles a component, a radix-4 butterfly grows it by up to 1 + 3 * sqrt(2)
+ * (DIT) or 4 * sqrt(2) (DIF), a radix-3 one by up to about 4.9, the split step
+ * (computed without its 0.5 factors) by 2 + 2 * sqrt(2) and the merge step by
+ * 2 + 2 * sqrt(2) */
+#define RFFT_FIX_GUARD_RADIX2   (1)
+#define RFFT_FIX_GUARD          (3)
+#define RFFT_FIX_S3_Q31         (1859775393)    /* sqrt(3) / 2 in Q31 */
+
+/* twiddle in Q31, +-1.0 saturate to +-FIX_Q31_ONE so that every twiddle can
+ * be negated */
+static int rfft_q31(double x)
+{
+    x = x > 1.0 ? 1.0 : (x < -1.0 ? -1.0 : x);
+    return (int)lrint(x * FIX_Q31_ONE);
+}
+
+static void rfft_fix_radix2_pass(int *re, int *im, int n)
+{
+    int j;
+    int xr, xi;
+    for (j = 0; j < n; j += 2)
+    {
+        xr = re[j + 1];
+        xi = im[j + 1];
+        re[j + 1] = re[j] - xr;
+        im[j + 1] = im[j] - xi;
+        re[j] += xr;
+        im[j] += xi;
+    }
+}
+
+static void rfft_fix_dit_radix3(int *re, int *im, int m, const int *tw3)
+{
+    int k;
+    int ar, ai, br, bi, cr, ci;
+    int t1r, t1i, t2r, t2i, sr, si;
+    for (k = 0; k < m; k++)
+    {
+        ar = re[k];
+        ai = im[k];
+        br = FIX_CMUL_RE_Q31(re[m + k], im[m + k], tw3[k], tw3[m + k]);
+        bi = FIX_CMUL_IM_Q31(re[m + k], im[m + k], tw3[k], tw3[m + k]);
+        cr = FIX_CMUL_RE_Q31(re[2 * m + k], im[2 * m + k], tw3[2 * m + k], tw3[3 * m + k]);
+        ci = FIX_CMUL_IM_Q31(re[2 * m + k], im[2 * m + k], tw3[2 * m + k], tw3[3 * m + k]);
+        t1r = br + cr;
+        t1i = bi + ci;
+        t2r = FIX_MUL_Q31(RFFT_FIX_S3_Q31, br - cr);
+        t2i = FIX_MUL_Q31(RFFT_FIX_S3_Q31, bi - ci);
+        sr = ar - (t1r >> 1);
+        si = ai - (t1i >> 1);
+        re[k] = ar + t1r;
+        im[k] = ai + t1i;
+        re[m + k] = sr + t2i;
+        im[m + k] = si - t2r;
+        re[2 * m + k] = sr - t2i;
+        im[2 * m + k] = si + t2r;
+    }
+}
+
+static void rfft_fix_dif_radix3(int *re, int *im, int m, const int *tw3)
+{
+    int k;
+    int ar, ai, t1r, t1i, t2r, t2i, sr, si;
+    int yr, yi;
+    for (k = 0; k < m; k++)
+    {
+        ar = re[k];
+        ai = im[k];
+        t1r = re[m + k] + re[2 * m + k];
+        t1i = im[m + k] + im[2 * m + k];
+        t2r = FIX_MUL_Q31(RFFT_FIX_S3_Q31, re[m + k] - re[2 * m + k]);
+        t2i = FIX_MUL_Q31(RFFT_FIX_S3_Q31, im[m + k] - im[2 * m + k]);
+        sr = ar - (t1r >> 1);
+        si = ai - (t1i >> 1);
+        re[k] = ar + t1r;
+        im[k] = ai + t1i;
+        yr = sr + t2i;
+        yi = si - t2r;
+        re[m + k] = FIX_CMUL_RE_Q31(yr, yi, tw3[k], tw3[m + k]);
+        im[m + k] = FIX_CMUL_IM_Q31(yr, yi, tw3[k], tw3[m + k]);
+        yr = sr - t2i;
+        yi = si + t2r;
+        re[2 * m + k] = FIX_CMUL_RE_Q31(yr, yi, tw3[2 * m + k], tw3[3 * m + k]);
+        im[2 * m + k] = FIX_CMUL_IM_Q31(yr, yi, tw3[2 * m + k], tw3[3 * m + k]);
+    }
+}
+
+static void rfft_fix_dit_radix4(int *re, int *im, int n, int h, const int *tw)
+{
+    int blk, j;
+    int *r0, *r1, *r2, *r3;
+    int *i0, *i1, *i2, *i3;
+    int c1r, c1i, c2r, c2i, c3r, c3i;
+    int s0r, s0i, d0r, d0i, s1r, s1i, d1r, d1i;
+
+    for (blk = 0; blk < n; blk += 4 * h)
+    {
+        r0 = re + blk; r1 = r0 + h; r2 = r1 + h; r3 = r2 + h;
+        i0 = im + blk; i1 = i0 + h; i2 = i1 + h; i3 = i2 + h;
+        for (j = 0; j < h; j++)
+        {
+            c1r = FIX_CMUL_RE_Q31(r2[j], i2[j], tw[j], tw[h + j]);
+            c1i = FIX_CMUL_IM_Q31(r2[j], i2[j], tw[j], tw[h + j]);
+            c2r = FIX_CMUL_RE_Q31(r1[j], i1[j], tw[2 * h + j], tw[3 * h + j]);
+            c2i = FIX_CMUL_IM_Q31(r1[j], i1[j], tw[2 * h + j], tw[3 * h + j]);
+            c3r = FIX_CMUL_RE_Q31(r3[j], i3[j], tw[4 * h + j], tw[5 * h + j]);
+            c3i = FIX_CMUL_IM_Q31(r3[j], i3[j], tw[4 * h + j], tw[5 * h + j]);
+            s0r = r0[j] + c2r; s0i = i0[j] + c2i;
+            d0r = r0[j] - c2r; d0i = i0[j] - c2i;
+            s1r = c1r + c3r; s1i = c1i + c3i;
+            d1r = c1r - c3r; d1i = c1i - c3i;
+            r0[j] = s0r + s1r; i0[j] = s0i + s1i;
+            r2[j] = s0r - s1r; i2[j] = s0i - s1i;
+            r1[j] = d0r + d1i; i1[j] = d0i - d1r;
+            r3[j] = d0r - d1i; i3[j] = d0i + d1r;
+        }
+    }
+}
+
+static void rfft_fix_dif_radix4(int *re, int *im, int n, int h, const int *tw)
+{
+    int blk, j;
+    int *r0, *r1, *r2, *r3;
+    int *i0, *i1, *i2, *i3;
+    int s0r, s0i, d0r, d0i, s1r, s1i, d1r, d1i;
+    int xr, xi;
+
+    for (blk = 0; blk < n; blk += 4 * h)
+    {
+        r0 = re + blk; r1 = r0 + h; r2 = r1 + h; r3 = r2 + h;
+        i0 = im + blk; i1 = i0 + h; i2 = i1 + h; i3 = i2 + h;
+        for (j = 0; j < h; j++)
+        {
+            s0r = r0[j] + r2[j]; s0i = i0[j] + i2[j];
+            d0r = r0[j] - r2[j]; d0i = i0[j] - i2[j];
+            s1r = r1[j] + r3[j]; s1i = i1[j] + i3[j];
+            d1r = r1[j] - r3[j]; d1i = i1[j] - i3[j];
+            r0[j] = s0r + s1r; i0[j] = s0i + s1i;
+            xr = s0r - s1r; xi = s0i - s1i;
+            r1[j] = FIX_CMUL_RE_Q31(xr, xi, tw[2 * h + j], tw[3 * h + j]);
+            i1[j] = FIX_CMUL_IM_Q31(xr, xi, tw[2 * h + j], tw[3 * h + j]);
+            xr = d0r + d1i; xi = d0i - d1r;
+            r2[j] = FIX_CMUL_RE_Q31(xr, xi, tw[j], tw[h + j]);
+            i2[j] = FIX_CMUL_IM_Q31(xr, xi, tw[j], tw[h + j]);
+            xr = d0r - d1i; xi = d0i + d1r;
+            r3[j] = FIX_CMUL_RE_Q31(xr, xi, tw[4 * h + j], tw[5 * h + j]);
+            i3[j] = FIX_CMUL_IM_Q31(xr, xi, tw[4 * h + j], tw[5 * h + j]);
+        }
+    }
+}
+
+/* rfft_bitrev_permute on an int32 block */
+static void rfft_fix_bitrev_permute(const RFFT_PARAM *rfft_param, const int *inbuffer, int *outbuffer, int inverse)
+{
+    int i;
+    int k;
+    int x;
+    int *scratch = (int *)rfft_param->scratch;
+    const int *bitrev = rfft_param->bitrev;
+
+    if (rfft_param->radix3_flag)
+    {
+        if (inbuffer == outbuffer)
+        {
+            memcpy(scratch, inbuffer, rfft_param->fft_len * sizeof(int));
+            inbuffer = scratch;
+        }
+        for (i = 0; i < rfft_param->fft_len; i++)
+        {
+            if (inverse)
+            {
+                outbuffer[i] = inbuffer[bitrev[i]];
+            }
+            else
+            {
+                outbuffer[bitrev[i]] = inbuffer[i];
+            }
+        }
+        return;
+    }
+    if (inbuffer != outbuffer)
+    {
+        for (i = 0; i < rfft_param->fft_len; i++)
+        {
+            outbuffer[bitrev[i]] = inbuffer[i];
+        }
+        return;
+    }
+    for (i = 0; i < rfft_param->fft_len; i++)
+    {
+        k = bitrev[i];
+        if (i < k)
+        {
+            x = outbuffer[i];
+            outbuffer[i] = outbuffer[k];
+            outbuffer[k] = x;
+        }
+    }
+}
+#endif
+
+/* size of the rfft tables in bytes, the table pointers of rfft_param are set
+   to their place in table unless it is NULL */
+static size_t rfft_table_layout(RFFT_PARAM *rfft_param, void *table)
+{
+    size_t off_wr = rfft_param->fft_len * sizeof(int);
+    size_t off_wi = off_wr + (rfft_param->half_len / 2 + 1) * sizeof(float);
+    size_t off_tw = off_wi + (rfft_param->half_len / 2 + 1) * sizeof(float);
+    size_t off_tw3 = off_tw + (rfft_param->tw_len + 1) * sizeof(float);
+    size_t size = off_tw3 + (rfft_param->radix3_flag ? 4 * rfft_param->sub_len * sizeof(float) : 0);
+#if DIOS_SSP_FIXED_POINT
+    size_t off_wr_q = size;
+    size_t off_wi_q = off_wr_q + (rfft_param->half_len / 2 + 1) * sizeof(int);
+    size_t off_tw_q = off_wi_q + (rfft_param->half_len / 2 + 1) * sizeof(int);
+    size_t off_tw3_q = off_tw_q + (rfft_param->tw_len + 1) * sizeof(int);
+    size = off_tw3_q + (rfft_param->radix3_flag ? 4 * rfft_param->sub_len * sizeof(int) : 0);
+#endif
+
+    if (table != NULL)
+    {
+        rfft_param->bitrev = (int *)table;
+        rfft_param->wr = (float *)((char *)table + off_wr);
+        rfft_param->wi = (float *)((char *)table + off_wi);
+        rfft_param->tw = (float *)((char *)table + off_tw);
+        rfft_param->tw3 = rfft_param->radix3_flag ? (float *)((char *)table + off_tw3) : NULL;
+#if DIOS_SSP_FIXED_POINT
+        rfft_param->wr_q = (int *)((char *)table + off_wr_q);
+        rfft_param->wi_q = (int *)((char *)table + off_wi_q);
+        rfft_param->tw_q = (int *)((char *)table + off_tw_q);
+        rfft_param->tw3_q = rfft_param->radix3_flag ? (int *)((char *)table + off_tw3_q) : NULL;
+#endif
+    }
+
+    return size;
+}
+
+/* ShareTableBuild of the rfft tables, arg is the planned RFFT_PARAM */
+static int rfft_table_build(void *table, const void *arg)
+{
+    RFFT_PARAM plan = *(const RFFT_PARAM *)arg;
+    RFFT_PARAM *rfft_param = &plan;
+    int fft_len = plan.fft_len;
+    int bits = plan.bits;
     int i = 0;
     int j = 0;
-    rfft_param->fft_len = fft_len;
-    for (i = 1; (j =  i << 1) <= rfft_param->fft_len; i = j)
-	{
-        rfft_param->Mq_max = i >> 1;
+    int k = 0;
+    int h = 0;
+    int p = 0;
+    float *tw;
+#if DIOS_SSP_FIXED_POINT
+    int *tw_q;
+#endif
+    double theta = 0;
+
+    rfft_table_layout(rfft_param, table);
+    if (rfft_param->radix3_flag)
+    {
+        /* sample 2 * (3 * j + r) + b goes to b * half_len + r * sub_len + bitrev(j) */
+        for (i = 0; i < fft_len; i++)
+        {
+            p = (i >> 1) / 3;
+            for (j = 0, k = 0; j < bits - 1; j++)
+            {
+                k = (k << 1) | ((p >> j) & 1);
+            }
+            rfft_param->bitrev[i] = (i & 1) * rfft_param->half_len + ((i >> 1) % 3) * rfft_param->sub_len + k;
+        }
+        for (i = 0; i < rfft_param->sub_len; i++)
+        {
+            theta = -2.0 * RFFT_PI * i / rfft_param->half_len;
+            rfft_param->tw3[i] = (float)cos(theta);
+            rfft_param->tw3[rfft_param->sub_len + i] = (float)sin(theta);
+            rfft_param->tw3[2 * rfft_param->sub_len + i] = (float)cos(2.0 * theta);
+            rfft_param->tw3[3 * rfft_param->sub_len + i] = (float)sin(2.0 * theta);
+        }
+    }
+    else
+    {
+        for (i = 0; i < fft_len; i++)
+        {
+            for (j = 0, k = 0; j < bits; j++)
+            {
+                k = (k << 1) | ((i >> j) & 1);
+            }
+            rfft_param->bitrev[i] = k;
+        }
     }
-    rfft_param->wi = (float *)calloc(rfft_param->Mq_max - 1, sizeof(float));
-    rfft_param->wr = (float *)calloc(rfft_param->Mq_max - 1, sizeof(float));
-    if (NULL == rfft_param->wi || NULL == rfft_param->wr)
+
+    /* twiddles are generated in double precision, then rounded once */
+    for (i = 0; i <= rfft_param->half_len / 2; i++)
 	{
+        theta = -2.0 * RFFT_PI * i / fft_len;
+        rfft_param->wr[i] = (float)cos(theta);
+        rfft_param->wi[i] = (float)sin(theta);
+    }
+    for (i = 0; i < rfft_param->stage_num; i++)
+    {
+        h = rfft_param->stage_h[i];
+        tw = rfft_param->tw + rfft_param->stage_tw[i];
+        for (j = 0; j < h; j++)
+        {
+            theta = -2.0 * RFFT_PI * j / (4 * h);
+            tw[j] = (float)cos(theta);
+            tw[h + j] = (float)sin(theta);
+            tw[2 * h + j] = (float)cos(2.0 * theta);
+            tw[3 * h + j] = (float)sin(2.0 * theta);
+            tw[4 * h + j] = (float)cos(3.0 * theta);
+            tw[5 * h + j] = (float)sin(3.0 * theta);
+        }
+    }
+#if DIOS_SSP_FIXED_POINT
+    for (i = 0; i <= rfft_param->half_len / 2; i++)
+    {
+        theta = -2.0 * RFFT_PI * i / fft_len;
+        rfft_param->wr_q[i] = rfft_q31(cos(theta));
+        rfft_param->wi_q[i] = rfft_q31(sin(theta));
+    }
+    for (i = 0; i < rfft_param->stage_num; i++)
+    {
+        h = rfft_param->stage_h[i];
+        tw_q = rfft_param->tw_q + rfft_param->stage_tw[i];
+        for (j = 0; j < h; j++)
+        {
+            theta = -2.0 * RFFT_PI * j / (4 * h);
+            tw_q[j] = rfft_q31(cos(theta));
+            tw_q[h + j] = rfft_q31(sin(theta));
+            tw_q[2 * h + j] = rfft_q31(cos(2.0 * theta));
+            tw_q[3 * h + j] = rfft_q31(sin(2.0 * theta));
+            tw_q[4 * h + j] = rfft_q31(cos(3.0 * theta));
+            tw_q[5 * h + j] = rfft_q31(sin(3.0 * theta));
+        }
+    }
+    for (i = 0; rfft_param->radix3_flag && i < rfft_param->sub_len; i++)
+    {
+        theta = -2.0 * RFFT_PI * i / rfft_param->half_len;
+        rfft_param->tw3_q[i] = rfft_q31(cos(theta));
+        rfft_param->tw3_q[rfft_param->sub_len + i] = rfft_q31(sin(theta));
+        rfft_param->tw3_q[2 * rfft_param->sub_len + i] = rfft_q31(cos(2.0 * theta));
+        rfft_param->tw3_q[3 * rfft_param->sub_len + i] = rfft_q31(sin(2.0 * theta));
+    }
+#endif
+
+    return 0;
+}
+
+static const size_t g_rfft_ptr[] = {
+	offsetof(RFFT_PARAM, table_pool), offsetof(RFFT_PARAM, table),
+	offsetof(RFFT_PARAM, bitrev), offsetof(RFFT_PARAM, tw3),
+	offsetof(RFFT_PARAM, scratch), offsetof(RFFT_PARAM, wr),
+	offsetof(RFFT_PARAM, wi), offsetof(RFFT_PARAM, tw),
+#if DIOS_SSP_FIXED_POINT
+	offsetof(RFFT_PARAM, wr_q), offsetof(RFFT_PARAM, wi_q),
+	offsetof(RFFT_PARAM, tw_q), offsetof(RFFT_PARAM, tw3_q),
+	offsetof(RFFT_PARAM, fix_buf),
+#endif
+};
+
+void *dios_ssp_share_rfft_init_pool(int fft_len, void *table_pool)
+{
+    void *rfft_handle = NULL;
+    RFFT_PARAM *rfft_param;
+    int bits = 0;
+    int h = 0;
+    int m = 0;
+    int tw_len = 0;
+    size_t table_size = 0;
+
+    /* fft_len must be 2^k or 3 * 2^k */
+    m = (fft_len % 3 == 0) ? fft_len / 3 : fft_len;
+    if (m < 2 || (m & (m - 1)) != 0)
+    {
+        puts("Invalid rfft length.\n");
+        return NULL;
+    }
+    rfft_handle = (void*)dios_ssp_share_calloc_map(1, sizeof(RFFT_PARAM), g_rfft_ptr, SHARE_ARENA_MAP_NUM(g_rfft_ptr));
+    if (NULL == rfft_handle)
+    {
         puts("Memory allocation error.\n");
         return NULL;
     }
+    rfft_param = (RFFT_PARAM*)rfft_handle;
+    rfft_param->fft_len = fft_len;
+    rfft_param->half_len = fft_len >> 1;
+    rfft_param->radix3_flag = (m != fft_len);
+    rfft_param->sub_len = m >> 1;
+    for (bits = 0; (1 << bits) < m; bits++)
+    {
+    }
+    rfft_param->bits = bits;
 
-    float theta = 0;
-    theta = (float)(-2.0f * PI / rfft_param->fft_len);
-    for (i = 1; i < rfft_param->Mq_max; i++)
+    /* stage plan of the complex fft, radix-4 stage h works on blocks of 4 * h,
+     * which also runs the three sub-ffts of a radix-3 plan in one pass */
+    rfft_param->radix2_flag = (bits - 1) & 1;
+    h = rfft_param->radix2_flag ? 2 : 1;
+    for (rfft_param->stage_num = 0; 4 * h <= rfft_param->sub_len; h *= 4)
+    {
+        rfft_param->stage_h[rfft_param->stage_num] = h;
+        rfft_param->stage_tw[rfft_param->stage_num] = tw_len;
+        rfft_param->stage_num++;
+        tw_len += 6 * h;
+    }
+    rfft_param->tw_len = tw_len;
+
+    rfft_param->table_pool = table_pool;
+    table_size = rfft_table_layout(rfft_param, NULL);
+    rfft_param->table = dios_ssp_share_table_get(table_pool, "rfft", &fft_len, sizeof(int), 
+        table_size, rfft_table_build, rfft_param);
+    if (rfft_param->radix3_flag)
+    {
+        rfft_param->scratch = (float *)dios_ssp_share_calloc(fft_len, sizeof(float));
+    }
+#if DIOS_SSP_FIXED_POINT
+    rfft_param->fix_buf = (int *)dios_ssp_share_calloc(fft_len, sizeof(int));
+    if (NULL == rfft_param->fix_buf)
+    {
+        puts("Memory allocation error.\n");
+        dios_ssp_share_rfft_uninit(rfft_handle);
+        return NULL;
+    }
+#endif
+    if (NULL == rfft_param->table || (rfft_param->radix3_flag && NULL == rfft_param->scratch))
 	{
-        rfft_param->wr[i - 1] = (float)cos(theta * i);
-        rfft_param->wi[i - 1] = (float)sin(theta * i);
+        puts("Memory allocation error.\n");
+        dios_ssp_share_rfft_uninit(rfft_handle);
+        return NULL;
     }
+    rfft_table_layout(rfft_param, rfft_param->table);
+
+    rfft_select_kernel(rfft_param);
     return(rfft_handle);
 }
 
+void *dios_ssp_share_rfft_init(int fft_len)
+{
+    return dios_ssp_share_rfft_init_pool(fft_len, NULL);
+}
+
 int dios_ssp_share_rfft_process(void *rfft_handle, float *inbuffer, float *outbuffer)
 {
     if (NULL == rfft_handle)
@@ -65,73 +930,63 @@ int dios_ssp_share_rfft_process(void *rfft_handle, float *inbuffer, float *outbu
     }
     RFFT_PARAM *rfft_param;
     rfft_param = (RFFT_PARAM*)rfft_handle;
-    int m = 0;
-    int mh = 0;
-    int mq = 0;
-    int i = 0;
-    int j = 0;
+#if DIOS_SSP_FIXED_POINT
+    int exp = dios_ssp_share_fixed_from_float(inbuffer, rfft_param->fix_buf, rfft_param->fft_len, 1);
+    dios_ssp_share_rfft_process_fix(rfft_handle, rfft_param->fix_buf, rfft_param->fix_buf, &exp);
+    dios_ssp_share_fixed_to_float(rfft_param->fix_buf, exp, outbuffer, rfft_param->fft_len);
+    return 0;
+#else
     int k = 0;
-    int jr = 0;
-    int ji = 0;
-    int kr = 0;
-    int ki = 0;
-    int fft_len = rfft_param->fft_len;
-    float xr = 0;
-    float xi = 0;
+    int s = 0;
+    int n = rfft_param->half_len;
+    float *re = outbuffer;
+    float *im = outbuffer + n;
+    float ar, ai, br, bi;
+    float fer, fei, for_, foi;
+    float xr, xi;
 
-    for (i = 0; i < fft_len; i++)
-	{
-        outbuffer[i] = inbuffer[i];
+    /* z[n] = x[2n] + i * x[2n + 1], loaded in bit-reversed order */
+    rfft_bitrev_permute(rfft_param, inbuffer, outbuffer, 0);
+
+    /* complex fft of half length */
+    if (rfft_param->radix2_flag)
+    {
+        rfft_radix2_pass(re, im, n);
     }
-    i = 0;
-    for (j = 1; j < fft_len - 1; j++)
-	{
-        for (k = fft_len >> 1; k > (i ^= k); k >>= 1)
-		{
-        }
-        if (j < i)
-		{
-            xr = outbuffer[j];
-            outbuffer[j] = outbuffer[i];
-            outbuffer[i] = xr;
-        }
+    for (s = 0; s < rfft_param->stage_num; s++)
+    {
+        rfft_param->dit_pass(re, im, n, rfft_param->stage_h[s], rfft_param->tw + rfft_param->stage_tw[s]);
+    }
+    if (rfft_param->radix3_flag)
+    {
+        rfft_dit_radix3(re, im, rfft_param->sub_len, rfft_param->tw3);
     }
 
-    for (mh = 1; (m = mh << 1) <= fft_len; mh = m)
-	{
-        mq = mh >> 1;
-
-        /* ---- real to real butterflies (W == 1) ---- */
-        for (jr = 0; jr < fft_len; jr += m)
-		{
-            kr = jr + mh;
-            xr = outbuffer[kr];
-            outbuffer[kr] = outbuffer[jr] - xr;
-            outbuffer[jr] += xr;
-        }
-
-        /* ---- complex to complex butterflies (W != 1) ---- */
-        for (i = 1; i < mq; i++)
-		{
-            for (j = 0; j < fft_len; j += m)
-			{
-                jr = j + i;
-                ji = j + mh - i;
-                kr = j + mh + i;
-                ki = j + m - i;
-                xr = rfft_param->wr[rfft_param->Mq_max / mq * i - 1] * outbuffer[kr] +
-                    rfft_param->wi[rfft_param->Mq_max / mq * i - 1] * outbuffer[ki];
-                xi = rfft_param->wr[rfft_param->Mq_max / mq * i - 1] * outbuffer[ki] -
-                    rfft_param->wi[rfft_param->Mq_max / mq * i - 1] * outbuffer[kr];
-                outbuffer[kr] = -outbuffer[ji] + xi;
-                outbuffer[ki] = outbuffer[ji] + xi;
-                outbuffer[ji] = outbuffer[jr] - xr;
-                outbuffer[jr] = outbuffer[jr] + xr;
-            }
-        }
-        /* ---- real to complex butterflies are trivial ---- */
+    /* split step, X[k] = Fe[k] + W^k * Fo[k], written back in place as
+     * out[k] = Re(X[k]), out[fft_len - k] = -Im(X[k]) */
+    ar = re[0];
+    ai = im[0];
+    re[0] = ar + ai;
+    im[0] = ar - ai;
+    for (k = 1; k <= n / 2; k++)
+    {
+        ar = re[k];
+        ai = im[k];
+        br = re[n - k];
+        bi = im[n - k];
+        fer = 0.5f * (ar + br);
+        fei = 0.5f * (ai - bi);
+        for_ = 0.5f * (ai + bi);
+        foi = 0.5f * (br - ar);
+        xr = rfft_param->wr[k] * for_ - rfft_param->wi[k] * foi;
+        xi = rfft_param->wr[k] * foi + rfft_param->wi[k] * for_;
+        re[k] = fer + xr;
+        im[n - k] = -(fei + xi);
+        re[n - k] = fer - xr;
+        im[k] = fei - xi;
     }
     return 0;
+#endif
 }
 
 int dios_ssp_share_irfft_process(void *rfft_handle, float *inbuffer, float *outbuffer)
@@ -142,84 +997,196 @@ int dios_ssp_share_irfft_process(void *rfft_handle, float *inbuffer, float *outb
     }
     RFFT_PARAM *rfft_param;
     rfft_param = (RFFT_PARAM*)rfft_handle;
-    int m = 0;
-    int mh = 0;
-    int mq = 0;
-    int i = 0;
-    int j = 0;
+#if DIOS_SSP_FIXED_POINT
+    int exp = dios_ssp_share_fixed_from_float(inbuffer, rfft_param->fix_buf, rfft_param->fft_len, 1);
+    dios_ssp_share_irfft_process_fix(rfft_handle, rfft_param->fix_buf, rfft_param->fix_buf, &exp);
+    dios_ssp_share_fixed_to_float(rfft_param->fix_buf, exp, outbuffer, rfft_param->fft_len);
+    return 0;
+#else
     int k = 0;
-    int jr = 0;
-    int ji = 0;
-    int kr = 0;
-    int ki = 0;
+    int s = 0;
+    int n = rfft_param->half_len;
     int fft_len = rfft_param->fft_len;
-    float xr = 0;
-    float xi = 0;
+    float *re = outbuffer;
+    float *im = outbuffer + n;
+    float xr, xi, yr, yi;
+    float ar, ai, br, bi, vr, vi;
 
-    for (i = 0; i < fft_len; i++)
-	{
-        outbuffer[i] = inbuffer[i];
+    /* merge step, Z[k] = (X[k] + conj(X[n - k])) + i * W^-k * (X[k] - conj(X[n - k])),
+     * which scales the result by fft_len like the former implementation */
+    xr = inbuffer[0];
+    yr = inbuffer[n];
+    re[0] = xr + yr;
+    im[0] = xr - yr;
+    for (k = 1; k <= n / 2; k++)
+    {
+        xr = inbuffer[k];
+        xi = -inbuffer[fft_len - k];
+        yr = inbuffer[n - k];
+        yi = -inbuffer[n + k];
+        ar = xr + yr;
+        ai = xi - yi;
+        br = xr - yr;
+        bi = xi + yi;
+        vr = rfft_param->wr[k] * br + rfft_param->wi[k] * bi;
+        vi = rfft_param->wr[k] * bi - rfft_param->wi[k] * br;
+        re[k] = ar - vi;
+        im[k] = ai + vr;
+        re[n - k] = ar + vi;
+        im[n - k] = vr - ai;
     }
-    outbuffer[0] *= 0.5;
-    outbuffer[fft_len / 2] *= 0.5;
 
-    for (m = fft_len; (mh = m >> 1) >= 1; m = mh)
-	{
-        mq = mh >> 1;
-
-        /* ---- real to real butterflies (W == 1) ---- */
-        for (jr = 0; jr < fft_len; jr += m)
-		{
-            kr = jr + mh;
-            xr = outbuffer[jr] - outbuffer[kr];
-            outbuffer[jr] += outbuffer[kr];
-            outbuffer[kr] = xr;
-        }
-
-        /* ---- complex to complex butterflies (W != 1) ---- */
-        for (i = 1; i < mq; i++)
-		{
-            for (j = 0; j < fft_len; j += m)
-			{
-                jr = j + i;
-                ji = j + mh - i;
-                kr = j + mh + i;
-                ki = j + m - i;
-                xr = outbuffer[jr] - outbuffer[ji];
-                xi = outbuffer[ki] + outbuffer[kr];
-                outbuffer[jr] = outbuffer[jr] + outbuffer[ji];
-                outbuffer[ji] = outbuffer[ki] - outbuffer[kr];
-                outbuffer[kr] = rfft_param->wr[rfft_param->Mq_max / mq * i - 1] * xr -
-                    rfft_param->wi[rfft_param->Mq_max / mq * i - 1] * xi;
-                outbuffer[ki] = rfft_param->wr[rfft_param->Mq_max / mq * i - 1] * xi + 
-                    rfft_param->wi[rfft_param->Mq_max / mq * i - 1] * xr;
-            }
-        }
-        /* ---- complex to real butterflies are trivial ---- */
+    /* inverse complex fft as a forward fft with real and imag swapped */
+    if (rfft_param->radix3_flag)
+    {
+        rfft_dif_radix3(im, re, rfft_param->sub_len, rfft_param->tw3);
+    }
+    for (s = rfft_param->stage_num - 1; s >= 0; s--)
+    {
+        rfft_param->dif_pass(im, re, n, rfft_param->stage_h[s], rfft_param->tw + rfft_param->stage_tw[s]);
+    }
+    if (rfft_param->radix2_flag)
+    {
+        rfft_radix2_pass(im, re, n);
     }
 
     /* ---- unscrambler ---- */
-    i = 0;
-    for (j = 1; j < fft_len - 1; j++)
+    rfft_bitrev_permute(rfft_param, outbuffer, outbuffer, 1);
+    return 0;
+#endif
+}
+
+#if DIOS_SSP_FIXED_POINT
+int dios_ssp_share_rfft_process_fix(void *rfft_handle, const int *inbuffer, int *outbuffer, int *exp)
+{
+    if (NULL == rfft_handle || NULL == exp)
 	{
-        for (k = fft_len >> 1; k > (i ^= k); k >>= 1)
-		{
-        }
-        if (j < i)
-		{
-            xr = outbuffer[j];
-            outbuffer[j] = outbuffer[i];
-            outbuffer[i] = xr;
-        }
+        return -1;
+    }
+    RFFT_PARAM *rfft_param;
+    rfft_param = (RFFT_PARAM*)rfft_handle;
+    int k = 0;
+    int s = 0;
+    int n = rfft_param->half_len;
+    int fft_len = rfft_param->fft_len;
+    int *re = outbuffer;
+    int *im = outbuffer + n;
+    int ar, ai, br, bi;
+    int fer, fei, for_, foi;
+    int xr, xi;
+
+    rfft_fix_bitrev_permute(rfft_param, inbuffer, outbuffer, 0);
+
+    if (rfft_param->radix2_flag)
+    {
+        dios_ssp_share_fixed_guard(outbuffer, fft_len, RFFT_FIX_GUARD_RADIX2, exp);
+        rfft_fix_radix2_pass(re, im, n);
+    }
+    for (s = 0; s < rfft_param->stage_num; s++)
+    {
+        dios_ssp_share_fixed_guard(outbuffer, fft_len, RFFT_FIX_GUARD, exp);
+        rfft_fix_dit_radix4(re, im, n, rfft_param->stage_h[s], rfft_param->tw_q + rfft_param->stage_tw[s]);
+    }
+    if (rfft_param->radix3_flag)
+    {
+        dios_ssp_share_fixed_guard(outbuffer, fft_len, RFFT_FIX_GUARD, exp);
+        rfft_fix_dit_radix3(re, im, rfft_param->sub_len, rfft_param->tw3_q);
     }
 
-    for (j = 0; j <= fft_len - 1; j++)
+    /* split step without the 0.5 factors, the output block is scaled by 2
+     * instead, which the exponent takes back */
+    dios_ssp_share_fixed_guard(outbuffer, fft_len, RFFT_FIX_GUARD, exp);
+    ar = re[0];
+    ai = im[0];
+    re[0] = 2 * (ar + ai);
+    im[0] = 2 * (ar - ai);
+    for (k = 1; k <= n / 2; k++)
+    {
+        ar = re[k];
+        ai = im[k];
+        br = re[n - k];
+        bi = im[n - k];
+        fer = ar + br;
+        fei = ai - bi;
+        for_ = ai + bi;
+        foi = br - ar;
+        xr = FIX_CMUL_RE_Q31(for_, foi, rfft_param->wr_q[k], rfft_param->wi_q[k]);
+        xi = FIX_CMUL_IM_Q31(for_, foi, rfft_param->wr_q[k], rfft_param->wi_q[k]);
+        re[k] = fer + xr;
+        im[n - k] = -(fei + xi);
+        re[n - k] = fer - xr;
+        im[k] = fei - xi;
+    }
+    *exp -= 1;
+    return 0;
+}
+
+int dios_ssp_share_irfft_process_fix(void *rfft_handle, const int *inbuffer, int *outbuffer, int *exp)
+{
+    if (NULL == rfft_handle || NULL == exp)
 	{
-        /*a[j] *= 2.0 / fft_len;*/    /* <=== Default */
-        outbuffer[j] *= 2.0;            /* <=== use for SubBand. */
+        return -1;
+    }
+    RFFT_PARAM *rfft_param;
+    rfft_param = (RFFT_PARAM*)rfft_handle;
+    int k = 0;
+    int s = 0;
+    int n = rfft_param->half_len;
+    int fft_len = rfft_param->fft_len;
+    int *re = outbuffer;
+    int *im = outbuffer + n;
+    int xr, xi, yr, yi;
+    int ar, ai, br, bi, vr, vi;
+
+    /* the merge step reads and writes the same four points per k, so it runs
+     * in place once the block has its headroom */
+    if (inbuffer != outbuffer)
+    {
+        memcpy(outbuffer, inbuffer, fft_len * sizeof(int));
     }
+    dios_ssp_share_fixed_guard(outbuffer, fft_len, RFFT_FIX_GUARD, exp);
+    xr = outbuffer[0];
+    yr = outbuffer[n];
+    re[0] = xr + yr;
+    im[0] = xr - yr;
+    for (k = 1; k <= n / 2; k++)
+    {
+        xr = outbuffer[k];
+        xi = -outbuffer[fft_len - k];
+        yr = outbuffer[n - k];
+        yi = -outbuffer[n + k];
+        ar = xr + yr;
+        ai = xi - yi;
+        br = xr - yr;
+        bi = xi + yi;
+        vr = FIX_CMUL_RE_Q31(br, bi, rfft_param->wr_q[k], -rfft_param->wi_q[k]);
+        vi = FIX_CMUL_IM_Q31(br, bi, rfft_param->wr_q[k], -rfft_param->wi_q[k]);
+        re[k] = ar - vi;
+        im[k] = ai + vr;
+        re[n - k] = ar + vi;
+        im[n - k] = vr - ai;
+    }
+
+    if (rfft_param->radix3_flag)
+    {
+        dios_ssp_share_fixed_guard(outbuffer, fft_len, RFFT_FIX_GUARD, exp);
+        rfft_fix_dif_radix3(im, re, rfft_param->sub_len, rfft_param->tw3_q);
+    }
+    for (s = rfft_param->stage_num - 1; s >= 0; s--)
+    {
+        dios_ssp_share_fixed_guard(outbuffer, fft_len, RFFT_FIX_GUARD, exp);
+        rfft_fix_dif_radix4(im, re, n, rfft_param->stage_h[s], rfft_param->tw_q + rfft_param->stage_tw[s]);
+    }
+    if (rfft_param->radix2_flag)
+    {
+        dios_ssp_share_fixed_guard(outbuffer, fft_len, RFFT_FIX_GUARD_RADIX2, exp);
+        rfft_fix_radix2_pass(im, re, n);
+    }
+
+    rfft_fix_bitrev_permute(rfft_param, outbuffer, outbuffer, 1);
     return 0;
 }
+#endif
 
 int dios_ssp_share_rfft_uninit(void *rfft_handle)
 {
@@ -229,10 +1196,12 @@ int dios_ssp_share_rfft_uninit(void *rfft_handle)
 	}
     RFFT_PARAM *rfft_param;
     rfft_param = (RFFT_PARAM*)rfft_handle;
-    free(rfft_param->wi);
-    free(rfft_param->wr);
-    free(rfft_param);
+    dios_ssp_share_table_release(rfft_param->table_pool, rfft_param->table);
+    dios_ssp_share_free(rfft_param->scratch);
+#if DIOS_SSP_FIXED_POINT
+    dios_ssp_share_free(rfft_param->fix_buf);
+#endif
+    dios_ssp_share_free(rfft_param);
 
 	return 0;
 }
-
@@ -20,25 +20,47 @@ limitations under the License.
 #include <stdlib.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 #include "../dios_ssp_aec/dios_ssp_aec_macros.h"
 #include "./dios_ssp_share_complex_defs.h"
+#include "./dios_ssp_share_table.h"
+#include "./dios_ssp_share_fixed.h"
 
 /**********************************************************************************
 Function:      // dios_ssp_share_rfft_init
-Description:   // rfft init
-Input:         // fft_len: fft length
+Description:   // rfft init, the instance has its own twiddle tables
+Input:         // fft_len: fft length, must be 2^k or 3 * 2^k
 Output:        // none
 Return:        // success: return dios speech signal process rfft pointer
 	              failure: return NULL
 **********************************************************************************/
 void *dios_ssp_share_rfft_init(int fft_len);    
 
+/**********************************************************************************
+Function:      // dios_ssp_share_rfft_init_pool
+Description:   // rfft init with the twiddle tables taken from a table pool
+Input:         // fft_len: fft length, must be 2^k or 3 * 2^k
+                  table_pool: pool the twiddle tables are shared through, NULL
+                              gives the instance its own tables
+Output:        // none
+Return:        // success: return dios speech signal process rfft pointer
+	              failure: return NULL
+**********************************************************************************/
+void *dios_ssp_share_rfft_init_pool(int fft_len, void *table_pool);
+
 /**********************************************************************************
 Function:      // dios_ssp_share_rfft_process
 Description:   // run dios speech signal process rfft module by frames
+                  outbuffer[k] = Re(X[k]), k = 0 ~ fft_len/2
+                  outbuffer[fft_len - k] = -Im(X[k]), k = 1 ~ fft_len/2-1
+                  compared with the former radix-2 implementation, the maximum
+                  absolute difference is below 1e-6 of the peak spectrum value
+                  (float rounding only), and all SIMD kernels give bit-identical
+                  results with the scalar one
 Input:         // rfft_handle: dios speech signal process rfft pointer
 	              inbuffer: input data in time domain, data type is float
-Output:        // outbuffer: output data in frequency domain, data type is float
+Output:        // outbuffer: output data in frequency domain, data type is float,
+                  it may be the same buffer as inbuffer
 Return:        // success: return 0, failure: return -1
 **********************************************************************************/
 int dios_ssp_share_rfft_process(void *rfft_handle, float *inbuffer, float *outbuffer);
@@ -46,13 +68,52 @@ int dios_ssp_share_rfft_process(void *rfft_handle, float *inbuffer, float *outbu
 /**********************************************************************************
 Function:      // dios_ssp_share_irfft_process
 Description:   // run dios speech signal process irfft module by frames
+                  input layout is the same as dios_ssp_share_rfft_process, output
+                  is scaled by fft_len, i.e. irfft(rfft(x)) = fft_len * x
+                  the maximum absolute difference with the former implementation
+                  is below 1e-6 of the peak output value
 Input:         // rfft_handle: dios speech signal process rfft pointer
 	              inbuffer: input data in frequency domain, data type is float
-Output:        // outbuffer: output data in time domain, data type is float
+Output:        // outbuffer: output data in time domain, data type is float,
+                  it may be the same buffer as inbuffer
 Return:        // success: return 0, failure: return -1
 **********************************************************************************/
 int dios_ssp_share_irfft_process(void *rfft_handle, float *inbuffer, float *outbuffer);
 
+#if DIOS_SSP_FIXED_POINT
+/**********************************************************************************
+Function:      // dios_ssp_share_rfft_process_fix
+Description:   // fixed-point rfft of a block, with Q31 twiddles and block floating
+                  point: before every butterfly stage the block is shifted right
+                  just enough to leave the headroom that stage can grow into.
+                  the output layout is the same as dios_ssp_share_rfft_process,
+                  which in the fixed-point build is a wrapper of this function
+Input:         // rfft_handle: dios speech signal process rfft pointer
+                  inbuffer: input block in time domain
+                  exp: exponent of inbuffer, value = inbuffer[i] * 2^exp
+Output:        // outbuffer: output block in frequency domain, it may be the same
+                  buffer as inbuffer
+                  exp: exponent of outbuffer
+Return:        // success: return 0, failure: return -1
+**********************************************************************************/
+int dios_ssp_share_rfft_process_fix(void *rfft_handle, const int *inbuffer, int *outbuffer, int *exp);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_irfft_process_fix
+Description:   // fixed-point irfft of a block, the counterpart of
+                  dios_ssp_share_rfft_process_fix, scaled by fft_len like
+                  dios_ssp_share_irfft_process
+Input:         // rfft_handle: dios speech signal process rfft pointer
+                  inbuffer: input block in frequency domain
+                  exp: exponent of inbuffer
+Output:        // outbuffer: output block in time domain, it may be the same
+                  buffer as inbuffer
+                  exp: exponent of outbuffer
+Return:        // success: return 0, failure: return -1
+**********************************************************************************/
+int dios_ssp_share_irfft_process_fix(void *rfft_handle, const int *inbuffer, int *outbuffer, int *exp);
+#endif
+
 /**********************************************************************************
 Function:      // dios_ssp_share_rfft_uninit
 Description:   // free dios speech signal process rfft module
@@ -24,6 +24,9 @@ limitations under the License.
 
 typedef struct {
 	int frm_len;
+	int fft_len;  // 2 * frm_len
+	int win_len;  // prototype filter length, 3 * fft_len
+	int sub_num;  // fft_len / 2 + 1
 	int Ppf_tap; // WIN_LEN/FFT_LEN
 	int Ppf_decm;
 	int *p_in;
@@ -35,21 +38,44 @@ typedef struct {
 
 	float *comp_in;  // time domain data input for compose
 	float *comp_out; // data output for compose
-	float* lpf_coef;
+	void *table_pool;
+	const float *lpf_coef;  // prototype lowpass, shared through table_pool
 	void *rfft_param;
 	float *fftout_buffer;
 	float *fftin_buffer;
+#if DIOS_SSP_FIXED_POINT
+	int lpf_frac;            // lpf_fix = lpf_coef * 2^lpf_frac
+	const int *lpf_fix;      // prototype lowpass in fixed point, shared through table_pool
+	int *ana_xin_fix;        // ana_xin in Q SUBBAND_FIX_IN_FRAC
+	long long *ana_acc;      // polyphase sums of one frame before block scaling
+	int *fft_fix;            // fft block
+	int *comp_out_fix;       // comp_out in Q SUBBAND_FIX_OUT_FRAC
+#endif
 }objSubBand;
 
 /**********************************************************************************
 Function:      // dios_ssp_share_subband_init
-Description:   // subband init
-Input:         // frm_len: frame length
+Description:   // subband init, the instance has its own prototype filter and fft
+                  tables
+Input:         // frm_len: frame length, the fft length is 2 * frm_len
 Output:        // none
 Return:        // success: return dios speech signal process subband pointer
 	              failure: return NULL
 **********************************************************************************/
 objSubBand* dios_ssp_share_subband_init(int frm_len);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_subband_init_pool
+Description:   // subband init with the prototype filter and fft tables taken from
+                  a table pool
+Input:         // frm_len: frame length, the fft length is 2 * frm_len
+                  table_pool: pool the prototype filter and fft tables are shared
+                              through, NULL gives the instance its own tables
+Output:        // none
+Return:        // success: return dios speech signal process subband pointer
+	              failure: return NULL
+**********************************************************************************/
+objSubBand* dios_ssp_share_subband_init_pool(int frm_len, void *table_pool);
 	
 /**********************************************************************************
 Function:      // dios_ssp_share_subband_reset
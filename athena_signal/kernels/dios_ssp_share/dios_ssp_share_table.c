@@ -0,0 +1,256 @@
+/* Copyright (C) 2017 Beijing Didi Infinity Technology and Development Co.,Ltd.
+All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Description: Pool of read-only tables shared by several instances. The entry
+header and the table are one allocation, the table starts at the first
+SHARE_TABLE_ALIGN boundary after the header and the word in front of it points
+back to the header, so a table pointer is all release needs.
+==============================================================================*/
+
+#include "dios_ssp_share_table.h"
+
+static void dios_ssp_share_table_free(int pooled, objShareTableEntry *entry)
+{
+	if (pooled)
+	{
+		free(entry->key);
+		free(entry);
+	}
+	else
+	{
+		dios_ssp_share_free(entry->key);
+		dios_ssp_share_free(entry);
+	}
+}
+
+/* private tables belong to their instance and come from its memory, pooled
+   ones outlive the instance building them and always come from the heap */
+static objShareTableEntry *dios_ssp_share_table_alloc(int pooled, const char *name, const void *key, int key_len, size_t size)
+{
+	objShareTableEntry *entry;
+	size_t addr;
+	size_t bytes = sizeof(objShareTableEntry) + sizeof(void*) + SHARE_TABLE_ALIGN + size;
+	size_t ptr[4];
+
+	if (pooled)
+	{
+		entry = (objShareTableEntry*)calloc(1, bytes);
+	}
+	else
+	{
+		/* an arena block starts on SHARE_ARENA_ALIGN, so the pointer back to
+		   the entry is at the same offset in every instance */
+		ptr[0] = offsetof(objShareTableEntry, next);
+		ptr[1] = offsetof(objShareTableEntry, key);
+		ptr[2] = offsetof(objShareTableEntry, table);
+		ptr[3] = ((sizeof(objShareTableEntry) + sizeof(void*) + SHARE_TABLE_ALIGN - 1)
+			& ~(size_t)(SHARE_TABLE_ALIGN - 1)) - sizeof(void*);
+		entry = (objShareTableEntry*)dios_ssp_share_calloc_map(1, bytes, ptr, 4);
+	}
+	if (entry == NULL)
+	{
+		return NULL;
+	}
+	addr = (size_t)(entry + 1) + sizeof(void*);
+	addr = (addr + SHARE_TABLE_ALIGN - 1) & ~(size_t)(SHARE_TABLE_ALIGN - 1);
+	entry->table = (void*)addr;
+	((objShareTableEntry**)entry->table)[-1] = entry;
+	strncpy(entry->name, name, SHARE_TABLE_NAME_LEN - 1);
+	entry->size = size;
+	entry->key_len = key_len;
+	if (key_len > 0)
+	{
+		entry->key = pooled ? malloc(key_len) : dios_ssp_share_calloc(1, key_len);
+		if (entry->key == NULL)
+		{
+			dios_ssp_share_table_free(pooled, entry);
+			return NULL;
+		}
+		memcpy(entry->key, key, key_len);
+	}
+
+	return entry;
+}
+
+static void dios_ssp_share_table_lock(objShareTablePool *pool)
+{
+#ifndef DIOS_SSP_NO_THREADS
+	pthread_mutex_lock(&pool->mutex);
+#endif
+}
+
+static void dios_ssp_share_table_unlock(objShareTablePool *pool)
+{
+#ifndef DIOS_SSP_NO_THREADS
+	pthread_mutex_unlock(&pool->mutex);
+#endif
+}
+
+void *dios_ssp_share_table_init(void)
+{
+	objShareTablePool *pool = (objShareTablePool*)calloc(1, sizeof(objShareTablePool));
+	if (pool == NULL)
+	{
+		return NULL;
+	}
+#ifndef DIOS_SSP_NO_THREADS
+	pthread_mutex_init(&pool->mutex, NULL);
+#endif
+
+	return pool;
+}
+
+void *dios_ssp_share_table_get(void *pool, const char *name, const void *key, int key_len,
+							   size_t size, ShareTableBuild build, const void *arg)
+{
+	objShareTablePool *srv = (objShareTablePool*)pool;
+	objShareTableEntry *entry;
+
+	if (name == NULL || build == NULL || key_len < 0 || (key_len > 0 && key == NULL))
+	{
+		return NULL;
+	}
+	if (srv == NULL)
+	{
+		entry = dios_ssp_share_table_alloc(0, name, key, key_len, size);
+		if (entry == NULL || 0 != build(entry->table, arg))
+		{
+			if (entry != NULL)
+			{
+				dios_ssp_share_table_free(0, entry);
+			}
+			return NULL;
+		}
+		return entry->table;
+	}
+
+	dios_ssp_share_table_lock(srv);
+	for (entry = srv->head; entry != NULL; entry = entry->next)
+	{
+		if (entry->size == size && entry->key_len == key_len
+			&& 0 == strncmp(entry->name, name, SHARE_TABLE_NAME_LEN - 1)
+			&& (key_len == 0 || 0 == memcmp(entry->key, key, key_len)))
+		{
+			entry->ref_num++;
+			dios_ssp_share_table_unlock(srv);
+			dios_ssp_share_arena_ref(entry->table, size);
+			return entry->table;
+		}
+	}
+
+	entry = dios_ssp_share_table_alloc(1, name, key, key_len, size);
+	if (entry == NULL || 0 != build(entry->table, arg))
+	{
+		if (entry != NULL)
+		{
+			dios_ssp_share_table_free(1, entry);
+		}
+		dios_ssp_share_table_unlock(srv);
+		return NULL;
+	}
+	entry->ref_num = 1;
+	entry->next = srv->head;
+	srv->head = entry;
+	srv->table_num++;
+	srv->table_bytes += size;
+	dios_ssp_share_table_unlock(srv);
+	dios_ssp_share_arena_ref(entry->table, size);
+
+	return entry->table;
+}
+
+int dios_ssp_share_table_release(void *pool, const void *table)
+{
+	objShareTablePool *srv = (objShareTablePool*)pool;
+	objShareTableEntry *entry;
+	objShareTableEntry **prev;
+
+	if (table == NULL)
+	{
+		return 0;
+	}
+	entry = ((objShareTableEntry* const*)table)[-1];
+	if (srv == NULL)
+	{
+		dios_ssp_share_table_free(0, entry);
+		return 0;
+	}
+
+	dios_ssp_share_table_lock(srv);
+	for (prev = &srv->head; *prev != NULL && *prev != entry; prev = &(*prev)->next)
+	{
+	}
+	if (*prev == NULL)
+	{
+		dios_ssp_share_table_unlock(srv);
+		return -1;
+	}
+	entry->ref_num--;
+	if (entry->ref_num == 0)
+	{
+		*prev = entry->next;
+		srv->table_num--;
+		srv->table_bytes -= entry->size;
+		dios_ssp_share_table_free(1, entry);
+	}
+	dios_ssp_share_table_unlock(srv);
+
+	return 0;
+}
+
+size_t dios_ssp_share_table_bytes(void *pool, int *table_num)
+{
+	objShareTablePool *srv = (objShareTablePool*)pool;
+	size_t bytes;
+
+	if (srv == NULL)
+	{
+		if (table_num != NULL)
+		{
+			*table_num = 0;
+		}
+		return 0;
+	}
+	dios_ssp_share_table_lock(srv);
+	bytes = srv->table_bytes;
+	if (table_num != NULL)
+	{
+		*table_num = srv->table_num;
+	}
+	dios_ssp_share_table_unlock(srv);
+
+	return bytes;
+}
+
+int dios_ssp_share_table_uninit(void *pool)
+{
+	objShareTablePool *srv = (objShareTablePool*)pool;
+
+	if (srv == NULL)
+	{
+		return -1;
+	}
+	if (srv->head != NULL)
+	{
+		printf("table pool still holds %d tables in use!\n", srv->table_num);
+		return -1;
+	}
+#ifndef DIOS_SSP_NO_THREADS
+	pthread_mutex_destroy(&srv->mutex);
+#endif
+	free(srv);
+
+	return 0;
+}
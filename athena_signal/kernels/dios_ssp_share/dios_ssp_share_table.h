@@ -0,0 +1,116 @@
+/* Copyright (C) 2017 Beijing Didi Infinity Technology and Development Co.,Ltd.
+All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Description: Pool of read-only tables shared by several instances. A table is
+identified by its name and a key built from the configuration it depends on,
+the first instance asking for it builds it and the later ones get the same
+memory. Tables are reference counted and freed with their last user.
+==============================================================================*/
+
+#ifndef _DIOS_SSP_SHARE_TABLE_H_
+#define _DIOS_SSP_SHARE_TABLE_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dios_ssp_share_workpool.h"
+#include "dios_ssp_share_arena.h"
+
+#define SHARE_TABLE_NAME_LEN	(16)
+#define SHARE_TABLE_ALIGN		(64)
+
+/* fills the zeroed table, return 0 on success */
+typedef int (*ShareTableBuild)(void *table, const void *arg);
+
+typedef struct objShareTableEntry_
+{
+	struct objShareTableEntry_ *next;
+	char name[SHARE_TABLE_NAME_LEN];
+	void *key;
+	int key_len;
+	size_t size;
+	int ref_num;
+	void *table;
+}objShareTableEntry;
+
+typedef struct
+{
+	objShareTableEntry *head;
+	int table_num;
+	size_t table_bytes;
+#ifndef DIOS_SSP_NO_THREADS
+	pthread_mutex_t mutex;
+#endif
+}objShareTablePool;
+
+/**********************************************************************************
+Function:      // dios_ssp_share_table_init
+Description:   // create an empty table pool
+Input:         // none
+Output:        // none
+Return:        // success: return table pool pointer
+                  failure: return NULL
+**********************************************************************************/
+void *dios_ssp_share_table_init(void);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_table_get
+Description:   // get the table of name and key, build it with build(table, arg)
+                  if the pool does not hold it yet. the pool is locked during
+                  the build, so build must not get tables of the same pool
+Input:         // pool: table pool pointer, NULL builds a private table
+                  name: table name, at most SHARE_TABLE_NAME_LEN-1 characters
+                  key: bytes the table content depends on, must not contain
+                       padding, e.g. an array of int or float
+                  key_len: key length in bytes
+                  size: table size in bytes
+                  build: function filling the table
+                  arg: argument of build
+Output:        // none
+Return:        // success: return table pointer, aligned to SHARE_TABLE_ALIGN
+                  failure: return NULL
+**********************************************************************************/
+void *dios_ssp_share_table_get(void *pool, const char *name, const void *key, int key_len,
+							   size_t size, ShareTableBuild build, const void *arg);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_table_release
+Description:   // drop one reference of a table returned by dios_ssp_share_table_get
+Input:         // pool: table pool pointer the table was got from
+                  table: table pointer, NULL is ignored
+Output:        // none
+Return:        // success: return 0, failure: return -1
+**********************************************************************************/
+int dios_ssp_share_table_release(void *pool, const void *table);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_table_bytes
+Description:   // memory held by the tables of the pool
+Input:         // pool: table pool pointer
+Output:        // table_num: number of tables, may be NULL
+Return:        // bytes of all tables
+**********************************************************************************/
+size_t dios_ssp_share_table_bytes(void *pool, int *table_num);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_table_uninit
+Description:   // free the pool, all tables must have been released
+Input:         // pool: table pool pointer
+Output:        // none
+Return:        // success: return 0, failure: return -1 if tables are still in use
+**********************************************************************************/
+int dios_ssp_share_table_uninit(void *pool);
+
+#endif /* _DIOS_SSP_SHARE_TABLE_H_ */
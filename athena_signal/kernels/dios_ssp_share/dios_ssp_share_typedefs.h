@@ -40,6 +40,14 @@ typedef struct {
 	float  theta;      ///< vertical angle (Radian), value range from 0 to PI
 } PolarCoord;
 
+typedef struct
+{
+	float	angle;			//	direction in degrees, 0 ~ 360
+	float	elevation;		//	degrees above the x-y plane, -90 ~ 90, 0 for azimuth only
+	float	confidence;		//	0 ~ 1, how much the source stands out of the spatial spectrum
+	int		id;				//	kept as long as the source is tracked
+} DoaSource;
+
 typedef struct
 {
 	int nIndexR;	//	the index of the right microphone (when speak faces to array)
@@ -0,0 +1,172 @@
+/* Copyright (C) 2017 Beijing Didi Infinity Technology and Development Co.,Ltd.
+All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+Description: Persistent worker thread pool. Modules with independent per 
+channel or per beam work (e.g. multi-beam GSC) submit one batch of tasks per 
+frame, the threads are created once at init so no thread is started on the
+processing path.
+==============================================================================*/
+
+#include "dios_ssp_share_workpool.h"
+#include "dios_ssp_share_arena.h"
+
+#ifndef DIOS_SSP_NO_THREADS
+static void *dios_ssp_share_workpool_thread(void *ptr)
+{
+	objWorkpool *pool = (objWorkpool*)ptr;
+	unsigned long generation = 0;
+	int idx;
+
+	pthread_mutex_lock(&pool->mutex);
+	while (1)
+	{
+		while (pool->generation == generation && !pool->quit)
+		{
+			pthread_cond_wait(&pool->start_cond, &pool->mutex);
+		}
+		if (pool->quit)
+		{
+			break;
+		}
+		generation = pool->generation;
+		while (pool->next_task < pool->task_num)
+		{
+			idx = pool->next_task++;
+			pthread_mutex_unlock(&pool->mutex);
+			pool->task(pool->arg, idx);
+			pthread_mutex_lock(&pool->mutex);
+		}
+		pool->busy_num--;
+		if (pool->busy_num == 0)
+		{
+			pthread_cond_signal(&pool->done_cond);
+		}
+	}
+	pthread_mutex_unlock(&pool->mutex);
+
+	return NULL;
+}
+#endif
+
+void *dios_ssp_share_workpool_init(int thread_num)
+{
+	if (thread_num < 1 || thread_num > WORKPOOL_MAX_THREADS)
+	{
+		printf("workpool thread number %d is not supported!\n", thread_num);
+		return NULL;
+	}
+
+	objWorkpool *pool = (objWorkpool*)dios_ssp_share_calloc(1, sizeof(objWorkpool));
+	/* thread handles and sync objects belong to this process, not to a saved state */
+	dios_ssp_share_arena_hole(pool, sizeof(objWorkpool));
+#ifdef DIOS_SSP_NO_THREADS
+	pool->thread_num = 0;
+#else
+	int i;
+	pool->thread_num = thread_num - 1;
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->start_cond, NULL);
+	pthread_cond_init(&pool->done_cond, NULL);
+	if (pool->thread_num > 0)
+	{
+		pool->threads = (pthread_t*)dios_ssp_share_calloc(pool->thread_num, sizeof(pthread_t));
+		dios_ssp_share_arena_hole(pool->threads, pool->thread_num * sizeof(pthread_t));
+		for (i = 0; i < pool->thread_num; i++)
+		{
+			if (0 != pthread_create(&pool->threads[i], NULL, dios_ssp_share_workpool_thread, pool))
+			{
+				/* run with the threads created so far */
+				printf("workpool only created %d of %d threads!\n", i, pool->thread_num);
+				pool->thread_num = i;
+				break;
+			}
+		}
+	}
+#endif
+
+	return pool;
+}
+
+int dios_ssp_share_workpool_run(void *workpool, WorkpoolTask task, void *arg, int task_num)
+{
+	objWorkpool *pool = (objWorkpool*)workpool;
+	int idx;
+
+	if (task == NULL || task_num < 0)
+	{
+		return -1;
+	}
+	if (pool == NULL || pool->thread_num == 0 || task_num == 1)
+	{
+		for (idx = 0; idx < task_num; idx++)
+		{
+			task(arg, idx);
+		}
+		return 0;
+	}
+
+#ifndef DIOS_SSP_NO_THREADS
+	pthread_mutex_lock(&pool->mutex);
+	pool->task = task;
+	pool->arg = arg;
+	pool->task_num = task_num;
+	pool->next_task = 0;
+	pool->busy_num = pool->thread_num;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->start_cond);
+	while (pool->next_task < pool->task_num)
+	{
+		idx = pool->next_task++;
+		pthread_mutex_unlock(&pool->mutex);
+		task(arg, idx);
+		pthread_mutex_lock(&pool->mutex);
+	}
+	while (pool->busy_num > 0)
+	{
+		pthread_cond_wait(&pool->done_cond, &pool->mutex);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+#endif
+
+	return 0;
+}
+
+int dios_ssp_share_workpool_uninit(void *workpool)
+{
+	objWorkpool *pool = (objWorkpool*)workpool;
+	if (pool == NULL)
+	{
+		return -1;
+	}
+
+#ifndef DIOS_SSP_NO_THREADS
+	int i;
+	pthread_mutex_lock(&pool->mutex);
+	pool->quit = 1;
+	pthread_cond_broadcast(&pool->start_cond);
+	pthread_mutex_unlock(&pool->mutex);
+	for (i = 0; i < pool->thread_num; i++)
+	{
+		pthread_join(pool->threads[i], NULL);
+	}
+	dios_ssp_share_free(pool->threads);
+	pthread_mutex_destroy(&pool->mutex);
+	pthread_cond_destroy(&pool->start_cond);
+	pthread_cond_destroy(&pool->done_cond);
+#endif
+	dios_ssp_share_free(pool);
+
+	return 0;
+}
@@ -0,0 +1,90 @@
+/* Copyright (C) 2017 Beijing Didi Infinity Technology and Development Co.,Ltd.
+All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef _DIOS_SSP_SHARE_WORKPOOL_H_
+#define _DIOS_SSP_SHARE_WORKPOOL_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* there is no pthread on windows, the pool then runs all tasks on the caller */
+#if defined(_WIN32) && !defined(DIOS_SSP_NO_THREADS)
+#define DIOS_SSP_NO_THREADS
+#endif
+
+#ifndef DIOS_SSP_NO_THREADS
+#include <pthread.h>
+#endif
+
+#define WORKPOOL_MAX_THREADS	(32)
+
+typedef void (*WorkpoolTask)(void *arg, int idx);
+
+typedef struct
+{
+	int thread_num;
+#ifndef DIOS_SSP_NO_THREADS
+	pthread_t *threads;
+	pthread_mutex_t mutex;
+	pthread_cond_t start_cond;
+	pthread_cond_t done_cond;
+	unsigned long generation;
+	int quit;
+	WorkpoolTask task;
+	void *arg;
+	int task_num;
+	int next_task;
+	int busy_num;
+#endif
+}objWorkpool;
+
+/**********************************************************************************
+Function:      // dios_ssp_share_workpool_init
+Description:   // create a pool of persistent worker threads, the threads sleep
+                  until a batch of tasks is submitted
+Input:         // thread_num: number of threads working on a batch including the
+                  caller, 1 means no worker thread is created
+Output:        // none
+Return:        // success: return workpool pointer
+                  failure: return NULL
+**********************************************************************************/
+void *dios_ssp_share_workpool_init(int thread_num);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_workpool_run
+Description:   // run task(arg, idx) for idx = 0 ~ task_num-1 on the pool and the
+                  calling thread, return when all of them are finished. tasks
+                  must not write any data shared with other tasks, then the
+                  result does not depend on the thread number or on scheduling
+Input:         // workpool: workpool pointer, NULL runs all tasks on the caller
+                  task: task function
+                  arg: argument passed to every task
+                  task_num: number of tasks
+Output:        // none
+Return:        // success: return 0, failure: return -1
+**********************************************************************************/
+int dios_ssp_share_workpool_run(void *workpool, WorkpoolTask task, void *arg, int task_num);
+
+/**********************************************************************************
+Function:      // dios_ssp_share_workpool_uninit
+Description:   // stop the worker threads and free the pool
+Input:         // workpool: workpool pointer
+Output:        // none
+Return:        // success: return 0, failure: return -1
+**********************************************************************************/
+int dios_ssp_share_workpool_uninit(void *workpool);
+
+#endif /* _DIOS_SSP_SHARE_WORKPOOL_H_ */
@@ -22,6 +22,7 @@ speech state based on the result of the double-talk detection.
 ==============================================================================*/
 
 #include "dios_ssp_vad_api.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
 typedef struct {
 	void* energy_vad_ptr;
@@ -35,14 +36,19 @@ typedef struct {
 	int vad_stric_result;
 } objVadProcess;
 
-void* dios_ssp_vad_init_api(void)
+static const size_t g_vad_ptr[] = {
+	offsetof(objVadProcess, energy_vad_ptr), offsetof(objVadProcess, vad_counter_ptr),
+	offsetof(objVadProcess, vad_counter_stric_ptr)
+};
+
+void* dios_ssp_vad_init_api(int sample_rate, void* table_pool)
 {
 	void* ptr_vad = NULL;
 	objVadProcess *srv;
-	ptr_vad = (void*)calloc(1, sizeof(objVadProcess));
+	ptr_vad = (void*)dios_ssp_share_calloc_map(1, sizeof(objVadProcess), g_vad_ptr, SHARE_ARENA_MAP_NUM(g_vad_ptr));
 	srv = (objVadProcess *)ptr_vad;
 
-    srv->energy_vad_ptr = dios_ssp_energy_vad_init(0);
+    srv->energy_vad_ptr = dios_ssp_energy_vad_init(0, sample_rate, table_pool);
 	if(srv->energy_vad_ptr == NULL)
     {
 		return NULL;
@@ -161,7 +167,7 @@ int dios_ssp_vad_uninit_api(void* ptr_vad)
 	dios_ssp_energy_vad_uninit(srv->energy_vad_ptr);
 	dios_ssp_vad_counter_uinit(srv->vad_counter_ptr);
 	dios_ssp_vad_counter_uinit(srv->vad_counter_stric_ptr);
-	free(srv);
+	dios_ssp_share_free(srv);
 
 	return 0;
 }
@@ -27,12 +27,14 @@ limitations under the License.
 /**********************************************************************************
 Function:      // dios_ssp_vad_init_api
 Description:   // init vad module
-Input:         // none
+Input:         // sample_rate: sampling rate in Hz, one frame is sample_rate / 125
+                  table_pool: pool of read-only tables shared with other 
+                  instances, NULL for private tables
 Output:        // none
 Return:        // success: return vad module pointer
                   failure: return NULL
 **********************************************************************************/
-void* dios_ssp_vad_init_api(void);
+void* dios_ssp_vad_init_api(int sample_rate, void* table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_vad_reset_api
@@ -17,6 +17,7 @@ Description: subfunctions of the VAD module
 ==============================================================================*/
 
 #include "dios_ssp_vad_counter.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
 const int VAD_CERTAINTY_COUNTER_LENGTH = 10;
 const float CERTAINTY_SMOOTH_RATE = 0.9857f;
@@ -64,22 +65,26 @@ void dios_ssp_vad_mix_process_subfunc(VAD_COUNTER *srv, float signaldev, float h
 		srv->cnt_index_cert++;
 }
 
+static const size_t g_vad_counter_ptr[] = {
+	offsetof(VAD_COUNTER, certainty_buff), offsetof(VAD_COUNTER, false_alarm_buff)
+};
+
 void* dios_ssp_vad_counter_init(void)
 {
 	void* vad_counter_handle = NULL;
 	VAD_COUNTER *srv;
-	vad_counter_handle = (void*)calloc(1, sizeof(VAD_COUNTER));
+	vad_counter_handle = (void*)dios_ssp_share_calloc_map(1, sizeof(VAD_COUNTER), g_vad_counter_ptr, SHARE_ARENA_MAP_NUM(g_vad_counter_ptr));
 	srv = (VAD_COUNTER *)vad_counter_handle;
 	srv->vad_certainty_counter_length = VAD_CERTAINTY_COUNTER_LENGTH;
 	srv->certainty_buff = NULL;
-	srv->certainty_buff = (float*)calloc(srv->vad_certainty_counter_length, sizeof(float));
+	srv->certainty_buff = (float*)dios_ssp_share_calloc(srv->vad_certainty_counter_length, sizeof(float));
 	srv->cnt_index_cert = 0;
 	srv->vad_certainty_cnt = 0;
 	srv->vad_certainty_cnt_thld = CERTAINTY_SUM_THRESH;
 
 	srv->vad_false_counter_length = VAD_FALSE_COUNTER_LENGTH;
 	srv->false_alarm_buff = NULL;
-	srv->false_alarm_buff = (float*)calloc(srv->vad_false_counter_length, sizeof(float));
+	srv->false_alarm_buff = (float*)dios_ssp_share_calloc(srv->vad_false_counter_length, sizeof(float));
 	srv->cnt_index_fals = 0;
 	srv->false_alarm_cnt = 0;
 
@@ -458,8 +463,8 @@ void dios_ssp_vad_counter_uinit(void* vad_counter_handle)
 	VAD_COUNTER *srv;
 	srv = (VAD_COUNTER *)vad_counter_handle;
 
-	free(srv->certainty_buff);
-	free(srv->false_alarm_buff);
-	free(srv);
+	dios_ssp_share_free(srv->certainty_buff);
+	dios_ssp_share_free(srv->false_alarm_buff);
+	dios_ssp_share_free(srv);
 }
 
@@ -25,14 +25,16 @@ energy.
 #include "../dios_ssp_share/dios_ssp_share_noiselevel.h"
 #include "../dios_ssp_share/dios_ssp_share_rfft.h"
 #include "dios_ssp_vad_macros.h"
+#include "../dios_ssp_share/dios_ssp_share_arena.h"
 
-#define FRM_LEN 128  
+#define FRM_LEN 128  /* at VAD_SAMPLE_RATE */
 #define NUM_CHAN 20
 #define VM_SIZE 90
 #define TRUE    1
 #define FALSE   0
 
 typedef struct {
+	int frm_len;              // frame length, 8ms
 	int delay;                // 128 the overlap (or delay) in samples
 	int fft_len;              // FFT length
 	int lo_chan;              // the index of low channel
@@ -136,13 +138,25 @@ typedef struct {
 	int vad_result_stric;
 } objENERGYVAD;
 
-void* dios_ssp_energy_vad_init(int vad_type)
+static const size_t g_energyvad_ptr[] = {
+	offsetof(objENERGYVAD, window_overlap), offsetof(objENERGYVAD, ch_enrg_long_db),
+	offsetof(objENERGYVAD, ch_energy), offsetof(objENERGYVAD, ch_energy_db),
+	offsetof(objENERGYVAD, ch_noise), offsetof(objENERGYVAD, ch_snr),
+	offsetof(objENERGYVAD, in_buffer), offsetof(objENERGYVAD, out_buffer),
+	offsetof(objENERGYVAD, window_coef), offsetof(objENERGYVAD, data_buffer),
+	offsetof(objENERGYVAD, energyvad_noise_est), offsetof(objENERGYVAD, rfft_param),
+	offsetof(objENERGYVAD, vad_fftbuf_in), offsetof(objENERGYVAD, vad_fft_out),
+	offsetof(objENERGYVAD, vad_fftbuf_out)
+};
+
+void* dios_ssp_energy_vad_init(int vad_type, int sample_rate, void* table_pool)
 {
     void* energyvad_ptr = NULL;
     objENERGYVAD *vad_param;
     int j = 0;
-    energyvad_ptr = (void*)calloc(1, sizeof(objENERGYVAD));
+    energyvad_ptr = (void*)dios_ssp_share_calloc_map(1, sizeof(objENERGYVAD), g_energyvad_ptr, SHARE_ARENA_MAP_NUM(g_energyvad_ptr));
     vad_param = (objENERGYVAD *)energyvad_ptr;
+    vad_param->frm_len = FRM_LEN * sample_rate / VAD_SAMPLE_RATE;
     if (vad_type == 0) 
     {
         vad_param->update_thld = 2.3f;
@@ -165,8 +179,8 @@ void* dios_ssp_energy_vad_init(int vad_type)
 	vad_param->no_voice_count_stric = 0;
 	vad_param->vad_result_stric = 0;
 
-	vad_param->delay = 128;
-	vad_param->fft_len = 256;
+	vad_param->delay = vad_param->frm_len;
+	vad_param->fft_len = VAD_FFT_LEN * sample_rate / VAD_SAMPLE_RATE;
 	vad_param->lo_chan = 0;
 	vad_param->mid_chan = 5;
 	vad_param->hi_chan = 19;
@@ -234,6 +248,18 @@ void* dios_ssp_energy_vad_init(int vad_type)
 		{105, 127} // 23
 	};
 	memcpy(vad_param->ch_table, tmp_ch_tbl, NUM_CHAN * 2 * sizeof(int));
+	// the bin width is the same at any sampling rate, channels above the nyquist frequency are cut
+	for (j = 0; j < NUM_CHAN; j++)
+	{
+		if (vad_param->ch_table[j][0] > vad_param->fft_len / 2)
+		{
+			vad_param->ch_table[j][0] = vad_param->fft_len / 2;
+		}
+		if (vad_param->ch_table[j][1] > vad_param->fft_len / 2)
+		{
+			vad_param->ch_table[j][1] = vad_param->fft_len / 2;
+		}
+	}
 	int tmp_vm_tbl[VM_SIZE] = {
 		2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
 		3, 3, 3, 3, 3, 4, 4, 4, 5, 5, 5, 6, 6, 7, 7, 7,
@@ -247,24 +273,24 @@ void* dios_ssp_energy_vad_init(int vad_type)
 	memcpy(vad_param->vm_table, tmp_vm_tbl, VM_SIZE * sizeof(int));
 
 	// FFT initialization
-	vad_param->vad_fftbuf_in = (float *)calloc(vad_param->fft_len, sizeof(float));
-	vad_param->vad_fftbuf_out = (xcomplex *)calloc(vad_param->fft_len / 2 + 1, sizeof(xcomplex));
-    vad_param->vad_fft_out = (float*)calloc(vad_param->fft_len, sizeof(float));
-    vad_param->rfft_param = dios_ssp_share_rfft_init(VAD_FFT_LEN);
+	vad_param->vad_fftbuf_in = (float *)dios_ssp_share_calloc(vad_param->fft_len, sizeof(float));
+	vad_param->vad_fftbuf_out = (xcomplex *)dios_ssp_share_calloc(vad_param->fft_len / 2 + 1, sizeof(xcomplex));
+    vad_param->vad_fft_out = (float*)dios_ssp_share_calloc(vad_param->fft_len, sizeof(float));
+    vad_param->rfft_param = dios_ssp_share_rfft_init_pool(vad_param->fft_len, table_pool);
 
     // allocate memory space and initialize to zeros
-    vad_param->window_overlap = (float *)calloc(vad_param->delay, sizeof(float));
-    vad_param->ch_energy = (float *)calloc(NUM_CHAN, sizeof(float));
-    vad_param->ch_noise = (float *)calloc(NUM_CHAN, sizeof(float));
-    vad_param->ch_energy_db = (float *)calloc(NUM_CHAN, sizeof(float));
-    vad_param->ch_enrg_long_db = (float *)calloc(NUM_CHAN, sizeof(float));
-    vad_param->data_buffer = (float *)calloc(FRM_LEN + vad_param->delay, sizeof(float));
-    vad_param->ch_snr = (int *)calloc(NUM_CHAN, sizeof(int));
-    vad_param->window_coef = (float *)calloc(FRM_LEN + vad_param->delay, sizeof(float));
-    vad_param->in_buffer = (float *)calloc(FRM_LEN, sizeof(float));
-    vad_param->out_buffer = (float *)calloc(FRM_LEN, sizeof(float));
-
-    vad_param->energyvad_noise_est = (objNoiseLevel *)calloc(1, sizeof(objNoiseLevel));
+    vad_param->window_overlap = (float *)dios_ssp_share_calloc(vad_param->delay, sizeof(float));
+    vad_param->ch_energy = (float *)dios_ssp_share_calloc(NUM_CHAN, sizeof(float));
+    vad_param->ch_noise = (float *)dios_ssp_share_calloc(NUM_CHAN, sizeof(float));
+    vad_param->ch_energy_db = (float *)dios_ssp_share_calloc(NUM_CHAN, sizeof(float));
+    vad_param->ch_enrg_long_db = (float *)dios_ssp_share_calloc(NUM_CHAN, sizeof(float));
+    vad_param->data_buffer = (float *)dios_ssp_share_calloc(vad_param->frm_len + vad_param->delay, sizeof(float));
+    vad_param->ch_snr = (int *)dios_ssp_share_calloc(NUM_CHAN, sizeof(int));
+    vad_param->window_coef = (float *)dios_ssp_share_calloc(vad_param->frm_len + vad_param->delay, sizeof(float));
+    vad_param->in_buffer = (float *)dios_ssp_share_calloc(vad_param->frm_len, sizeof(float));
+    vad_param->out_buffer = (float *)dios_ssp_share_calloc(vad_param->frm_len, sizeof(float));
+
+    vad_param->energyvad_noise_est = (objNoiseLevel *)dios_ssp_share_calloc(1, sizeof(objNoiseLevel));
     dios_ssp_share_noiselevel_init(vad_param->energyvad_noise_est, 90000.0f, 0.00001f, vad_param->nl_run_min_len); 
 
     vad_param->voice_detect_state = FALSE;
@@ -290,16 +316,16 @@ void* dios_ssp_energy_vad_init(int vad_type)
         vad_param->window_coef[j] = (float)sin(PI * (j + 0.5) / (2 * vad_param->delay)) * 
             (float)sin(PI * (j + 0.5) / (2 * vad_param->delay));
     }
-    for (j = vad_param->delay; j < FRM_LEN; j++) 
+    for (j = vad_param->delay; j < vad_param->frm_len; j++) 
     {
         vad_param->window_coef[j] = 1.0;
     }
-    for (j = FRM_LEN; j < FRM_LEN + vad_param->delay; j++) 
+    for (j = vad_param->frm_len; j < vad_param->frm_len + vad_param->delay; j++) 
     {
-        vad_param->window_coef[j] = (float)sin(PI * (j - FRM_LEN + vad_param->delay + 0.5) / (2 * vad_param->delay)) * 
-            (float)sin(PI * (j - FRM_LEN + vad_param->delay + 0.5) / (2 * vad_param->delay));
+        vad_param->window_coef[j] = (float)sin(PI * (j - vad_param->frm_len + vad_param->delay + 0.5) / (2 * vad_param->delay)) * 
+            (float)sin(PI * (j - vad_param->frm_len + vad_param->delay + 0.5) / (2 * vad_param->delay));
     }
-    for (j = 0; j < FRM_LEN + vad_param->delay; j++) 
+    for (j = 0; j < vad_param->frm_len + vad_param->delay; j++) 
     {
         vad_param->data_buffer[j] = 0.0;
     }
@@ -315,7 +341,7 @@ void dios_ssp_energy_vad_reset(void* energyvad_ptr)
 
     vad_param = (objENERGYVAD *)energyvad_ptr;
 
-    for (j = 0; j < FRM_LEN + vad_param->delay; j++) 
+    for (j = 0; j < vad_param->frm_len + vad_param->delay; j++) 
     {
         vad_param->data_buffer[j] = 0.0;
     }
@@ -341,7 +367,7 @@ void dios_ssp_energy_vad_reset(void* energyvad_ptr)
 		vad_param->vad_fftbuf_out[j].r = 0.0;
 		vad_param->vad_fftbuf_out[j].i = 0.0;
 	}
-    for (j = 0; j < FRM_LEN; j++) 
+    for (j = 0; j < vad_param->frm_len; j++) 
     {
         vad_param->in_buffer[j] = 0.0;
         vad_param->out_buffer[j] = 0.0;
@@ -430,24 +456,23 @@ int dios_ssp_energy_vad_process(void* energyvad_ptr, float *inbuf)
     int tmpi = 0;
     float tmpf = 0;
     float energ = 0.0f;
+    vad_param = (objENERGYVAD *)energyvad_ptr;
 #if 0
     float *nl_data = NULL;
-    nl_data = (float *)calloc(FRM_LEN, sizeof(float));
+    nl_data = (float *)dios_ssp_share_calloc(vad_param->frm_len, sizeof(float));
     energ = 0;
-    for (j = 0; j < FRM_LEN; j++)
+    for (j = 0; j < vad_param->frm_len; j++)
     {
         nl_data[j] = (float)inbuf[j];
         energ += nl_data[j] * nl_data[j];
     }
-    energ /= FRM_LEN;
-    free(nl_data);
+    energ /= vad_param->frm_len;
+    dios_ssp_share_free(nl_data);
 #endif
-    for (j = 0; j < FRM_LEN; j++) {
+    for (j = 0; j < vad_param->frm_len; j++) {
         energ += ((float)inbuf[j]) * ((float)inbuf[j]);
     }
-    energ /= FRM_LEN;
-
-    vad_param = (objENERGYVAD *)energyvad_ptr;
+    energ /= vad_param->frm_len;
 
     int nlvad = dios_ssp_share_noiselevel_process(vad_param->energyvad_noise_est, energ);
     
@@ -467,11 +492,11 @@ int dios_ssp_energy_vad_process(void* energyvad_ptr, float *inbuf)
     }
     vad_param->frame_count++;
 
-    for (i = 0; i < FRM_LEN; i++) 
+    for (i = 0; i < vad_param->frm_len; i++) 
     {
         vad_param->in_buffer[i] = (float)inbuf[i];
     }
-    //iir_proc(vad_param->iir_notch_vad, vad_param->in_buffer, FRM_LEN);
+    //iir_proc(vad_param->iir_notch_vad, vad_param->in_buffer, vad_param->frm_len);
 
     /*--------------------------------------*/
     /*	Frame & Window						*/
@@ -494,39 +519,39 @@ int dios_ssp_energy_vad_process(void* energyvad_ptr, float *inbuf)
 
     vad_param->data_buffer[vad_param->delay] = vad_param->in_buffer[0] + vad_param->pre_emp_fac * vad_param->pre_emp_data;
 
-    for (i = vad_param->delay + 1, j = 1; i < vad_param->delay + FRM_LEN; i++, j++) 
+    for (i = vad_param->delay + 1, j = 1; i < vad_param->delay + vad_param->frm_len; i++, j++) 
     {
         vad_param->data_buffer[i] = vad_param->in_buffer[j] + vad_param->pre_emp_fac * vad_param->in_buffer[j - 1];
     }
-    vad_param->pre_emp_data = vad_param->in_buffer[FRM_LEN - 1];
+    vad_param->pre_emp_data = vad_param->in_buffer[vad_param->frm_len - 1];
 
     // update window_overlap buffer
-    for (i = 0, j = FRM_LEN; i < vad_param->delay; i++, j++) 
+    for (i = 0, j = vad_param->frm_len; i < vad_param->delay; i++, j++) 
     {
         vad_param->window_overlap[i] = vad_param->data_buffer[j];
     }
 
     // apply window_coef to frame prior to FFT
-    for (i = 0; i < FRM_LEN + vad_param->delay; i++)
+    for (i = 0; i < vad_param->frm_len + vad_param->delay; i++)
     {
 		vad_param->vad_fftbuf_in[i] = vad_param->data_buffer[i] * vad_param->window_coef[i];
     }
 
-    for (i = FRM_LEN + vad_param->delay; i < vad_param->fft_len; i++) 
+    for (i = vad_param->frm_len + vad_param->delay; i < vad_param->fft_len; i++) 
     {
 		vad_param->vad_fftbuf_in[i] = 0.0;
     }
 
     // perform FFT on the 'tbuf', results in 'spec'
     dios_ssp_share_rfft_process(vad_param->rfft_param, vad_param->vad_fftbuf_in, vad_param->vad_fft_out);
-    for (i = 0; i < VAD_SUBBAND_NUM; i++)
+    for (i = 0; i < vad_param->fft_len / 2 + 1; i++)
     {
 	    vad_param->vad_fftbuf_out[i].r = vad_param->vad_fft_out[i];
     }
-    vad_param->vad_fftbuf_out[0].i = vad_param->vad_fftbuf_out[VAD_SUBBAND_NUM - 1].i = 0.0;
-    for (i = 1; i < VAD_SUBBAND_NUM - 1; i++)
+    vad_param->vad_fftbuf_out[0].i = vad_param->vad_fftbuf_out[vad_param->fft_len / 2].i = 0.0;
+    for (i = 1; i < vad_param->fft_len / 2; i++)
     {
-	    vad_param->vad_fftbuf_out[i].i = -vad_param->vad_fft_out[VAD_FFT_LEN - i];
+	    vad_param->vad_fftbuf_out[i].i = -vad_param->vad_fft_out[vad_param->fft_len - i];
     }
     
     // estimate the energy in each channel
@@ -885,19 +910,19 @@ void dios_ssp_energy_vad_uninit(void* energyvad_ptr)
     int ret = 0;
     objENERGYVAD *vad_param;
     vad_param = (objENERGYVAD *)energyvad_ptr;
-    free(vad_param->window_overlap);
-    free(vad_param->ch_energy);
-    free(vad_param->ch_noise);
-    free(vad_param->ch_enrg_long_db);
-    free(vad_param->data_buffer);
-    free(vad_param->ch_snr);
-    free(vad_param->ch_energy_db);
-    free(vad_param->window_coef);
-    free(vad_param->in_buffer);
-    free(vad_param->out_buffer);
-	free(vad_param->vad_fftbuf_in);
-	free(vad_param->vad_fftbuf_out);
-    free(vad_param->vad_fft_out);
+    dios_ssp_share_free(vad_param->window_overlap);
+    dios_ssp_share_free(vad_param->ch_energy);
+    dios_ssp_share_free(vad_param->ch_noise);
+    dios_ssp_share_free(vad_param->ch_enrg_long_db);
+    dios_ssp_share_free(vad_param->data_buffer);
+    dios_ssp_share_free(vad_param->ch_snr);
+    dios_ssp_share_free(vad_param->ch_energy_db);
+    dios_ssp_share_free(vad_param->window_coef);
+    dios_ssp_share_free(vad_param->in_buffer);
+    dios_ssp_share_free(vad_param->out_buffer);
+	dios_ssp_share_free(vad_param->vad_fftbuf_in);
+	dios_ssp_share_free(vad_param->vad_fftbuf_out);
+    dios_ssp_share_free(vad_param->vad_fft_out);
     
     ret = dios_ssp_share_rfft_uninit(vad_param->rfft_param);
 	if (0 != ret)
@@ -905,7 +930,7 @@ void dios_ssp_energy_vad_uninit(void* energyvad_ptr)
 		vad_param->rfft_param = NULL;
 	}
 	
-    free(vad_param->energyvad_noise_est);
-    free(vad_param);
+    dios_ssp_share_free(vad_param->energyvad_noise_est);
+    dios_ssp_share_free(vad_param);
 }
 
@@ -28,11 +28,13 @@ enum TALK_STATE
 Function:      // dios_ssp_energy_vad_init
 Description:   // init energy vad module
 Input:         // ptr: vad_type
+                  sample_rate: sampling rate in Hz, one frame is sample_rate / 125
+                  table_pool: pool of shared read-only tables, NULL for private ones
 Output:        // none
 Return:        // success: return energy vad module pointer
                   failure: return NULL
 **********************************************************************************/
-void* dios_ssp_energy_vad_init(int vad_type);
+void* dios_ssp_energy_vad_init(int vad_type, int sample_rate, void* table_pool);
 
 /**********************************************************************************
 Function:      // dios_ssp_energy_vad_reset
@@ -17,6 +17,8 @@ limitations under the License.
 #ifndef _DIOS_SSP_VAD_MACROS_H_
 #define _DIOS_SSP_VAD_MACROS_H_
 
+/* frame and fft length at VAD_SAMPLE_RATE, both scale with the sampling rate */
+#define VAD_SAMPLE_RATE                   (16000)
 #define VAD_FFT_LEN                       (256)
 #define VAD_SUBBAND_NUM                   (VAD_FFT_LEN/2+1)
 	
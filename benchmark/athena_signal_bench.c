@@ -0,0 +1,828 @@
+// Throughput benchmark of athena-signal modules.
+//
+// Every module is driven frame by frame with synthetic multichannel input
+// (a far-end reference, its echo on every mic, a tone arriving from 60 degree
+// and white noise), so no audio file is needed. For each module the per-frame
+// latency is measured and reported as mean ns/frame, real-time factor
+// (processing time / audio time) and p50/p99/max per-frame latency.
+//
+// One frame is 8 ms for every module, 128 samples at 16 kHz and sample_rate / 125
+// in general. The share kernels are run with the amount of work they do in one
+// frame of the pipeline (sizes at 16 kHz, scaled with the sample rate):
+//   rfft:    one 512-point forward rfft per mic (DOA/MVDR STFT)
+//   subband: one 128-sample subband analyse + compose per mic (AEC)
+//   cinv:    a batch of 257 mic_num x mic_num hermitian inverses (MVDR weights)
+//
+// After the modules, session_num full pipelines (HPF, AEC, DOA, MVDR, NS, AGC)
+// are created side by side, once with private tables and once sharing them
+// through a table pool, and the mean init time and heap bytes per session are
+// reported together with the bytes held by the pool. Heap bytes come from
+// mallinfo2 and are reported as -1 without glibc 2.33 or later.
+//
+// build & run with following cmd:
+// $ gcc -Wall -O2 -o athena_signal_bench athena_signal_bench.c -I<header file path> -L<lib file path> -lathenasignal -lm -lpthread
+// $ ./athena_signal_bench -h
+// Usage: athena_signal_bench
+// --mic_num, -m: microphone number, 2 ~ 16. default: 6
+// --ref_num, -r: reference number. default: 1
+// --frame_num, -n: frames measured per module. default: 2000
+// --warmup_num, -w: frames run before measuring. default: 100
+// --thread_num, -t: threads of AEC. default: 1
+// --sample_rate, -s: sample rate, 8000, 16000, 32000 or 48000. default: 16000
+// --module, -M: comma separated modules to run. default: all
+// --session_num, -p: sessions of the session report, 0 to skip it. default: 8
+// --format, -f: report format, csv or json. default: csv
+// --output_file, -o: report file. default: stdout
+//
+// $ ./athena_signal_bench -m 6 -f json -o bench.json
+// $ ./athena_signal_bench -m 6 -s 48000 -M aec,ns
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <getopt.h>
+#include "dios_ssp_api.h"
+#include "dios_ssp_share/dios_ssp_share_rfft.h"
+#include "dios_ssp_share/dios_ssp_share_subband.h"
+#include "dios_ssp_share/dios_ssp_share_cinv.h"
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define BENCH_HEAP_ON (1)
+#else
+#define BENCH_HEAP_ON (0)
+#endif
+
+#define MAX_STR_LEN 128
+#define BENCH_SAMPLE_RATE (16000)  // default sample rate
+#define BENCH_FRAME_LEN (128)  // at BENCH_SAMPLE_RATE, scaled with the sample rate
+#define BENCH_MAX_MIC (16)
+#define BENCH_FFT_LEN (512)  // at BENCH_SAMPLE_RATE, scaled with the sample rate
+#define BENCH_PI (3.14159265358979f)
+#define BENCH_SOUND_SPEED (340.0f)
+
+typedef struct {
+    int mic_num;
+    int ref_num;
+    int frame_num;
+    int warmup_num;
+    int thread_num;
+    int session_num;
+    int sample_rate;
+    int frame_len;      // sample_rate / 125, one 8 ms block
+    int fft_len;        // DOA/MVDR STFT length
+    int cinv_num;       // fft_len / 2 + 1 bins
+
+    PlaneCoord mic_coord[BENCH_MAX_MIC];
+    // synthetic signals of all (warmup_num + frame_num) frames
+    float* mic_sig;     // [frame][mic][frame_len]
+    float* ref_sig;     // [frame][ref][frame_len]
+
+    // per frame io buffers, refilled from the synthetic signals before every frame
+    float* mic_buf;
+    float* ref_buf;
+    float* out_buf;
+    float* fft_out;
+    xcomplex* subband_buf;
+    float* rxx_re;
+    float* rxx_im;
+    float* rinv_re;
+    float* rinv_im;
+
+    long long* frame_ns;
+} objBench;
+
+typedef struct {
+    const char* name;
+    void* (*init)(objBench* bench);
+    int (*process)(void* ptr, objBench* bench, int frame);
+    int (*uninit)(void* ptr);
+} objBenchModule;
+
+typedef struct {
+    void* subband[BENCH_MAX_MIC];
+} objBenchShare;
+
+
+static long long bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static unsigned int bench_rand_state = 12345u;
+
+// uniform noise in [-1, 1), fixed seed so every run sees the same input
+static float bench_rand(void)
+{
+    bench_rand_state = bench_rand_state * 1664525u + 1013904223u;
+    return (float)(bench_rand_state >> 8) / 8388608.0f - 1.0f;
+}
+
+static void bench_gen_signal(objBench* bench)
+{
+    int total = bench->warmup_num + bench->frame_num;
+    int len = total * bench->frame_len;
+    float src_x = cosf(60.0f * BENCH_PI / 180.0f);
+    float src_y = sinf(60.0f * BENCH_PI / 180.0f);
+    float* ref = (float*)calloc(len, sizeof(float));
+    int i, m, r, f;
+
+    // far-end reference: band-limited noise burst, silent every other second
+    float lp = 0.0f;
+    for (i = 0; i < len; i++) {
+        lp = 0.7f * lp + 0.3f * bench_rand();
+        ref[i] = ((i / bench->sample_rate) % 2 == 0) ? 6000.0f * lp : 0.0f;
+    }
+
+    for (f = 0; f < total; f++) {
+        for (m = 0; m < bench->mic_num; m++) {
+            // plane wave delay of the near-end tone on mic m
+            float tau = (bench->mic_coord[m].x * src_x + bench->mic_coord[m].y * src_y) / BENCH_SOUND_SPEED;
+            float* dst = bench->mic_sig + (f * bench->mic_num + m) * bench->frame_len;
+            for (i = 0; i < bench->frame_len; i++) {
+                int n = f * bench->frame_len + i;
+                float t = (float)n / bench->sample_rate + tau;
+                float echo = (n >= 40 + m) ? 0.5f * ref[n - 40 - m] : 0.0f;
+                dst[i] = echo + 3000.0f * sinf(2.0f * BENCH_PI * 700.0f * t) + 100.0f * bench_rand();
+            }
+        }
+        for (r = 0; r < bench->ref_num; r++) {
+            float* dst = bench->ref_sig + (f * bench->ref_num + r) * bench->frame_len;
+            for (i = 0; i < bench->frame_len; i++) {
+                dst[i] = ref[f * bench->frame_len + i] * (1.0f - 0.1f * r);
+            }
+        }
+    }
+    free(ref);
+}
+
+static void bench_load_frame(objBench* bench, int frame)
+{
+    memcpy(bench->mic_buf, bench->mic_sig + frame * bench->mic_num * bench->frame_len,
+           bench->mic_num * bench->frame_len * sizeof(float));
+    memcpy(bench->ref_buf, bench->ref_sig + frame * bench->ref_num * bench->frame_len,
+           bench->ref_num * bench->frame_len * sizeof(float));
+}
+
+
+/* AEC */
+static void* bench_aec_init(objBench* bench)
+{
+    return dios_ssp_aec_multithread_init_api(bench->mic_num, bench->ref_num, bench->frame_len, bench->sample_rate, bench->thread_num, NULL);
+}
+
+static int bench_aec_process(void* ptr, objBench* bench, int frame)
+{
+    int dt_st;
+    return dios_ssp_aec_process_api(ptr, bench->mic_buf, bench->ref_buf, &dt_st);
+}
+
+/* MVDR */
+static void* bench_mvdr_init(objBench* bench)
+{
+    void* ptr = dios_ssp_mvdr_init_api(bench->mic_num, (void*)bench->mic_coord, bench->sample_rate, NULL);
+    if (ptr != NULL) {
+        dios_ssp_mvdr_reset_api(ptr);
+    }
+    return ptr;
+}
+
+static int bench_mvdr_process(void* ptr, objBench* bench, int frame)
+{
+    return dios_ssp_mvdr_process_api(ptr, bench->mic_buf, bench->out_buf, 60.0f, 0.0f);
+}
+
+/* GSC */
+static void* bench_gsc_init(objBench* bench)
+{
+    void* ptr = dios_ssp_gsc_init_api(bench->mic_num, (void*)bench->mic_coord, bench->sample_rate);
+    if (ptr != NULL) {
+        dios_ssp_gsc_reset_api(ptr);
+    }
+    return ptr;
+}
+
+static int bench_gsc_process(void* ptr, objBench* bench, int frame)
+{
+    return dios_ssp_gsc_process_api(ptr, bench->mic_buf, bench->out_buf, 60.0f);
+}
+
+/* DOA */
+static void* bench_doa_init(objBench* bench)
+{
+    void* ptr = dios_ssp_doa_init_api(bench->mic_num, bench->mic_coord, bench->sample_rate, 0.0f, 0.0f, 0.0f, NULL);
+    if (ptr != NULL) {
+        dios_ssp_doa_reset_api(ptr);
+    }
+    return ptr;
+}
+
+static int bench_doa_process(void* ptr, objBench* bench, int frame)
+{
+    dios_ssp_doa_process_api(ptr, bench->mic_buf, 1, 0);
+    return 0;
+}
+
+/* NS */
+static void* bench_ns_init(objBench* bench)
+{
+    void* ptr = dios_ssp_ns_init_api(bench->frame_len, bench->sample_rate, NULL);
+    if (ptr != NULL) {
+        dios_ssp_ns_reset_api(ptr);
+    }
+    return ptr;
+}
+
+static int bench_ns_process(void* ptr, objBench* bench, int frame)
+{
+    return dios_ssp_ns_process(ptr, bench->mic_buf);
+}
+
+/* VAD */
+static void* bench_vad_init(objBench* bench)
+{
+    void* ptr = dios_ssp_vad_init_api(bench->sample_rate, NULL);
+    if (ptr != NULL) {
+        dios_ssp_vad_reset_api(ptr);
+    }
+    return ptr;
+}
+
+static int bench_vad_process(void* ptr, objBench* bench, int frame)
+{
+    return dios_ssp_vad_process_api(ptr, bench->mic_buf, 0);
+}
+
+/* AGC */
+static void* bench_agc_init(objBench* bench)
+{
+    void* ptr = dios_ssp_agc_init_api(bench->frame_len, 26000.0f, 0, bench->sample_rate);
+    if (ptr != NULL) {
+        dios_ssp_agc_reset_api(ptr);
+    }
+    return ptr;
+}
+
+static int bench_agc_process(void* ptr, objBench* bench, int frame)
+{
+    return dios_ssp_agc_process_api(ptr, bench->mic_buf, 1, 1, 0);
+}
+
+/* HPF */
+static void* bench_hpf_init(objBench* bench)
+{
+    void* ptr = dios_ssp_hpf_init_api(bench->sample_rate);
+    if (ptr != NULL) {
+        dios_ssp_hpf_reset_api(ptr);
+    }
+    return ptr;
+}
+
+static int bench_hpf_process(void* ptr, objBench* bench, int frame)
+{
+    return dios_ssp_hpf_process_api(ptr, bench->mic_buf, bench->frame_len);
+}
+
+/* rfft */
+static void* bench_rfft_init(objBench* bench)
+{
+    return dios_ssp_share_rfft_init(bench->fft_len);
+}
+
+static int bench_rfft_process(void* ptr, objBench* bench, int frame)
+{
+    // fft_len samples per mic from the current frame on, the signal
+    // buffer has that much slack after the last frame
+    float* in = bench->mic_sig + frame * bench->mic_num * bench->frame_len;
+    int m;
+    int ret = 0;
+
+    for (m = 0; m < bench->mic_num; m++) {
+        ret |= dios_ssp_share_rfft_process(ptr, in + m * bench->fft_len, bench->fft_out);
+    }
+    return ret;
+}
+
+static int bench_rfft_uninit(void* ptr)
+{
+    return dios_ssp_share_rfft_uninit(ptr);
+}
+
+/* subband */
+static void* bench_subband_init(objBench* bench)
+{
+    objBenchShare* share = (objBenchShare*)calloc(1, sizeof(objBenchShare));
+    int m;
+
+    for (m = 0; m < bench->mic_num; m++) {
+        share->subband[m] = dios_ssp_share_subband_init(bench->frame_len);
+        dios_ssp_share_subband_reset(share->subband[m]);
+    }
+    return share;
+}
+
+static int bench_subband_process(void* ptr, objBench* bench, int frame)
+{
+    objBenchShare* share = (objBenchShare*)ptr;
+    int m;
+    int ret = 0;
+
+    for (m = 0; m < bench->mic_num; m++) {
+        ret |= dios_ssp_share_subband_analyse(share->subband[m], bench->mic_buf + m * bench->frame_len, bench->subband_buf);
+        ret |= dios_ssp_share_subband_compose(share->subband[m], bench->subband_buf, bench->out_buf);
+    }
+    return ret;
+}
+
+static int bench_subband_uninit(void* ptr)
+{
+    objBenchShare* share = (objBenchShare*)ptr;
+    int m;
+
+    for (m = 0; m < BENCH_MAX_MIC; m++) {
+        if (share->subband[m] != NULL) {
+            dios_ssp_share_subband_uninit(share->subband[m]);
+        }
+    }
+    free(share);
+    return 0;
+}
+
+/* cinv */
+static void* bench_cinv_init(objBench* bench)
+{
+    int dim = bench->mic_num;
+    int size = dim * dim;
+    int b, i, j, k;
+
+    // covariance of the first frame's spectrum plus noise floor, hermitian positive definite
+    for (b = 0; b < bench->cinv_num; b++) {
+        float* re = bench->rxx_re + b * size;
+        float* im = bench->rxx_im + b * size;
+        memset(re, 0, size * sizeof(float));
+        memset(im, 0, size * sizeof(float));
+        for (k = 0; k < 4; k++) {
+            float vr[BENCH_MAX_MIC];
+            float vi[BENCH_MAX_MIC];
+            for (i = 0; i < dim; i++) {
+                vr[i] = bench_rand();
+                vi[i] = bench_rand();
+            }
+            for (i = 0; i < dim; i++) {
+                for (j = 0; j < dim; j++) {
+                    re[i * dim + j] += vr[i] * vr[j] + vi[i] * vi[j];
+                    im[i * dim + j] += vi[i] * vr[j] - vr[i] * vi[j];
+                }
+            }
+        }
+        for (i = 0; i < dim; i++) {
+            re[i * dim + i] += 0.01f;
+        }
+    }
+    return dios_ssp_hermitian_inv_init(dim, 0.0f);
+}
+
+static int bench_cinv_process(void* ptr, objBench* bench, int frame)
+{
+    return dios_ssp_hermitian_inv_process(ptr, bench->rxx_re, bench->rxx_im,
+                                          bench->rinv_re, bench->rinv_im, bench->cinv_num);
+}
+
+static int bench_cinv_uninit(void* ptr)
+{
+    return dios_ssp_hermitian_inv_delete(ptr);
+}
+
+
+static const objBenchModule bench_modules[] = {
+    {"aec",     bench_aec_init,     bench_aec_process,     dios_ssp_aec_uninit_api},
+    {"mvdr",    bench_mvdr_init,    bench_mvdr_process,    dios_ssp_mvdr_uninit_api},
+    {"gsc",     bench_gsc_init,     bench_gsc_process,     dios_ssp_gsc_uninit_api},
+    {"doa",     bench_doa_init,     bench_doa_process,     dios_ssp_doa_uninit_api},
+    {"ns",      bench_ns_init,      bench_ns_process,      dios_ssp_ns_uninit_api},
+    {"vad",     bench_vad_init,     bench_vad_process,     dios_ssp_vad_uninit_api},
+    {"agc",     bench_agc_init,     bench_agc_process,     dios_ssp_agc_uninit_api},
+    {"hpf",     bench_hpf_init,     bench_hpf_process,     dios_ssp_hpf_uninit_api},
+    {"rfft",    bench_rfft_init,    bench_rfft_process,    bench_rfft_uninit},
+    {"subband", bench_subband_init, bench_subband_process, bench_subband_uninit},
+    {"cinv",    bench_cinv_init,    bench_cinv_process,    bench_cinv_uninit},
+};
+#define BENCH_MODULE_NUM ((int)(sizeof(bench_modules) / sizeof(bench_modules[0])))
+
+
+static int bench_cmp_ns(const void* a, const void* b)
+{
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+// nearest-rank percentile of sorted latencies
+static long long bench_percentile(const long long* sorted, int num, int pct)
+{
+    int rank = (pct * num + 99) / 100;
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1];
+}
+
+static int bench_selected(const char* list, const char* name)
+{
+    const char* p = list;
+    size_t len = strlen(name);
+
+    if (strcmp(list, "all") == 0) return 1;
+    while (*p) {
+        if (strncmp(p, name, len) == 0 && (p[len] == ',' || p[len] == '\0')) return 1;
+        p = strchr(p, ',');
+        if (p == NULL) break;
+        p++;
+    }
+    return 0;
+}
+
+// every name of the comma separated list must be a known module
+static int bench_check_modules(const char* list)
+{
+    const char* p = list;
+    size_t len;
+    int i;
+
+    if (strcmp(list, "all") == 0) return 0;
+    while (1) {
+        len = strcspn(p, ",");
+        for (i = 0; i < BENCH_MODULE_NUM; i++) {
+            if (strlen(bench_modules[i].name) == len && strncmp(p, bench_modules[i].name, len) == 0) break;
+        }
+        if (i == BENCH_MODULE_NUM) return -1;
+        if (p[len] == '\0') break;
+        p += len + 1;
+    }
+    return 0;
+}
+
+static int bench_run_module(objBench* bench, const objBenchModule* module, FILE* fp, const char* format, int first)
+{
+    void* ptr;
+    int f;
+    int ret;
+    long long sum = 0;
+    double frame_ns = 1e9 * bench->frame_len / bench->sample_rate;
+    double mean;
+
+    ptr = module->init(bench);
+    if (ptr == NULL) {
+        fprintf(stderr, "%s: init failed, skipped\n", module->name);
+        return -1;
+    }
+
+    for (f = 0; f < bench->warmup_num + bench->frame_num; f++) {
+        long long t0, t1;
+        bench_load_frame(bench, f);
+        t0 = bench_now_ns();
+        ret = module->process(ptr, bench, f);
+        t1 = bench_now_ns();
+        if (ret != 0) {
+            fprintf(stderr, "%s: process returned %d on frame %d\n", module->name, ret, f);
+        }
+        if (f >= bench->warmup_num) {
+            bench->frame_ns[f - bench->warmup_num] = t1 - t0;
+            sum += t1 - t0;
+        }
+    }
+    module->uninit(ptr);
+
+    qsort(bench->frame_ns, bench->frame_num, sizeof(long long), bench_cmp_ns);
+    mean = (double)sum / bench->frame_num;
+
+    if (strcmp(format, "json") == 0) {
+        fprintf(fp, "%s    {\"module\": \"%s\", \"mic_num\": %d, \"ref_num\": %d, \"thread_num\": %d, "
+                "\"frame_len\": %d, \"sample_rate\": %d, \"frames\": %d, "
+                "\"ns_per_frame\": %.1f, \"rtf\": %.6f, \"p50_ns\": %lld, \"p99_ns\": %lld, \"max_ns\": %lld}",
+                first ? "" : ",\n", module->name, bench->mic_num, bench->ref_num, bench->thread_num,
+                bench->frame_len, bench->sample_rate, bench->frame_num,
+                mean, mean / frame_ns,
+                bench_percentile(bench->frame_ns, bench->frame_num, 50),
+                bench_percentile(bench->frame_ns, bench->frame_num, 99),
+                bench->frame_ns[bench->frame_num - 1]);
+    } else {
+        fprintf(fp, "%s,%d,%d,%d,%d,%d,%d,%.1f,%.6f,%lld,%lld,%lld\n",
+                module->name, bench->mic_num, bench->ref_num, bench->thread_num,
+                bench->frame_len, bench->sample_rate, bench->frame_num,
+                mean, mean / frame_ns,
+                bench_percentile(bench->frame_ns, bench->frame_num, 50),
+                bench_percentile(bench->frame_ns, bench->frame_num, 99),
+                bench->frame_ns[bench->frame_num - 1]);
+    }
+    fflush(fp);
+    return 0;
+}
+
+// bytes in use on the heap, -1 when it can not be measured
+static long long bench_heap_bytes(void)
+{
+#if BENCH_HEAP_ON
+    struct mallinfo2 mi = mallinfo2();
+    return (long long)(mi.uordblks + mi.hblkhd);
+#else
+    return -1;
+#endif
+}
+
+// init session_num full pipelines, with private tables when pool is NULL
+static int bench_run_sessions(objBench* bench, void* pool, FILE* fp, const char* format, int first)
+{
+    void** st = (void**)calloc(bench->session_num, sizeof(void*));
+    objSSP_Param param;
+    long long heap0, heap1;
+    long long t0, t1;
+    long long first_ns = 0;
+    long long sum = 0;
+    long long heap_per_session;
+    size_t shared_bytes;
+    int shared_num;
+    int i, n;
+    int ret = 0;
+
+    memset(&param, 0, sizeof(objSSP_Param));
+    param.AEC_KEY = 1;
+    param.NS_KEY = 1;
+    param.AGC_KEY = 1;
+    param.HPF_KEY = 1;
+    param.BF_KEY = 1;
+    param.DOA_KEY = 1;
+    param.mic_num = bench->mic_num;
+    param.ref_num = bench->ref_num;
+    for (i = 0; i < bench->mic_num; i++) {
+        param.mic_coord[i] = bench->mic_coord[i];
+    }
+    param.loc_phi = 90.0f;
+    param.frame_len = bench->frame_len;
+    param.sample_rate = bench->sample_rate;
+    param.table_pool = pool;
+
+    heap0 = bench_heap_bytes();
+    for (n = 0; n < bench->session_num; n++) {
+        t0 = bench_now_ns();
+        st[n] = dios_ssp_init_api(&param);
+        t1 = bench_now_ns();
+        if (st[n] == NULL) {
+            fprintf(stderr, "session %d: init failed\n", n);
+            ret = -1;
+            break;
+        }
+        if (n == 0) {
+            first_ns = t1 - t0;
+        }
+        sum += t1 - t0;
+    }
+    heap1 = bench_heap_bytes();
+    shared_bytes = dios_ssp_pool_bytes_api(pool, &shared_num);
+
+    if (ret == 0) {
+        heap_per_session = -1;
+        if (heap0 >= 0) {
+            heap_per_session = (heap1 - heap0 - (long long)shared_bytes) / bench->session_num;
+        }
+        if (strcmp(format, "json") == 0) {
+            fprintf(fp, "%s    {\"tables\": \"%s\", \"sessions\": %d, \"mic_num\": %d, \"ref_num\": %d, "
+                    "\"sample_rate\": %d, \"init_ns_per_session\": %lld, \"first_init_ns\": %lld, "
+                    "\"heap_bytes_per_session\": %lld, \"shared_bytes\": %lld, \"shared_tables\": %d}",
+                    first ? "" : ",\n", pool != NULL ? "pool" : "private", bench->session_num,
+                    bench->mic_num, bench->ref_num, bench->sample_rate, sum / bench->session_num, first_ns,
+                    heap_per_session, (long long)shared_bytes, shared_num);
+        } else {
+            fprintf(fp, "%s,%d,%d,%d,%d,%lld,%lld,%lld,%lld,%d\n",
+                    pool != NULL ? "pool" : "private", bench->session_num,
+                    bench->mic_num, bench->ref_num, bench->sample_rate, sum / bench->session_num, first_ns,
+                    heap_per_session, (long long)shared_bytes, shared_num);
+        }
+        fflush(fp);
+    }
+
+    for (n = 0; n < bench->session_num; n++) {
+        if (st[n] != NULL) {
+            dios_ssp_uninit_api(st[n], &param);
+        }
+    }
+    free(st);
+    return ret;
+}
+
+
+int athena_signal_bench(int mic_num, int ref_num, int frame_num, int warmup_num, int thread_num,
+                        int session_num, int sample_rate, char* module_list, char* format, char* output_file)
+{
+    objBench bench;
+    FILE* fp = stdout;
+    int total = warmup_num + frame_num;
+    int i;
+    int first = 1;
+
+    if (strcmp(output_file, "-") != 0) {
+        fp = fopen(output_file, "w");
+        if (fp == NULL) {
+            printf("can not open output file %s\n", output_file);
+            return -1;
+        }
+    }
+
+    memset(&bench, 0, sizeof(objBench));
+    bench.mic_num = mic_num;
+    bench.ref_num = ref_num;
+    bench.frame_num = frame_num;
+    bench.warmup_num = warmup_num;
+    bench.thread_num = thread_num;
+    bench.session_num = session_num;
+    bench.sample_rate = sample_rate;
+    bench.frame_len = BENCH_FRAME_LEN * sample_rate / BENCH_SAMPLE_RATE;
+    bench.fft_len = BENCH_FFT_LEN * sample_rate / BENCH_SAMPLE_RATE;
+    bench.cinv_num = bench.fft_len / 2 + 1;
+
+    // uniform circular array of radius 5 cm
+    for (i = 0; i < mic_num; i++) {
+        bench.mic_coord[i].x = 0.05f * cosf(2.0f * BENCH_PI * i / mic_num);
+        bench.mic_coord[i].y = 0.05f * sinf(2.0f * BENCH_PI * i / mic_num);
+        bench.mic_coord[i].z = 0.0f;
+    }
+
+    // the rfft kernel reads fft_len samples per mic, keep that much slack after the signal
+    bench.mic_sig = (float*)calloc(total * mic_num * bench.frame_len + mic_num * bench.fft_len, sizeof(float));
+    bench.ref_sig = (float*)calloc(total * ref_num * bench.frame_len, sizeof(float));
+    bench.mic_buf = (float*)calloc(mic_num * bench.frame_len, sizeof(float));
+    bench.ref_buf = (float*)calloc(ref_num * bench.frame_len, sizeof(float));
+    bench.out_buf = (float*)calloc(bench.fft_len, sizeof(float));
+    bench.fft_out = (float*)calloc(bench.fft_len, sizeof(float));
+    bench.subband_buf = (xcomplex*)calloc(bench.fft_len, sizeof(xcomplex));
+    bench.rxx_re = (float*)calloc(bench.cinv_num * mic_num * mic_num, sizeof(float));
+    bench.rxx_im = (float*)calloc(bench.cinv_num * mic_num * mic_num, sizeof(float));
+    bench.rinv_re = (float*)calloc(bench.cinv_num * mic_num * mic_num, sizeof(float));
+    bench.rinv_im = (float*)calloc(bench.cinv_num * mic_num * mic_num, sizeof(float));
+    bench.frame_ns = (long long*)calloc(frame_num, sizeof(long long));
+    bench_gen_signal(&bench);
+
+    if (strcmp(format, "json") == 0) {
+        fprintf(fp, "{\n  \"benchmark\": \"athena_signal_bench\",\n  \"results\": [\n");
+    } else {
+        fprintf(fp, "module,mic_num,ref_num,thread_num,frame_len,sample_rate,frames,ns_per_frame,rtf,p50_ns,p99_ns,max_ns\n");
+    }
+
+    for (i = 0; i < BENCH_MODULE_NUM; i++) {
+        if (!bench_selected(module_list, bench_modules[i].name)) continue;
+        fprintf(stderr, "running %s ...\n", bench_modules[i].name);
+        if (bench_run_module(&bench, &bench_modules[i], fp, format, first) == 0) {
+            first = 0;
+        }
+    }
+
+    if (session_num > 0) {
+        void* pool = dios_ssp_pool_init_api();
+
+        fprintf(stderr, "running %d sessions ...\n", session_num);
+        if (strcmp(format, "json") == 0) {
+            fprintf(fp, "\n  ],\n  \"sessions\": [\n");
+        } else {
+            fprintf(fp, "\ntables,sessions,mic_num,ref_num,sample_rate,init_ns_per_session,first_init_ns,"
+                    "heap_bytes_per_session,shared_bytes,shared_tables\n");
+        }
+        first = (bench_run_sessions(&bench, NULL, fp, format, 1) != 0);
+        bench_run_sessions(&bench, pool, fp, format, first);
+        if (dios_ssp_pool_uninit_api(pool) != OK_AUDIO_PROCESS) {
+            fprintf(stderr, "table pool still in use\n");
+        }
+    }
+
+    if (strcmp(format, "json") == 0) {
+        fprintf(fp, "\n  ]\n}\n");
+    }
+    if (fp != stdout) {
+        fclose(fp);
+    }
+
+    free(bench.mic_sig);
+    free(bench.ref_sig);
+    free(bench.mic_buf);
+    free(bench.ref_buf);
+    free(bench.out_buf);
+    free(bench.fft_out);
+    free(bench.subband_buf);
+    free(bench.rxx_re);
+    free(bench.rxx_im);
+    free(bench.rinv_re);
+    free(bench.rinv_im);
+    free(bench.frame_ns);
+    return 0;
+}
+
+
+
+void display_usage()
+{
+    printf("Usage: athena_signal_bench\n" \
+           "--mic_num, -m: microphone number, 2 ~ 16. default: 6\n" \
+           "--ref_num, -r: reference number. default: 1\n" \
+           "--frame_num, -n: frames measured per module. default: 2000\n" \
+           "--warmup_num, -w: frames run before measuring. default: 100\n" \
+           "--thread_num, -t: threads of AEC. default: 1\n" \
+           "--sample_rate, -s: sample rate, 8000, 16000, 32000 or 48000. default: 16000\n" \
+           "--module, -M: comma separated modules to run, any of\n" \
+           "              aec,mvdr,gsc,doa,ns,vad,agc,hpf,rfft,subband,cinv. default: all\n" \
+           "--session_num, -p: sessions of the session report, 0 to skip it. default: 8\n" \
+           "--format, -f: report format, csv or json. default: csv\n" \
+           "--output_file, -o: report file, '-' for stdout. default: -\n" \
+           "\n");
+    return;
+}
+
+
+int main(int argc, char** argv)
+{
+    int mic_num = 6;
+    int ref_num = 1;
+    int frame_num = 2000;
+    int warmup_num = 100;
+    int thread_num = 1;
+    int session_num = 8;
+    int sample_rate = BENCH_SAMPLE_RATE;
+    char module_list[MAX_STR_LEN] = "all";
+    char format[MAX_STR_LEN] = "csv";
+    char output_file[MAX_STR_LEN] = "-";
+
+    int c;
+    while (1) {
+        static struct option long_options[] = {
+            {"mic_num", required_argument, NULL, 'm'},
+            {"ref_num", required_argument, NULL, 'r'},
+            {"frame_num", required_argument, NULL, 'n'},
+            {"warmup_num", required_argument, NULL, 'w'},
+            {"thread_num", required_argument, NULL, 't'},
+            {"sample_rate", required_argument, NULL, 's'},
+            {"module", required_argument, NULL, 'M'},
+            {"session_num", required_argument, NULL, 'p'},
+            {"format", required_argument, NULL, 'f'},
+            {"output_file", required_argument, NULL, 'o'},
+            {"help", no_argument, NULL, 'h'},
+            {NULL, 0, NULL, 0}};
+
+        /* getopt_long stores the option index here. */
+        int option_index = 0;
+        c = getopt_long(argc, argv, "M:f:hm:n:o:p:r:s:t:w:", long_options, &option_index);
+
+        /* Detect the end of the options. */
+        if (c == -1) break;
+
+        switch (c) {
+            case 'M':
+                memset(module_list, 0, MAX_STR_LEN);
+                strncpy(module_list, optarg, MAX_STR_LEN - 1);
+                break;
+            case 'f':
+                memset(format, 0, MAX_STR_LEN);
+                strncpy(format, optarg, MAX_STR_LEN - 1);
+                break;
+            case 'm':
+                mic_num = strtol(optarg, NULL, 10);
+                break;
+            case 'n':
+                frame_num = strtol(optarg, NULL, 10);
+                break;
+            case 'o':
+                memset(output_file, 0, MAX_STR_LEN);
+                strncpy(output_file, optarg, MAX_STR_LEN - 1);
+                break;
+            case 'p':
+                session_num = strtol(optarg, NULL, 10);
+                break;
+            case 'r':
+                ref_num = strtol(optarg, NULL, 10);
+                break;
+            case 's':
+                sample_rate = strtol(optarg, NULL, 10);
+                break;
+            case 't':
+                thread_num = strtol(optarg, NULL, 10);
+                break;
+            case 'w':
+                warmup_num = strtol(optarg, NULL, 10);
+                break;
+            case 'h':
+            case '?':
+            default:
+                /* getopt_long already printed an error message. */
+                display_usage();
+                exit(-1);
+        }
+    }
+
+    if (mic_num < 2 || mic_num > BENCH_MAX_MIC || ref_num < 1 || frame_num < 1 || warmup_num < 0 || thread_num < 1 || session_num < 0
+        || (sample_rate != 8000 && sample_rate != 16000 && sample_rate != 32000 && sample_rate != 48000)
+        || (strcmp(format, "csv") != 0 && strcmp(format, "json") != 0)
+        || bench_check_modules(module_list) != 0) {
+        display_usage();
+        exit(-1);
+    }
+
+    return athena_signal_bench(mic_num, ref_num, frame_num, warmup_num, thread_num, session_num, sample_rate, module_list, format, output_file);
+}
@@ -16,7 +16,8 @@
 """This model tests API of athena_signal."""
 
 
-from athena_signal.dios_ssp_api import athena_signal_process
+import numpy as np
+from athena_signal.dios_ssp_api import athena_signal_process, AthenaSignalStream
 
 if __name__ == "__main__":
 
@@ -43,3 +44,12 @@ if __name__ == "__main__":
                  [-0.025, -0.0433, 0.0],
                  [0.025, -0.0433, 0.0]]
     athena_signal_process(input_file, out_file, config=config, mic_coord=mic_coord)
+
+    # Test streaming AEC on numpy arrays
+    mic = np.fromfile("examples/0841-0875_env7_sit1_male_in.pcm", dtype=np.int16)
+    ref = np.fromfile("examples/0841-0875_env7_sit1_male_ref.pcm", dtype=np.int16)
+    samples = min(len(mic), len(ref)) // 128 * 128
+    with AthenaSignalStream({'add_AEC': 1, 'add_BF': 0}) as stream:
+        out = [stream.process(mic[np.newaxis, i:i + 1280], ref[np.newaxis, i:i + 1280])
+               for i in range(0, samples - samples % 1280, 1280)]
+    np.concatenate(out).tofile("examples/0841-0875_env7_sit1_male_stream_out.pcm")
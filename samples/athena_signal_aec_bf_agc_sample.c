@@ -8,7 +8,8 @@
 // Usage: athena_signal_aec_bf_agc_sample
 // --input_file, -i: input multi-channel audio file. default: 'input.wav'
 // --ref_file, -r: input reference audio file. default: 'ref.wav'
-// --chunk_size,  -c: audio chunk size to read every time. default: 640
+// --chunk_size,  -c: audio chunk size to read every time. default: 5 frames (640 at 16k)
+// --sample_rate, -s: sample rate of the audio, 8000, 16000, 32000 or 48000. default: 16000
 // --bf_type, -b: type of beamforming, 1 for MVDR and 2 for GSC. default: 1
 // --mic_num, -m: number of mics. default: 3
 // --mic_coord_file, -f: mics coordinate text file. default: mic_coord.txt
@@ -25,7 +26,7 @@
 #include "dios_ssp_return_defs.h"
 
 #define MAX_STR_LEN 128
-#define ATHENA_SIGNAL_FRAME_SIZE (128)  // athena-signal use hard-coded frame size
+#define ATHENA_SIGNAL_SAMPLE_RATE (16000)  // default sample rate, athena-signal frame size is sample_rate / 125
 
 
 void show_progressbar(int progress, int total, int barWidth)
@@ -47,7 +48,7 @@ void show_progressbar(int progress, int total, int barWidth)
 }
 
 
-int athena_signal_aec_bf_agc_sample(char* input_file, char* ref_file, int chunk_size, int bf_type, int mic_num, float* mic_coord, float loc_phi, char* output_file)
+int athena_signal_aec_bf_agc_sample(char* input_file, char* ref_file, int chunk_size, int sample_rate, int bf_type, int mic_num, float* mic_coord, float loc_phi, char* output_file)
 {
     int ret;
 
@@ -56,6 +57,7 @@ int athena_signal_aec_bf_agc_sample(char* input_file, char* ref_file, int chunk_
     memset(SSP_PARAM, 0, sizeof(objSSP_Param));
 
     // prepare dios ssp param
+    SSP_PARAM->sample_rate = sample_rate;
     //SSP_PARAM->NS_KEY = 0;
     SSP_PARAM->AEC_KEY = 1;
     SSP_PARAM->AGC_KEY = 1;
@@ -87,15 +89,25 @@ int athena_signal_aec_bf_agc_sample(char* input_file, char* ref_file, int chunk_
         }
     }
 
-    if (chunk_size % ATHENA_SIGNAL_FRAME_SIZE != 0) {
-        printf("WARNING: chunk_size is not multiple of Athena-signal frame size %d, which will cause process issue!\n", ATHENA_SIGNAL_FRAME_SIZE);
-    }
-
     // init dios ssp api
     void* st;
     st = dios_ssp_init_api(SSP_PARAM);
+    if (st == NULL) {
+        printf("dios_ssp_init_api failed, sample rate %d may not be supported, exit process!\n", sample_rate);
+        free(SSP_PARAM);
+        return -1;
+    }
     dios_ssp_reset_api(st, SSP_PARAM);
 
+    // athena-signal frame size follows the sample rate (128 at 16k)
+    int frame_size = dios_ssp_frame_len_get_api(st);
+    if (chunk_size <= 0) {
+        chunk_size = 5 * frame_size;
+    }
+    if (chunk_size % frame_size != 0) {
+        printf("WARNING: chunk_size is not multiple of Athena-signal frame size %d, which will cause process issue!\n", frame_size);
+    }
+
     // open input/output file
     FILE* fp_input = fopen(input_file, "rb");
     FILE* fp_ref = fopen(ref_file, "rb");
@@ -116,10 +128,10 @@ int athena_signal_aec_bf_agc_sample(char* input_file, char* ref_file, int chunk_
     printf("chunk number is %ld\n", chunk_num);
 
     // prepare data buffers
-    short* ptr_input_data = (short*)calloc(mic_num*ATHENA_SIGNAL_FRAME_SIZE, sizeof(short));
+    short* ptr_input_data = (short*)calloc(mic_num*frame_size, sizeof(short));
     short* ptr_temp = (short*)calloc(mic_num*chunk_size, sizeof(short));
     short* ptr_ref_data = (short*)calloc(chunk_size, sizeof(short));
-    short* ptr_output_data = (short*)calloc(ATHENA_SIGNAL_FRAME_SIZE, sizeof(short));
+    short* ptr_output_data = (short*)calloc(frame_size, sizeof(short));
 
     // read out wav header (usually 44 bytes) to bypass it
     fread(ptr_temp, 1, 44, fp_input);
@@ -134,15 +146,15 @@ int athena_signal_aec_bf_agc_sample(char* input_file, char* ref_file, int chunk_
 
         short* ptr_tmp_input = ptr_temp;
         short* ptr_tmp_ref = ptr_ref_data;
-        int loop_num = chunk_size / ATHENA_SIGNAL_FRAME_SIZE;
+        int loop_num = chunk_size / frame_size;
 
         for(int j=0; j < loop_num; j++) {
             // since layout of multi-channel audio data in .wav audio is interleave,
             // but athena-signal lib only handle non-interleave layout data,
             // so we need convert audio data from interleave to non-interleave
-            for(int k=0; k < ATHENA_SIGNAL_FRAME_SIZE; k++) {
+            for(int k=0; k < frame_size; k++) {
                 for(int l=0; l < mic_num; l++) {
-                    ptr_input_data[k+l*ATHENA_SIGNAL_FRAME_SIZE] = ptr_tmp_input[mic_num*k+l];
+                    ptr_input_data[k+l*frame_size] = ptr_tmp_input[mic_num*k+l];
                 }
             }
 
@@ -162,10 +174,10 @@ int athena_signal_aec_bf_agc_sample(char* input_file, char* ref_file, int chunk_
             }
 
             // save enhanced audio to output file
-            fwrite(ptr_output_data, sizeof(short), ATHENA_SIGNAL_FRAME_SIZE, fp_output);
+            fwrite(ptr_output_data, sizeof(short), frame_size, fp_output);
             // move to next frame
-            ptr_tmp_input += mic_num*ATHENA_SIGNAL_FRAME_SIZE;
-            ptr_tmp_ref += ATHENA_SIGNAL_FRAME_SIZE;
+            ptr_tmp_input += mic_num*frame_size;
+            ptr_tmp_ref += frame_size;
         }
 
         // show process bar
@@ -212,7 +224,8 @@ void display_usage()
     printf("Usage: athena_signal_aec_bf_agc_sample\n" \
            "--input_file, -i: input multi-channel audio file. default: 'input.wav'\n" \
            "--ref_file, -r: input reference audio file. default: 'ref.wav'\n" \
-           "--chunk_size,  -c: audio chunk size to read every time. default: 640\n" \
+           "--chunk_size,  -c: audio chunk size to read every time. default: 5 frames (640 at 16k)\n" \
+           "--sample_rate, -s: sample rate of the audio, 8000, 16000, 32000 or 48000. default: 16000\n" \
            "--bf_type, -b: type of beamforming, 1 for MVDR and 2 for GSC. default: 1\n" \
            "--mic_num, -m: number of mics. default: 3\n" \
            "--mic_coord_file, -f: mics coordinate text file. default: mic_coord.txt\n" \
@@ -227,13 +240,15 @@ int main(int argc, char** argv)
 {
     char input_file[MAX_STR_LEN] = "input.wav";
     char ref_file[MAX_STR_LEN] = "ref.wav";
-    int chunk_size = 640;
+    int chunk_size = 0;
+    int sample_rate = ATHENA_SIGNAL_SAMPLE_RATE;
     int bf_type = 1;
     int mic_num = 3;
     char mic_coord_file[MAX_STR_LEN] = "mic_coord.txt";
     float* mic_coord;
     float loc_phi = 90.0;
     char output_file[MAX_STR_LEN] = "output.pcm";
+    int ret = 0;
 
     int c;
     while (1) {
@@ -241,6 +256,7 @@ int main(int argc, char** argv)
             {"input_file", required_argument, NULL, 'i'},
             {"ref_file", required_argument, NULL, 'r'},
             {"chunk_size", required_argument, NULL, 'c'},
+            {"sample_rate", required_argument, NULL, 's'},
             {"bf_type", required_argument, NULL, 'b'},
             {"mic_num", required_argument, NULL, 'm'},
             {"mic_coord_file", required_argument, NULL, 'f'},
@@ -251,7 +267,7 @@ int main(int argc, char** argv)
 
         /* getopt_long stores the option index here. */
         int option_index = 0;
-        c = getopt_long(argc, argv, "b:c:f:hi:l:m:o:r:", long_options, &option_index);
+        c = getopt_long(argc, argv, "b:c:f:hi:l:m:o:r:s:", long_options, &option_index);
 
         /* Detect the end of the options. */
         if (c == -1) break;
@@ -285,6 +301,9 @@ int main(int argc, char** argv)
                 memset(ref_file, 0, MAX_STR_LEN);
                 strcpy(ref_file, optarg);
                 break;
+            case 's':
+                sample_rate = strtol(optarg, NULL, 10);
+                break;
             case 'h':
             case '?':
             default:
@@ -310,11 +329,11 @@ int main(int argc, char** argv)
     }
 #endif
 
-    printf("NOTE: Athena-signal lib only support 16k sample rate, 16-bit audio data!\n");
-    athena_signal_aec_bf_agc_sample(input_file, ref_file, chunk_size, bf_type, mic_num, mic_coord, loc_phi, output_file);
+    printf("NOTE: Athena-signal lib support 8k, 16k, 32k and 48k sample rate, 16-bit audio data!\n");
+    ret = athena_signal_aec_bf_agc_sample(input_file, ref_file, chunk_size, sample_rate, bf_type, mic_num, mic_coord, loc_phi, output_file);
 
     free(mic_coord);
     printf("\nProcess finished.\n");
-    return 0;
+    return ret;
 }
 
@@ -8,8 +8,10 @@
 // Usage: athena_signal_aec_sample
 // --input_file, -i: input mixed audio file. default: 'input.wav'
 // --ref_file, -r: input reference audio file. default: 'ref.wav'
-// --chunk_size,  -c: audio chunk size to read every time. default: 640
+// --chunk_size,  -c: audio chunk size to read every time. default: 5 frames (640 at 16k)
+// --sample_rate, -s: sample rate of the audio, 8000, 16000, 32000 or 48000. default: 16000
 // --output_file, -o: output pcm file for AEC processed audio. default: output.pcm
+// --ns, -n: run NS after AEC. default: off
 //
 // $ ./athena_signal_aec_sample -i aec_input.wav -r aec_ref.wav -o aec_output.pcm
 //
@@ -21,7 +23,7 @@
 #include "dios_ssp_return_defs.h"
 
 #define MAX_STR_LEN 128
-#define ATHENA_SIGNAL_FRAME_SIZE (128)  // athena-signal use hard-coded frame size
+#define ATHENA_SIGNAL_SAMPLE_RATE (16000)  // default sample rate, athena-signal frame size is sample_rate / 125
 
 
 void show_progressbar(int progress, int total, int barWidth)
@@ -43,7 +45,7 @@ void show_progressbar(int progress, int total, int barWidth)
 }
 
 
-int athena_signal_aec_sample(char* input_file, char* ref_file, int chunk_size, char* output_file)
+int athena_signal_aec_sample(char* input_file, char* ref_file, int chunk_size, int sample_rate, char* output_file, int ns_key)
 {
     int ret;
 
@@ -52,7 +54,8 @@ int athena_signal_aec_sample(char* input_file, char* ref_file, int chunk_size, c
     memset(SSP_PARAM, 0, sizeof(objSSP_Param));
 
     // prepare dios ssp param
-    //SSP_PARAM->NS_KEY = 1;
+    SSP_PARAM->sample_rate = sample_rate;
+    SSP_PARAM->NS_KEY = ns_key;
     SSP_PARAM->AEC_KEY = 1;
     SSP_PARAM->mic_num = 1;
     SSP_PARAM->ref_num = 1;
@@ -65,15 +68,25 @@ int athena_signal_aec_sample(char* input_file, char* ref_file, int chunk_size, c
         }
     }
 
-    if (chunk_size % ATHENA_SIGNAL_FRAME_SIZE != 0) {
-        printf("WARNING: chunk_size is not multiple of Athena-signal frame size %d, which will cause process issue!\n", ATHENA_SIGNAL_FRAME_SIZE);
-    }
-
     // init dios ssp api
     void* st;
     st = dios_ssp_init_api(SSP_PARAM);
+    if (st == NULL) {
+        printf("dios_ssp_init_api failed, sample rate %d may not be supported, exit process!\n", sample_rate);
+        free(SSP_PARAM);
+        return -1;
+    }
     dios_ssp_reset_api(st, SSP_PARAM);
 
+    // athena-signal frame size follows the sample rate (128 at 16k)
+    int frame_size = dios_ssp_frame_len_get_api(st);
+    if (chunk_size <= 0) {
+        chunk_size = 5 * frame_size;
+    }
+    if (chunk_size % frame_size != 0) {
+        printf("WARNING: chunk_size is not multiple of Athena-signal frame size %d, which will cause process issue!\n", frame_size);
+    }
+
     // open input/reference/output file
     FILE* fp_input = fopen(input_file, "rb");
     FILE* fp_ref = fopen(ref_file, "rb");
@@ -96,7 +109,7 @@ int athena_signal_aec_sample(char* input_file, char* ref_file, int chunk_size, c
     // prepare data buffers
     short* ptr_input_data = (short*)calloc(chunk_size, sizeof(short));
     short* ptr_ref_data = (short*)calloc(chunk_size, sizeof(short));
-    short* ptr_output_data = (short*)calloc(ATHENA_SIGNAL_FRAME_SIZE, sizeof(short));
+    short* ptr_output_data = (short*)calloc(frame_size, sizeof(short));
 
     // read out wav header (usually 44 bytes) to bypass it
     fread(ptr_input_data, 1, 44, fp_input);
@@ -111,7 +124,7 @@ int athena_signal_aec_sample(char* input_file, char* ref_file, int chunk_size, c
 
         short* ptr_tmp_input = ptr_input_data;
         short* ptr_tmp_ref = ptr_ref_data;
-        int loop_num = chunk_size / ATHENA_SIGNAL_FRAME_SIZE;
+        int loop_num = chunk_size / frame_size;
 
         for(int j=0; j < loop_num; j++) {
             // dios ssp processing
@@ -130,10 +143,10 @@ int athena_signal_aec_sample(char* input_file, char* ref_file, int chunk_size, c
             }
 
             // save enhanced audio to output file
-            fwrite(ptr_output_data, sizeof(short), ATHENA_SIGNAL_FRAME_SIZE, fp_output);
+            fwrite(ptr_output_data, sizeof(short), frame_size, fp_output);
             // move to next frame
-            ptr_tmp_input += ATHENA_SIGNAL_FRAME_SIZE;
-            ptr_tmp_ref += ATHENA_SIGNAL_FRAME_SIZE;
+            ptr_tmp_input += frame_size;
+            ptr_tmp_ref += frame_size;
         }
 
         // show process bar
@@ -163,8 +176,10 @@ void display_usage()
     printf("Usage: athena_signal_aec_sample\n" \
            "--input_file, -i: input mixed audio file. default: 'input.wav'\n" \
            "--ref_file, -r: input reference audio file. default: 'ref.wav'\n" \
-           "--chunk_size,  -c: audio chunk size to read every time. default: 640\n" \
+           "--chunk_size,  -c: audio chunk size to read every time. default: 5 frames (640 at 16k)\n" \
+           "--sample_rate, -s: sample rate of the audio, 8000, 16000, 32000 or 48000. default: 16000\n" \
            "--output_file, -o: output pcm file for AEC processed audio. default: output.pcm\n" \
+           "--ns, -n: run NS after AEC. default: off\n" \
            "\n");
     return;
 }
@@ -174,8 +189,11 @@ int main(int argc, char** argv)
 {
     char input_file[MAX_STR_LEN] = "input.wav";
     char ref_file[MAX_STR_LEN] = "ref.wav";
-    int chunk_size = 640;
+    int chunk_size = 0;
+    int sample_rate = ATHENA_SIGNAL_SAMPLE_RATE;
     char output_file[MAX_STR_LEN] = "output.pcm";
+    int ns_key = 0;
+    int ret = 0;
 
     int c;
     while (1) {
@@ -183,13 +201,15 @@ int main(int argc, char** argv)
             {"input_file", required_argument, NULL, 'i'},
             {"ref_file", required_argument, NULL, 'r'},
             {"chunk_size", required_argument, NULL, 'c'},
+            {"sample_rate", required_argument, NULL, 's'},
             {"output_file", required_argument, NULL, 'o'},
+            {"ns", no_argument, NULL, 'n'},
             {"help", no_argument, NULL, 'h'},
             {NULL, 0, NULL, 0}};
 
         /* getopt_long stores the option index here. */
         int option_index = 0;
-        c = getopt_long(argc, argv, "c:hi:o:r:", long_options, &option_index);
+        c = getopt_long(argc, argv, "c:hi:no:r:s:", long_options, &option_index);
 
         /* Detect the end of the options. */
         if (c == -1) break;
@@ -202,6 +222,9 @@ int main(int argc, char** argv)
                 memset(input_file, 0, MAX_STR_LEN);
                 strcpy(input_file, optarg);
                 break;
+            case 'n':
+                ns_key = 1;
+                break;
             case 'o':
                 memset(output_file, 0, MAX_STR_LEN);
                 strcpy(output_file, optarg);
@@ -210,6 +233,9 @@ int main(int argc, char** argv)
                 memset(ref_file, 0, MAX_STR_LEN);
                 strcpy(ref_file, optarg);
                 break;
+            case 's':
+                sample_rate = strtol(optarg, NULL, 10);
+                break;
             case 'h':
             case '?':
             default:
@@ -219,10 +245,10 @@ int main(int argc, char** argv)
         }
     }
 
-    printf("NOTE: Athena-signal lib only support 16k sample rate, 16-bit audio data!\n");
-    athena_signal_aec_sample(input_file, ref_file, chunk_size, output_file);
+    printf("NOTE: Athena-signal lib support 8k, 16k, 32k and 48k sample rate, 16-bit audio data!\n");
+    ret = athena_signal_aec_sample(input_file, ref_file, chunk_size, sample_rate, output_file, ns_key);
 
     printf("\nProcess finished.\n");
-    return 0;
+    return ret;
 }
 
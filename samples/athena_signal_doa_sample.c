@@ -7,7 +7,8 @@
 // $ ./install/bin/samples/athena_signal_doa_sample -h
 // Usage: athena_signal_doa_sample
 // --input_file, -i: input multi-channel audio file. default: 'input.wav'
-// --chunk_size,  -c: audio chunk size to read every time. default: 640
+// --chunk_size,  -c: audio chunk size to read every time. default: 5 frames (640 at 16k)
+// --sample_rate, -s: sample rate of the audio, 8000, 16000, 32000 or 48000. default: 16000
 // --mic_num, -m: number of mics. default: 3
 // --mic_coord_file, -f: mics coordinate text file. default: mic_coord.txt
 //
@@ -21,7 +22,7 @@
 #include "dios_ssp_return_defs.h"
 
 #define MAX_STR_LEN 128
-#define ATHENA_SIGNAL_FRAME_SIZE (128)  // athena-signal use hard-coded frame size
+#define ATHENA_SIGNAL_SAMPLE_RATE (16000)  // default sample rate, athena-signal frame size is sample_rate / 125
 
 
 void show_progressbar(int progress, int total, int barWidth)
@@ -43,16 +44,19 @@ void show_progressbar(int progress, int total, int barWidth)
 }
 
 
-int athena_signal_doa_sample(char* input_file, int chunk_size, int mic_num, float* mic_coord)
+int athena_signal_doa_sample(char* input_file, int chunk_size, int sample_rate, int mic_num, float* mic_coord)
 {
     int ret=0;
     float angle=0.0;
+    DoaSource source[DEFAULT_DOA_MAX_SOURCE_NUM];
+    int source_num;
 
     // create dios ssp param data structure
     objSSP_Param* SSP_PARAM = (objSSP_Param*)malloc(sizeof(objSSP_Param));
     memset(SSP_PARAM, 0, sizeof(objSSP_Param));
 
     // prepare dios ssp param
+    SSP_PARAM->sample_rate = sample_rate;
     SSP_PARAM->DOA_KEY = 1;
     SSP_PARAM->mic_num = mic_num;
 
@@ -71,15 +75,25 @@ int athena_signal_doa_sample(char* input_file, int chunk_size, int mic_num, floa
         }
     }
 
-    if (chunk_size % ATHENA_SIGNAL_FRAME_SIZE != 0) {
-        printf("WARNING: chunk_size is not multiple of Athena-signal frame size %d, which will cause process issue!\n", ATHENA_SIGNAL_FRAME_SIZE);
-    }
-
     // init dios ssp api
     void* st;
     st = dios_ssp_init_api(SSP_PARAM);
+    if (st == NULL) {
+        printf("dios_ssp_init_api failed, sample rate %d may not be supported, exit process!\n", sample_rate);
+        free(SSP_PARAM);
+        return -1;
+    }
     dios_ssp_reset_api(st, SSP_PARAM);
 
+    // athena-signal frame size follows the sample rate (128 at 16k)
+    int frame_size = dios_ssp_frame_len_get_api(st);
+    if (chunk_size <= 0) {
+        chunk_size = 5 * frame_size;
+    }
+    if (chunk_size % frame_size != 0) {
+        printf("WARNING: chunk_size is not multiple of Athena-signal frame size %d, which will cause process issue!\n", frame_size);
+    }
+
     // open input audio file
     FILE* fp_input = fopen(input_file, "rb");
 
@@ -97,10 +111,10 @@ int athena_signal_doa_sample(char* input_file, int chunk_size, int mic_num, floa
     printf("chunk number is %ld\n", chunk_num);
 
     // prepare data buffers
-    short* ptr_input_data = (short*)calloc(mic_num*ATHENA_SIGNAL_FRAME_SIZE, sizeof(short));
+    short* ptr_input_data = (short*)calloc(mic_num*frame_size, sizeof(short));
     short* ptr_temp = (short*)calloc(mic_num*chunk_size, sizeof(short));
     short* ptr_ref_data = (short*)calloc(chunk_size, sizeof(short));
-    short* ptr_output_data = (short*)calloc(ATHENA_SIGNAL_FRAME_SIZE, sizeof(short));
+    short* ptr_output_data = (short*)calloc(frame_size, sizeof(short));
 
     // read out wav header (usually 44 bytes) to bypass it
     fread(ptr_temp, 1, 44, fp_input);
@@ -113,15 +127,15 @@ int athena_signal_doa_sample(char* input_file, int chunk_size, int mic_num, floa
         // read data from input file
         ret = fread(ptr_temp, sizeof(short), mic_num*chunk_size, fp_input);
         short* ptr_tmp_input = ptr_temp;
-        int loop_num = chunk_size / ATHENA_SIGNAL_FRAME_SIZE;
+        int loop_num = chunk_size / frame_size;
 
         for(int j=0; j < loop_num; j++) {
             // since layout of multi-channel audio data in .wav audio is interleave,
             // but athena-signal lib only handle non-interleave layout data,
             // so we need convert audio data from interleave to non-interleave
-            for(int k=0; k < ATHENA_SIGNAL_FRAME_SIZE; k++) {
+            for(int k=0; k < frame_size; k++) {
                 for(int l=0; l < mic_num; l++) {
-                    ptr_input_data[k+l*ATHENA_SIGNAL_FRAME_SIZE] = ptr_tmp_input[mic_num*k+l];
+                    ptr_input_data[k+l*frame_size] = ptr_tmp_input[mic_num*k+l];
                 }
             }
 
@@ -144,7 +158,7 @@ int athena_signal_doa_sample(char* input_file, int chunk_size, int mic_num, floa
                 angle = dios_ssp_doa_result_get_api(st, SSP_PARAM);
             }
             // move to next frame
-            ptr_tmp_input += mic_num*ATHENA_SIGNAL_FRAME_SIZE;
+            ptr_tmp_input += mic_num*frame_size;
         }
 
         // show process bar
@@ -153,6 +167,12 @@ int athena_signal_doa_sample(char* input_file, int chunk_size, int mic_num, floa
     }
     printf("\nDOA angle: %f\n", angle);
 
+    // sources still tracked at the end of the file
+    source_num = dios_ssp_doa_source_get_api(st, SSP_PARAM, source, DEFAULT_DOA_MAX_SOURCE_NUM);
+    for (int i = 0; i < source_num && source_num != ERROR_DOA; i++) {
+        printf("DOA source %d: angle %.1f, confidence %.2f\n", source[i].id, source[i].angle, source[i].confidence);
+    }
+
     // uninit dios ssp api
     dios_ssp_uninit_api(st, SSP_PARAM);
     // release resources
@@ -191,7 +211,8 @@ void display_usage()
 {
     printf("Usage: athena_signal_doa_sample\n" \
            "--input_file, -i: input multi-channel audio file. default: 'input.wav'\n" \
-           "--chunk_size,  -c: audio chunk size to read every time. default: 640\n" \
+           "--chunk_size,  -c: audio chunk size to read every time. default: 5 frames (640 at 16k)\n" \
+           "--sample_rate, -s: sample rate of the audio, 8000, 16000, 32000 or 48000. default: 16000\n" \
            "--mic_num, -m: number of mics. default: 3\n" \
            "--mic_coord_file, -f: mics coordinate text file. default: mic_coord.txt\n" \
            "\n");
@@ -202,7 +223,8 @@ void display_usage()
 int main(int argc, char** argv)
 {
     char input_file[MAX_STR_LEN] = "input.wav";
-    int chunk_size = 640;
+    int chunk_size = 0;
+    int sample_rate = ATHENA_SIGNAL_SAMPLE_RATE;
     int mic_num = 3;
     char mic_coord_file[MAX_STR_LEN] = "mic_coord.txt";
     float* mic_coord;
@@ -213,6 +235,7 @@ int main(int argc, char** argv)
         static struct option long_options[] = {
             {"input_file", required_argument, NULL, 'i'},
             {"chunk_size", required_argument, NULL, 'c'},
+            {"sample_rate", required_argument, NULL, 's'},
             {"mic_num", required_argument, NULL, 'm'},
             {"mic_coord_file", required_argument, NULL, 'f'},
             {"help", no_argument, NULL, 'h'},
@@ -220,7 +243,7 @@ int main(int argc, char** argv)
 
         /* getopt_long stores the option index here. */
         int option_index = 0;
-        c = getopt_long(argc, argv, "c:f:hi:m:", long_options, &option_index);
+        c = getopt_long(argc, argv, "c:f:hi:m:s:", long_options, &option_index);
 
         /* Detect the end of the options. */
         if (c == -1) break;
@@ -240,6 +263,9 @@ int main(int argc, char** argv)
             case 'm':
                 mic_num = strtol(optarg, NULL, 10);
                 break;
+            case 's':
+                sample_rate = strtol(optarg, NULL, 10);
+                break;
             case 'h':
             case '?':
             default:
@@ -253,8 +279,8 @@ int main(int argc, char** argv)
     mic_coord = malloc(mic_num*3*sizeof(float));
     parse_mic_coord(mic_coord_file, mic_coord, mic_num);
 
-    printf("NOTE: Athena-signal lib only support 16k sample rate, 16-bit audio data!\n");
-    ret = athena_signal_doa_sample(input_file, chunk_size, mic_num, mic_coord);
+    printf("NOTE: Athena-signal lib support 8k, 16k, 32k and 48k sample rate, 16-bit audio data!\n");
+    ret = athena_signal_doa_sample(input_file, chunk_size, sample_rate, mic_num, mic_coord);
 
     free(mic_coord);
     printf("\nProcess finished.\n");
@@ -7,7 +7,8 @@
 // $ ./athena_signal_hpf_sample -h
 // Usage: athena_signal_hpf_sample
 // --input_file, -i: input raw audio file. default: 'input.wav'
-// --chunk_size,  -c: audio chunk size to read every time. default: 640
+// --chunk_size,  -c: audio chunk size to read every time. default: 5 frames (640 at 16k)
+// --sample_rate, -s: sample rate of the audio, 8000, 16000, 32000 or 48000. default: 16000
 // --output_file, -o: output pcm file for HPF processed audio. default: output.pcm
 //
 // $ ./athena_signal_hpf_sample -i hpf_input.wav -o hpf_output.pcm
@@ -20,7 +21,7 @@
 #include "dios_ssp_return_defs.h"
 
 #define MAX_STR_LEN 128
-#define ATHENA_SIGNAL_FRAME_SIZE (128)  // athena-signal use hard-coded frame size
+#define ATHENA_SIGNAL_SAMPLE_RATE (16000)  // default sample rate, athena-signal frame size is sample_rate / 125
 
 
 void show_progressbar(int progress, int total, int barWidth)
@@ -42,7 +43,7 @@ void show_progressbar(int progress, int total, int barWidth)
 }
 
 
-int athena_signal_hpf_sample(char* input_file, int chunk_size, char* output_file)
+int athena_signal_hpf_sample(char* input_file, int chunk_size, int sample_rate, char* output_file)
 {
     int ret;
 
@@ -51,19 +52,30 @@ int athena_signal_hpf_sample(char* input_file, int chunk_size, char* output_file
     memset(SSP_PARAM, 0, sizeof(objSSP_Param));
 
     // prepare dios ssp param
+    SSP_PARAM->sample_rate = sample_rate;
     //SSP_PARAM->NS_KEY = 1;
     SSP_PARAM->HPF_KEY = 1;
     SSP_PARAM->mic_num = 1;
 
-    if (chunk_size % ATHENA_SIGNAL_FRAME_SIZE != 0) {
-        printf("WARNING: chunk_size is not multiple of Athena-signal frame size %d, which will cause process issue!\n", ATHENA_SIGNAL_FRAME_SIZE);
-    }
-
     // init dios ssp api
     void* st;
     st = dios_ssp_init_api(SSP_PARAM);
+    if (st == NULL) {
+        printf("dios_ssp_init_api failed, sample rate %d may not be supported, exit process!\n", sample_rate);
+        free(SSP_PARAM);
+        return -1;
+    }
     dios_ssp_reset_api(st, SSP_PARAM);
 
+    // athena-signal frame size follows the sample rate (128 at 16k)
+    int frame_size = dios_ssp_frame_len_get_api(st);
+    if (chunk_size <= 0) {
+        chunk_size = 5 * frame_size;
+    }
+    if (chunk_size % frame_size != 0) {
+        printf("WARNING: chunk_size is not multiple of Athena-signal frame size %d, which will cause process issue!\n", frame_size);
+    }
+
     // open input/output file
     FILE* fp_input = fopen(input_file, "rb");
     FILE* fp_output = fopen(output_file, "wb");
@@ -85,7 +97,7 @@ int athena_signal_hpf_sample(char* input_file, int chunk_size, char* output_file
     // prepare data buffers
     short* ptr_input_data = (short*)calloc(chunk_size, sizeof(short));
     short* ptr_ref_data = (short*)calloc(chunk_size, sizeof(short));
-    short* ptr_output_data = (short*)calloc(ATHENA_SIGNAL_FRAME_SIZE, sizeof(short));
+    short* ptr_output_data = (short*)calloc(frame_size, sizeof(short));
 
     // read out wav header (usually 44 bytes) to bypass it
     fread(ptr_input_data, 1, 44, fp_input);
@@ -100,7 +112,7 @@ int athena_signal_hpf_sample(char* input_file, int chunk_size, char* output_file
 
         short* ptr_tmp_input = ptr_input_data;
         short* ptr_tmp_ref = ptr_ref_data;
-        int loop_num = chunk_size / ATHENA_SIGNAL_FRAME_SIZE;
+        int loop_num = chunk_size / frame_size;
 
         for(int j=0; j < loop_num; j++) {
             // dios ssp processing
@@ -119,10 +131,10 @@ int athena_signal_hpf_sample(char* input_file, int chunk_size, char* output_file
             }
 
             // save enhanced audio to output file
-            fwrite(ptr_output_data, sizeof(short), ATHENA_SIGNAL_FRAME_SIZE, fp_output);
+            fwrite(ptr_output_data, sizeof(short), frame_size, fp_output);
             // move to next frame
-            ptr_tmp_input += ATHENA_SIGNAL_FRAME_SIZE;
-            ptr_tmp_ref += ATHENA_SIGNAL_FRAME_SIZE;
+            ptr_tmp_input += frame_size;
+            ptr_tmp_ref += frame_size;
         }
 
         // show process bar
@@ -149,7 +161,8 @@ void display_usage()
 {
     printf("Usage: athena_signal_hpf_sample\n" \
            "--input_file, -i: input raw audio file. default: 'input.wav'\n" \
-           "--chunk_size,  -c: audio chunk size to read every time. default: 640\n" \
+           "--chunk_size,  -c: audio chunk size to read every time. default: 5 frames (640 at 16k)\n" \
+           "--sample_rate, -s: sample rate of the audio, 8000, 16000, 32000 or 48000. default: 16000\n" \
            "--output_file, -o: output pcm file for HPF processed audio. default: output.pcm\n" \
            "\n");
     return;
@@ -158,21 +171,24 @@ void display_usage()
 int main(int argc, char** argv)
 {
     char input_file[MAX_STR_LEN] = "input.wav";
-    int chunk_size = 640;
+    int chunk_size = 0;
+    int sample_rate = ATHENA_SIGNAL_SAMPLE_RATE;
     char output_file[MAX_STR_LEN] = "output.pcm";
+    int ret = 0;
 
     int c;
     while (1) {
         static struct option long_options[] = {
             {"input_file", required_argument, NULL, 'i'},
             {"chunk_size", required_argument, NULL, 'c'},
+            {"sample_rate", required_argument, NULL, 's'},
             {"output_file", required_argument, NULL, 'o'},
             {"help", no_argument, NULL, 'h'},
             {NULL, 0, NULL, 0}};
 
         /* getopt_long stores the option index here. */
         int option_index = 0;
-        c = getopt_long(argc, argv, "c:hi:o:", long_options, &option_index);
+        c = getopt_long(argc, argv, "c:hi:o:s:", long_options, &option_index);
 
         /* Detect the end of the options. */
         if (c == -1) break;
@@ -189,6 +205,9 @@ int main(int argc, char** argv)
                 memset(output_file, 0, MAX_STR_LEN);
                 strcpy(output_file, optarg);
                 break;
+            case 's':
+                sample_rate = strtol(optarg, NULL, 10);
+                break;
             case 'h':
             case '?':
             default:
@@ -198,10 +217,10 @@ int main(int argc, char** argv)
         }
     }
 
-    printf("NOTE: Athena-signal lib only support 16k sample rate, 16-bit audio data!\n");
-    athena_signal_hpf_sample(input_file, chunk_size, output_file);
+    printf("NOTE: Athena-signal lib support 8k, 16k, 32k and 48k sample rate, 16-bit audio data!\n");
+    ret = athena_signal_hpf_sample(input_file, chunk_size, sample_rate, output_file);
 
     printf("\nProcess finished.\n");
-    return 0;
+    return ret;
 }
 
@@ -15,10 +15,16 @@
 # ==============================================================================*/
 """Compile and package the project into a wheel for easy installation."""
 
+import os
 import setuptools
 from glob import glob
 import shutil
 
+# the python binding is generated from athena_signal/dios_signal.i and is not tracked
+if not os.path.exists("athena_signal/dios_signal_wrap.c"):
+      raise SystemExit("athena_signal/dios_signal_wrap.c not found, "
+                       "run 'swig -python athena_signal/dios_signal.i' first")
+
 directories = [
       "athena_signal",
       "athena_signal/kernels",
@@ -0,0 +1,135 @@
+// SNR of a 16-bit pcm output against a reference output.
+//
+// Both files are read as 16-bit little endian samples after skip_bytes
+// (default 44, the header of the sample outputs), and
+//   snr = 10 * log10(sum(ref^2) / sum((test - ref)^2))
+// is reported in dB together with the largest absolute sample difference.
+// It is used by the stress test to check the fixed-point build
+// (ATHENASIGNAL_BUILD_FIXED) against the float reference outputs.
+//
+// build & run with following cmd:
+// $ gcc -Wall -O2 -o athena_signal_snr athena_signal_snr.c -lm
+// $ ./athena_signal_snr -h
+// Usage: athena_signal_snr
+// --ref_file, -r: reference pcm file
+// --test_file, -t: pcm file to check
+// --min_snr, -s: exit with 1 if the snr in dB is below it. default: no check
+// --skip_bytes, -k: header bytes to skip in both files. default: 44
+//
+// $ ./athena_signal_snr -r testing/data/aec_output.pcm -t output/aec_output.pcm -s 30
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+
+#define MAX_STR_LEN 128
+#define SNR_BLOCK_LEN (4096)
+
+void usage()
+{
+    printf("Usage: athena_signal_snr\n");
+    printf("--ref_file, -r: reference pcm file\n");
+    printf("--test_file, -t: pcm file to check\n");
+    printf("--min_snr, -s: exit with 1 if the snr in dB is below it. default: no check\n");
+    printf("--skip_bytes, -k: header bytes to skip in both files. default: 44\n");
+}
+
+int main(int argc, char** argv)
+{
+    char ref_file[MAX_STR_LEN] = "";
+    char test_file[MAX_STR_LEN] = "";
+    int check = 0;
+    double min_snr = 0.0;
+    long skip_bytes = 44;
+    FILE *fp_ref;
+    FILE *fp_test;
+    short ref[SNR_BLOCK_LEN];
+    short test[SNR_BLOCK_LEN];
+    size_t ref_len, test_len, len, i;
+    long sample_num = 0;
+    double sig = 0.0;
+    double err = 0.0;
+    double d;
+    int max_diff = 0;
+    double snr;
+
+    int c;
+    while (1) {
+        static struct option long_options[] = {
+            {"ref_file", required_argument, NULL, 'r'},
+            {"test_file", required_argument, NULL, 't'},
+            {"min_snr", required_argument, NULL, 's'},
+            {"skip_bytes", required_argument, NULL, 'k'},
+            {"help", no_argument, NULL, 'h'},
+            {NULL, 0, NULL, 0}};
+
+        int option_index = 0;
+        c = getopt_long(argc, argv, "hk:r:s:t:", long_options, &option_index);
+        if (c == -1) break;
+
+        switch (c) {
+            case 'r':
+                strncpy(ref_file, optarg, MAX_STR_LEN - 1);
+                break;
+            case 't':
+                strncpy(test_file, optarg, MAX_STR_LEN - 1);
+                break;
+            case 's':
+                min_snr = strtod(optarg, NULL);
+                check = 1;
+                break;
+            case 'k':
+                skip_bytes = strtol(optarg, NULL, 10);
+                break;
+            case 'h':
+                usage();
+                return 0;
+            default:
+                usage();
+                return -1;
+        }
+    }
+
+    fp_ref = fopen(ref_file, "rb");
+    fp_test = fopen(test_file, "rb");
+    if (fp_ref == NULL || fp_test == NULL) {
+        printf("can not open %s or %s\n", ref_file, test_file);
+        if (fp_ref != NULL) fclose(fp_ref);
+        if (fp_test != NULL) fclose(fp_test);
+        return -1;
+    }
+    fseek(fp_ref, skip_bytes, SEEK_SET);
+    fseek(fp_test, skip_bytes, SEEK_SET);
+
+    while (1) {
+        ref_len = fread(ref, sizeof(short), SNR_BLOCK_LEN, fp_ref);
+        test_len = fread(test, sizeof(short), SNR_BLOCK_LEN, fp_test);
+        len = ref_len < test_len ? ref_len : test_len;
+        for (i = 0; i < len; i++) {
+            d = (double)test[i] - ref[i];
+            sig += (double)ref[i] * ref[i];
+            err += d * d;
+            if (abs(test[i] - ref[i]) > max_diff) {
+                max_diff = abs(test[i] - ref[i]);
+            }
+        }
+        sample_num += len;
+        if (ref_len != test_len) {
+            printf("WARNING: %s and %s differ in length, compared the first %ld samples\n", ref_file, test_file, sample_num);
+        }
+        if (len < SNR_BLOCK_LEN) break;
+    }
+    fclose(fp_ref);
+    fclose(fp_test);
+
+    snr = err > 0.0 ? 10.0 * log10(sig / err) : INFINITY;
+    printf("%s: snr %.2f dB, max diff %d over %ld samples\n", test_file, snr, max_diff, sample_num);
+    if (check && !(snr >= min_snr)) {
+        printf("snr is below %.2f dB\n", min_snr);
+        return 1;
+    }
+
+    return 0;
+}
@@ -38,12 +38,53 @@
 #
 # NOTE: This stress test script will be installed in and should be run at "build/install" dir!
 #
-if [[ "$#" -ne 1 ]]; then
-    echo "Usage: $0 <loop_num>"
+# for a build with ATHENASIGNAL_BUILD_FIXED=ON, run it as "stress_test.sh <loop_num> fixed",
+# the outputs are then checked against the float results by snr (athena_signal_snr)
+# instead of by the number of differing bytes
+#
+if [[ "$#" -ne 1 && "$#" -ne 2 ]]; then
+    echo "Usage: $0 <loop_num> [fixed]"
     exit 1
 fi
 
 LOOP_NUM=$1
+MODE=$2
+
+# check_output <right result> <output> <diff bytes ratio> <min snr in dB for fixed mode>
+check_output()
+{
+    if [ "$MODE" == "fixed" ]; then
+        ./bin/athena_signal_snr -r $1 -t $2 -s $4
+        return $?
+    fi
+    RESULT_BYTES=$(ls -l $1 | awk '{print $5}')
+    DIFF_THRESHOLD=$(echo "$RESULT_BYTES*$3" | bc)
+    DIFF_BYTES=$(cmp -l $1 $2 | wc -l | bc)
+    return $(echo "$DIFF_BYTES > $DIFF_THRESHOLD" | bc)
+}
+
+# check_rate_case <test name> <sample rate in kHz> <right result> <output> <diff bytes ratio> <min snr in dB for fixed mode> <sample cmd ...>
+check_rate_case()
+{
+    NAME=$1
+    RATE=$2
+    RESULT=$3
+    OUTPUT=$4
+    RATIO=$5
+    SNR=$6
+    shift 6
+
+    "$@"
+    if [ $? -ne 0 ]; then
+        echo "$NAME test at ${RATE}k returned an error at loop "$i
+        exit 1
+    fi
+    check_output $RESULT $OUTPUT $RATIO $SNR
+    if [ $? -ne 0 ]; then
+        echo "$NAME test at ${RATE}k failed at loop "$i
+        exit 1
+    fi
+}
 
 SCRIPT_PATH=$(dirname $(readlink -f "$0"))
 export LD_LIBRARY_PATH=$LD_LIBRARY_PATH:$SCRIPT_PATH/../lib/
@@ -61,11 +102,8 @@ do
     ./bin/samples/athena_signal_bf_sample -i testing/data/beamforming_1nan_3m_sound_0_noise_60_3channels.wav -b 1 -m 3 -f testing/data/beamforming_mic_coord.txt -l 90.0 -o output/beamforming_1nan_3m_sound_0_noise_60_mvdr_output.pcm
     # check if MVDR beamforming output match with the right result
     # due to potential calculation deviation, output may not strictly same as the right result
-    MVDR_RESULT_BYTES=$(ls -l testing/data/beamforming_1nan_3m_sound_0_noise_60_mvdr_output.pcm | awk '{print $5}')
-    MVDR_DIFF_THRESHOLD=$(echo "$MVDR_RESULT_BYTES*0.01" | bc)
-    MVDR_DIFF_BYTES=$(cmp -l testing/data/beamforming_1nan_3m_sound_0_noise_60_mvdr_output.pcm output/beamforming_1nan_3m_sound_0_noise_60_mvdr_output.pcm | wc -l | bc)
-    MVDR_DIFF_RESULT=$(echo "$MVDR_DIFF_BYTES > $MVDR_DIFF_THRESHOLD" | bc)
-    if [ $MVDR_DIFF_RESULT -eq 1 ]; then
+    check_output testing/data/beamforming_1nan_3m_sound_0_noise_60_mvdr_output.pcm output/beamforming_1nan_3m_sound_0_noise_60_mvdr_output.pcm 0.01 60
+    if [ $? -ne 0 ]; then
         echo "MVDR beamforming test failed at loop "$i
         exit
     fi
@@ -74,11 +112,8 @@ do
     ./bin/samples/athena_signal_bf_sample -i testing/data/beamforming_1nan_3m_sound_0_noise_60_3channels.wav -b 2 -m 3 -f testing/data/beamforming_mic_coord.txt -l 90.0 -o output/beamforming_1nan_3m_sound_0_noise_60_gsc_output.pcm
     # check if GSC beamforming output match with the right result
     # due to potential calculation deviation, output may not strictly same as the right result
-    GSC_RESULT_BYTES=$(ls -l testing/data/beamforming_1nan_3m_sound_0_noise_60_gsc_output.pcm | awk '{print $5}')
-    GSC_DIFF_THRESHOLD=$(echo "$GSC_RESULT_BYTES*0.08" | bc)
-    GSC_DIFF_BYTES=$(cmp -l testing/data/beamforming_1nan_3m_sound_0_noise_60_gsc_output.pcm output/beamforming_1nan_3m_sound_0_noise_60_gsc_output.pcm | wc -l | bc)
-    GSC_DIFF_RESULT=$(echo "$GSC_DIFF_BYTES > $GSC_DIFF_THRESHOLD" | bc)
-    if [ $GSC_DIFF_RESULT -eq 1 ]; then
+    check_output testing/data/beamforming_1nan_3m_sound_0_noise_60_gsc_output.pcm output/beamforming_1nan_3m_sound_0_noise_60_gsc_output.pcm 0.08 45
+    if [ $? -ne 0 ]; then
         echo "GSC beamforming test failed at loop "$i
         exit
     fi
@@ -87,24 +122,28 @@ do
     ./bin/samples/athena_signal_aec_sample -i testing/data/aec_input.wav -r testing/data/aec_ref.wav -o output/aec_output.pcm
     # check if AEC output match with the right result
     # due to potential calculation deviation, output may not strictly same as the right result
-    AEC_RESULT_BYTES=$(ls -l testing/data/aec_output.pcm | awk '{print $5}')
-    AEC_DIFF_THRESHOLD=$(echo "$AEC_RESULT_BYTES*0.08" | bc)
-    AEC_DIFF_BYTES=$(cmp -l testing/data/aec_output.pcm output/aec_output.pcm | wc -l | bc)
-    AEC_DIFF_RESULT=$(echo "$AEC_DIFF_BYTES > $AEC_DIFF_THRESHOLD" | bc)
-    if [ $AEC_DIFF_RESULT -eq 1 ]; then
+    check_output testing/data/aec_output.pcm output/aec_output.pcm 0.08 50
+    if [ $? -ne 0 ]; then
         echo "AEC test failed at loop "$i
         exit
     fi
 
+    # run AEC + NS test
+    ./bin/samples/athena_signal_aec_sample -i testing/data/aec_input.wav -r testing/data/aec_ref.wav -n -o output/aec_ns_output.pcm
+    # check if AEC + NS output match with the right result
+    # due to potential calculation deviation, output may not strictly same as the right result
+    check_output testing/data/aec_ns_output.pcm output/aec_ns_output.pcm 0.08 50
+    if [ $? -ne 0 ]; then
+        echo "AEC + NS test failed at loop "$i
+        exit
+    fi
+
     # run AGC test
     ./bin/samples/athena_signal_agc_sample -i testing/data/agc_input.wav -o output/agc_output.pcm
     # check if AGC output match with the right result
     # due to potential calculation deviation, output may not strictly same as the right result
-    AGC_RESULT_BYTES=$(ls -l testing/data/agc_output.pcm | awk '{print $5}')
-    AGC_DIFF_THRESHOLD=$(echo "$AGC_RESULT_BYTES*0.01" | bc)
-    AGC_DIFF_BYTES=$(cmp -l testing/data/agc_output.pcm output/agc_output.pcm | wc -l | bc)
-    AGC_DIFF_RESULT=$(echo "$AGC_DIFF_BYTES > $AGC_DIFF_THRESHOLD" | bc)
-    if [ $AGC_DIFF_RESULT -eq 1 ]; then
+    check_output testing/data/agc_output.pcm output/agc_output.pcm 0.01 60
+    if [ $? -ne 0 ]; then
         echo "AGC test failed at loop "$i
         exit
     fi
@@ -113,15 +152,29 @@ do
     ./bin/samples/athena_signal_hpf_sample -i testing/data/hpf_input.wav -o output/hpf_output.pcm
     # check if HPF output match with the right result
     # due to potential calculation deviation, output may not strictly same as the right result
-    HPF_RESULT_BYTES=$(ls -l testing/data/hpf_output.pcm | awk '{print $5}')
-    HPF_DIFF_THRESHOLD=$(echo "$HPF_RESULT_BYTES*0.01" | bc)
-    HPF_DIFF_BYTES=$(cmp -l testing/data/hpf_output.pcm output/hpf_output.pcm | wc -l | bc)
-    HPF_DIFF_RESULT=$(echo "$HPF_DIFF_BYTES > $HPF_DIFF_THRESHOLD" | bc)
-    if [ $HPF_DIFF_RESULT -eq 1 ]; then
+    check_output testing/data/hpf_output.pcm output/hpf_output.pcm 0.01 60
+    if [ $? -ne 0 ]; then
         echo "HPF test failed at loop "$i
         exit
     fi
 
+    # run MVDR, GSC, AEC + NS, AGC and HPF at the other supported sample rates,
+    # the inputs are the first 4 seconds of aec_input.wav, aec_ref.wav and
+    # aec_beamforming_agc_5m_3channels_input1.wav resampled to each rate
+    for RATE in 8 32 48;
+    do
+        check_rate_case "MVDR beamforming" $RATE testing/data/mvdr_output_${RATE}k.pcm output/mvdr_output_${RATE}k.pcm 0.01 60 \
+            ./bin/samples/athena_signal_bf_sample -s ${RATE}000 -i testing/data/beamforming_3channels_${RATE}k.wav -b 1 -m 3 -f testing/data/beamforming_mic_coord.txt -l 90.0 -o output/mvdr_output_${RATE}k.pcm
+        check_rate_case "GSC beamforming" $RATE testing/data/gsc_output_${RATE}k.pcm output/gsc_output_${RATE}k.pcm 0.08 45 \
+            ./bin/samples/athena_signal_bf_sample -s ${RATE}000 -i testing/data/beamforming_3channels_${RATE}k.wav -b 2 -m 3 -f testing/data/beamforming_mic_coord.txt -l 90.0 -o output/gsc_output_${RATE}k.pcm
+        check_rate_case "AEC + NS" $RATE testing/data/aec_ns_output_${RATE}k.pcm output/aec_ns_output_${RATE}k.pcm 0.08 50 \
+            ./bin/samples/athena_signal_aec_sample -s ${RATE}000 -i testing/data/aec_input_${RATE}k.wav -r testing/data/aec_ref_${RATE}k.wav -n -o output/aec_ns_output_${RATE}k.pcm
+        check_rate_case "AGC" $RATE testing/data/agc_output_${RATE}k.pcm output/agc_output_${RATE}k.pcm 0.01 60 \
+            ./bin/samples/athena_signal_agc_sample -s ${RATE}000 -i testing/data/aec_input_${RATE}k.wav -o output/agc_output_${RATE}k.pcm
+        check_rate_case "HPF" $RATE testing/data/hpf_output_${RATE}k.pcm output/hpf_output_${RATE}k.pcm 0.01 60 \
+            ./bin/samples/athena_signal_hpf_sample -s ${RATE}000 -i testing/data/aec_input_${RATE}k.wav -o output/hpf_output_${RATE}k.pcm
+    done
+
     # run DOA test
     #./bin/samples/athena_signal_doa_sample -i testing/data/beamforming_1nan_3m_sound_0_noise_60_3channels.wav -m 3 -f testing/data/beamforming_mic_coord.txt
     # check if DOA result is the right angle (0 degree)